@@ -0,0 +1 @@
+doxygen lwip.Doxyfile
@@ -55,6 +55,11 @@ extern "C" {
   void OS_set_printf(int (*printf)(const char *fmt, ...));
   boolean OS_TaskDeleteCheck(void);
   int32 OS_TaskWait(uint32 task_id);
+  int32 OS_QueueReserve(uint32 queue_id, void **data, int32 timeout);
+  int32 OS_QueueCommit(uint32 queue_id, void *data, uint32 size);
+  int32 OS_QueueFetch(uint32 queue_id, void **data, uint32 *size,
+                      int32 timeout);
+  int32 OS_QueueRelease(uint32 queue_id, void *data);
 #ifdef __cplusplus
 }
 #endif
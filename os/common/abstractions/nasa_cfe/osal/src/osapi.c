@@ -23,6 +23,7 @@
  */
 
 #include <stdarg.h>
+#include <stddef.h>
 #include <string.h>
 
 #include "ch.h"
@@ -79,6 +80,35 @@
 #define MIN_QUEUE_DEPTH     1
 #define MAX_QUEUE_DEPTH     16384
 
+/**
+ * @brief   Number of buckets in each objects names hash table.
+ * @note    It must be a power of two.
+ */
+#if !defined(OSAL_NAMES_HASH_SIZE)
+#define OSAL_NAMES_HASH_SIZE    64
+#endif
+
+#if (OSAL_NAMES_HASH_SIZE < 1) ||                                           \
+    ((OSAL_NAMES_HASH_SIZE & (OSAL_NAMES_HASH_SIZE - 1)) != 0)
+#error "OSAL_NAMES_HASH_SIZE must be a power of two"
+#endif
+
+/**
+ * @brief   Checks if a pointer refers to an element of an objects table.
+ */
+#define IS_TABLE_ENTRY(p, table)                                            \
+  (((uint8_t *)(p) >= (uint8_t *)&(table)[0]) &&                            \
+   ((uint8_t *)(p) < (uint8_t *)&(table)[sizeof (table) /                   \
+                                         sizeof ((table)[0])]) &&           \
+   ((((uint8_t *)(p) - (uint8_t *)&(table)[0]) %                            \
+     sizeof ((table)[0])) == 0U))
+
+/**
+ * @brief   Returns the object containing a name entry.
+ */
+#define NAME_TO_OBJECT(onp, type)                                           \
+  ((type *)(void *)((uint8_t *)(onp) - offsetof(type, nm)))
+
 /*===========================================================================*/
 /* Module exported variables.                                                */
 /*===========================================================================*/
@@ -92,12 +122,34 @@
  */
 typedef void (*funcptr_t)(void);
 
+/**
+ * @brief   Type of an object name entry.
+ */
+typedef struct osal_name osal_name_t;
+
+/**
+ * @brief   Structure of an object name entry.
+ * @note    It is placed at the start of timers and queues, the pool link
+ *          of free objects overwrites the @p next field.
+ */
+struct osal_name {
+  osal_name_t           *next;
+  char                  name[OS_MAX_API_NAME];
+};
+
+/**
+ * @brief   Type of an objects names hash table.
+ */
+typedef struct {
+  osal_name_t           *buckets[OSAL_NAMES_HASH_SIZE];
+} osal_names_t;
+
 /**
  * @brief   Type of OSAL timer.
  */
 typedef struct {
+  osal_name_t           nm;
   uint32                is_free;
-  char                  name[OS_MAX_API_NAME];
   OS_TimerCallback_t    callback_ptr;
   uint32                start_time;
   uint32                interval_time;
@@ -108,8 +160,8 @@ typedef struct {
  * @brief   Type of an OSAL queue.
  */
 typedef struct {
+  osal_name_t           nm;
   uint32                is_free;
-  char                  name[OS_MAX_API_NAME];
   semaphore_t           free_msgs;
   memory_pool_t         messages;
   mailbox_t             mb;
@@ -127,6 +179,30 @@ typedef struct {
   char                  buf[4];
 } osal_message_t;
 
+/**
+ * @brief   Type of an OSAL binary semaphore.
+ */
+typedef struct {
+  binary_semaphore_t    bs;
+  osal_name_t           nm;
+} osal_binary_semaphore_t;
+
+/**
+ * @brief   Type of an OSAL counter semaphore.
+ */
+typedef struct {
+  semaphore_t           cs;
+  osal_name_t           nm;
+} osal_count_semaphore_t;
+
+/**
+ * @brief   Type of an OSAL mutex.
+ */
+typedef struct {
+  mutex_t               m;
+  osal_name_t           nm;
+} osal_mutex_t;
+
 /**
  * @brief   Type of OSAL main structure.
  */
@@ -142,9 +218,14 @@ typedef struct {
   memory_pool_t         mutexes_pool;
   osal_timer_t          timers[OS_MAX_TIMERS];
   osal_queue_t          queues[OS_MAX_QUEUES];
-  binary_semaphore_t    binary_semaphores[OS_MAX_BIN_SEMAPHORES];
-  semaphore_t           count_semaphores[OS_MAX_COUNT_SEMAPHORES];
-  mutex_t               mutexes[OS_MAX_MUTEXES];
+  osal_binary_semaphore_t binary_semaphores[OS_MAX_BIN_SEMAPHORES];
+  osal_count_semaphore_t count_semaphores[OS_MAX_COUNT_SEMAPHORES];
+  osal_mutex_t          mutexes[OS_MAX_MUTEXES];
+  osal_names_t          timer_names;
+  osal_names_t          queue_names;
+  osal_names_t          binary_semaphore_names;
+  osal_names_t          count_semaphore_names;
+  osal_names_t          mutex_names;
 } osal_t;
 
 /*===========================================================================*/
@@ -191,53 +272,234 @@ static void timer_handler(void *p) {
 }
 
 /**
- * @brief   Finds a queue by name.
+ * @brief   Names hash function.
+ * @note    Only the first @p OS_MAX_API_NAME - 1 characters are relevant.
  */
-uint32 queue_find(const char *queue_name) {
-  osal_queue_t *oqp;
+static uint32_t name_hash(const char *name) {
+  uint32_t h = 2166136261U;
+  unsigned i;
+
+  for (i = 0U; i < (unsigned)OS_MAX_API_NAME - 1U; i++) {
+    if (name[i] == '\0') {
+      break;
+    }
+    h = (h ^ (uint32_t)(uint8_t)name[i]) * 16777619U;
+  }
+
+  return h;
+}
+
+/**
+ * @brief   Returns the bucket of a name.
+ */
+static osal_name_t **name_bucket(osal_names_t *ntp, const char *name) {
 
-  /* Searching the queue in the table.*/
-  for (oqp = &osal.queues[0]; oqp < &osal.queues[OS_MAX_QUEUES]; oqp++) {
-    /* Entering a reentrant critical zone.*/
-    syssts_t sts = chSysGetStatusAndLockX();
+  return &ntp->buckets[name_hash(name) & (OSAL_NAMES_HASH_SIZE - 1U)];
+}
 
-    if (!oqp->is_free &&
-        (strncmp(oqp->name, queue_name, OS_MAX_API_NAME - 1) == 0)) {
-      /* Leaving the critical zone.*/
-      chSysRestoreStatusX(sts);
-      return (uint32)oqp;
+/**
+ * @brief   Searches a name in an hash table.
+ * @note    Must be invoked from within a critical zone.
+ */
+static osal_name_t *name_find_s(osal_names_t *ntp, const char *name) {
+  osal_name_t *onp;
+
+  for (onp = *name_bucket(ntp, name); onp != NULL; onp = onp->next) {
+    if (strncmp(onp->name, name, OS_MAX_API_NAME - 1) == 0) {
+      return onp;
     }
+  }
 
-    /* Leaving the critical zone.*/
-    chSysRestoreStatusX(sts);
+  return NULL;
+}
+
+/**
+ * @brief   Finds an object by name.
+ *
+ * @return                      The name entry or @p NULL if not found.
+ */
+static osal_name_t *name_find(osal_names_t *ntp, const char *name) {
+  osal_name_t *onp;
+
+  /* Entering a reentrant critical zone.*/
+  syssts_t sts = chSysGetStatusAndLockX();
+
+  onp = name_find_s(ntp, name);
+
+  /* Leaving the critical zone.*/
+  chSysRestoreStatusX(sts);
+
+  return onp;
+}
+
+/**
+ * @brief   Assigns a name to an object and adds it to an hash table.
+ * @note    Check and insertion are atomic, two objects cannot get the
+ *          same name.
+ *
+ * @return                      The operation status.
+ * @retval false                if the name is already taken.
+ */
+static bool name_insert(osal_names_t *ntp, osal_name_t *onp,
+                        const char *name) {
+  osal_name_t **bpp = name_bucket(ntp, name);
+
+  strncpy(onp->name, name, OS_MAX_API_NAME - 1);
+  onp->name[OS_MAX_API_NAME - 1] = '\0';
+
+  chSysLock();
+
+  if (name_find_s(ntp, name) != NULL) {
+    chSysUnlock();
+    return false;
   }
 
-  return 0;
+  onp->next = *bpp;
+  *bpp = onp;
+
+  chSysUnlock();
+
+  return true;
 }
 
 /**
- * @brief   Finds a timer by name.
+ * @brief   Removes an object name from an hash table.
+ * @note    Must be invoked from within a critical zone.
  */
-uint32 timer_find(const char *timer_name) {
-  osal_timer_t *otp;
+static void name_remove_s(osal_names_t *ntp, osal_name_t *onp) {
+  osal_name_t **pp;
+
+  for (pp = name_bucket(ntp, onp->name); *pp != NULL; pp = &(*pp)->next) {
+    if (*pp == onp) {
+      *pp = onp->next;
+      return;
+    }
+  }
+}
+
+/**
+ * @brief   Gives back a queue whose creation failed.
+ */
+static void queue_abort(osal_queue_t *oqp) {
 
-  /* Searching the queue in the table.*/
-  for (otp = &osal.timers[0]; otp < &osal.timers[OS_MAX_TIMERS]; otp++) {
-    /* Entering a reentrant critical zone.*/
-    syssts_t sts = chSysGetStatusAndLockX();
+  chSysLock();
+  name_remove_s(&osal.queue_names, &oqp->nm);
+  chPoolFreeI(&osal.queues_pool, (void *)oqp);
+  chSysUnlock();
+}
 
-    if (!otp->is_free &&
-        (strncmp(otp->name, timer_name, OS_MAX_API_NAME - 1) == 0)) {
-      /* Leaving the critical zone.*/
-      chSysRestoreStatusX(sts);
-      return (uint32)otp;
+/**
+ * @brief   Converts an OSAL timeout in a system interval.
+ */
+static sysinterval_t queue_timeout(int32 timeout) {
+
+  if (timeout == OS_PEND) {
+    return TIME_INFINITE;
+  }
+  if (timeout == OS_CHECK) {
+    return TIME_IMMEDIATE;
+  }
+  return (sysinterval_t)timeout;
+}
+
+/**
+ * @brief   Gets a free message buffer from a queue.
+ *
+ * @return                      An error code.
+ */
+static int32 queue_reserve(osal_queue_t *oqp, osal_message_t **omsgp,
+                           int32 timeout) {
+  msg_t msgsts;
+
+  chSysLock();
+  msgsts = chSemWaitTimeoutS(&oqp->free_msgs, queue_timeout(timeout));
+  if (msgsts < MSG_OK) {
+    chSysUnlock();
+    if (msgsts == MSG_TIMEOUT) {
+      return timeout == OS_CHECK ? OS_QUEUE_FULL : OS_QUEUE_TIMEOUT;
     }
+    return OS_ERROR;
+  }
+  *omsgp = chPoolAllocI(&oqp->messages);
+  chSysUnlock();
 
-    /* Leaving the critical zone.*/
-    chSysRestoreStatusX(sts);
+  return OS_SUCCESS;
+}
+
+/**
+ * @brief   Posts a filled message buffer in a queue.
+ * @note    There is always space in the mailbox for a reserved buffer so
+ *          the post does not wait.
+ *
+ * @return                      An error code.
+ */
+static int32 queue_post(osal_queue_t *oqp, osal_message_t *omsg) {
+  msg_t msgsts;
+
+  chSysLock();
+  msgsts = chMBPostI(&oqp->mb, (msg_t)omsg);
+  chSchRescheduleS();
+  chSysUnlock();
+
+  return msgsts == MSG_OK ? OS_SUCCESS : OS_ERROR;
+}
+
+/**
+ * @brief   Fetches a message buffer from a queue.
+ *
+ * @return                      An error code.
+ */
+static int32 queue_fetch(osal_queue_t *oqp, osal_message_t **omsgp,
+                         int32 timeout) {
+  msg_t msg, msgsts;
+
+  msgsts = chMBFetchTimeout(&oqp->mb, &msg, queue_timeout(timeout));
+  if (msgsts < MSG_OK) {
+    if (timeout == OS_PEND) {
+      return OS_ERROR;
+    }
+    return timeout == OS_CHECK ? OS_QUEUE_EMPTY : OS_QUEUE_TIMEOUT;
+  }
+  *omsgp = (osal_message_t *)msg;
+
+  return OS_SUCCESS;
+}
+
+/**
+ * @brief   Returns a message buffer to the queue pool.
+ */
+static void queue_free(osal_queue_t *oqp, osal_message_t *omsg) {
+
+  chSysLock();
+  chPoolFreeI(&oqp->messages, (void *)omsg);
+  chSemSignalI(&oqp->free_msgs);
+  chSchRescheduleS();
+  chSysUnlock();
+}
+
+/**
+ * @brief   Returns the message buffer containing a message body.
+ *
+ * @return                      The message buffer or @p NULL if the
+ *                              pointer is not a message body of the queue.
+ */
+static osal_message_t *queue_body_to_message(osal_queue_t *oqp, void *data) {
+  uint8_t *base = (uint8_t *)oqp->mb_buffer;
+  size_t msgsize = oqp->messages.object_size;
+  uint8_t *p;
+
+  if (data == NULL) {
+    return NULL;
+  }
+
+  p = (uint8_t *)data - offsetof(osal_message_t, buf);
+  if ((p < base) ||
+      (p >= base + (msgsize * (size_t)oqp->depth)) ||
+      (((size_t)(p - base) % msgsize) != 0U)) {
+    return NULL;
   }
 
-  return 0;
+  return (osal_message_t *)(void *)p;
 }
 
 /*===========================================================================*/
@@ -270,6 +532,13 @@ int32 OS_API_Init(void) {
   chVTObjectInit(&osal.vt);
   chVTSet(&osal.vt, TIME_MS2I(1), systime_update, (void *)TIME_MS2I(1));
 
+  /* Names hash tables initialization.*/
+  memset(&osal.timer_names, 0, sizeof (osal_names_t));
+  memset(&osal.queue_names, 0, sizeof (osal_names_t));
+  memset(&osal.binary_semaphore_names, 0, sizeof (osal_names_t));
+  memset(&osal.count_semaphore_names, 0, sizeof (osal_names_t));
+  memset(&osal.mutex_names, 0, sizeof (osal_names_t));
+
   /* Timers pool initialization.*/
   chPoolObjectInit(&osal.timers_pool,
                    sizeof (osal_timer_t),
@@ -288,7 +557,7 @@ int32 OS_API_Init(void) {
 
   /* Binary Semaphores pool initialization.*/
   chPoolObjectInit(&osal.binary_semaphores_pool,
-                   sizeof (binary_semaphore_t),
+                   sizeof (osal_binary_semaphore_t),
                    NULL);
   chPoolLoadArray(&osal.binary_semaphores_pool,
                   &osal.binary_semaphores[0],
@@ -296,7 +565,7 @@ int32 OS_API_Init(void) {
 
   /* Counter Semaphores pool initialization.*/
   chPoolObjectInit(&osal.count_semaphores_pool,
-                   sizeof (semaphore_t),
+                   sizeof (osal_count_semaphore_t),
                    NULL);
   chPoolLoadArray(&osal.count_semaphores_pool,
                   &osal.count_semaphores[0],
@@ -304,7 +573,7 @@ int32 OS_API_Init(void) {
 
   /* Mutexes pool initialization.*/
   chPoolObjectInit(&osal.mutexes_pool,
-                   sizeof (mutex_t),
+                   sizeof (osal_mutex_t),
                    NULL);
   chPoolLoadArray(&osal.mutexes_pool,
                   &osal.mutexes[0],
@@ -467,12 +736,6 @@ int32 OS_TimerCreate(uint32 *timer_id, const char *timer_name,
     return OS_ERR_NAME_TOO_LONG;
   }
 
-  /* Checking if the name is already taken.*/
-  if (timer_find(timer_name) > 0) {
-    *timer_id = 0;
-    return OS_ERR_NAME_TAKEN;
-  }
-
   /* Getting object.*/
   otp = chPoolAlloc(&osal.timers_pool);
   if (otp == NULL) {
@@ -480,7 +743,13 @@ int32 OS_TimerCreate(uint32 *timer_id, const char *timer_name,
     return OS_ERR_NO_FREE_IDS;
   }
 
-  strncpy(otp->name, timer_name, OS_MAX_API_NAME - 1);
+  /* Assigning the name, it could be already taken.*/
+  if (!name_insert(&osal.timer_names, &otp->nm, timer_name)) {
+    chPoolFree(&osal.timers_pool, (void *)otp);
+    *timer_id = 0;
+    return OS_ERR_NAME_TAKEN;
+  }
+
   chVTObjectInit(&otp->vt);
   otp->start_time    = 0;
   otp->interval_time = 0;
@@ -505,9 +774,7 @@ int32 OS_TimerDelete(uint32 timer_id) {
   osal_timer_t *otp = (osal_timer_t *)timer_id;
 
   /* Range check.*/
-  if ((otp < &osal.timers[0]) ||
-      (otp >= &osal.timers[OS_MAX_TIMERS]) ||
-      (otp->is_free)) {
+  if (!IS_TABLE_ENTRY(otp, osal.timers) || (otp->is_free)) {
     return OS_ERR_INVALID_ID;
   }
 
@@ -522,6 +789,7 @@ int32 OS_TimerDelete(uint32 timer_id) {
   otp->interval_time = 0;
 
   /* Flagging it as unused and returning it to the pool.*/
+  name_remove_s(&osal.timer_names, &otp->nm);
   chPoolFreeI(&osal.timers_pool, (void *)otp);
 
   chSysUnlock();
@@ -545,9 +813,7 @@ int32 OS_TimerSet(uint32 timer_id, uint32 start_time, uint32 interval_time) {
   osal_timer_t *otp = (osal_timer_t *)timer_id;
 
   /* Range check.*/
-  if ((otp < &osal.timers[0]) ||
-      (otp >= &osal.timers[OS_MAX_TIMERS]) ||
-      (otp->is_free)) {
+  if (!IS_TABLE_ENTRY(otp, osal.timers) || (otp->is_free)) {
     return OS_ERR_INVALID_ID;
   }
 
@@ -579,6 +845,7 @@ int32 OS_TimerSet(uint32 timer_id, uint32 start_time, uint32 interval_time) {
  * @api
  */
 int32 OS_TimerGetIdByName(uint32 *timer_id, const char *timer_name) {
+  osal_name_t *onp;
 
   /* NULL pointer checks.*/
   if ((timer_id == NULL) || (timer_name == NULL)) {
@@ -590,9 +857,10 @@ int32 OS_TimerGetIdByName(uint32 *timer_id, const char *timer_name) {
     return OS_ERR_NAME_TOO_LONG;
   }
 
-  /* Searching the queue.*/
-  *timer_id = timer_find(timer_name);
-  if (*timer_id > 0) {
+  /* Searching the timer.*/
+  onp = name_find(&osal.timer_names, timer_name);
+  if (onp != NULL) {
+    *timer_id = (uint32)NAME_TO_OBJECT(onp, osal_timer_t);
     return OS_SUCCESS;
   }
 
@@ -619,9 +887,7 @@ int32 OS_TimerGetInfo(uint32 timer_id, OS_timer_prop_t *timer_prop) {
   }
 
   /* Range check.*/
-  if ((otp < &osal.timers[0]) ||
-      (otp >= &osal.timers[OS_MAX_TIMERS]) ||
-      (otp->is_free)) {
+  if (!IS_TABLE_ENTRY(otp, osal.timers) || (otp->is_free)) {
     return OS_ERR_INVALID_ID;
   }
 
@@ -635,7 +901,7 @@ int32 OS_TimerGetInfo(uint32 timer_id, OS_timer_prop_t *timer_prop) {
     return OS_ERR_INVALID_ID;
   }
 
-  strncpy(timer_prop->name, otp->name, OS_MAX_API_NAME - 1);
+  strncpy(timer_prop->name, otp->nm.name, OS_MAX_API_NAME - 1);
   timer_prop->creator       = (uint32)0;
   timer_prop->start_time    = otp->start_time;
   timer_prop->interval_time = otp->interval_time;
@@ -679,12 +945,6 @@ int32 OS_QueueCreate(uint32 *queue_id, const char *queue_name,
     return OS_ERR_NAME_TOO_LONG;
   }
 
-  /* Checking if the name is already taken.*/
-  if (queue_find(queue_name) > 0) {
-    *queue_id = 0;
-    return OS_ERR_NAME_TAKEN;
-  }
-
   /* Checks on queue limits. There is no dedicated error code.*/
   if ((data_size < MIN_MESSAGE_SIZE) || (data_size > MAX_MESSAGE_SIZE) ||
       (queue_depth < MIN_QUEUE_DEPTH) || (queue_depth > MAX_QUEUE_DEPTH)) {
@@ -699,12 +959,21 @@ int32 OS_QueueCreate(uint32 *queue_id, const char *queue_name,
     return OS_ERR_NO_FREE_IDS;
   }
 
+  /* Assigning the name, it could be already taken.*/
+  if (!name_insert(&osal.queue_names, &oqp->nm, queue_name)) {
+    chPoolFree(&osal.queues_pool, (void *)oqp);
+    *queue_id = 0;
+    return OS_ERR_NAME_TAKEN;
+  }
+
   /* Attempting messages buffer allocation.*/
-  msgsize = MEM_ALIGN_NEXT(data_size + sizeof (size_t), PORT_NATURAL_ALIGN);
+  msgsize = MEM_ALIGN_NEXT(offsetof(osal_message_t, buf) + data_size,
+                           PORT_NATURAL_ALIGN);
   oqp->mb_buffer = chHeapAllocAligned(NULL,
                                       msgsize * (size_t)queue_depth,
                                       PORT_NATURAL_ALIGN);
   if (oqp->mb_buffer == NULL) {
+    queue_abort(oqp);
     *queue_id = 0;
     return OS_ERROR;
   }
@@ -714,13 +983,13 @@ int32 OS_QueueCreate(uint32 *queue_id, const char *queue_name,
                                      sizeof (msg_t) * (size_t)queue_depth,
                                      PORT_NATURAL_ALIGN);
   if (oqp->q_buffer == NULL) {
-    *queue_id = 0;
     chHeapFree(oqp->mb_buffer);
+    queue_abort(oqp);
+    *queue_id = 0;
     return OS_ERROR;
   }
 
   /* Initializing object static parts.*/
-  strncpy(oqp->name, queue_name, OS_MAX_API_NAME - 1);
   chMBObjectInit(&oqp->mb, oqp->q_buffer, (size_t)queue_depth);
   chSemObjectInit(&oqp->free_msgs, (cnt_t)queue_depth);
   chPoolObjectInit(&oqp->messages, msgsize, NULL);
@@ -746,9 +1015,7 @@ int32 OS_QueueDelete(uint32 queue_id) {
   void *q_buffer, *mb_buffer;
 
   /* Range check.*/
-  if ((oqp < &osal.queues[0]) ||
-      (oqp >= &osal.queues[OS_MAX_QUEUES]) ||
-      (oqp->is_free)) {
+  if (!IS_TABLE_ENTRY(oqp, osal.queues) || (oqp->is_free)) {
     return OS_ERR_INVALID_ID;
   }
 
@@ -767,6 +1034,7 @@ int32 OS_QueueDelete(uint32 queue_id) {
   chSemResetI(&oqp->free_msgs, 0);
 
   /* Flagging it as unused and returning it to the pool.*/
+  name_remove_s(&osal.queue_names, &oqp->nm);
   chPoolFreeI(&osal.queues_pool, (void *)oqp);
 
   chSchRescheduleS();
@@ -797,8 +1065,8 @@ int32 OS_QueueDelete(uint32 queue_id) {
 int32 OS_QueueGet(uint32 queue_id, void *data, uint32 size,
                   uint32 *size_copied, int32 timeout) {
   osal_queue_t *oqp = (osal_queue_t *)queue_id;
-  msg_t msg, msgsts;
-  void *body;
+  osal_message_t *omsg;
+  int32 err;
 
   /* NULL pointer checks.*/
   if ((data == NULL) || (size_copied == NULL)) {
@@ -806,9 +1074,7 @@ int32 OS_QueueGet(uint32 queue_id, void *data, uint32 size,
   }
 
   /* Range check.*/
-  if ((oqp < &osal.queues[0]) ||
-      (oqp >= &osal.queues[OS_MAX_QUEUES]) ||
-      (oqp->is_free)) {
+  if (!IS_TABLE_ENTRY(oqp, osal.queues) || (oqp->is_free)) {
     return OS_ERR_INVALID_ID;
   }
 
@@ -817,39 +1083,19 @@ int32 OS_QueueGet(uint32 queue_id, void *data, uint32 size,
     return OS_QUEUE_INVALID_SIZE;
   }
 
-  /* Special time handling.*/
-  if (timeout == OS_PEND) {
-    msgsts = chMBFetchTimeout(&oqp->mb, &msg, TIME_INFINITE);
-    if (msgsts < MSG_OK) {
-      *size_copied = 0;
-      return OS_ERROR;
-    }
-  }
-  else if (timeout == OS_CHECK) {
-    msgsts = chMBFetchTimeout(&oqp->mb, &msg, TIME_IMMEDIATE);
-    if (msgsts < MSG_OK) {
-      *size_copied = 0;
-      return OS_QUEUE_EMPTY;
-    }
-  }
-  else {
-    msgsts = chMBFetchTimeout(&oqp->mb, &msg, (sysinterval_t)timeout);
-    if (msgsts < MSG_OK) {
-      *size_copied = 0;
-      return OS_QUEUE_TIMEOUT;
-    }
+  /* Getting the next message.*/
+  err = queue_fetch(oqp, &omsg, timeout);
+  if (err != OS_SUCCESS) {
+    *size_copied = 0;
+    return err;
   }
 
-  /* Message body and size.*/
-  *size_copied = ((osal_message_t *)msg)->size;
-  body  = (void *)((osal_message_t *)msg)->buf;
-
   /* Copying the message body.*/
-  memcpy(data, body, *size_copied);
+  *size_copied = (uint32)omsg->size;
+  memcpy(data, omsg->buf, omsg->size);
 
   /* Freeing the message buffer.*/
-  chPoolFree(&oqp->messages, (void *)msg);
-  chSemSignal(&oqp->free_msgs);
+  queue_free(oqp, omsg);
 
   return OS_SUCCESS;
 }
@@ -867,8 +1113,8 @@ int32 OS_QueueGet(uint32 queue_id, void *data, uint32 size,
  */
 int32 OS_QueuePut(uint32 queue_id, void *data, uint32 size, uint32 flags) {
   osal_queue_t *oqp = (osal_queue_t *)queue_id;
-  msg_t msgsts;
   osal_message_t *omsg;
+  int32 err;
 
   (void)flags;
 
@@ -878,9 +1124,7 @@ int32 OS_QueuePut(uint32 queue_id, void *data, uint32 size, uint32 flags) {
   }
 
   /* Range check.*/
-  if ((oqp < &osal.queues[0]) ||
-      (oqp >= &osal.queues[OS_MAX_QUEUES]) ||
-      (oqp->is_free)) {
+  if (!IS_TABLE_ENTRY(oqp, osal.queues) || (oqp->is_free)) {
     return OS_ERR_INVALID_ID;
   }
 
@@ -890,23 +1134,17 @@ int32 OS_QueuePut(uint32 queue_id, void *data, uint32 size, uint32 flags) {
   }
 
   /* Getting a message buffer from the pool.*/
-  msgsts = chSemWait(&oqp->free_msgs);
-  if (msgsts < MSG_OK) {
-    return OS_ERROR;
+  err = queue_reserve(oqp, &omsg, OS_PEND);
+  if (err != OS_SUCCESS) {
+    return err;
   }
-  omsg = chPoolAlloc(&oqp->messages);
 
   /* Filling message size and data.*/
   omsg->size = (size_t)size;
   memcpy(omsg->buf, data, size);
 
   /* Posting the message.*/
-  msgsts = chMBPostTimeout(&oqp->mb, (msg_t)omsg, TIME_INFINITE);
-  if (msgsts < MSG_OK) {
-    return OS_ERROR;
-  }
-
-  return OS_SUCCESS;
+  return queue_post(oqp, omsg);
 }
 
 /**
@@ -919,6 +1157,7 @@ int32 OS_QueuePut(uint32 queue_id, void *data, uint32 size, uint32 flags) {
  * @api
  */
 int32 OS_QueueGetIdByName(uint32 *queue_id, const char *queue_name) {
+  osal_name_t *onp;
 
   /* NULL pointer checks.*/
   if ((queue_id == NULL) || (queue_name == NULL)) {
@@ -931,8 +1170,9 @@ int32 OS_QueueGetIdByName(uint32 *queue_id, const char *queue_name) {
   }
 
   /* Searching the queue.*/
-  *queue_id = queue_find(queue_name);
-  if (*queue_id > 0) {
+  onp = name_find(&osal.queue_names, queue_name);
+  if (onp != NULL) {
+    *queue_id = (uint32)NAME_TO_OBJECT(onp, osal_queue_t);
     return OS_SUCCESS;
   }
 
@@ -959,9 +1199,7 @@ int32 OS_QueueGetInfo (uint32 queue_id, OS_queue_prop_t *queue_prop) {
   }
 
   /* Range check.*/
-  if ((oqp < &osal.queues[0]) ||
-      (oqp >= &osal.queues[OS_MAX_QUEUES]) ||
-      (oqp->is_free)) {
+  if (!IS_TABLE_ENTRY(oqp, osal.queues) || (oqp->is_free)) {
     return OS_ERR_INVALID_ID;
   }
 
@@ -975,7 +1213,7 @@ int32 OS_QueueGetInfo (uint32 queue_id, OS_queue_prop_t *queue_prop) {
     return OS_ERR_INVALID_ID;
   }
 
-  strncpy(queue_prop->name, oqp->name, OS_MAX_API_NAME - 1);
+  strncpy(queue_prop->name, oqp->nm.name, OS_MAX_API_NAME - 1);
   queue_prop->creator = (uint32)0;
 
   /* Leaving the critical zone.*/
@@ -986,6 +1224,161 @@ int32 OS_QueueGetInfo (uint32 queue_id, OS_queue_prop_t *queue_prop) {
   return OS_ERR_NOT_IMPLEMENTED;
 }
 
+/**
+ * @brief   Reserves a message buffer in the queue.
+ * @details The message body is written in place by the caller then the
+ *          message is sent using @p OS_QueueCommit(), no copy is performed.
+ * @note    This is a ChibiOS/RT extension.
+ *
+ * @param[in] queue_id          queue id variable
+ * @param[out] data             pointer to the message body pointer, the
+ *                              body size is the maximum message size of
+ *                              the queue
+ * @param[in] timeout           timeout in ticks, the special values @p OS_PEND
+ *                              and @p OS_CHECK can be specified
+ * @return                      An error code.
+ *
+ * @api
+ */
+int32 OS_QueueReserve(uint32 queue_id, void **data, int32 timeout) {
+  osal_queue_t *oqp = (osal_queue_t *)queue_id;
+  osal_message_t *omsg;
+  int32 err;
+
+  /* NULL pointer checks.*/
+  if (data == NULL) {
+    return OS_INVALID_POINTER;
+  }
+
+  /* Range check.*/
+  if (!IS_TABLE_ENTRY(oqp, osal.queues) || (oqp->is_free)) {
+    return OS_ERR_INVALID_ID;
+  }
+
+  err = queue_reserve(oqp, &omsg, timeout);
+  if (err != OS_SUCCESS) {
+    *data = NULL;
+    return err;
+  }
+
+  *data = (void *)omsg->buf;
+
+  return OS_SUCCESS;
+}
+
+/**
+ * @brief   Sends a message previously reserved.
+ * @note    This is a ChibiOS/RT extension.
+ *
+ * @param[in] queue_id          queue id variable
+ * @param[in] data              message body pointer returned by
+ *                              @p OS_QueueReserve()
+ * @param[in] size              size of the message
+ * @return                      An error code.
+ *
+ * @api
+ */
+int32 OS_QueueCommit(uint32 queue_id, void *data, uint32 size) {
+  osal_queue_t *oqp = (osal_queue_t *)queue_id;
+  osal_message_t *omsg;
+
+  /* Range check.*/
+  if (!IS_TABLE_ENTRY(oqp, osal.queues) || (oqp->is_free)) {
+    return OS_ERR_INVALID_ID;
+  }
+
+  /* The pointer must be a message body of this queue.*/
+  omsg = queue_body_to_message(oqp, data);
+  if (omsg == NULL) {
+    return OS_INVALID_POINTER;
+  }
+
+  /* Check on maximum size, the buffer is still owned by the caller.*/
+  if (size > oqp->size) {
+    return OS_QUEUE_INVALID_SIZE;
+  }
+
+  omsg->size = (size_t)size;
+
+  return queue_post(oqp, omsg);
+}
+
+/**
+ * @brief   Retrieves a message from the queue without copying it.
+ * @details The returned message body is borrowed from the queue and must
+ *          be returned using @p OS_QueueRelease().
+ * @note    This is a ChibiOS/RT extension.
+ *
+ * @param[in] queue_id          queue id variable
+ * @param[out] data             pointer to the message body pointer
+ * @param[out] size             size of the received message
+ * @param[in] timeout           timeout in ticks, the special values @p OS_PEND
+ *                              and @p OS_CHECK can be specified
+ * @return                      An error code.
+ *
+ * @api
+ */
+int32 OS_QueueFetch(uint32 queue_id, void **data, uint32 *size,
+                    int32 timeout) {
+  osal_queue_t *oqp = (osal_queue_t *)queue_id;
+  osal_message_t *omsg;
+  int32 err;
+
+  /* NULL pointer checks.*/
+  if ((data == NULL) || (size == NULL)) {
+    return OS_INVALID_POINTER;
+  }
+
+  /* Range check.*/
+  if (!IS_TABLE_ENTRY(oqp, osal.queues) || (oqp->is_free)) {
+    return OS_ERR_INVALID_ID;
+  }
+
+  err = queue_fetch(oqp, &omsg, timeout);
+  if (err != OS_SUCCESS) {
+    *data = NULL;
+    *size = 0;
+    return err;
+  }
+
+  *data = (void *)omsg->buf;
+  *size = (uint32)omsg->size;
+
+  return OS_SUCCESS;
+}
+
+/**
+ * @brief   Returns a message body to the queue.
+ * @details It is used for messages obtained by @p OS_QueueFetch() or for
+ *          discarding messages reserved by @p OS_QueueReserve().
+ * @note    This is a ChibiOS/RT extension.
+ *
+ * @param[in] queue_id          queue id variable
+ * @param[in] data              message body pointer
+ * @return                      An error code.
+ *
+ * @api
+ */
+int32 OS_QueueRelease(uint32 queue_id, void *data) {
+  osal_queue_t *oqp = (osal_queue_t *)queue_id;
+  osal_message_t *omsg;
+
+  /* Range check.*/
+  if (!IS_TABLE_ENTRY(oqp, osal.queues) || (oqp->is_free)) {
+    return OS_ERR_INVALID_ID;
+  }
+
+  /* The pointer must be a message body of this queue.*/
+  omsg = queue_body_to_message(oqp, data);
+  if (omsg == NULL) {
+    return OS_INVALID_POINTER;
+  }
+
+  queue_free(oqp, omsg);
+
+  return OS_SUCCESS;
+}
+
 /*-- Binary Semaphore API ---------------------------------------------------*/
 
 /**
@@ -1001,7 +1394,7 @@ int32 OS_QueueGetInfo (uint32 queue_id, OS_queue_prop_t *queue_prop) {
  */
 int32 OS_BinSemCreate(uint32 *sem_id, const char *sem_name,
                       uint32 sem_initial_value, uint32 options) {
-  binary_semaphore_t *bsp;
+  osal_binary_semaphore_t *bsp;
 
   (void)options;
 
@@ -1026,8 +1419,14 @@ int32 OS_BinSemCreate(uint32 *sem_id, const char *sem_name,
     return OS_ERR_NO_FREE_IDS;
   }
 
+  /* Assigning the name, it could be already taken.*/
+  if (!name_insert(&osal.binary_semaphore_names, &bsp->nm, sem_name)) {
+    chPoolFree(&osal.binary_semaphores_pool, (void *)bsp);
+    return OS_ERR_NAME_TAKEN;
+  }
+
   /* Semaphore is initialized.*/
-  chBSemObjectInit(bsp, sem_initial_value == 0 ? true : false);
+  chBSemObjectInit(&bsp->bs, sem_initial_value == 0 ? true : false);
 
   *sem_id = (uint32)bsp;
 
@@ -1043,21 +1442,21 @@ int32 OS_BinSemCreate(uint32 *sem_id, const char *sem_name,
  * @api
  */
 int32 OS_BinSemDelete(uint32 sem_id) {
-  binary_semaphore_t *bsp = (binary_semaphore_t *)sem_id;
+  osal_binary_semaphore_t *bsp = (osal_binary_semaphore_t *)sem_id;
 
   /* Range check.*/
-  if ((bsp < &osal.binary_semaphores[0]) ||
-      (bsp >= &osal.binary_semaphores[OS_MAX_BIN_SEMAPHORES])) {
+  if (!IS_TABLE_ENTRY(bsp, osal.binary_semaphores)) {
     return OS_ERR_INVALID_ID;
   }
 
   chSysLock();
 
   /* Resetting the semaphore, no threads in queue.*/
-  chBSemResetI(bsp, true);
+  chBSemResetI(&bsp->bs, true);
 
   /* Flagging it as unused and returning it to the pool.*/
-  bsp->sem.queue.prev = NULL;
+  bsp->bs.sem.queue.prev = NULL;
+  name_remove_s(&osal.binary_semaphore_names, &bsp->nm);
   chPoolFreeI(&osal.binary_semaphores_pool, (void *)bsp);
 
   /* Required because some thread could have been made ready.*/
@@ -1080,11 +1479,10 @@ int32 OS_BinSemDelete(uint32 sem_id) {
  */
 int32 OS_BinSemFlush(uint32 sem_id) {
   syssts_t sts;
-  binary_semaphore_t *bsp = (binary_semaphore_t *)sem_id;
+  osal_binary_semaphore_t *bsp = (osal_binary_semaphore_t *)sem_id;
 
   /* Range check.*/
-  if ((bsp < &osal.binary_semaphores[0]) ||
-      (bsp >= &osal.binary_semaphores[OS_MAX_BIN_SEMAPHORES])) {
+  if (!IS_TABLE_ENTRY(bsp, osal.binary_semaphores)) {
     return OS_ERR_INVALID_ID;
   }
 
@@ -1092,15 +1490,15 @@ int32 OS_BinSemFlush(uint32 sem_id) {
   sts = chSysGetStatusAndLockX();
 
   /* If the semaphore is not in use then error.*/
-  if (bsp->sem.queue.prev == NULL) {
+  if (bsp->bs.sem.queue.prev == NULL) {
     /* Leaving the critical zone.*/
     chSysRestoreStatusX(sts);
     return OS_SEM_FAILURE;
   }
 
   /* If the semaphore state is "not taken" then it is not touched.*/
-  if (bsp->sem.cnt < 0) {
-    chBSemResetI(bsp, true);
+  if (bsp->bs.sem.cnt < 0) {
+    chBSemResetI(&bsp->bs, true);
   }
 
   /* Leaving the critical zone.*/
@@ -1120,11 +1518,10 @@ int32 OS_BinSemFlush(uint32 sem_id) {
  */
 int32 OS_BinSemGive(uint32 sem_id) {
   syssts_t sts;
-  binary_semaphore_t *bsp = (binary_semaphore_t *)sem_id;
+  osal_binary_semaphore_t *bsp = (osal_binary_semaphore_t *)sem_id;
 
   /* Range check.*/
-  if ((bsp < &osal.binary_semaphores[0]) ||
-      (bsp >= &osal.binary_semaphores[OS_MAX_BIN_SEMAPHORES])) {
+  if (!IS_TABLE_ENTRY(bsp, osal.binary_semaphores)) {
     return OS_ERR_INVALID_ID;
   }
 
@@ -1132,13 +1529,13 @@ int32 OS_BinSemGive(uint32 sem_id) {
   sts = chSysGetStatusAndLockX();
 
   /* If the semaphore is not in use then error.*/
-  if (bsp->sem.queue.prev == NULL) {
+  if (bsp->bs.sem.queue.prev == NULL) {
     /* Leaving the critical zone.*/
     chSysRestoreStatusX(sts);
     return OS_SEM_FAILURE;
   }
 
-  chBSemSignalI(bsp);
+  chBSemSignalI(&bsp->bs);
 
   /* Leaving the critical zone.*/
   chSysRestoreStatusX(sts);
@@ -1155,23 +1552,22 @@ int32 OS_BinSemGive(uint32 sem_id) {
  * @api
  */
 int32 OS_BinSemTake(uint32 sem_id) {
-  binary_semaphore_t *bsp = (binary_semaphore_t *)sem_id;
+  osal_binary_semaphore_t *bsp = (osal_binary_semaphore_t *)sem_id;
 
   /* Range check.*/
-  if ((bsp < &osal.binary_semaphores[0]) ||
-      (bsp >= &osal.binary_semaphores[OS_MAX_BIN_SEMAPHORES])) {
+  if (!IS_TABLE_ENTRY(bsp, osal.binary_semaphores)) {
     return OS_ERR_INVALID_ID;
   }
 
   chSysLock();
 
   /* If the semaphore is not in use then error.*/
-  if (bsp->sem.queue.prev == NULL) {
+  if (bsp->bs.sem.queue.prev == NULL) {
     chSysUnlock();
     return OS_SEM_FAILURE;
   }
 
-  (void) chBSemWaitS(bsp);
+  (void) chBSemWaitS(&bsp->bs);
 
   chSysUnlock();
 
@@ -1188,12 +1584,11 @@ int32 OS_BinSemTake(uint32 sem_id) {
  * @api
  */
 int32 OS_BinSemTimedWait(uint32 sem_id, uint32 msecs) {
-  binary_semaphore_t *bsp = (binary_semaphore_t *)sem_id;
+  osal_binary_semaphore_t *bsp = (osal_binary_semaphore_t *)sem_id;
   msg_t msg;
 
   /* Range check.*/
-  if ((bsp < &osal.binary_semaphores[0]) ||
-      (bsp >= &osal.binary_semaphores[OS_MAX_BIN_SEMAPHORES])) {
+  if (!IS_TABLE_ENTRY(bsp, osal.binary_semaphores)) {
     return OS_ERR_INVALID_ID;
   }
 
@@ -1205,12 +1600,12 @@ int32 OS_BinSemTimedWait(uint32 sem_id, uint32 msecs) {
   chSysLock();
 
   /* If the semaphore is not in use then error.*/
-  if (bsp->sem.queue.prev == NULL) {
+  if (bsp->bs.sem.queue.prev == NULL) {
     chSysUnlock();
     return OS_SEM_FAILURE;
   }
 
-  msg = chBSemWaitTimeoutS(bsp, TIME_MS2I(msecs));
+  msg = chBSemWaitTimeoutS(&bsp->bs, TIME_MS2I(msecs));
 
   chSysUnlock();
 
@@ -1219,7 +1614,6 @@ int32 OS_BinSemTimedWait(uint32 sem_id, uint32 msecs) {
 
 /**
  * @brief   Retrieves a binary semaphore id by name.
- * @note    It is not currently implemented.
  *
  * @param[out] sem_id           pointer to a binary semaphore id variable
  * @param[in] sem_name          the binary semaphore name
@@ -1228,6 +1622,7 @@ int32 OS_BinSemTimedWait(uint32 sem_id, uint32 msecs) {
  * @api
  */
 int32 OS_BinSemGetIdByName(uint32 *sem_id, const char *sem_name) {
+  osal_name_t *onp;
 
   /* NULL pointer checks.*/
   if ((sem_id == NULL) || (sem_name == NULL)) {
@@ -1239,7 +1634,14 @@ int32 OS_BinSemGetIdByName(uint32 *sem_id, const char *sem_name) {
     return OS_ERR_NAME_TOO_LONG;
   }
 
-  return OS_ERR_NOT_IMPLEMENTED;
+  /* Searching the semaphore.*/
+  onp = name_find(&osal.binary_semaphore_names, sem_name);
+  if (onp != NULL) {
+    *sem_id = (uint32)NAME_TO_OBJECT(onp, osal_binary_semaphore_t);
+    return OS_SUCCESS;
+  }
+
+  return OS_ERR_NAME_NOT_FOUND;
 }
 
 /**
@@ -1255,7 +1657,7 @@ int32 OS_BinSemGetIdByName(uint32 *sem_id, const char *sem_name) {
  */
 int32 OS_BinSemGetInfo(uint32 sem_id, OS_bin_sem_prop_t *bin_prop) {
   syssts_t sts;
-  binary_semaphore_t *bsp = (binary_semaphore_t *)sem_id;
+  osal_binary_semaphore_t *bsp = (osal_binary_semaphore_t *)sem_id;
 
   /* NULL pointer checks.*/
   if (bin_prop == NULL) {
@@ -1263,8 +1665,7 @@ int32 OS_BinSemGetInfo(uint32 sem_id, OS_bin_sem_prop_t *bin_prop) {
   }
 
   /* Range check.*/
-  if ((bsp < &osal.binary_semaphores[0]) ||
-      (bsp >= &osal.binary_semaphores[OS_MAX_BIN_SEMAPHORES])) {
+  if (!IS_TABLE_ENTRY(bsp, osal.binary_semaphores)) {
     return OS_ERR_INVALID_ID;
   }
 
@@ -1272,7 +1673,7 @@ int32 OS_BinSemGetInfo(uint32 sem_id, OS_bin_sem_prop_t *bin_prop) {
   sts = chSysGetStatusAndLockX();
 
   /* If the semaphore is not in use then error.*/
-  if (bsp->sem.queue.prev == NULL) {
+  if (bsp->bs.sem.queue.prev == NULL) {
     /* Leaving the critical zone.*/
     chSysRestoreStatusX(sts);
     return OS_ERR_INVALID_ID;
@@ -1299,7 +1700,7 @@ int32 OS_BinSemGetInfo(uint32 sem_id, OS_bin_sem_prop_t *bin_prop) {
  */
 int32 OS_CountSemCreate(uint32 *sem_id, const char *sem_name,
                         uint32 sem_initial_value, uint32 options) {
-  semaphore_t *sp;
+  osal_count_semaphore_t *sp;
 
   (void)options;
 
@@ -1324,8 +1725,14 @@ int32 OS_CountSemCreate(uint32 *sem_id, const char *sem_name,
     return OS_ERR_NO_FREE_IDS;
   }
 
+  /* Assigning the name, it could be already taken.*/
+  if (!name_insert(&osal.count_semaphore_names, &sp->nm, sem_name)) {
+    chPoolFree(&osal.count_semaphores_pool, (void *)sp);
+    return OS_ERR_NAME_TAKEN;
+  }
+
   /* Semaphore is initialized.*/
-  chSemObjectInit(sp, (cnt_t)sem_initial_value);
+  chSemObjectInit(&sp->cs, (cnt_t)sem_initial_value);
 
   *sem_id = (uint32)sp;
 
@@ -1341,21 +1748,21 @@ int32 OS_CountSemCreate(uint32 *sem_id, const char *sem_name,
  * @api
  */
 int32 OS_CountSemDelete(uint32 sem_id) {
-  semaphore_t *sp = (semaphore_t *)sem_id;
+  osal_count_semaphore_t *sp = (osal_count_semaphore_t *)sem_id;
 
   /* Range check.*/
-  if ((sp < &osal.count_semaphores[0]) ||
-      (sp >= &osal.count_semaphores[OS_MAX_COUNT_SEMAPHORES])) {
+  if (!IS_TABLE_ENTRY(sp, osal.count_semaphores)) {
     return OS_ERR_INVALID_ID;
   }
 
   chSysLock();
 
   /* Resetting the semaphore, no threads in queue.*/
-  chSemResetI(sp, 0);
+  chSemResetI(&sp->cs, 0);
 
   /* Flagging it as unused and returning it to the pool.*/
-  sp->queue.prev = NULL;
+  sp->cs.queue.prev = NULL;
+  name_remove_s(&osal.count_semaphore_names, &sp->nm);
   chPoolFreeI(&osal.count_semaphores_pool, (void *)sp);
 
   /* Required because some thread could have been made ready.*/
@@ -1377,11 +1784,10 @@ int32 OS_CountSemDelete(uint32 sem_id) {
  */
 int32 OS_CountSemGive(uint32 sem_id) {
   syssts_t sts;
-  semaphore_t *sp = (semaphore_t *)sem_id;
+  osal_count_semaphore_t *sp = (osal_count_semaphore_t *)sem_id;
 
   /* Range check.*/
-  if ((sp < &osal.count_semaphores[0]) ||
-      (sp >= &osal.count_semaphores[OS_MAX_COUNT_SEMAPHORES])) {
+  if (!IS_TABLE_ENTRY(sp, osal.count_semaphores)) {
     return OS_ERR_INVALID_ID;
   }
 
@@ -1389,13 +1795,13 @@ int32 OS_CountSemGive(uint32 sem_id) {
   sts = chSysGetStatusAndLockX();
 
   /* If the semaphore is not in use then error.*/
-  if (sp->queue.prev == NULL) {
+  if (sp->cs.queue.prev == NULL) {
     /* Leaving the critical zone.*/
     chSysRestoreStatusX(sts);
     return OS_SEM_FAILURE;
   }
 
-  chSemSignalI(sp);
+  chSemSignalI(&sp->cs);
 
   /* Leaving the critical zone.*/
   chSysRestoreStatusX(sts);
@@ -1412,23 +1818,22 @@ int32 OS_CountSemGive(uint32 sem_id) {
  * @api
  */
 int32 OS_CountSemTake(uint32 sem_id) {
-  semaphore_t *sp = (semaphore_t *)sem_id;
+  osal_count_semaphore_t *sp = (osal_count_semaphore_t *)sem_id;
 
   /* Range check.*/
-  if ((sp < &osal.count_semaphores[0]) ||
-      (sp >= &osal.count_semaphores[OS_MAX_COUNT_SEMAPHORES])) {
+  if (!IS_TABLE_ENTRY(sp, osal.count_semaphores)) {
     return OS_ERR_INVALID_ID;
   }
 
   chSysLock();
 
   /* If the semaphore is not in use then error.*/
-  if (sp->queue.prev == NULL) {
+  if (sp->cs.queue.prev == NULL) {
     chSysUnlock();
     return OS_SEM_FAILURE;
   }
 
-  (void) chSemWaitS(sp);
+  (void) chSemWaitS(&sp->cs);
 
   chSysUnlock();
 
@@ -1445,12 +1850,11 @@ int32 OS_CountSemTake(uint32 sem_id) {
  * @api
  */
 int32 OS_CountSemTimedWait(uint32 sem_id, uint32 msecs) {
-  semaphore_t *sp = (semaphore_t *)sem_id;
+  osal_count_semaphore_t *sp = (osal_count_semaphore_t *)sem_id;
   msg_t msg;
 
   /* Range check.*/
-  if ((sp < &osal.count_semaphores[0]) ||
-      (sp >= &osal.count_semaphores[OS_MAX_COUNT_SEMAPHORES])) {
+  if (!IS_TABLE_ENTRY(sp, osal.count_semaphores)) {
     return OS_ERR_INVALID_ID;
   }
 
@@ -1462,12 +1866,12 @@ int32 OS_CountSemTimedWait(uint32 sem_id, uint32 msecs) {
   chSysLock();
 
   /* If the semaphore is not in use then error.*/
-  if (sp->queue.prev == NULL) {
+  if (sp->cs.queue.prev == NULL) {
     chSysUnlock();
     return OS_SEM_FAILURE;
   }
 
-  msg = chSemWaitTimeoutS(sp, TIME_MS2I(msecs));
+  msg = chSemWaitTimeoutS(&sp->cs, TIME_MS2I(msecs));
 
   chSysUnlock();
 
@@ -1476,7 +1880,6 @@ int32 OS_CountSemTimedWait(uint32 sem_id, uint32 msecs) {
 
 /**
  * @brief   Retrieves a counter semaphore id by name.
- * @note    It is not currently implemented.
  *
  * @param[out] sem_id           pointer to a counter semaphore id variable
  * @param[in] sem_name          the counter semaphore name
@@ -1485,6 +1888,7 @@ int32 OS_CountSemTimedWait(uint32 sem_id, uint32 msecs) {
  * @api
  */
 int32 OS_CountSemGetIdByName(uint32 *sem_id, const char *sem_name) {
+  osal_name_t *onp;
 
   /* NULL pointer checks.*/
   if ((sem_id == NULL) || (sem_name == NULL)) {
@@ -1496,7 +1900,14 @@ int32 OS_CountSemGetIdByName(uint32 *sem_id, const char *sem_name) {
     return OS_ERR_NAME_TOO_LONG;
   }
 
-  return OS_ERR_NOT_IMPLEMENTED;
+  /* Searching the semaphore.*/
+  onp = name_find(&osal.count_semaphore_names, sem_name);
+  if (onp != NULL) {
+    *sem_id = (uint32)NAME_TO_OBJECT(onp, osal_count_semaphore_t);
+    return OS_SUCCESS;
+  }
+
+  return OS_ERR_NAME_NOT_FOUND;
 }
 
 /**
@@ -1512,7 +1923,7 @@ int32 OS_CountSemGetIdByName(uint32 *sem_id, const char *sem_name) {
  */
 int32 OS_CountSemGetInfo(uint32 sem_id, OS_count_sem_prop_t *sem_prop) {
   syssts_t sts;
-  semaphore_t *sp = (semaphore_t *)sem_id;
+  osal_count_semaphore_t *sp = (osal_count_semaphore_t *)sem_id;
 
   /* NULL pointer checks.*/
   if (sem_prop == NULL) {
@@ -1520,8 +1931,7 @@ int32 OS_CountSemGetInfo(uint32 sem_id, OS_count_sem_prop_t *sem_prop) {
   }
 
   /* Range check.*/
-  if ((sp < &osal.count_semaphores[0]) ||
-      (sp >= &osal.count_semaphores[OS_MAX_BIN_SEMAPHORES])) {
+  if (!IS_TABLE_ENTRY(sp, osal.count_semaphores)) {
     return OS_ERR_INVALID_ID;
   }
 
@@ -1529,7 +1939,7 @@ int32 OS_CountSemGetInfo(uint32 sem_id, OS_count_sem_prop_t *sem_prop) {
   sts = chSysGetStatusAndLockX();
 
   /* If the semaphore is not in use then error.*/
-  if (sp->queue.prev == NULL) {
+  if (sp->cs.queue.prev == NULL) {
     /* Leaving the critical zone.*/
     chSysRestoreStatusX(sts);
     return OS_ERR_INVALID_ID;
@@ -1554,7 +1964,7 @@ int32 OS_CountSemGetInfo(uint32 sem_id, OS_count_sem_prop_t *sem_prop) {
  * @api
  */
 int32 OS_MutSemCreate(uint32 *sem_id, const char *sem_name, uint32 options) {
-  mutex_t *mp;
+  osal_mutex_t *mp;
 
   (void)options;
 
@@ -1574,8 +1984,14 @@ int32 OS_MutSemCreate(uint32 *sem_id, const char *sem_name, uint32 options) {
     return OS_ERR_NO_FREE_IDS;
   }
 
+  /* Assigning the name, it could be already taken.*/
+  if (!name_insert(&osal.mutex_names, &mp->nm, sem_name)) {
+    chPoolFree(&osal.mutexes_pool, (void *)mp);
+    return OS_ERR_NAME_TAKEN;
+  }
+
   /* Semaphore is initialized.*/
-  chMtxObjectInit(mp);
+  chMtxObjectInit(&mp->m);
 
   *sem_id = (uint32)mp;
 
@@ -1591,11 +2007,10 @@ int32 OS_MutSemCreate(uint32 *sem_id, const char *sem_name, uint32 options) {
  * @api
  */
 int32 OS_MutSemDelete(uint32 sem_id) {
-  mutex_t *mp = (mutex_t *)sem_id;
+  osal_mutex_t *mp = (osal_mutex_t *)sem_id;
 
   /* Range check.*/
-  if ((mp < &osal.mutexes[0]) ||
-      (mp >= &osal.mutexes[OS_MAX_MUTEXES])) {
+  if (!IS_TABLE_ENTRY(mp, osal.mutexes)) {
     return OS_ERR_INVALID_ID;
   }
 
@@ -1605,7 +2020,8 @@ int32 OS_MutSemDelete(uint32 sem_id) {
   chMtxUnlockAllS();
 
   /* Flagging it as unused and returning it to the pool.*/
-  mp->queue.prev = NULL;
+  mp->m.queue.prev = NULL;
+  name_remove_s(&osal.mutex_names, &mp->nm);
   chPoolFreeI(&osal.mutexes_pool, (void *)mp);
 
   /* Required because some thread could have been made ready.*/
@@ -1625,23 +2041,22 @@ int32 OS_MutSemDelete(uint32 sem_id) {
  * @api
  */
 int32 OS_MutSemGive(uint32 sem_id) {
-  mutex_t *mp = (mutex_t *)sem_id;
+  osal_mutex_t *mp = (osal_mutex_t *)sem_id;
 
   /* Range check.*/
-  if ((mp < &osal.mutexes[0]) ||
-      (mp >= &osal.mutexes[OS_MAX_COUNT_SEMAPHORES])) {
+  if (!IS_TABLE_ENTRY(mp, osal.mutexes)) {
     return OS_ERR_INVALID_ID;
   }
 
   chSysLock();
 
   /* If the mutex is not in use then error.*/
-  if (mp->queue.prev == NULL) {
+  if (mp->m.queue.prev == NULL) {
     chSysUnlock();
     return OS_SEM_FAILURE;
   }
 
-  chMtxUnlockS(mp);
+  chMtxUnlockS(&mp->m);
   chSchRescheduleS();
 
   chSysUnlock();
@@ -1658,23 +2073,22 @@ int32 OS_MutSemGive(uint32 sem_id) {
  * @api
  */
 int32 OS_MutSemTake(uint32 sem_id) {
-  mutex_t *mp = (mutex_t *)sem_id;
+  osal_mutex_t *mp = (osal_mutex_t *)sem_id;
 
   /* Range check.*/
-  if ((mp < &osal.mutexes[0]) ||
-      (mp >= &osal.mutexes[OS_MAX_COUNT_SEMAPHORES])) {
+  if (!IS_TABLE_ENTRY(mp, osal.mutexes)) {
     return OS_ERR_INVALID_ID;
   }
 
   chSysLock();
 
   /* If the mutex is not in use then error.*/
-  if (mp->queue.prev == NULL) {
+  if (mp->m.queue.prev == NULL) {
     chSysUnlock();
     return OS_SEM_FAILURE;
   }
 
-  chMtxLockS(mp);
+  chMtxLockS(&mp->m);
 
   chSysUnlock();
 
@@ -1683,7 +2097,6 @@ int32 OS_MutSemTake(uint32 sem_id) {
 
 /**
  * @brief   Retrieves a mutex id by name.
- * @note    It is not currently implemented.
  *
  * @param[out] sem_id           pointer to a mutex id variable
  * @param[in] sem_name          the mutex name
@@ -1692,6 +2105,7 @@ int32 OS_MutSemTake(uint32 sem_id) {
  * @api
  */
 int32 OS_MutSemGetIdByName(uint32 *sem_id, const char *sem_name) {
+  osal_name_t *onp;
 
   /* NULL pointer checks.*/
   if ((sem_id == NULL) || (sem_name == NULL)) {
@@ -1703,7 +2117,14 @@ int32 OS_MutSemGetIdByName(uint32 *sem_id, const char *sem_name) {
     return OS_ERR_NAME_TOO_LONG;
   }
 
-  return OS_ERR_NOT_IMPLEMENTED;
+  /* Searching the semaphore.*/
+  onp = name_find(&osal.mutex_names, sem_name);
+  if (onp != NULL) {
+    *sem_id = (uint32)NAME_TO_OBJECT(onp, osal_mutex_t);
+    return OS_SUCCESS;
+  }
+
+  return OS_ERR_NAME_NOT_FOUND;
 }
 
 /**
@@ -1719,7 +2140,7 @@ int32 OS_MutSemGetIdByName(uint32 *sem_id, const char *sem_name) {
  */
 int32 OS_MutSemGetInfo(uint32 sem_id, OS_mut_sem_prop_t *sem_prop) {
   syssts_t sts;
-  mutex_t *mp = (mutex_t *)sem_id;
+  osal_mutex_t *mp = (osal_mutex_t *)sem_id;
 
   /* NULL pointer checks.*/
   if (sem_prop == NULL) {
@@ -1727,8 +2148,7 @@ int32 OS_MutSemGetInfo(uint32 sem_id, OS_mut_sem_prop_t *sem_prop) {
   }
 
   /* Range check.*/
-  if ((mp < &osal.mutexes[0]) ||
-      (mp >= &osal.mutexes[OS_MAX_BIN_SEMAPHORES])) {
+  if (!IS_TABLE_ENTRY(mp, osal.mutexes)) {
     return OS_ERR_INVALID_ID;
   }
 
@@ -1736,7 +2156,7 @@ int32 OS_MutSemGetInfo(uint32 sem_id, OS_mut_sem_prop_t *sem_prop) {
   sts = chSysGetStatusAndLockX();
 
   /* If the mutex is not in use then error.*/
-  if (mp->queue.prev == NULL) {
+  if (mp->m.queue.prev == NULL) {
     /* Leaving the critical zone.*/
     chSysRestoreStatusX(sts);
     return OS_ERR_INVALID_ID;
@@ -2174,25 +2594,45 @@ int32 OS_IntUnlock(int32 IntLevel) {
   return OS_SUCCESS;
 }
 
+/* The interrupt sources are only controllable on ARM Cortex-M cores, other
+   ports, the simulators for example, do not have an NVIC.*/
 int32 OS_IntEnable(int32 Level) {
 
+#if defined(__CORTEX_M)
   NVIC_EnableIRQ((IRQn_Type)Level);
 
   return OS_SUCCESS;
+#else
+  (void)Level;
+
+  return OS_ERR_NOT_IMPLEMENTED;
+#endif
 }
 
 int32 OS_IntDisable(int32 Level) {
 
+#if defined(__CORTEX_M)
   NVIC_DisableIRQ((IRQn_Type)Level);
 
   return OS_SUCCESS;
+#else
+  (void)Level;
+
+  return OS_ERR_NOT_IMPLEMENTED;
+#endif
 }
 
 int32 OS_IntAck(int32 InterruptNumber) {
 
+#if defined(__CORTEX_M)
   NVIC_ClearPendingIRQ((IRQn_Type)InterruptNumber);
 
   return OS_SUCCESS;
+#else
+  (void)InterruptNumber;
+
+  return OS_ERR_NOT_IMPLEMENTED;
+#endif
 }
 
 /*-- System Exception API ---------------------------------------------------*/
@@ -283,6 +283,13 @@ struct port_context {
 #define PORT_FAST_IRQ_HANDLER(id) void id(void)
 #endif
 
+/**
+ * @brief   Hint for kernel spin loops.
+ * @note    Simulated interrupts are only served when polled, spinning
+ *          threads poll them.
+ */
+#define port_spin_hint() _sim_check_for_interrupts()
+
 /*===========================================================================*/
 /* External declarations.                                                    */
 /*===========================================================================*/
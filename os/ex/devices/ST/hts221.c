@@ -658,7 +658,16 @@ void hts221Start(HTS221Driver *devp, const HTS221Config *config) {
 #endif /* HTS221_SHARED_I2C */
 
   /* Intializing the I2C. */
+#if HTS221_USE_BUS_SCHEDULER
+  if (devp->config->bsp != NULL) {
+    bschedAcquireBus(devp->config->bsp);
+  }
+  else {
+    i2cStart(devp->config->i2cp, devp->config->i2ccfg);
+  }
+#else
   i2cStart(devp->config->i2cp, devp->config->i2ccfg);
+#endif /* HTS221_USE_BUS_SCHEDULER */
 
   hts221Calibrate(devp);
 
@@ -739,6 +748,18 @@ void hts221Start(HTS221Driver *devp, const HTS221Config *config) {
 #endif /* HTS221_SHARED_I2C */
   }
 
+#if HTS221_USE_BUS_SCHEDULER
+  if (devp->config->bsp != NULL) {
+    bschedReleaseBus(devp->config->bsp);
+
+    /* Asynchronous read of the humidity and temperature outputs.*/
+    devp->rdreg = HTS221_AD_HUMIDITY_OUT_L | HTS221_SUB_MS;
+    bschedXferObjectInit(&devp->xfer, HTS221_SAD, &devp->rdreg, 1U,
+                         devp->rdbuf, sizeof (devp->rdbuf));
+    bschedChainObjectInit(&devp->chain, &devp->xfer, 1U, NULL, NULL);
+  }
+#endif /* HTS221_USE_BUS_SCHEDULER */
+
   /* This is the MEMS transient recovery time */
   osalThreadSleepMilliseconds(5);
 
@@ -766,16 +787,108 @@ void hts221Stop(HTS221Driver *devp) {
   i2cAcquireBus(devp->config->i2cp);
   i2cStart(devp->config->i2cp, devp->config->i2ccfg);
 #endif /* HTS221_SHARED_I2C */
+#if HTS221_USE_BUS_SCHEDULER
+  if (devp->config->bsp != NULL) {
+    osalDbgAssert(devp->chain.done, "hts221Stop(), read pending");
+    bschedAcquireBus(devp->config->bsp);
+  }
+#endif /* HTS221_USE_BUS_SCHEDULER */
 
   cr[0] = HTS221_AD_CTRL_REG1;
   cr[1] = 0;
   hts221I2CWriteRegister(devp->config->i2cp, cr, 1);
 
+#if HTS221_USE_BUS_SCHEDULER
+  /* The I2C driver is owned by the scheduler.*/
+  if (devp->config->bsp != NULL) {
+    bschedReleaseBus(devp->config->bsp);
+  }
+  else {
+    i2cStop(devp->config->i2cp);
+  }
+#else
   i2cStop(devp->config->i2cp);
+#endif /* HTS221_USE_BUS_SCHEDULER */
 #if HTS221_SHARED_I2C
   i2cReleaseBus(devp->config->i2cp);
 #endif /* HTS221_SHARED_I2C */
   }
   devp->state = HTS221_STOP;
 }
+
+#if (HTS221_USE_BUS_SCHEDULER) || defined(__DOXYGEN__)
+/**
+ * @brief   Starts an asynchronous read of the raw data.
+ * @details Humidity and temperature output registers are read in a single
+ *          transfer queued on the bus scheduler, the callback is invoked
+ *          from the ISR context on completion.
+ * @pre     The previous asynchronous read has been completed.
+ *
+ * @param[in] devp      pointer to the @p HTS221Driver object
+ * @param[in] cb        completion callback or @p NULL
+ * @param[in] arg       callback argument
+ *
+ * @iclass
+ */
+void hts221StartReadRawI(HTS221Driver *devp,
+                         bschedcallback_t cb, void *arg) {
+
+  osalDbgCheckClassI();
+  osalDbgCheck(devp != NULL);
+  osalDbgAssert((devp->state == HTS221_READY),
+                "hts221StartReadRawI(), invalid state");
+  osalDbgAssert((devp->config->bsp != NULL),
+                "hts221StartReadRawI(), no scheduler");
+
+  devp->chain.cb  = cb;
+  devp->chain.arg = arg;
+  bschedSubmitI(devp->config->bsp, &devp->chain);
+}
+
+/**
+ * @brief   Starts an asynchronous read of the raw data.
+ * @details Humidity and temperature output registers are read in a single
+ *          transfer queued on the bus scheduler, the callback is invoked
+ *          from the ISR context on completion.
+ * @pre     The previous asynchronous read has been completed.
+ *
+ * @param[in] devp      pointer to the @p HTS221Driver object
+ * @param[in] cb        completion callback or @p NULL
+ * @param[in] arg       callback argument
+ *
+ * @api
+ */
+void hts221StartReadRaw(HTS221Driver *devp,
+                        bschedcallback_t cb, void *arg) {
+
+  osalSysLock();
+  hts221StartReadRawI(devp, cb, arg);
+  osalSysUnlock();
+}
+
+/**
+ * @brief   Retrieves the raw data of the last asynchronous read.
+ * @note    The axes arrays must be at least the same size of the
+ *          BaseHygrometer and BaseThermometer axes numbers.
+ *
+ * @param[in] devp      pointer to the @p HTS221Driver object
+ * @param[out] hygroaxes a buffer which would be filled with hygrometer raw
+ *                      data
+ * @param[out] thermoaxes a buffer which would be filled with thermometer
+ *                      raw data
+ *
+ * @xclass
+ */
+void hts221GetRaw(HTS221Driver *devp, int32_t hygroaxes[],
+                  int32_t thermoaxes[]) {
+  int16_t tmp;
+
+  osalDbgCheck((devp != NULL) && (hygroaxes != NULL) && (thermoaxes != NULL));
+
+  tmp = (int16_t)(devp->rdbuf[0] + (devp->rdbuf[1] << 8));
+  hygroaxes[0] = (int32_t)tmp;
+  tmp = (int16_t)(devp->rdbuf[2] + (devp->rdbuf[3] << 8));
+  thermoaxes[0] = (int32_t)tmp;
+}
+#endif /* HTS221_USE_BUS_SCHEDULER */
 /** @} */
@@ -213,6 +213,19 @@
 #define HTS221_SHARED_I2C                   FALSE
 #endif
 
+/**
+ * @brief   HTS221 bus scheduler switch.
+ * @details If set to @p TRUE the asynchronous read API is included, the
+ *          transfers are queued on a bus scheduler driving the I2C bus.
+ * @note    The default is @p FALSE. While the scheduler is running the
+ *          other functions must be invoked between @p bschedAcquireBus()
+ *          and @p bschedReleaseBus(), @p hts221Start() and
+ *          @p hts221Stop() do it internally.
+ */
+#if !defined(HTS221_USE_BUS_SCHEDULER) || defined(__DOXYGEN__)
+#define HTS221_USE_BUS_SCHEDULER            FALSE
+#endif
+
 /**
  * @brief   HTS221 advanced configurations switch.
  * @details If set to @p TRUE more configurations are available.
@@ -247,6 +260,14 @@
 #error "HTS221_SHARED_I2C requires I2C_USE_MUTUAL_EXCLUSION"
 #endif
 
+#if HTS221_USE_BUS_SCHEDULER && (!HTS221_USE_I2C || HTS221_SHARED_I2C)
+#error "HTS221_USE_BUS_SCHEDULER requires HTS221_USE_I2C without HTS221_SHARED_I2C"
+#endif
+
+#if HTS221_USE_BUS_SCHEDULER
+#include "hal_bus_scheduler.h"
+#endif
+
 /*
  * CHTODO: Add support for HTS221 over SPI.
  */
@@ -347,6 +368,15 @@ typedef struct {
    */
   const I2CConfig           *i2ccfg;
 #endif /* HTS221_USE_I2C */
+#if (HTS221_USE_BUS_SCHEDULER) || defined(__DOXYGEN__)
+  /**
+   * @brief Bus scheduler for the asynchronous reads or @p NULL.
+   * @note  The scheduler must be started on the I2C driver of this HTS221
+   *        before the device, the I2C driver is then owned by the
+   *        scheduler.
+   */
+  BSchedDriver              *bsp;
+#endif /* HTS221_USE_BUS_SCHEDULER */
   /**
    * @brief HTS221 hygrometer subsystem initial sensitivity.
    */
@@ -445,6 +475,16 @@ struct HTS221Driver {
   /** @brief Base thermometer interface.*/
   BaseThermometer           thermo_if;
   _hts221_data
+#if (HTS221_USE_BUS_SCHEDULER) || defined(__DOXYGEN__)
+  /** @brief Asynchronous read chain.*/
+  bsched_chain_t            chain;
+  /** @brief Asynchronous read transfer.*/
+  bsched_xfer_t             xfer;
+  /** @brief Asynchronous read first register.*/
+  uint8_t                   rdreg;
+  /** @brief Asynchronous read buffer, humidity then temperature.*/
+  uint8_t                   rdbuf[4];
+#endif /* HTS221_USE_BUS_SCHEDULER */
 };
 /** @} */
 
@@ -688,6 +728,27 @@ struct HTS221Driver {
 #define hts221ThermometerResetSensitivity(devp)                             \
         thermometerResetSensitivity(&((devp)->thermo_if))
 
+#if (HTS221_USE_BUS_SCHEDULER) || defined(__DOXYGEN__)
+/**
+ * @brief   Waits for the completion of an asynchronous read.
+ *
+ * @param[in] devp      pointer to @p HTS221Driver.
+ * @param[in] timeout   the number of ticks before the operation timeouts,
+ *                      the following special values are allowed:
+ *                      - @a TIME_IMMEDIATE immediate timeout.
+ *                      - @a TIME_INFINITE no timeout.
+ *                      .
+ * @return              The operation status.
+ * @retval MSG_OK       if the function succeeded.
+ * @retval MSG_RESET    if one or more I2C errors occurred.
+ * @retval MSG_TIMEOUT  if the read is still pending.
+ *
+ * @api
+ */
+#define hts221WaitReadRawTimeout(devp, timeout)                             \
+        bschedWaitTimeout(&(devp)->chain, timeout)
+#endif /* HTS221_USE_BUS_SCHEDULER */
+
 /*===========================================================================*/
 /* External declarations.                                                    */
 /*===========================================================================*/
@@ -698,6 +759,14 @@ extern "C" {
   void hts221ObjectInit(HTS221Driver *devp);
   void hts221Start(HTS221Driver *devp, const HTS221Config *config);
   void hts221Stop(HTS221Driver *devp);
+#if HTS221_USE_BUS_SCHEDULER
+  void hts221StartReadRawI(HTS221Driver *devp,
+                           bschedcallback_t cb, void *arg);
+  void hts221StartReadRaw(HTS221Driver *devp,
+                          bschedcallback_t cb, void *arg);
+  void hts221GetRaw(HTS221Driver *devp, int32_t hygroaxes[],
+                    int32_t thermoaxes[]);
+#endif
 #ifdef __cplusplus
 }
 #endif
@@ -581,7 +581,16 @@ void lps22hbStart(LPS22HBDriver *devp, const LPS22HBConfig *config) {
   i2cAcquireBus(devp->config->i2cp);
 #endif /* LPS22HB_SHARED_I2C */
 
+#if LPS22HB_USE_BUS_SCHEDULER
+  if (devp->config->bsp != NULL) {
+    bschedAcquireBus(devp->config->bsp);
+  }
+  else {
+    i2cStart(devp->config->i2cp, devp->config->i2ccfg);
+  }
+#else
   i2cStart(devp->config->i2cp, devp->config->i2ccfg);
+#endif /* LPS22HB_USE_BUS_SCHEDULER */
   lps22hbI2CWriteRegister(devp->config->i2cp, devp->config->slaveaddress,
                           cr, 1);
 
@@ -611,6 +620,18 @@ void lps22hbStart(LPS22HBDriver *devp, const LPS22HBConfig *config) {
   i2cReleaseBus((devp)->config->i2cp);
 #endif /* LPS22HB_SHARED_I2C */
 
+#if LPS22HB_USE_BUS_SCHEDULER
+  if (devp->config->bsp != NULL) {
+    bschedReleaseBus(devp->config->bsp);
+
+    /* Asynchronous read of the pressure and temperature outputs.*/
+    devp->rdreg = LPS22HB_AD_PRESS_OUT_XL;
+    bschedXferObjectInit(&devp->xfer, devp->config->slaveaddress,
+                         &devp->rdreg, 1U, devp->rdbuf, sizeof (devp->rdbuf));
+    bschedChainObjectInit(&devp->chain, &devp->xfer, 1U, NULL, NULL);
+  }
+#endif /* LPS22HB_USE_BUS_SCHEDULER */
+
   if(devp->config->barosensitivity == NULL) {
     devp->barosensitivity = LPS22HB_BARO_SENS;
   }
@@ -670,17 +691,109 @@ void lps22hbStop(LPS22HBDriver *devp) {
     i2cStart((devp)->config->i2cp,
              (devp)->config->i2ccfg);
 #endif /* LPS22HB_SHARED_I2C */
+#if LPS22HB_USE_BUS_SCHEDULER
+    if (devp->config->bsp != NULL) {
+      osalDbgAssert(devp->chain.done, "lps22hbStop(), read pending");
+      bschedAcquireBus(devp->config->bsp);
+    }
+#endif /* LPS22HB_USE_BUS_SCHEDULER */
 
     cr[0] = LPS22HB_AD_CTRL_REG1;
     cr[1] = 0;
     lps22hbI2CWriteRegister(devp->config->i2cp, devp->config->slaveaddress,
                             cr, 1);
 
+#if LPS22HB_USE_BUS_SCHEDULER
+    /* The I2C driver is owned by the scheduler.*/
+    if (devp->config->bsp != NULL) {
+      bschedReleaseBus(devp->config->bsp);
+    }
+    else {
+      i2cStop((devp)->config->i2cp);
+    }
+#else
     i2cStop((devp)->config->i2cp);
+#endif /* LPS22HB_USE_BUS_SCHEDULER */
 #if  LPS22HB_SHARED_I2C
     i2cReleaseBus((devp)->config->i2cp);
 #endif /* LPS22HB_SHARED_I2C */
   }
   devp->state = LPS22HB_STOP;
 }
+
+#if (LPS22HB_USE_BUS_SCHEDULER) || defined(__DOXYGEN__)
+/**
+ * @brief   Starts an asynchronous read of the raw data.
+ * @details Pressure and temperature output registers are read in a single
+ *          transfer queued on the bus scheduler, the callback is invoked
+ *          from the ISR context on completion.
+ * @pre     The previous asynchronous read has been completed.
+ *
+ * @param[in] devp      pointer to the @p LPS22HBDriver object
+ * @param[in] cb        completion callback or @p NULL
+ * @param[in] arg       callback argument
+ *
+ * @iclass
+ */
+void lps22hbStartReadRawI(LPS22HBDriver *devp,
+                          bschedcallback_t cb, void *arg) {
+
+  osalDbgCheckClassI();
+  osalDbgCheck(devp != NULL);
+  osalDbgAssert((devp->state == LPS22HB_READY),
+                "lps22hbStartReadRawI(), invalid state");
+  osalDbgAssert((devp->config->bsp != NULL),
+                "lps22hbStartReadRawI(), no scheduler");
+
+  devp->chain.cb  = cb;
+  devp->chain.arg = arg;
+  bschedSubmitI(devp->config->bsp, &devp->chain);
+}
+
+/**
+ * @brief   Starts an asynchronous read of the raw data.
+ * @details Pressure and temperature output registers are read in a single
+ *          transfer queued on the bus scheduler, the callback is invoked
+ *          from the ISR context on completion.
+ * @pre     The previous asynchronous read has been completed.
+ *
+ * @param[in] devp      pointer to the @p LPS22HBDriver object
+ * @param[in] cb        completion callback or @p NULL
+ * @param[in] arg       callback argument
+ *
+ * @api
+ */
+void lps22hbStartReadRaw(LPS22HBDriver *devp,
+                         bschedcallback_t cb, void *arg) {
+
+  osalSysLock();
+  lps22hbStartReadRawI(devp, cb, arg);
+  osalSysUnlock();
+}
+
+/**
+ * @brief   Retrieves the raw data of the last asynchronous read.
+ * @note    The axes arrays must be at least the same size of the
+ *          BaseBarometer and BaseThermometer axes numbers.
+ *
+ * @param[in] devp      pointer to the @p LPS22HBDriver object
+ * @param[out] baroaxes a buffer which would be filled with barometer raw
+ *                      data
+ * @param[out] thermoaxes a buffer which would be filled with thermometer
+ *                      raw data
+ *
+ * @xclass
+ */
+void lps22hbGetRaw(LPS22HBDriver *devp, int32_t baroaxes[],
+                   int32_t thermoaxes[]) {
+  int16_t tmp;
+
+  osalDbgCheck((devp != NULL) && (baroaxes != NULL) && (thermoaxes != NULL));
+
+  baroaxes[0] = devp->rdbuf[0] + (devp->rdbuf[1] << 8) +
+                (devp->rdbuf[2] << 16);
+  tmp = (int16_t)(devp->rdbuf[3] + (devp->rdbuf[4] << 8));
+  thermoaxes[0] = (int32_t)tmp;
+}
+#endif /* LPS22HB_USE_BUS_SCHEDULER */
 /** @} */
@@ -246,6 +246,19 @@
 #define LPS22HB_SHARED_I2C                  FALSE
 #endif
 
+/**
+ * @brief   LPS22HB bus scheduler switch.
+ * @details If set to @p TRUE the asynchronous read API is included, the
+ *          transfers are queued on a bus scheduler driving the I2C bus.
+ * @note    The default is @p FALSE. While the scheduler is running the
+ *          other functions must be invoked between @p bschedAcquireBus()
+ *          and @p bschedReleaseBus(), @p lps22hbStart() and
+ *          @p lps22hbStop() do it internally.
+ */
+#if !defined(LPS22HB_USE_BUS_SCHEDULER) || defined(__DOXYGEN__)
+#define LPS22HB_USE_BUS_SCHEDULER           FALSE
+#endif
+
 /**
  * @brief   LPS22HB advanced configurations switch.
  * @details If set to @p TRUE more configurations are available.
@@ -280,6 +293,14 @@
 #error "LPS22HB_SHARED_I2C requires I2C_USE_MUTUAL_EXCLUSION"
 #endif
 
+#if LPS22HB_USE_BUS_SCHEDULER && (!LPS22HB_USE_I2C || LPS22HB_SHARED_I2C)
+#error "LPS22HB_USE_BUS_SCHEDULER requires LPS22HB_USE_I2C without LPS22HB_SHARED_I2C"
+#endif
+
+#if LPS22HB_USE_BUS_SCHEDULER
+#include "hal_bus_scheduler.h"
+#endif
+
 /*
  * CHTODO: Add support for LPS22HB over SPI.
  */
@@ -375,6 +396,15 @@ typedef struct {
    */
   lps22hb_sad_t             slaveaddress;
 #endif /* LPS22HB_USE_I2C */
+#if (LPS22HB_USE_BUS_SCHEDULER) || defined(__DOXYGEN__)
+  /**
+   * @brief Bus scheduler for the asynchronous reads or @p NULL.
+   * @note  The scheduler must be started on the I2C driver of this LPS22HB
+   *        before the device, the I2C driver is then owned by the
+   *        scheduler.
+   */
+  BSchedDriver              *bsp;
+#endif /* LPS22HB_USE_BUS_SCHEDULER */
   /**
    * @brief LPS22HB barometer subsystem initial sensitivity.
    */
@@ -461,6 +491,16 @@ struct LPS22HBDriver {
   /** @brief Base thermometer interface.*/
   BaseThermometer           thermo_if;
   _lps22hb_data
+#if (LPS22HB_USE_BUS_SCHEDULER) || defined(__DOXYGEN__)
+  /** @brief Asynchronous read chain.*/
+  bsched_chain_t            chain;
+  /** @brief Asynchronous read transfer.*/
+  bsched_xfer_t             xfer;
+  /** @brief Asynchronous read first register.*/
+  uint8_t                   rdreg;
+  /** @brief Asynchronous read buffer, pressure then temperature.*/
+  uint8_t                   rdbuf[5];
+#endif /* LPS22HB_USE_BUS_SCHEDULER */
 };
 /** @} */
 
@@ -703,6 +743,27 @@ struct LPS22HBDriver {
  */
 #define lps22hbThermometerResetSensitivity(devp)                            \
         thermometerResetSensitivity(&((devp)->thermo_if))
+
+#if (LPS22HB_USE_BUS_SCHEDULER) || defined(__DOXYGEN__)
+/**
+ * @brief   Waits for the completion of an asynchronous read.
+ *
+ * @param[in] devp      pointer to @p LPS22HBDriver.
+ * @param[in] timeout   the number of ticks before the operation timeouts,
+ *                      the following special values are allowed:
+ *                      - @a TIME_IMMEDIATE immediate timeout.
+ *                      - @a TIME_INFINITE no timeout.
+ *                      .
+ * @return              The operation status.
+ * @retval MSG_OK       if the function succeeded.
+ * @retval MSG_RESET    if one or more I2C errors occurred.
+ * @retval MSG_TIMEOUT  if the read is still pending.
+ *
+ * @api
+ */
+#define lps22hbWaitReadRawTimeout(devp, timeout)                            \
+        bschedWaitTimeout(&(devp)->chain, timeout)
+#endif /* LPS22HB_USE_BUS_SCHEDULER */
         
 /*===========================================================================*/
 /* External declarations.                                                    */
@@ -714,6 +775,14 @@ extern "C" {
   void lps22hbObjectInit(LPS22HBDriver *devp);
   void lps22hbStart(LPS22HBDriver *devp, const LPS22HBConfig *config);
   void lps22hbStop(LPS22HBDriver *devp);
+#if LPS22HB_USE_BUS_SCHEDULER
+  void lps22hbStartReadRawI(LPS22HBDriver *devp,
+                            bschedcallback_t cb, void *arg);
+  void lps22hbStartReadRaw(LPS22HBDriver *devp,
+                           bschedcallback_t cb, void *arg);
+  void lps22hbGetRaw(LPS22HBDriver *devp, int32_t baroaxes[],
+                     int32_t thermoaxes[]);
+#endif
 #ifdef __cplusplus
 }
 #endif
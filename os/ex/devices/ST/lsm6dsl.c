@@ -871,7 +871,16 @@ void lsm6dslStart(LSM6DSLDriver *devp, const LSM6DSLConfig *config) {
   i2cAcquireBus(devp->config->i2cp);
 #endif /* LSM6DSL_SHARED_I2C */
 
+#if LSM6DSL_USE_BUS_SCHEDULER
+  if (devp->config->bsp != NULL) {
+    bschedAcquireBus(devp->config->bsp);
+  }
+  else {
+    i2cStart(devp->config->i2cp, devp->config->i2ccfg);
+  }
+#else
   i2cStart(devp->config->i2cp, devp->config->i2ccfg);
+#endif /* LSM6DSL_USE_BUS_SCHEDULER */
   lsm6dslI2CWriteRegister(devp->config->i2cp, devp->config->slaveaddress,
                           cr, 1);
 
@@ -967,6 +976,18 @@ void lsm6dslStart(LSM6DSLDriver *devp, const LSM6DSLConfig *config) {
 #endif /* LSM6DSL_SHARED_I2C */
 #endif /* LSM6DSL_USE_I2C */
 
+#if LSM6DSL_USE_BUS_SCHEDULER
+  if (devp->config->bsp != NULL) {
+    bschedReleaseBus(devp->config->bsp);
+
+    /* Asynchronous read of the gyroscope and accelerometer outputs.*/
+    devp->rdreg = LSM6DSL_AD_OUTX_L_G;
+    bschedXferObjectInit(&devp->xfer, devp->config->slaveaddress,
+                         &devp->rdreg, 1U, devp->rdbuf, sizeof (devp->rdbuf));
+    bschedChainObjectInit(&devp->chain, &devp->xfer, 1U, NULL, NULL);
+  }
+#endif /* LSM6DSL_USE_BUS_SCHEDULER */
+
   /* Storing sensitivity according to user settings */
   if(devp->config->accfullscale == LSM6DSL_ACC_FS_2G) {
     for(i = 0; i < LSM6DSL_ACC_NUMBER_OF_AXES; i++) {
@@ -1085,7 +1106,7 @@ void lsm6dslStart(LSM6DSLDriver *devp, const LSM6DSLConfig *config) {
  * @api
  */
 void lsm6dslStop(LSM6DSLDriver *devp) {
-  uint8_t cr[2];
+  uint8_t cr[3];
 
   osalDbgCheck(devp != NULL);
 
@@ -1098,6 +1119,12 @@ void lsm6dslStop(LSM6DSLDriver *devp) {
     i2cAcquireBus(devp->config->i2cp);
     i2cStart(devp->config->i2cp, devp->config->i2ccfg);
 #endif /* LSM6DSL_SHARED_I2C */
+#if LSM6DSL_USE_BUS_SCHEDULER
+    if (devp->config->bsp != NULL) {
+      osalDbgAssert(devp->chain.done, "lsm6dslStop(), read pending");
+      bschedAcquireBus(devp->config->bsp);
+    }
+#endif /* LSM6DSL_USE_BUS_SCHEDULER */
 
 
     cr[0] = LSM6DSL_AD_CTRL1_XL;
@@ -1108,7 +1135,17 @@ void lsm6dslStop(LSM6DSLDriver *devp) {
     lsm6dslI2CWriteRegister(devp->config->i2cp, devp->config->slaveaddress,
                             cr, 2);
 
+#if LSM6DSL_USE_BUS_SCHEDULER
+    /* The I2C driver is owned by the scheduler.*/
+    if (devp->config->bsp != NULL) {
+      bschedReleaseBus(devp->config->bsp);
+    }
+    else {
+      i2cStop(devp->config->i2cp);
+    }
+#else
     i2cStop(devp->config->i2cp);
+#endif /* LSM6DSL_USE_BUS_SCHEDULER */
 #if LSM6DSL_SHARED_I2C
     i2cReleaseBus(devp->config->i2cp);
 #endif /* LSM6DSL_SHARED_I2C */
@@ -1116,4 +1153,88 @@ void lsm6dslStop(LSM6DSLDriver *devp) {
   }
   devp->state = LSM6DSL_STOP;
 }
+
+#if (LSM6DSL_USE_BUS_SCHEDULER) || defined(__DOXYGEN__)
+/**
+ * @brief   Starts an asynchronous read of the raw data.
+ * @details Gyroscope and accelerometer output registers are read in a
+ *          single transfer queued on the bus scheduler, the callback is
+ *          invoked from the ISR context on completion.
+ * @pre     The previous asynchronous read has been completed.
+ *
+ * @param[in] devp      pointer to the @p LSM6DSLDriver object
+ * @param[in] cb        completion callback or @p NULL
+ * @param[in] arg       callback argument
+ *
+ * @iclass
+ */
+void lsm6dslStartReadRawI(LSM6DSLDriver *devp,
+                          bschedcallback_t cb, void *arg) {
+
+  osalDbgCheckClassI();
+  osalDbgCheck(devp != NULL);
+  osalDbgAssert((devp->state == LSM6DSL_READY),
+                "lsm6dslStartReadRawI(), invalid state");
+  osalDbgAssert((devp->config->bsp != NULL),
+                "lsm6dslStartReadRawI(), no scheduler");
+
+  devp->chain.cb  = cb;
+  devp->chain.arg = arg;
+  bschedSubmitI(devp->config->bsp, &devp->chain);
+}
+
+/**
+ * @brief   Starts an asynchronous read of the raw data.
+ * @details Gyroscope and accelerometer output registers are read in a
+ *          single transfer queued on the bus scheduler, the callback is
+ *          invoked from the ISR context on completion.
+ * @pre     The previous asynchronous read has been completed.
+ *
+ * @param[in] devp      pointer to the @p LSM6DSLDriver object
+ * @param[in] cb        completion callback or @p NULL
+ * @param[in] arg       callback argument
+ *
+ * @api
+ */
+void lsm6dslStartReadRaw(LSM6DSLDriver *devp,
+                         bschedcallback_t cb, void *arg) {
+
+  osalSysLock();
+  lsm6dslStartReadRawI(devp, cb, arg);
+  osalSysUnlock();
+}
+
+/**
+ * @brief   Retrieves the raw data of the last asynchronous read.
+ * @note    The axes arrays must be at least the same size of the
+ *          BaseAccelerometer and BaseGyroscope axes numbers.
+ *
+ * @param[in] devp      pointer to the @p LSM6DSLDriver object
+ * @param[out] accaxes  a buffer which would be filled with accelerometer
+ *                      raw data
+ * @param[out] gyroaxes a buffer which would be filled with gyroscope
+ *                      raw data
+ *
+ * @xclass
+ */
+void lsm6dslGetRaw(LSM6DSLDriver *devp, int32_t accaxes[],
+                   int32_t gyroaxes[]) {
+  const uint8_t *bp;
+  int16_t tmp;
+  unsigned i;
+
+  osalDbgCheck((devp != NULL) && (accaxes != NULL) && (gyroaxes != NULL));
+
+  bp = devp->rdbuf;
+  for (i = 0U; i < LSM6DSL_GYRO_NUMBER_OF_AXES; i++) {
+    tmp = (int16_t)(bp[2U * i] + (bp[2U * i + 1U] << 8));
+    gyroaxes[i] = (int32_t)tmp;
+  }
+  bp += LSM6DSL_GYRO_NUMBER_OF_AXES * 2U;
+  for (i = 0U; i < LSM6DSL_ACC_NUMBER_OF_AXES; i++) {
+    tmp = (int16_t)(bp[2U * i] + (bp[2U * i + 1U] << 8));
+    accaxes[i] = (int32_t)tmp;
+  }
+}
+#endif /* LSM6DSL_USE_BUS_SCHEDULER */
 /** @} */
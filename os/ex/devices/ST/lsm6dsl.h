@@ -398,6 +398,19 @@
 #define LSM6DSL_SHARED_I2C                  FALSE
 #endif
 
+/**
+ * @brief   LSM6DSL bus scheduler switch.
+ * @details If set to @p TRUE the asynchronous read API is included, the
+ *          transfers are queued on a bus scheduler driving the I2C bus.
+ * @note    The default is @p FALSE. While the scheduler is running the
+ *          other functions must be invoked between @p bschedAcquireBus()
+ *          and @p bschedReleaseBus(), @p lsm6dslStart() and
+ *          @p lsm6dslStop() do it internally.
+ */
+#if !defined(LSM6DSL_USE_BUS_SCHEDULER) || defined(__DOXYGEN__)
+#define LSM6DSL_USE_BUS_SCHEDULER           FALSE
+#endif
+
 /**
  * @brief   LSM6DSL advanced configurations switch.
  * @details If set to @p TRUE more configurations are available.
@@ -449,6 +462,14 @@
 #error "LSM6DSL_SHARED_I2C requires I2C_USE_MUTUAL_EXCLUSION"
 #endif
 
+#if LSM6DSL_USE_BUS_SCHEDULER && (!LSM6DSL_USE_I2C || LSM6DSL_SHARED_I2C)
+#error "LSM6DSL_USE_BUS_SCHEDULER requires LSM6DSL_USE_I2C without LSM6DSL_SHARED_I2C"
+#endif
+
+#if LSM6DSL_USE_BUS_SCHEDULER
+#include "hal_bus_scheduler.h"
+#endif
+
 /*
  * CHTODO: Add support for LSM6DSL over SPI.
  */
@@ -615,6 +636,15 @@ typedef struct {
    */
   lsm6dsl_sad_t             slaveaddress;
 #endif /* LSM6DSL_USE_I2C */
+#if (LSM6DSL_USE_BUS_SCHEDULER) || defined(__DOXYGEN__)
+  /**
+   * @brief Bus scheduler for the asynchronous reads or @p NULL.
+   * @note  The scheduler must be started on the I2C driver of this LSM6DSL
+   *        before the device, the I2C driver is then owned by the
+   *        scheduler.
+   */
+  BSchedDriver              *bsp;
+#endif /* LSM6DSL_USE_BUS_SCHEDULER */
   /**
    * @brief LSM6DSL accelerometer subsystem initial sensitivity.
    */
@@ -735,6 +765,17 @@ struct LSM6DSLDriver {
   /** @brief Base gyroscope interface.*/
   BaseGyroscope               gyro_if;
   _lsm6dsl_data
+#if (LSM6DSL_USE_BUS_SCHEDULER) || defined(__DOXYGEN__)
+  /** @brief Asynchronous read chain.*/
+  bsched_chain_t              chain;
+  /** @brief Asynchronous read transfer.*/
+  bsched_xfer_t               xfer;
+  /** @brief Asynchronous read first register.*/
+  uint8_t                     rdreg;
+  /** @brief Asynchronous read buffer, gyroscope then accelerometer.*/
+  uint8_t                     rdbuf[(LSM6DSL_GYRO_NUMBER_OF_AXES +
+                                     LSM6DSL_ACC_NUMBER_OF_AXES) * 2];
+#endif /* LSM6DSL_USE_BUS_SCHEDULER */
 };
 /** @} */
 
@@ -1036,6 +1077,27 @@ struct LSM6DSLDriver {
 #define lsm6dslGyroscopeSetFullScale(devp, fs)                              \
         (devp)->vmt->acc_set_full_scale(devp, fs)
 
+#if (LSM6DSL_USE_BUS_SCHEDULER) || defined(__DOXYGEN__)
+/**
+ * @brief   Waits for the completion of an asynchronous read.
+ *
+ * @param[in] devp      pointer to @p LSM6DSLDriver.
+ * @param[in] timeout   the number of ticks before the operation timeouts,
+ *                      the following special values are allowed:
+ *                      - @a TIME_IMMEDIATE immediate timeout.
+ *                      - @a TIME_INFINITE no timeout.
+ *                      .
+ * @return              The operation status.
+ * @retval MSG_OK       if the function succeeded.
+ * @retval MSG_RESET    if one or more I2C errors occurred.
+ * @retval MSG_TIMEOUT  if the read is still pending.
+ *
+ * @api
+ */
+#define lsm6dslWaitReadRawTimeout(devp, timeout)                            \
+        bschedWaitTimeout(&(devp)->chain, timeout)
+#endif /* LSM6DSL_USE_BUS_SCHEDULER */
+
 /*===========================================================================*/
 /* External declarations.                                                    */
 /*===========================================================================*/
@@ -1046,6 +1108,14 @@ extern "C" {
   void lsm6dslObjectInit(LSM6DSLDriver *devp);
   void lsm6dslStart(LSM6DSLDriver *devp, const LSM6DSLConfig *config);
   void lsm6dslStop(LSM6DSLDriver *devp);
+#if LSM6DSL_USE_BUS_SCHEDULER
+  void lsm6dslStartReadRawI(LSM6DSLDriver *devp,
+                            bschedcallback_t cb, void *arg);
+  void lsm6dslStartReadRaw(LSM6DSLDriver *devp,
+                           bschedcallback_t cb, void *arg);
+  void lsm6dslGetRaw(LSM6DSLDriver *devp, int32_t accaxes[],
+                     int32_t gyroaxes[]);
+#endif
 #ifdef __cplusplus
 }
 #endif
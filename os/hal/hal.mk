@@ -26,7 +26,8 @@ ifneq ($(findstring HAL_USE_CAN TRUE,$(HALCONF)),)
 HALSRC += $(CHIBIOS)/os/hal/src/hal_can.c
 endif
 ifneq ($(findstring HAL_USE_CRY TRUE,$(HALCONF)),)
-HALSRC += $(CHIBIOS)/os/hal/src/hal_crypto.c
+HALSRC += $(CHIBIOS)/os/hal/src/hal_crypto.c \
+          $(CHIBIOS)/os/hal/src/hal_crypto_fallback.c
 endif
 ifneq ($(findstring HAL_USE_DAC TRUE,$(HALCONF)),)
 HALSRC += $(CHIBIOS)/os/hal/src/hal_dac.c
@@ -71,7 +72,8 @@ ifneq ($(findstring HAL_USE_SERIAL_USB TRUE,$(HALCONF)),)
 HALSRC += $(CHIBIOS)/os/hal/src/hal_serial_usb.c
 endif
 ifneq ($(findstring HAL_USE_SIO TRUE,$(HALCONF)),)
-HALSRC += $(CHIBIOS)/os/hal/src/hal_sio.c
+HALSRC += $(CHIBIOS)/os/hal/src/hal_sio.c \
+          $(CHIBIOS)/os/hal/src/hal_buffered_sio.c
 endif
 ifneq ($(findstring HAL_USE_SPI TRUE,$(HALCONF)),)
 HALSRC += $(CHIBIOS)/os/hal/src/hal_spi.c
@@ -101,6 +103,7 @@ HALSRC = $(CHIBIOS)/os/hal/src/hal.c \
          $(CHIBIOS)/os/hal/src/hal_adc.c \
          $(CHIBIOS)/os/hal/src/hal_can.c \
          $(CHIBIOS)/os/hal/src/hal_crypto.c \
+         $(CHIBIOS)/os/hal/src/hal_crypto_fallback.c \
          $(CHIBIOS)/os/hal/src/hal_dac.c \
          $(CHIBIOS)/os/hal/src/hal_efl.c \
          $(CHIBIOS)/os/hal/src/hal_gpt.c \
@@ -116,6 +119,7 @@ HALSRC = $(CHIBIOS)/os/hal/src/hal.c \
          $(CHIBIOS)/os/hal/src/hal_serial.c \
          $(CHIBIOS)/os/hal/src/hal_serial_usb.c \
          $(CHIBIOS)/os/hal/src/hal_sio.c \
+         $(CHIBIOS)/os/hal/src/hal_buffered_sio.c \
          $(CHIBIOS)/os/hal/src/hal_spi.c \
          $(CHIBIOS)/os/hal/src/hal_trng.c \
          $(CHIBIOS)/os/hal/src/hal_uart.c \
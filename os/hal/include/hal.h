@@ -170,6 +170,7 @@
 /* Complex drivers.*/
 #include "hal_mmc_spi.h"
 #include "hal_serial_usb.h"
+#include "hal_buffered_sio.h"
 
 /* Community drivers.*/
 #if defined(HAL_USE_COMMUNITY) || defined(__DOXYGEN__)
@@ -0,0 +1,219 @@
+/*
+    ChibiOS - Copyright (C) 2006..2018 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+/**
+ * @file    hal_buffered_sio.h
+ * @brief   Buffered SIO Driver macros and structures.
+ *
+ * @addtogroup BUFFERED_SIO
+ * @{
+ */
+
+#ifndef HAL_BUFFERED_SIO_H
+#define HAL_BUFFERED_SIO_H
+
+#if (HAL_USE_SIO == TRUE) || defined(__DOXYGEN__)
+
+/*===========================================================================*/
+/* Driver constants.                                                         */
+/*===========================================================================*/
+
+/**
+ * @name    Buffered SIO status flags
+ * @note    The values are the same of the @p SerialDriver flags.
+ * @{
+ */
+#define BSIO_PARITY_ERROR       (eventflags_t)32    /**< @brief Parity.     */
+#define BSIO_FRAMING_ERROR      (eventflags_t)64    /**< @brief Framing.    */
+#define BSIO_OVERRUN_ERROR      (eventflags_t)128   /**< @brief Overflow.   */
+#define BSIO_NOISE_ERROR        (eventflags_t)256   /**< @brief Line noise. */
+#define BSIO_BREAK_DETECTED     (eventflags_t)512   /**< @brief LIN Break.  */
+#define BSIO_QUEUE_FULL_ERROR   (eventflags_t)1024  /**< @brief Queue full. */
+/** @} */
+
+/*===========================================================================*/
+/* Driver pre-compile time settings.                                         */
+/*===========================================================================*/
+
+/**
+ * @name    Buffered SIO configuration options
+ * @{
+ */
+/**
+ * @brief   Buffered SIO buffers size.
+ * @details Configuration parameter, you can change the depth of the queue
+ *          buffers depending on the requirements of your application.
+ * @note    The default is 64 bytes for both the transmission and receive
+ *          buffers.
+ */
+#if !defined(BUFFERED_SIO_BUFFERS_SIZE) || defined(__DOXYGEN__)
+#define BUFFERED_SIO_BUFFERS_SIZE   64
+#endif
+/** @} */
+
+/*===========================================================================*/
+/* Derived constants and error checks.                                       */
+/*===========================================================================*/
+
+#if BUFFERED_SIO_BUFFERS_SIZE < 1
+#error "invalid BUFFERED_SIO_BUFFERS_SIZE value"
+#endif
+
+/*===========================================================================*/
+/* Driver data structures and types.                                         */
+/*===========================================================================*/
+
+/**
+ * @brief   Driver state machine possible states.
+ */
+typedef enum {
+  BSIO_UNINIT = 0,                  /**< Not initialized.                   */
+  BSIO_STOP = 1,                    /**< Stopped.                           */
+  BSIO_READY = 2                    /**< Ready.                             */
+} bsiostate_t;
+
+/**
+ * @brief   Structure representing a buffered SIO driver.
+ */
+typedef struct BufferedSIODriver BufferedSIODriver;
+
+/**
+ * @brief   @p BufferedSIODriver specific data.
+ */
+#define _buffered_sio_driver_data                                           \
+  _base_asynchronous_channel_data                                           \
+  /* Driver state.*/                                                        \
+  bsiostate_t               state;                                          \
+  /* Underlying SIO driver.*/                                               \
+  SIODriver                 *siop;                                          \
+  /* SIO configuration, a copy of the user one with the driver callbacks.*/ \
+  SIOConfig                 config;                                         \
+  /* Input queue.*/                                                         \
+  input_queue_t             iqueue;                                         \
+  /* Output queue.*/                                                        \
+  output_queue_t            oqueue;                                         \
+  /* Input circular buffer.*/                                               \
+  uint8_t                   ib[BUFFERED_SIO_BUFFERS_SIZE];                  \
+  /* Output circular buffer.*/                                              \
+  uint8_t                   ob[BUFFERED_SIO_BUFFERS_SIZE];
+
+/**
+ * @brief   @p BufferedSIODriver specific methods.
+ */
+#define _buffered_sio_driver_methods                                        \
+  _base_asynchronous_channel_methods
+
+/**
+ * @extends BaseAsynchronousChannelVMT
+ *
+ * @brief   @p BufferedSIODriver virtual methods table.
+ */
+struct BufferedSIODriverVMT {
+  _buffered_sio_driver_methods
+};
+
+/**
+ * @extends BaseAsynchronousChannel
+ *
+ * @brief   Buffered SIO driver class.
+ * @details This class implements a full duplex serial channel on top of a
+ *          @p SIODriver. The SIO callbacks move the content of the hardware
+ *          FIFOs from and to the I/O queues in blocks, the queues are
+ *          updated and the waiting threads are awakened once per block
+ *          instead of once per byte.
+ */
+struct BufferedSIODriver {
+  /** @brief Virtual Methods Table.*/
+  const struct BufferedSIODriverVMT *vmt;
+  _buffered_sio_driver_data
+};
+
+/*===========================================================================*/
+/* Driver macros.                                                            */
+/*===========================================================================*/
+
+/**
+ * @name    Macro Functions
+ * @{
+ */
+/**
+ * @brief   Direct blocking write to a @p BufferedSIODriver.
+ * @note    This function bypasses the indirect access to the channel and
+ *          writes directly to the output queue. This is faster but cannot
+ *          be used to write to different channels implementations.
+ *
+ * @api
+ */
+#define bsioWrite(bsiop, b, n)                                              \
+  oqWriteTimeout(&(bsiop)->oqueue, b, n, TIME_INFINITE)
+
+/**
+ * @brief   Direct blocking write to a @p BufferedSIODriver with timeout
+ *          specification.
+ * @note    This function bypasses the indirect access to the channel and
+ *          writes directly to the output queue. This is faster but cannot
+ *          be used to write to different channels implementations.
+ *
+ * @api
+ */
+#define bsioWriteTimeout(bsiop, b, n, t)                                    \
+  oqWriteTimeout(&(bsiop)->oqueue, b, n, t)
+
+/**
+ * @brief   Direct blocking read from a @p BufferedSIODriver.
+ * @note    This function bypasses the indirect access to the channel and
+ *          reads directly from the input queue. This is faster but cannot
+ *          be used to read from different channels implementations.
+ *
+ * @api
+ */
+#define bsioRead(bsiop, b, n)                                               \
+  iqReadTimeout(&(bsiop)->iqueue, b, n, TIME_INFINITE)
+
+/**
+ * @brief   Direct blocking read from a @p BufferedSIODriver with timeout
+ *          specification.
+ * @note    This function bypasses the indirect access to the channel and
+ *          reads directly from the input queue. This is faster but cannot
+ *          be used to read from different channels implementations.
+ *
+ * @api
+ */
+#define bsioReadTimeout(bsiop, b, n, t)                                     \
+  iqReadTimeout(&(bsiop)->iqueue, b, n, t)
+/** @} */
+
+/*===========================================================================*/
+/* External declarations.                                                    */
+/*===========================================================================*/
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+  void bsioObjectInit(BufferedSIODriver *bsiop, SIODriver *siop);
+  void bsioStart(BufferedSIODriver *bsiop, const SIOConfig *config);
+  void bsioStop(BufferedSIODriver *bsiop);
+  msg_t bsioControl(BufferedSIODriver *bsiop,
+                    unsigned int operation, void *arg);
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* HAL_USE_SIO == TRUE */
+
+#endif /* HAL_BUFFERED_SIO_H */
+
+/** @} */
@@ -35,8 +35,11 @@
 
 /**
  * @brief   Maximum size of blocks copied in critical sections.
- * @note    Increasing this value increases performance at expense of
- *          IRQ servicing efficiency.
+ * @details Larger blocks are copied outside the critical section, with the
+ *          system unlocked, while the buffer is owned by the thread.
+ * @note    Increasing this value decreases the number of lock and unlock
+ *          operations for medium sized transfers at expense of IRQ
+ *          servicing efficiency.
  * @note    It must be a power of two.
  */
 #if !defined(BUFFERS_CHUNKS_SIZE) || defined(__DOXYGEN__)
@@ -121,6 +124,12 @@ struct io_buffers_queue {
    * @brief   Boundary for R/W sequential access.
    */
   uint8_t               *top;
+  /**
+   * @brief   Current buffer reserved by a writer.
+   * @note    A reserved buffer is being written outside the critical zone,
+   *          it is not flushed from ISR context by @p obqTryFlushI().
+   */
+  bool                  reserved;
   /**
    * @brief   Data notification callback.
    */
@@ -318,6 +327,9 @@ extern "C" {
   msg_t ibqGetTimeout(input_buffers_queue_t *ibqp, sysinterval_t timeout);
   size_t ibqReadTimeout(input_buffers_queue_t *ibqp, uint8_t *bp,
                         size_t n, sysinterval_t timeout);
+  msg_t ibqFetchTimeout(input_buffers_queue_t *ibqp, const uint8_t **bpp,
+                        size_t *np, sysinterval_t timeout);
+  void ibqRelease(input_buffers_queue_t *ibqp, size_t n);
   void obqObjectInit(output_buffers_queue_t *obqp, bool suspended, uint8_t *bp,
                      size_t size, size_t n, bqnotify_t onfy, void *link);
   void obqResetI(output_buffers_queue_t *obqp);
@@ -334,6 +346,9 @@ extern "C" {
                       sysinterval_t timeout);
   size_t obqWriteTimeout(output_buffers_queue_t *obqp, const uint8_t *bp,
                          size_t n, sysinterval_t timeout);
+  msg_t obqReserveTimeout(output_buffers_queue_t *obqp, uint8_t **bpp,
+                          size_t *np, sysinterval_t timeout);
+  void obqCommit(output_buffers_queue_t *obqp, size_t n);
   bool obqTryFlushI(output_buffers_queue_t *obqp);
   void obqFlush(output_buffers_queue_t *obqp);
 #ifdef __cplusplus
@@ -0,0 +1,327 @@
+/*
+    ChibiOS - Copyright (C) 2006..2018 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+/**
+ * @file    hal_crypto_fallback.h
+ * @brief   Cryptographic Driver software fallback header.
+ * @details This module implements in software all the functionalities not
+ *          provided by the low level driver, it is enabled by the
+ *          @p HAL_CRY_USE_FALLBACK setting.
+ * @note    The fallback handles a single transient key for each algorithm,
+ *          it is shared among all the driver instances.
+ * @note    DES and TDES are not supported, the related functions return
+ *          @p CRY_ERR_INV_ALGO.
+ *
+ * @addtogroup CRYPTO
+ * @{
+ */
+
+#ifndef HAL_CRYPTO_FALLBACK_H
+#define HAL_CRYPTO_FALLBACK_H
+
+/*===========================================================================*/
+/* Driver constants.                                                         */
+/*===========================================================================*/
+
+/**
+ * @name    Fallback hash sizes
+ * @{
+ */
+#define CRY_FALLBACK_SHA1_BLOCK_SIZE        64U
+#define CRY_FALLBACK_SHA256_BLOCK_SIZE      64U
+#define CRY_FALLBACK_SHA512_BLOCK_SIZE      128U
+/** @} */
+
+/*===========================================================================*/
+/* Driver pre-compile time settings.                                         */
+/*===========================================================================*/
+
+/**
+ * @brief   Maximum size of the HMAC transient key.
+ * @note    Keys larger than the hash block size are hashed when an HMAC
+ *          operation is initialized, the whole key is stored until then.
+ */
+#if !defined(CRY_FALLBACK_HMAC_KEY_SIZE) || defined(__DOXYGEN__)
+#define CRY_FALLBACK_HMAC_KEY_SIZE          128U
+#endif
+
+/*===========================================================================*/
+/* Derived constants and error checks.                                       */
+/*===========================================================================*/
+
+#if CRY_FALLBACK_HMAC_KEY_SIZE < CRY_FALLBACK_SHA512_BLOCK_SIZE
+#error "CRY_FALLBACK_HMAC_KEY_SIZE smaller than the SHA512 block size"
+#endif
+
+/*===========================================================================*/
+/* Driver data structures and types.                                         */
+/*===========================================================================*/
+
+/**
+ * @brief   Type of a software SHA1 state.
+ */
+typedef struct {
+  uint32_t                  h[5];
+  uint64_t                  length;
+  uint8_t                   buf[CRY_FALLBACK_SHA1_BLOCK_SIZE];
+} cry_sha1_state_t;
+
+/**
+ * @brief   Type of a software SHA256 state.
+ */
+typedef struct {
+  uint32_t                  h[8];
+  uint64_t                  length;
+  uint8_t                   buf[CRY_FALLBACK_SHA256_BLOCK_SIZE];
+} cry_sha256_state_t;
+
+/**
+ * @brief   Type of a software SHA512 state.
+ * @note    Messages are limited to 2^61 bytes.
+ */
+typedef struct {
+  uint64_t                  h[8];
+  uint64_t                  length;
+  uint8_t                   buf[CRY_FALLBACK_SHA512_BLOCK_SIZE];
+} cry_sha512_state_t;
+
+#if (CRY_LLD_SUPPORTS_SHA1 == FALSE) || defined(__DOXYGEN__)
+/**
+ * @brief   Type of a SHA1 context.
+ */
+typedef struct {
+  cry_sha1_state_t          sha;
+} SHA1Context;
+#endif
+
+#if (CRY_LLD_SUPPORTS_SHA256 == FALSE) || defined(__DOXYGEN__)
+/**
+ * @brief   Type of a SHA256 context.
+ */
+typedef struct {
+  cry_sha256_state_t        sha;
+} SHA256Context;
+#endif
+
+#if (CRY_LLD_SUPPORTS_SHA512 == FALSE) || defined(__DOXYGEN__)
+/**
+ * @brief   Type of a SHA512 context.
+ */
+typedef struct {
+  cry_sha512_state_t        sha;
+} SHA512Context;
+#endif
+
+#if (CRY_LLD_SUPPORTS_HMAC_SHA256 == FALSE) || defined(__DOXYGEN__)
+/**
+ * @brief   Type of a HMAC_SHA256 context.
+ */
+typedef struct {
+  cry_sha256_state_t        sha;
+} HMACSHA256Context;
+#endif
+
+#if (CRY_LLD_SUPPORTS_HMAC_SHA512 == FALSE) || defined(__DOXYGEN__)
+/**
+ * @brief   Type of a HMAC_SHA512 context.
+ */
+typedef struct {
+  cry_sha512_state_t        sha;
+} HMACSHA512Context;
+#endif
+
+/*===========================================================================*/
+/* Driver macros.                                                            */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* External declarations.                                                    */
+/*===========================================================================*/
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+  cryerror_t cry_fallback_aes_loadkey(CRYDriver *cryp,
+                                      size_t size,
+                                      const uint8_t *keyp);
+  cryerror_t cry_fallback_encrypt_AES(CRYDriver *cryp,
+                                      crykey_t key_id,
+                                      const uint8_t *in,
+                                      uint8_t *out);
+  cryerror_t cry_fallback_decrypt_AES(CRYDriver *cryp,
+                                      crykey_t key_id,
+                                      const uint8_t *in,
+                                      uint8_t *out);
+  cryerror_t cry_fallback_encrypt_AES_ECB(CRYDriver *cryp,
+                                          crykey_t key_id,
+                                          size_t size,
+                                          const uint8_t *in,
+                                          uint8_t *out);
+  cryerror_t cry_fallback_decrypt_AES_ECB(CRYDriver *cryp,
+                                          crykey_t key_id,
+                                          size_t size,
+                                          const uint8_t *in,
+                                          uint8_t *out);
+  cryerror_t cry_fallback_encrypt_AES_CBC(CRYDriver *cryp,
+                                          crykey_t key_id,
+                                          size_t size,
+                                          const uint8_t *in,
+                                          uint8_t *out,
+                                          const uint8_t *iv);
+  cryerror_t cry_fallback_decrypt_AES_CBC(CRYDriver *cryp,
+                                          crykey_t key_id,
+                                          size_t size,
+                                          const uint8_t *in,
+                                          uint8_t *out,
+                                          const uint8_t *iv);
+  cryerror_t cry_fallback_encrypt_AES_CFB(CRYDriver *cryp,
+                                          crykey_t key_id,
+                                          size_t size,
+                                          const uint8_t *in,
+                                          uint8_t *out,
+                                          const uint8_t *iv);
+  cryerror_t cry_fallback_decrypt_AES_CFB(CRYDriver *cryp,
+                                          crykey_t key_id,
+                                          size_t size,
+                                          const uint8_t *in,
+                                          uint8_t *out,
+                                          const uint8_t *iv);
+  cryerror_t cry_fallback_encrypt_AES_CTR(CRYDriver *cryp,
+                                          crykey_t key_id,
+                                          size_t size,
+                                          const uint8_t *in,
+                                          uint8_t *out,
+                                          const uint8_t *iv);
+  cryerror_t cry_fallback_decrypt_AES_CTR(CRYDriver *cryp,
+                                          crykey_t key_id,
+                                          size_t size,
+                                          const uint8_t *in,
+                                          uint8_t *out,
+                                          const uint8_t *iv);
+  cryerror_t cry_fallback_encrypt_AES_GCM(CRYDriver *cryp,
+                                          crykey_t key_id,
+                                          size_t auth_size,
+                                          const uint8_t *auth_in,
+                                          size_t text_size,
+                                          const uint8_t *text_in,
+                                          uint8_t *text_out,
+                                          const uint8_t *iv,
+                                          size_t tag_size,
+                                          uint8_t *tag_out);
+  cryerror_t cry_fallback_decrypt_AES_GCM(CRYDriver *cryp,
+                                          crykey_t key_id,
+                                          size_t auth_size,
+                                          const uint8_t *auth_in,
+                                          size_t text_size,
+                                          const uint8_t *text_in,
+                                          uint8_t *text_out,
+                                          const uint8_t *iv,
+                                          size_t tag_size,
+                                          const uint8_t *tag_in);
+  cryerror_t cry_fallback_des_loadkey(CRYDriver *cryp,
+                                      size_t size,
+                                      const uint8_t *keyp);
+  cryerror_t cry_fallback_encrypt_DES(CRYDriver *cryp,
+                                      crykey_t key_id,
+                                      const uint8_t *in,
+                                      uint8_t *out);
+  cryerror_t cry_fallback_decrypt_DES(CRYDriver *cryp,
+                                      crykey_t key_id,
+                                      const uint8_t *in,
+                                      uint8_t *out);
+  cryerror_t cry_fallback_encrypt_DES_ECB(CRYDriver *cryp,
+                                          crykey_t key_id,
+                                          size_t size,
+                                          const uint8_t *in,
+                                          uint8_t *out);
+  cryerror_t cry_fallback_decrypt_DES_ECB(CRYDriver *cryp,
+                                          crykey_t key_id,
+                                          size_t size,
+                                          const uint8_t *in,
+                                          uint8_t *out);
+  cryerror_t cry_fallback_encrypt_DES_CBC(CRYDriver *cryp,
+                                          crykey_t key_id,
+                                          size_t size,
+                                          const uint8_t *in,
+                                          uint8_t *out,
+                                          const uint8_t *iv);
+  cryerror_t cry_fallback_decrypt_DES_CBC(CRYDriver *cryp,
+                                          crykey_t key_id,
+                                          size_t size,
+                                          const uint8_t *in,
+                                          uint8_t *out,
+                                          const uint8_t *iv);
+#if (CRY_LLD_SUPPORTS_SHA1 == FALSE) || defined(__DOXYGEN__)
+  cryerror_t cry_fallback_SHA1_init(CRYDriver *cryp, SHA1Context *sha1ctxp);
+  cryerror_t cry_fallback_SHA1_update(CRYDriver *cryp, SHA1Context *sha1ctxp,
+                                      size_t size, const uint8_t *in);
+  cryerror_t cry_fallback_SHA1_final(CRYDriver *cryp, SHA1Context *sha1ctxp,
+                                     uint8_t *out);
+#endif
+#if (CRY_LLD_SUPPORTS_SHA256 == FALSE) || defined(__DOXYGEN__)
+  cryerror_t cry_fallback_SHA256_init(CRYDriver *cryp,
+                                      SHA256Context *sha256ctxp);
+  cryerror_t cry_fallback_SHA256_update(CRYDriver *cryp,
+                                        SHA256Context *sha256ctxp,
+                                        size_t size, const uint8_t *in);
+  cryerror_t cry_fallback_SHA256_final(CRYDriver *cryp,
+                                       SHA256Context *sha256ctxp,
+                                       uint8_t *out);
+#endif
+#if (CRY_LLD_SUPPORTS_SHA512 == FALSE) || defined(__DOXYGEN__)
+  cryerror_t cry_fallback_SHA512_init(CRYDriver *cryp,
+                                      SHA512Context *sha512ctxp);
+  cryerror_t cry_fallback_SHA512_update(CRYDriver *cryp,
+                                        SHA512Context *sha512ctxp,
+                                        size_t size, const uint8_t *in);
+  cryerror_t cry_fallback_SHA512_final(CRYDriver *cryp,
+                                       SHA512Context *sha512ctxp,
+                                       uint8_t *out);
+#endif
+  cryerror_t cry_fallback_hmac_loadkey(CRYDriver *cryp,
+                                       size_t size,
+                                       const uint8_t *keyp);
+#if (CRY_LLD_SUPPORTS_HMAC_SHA256 == FALSE) || defined(__DOXYGEN__)
+  cryerror_t cry_fallback_HMACSHA256_init(CRYDriver *cryp,
+                                          HMACSHA256Context *hmacsha256ctxp);
+  cryerror_t cry_fallback_HMACSHA256_update(CRYDriver *cryp,
+                                            HMACSHA256Context *hmacsha256ctxp,
+                                            size_t size, const uint8_t *in);
+  cryerror_t cry_fallback_HMACSHA256_final(CRYDriver *cryp,
+                                           HMACSHA256Context *hmacsha256ctxp,
+                                           uint8_t *out);
+#endif
+#if (CRY_LLD_SUPPORTS_HMAC_SHA512 == FALSE) || defined(__DOXYGEN__)
+  cryerror_t cry_fallback_HMACSHA512_init(CRYDriver *cryp,
+                                          HMACSHA512Context *hmacsha512ctxp);
+  cryerror_t cry_fallback_HMACSHA512_update(CRYDriver *cryp,
+                                            HMACSHA512Context *hmacsha512ctxp,
+                                            size_t size, const uint8_t *in);
+  cryerror_t cry_fallback_HMACSHA512_final(CRYDriver *cryp,
+                                           HMACSHA512Context *hmacsha512ctxp,
+                                           uint8_t *out);
+#endif
+#ifdef __cplusplus
+}
+#endif
+
+/*===========================================================================*/
+/* Driver inline functions.                                                  */
+/*===========================================================================*/
+
+#endif /* HAL_CRYPTO_FALLBACK_H */
+
+/** @} */
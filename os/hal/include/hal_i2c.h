@@ -82,12 +82,77 @@ typedef enum {
   I2C_LOCKED = 5                            /**< @brief Bus locked.         */
 } i2cstate_t;
 
+struct I2CDriver;
+
+/**
+ * @brief   Type of an asynchronous operation end callback.
+ *
+ * @param[in] i2cp      pointer to the @p I2CDriver object
+ * @param[in] msg       the operation result, @p MSG_OK or @p MSG_RESET
+ */
+typedef void (*i2ccallback_t)(struct I2CDriver *i2cp, msg_t msg);
+
 #include "hal_i2c_lld.h"
 
+/**
+ * @brief   Asynchronous operations support.
+ * @note    Low level drivers implementing the asynchronous operations
+ *          define this switch as @p TRUE and include the @p callback and
+ *          @p arg fields in their driver structure.
+ */
+#if !defined(I2C_SUPPORTS_ASYNC) || defined(__DOXYGEN__)
+#define I2C_SUPPORTS_ASYNC          FALSE
+#endif
+
 /*===========================================================================*/
 /* Driver macros.                                                            */
 /*===========================================================================*/
 
+#if (I2C_SUPPORTS_ASYNC == TRUE) || defined(__DOXYGEN__)
+/**
+ * @brief   Ends the current operation.
+ * @details The callback of an asynchronous operation is invoked, else the
+ *          waiting thread is resumed. The callback can start a new
+ *          operation.
+ *
+ * @param[in] i2cp      pointer to the @p I2CDriver object
+ * @param[in] msg       the operation result
+ *
+ * @notapi
+ */
+#define _i2c_end_isr(i2cp, msg) do {                                        \
+  if ((i2cp)->callback != NULL) {                                           \
+    i2ccallback_t cb = (i2cp)->callback;                                    \
+    (i2cp)->callback = NULL;                                                \
+    (i2cp)->state = I2C_READY;                                              \
+    cb(i2cp, msg);                                                          \
+  }                                                                         \
+  else {                                                                    \
+    osalSysLockFromISR();                                                   \
+    osalThreadResumeI(&(i2cp)->thread, msg);                                \
+    osalSysUnlockFromISR();                                                 \
+  }                                                                         \
+} while (0)
+
+/**
+ * @brief   Wakes up the waiting thread notifying no errors.
+ *
+ * @param[in] i2cp      pointer to the @p I2CDriver object
+ *
+ * @notapi
+ */
+#define _i2c_wakeup_isr(i2cp) _i2c_end_isr(i2cp, MSG_OK)
+
+/**
+ * @brief   Wakes up the waiting thread notifying errors.
+ *
+ * @param[in] i2cp      pointer to the @p I2CDriver object
+ *
+ * @notapi
+ */
+#define _i2c_wakeup_error_isr(i2cp) _i2c_end_isr(i2cp, MSG_RESET)
+
+#else /* I2C_SUPPORTS_ASYNC == FALSE */
 /**
  * @brief   Wakes up the waiting thread notifying no errors.
  *
@@ -113,6 +178,7 @@ typedef enum {
   osalThreadResumeI(&(i2cp)->thread, MSG_RESET);                            \
   osalSysUnlockFromISR();                                                   \
 } while (0)
+#endif /* I2C_SUPPORTS_ASYNC == FALSE */
 
 /**
  * @brief   Wrap i2cMasterTransmitTimeout function with TIME_INFINITE timeout.
@@ -150,6 +216,17 @@ extern "C" {
                                 i2caddr_t addr,
                                 uint8_t *rxbuf, size_t rxbytes,
                                 sysinterval_t timeout);
+#if I2C_SUPPORTS_ASYNC == TRUE
+  void i2cMasterStartTransmitI(I2CDriver *i2cp,
+                               i2caddr_t addr,
+                               const uint8_t *txbuf, size_t txbytes,
+                               uint8_t *rxbuf, size_t rxbytes,
+                               i2ccallback_t cb);
+  void i2cMasterStartReceiveI(I2CDriver *i2cp,
+                              i2caddr_t addr,
+                              uint8_t *rxbuf, size_t rxbytes,
+                              i2ccallback_t cb);
+#endif
 #if I2C_USE_MUTUAL_EXCLUSION == TRUE
   void i2cAcquireBus(I2CDriver *i2cp);
   void i2cReleaseBus(I2CDriver *i2cp);
@@ -309,6 +309,8 @@ extern "C" {
   size_t iqReadI(input_queue_t *iqp, uint8_t *bp, size_t n);
   size_t iqReadTimeout(input_queue_t *iqp, uint8_t *bp,
                        size_t n, sysinterval_t timeout);
+  uint8_t *iqGetEmptyAreaI(input_queue_t *iqp, size_t *np);
+  void iqPostFullAreaI(input_queue_t *iqp, size_t n);
 
   void oqObjectInit(output_queue_t *oqp, uint8_t *bp, size_t size,
                     qnotify_t onfy, void *link);
@@ -319,6 +321,8 @@ extern "C" {
   size_t oqWriteI(output_queue_t *oqp, const uint8_t *bp, size_t n);
   size_t oqWriteTimeout(output_queue_t *oqp, const uint8_t *bp,
                         size_t n, sysinterval_t timeout);
+  uint8_t *oqGetFullAreaI(output_queue_t *oqp, size_t *np);
+  void oqReleaseEmptyAreaI(output_queue_t *oqp, size_t n);
 #ifdef __cplusplus
 }
 #endif
@@ -210,6 +210,10 @@ struct hal_spi_driver {
    */
   mutex_t                   mutex;
 #endif /* SPI_USE_MUTUAL_EXCLUSION == TRUE */
+  /**
+   * @brief   Pointer for the callback owner, not used by the driver.
+   */
+  void                      *arg;
 #if defined(SPI_DRIVER_EXT_FIELDS)
   SPI_DRIVER_EXT_FIELDS
 #endif
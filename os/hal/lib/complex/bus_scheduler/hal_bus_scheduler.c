@@ -0,0 +1,532 @@
+/*
+    ChibiOS - Copyright (C) 2006..2018 Giovanni Di Sirio.
+
+    This file is part of ChibiOS.
+
+    ChibiOS is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 3 of the License, or
+    (at your option) any later version.
+
+    ChibiOS is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/**
+ * @file    hal_bus_scheduler.c
+ * @brief   Bus transactions scheduler code.
+ * @details Clients submit chains of transfer descriptors, the scheduler
+ *          queues the chains and executes them in submission order. Each
+ *          transfer is started from the completion callback of the
+ *          previous one, no thread is involved between transfers.
+ *
+ * @addtogroup HAL_BUS_SCHEDULER
+ * @{
+ */
+
+#include "hal.h"
+
+#include "hal_bus_scheduler.h"
+
+/*===========================================================================*/
+/* Driver local definitions.                                                 */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Driver exported variables.                                                */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Driver local variables and types.                                         */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Driver local functions.                                                   */
+/*===========================================================================*/
+
+static void xfer_end(BSchedDriver *bsp, msg_t msg);
+
+#if (HAL_USE_I2C == TRUE) || defined(__DOXYGEN__)
+/**
+ * @brief   I2C operation end callback.
+ *
+ * @param[in] i2cp      pointer to the @p I2CDriver object
+ * @param[in] msg       the operation result
+ */
+static void i2c_end_cb(I2CDriver *i2cp, msg_t msg) {
+
+  osalSysLockFromISR();
+  xfer_end((BSchedDriver *)i2cp->arg, msg);
+  osalSysUnlockFromISR();
+}
+#endif
+
+#if (HAL_USE_SPI == TRUE) || defined(__DOXYGEN__)
+/**
+ * @brief   Changes the chip select of the running chain.
+ *
+ * @param[in] bsp       pointer to the @p BSchedDriver object
+ * @param[in] select    the new chip select state
+ */
+static void spi_select(BSchedDriver *bsp, bool select) {
+  bsched_chain_t *chp = bsp->current;
+
+  if (chp->select != NULL) {
+    chp->select(chp, select);
+  }
+  else if (select) {
+    spiSelectI(bsp->config->spip);
+  }
+  else {
+    spiUnselectI(bsp->config->spip);
+  }
+}
+
+/**
+ * @brief   SPI operation end callback.
+ * @note    Synchronous operations performed while the bus is owned by a
+ *          thread invoke the callback too, there is no running chain in
+ *          that case.
+ *
+ * @param[in] spip      pointer to the @p SPIDriver object
+ */
+static void spi_end_cb(SPIDriver *spip) {
+  BSchedDriver *bsp = (BSchedDriver *)spip->arg;
+  bsched_chain_t *chp;
+
+  osalSysLockFromISR();
+  chp = bsp->current;
+  if (chp != NULL) {
+    const bsched_xfer_t *xp = &chp->xfers[chp->index];
+
+    if (!chp->rxphase && (xp->rxn > 0U)) {
+      chp->rxphase = true;
+      spiStartReceiveI(spip, xp->rxn, xp->rxbuf);
+    }
+    else {
+      spi_select(bsp, false);
+      xfer_end(bsp, MSG_OK);
+    }
+  }
+  osalSysUnlockFromISR();
+}
+#endif
+
+/**
+ * @brief   Starts the current transfer of the running chain.
+ *
+ * @param[in] bsp       pointer to the @p BSchedDriver object
+ */
+static void xfer_start(BSchedDriver *bsp) {
+  bsched_chain_t *chp = bsp->current;
+  const bsched_xfer_t *xp = &chp->xfers[chp->index];
+
+#if HAL_USE_I2C == TRUE
+  if (bsp->config->bus == BSCHED_BUS_I2C) {
+    if (xp->txn > 0U) {
+      i2cMasterStartTransmitI(bsp->config->i2cp, (i2caddr_t)xp->addr,
+                              xp->txbuf, xp->txn, xp->rxbuf, xp->rxn,
+                              i2c_end_cb);
+    }
+    else {
+      i2cMasterStartReceiveI(bsp->config->i2cp, (i2caddr_t)xp->addr,
+                             xp->rxbuf, xp->rxn, i2c_end_cb);
+    }
+    return;
+  }
+#endif
+
+#if HAL_USE_SPI == TRUE
+  spi_select(bsp, true);
+  if (xp->txn > 0U) {
+    chp->rxphase = false;
+    spiStartSendI(bsp->config->spip, xp->txn, xp->txbuf);
+  }
+  else {
+    chp->rxphase = true;
+    spiStartReceiveI(bsp->config->spip, xp->rxn, xp->rxbuf);
+  }
+#endif
+}
+
+/**
+ * @brief   Starts the next pending chain.
+ * @details A thread waiting for the bus ownership takes precedence over
+ *          the pending chains, the ownership is transferred directly.
+ *
+ * @param[in] bsp       pointer to the @p BSchedDriver object
+ */
+static void chain_next(BSchedDriver *bsp) {
+  bsched_chain_t *chp;
+
+  if ((bsp->current != NULL) || bsp->owned) {
+    return;
+  }
+
+  if (bsp->nowners > 0U) {
+    bsp->nowners--;
+    bsp->owned = true;
+    bsp->stats.acquisitions++;
+    osalThreadDequeueNextI(&bsp->owners, MSG_OK);
+    return;
+  }
+
+  chp = bsp->head;
+  if (chp == NULL) {
+    return;
+  }
+  bsp->head = chp->next;
+  if (bsp->head == NULL) {
+    bsp->tail = NULL;
+  }
+
+  bsp->current = chp;
+  xfer_start(bsp);
+}
+
+/**
+ * @brief   Handles the end of a transfer.
+ * @details The next transfer of the running chain is started, on failure
+ *          or after the last transfer the chain is completed and the next
+ *          pending chain is started.
+ *
+ * @param[in] bsp       pointer to the @p BSchedDriver object
+ * @param[in] msg       the transfer result
+ */
+static void xfer_end(BSchedDriver *bsp, msg_t msg) {
+  bsched_chain_t *chp = bsp->current;
+
+  bsp->stats.xfers++;
+  chp->index++;
+  if ((msg == MSG_OK) && (chp->index < chp->n)) {
+    xfer_start(bsp);
+    return;
+  }
+
+  /* Chain completed.*/
+  bsp->current = NULL;
+  bsp->stats.chains++;
+  if (msg != MSG_OK) {
+    msg = MSG_RESET;
+    bsp->stats.errors++;
+  }
+  chp->result = msg;
+  chp->done   = true;
+  osalThreadDequeueAllI(&chp->waiting, msg);
+
+  /* The callback can submit chains including the completed one.*/
+  if (chp->cb != NULL) {
+    chp->cb(chp);
+  }
+
+  chain_next(bsp);
+}
+
+/*===========================================================================*/
+/* Driver exported functions.                                                */
+/*===========================================================================*/
+
+/**
+ * @brief   Initializes an instance.
+ *
+ * @param[out] bsp      pointer to the @p BSchedDriver object
+ *
+ * @init
+ */
+void bschedObjectInit(BSchedDriver *bsp) {
+
+  osalDbgCheck(bsp != NULL);
+
+  bsp->state   = BSCHED_STOP;
+  bsp->config  = NULL;
+  bsp->current = NULL;
+  bsp->head    = NULL;
+  bsp->tail    = NULL;
+  bsp->owned   = false;
+  bsp->nowners = 0U;
+  osalThreadQueueObjectInit(&bsp->owners);
+  bschedResetStats(bsp);
+}
+
+/**
+ * @brief   Configures and activates the scheduler.
+ * @details The bus driver is started, from now on it is owned by the
+ *          scheduler and must only be used directly between
+ *          @p bschedAcquireBus() and @p bschedReleaseBus().
+ *
+ * @param[in] bsp       pointer to the @p BSchedDriver object
+ * @param[in] config    pointer to the configuration structure
+ *
+ * @api
+ */
+void bschedStart(BSchedDriver *bsp, const BSchedConfig *config) {
+
+  osalDbgCheck((bsp != NULL) && (config != NULL));
+  osalDbgAssert(bsp->state == BSCHED_STOP, "invalid state");
+
+  bsp->config = config;
+
+#if HAL_USE_I2C == TRUE
+  if (config->bus == BSCHED_BUS_I2C) {
+    osalDbgCheck(config->i2cp != NULL);
+
+    i2cStart(config->i2cp, config->i2ccfg);
+    config->i2cp->arg = (void *)bsp;
+  }
+#endif
+
+#if HAL_USE_SPI == TRUE
+  if (config->bus == BSCHED_BUS_SPI) {
+    osalDbgCheck((config->spip != NULL) && (config->spicfg != NULL));
+
+    bsp->spicfg        = *config->spicfg;
+    bsp->spicfg.end_cb = spi_end_cb;
+    spiStart(config->spip, &bsp->spicfg);
+    config->spip->arg  = (void *)bsp;
+  }
+#endif
+
+  osalSysLock();
+  bsp->state = BSCHED_READY;
+  osalSysUnlock();
+}
+
+/**
+ * @brief   Deactivates the scheduler.
+ * @pre     There are no pending chains and the bus is not owned.
+ *
+ * @param[in] bsp       pointer to the @p BSchedDriver object
+ *
+ * @api
+ */
+void bschedStop(BSchedDriver *bsp) {
+
+  osalDbgCheck(bsp != NULL);
+
+  osalSysLock();
+  osalDbgAssert(bsp->state == BSCHED_READY, "invalid state");
+  osalDbgAssert((bsp->current == NULL) && (bsp->head == NULL) &&
+                !bsp->owned, "not idle");
+  bsp->state = BSCHED_STOP;
+  osalSysUnlock();
+
+#if HAL_USE_I2C == TRUE
+  if (bsp->config->bus == BSCHED_BUS_I2C) {
+    i2cStop(bsp->config->i2cp);
+  }
+#endif
+
+#if HAL_USE_SPI == TRUE
+  if (bsp->config->bus == BSCHED_BUS_SPI) {
+    spiStop(bsp->config->spip);
+  }
+#endif
+}
+
+/**
+ * @brief   Initializes a transfer chain.
+ * @note    The SPI chip select callback is initialized to @p NULL, it can
+ *          be assigned before submitting the chain.
+ *
+ * @param[out] chp      pointer to the @p bsched_chain_t object
+ * @param[in] xfers     pointer to the transfer descriptors
+ * @param[in] n         number of transfer descriptors
+ * @param[in] cb        completion callback or @p NULL
+ * @param[in] arg       callback argument
+ *
+ * @init
+ */
+void bschedChainObjectInit(bsched_chain_t *chp,
+                           const bsched_xfer_t *xfers, size_t n,
+                           bschedcallback_t cb, void *arg) {
+
+  osalDbgCheck((chp != NULL) && (xfers != NULL) && (n > 0U));
+
+  chp->next   = NULL;
+  chp->xfers  = xfers;
+  chp->n      = n;
+  chp->cb     = cb;
+  chp->arg    = arg;
+#if HAL_USE_SPI == TRUE
+  chp->select = NULL;
+#endif
+  chp->index  = 0U;
+  chp->done   = true;
+  chp->result = MSG_OK;
+  osalThreadQueueObjectInit(&chp->waiting);
+}
+
+/**
+ * @brief   Submits a transfer chain.
+ * @details The chain is appended to the pending list and started
+ *          immediately if the bus is idle.
+ * @pre     The chain is not pending.
+ *
+ * @param[in] bsp       pointer to the @p BSchedDriver object
+ * @param[in] chp       pointer to the @p bsched_chain_t object
+ *
+ * @iclass
+ */
+void bschedSubmitI(BSchedDriver *bsp, bsched_chain_t *chp) {
+
+  osalDbgCheckClassI();
+  osalDbgCheck((bsp != NULL) && (chp != NULL));
+  osalDbgAssert(bsp->state == BSCHED_READY, "invalid state");
+  osalDbgAssert(chp->done, "chain pending");
+
+  chp->next  = NULL;
+  chp->index = 0U;
+  chp->done  = false;
+  if (bsp->tail == NULL) {
+    bsp->head = chp;
+  }
+  else {
+    bsp->tail->next = chp;
+  }
+  bsp->tail = chp;
+
+  chain_next(bsp);
+}
+
+/**
+ * @brief   Submits a transfer chain.
+ * @details The chain is appended to the pending list and started
+ *          immediately if the bus is idle.
+ * @pre     The chain is not pending.
+ *
+ * @param[in] bsp       pointer to the @p BSchedDriver object
+ * @param[in] chp       pointer to the @p bsched_chain_t object
+ *
+ * @api
+ */
+void bschedSubmit(BSchedDriver *bsp, bsched_chain_t *chp) {
+
+  osalSysLock();
+  bschedSubmitI(bsp, chp);
+  osalSysUnlock();
+}
+
+/**
+ * @brief   Waits for a chain completion.
+ *
+ * @param[in] chp       pointer to the @p bsched_chain_t object
+ * @param[in] timeout   the number of ticks before the operation timeouts,
+ *                      the following special values are allowed:
+ *                      - @a TIME_IMMEDIATE immediate timeout.
+ *                      - @a TIME_INFINITE no timeout.
+ *                      .
+ * @return              The chain result.
+ * @retval MSG_OK       if the chain succeeded.
+ * @retval MSG_RESET    if a transfer failed.
+ * @retval MSG_TIMEOUT  if the chain is still pending.
+ *
+ * @api
+ */
+msg_t bschedWaitTimeout(bsched_chain_t *chp, sysinterval_t timeout) {
+  msg_t msg;
+
+  osalDbgCheck(chp != NULL);
+
+  osalSysLock();
+  if (chp->done) {
+    msg = chp->result;
+  }
+  else {
+    msg = osalThreadEnqueueTimeoutS(&chp->waiting, timeout);
+  }
+  osalSysUnlock();
+
+  return msg;
+}
+
+/**
+ * @brief   Gains exclusive access to the bus.
+ * @details The function waits for the running chain to complete then
+ *          the bus driver can be used directly, chains submitted meanwhile
+ *          are queued until @p bschedReleaseBus() is invoked.
+ *
+ * @param[in] bsp       pointer to the @p BSchedDriver object
+ *
+ * @api
+ */
+void bschedAcquireBus(BSchedDriver *bsp) {
+
+  osalDbgCheck(bsp != NULL);
+
+  osalSysLock();
+  osalDbgAssert(bsp->state == BSCHED_READY, "invalid state");
+  if ((bsp->current != NULL) || bsp->owned) {
+    /* The ownership is transferred on wakeup.*/
+    bsp->nowners++;
+    (void) osalThreadEnqueueTimeoutS(&bsp->owners, TIME_INFINITE);
+  }
+  else {
+    bsp->owned = true;
+    bsp->stats.acquisitions++;
+  }
+  osalSysUnlock();
+}
+
+/**
+ * @brief   Releases exclusive access to the bus.
+ * @details The next thread waiting for the bus or the next pending chain
+ *          is started.
+ *
+ * @param[in] bsp       pointer to the @p BSchedDriver object
+ *
+ * @api
+ */
+void bschedReleaseBus(BSchedDriver *bsp) {
+
+  osalDbgCheck(bsp != NULL);
+
+  osalSysLock();
+  osalDbgAssert(bsp->owned, "not owned");
+  bsp->owned = false;
+  chain_next(bsp);
+  osalOsRescheduleS();
+  osalSysUnlock();
+}
+
+/**
+ * @brief   Returns the scheduler statistics.
+ *
+ * @param[in] bsp       pointer to the @p BSchedDriver object
+ * @param[out] statsp   pointer to the statistics structure
+ *
+ * @api
+ */
+void bschedGetStats(BSchedDriver *bsp, bsched_stats_t *statsp) {
+
+  osalDbgCheck((bsp != NULL) && (statsp != NULL));
+
+  osalSysLock();
+  *statsp = bsp->stats;
+  osalSysUnlock();
+}
+
+/**
+ * @brief   Resets the scheduler statistics.
+ *
+ * @param[in] bsp       pointer to the @p BSchedDriver object
+ *
+ * @api
+ */
+void bschedResetStats(BSchedDriver *bsp) {
+
+  osalDbgCheck(bsp != NULL);
+
+  osalSysLock();
+  bsp->stats.chains       = 0U;
+  bsp->stats.xfers        = 0U;
+  bsp->stats.errors       = 0U;
+  bsp->stats.acquisitions = 0U;
+  osalSysUnlock();
+}
+
+/** @} */
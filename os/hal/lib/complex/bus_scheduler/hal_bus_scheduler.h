@@ -0,0 +1,345 @@
+/*
+    ChibiOS - Copyright (C) 2006..2018 Giovanni Di Sirio.
+
+    This file is part of ChibiOS.
+
+    ChibiOS is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 3 of the License, or
+    (at your option) any later version.
+
+    ChibiOS is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/**
+ * @file    hal_bus_scheduler.h
+ * @brief   Bus transactions scheduler header.
+ *
+ * @addtogroup HAL_BUS_SCHEDULER
+ * @{
+ */
+
+#ifndef HAL_BUS_SCHEDULER_H
+#define HAL_BUS_SCHEDULER_H
+
+/*===========================================================================*/
+/* Driver constants.                                                         */
+/*===========================================================================*/
+
+/**
+ * @name    Bus types
+ * @{
+ */
+#define BSCHED_BUS_I2C                      0U  /**< @brief I2C bus.        */
+#define BSCHED_BUS_SPI                      1U  /**< @brief SPI bus.        */
+/** @} */
+
+/*===========================================================================*/
+/* Driver pre-compile time settings.                                         */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Derived constants and error checks.                                       */
+/*===========================================================================*/
+
+#if (HAL_USE_I2C != TRUE) && (HAL_USE_SPI != TRUE)
+#error "the bus scheduler requires HAL_USE_I2C or HAL_USE_SPI"
+#endif
+
+#if (HAL_USE_I2C == TRUE) && (I2C_SUPPORTS_ASYNC != TRUE)
+#error "the bus scheduler requires an I2C driver supporting I2C_SUPPORTS_ASYNC"
+#endif
+
+/*===========================================================================*/
+/* Driver data structures and types.                                         */
+/*===========================================================================*/
+
+/**
+ * @brief   Type of a scheduler state.
+ */
+typedef enum {
+  BSCHED_UNINIT = 0,                /**< Not initialized.                   */
+  BSCHED_STOP = 1,                  /**< Stopped.                           */
+  BSCHED_READY = 2                  /**< Accepting chains.                  */
+} bschedstate_t;
+
+/**
+ * @brief   Type of a transfer chain.
+ */
+typedef struct bsched_chain bsched_chain_t;
+
+/**
+ * @brief   Type of a chain completion callback.
+ * @note    The callback is invoked from the ISR context with the system
+ *          locked, it can only use I-class functions.
+ *
+ * @param[in] chp       pointer to the completed @p bsched_chain_t object
+ */
+typedef void (*bschedcallback_t)(bsched_chain_t *chp);
+
+/**
+ * @brief   Type of an SPI chip select callback.
+ * @note    The callback is invoked with the system locked.
+ *
+ * @param[in] chp       pointer to the running @p bsched_chain_t object
+ * @param[in] select    @p true for asserting the chip select, @p false
+ *                      for releasing it
+ */
+typedef void (*bschedselect_t)(bsched_chain_t *chp, bool select);
+
+/**
+ * @brief   Type of a transfer descriptor.
+ * @details A transfer transmits @p txn bytes then receives @p rxn bytes,
+ *          on I2C it is a single transaction with a repeated start, on SPI
+ *          the chip select is asserted for the whole transfer.
+ */
+typedef struct {
+  /**
+   * @brief   Slave address, I2C only.
+   */
+  uint16_t              addr;
+  /**
+   * @brief   Transmit buffer.
+   */
+  const uint8_t         *txbuf;
+  /**
+   * @brief   Number of bytes to be transmitted.
+   */
+  size_t                txn;
+  /**
+   * @brief   Receive buffer.
+   */
+  uint8_t               *rxbuf;
+  /**
+   * @brief   Number of bytes to be received.
+   */
+  size_t                rxn;
+} bsched_xfer_t;
+
+/**
+ * @brief   Structure representing a transfer chain.
+ * @note    The fields are owned by the scheduler from the chain submission
+ *          until its completion.
+ */
+struct bsched_chain {
+  /**
+   * @brief   Next chain in the pending list.
+   */
+  bsched_chain_t        *next;
+  /**
+   * @brief   Transfer descriptors.
+   */
+  const bsched_xfer_t   *xfers;
+  /**
+   * @brief   Number of transfer descriptors.
+   */
+  size_t                n;
+  /**
+   * @brief   Completion callback or @p NULL.
+   */
+  bschedcallback_t      cb;
+  /**
+   * @brief   Callback argument.
+   */
+  void                  *arg;
+#if (HAL_USE_SPI == TRUE) || defined(__DOXYGEN__)
+  /**
+   * @brief   Chip select callback or @p NULL for the driver chip select.
+   */
+  bschedselect_t        select;
+#endif
+  /**
+   * @brief   Index of the running transfer.
+   */
+  size_t                index;
+  /**
+   * @brief   The receive phase of the running transfer is in progress.
+   */
+  bool                  rxphase;
+  /**
+   * @brief   Chain completed.
+   */
+  bool                  done;
+  /**
+   * @brief   Chain result, @p MSG_OK or @p MSG_RESET on failure.
+   */
+  msg_t                 result;
+  /**
+   * @brief   Threads waiting for completion.
+   */
+  threads_queue_t       waiting;
+};
+
+/**
+ * @brief   Type of a scheduler configuration structure.
+ */
+typedef struct {
+  /**
+   * @brief   Bus type.
+   */
+  unsigned              bus;
+#if (HAL_USE_I2C == TRUE) || defined(__DOXYGEN__)
+  /**
+   * @brief   I2C driver.
+   */
+  I2CDriver             *i2cp;
+  /**
+   * @brief   I2C configuration.
+   */
+  const I2CConfig       *i2ccfg;
+#endif
+#if (HAL_USE_SPI == TRUE) || defined(__DOXYGEN__)
+  /**
+   * @brief   SPI driver.
+   */
+  SPIDriver             *spip;
+  /**
+   * @brief   SPI configuration.
+   * @note    The @p end_cb field is ignored, the scheduler uses its own
+   *          callback.
+   */
+  const SPIConfig       *spicfg;
+#endif
+} BSchedConfig;
+
+/**
+ * @brief   Type of the scheduler statistics.
+ */
+typedef struct {
+  /**
+   * @brief   Completed chains.
+   */
+  uint32_t              chains;
+  /**
+   * @brief   Completed transfers.
+   */
+  uint32_t              xfers;
+  /**
+   * @brief   Failed chains.
+   */
+  uint32_t              errors;
+  /**
+   * @brief   Bus acquisitions by threads.
+   */
+  uint32_t              acquisitions;
+} bsched_stats_t;
+
+/**
+ * @brief   Structure representing a bus scheduler.
+ * @details Chains are executed in submission order, the next transfer is
+ *          started from the driver completion callback.
+ */
+typedef struct {
+  /**
+   * @brief   Scheduler state.
+   */
+  bschedstate_t         state;
+  /**
+   * @brief   Current configuration.
+   */
+  const BSchedConfig    *config;
+#if (HAL_USE_SPI == TRUE) || defined(__DOXYGEN__)
+  /**
+   * @brief   SPI configuration with the scheduler callback.
+   */
+  SPIConfig             spicfg;
+#endif
+  /**
+   * @brief   Running chain or @p NULL.
+   */
+  bsched_chain_t        *current;
+  /**
+   * @brief   First pending chain.
+   */
+  bsched_chain_t        *head;
+  /**
+   * @brief   Last pending chain.
+   */
+  bsched_chain_t        *tail;
+  /**
+   * @brief   The bus is owned by a thread.
+   */
+  bool                  owned;
+  /**
+   * @brief   Threads waiting for the bus ownership.
+   */
+  threads_queue_t       owners;
+  /**
+   * @brief   Number of threads waiting for the bus ownership.
+   */
+  unsigned              nowners;
+  /**
+   * @brief   Statistics.
+   */
+  bsched_stats_t        stats;
+} BSchedDriver;
+
+/*===========================================================================*/
+/* Driver macros.                                                            */
+/*===========================================================================*/
+
+/**
+ * @brief   Determines if a chain has been completed.
+ *
+ * @param[in] chp       pointer to the @p bsched_chain_t object
+ * @return              The chain state.
+ * @retval false        if the chain is pending.
+ * @retval true         if the chain has been completed.
+ *
+ * @iclass
+ */
+#define bschedIsChainDoneI(chp) ((chp)->done)
+
+/**
+ * @brief   Initializes a transfer descriptor.
+ *
+ * @param[out] xp       pointer to the @p bsched_xfer_t object
+ * @param[in] a         slave address, I2C only
+ * @param[in] tb        transmit buffer
+ * @param[in] tn        number of bytes to be transmitted
+ * @param[out] rb       receive buffer
+ * @param[in] rn        number of bytes to be received
+ *
+ * @special
+ */
+#define bschedXferObjectInit(xp, a, tb, tn, rb, rn) do {                    \
+  (xp)->addr  = (uint16_t)(a);                                              \
+  (xp)->txbuf = (tb);                                                       \
+  (xp)->txn   = (tn);                                                       \
+  (xp)->rxbuf = (rb);                                                       \
+  (xp)->rxn   = (rn);                                                       \
+} while (false)
+
+/*===========================================================================*/
+/* External declarations.                                                    */
+/*===========================================================================*/
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+  void bschedObjectInit(BSchedDriver *bsp);
+  void bschedStart(BSchedDriver *bsp, const BSchedConfig *config);
+  void bschedStop(BSchedDriver *bsp);
+  void bschedChainObjectInit(bsched_chain_t *chp,
+                             const bsched_xfer_t *xfers, size_t n,
+                             bschedcallback_t cb, void *arg);
+  void bschedSubmitI(BSchedDriver *bsp, bsched_chain_t *chp);
+  void bschedSubmit(BSchedDriver *bsp, bsched_chain_t *chp);
+  msg_t bschedWaitTimeout(bsched_chain_t *chp, sysinterval_t timeout);
+  void bschedAcquireBus(BSchedDriver *bsp);
+  void bschedReleaseBus(BSchedDriver *bsp);
+  void bschedGetStats(BSchedDriver *bsp, bsched_stats_t *statsp);
+  void bschedResetStats(BSchedDriver *bsp);
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* HAL_BUS_SCHEDULER_H */
+
+/** @} */
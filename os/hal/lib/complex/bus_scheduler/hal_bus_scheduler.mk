@@ -0,0 +1,9 @@
+# List of all the bus scheduler subsystem files.
+BSCHEDSRC := $(CHIBIOS)/os/hal/lib/complex/bus_scheduler/hal_bus_scheduler.c
+
+# Required include directories
+BSCHEDINC := $(CHIBIOS)/os/hal/lib/complex/bus_scheduler
+
+# Shared variables
+ALLCSRC += $(BSCHEDSRC)
+ALLINC  += $(BSCHEDINC)
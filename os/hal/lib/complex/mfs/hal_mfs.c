@@ -62,6 +62,13 @@
 #define ALIGNED_SIZEOF(t)                                                   \
   (((sizeof (t) - 1U) | MFS_ALIGN_MASK) + 1U)
 
+/**
+ * @brief   Checkpoint slot size aligned.
+ */
+#define CHECKPOINT_SLOT_SIZE                                                \
+  (flash_offset_t)(ALIGNED_SIZEOF(mfs_checkpoint_header_t) +                \
+                   ALIGNED_SIZEOF(mfs_record_descriptor_t[MFS_CFG_MAX_RECORDS]))
+
 /**
  * @brief   Combines two values (0..3) in one (0..15).
  */
@@ -147,6 +154,14 @@ static void mfs_state_reset(MFSDriver *mfsp) {
     mfsp->descriptors[i].offset = 0U;
     mfsp->descriptors[i].size   = 0U;
   }
+
+#if MFS_CFG_USE_CHECKPOINTS == TRUE
+  mfsp->cp_next = 0U;
+  mfsp->cp_ops  = 0U;
+#endif
+#if MFS_CFG_USE_INCREMENTAL_GC == TRUE
+  mfsp->gc_state = MFS_GC_IDLE;
+#endif
 }
 
 static flash_offset_t mfs_flash_get_bank_offset(MFSDriver *mfsp,
@@ -267,6 +282,37 @@ static mfs_error_t mfs_flash_copy(MFSDriver *mfsp,
   return MFS_NO_ERROR;
 }
 
+/**
+ * @brief   Erases and verifies a sector.
+ *
+ * @param[in] mfsp      pointer to the @p MFSDriver object
+ * @param[in] sector    sector to be erased
+ * @return              The operation status.
+ *
+ * @notapi
+ */
+static mfs_error_t mfs_flash_erase(MFSDriver *mfsp, flash_sector_t sector) {
+  flash_error_t ferr;
+
+  ferr = flashStartEraseSector(mfsp->config->flashp, sector);
+  if (ferr != FLASH_NO_ERROR) {
+    mfsp->state = MFS_ERROR;
+    return MFS_ERR_FLASH_FAILURE;
+  }
+  ferr = flashWaitErase(mfsp->config->flashp);
+  if (ferr != FLASH_NO_ERROR) {
+    mfsp->state = MFS_ERROR;
+    return MFS_ERR_FLASH_FAILURE;
+  }
+  ferr = flashVerifyErase(mfsp->config->flashp, sector);
+  if (ferr != FLASH_NO_ERROR) {
+    mfsp->state = MFS_ERROR;
+    return MFS_ERR_FLASH_FAILURE;
+  }
+
+  return MFS_NO_ERROR;
+}
+
 /**
  * @brief   Erases and verifies all sectors belonging to a bank.
  *
@@ -289,24 +335,7 @@ static mfs_error_t mfs_bank_erase(MFSDriver *mfsp, mfs_bank_t bank) {
   }
 
   while (sector < end) {
-    flash_error_t ferr;
-
-    ferr = flashStartEraseSector(mfsp->config->flashp, sector);
-    if (ferr != FLASH_NO_ERROR) {
-      mfsp->state = MFS_ERROR;
-      return MFS_ERR_FLASH_FAILURE;
-    }
-    ferr = flashWaitErase(mfsp->config->flashp);
-    if (ferr != FLASH_NO_ERROR) {
-      mfsp->state = MFS_ERROR;
-      return MFS_ERR_FLASH_FAILURE;
-    }
-    ferr = flashVerifyErase(mfsp->config->flashp, sector);
-    if (ferr != FLASH_NO_ERROR) {
-      mfsp->state = MFS_ERROR;
-      return MFS_ERR_FLASH_FAILURE;
-    }
-
+    RET_ON_ERROR(mfs_flash_erase(mfsp, sector));
     sector++;
   }
 
@@ -352,6 +381,326 @@ static mfs_error_t mfs_bank_verify_erase(MFSDriver *mfsp, mfs_bank_t bank) {
   return MFS_NO_ERROR;
 }
 
+#if (MFS_CFG_USE_CHECKPOINTS == TRUE) || defined(__DOXYGEN__)
+/**
+ * @brief   Returns the number of slots in the checkpoints area.
+ *
+ * @param[in] mfsp      pointer to the @p MFSDriver object
+ * @return              The number of checkpoint slots.
+ *
+ * @notapi
+ */
+static uint32_t mfs_checkpoint_get_slots(MFSDriver *mfsp) {
+  flash_sector_t sector, end;
+  uint32_t size = 0U;
+
+  sector = mfsp->config->checkpoint_start;
+  end    = mfsp->config->checkpoint_start + mfsp->config->checkpoint_sectors;
+  while (sector < end) {
+    size += flashGetSectorSize(mfsp->config->flashp, sector);
+    sector++;
+  }
+
+  return size / CHECKPOINT_SLOT_SIZE;
+}
+
+/**
+ * @brief   Returns the offset of a checkpoint slot.
+ *
+ * @param[in] mfsp      pointer to the @p MFSDriver object
+ * @param[in] slot      slot index
+ * @return              The slot offset.
+ *
+ * @notapi
+ */
+static flash_offset_t mfs_checkpoint_get_offset(MFSDriver *mfsp,
+                                                uint32_t slot) {
+
+  return flashGetSectorOffset(mfsp->config->flashp,
+                              mfsp->config->checkpoint_start) +
+         (slot * CHECKPOINT_SLOT_SIZE);
+}
+
+/**
+ * @brief   Calculates the CRC of a checkpoint.
+ * @note    The CRC covers the current records index and the header fields
+ *          except magic numbers and CRC.
+ *
+ * @param[in] mfsp      pointer to the @p MFSDriver object
+ * @param[in] chdrp     pointer to the checkpoint header
+ * @return              The calculated CRC.
+ *
+ * @notapi
+ */
+static uint16_t mfs_checkpoint_crc(MFSDriver *mfsp,
+                                   const mfs_checkpoint_header_t *chdrp) {
+  uint16_t crc;
+
+  crc = crc16(0xFFFFU, (const uint8_t *)mfsp->descriptors,
+              sizeof (mfsp->descriptors));
+  return crc16(crc, &chdrp->hdr8[sizeof (uint32_t) * 2U],
+               sizeof (mfs_checkpoint_header_t) - (sizeof (uint32_t) * 2U) -
+               sizeof (uint16_t));
+}
+
+/**
+ * @brief   Erases the checkpoints area.
+ *
+ * @param[in] mfsp      pointer to the @p MFSDriver object
+ * @return              The operation status.
+ *
+ * @notapi
+ */
+static mfs_error_t mfs_checkpoint_erase(MFSDriver *mfsp) {
+  flash_sector_t sector, end;
+
+  sector = mfsp->config->checkpoint_start;
+  end    = mfsp->config->checkpoint_start + mfsp->config->checkpoint_sectors;
+  while (sector < end) {
+    RET_ON_ERROR(mfs_flash_erase(mfsp, sector));
+    sector++;
+  }
+
+  mfsp->cp_next = 0U;
+
+  return MFS_NO_ERROR;
+}
+
+/**
+ * @brief   Checks if a checkpoint slot is fully erased.
+ *
+ * @param[in] mfsp      pointer to the @p MFSDriver object
+ * @param[in] offset    slot offset
+ * @param[out] erasedp  @p true if the slot is erased
+ * @return              The operation status.
+ *
+ * @notapi
+ */
+static mfs_error_t mfs_checkpoint_is_erased(MFSDriver *mfsp,
+                                            flash_offset_t offset,
+                                            bool *erasedp) {
+  uint32_t total = CHECKPOINT_SLOT_SIZE;
+
+  *erasedp = false;
+  while (total > 0U) {
+    uint32_t i, chunk = total > MFS_CFG_BUFFER_SIZE ? MFS_CFG_BUFFER_SIZE :
+                                                      total;
+
+    RET_ON_ERROR(mfs_flash_read(mfsp, offset, chunk, mfsp->buffer.data8));
+    for (i = 0U; i < chunk; i++) {
+      if (mfsp->buffer.data8[i] != (uint8_t)mfsp->config->erased) {
+        return MFS_NO_ERROR;
+      }
+    }
+
+    offset += chunk;
+    total  -= chunk;
+  }
+  *erasedp = true;
+
+  return MFS_NO_ERROR;
+}
+
+/**
+ * @brief   Writes a checkpoint of the current records index.
+ * @note    The checkpoint is written in the next erased slot, the whole
+ *          area is erased when there are no more free slots.
+ * @note    The header magic numbers are written last, they seal the
+ *          operation.
+ *
+ * @param[in] mfsp      pointer to the @p MFSDriver object
+ * @param[in] erased    the other bank is known to be fully erased, on
+ *                      mount its erase verification is skipped
+ * @return              The operation status.
+ *
+ * @notapi
+ */
+static mfs_error_t mfs_checkpoint_write(MFSDriver *mfsp, bool erased) {
+  mfs_checkpoint_header_t chdr;
+  flash_offset_t offset;
+  uint32_t slots = mfs_checkpoint_get_slots(mfsp);
+
+  /* Checked on start but release builds would write outside the area.*/
+  if (slots == 0U) {
+    return MFS_ERR_INTERNAL;
+  }
+
+  /* Searching for an erased slot, slots partially written because a power
+     loss are skipped.*/
+  while (true) {
+    bool erased;
+
+    if (mfsp->cp_next >= slots) {
+      RET_ON_ERROR(mfs_checkpoint_erase(mfsp));
+    }
+    offset = mfs_checkpoint_get_offset(mfsp, mfsp->cp_next);
+    RET_ON_ERROR(mfs_checkpoint_is_erased(mfsp, offset, &erased));
+    if (erased) {
+      break;
+    }
+    mfsp->cp_next++;
+  }
+
+  /* Writing the header without the magic, it will be written last.*/
+  chdr.fields.counter     = mfsp->current_counter;
+  chdr.fields.next_offset = mfsp->next_offset;
+  chdr.fields.bank        = (uint8_t)mfsp->current_bank;
+  chdr.fields.flags       = erased ? (uint8_t)MFS_CHECKPOINT_FLAG_ERASED :
+                                     (uint8_t)0U;
+  chdr.fields.crc         = mfs_checkpoint_crc(mfsp, &chdr);
+  RET_ON_ERROR(mfs_flash_write(mfsp,
+                               offset + (sizeof (uint32_t) * 2U),
+                               sizeof (mfs_checkpoint_header_t) - (sizeof (uint32_t) * 2U),
+                               chdr.hdr8 + (sizeof (uint32_t) * 2U)));
+
+  /* Writing the records index.*/
+  RET_ON_ERROR(mfs_flash_write(mfsp,
+                               offset + ALIGNED_SIZEOF(mfs_checkpoint_header_t),
+                               sizeof (mfsp->descriptors),
+                               (const uint8_t *)mfsp->descriptors));
+
+  /* Finally writing the magic number, it seals the operation.*/
+  chdr.fields.magic1 = (uint32_t)MFS_CHECKPOINT_MAGIC_1;
+  chdr.fields.magic2 = (uint32_t)MFS_CHECKPOINT_MAGIC_2;
+  RET_ON_ERROR(mfs_flash_write(mfsp,
+                               offset,
+                               sizeof (uint32_t) * 2U,
+                               chdr.hdr8));
+
+  mfsp->cp_next++;
+  mfsp->cp_ops = 0U;
+
+  return MFS_NO_ERROR;
+}
+
+/**
+ * @brief   Loads the most recent valid checkpoint for a bank.
+ * @details The records index is restored from the checkpoint and the
+ *          offset of the first record written after the checkpoint is
+ *          returned, records scanning can start from there.
+ * @note    If a valid checkpoint is not found then the records index is
+ *          cleared, @p offsetp is not modified and @p erasedp is set
+ *          to @p false.
+ *
+ * @param[in] mfsp      pointer to the @p MFSDriver object
+ * @param[in] bank      the bank identifier
+ * @param[in] cnt       usage counter of the bank
+ * @param[in,out] offsetp pointer to the scan start offset
+ * @param[out] erasedp  set to @p true if the checkpoint states that the
+ *                      other bank is fully erased
+ * @return              The operation status.
+ *
+ * @notapi
+ */
+static mfs_error_t mfs_checkpoint_load(MFSDriver *mfsp,
+                                       mfs_bank_t bank,
+                                       uint32_t cnt,
+                                       flash_offset_t *offsetp,
+                                       bool *erasedp) {
+  mfs_checkpoint_header_t chdr;
+  flash_offset_t start_offset, end_offset;
+  uint32_t i, slots = mfs_checkpoint_get_slots(mfsp);
+
+  /* Boundaries.*/
+  start_offset = mfs_flash_get_bank_offset(mfsp, bank) +
+                 (flash_offset_t)ALIGNED_SIZEOF(mfs_bank_header_t);
+  end_offset   = mfs_flash_get_bank_offset(mfsp, bank) +
+                 mfsp->config->bank_size;
+
+  /* Searching for the first slot with an erased header, checkpoints are
+     written in sequence so the most recent is the one before.*/
+  *erasedp = false;
+  mfsp->cp_next = 0U;
+  while (mfsp->cp_next < slots) {
+    RET_ON_ERROR(mfs_flash_read(mfsp,
+                                mfs_checkpoint_get_offset(mfsp, mfsp->cp_next),
+                                sizeof (mfs_checkpoint_header_t),
+                                chdr.hdr8));
+    if ((chdr.hdr32[0] == mfsp->config->erased) &&
+        (chdr.hdr32[1] == mfsp->config->erased) &&
+        (chdr.hdr32[2] == mfsp->config->erased) &&
+        (chdr.hdr32[3] == mfsp->config->erased) &&
+        (chdr.hdr32[4] == mfsp->config->erased)) {
+      break;
+    }
+    mfsp->cp_next++;
+  }
+
+  /* Searching backward for a valid checkpoint of the specified bank.*/
+  i = mfsp->cp_next;
+  while (i > 0U) {
+    flash_offset_t offset;
+
+    i--;
+    offset = mfs_checkpoint_get_offset(mfsp, i);
+    RET_ON_ERROR(mfs_flash_read(mfsp, offset,
+                                sizeof (mfs_checkpoint_header_t),
+                                chdr.hdr8));
+
+    /* Checking header fields integrity.*/
+    if ((chdr.fields.magic1 != MFS_CHECKPOINT_MAGIC_1) ||
+        (chdr.fields.magic2 != MFS_CHECKPOINT_MAGIC_2) ||
+        (chdr.fields.counter != cnt) ||
+        (chdr.fields.bank != (uint8_t)bank) ||
+        (chdr.fields.next_offset < start_offset) ||
+        (chdr.fields.next_offset > end_offset)) {
+      continue;
+    }
+
+    /* Reading the records index and verifying the CRC.*/
+    RET_ON_ERROR(mfs_flash_read(mfsp,
+                                offset + ALIGNED_SIZEOF(mfs_checkpoint_header_t),
+                                sizeof (mfsp->descriptors),
+                                (uint8_t *)mfsp->descriptors));
+    if (mfs_checkpoint_crc(mfsp, &chdr) == chdr.fields.crc) {
+      *offsetp = chdr.fields.next_offset;
+      *erasedp = (chdr.fields.flags & MFS_CHECKPOINT_FLAG_ERASED) != 0U;
+      return MFS_NO_ERROR;
+    }
+  }
+
+  /* No valid checkpoint, the records index could have been overwritten
+     by an invalid one.*/
+  for (i = 0; i < MFS_CFG_MAX_RECORDS; i++) {
+    mfsp->descriptors[i].offset = 0U;
+    mfsp->descriptors[i].size   = 0U;
+  }
+
+  return MFS_NO_ERROR;
+}
+
+/**
+ * @brief   Accounts an operation and writes a checkpoint when required.
+ *
+ * @param[in] mfsp      pointer to the @p MFSDriver object
+ * @return              The operation status.
+ *
+ * @notapi
+ */
+static mfs_error_t mfs_checkpoint_count(MFSDriver *mfsp) {
+
+#if MFS_CFG_CHECKPOINT_INTERVAL > 0
+  mfsp->cp_ops++;
+  if (mfsp->cp_ops >= (uint32_t)MFS_CFG_CHECKPOINT_INTERVAL) {
+#if MFS_CFG_USE_INCREMENTAL_GC == TRUE
+    /* The records index is not consistent while records are being moved,
+       the checkpoint is written when the copy is finished.*/
+    if (mfsp->gc_state == MFS_GC_COPY) {
+      return MFS_NO_ERROR;
+    }
+    return mfs_checkpoint_write(mfsp, mfsp->gc_state == MFS_GC_IDLE);
+#else
+    return mfs_checkpoint_write(mfsp, true);
+#endif
+  }
+#else
+  (void)mfsp;
+#endif
+
+  return MFS_NO_ERROR;
+}
+#endif /* MFS_CFG_USE_CHECKPOINTS == TRUE */
+
 /**
  * @brief   Writes the validation header in a bank.
  *
@@ -382,6 +731,14 @@ static mfs_error_t mfs_bank_write_header(MFSDriver *mfsp,
   bhdr.fields.crc       = crc16(0xFFFFU, bhdr.hdr8,
                                 sizeof (mfs_bank_header_t) - sizeof (uint16_t));
 
+#if MFS_CFG_USE_CHECKPOINTS == TRUE
+  /* A new partition is being initialized, old checkpoints could match the
+     new bank so the checkpoints area is erased first.*/
+  if (cnt == 1U) {
+    RET_ON_ERROR(mfs_checkpoint_erase(mfsp));
+  }
+#endif
+
   return mfs_flash_write(mfsp,
                          flashGetSectorOffset(mfsp->config->flashp, sector),
                          sizeof (mfs_bank_header_t),
@@ -431,6 +788,7 @@ static mfs_bank_state_t mfs_bank_check_header(MFSDriver *mfsp) {
  *
  * @param[in] mfsp      pointer to the @p MFSDriver object
  * @param[in] bank      the bank identifier
+ * @param[in] offset    offset of the first record header to be scanned
  * @param[out] wflagp   warning flag on anomalies
  *
  * @return              The operation status.
@@ -439,6 +797,7 @@ static mfs_bank_state_t mfs_bank_check_header(MFSDriver *mfsp) {
  */
 static mfs_error_t mfs_bank_scan_records(MFSDriver *mfsp,
                                          mfs_bank_t bank,
+                                         flash_offset_t offset,
                                          bool *wflagp) {
   flash_offset_t hdr_offset, start_offset, end_offset;
 
@@ -447,7 +806,7 @@ static mfs_error_t mfs_bank_scan_records(MFSDriver *mfsp,
 
   /* Boundaries.*/
   start_offset = mfs_flash_get_bank_offset(mfsp, bank);
-  hdr_offset   = start_offset + (flash_offset_t)ALIGNED_SIZEOF(mfs_bank_header_t);
+  hdr_offset   = offset;
   end_offset   = start_offset + mfsp->config->bank_size;
 
   /* Scanning records until there is there is not enough space left for an
@@ -563,6 +922,25 @@ static mfs_error_t mfs_bank_get_state(MFSDriver *mfsp,
 
   /* Checking just the header.*/
   *statep = mfs_bank_check_header(mfsp);
+
+  return MFS_NO_ERROR;
+}
+
+/**
+ * @brief   Verifies a bank whose header appears erased.
+ * @details The state becomes @p MFS_BANK_GARBAGE if the bank is not
+ *          fully erased.
+ *
+ * @param[in] mfsp      pointer to the @p MFSDriver object
+ * @param[in] bank      the bank identifier
+ * @param[in,out] statep bank state
+ *
+ * @notapi
+ */
+static void mfs_bank_verify_state(MFSDriver *mfsp,
+                                  mfs_bank_t bank,
+                                  mfs_bank_state_t *statep) {
+
   if (*statep == MFS_BANK_ERASED) {
     mfs_error_t err;
 
@@ -572,10 +950,238 @@ static mfs_error_t mfs_bank_get_state(MFSDriver *mfsp,
       *statep = MFS_BANK_GARBAGE;
     }
   }
+}
+
+#if (MFS_CFG_USE_INCREMENTAL_GC == TRUE) || defined(__DOXYGEN__)
+/**
+ * @brief   Starts an incremental garbage collection cycle.
+ *
+ * @param[in] mfsp      pointer to the @p MFSDriver object
+ *
+ * @notapi
+ */
+static void mfs_gc_start(MFSDriver *mfsp) {
+  unsigned i;
+  mfs_bank_t dbank;
+
+  dbank = mfsp->current_bank == MFS_BANK_0 ? MFS_BANK_1 : MFS_BANK_0;
+
+  mfsp->gc_state  = MFS_GC_COPY;
+  mfsp->gc_index  = 0U;
+  mfsp->gc_offset = mfs_flash_get_bank_offset(mfsp, dbank) +
+                    ALIGNED_SIZEOF(mfs_bank_header_t);
+  mfsp->gc_space  = mfsp->used_space;
+  for (i = 0; i < (MFS_CFG_MAX_RECORDS + 31) / 32; i++) {
+    mfsp->gc_copied[i] = 0U;
+  }
+}
+
+/**
+ * @brief   Checks if a record instance is in the source bank.
+ *
+ * @param[in] mfsp      pointer to the @p MFSDriver object
+ * @param[in] offset    record header offset
+ * @return              The check result.
+ *
+ * @notapi
+ */
+static bool mfs_gc_is_source(MFSDriver *mfsp, flash_offset_t offset) {
+  flash_offset_t start = mfs_flash_get_bank_offset(mfsp, mfsp->current_bank);
+
+  return (offset >= start) && (offset < start + mfsp->config->bank_size);
+}
+
+/**
+ * @brief   Copies a record in the destination bank.
+ * @note    The record descriptor is updated to point to the copy, the data
+ *          is the same so the record remains readable.
+ *
+ * @param[in] mfsp      pointer to the @p MFSDriver object
+ * @param[in] i         record index
+ * @return              The operation status.
+ *
+ * @notapi
+ */
+static mfs_error_t mfs_gc_copy_record(MFSDriver *mfsp, unsigned i) {
+  uint32_t totsize = ALIGNED_REC_SIZE(mfsp->descriptors[i].size);
+
+  RET_ON_ERROR(mfs_flash_copy(mfsp, mfsp->gc_offset,
+                              mfsp->descriptors[i].offset,
+                              totsize));
+  mfsp->descriptors[i].offset = mfsp->gc_offset;
+  mfsp->gc_offset += totsize;
+  mfsp->gc_copied[i / 32U] |= 1U << (i % 32U);
+
+  return MFS_NO_ERROR;
+}
+
+/**
+ * @brief   Finalizes the copy phase of an incremental garbage collection.
+ * @details Records written in the source bank after being copied are copied
+ *          again, records erased after being copied get an erase marker
+ *          in the destination bank. The destination bank is then validated
+ *          and becomes the current bank.
+ *
+ * @param[in] mfsp      pointer to the @p MFSDriver object
+ * @return              The operation status.
+ *
+ * @notapi
+ */
+static mfs_error_t mfs_gc_finalize(MFSDriver *mfsp) {
+  unsigned i;
+
+  for (i = 0; i < MFS_CFG_MAX_RECORDS; i++) {
+    if (mfsp->descriptors[i].offset != 0U) {
+      if (mfs_gc_is_source(mfsp, mfsp->descriptors[i].offset)) {
+        RET_ON_ERROR(mfs_gc_copy_record(mfsp, i));
+      }
+    }
+    else if ((mfsp->gc_copied[i / 32U] & (1U << (i % 32U))) != 0U) {
+      /* Writing an erase marker over the copied instance.*/
+      mfsp->buffer.dhdr.fields.magic1 = (uint32_t)MFS_HEADER_MAGIC_1;
+      mfsp->buffer.dhdr.fields.magic2 = (uint32_t)MFS_HEADER_MAGIC_2;
+      mfsp->buffer.dhdr.fields.id     = (uint16_t)(i + 1U);
+      mfsp->buffer.dhdr.fields.size   = (uint32_t)0;
+      mfsp->buffer.dhdr.fields.crc    = (uint16_t)0xFFFF;
+      RET_ON_ERROR(mfs_flash_write(mfsp,
+                                   mfsp->gc_offset,
+                                   sizeof (mfs_data_header_t),
+                                   mfsp->buffer.data8));
+      mfsp->gc_offset += ALIGNED_DHDR_SIZE;
+    }
+  }
+
+  /* New current bank.*/
+  mfsp->current_bank = mfsp->current_bank == MFS_BANK_0 ? MFS_BANK_1 :
+                                                          MFS_BANK_0;
+  mfsp->current_counter += 1U;
+  mfsp->next_offset = mfsp->gc_offset;
+
+  /* The header is written after the data.*/
+  RET_ON_ERROR(mfs_bank_write_header(mfsp, mfsp->current_bank,
+                                     mfsp->current_counter));
+
+  /* Calculating the effective used size.*/
+  mfsp->used_space = ALIGNED_SIZEOF(mfs_bank_header_t);
+  for (i = 0; i < MFS_CFG_MAX_RECORDS; i++) {
+    if (mfsp->descriptors[i].offset != 0U) {
+      mfsp->used_space += ALIGNED_REC_SIZE(mfsp->descriptors[i].size);
+    }
+  }
+
+  /* The old bank is erased in the next steps.*/
+  mfsp->gc_state = MFS_GC_ERASE;
+  mfsp->gc_index = 0U;
+
+#if MFS_CFG_USE_CHECKPOINTS == TRUE
+  RET_ON_ERROR(mfs_checkpoint_write(mfsp, false));
+#endif
+
+  return MFS_NO_ERROR;
+}
+
+/**
+ * @brief   Performs a single incremental garbage collection step.
+ * @details A step is the copy of a single record or the erase of a single
+ *          sector of the old bank.
+ *
+ * @param[in] mfsp      pointer to the @p MFSDriver object
+ * @return              The operation status.
+ *
+ * @notapi
+ */
+static mfs_error_t mfs_gc_step(MFSDriver *mfsp) {
+
+  if (mfsp->gc_state == MFS_GC_COPY) {
+    while (mfsp->gc_index < (uint32_t)MFS_CFG_MAX_RECORDS) {
+      unsigned i = (unsigned)mfsp->gc_index;
+
+      mfsp->gc_index++;
+      if ((mfsp->descriptors[i].offset != 0U) &&
+          mfs_gc_is_source(mfsp, mfsp->descriptors[i].offset)) {
+        return mfs_gc_copy_record(mfsp, i);
+      }
+    }
+
+    return mfs_gc_finalize(mfsp);
+  }
+
+  if (mfsp->gc_state == MFS_GC_ERASE) {
+    flash_sector_t start, n;
+
+    if (mfsp->current_bank == MFS_BANK_0) {
+      start = mfsp->config->bank1_start;
+      n     = mfsp->config->bank1_sectors;
+    }
+    else {
+      start = mfsp->config->bank0_start;
+      n     = mfsp->config->bank0_sectors;
+    }
+
+    RET_ON_ERROR(mfs_flash_erase(mfsp, start + mfsp->gc_index));
+    mfsp->gc_index++;
+    if (mfsp->gc_index >= n) {
+      mfsp->gc_state = MFS_GC_IDLE;
+    }
+  }
 
   return MFS_NO_ERROR;
 }
 
+/**
+ * @brief   Completes an incremental garbage collection cycle, if any.
+ *
+ * @param[in] mfsp      pointer to the @p MFSDriver object
+ * @return              The operation status.
+ *
+ * @notapi
+ */
+static mfs_error_t mfs_gc_complete(MFSDriver *mfsp) {
+
+  while (mfsp->gc_state != MFS_GC_IDLE) {
+    RET_ON_ERROR(mfs_gc_step(mfsp));
+  }
+
+  return MFS_NO_ERROR;
+}
+
+/**
+ * @brief   Reserves space for an operation during the copy phase.
+ * @details Records written during the copy phase must be copied again when
+ *          the phase is finalized, the space is reserved in the destination
+ *          bank. If the operation does not fit in one of the banks then
+ *          the cycle is completed immediately.
+ *
+ * @param[in] mfsp      pointer to the @p MFSDriver object
+ * @param[in] rspace    space required by the operation
+ * @param[out] warningp set to @p true if the cycle has been completed
+ * @return              The operation status.
+ *
+ * @notapi
+ */
+static mfs_error_t mfs_gc_reserve(MFSDriver *mfsp,
+                                  flash_offset_t rspace,
+                                  bool *warningp) {
+  flash_offset_t free;
+
+  if (mfsp->gc_state != MFS_GC_COPY) {
+    return MFS_NO_ERROR;
+  }
+
+  free = (mfs_flash_get_bank_offset(mfsp, mfsp->current_bank) +
+          mfsp->config->bank_size) - mfsp->next_offset;
+  if ((rspace > free) ||
+      (rspace > mfsp->config->bank_size - mfsp->gc_space)) {
+    *warningp = true;
+    return mfs_gc_complete(mfsp);
+  }
+
+  mfsp->gc_space += rspace;
+
+  return MFS_NO_ERROR;
+}
+#endif /* MFS_CFG_USE_INCREMENTAL_GC == TRUE */
+
 /**
  * @brief   Enforces a garbage collection.
  * @details Storage data is compacted into a single bank.
@@ -590,6 +1196,12 @@ static mfs_error_t mfs_garbage_collect(MFSDriver *mfsp) {
   mfs_bank_t sbank, dbank;
   flash_offset_t dest_offset;
 
+#if MFS_CFG_USE_INCREMENTAL_GC == TRUE
+  /* An incremental cycle in progress is completed first, the other bank
+     must be fully erased.*/
+  RET_ON_ERROR(mfs_gc_complete(mfsp));
+#endif
+
   sbank = mfsp->current_bank;
   if (sbank == MFS_BANK_0) {
     dbank = MFS_BANK_1;
@@ -598,6 +1210,12 @@ static mfs_error_t mfs_garbage_collect(MFSDriver *mfsp) {
     dbank = MFS_BANK_0;
   }
 
+#if MFS_CFG_USE_CHECKPOINTS == TRUE
+  /* The previous checkpoint could state the other bank as erased, it is
+     superseded before writing in it.*/
+  RET_ON_ERROR(mfs_checkpoint_write(mfsp, false));
+#endif
+
   /* Write address.*/
   dest_offset = mfs_flash_get_bank_offset(mfsp, dbank) +
                 ALIGNED_SIZEOF(mfs_bank_header_t);
@@ -625,6 +1243,10 @@ static mfs_error_t mfs_garbage_collect(MFSDriver *mfsp) {
   /* The source bank is erased last.*/
   RET_ON_ERROR(mfs_bank_erase(mfsp, sbank));
 
+#if MFS_CFG_USE_CHECKPOINTS == TRUE
+  RET_ON_ERROR(mfs_checkpoint_write(mfsp, true));
+#endif
+
   return MFS_NO_ERROR;
 }
 
@@ -640,7 +1262,7 @@ static mfs_error_t mfs_try_mount(MFSDriver *mfsp) {
   mfs_bank_state_t sts0, sts1;
   mfs_bank_t bank;
   uint32_t cnt0 = 0, cnt1 = 0;
-  bool w1 = false, w2 = false;
+  bool w1 = false, w2 = false, spare = false, erased = false;
 
   /* Resetting the bank state.*/
   mfs_state_reset(mfsp);
@@ -649,6 +1271,18 @@ static mfs_error_t mfs_try_mount(MFSDriver *mfsp) {
   RET_ON_ERROR(mfs_bank_get_state(mfsp, MFS_BANK_0, &sts0, &cnt0));
   RET_ON_ERROR(mfs_bank_get_state(mfsp, MFS_BANK_1, &sts1, &cnt1));
 
+  /* Banks with an erased header are verified, in the normal situation of
+     a valid bank and an erased spare bank the verification is deferred,
+     a checkpoint of the valid bank can make it unnecessary.*/
+  if ((PAIR(sts0, sts1) == PAIR(MFS_BANK_ERASED, MFS_BANK_OK)) ||
+      (PAIR(sts0, sts1) == PAIR(MFS_BANK_OK, MFS_BANK_ERASED))) {
+    spare = true;
+  }
+  else {
+    mfs_bank_verify_state(mfsp, MFS_BANK_0, &sts0);
+    mfs_bank_verify_state(mfsp, MFS_BANK_1, &sts1);
+  }
+
   /* Handling all possible scenarios, each one requires its own recovery
      strategy.*/
   switch (PAIR(sts0, sts1)) {
@@ -731,6 +1365,7 @@ static mfs_error_t mfs_try_mount(MFSDriver *mfsp) {
   /* Mounting the bank.*/
   {
     unsigned i;
+    flash_offset_t offset;
 
     /* Reading the bank header again.*/
     RET_ON_ERROR(mfs_flash_read(mfsp, mfs_flash_get_bank_offset(mfsp, bank),
@@ -746,8 +1381,19 @@ static mfs_error_t mfs_try_mount(MFSDriver *mfsp) {
     mfsp->current_bank    = bank;
     mfsp->current_counter = mfsp->buffer.bhdr.fields.counter;
 
+    /* Scanning starts after the bank header.*/
+    offset = mfs_flash_get_bank_offset(mfsp, bank) +
+             (flash_offset_t)ALIGNED_SIZEOF(mfs_bank_header_t);
+
+#if MFS_CFG_USE_CHECKPOINTS == TRUE
+    /* If there is a valid checkpoint then only the records written after
+       it need to be scanned.*/
+    RET_ON_ERROR(mfs_checkpoint_load(mfsp, bank, mfsp->current_counter,
+                                     &offset, &erased));
+#endif
+
     /* Scanning for the most recent instance of all records.*/
-    RET_ON_ERROR(mfs_bank_scan_records(mfsp, bank, &w2));
+    RET_ON_ERROR(mfs_bank_scan_records(mfsp, bank, offset, &w2));
 
     /* Calculating the effective used size.*/
     mfsp->used_space = ALIGNED_SIZEOF(mfs_bank_header_t);
@@ -758,6 +1404,19 @@ static mfs_error_t mfs_try_mount(MFSDriver *mfsp) {
     }
   }
 
+  /* The spare bank is verified unless the checkpoint stated it erased, a
+     bank not fully erased is erased again.*/
+  if (spare && !erased) {
+    mfs_bank_state_t sts = MFS_BANK_ERASED;
+    mfs_bank_t sbank = bank == MFS_BANK_0 ? MFS_BANK_1 : MFS_BANK_0;
+
+    mfs_bank_verify_state(mfsp, sbank, &sts);
+    if (sts == MFS_BANK_GARBAGE) {
+      RET_ON_ERROR(mfs_bank_erase(mfsp, sbank));
+      w1 = true;
+    }
+  }
+
   /* In case of detected problems then a garbage collection is performed in
      order to repair/remove anomalies.*/
   if (w2) {
@@ -850,11 +1509,26 @@ void mfsObjectInit(MFSDriver *mfsp) {
 mfs_error_t mfsStart(MFSDriver *mfsp, const MFSConfig *config) {
 
   osalDbgCheck((mfsp != NULL) && (config != NULL));
+#if MFS_CFG_USE_CHECKPOINTS == TRUE
+  osalDbgCheck((config->checkpoint_sectors > 0U) &&
+               ((config->checkpoint_start + config->checkpoint_sectors <=
+                 config->bank0_start) ||
+                (config->checkpoint_start >=
+                 config->bank0_start + config->bank0_sectors)) &&
+               ((config->checkpoint_start + config->checkpoint_sectors <=
+                 config->bank1_start) ||
+                (config->checkpoint_start >=
+                 config->bank1_start + config->bank1_sectors)));
+#endif
   osalDbgAssert((mfsp->state == MFS_STOP) || (mfsp->state == MFS_READY) ||
                 (mfsp->state == MFS_ERROR), "invalid state");
 
   /* Storing configuration.*/
   mfsp->config = config;
+#if MFS_CFG_USE_CHECKPOINTS == TRUE
+  osalDbgAssert(mfs_checkpoint_get_slots(mfsp) > 0U,
+                "checkpoints area too small");
+#endif
 
   return mfs_mount(mfsp);
 } 
@@ -1027,6 +1701,10 @@ mfs_error_t mfsWriteRecord(MFSDriver *mfsp, mfs_id_t id,
       return MFS_ERR_OUT_OF_MEM;
     }
 
+#if MFS_CFG_USE_INCREMENTAL_GC == TRUE
+    RET_ON_ERROR(mfs_gc_reserve(mfsp, rspace, &warning));
+#endif
+
     /* Checking for immediately (not compacted) available space.*/
     free = (mfs_flash_get_bank_offset(mfsp, mfsp->current_bank) +
             mfsp->config->bank_size) - mfsp->next_offset;
@@ -1072,6 +1750,10 @@ mfs_error_t mfsWriteRecord(MFSDriver *mfsp, mfs_id_t id,
     mfsp->next_offset += asize;
     mfsp->used_space  += asize;
 
+#if MFS_CFG_USE_CHECKPOINTS == TRUE
+    RET_ON_ERROR(mfs_checkpoint_count(mfsp));
+#endif
+
     return warning ? MFS_WARN_GC : MFS_NO_ERROR;
   }
 
@@ -1177,6 +1859,10 @@ mfs_error_t mfsEraseRecord(MFSDriver *mfsp, mfs_id_t id) {
       return MFS_ERR_INTERNAL;
     }
 
+#if MFS_CFG_USE_INCREMENTAL_GC == TRUE
+    RET_ON_ERROR(mfs_gc_reserve(mfsp, rspace, &warning));
+#endif
+
     /* Checking for immediately (not compacted) available space.*/
     free = (mfs_flash_get_bank_offset(mfsp, mfsp->current_bank) +
             mfsp->config->bank_size) - mfsp->next_offset;
@@ -1205,6 +1891,10 @@ mfs_error_t mfsEraseRecord(MFSDriver *mfsp, mfs_id_t id) {
     mfsp->descriptors[id - 1U].offset = 0U;
     mfsp->descriptors[id - 1U].size   = 0U;
 
+#if MFS_CFG_USE_CHECKPOINTS == TRUE
+    RET_ON_ERROR(mfs_checkpoint_count(mfsp));
+#endif
+
     return warning ? MFS_WARN_GC : MFS_NO_ERROR;
   }
 
@@ -1287,6 +1977,122 @@ mfs_error_t mfsPerformGarbageCollection(MFSDriver *mfsp) {
   return mfs_garbage_collect(mfsp);
 }
 
+#if (MFS_CFG_USE_INCREMENTAL_GC == TRUE) || defined(__DOXYGEN__)
+/**
+ * @brief   Performs an incremental garbage collection step.
+ * @details A garbage collection cycle is started when the free space in
+ *          the current bank falls below the @p MFS_CFG_GC_THRESHOLD
+ *          percentage of the bank size and there is space to be reclaimed.
+ *          Each call performs at most @p n elementary operations, an
+ *          elementary operation is the copy of a single record or the
+ *          erase of a single sector.
+ * @note    This function is meant to be called periodically, for example
+ *          from a low priority thread, so that write operations do not
+ *          need to perform a full garbage collection. Calls must be
+ *          serialized with the other driver functions.
+ * @note    Records written or erased while a cycle is in progress are
+ *          handled when the copy phase is finalized, if an operation does
+ *          not fit in the available space then the cycle is completed by
+ *          the operation itself.
+ *
+ * @param[in] mfsp      pointer to the @p MFSDriver object
+ * @param[in] n         maximum number of elementary operations
+ * @return              The operation status.
+ * @retval MFS_NO_ERROR             if there is no garbage collection cycle
+ *                                  in progress.
+ * @retval MFS_WARN_GC_PENDING      if the garbage collection cycle requires
+ *                                  more steps to be completed.
+ * @retval MFS_ERR_INV_STATE        if the driver is in not in @p MFS_READY
+ *                                  state.
+ * @retval MFS_ERR_FLASH_FAILURE    if the flash memory is unusable because HW
+ *                                  failures. Makes the driver enter the
+ *                                  @p MFS_ERROR state.
+ *
+ * @api
+ */
+mfs_error_t mfsPerformGarbageCollectionStep(MFSDriver *mfsp, unsigned n) {
+
+  osalDbgCheck((mfsp != NULL) && (n > 0U));
+
+  if (mfsp->state != MFS_READY) {
+    return MFS_ERR_INV_STATE;
+  }
+
+  if (mfsp->gc_state == MFS_GC_IDLE) {
+    flash_offset_t bank_offset, free;
+
+    bank_offset = mfs_flash_get_bank_offset(mfsp, mfsp->current_bank);
+    free = (bank_offset + mfsp->config->bank_size) - mfsp->next_offset;
+
+    /* Starting a new cycle only if the free space is below the threshold
+       and there is something to reclaim.*/
+    if ((free >= (mfsp->config->bank_size / 100U) *
+                 (flash_offset_t)MFS_CFG_GC_THRESHOLD) ||
+        (mfsp->next_offset - bank_offset <= mfsp->used_space)) {
+      return MFS_NO_ERROR;
+    }
+
+    mfs_gc_start(mfsp);
+#if MFS_CFG_USE_CHECKPOINTS == TRUE
+    /* The previous checkpoint could state the other bank as erased, it is
+       superseded before writing in it.*/
+    RET_ON_ERROR(mfs_checkpoint_write(mfsp, false));
+#endif
+  }
+
+  while ((n > 0U) && (mfsp->gc_state != MFS_GC_IDLE)) {
+    RET_ON_ERROR(mfs_gc_step(mfsp));
+    n--;
+  }
+
+  return mfsp->gc_state != MFS_GC_IDLE ? MFS_WARN_GC_PENDING : MFS_NO_ERROR;
+}
+#endif /* MFS_CFG_USE_INCREMENTAL_GC == TRUE */
+
+#if (MFS_CFG_USE_CHECKPOINTS == TRUE) || defined(__DOXYGEN__)
+/**
+ * @brief   Writes a checkpoint of the records index.
+ * @details On mount the records index is loaded from the most recent valid
+ *          checkpoint and only the records written after it are scanned.
+ * @note    Checkpoints are also written automatically after each garbage
+ *          collection and every @p MFS_CFG_CHECKPOINT_INTERVAL write or
+ *          erase operations.
+ * @note    If an incremental garbage collection cycle is in the copy phase
+ *          then the cycle is completed, the checkpoint is written when the
+ *          copy phase is finalized.
+ *
+ * @param[in] mfsp      pointer to the @p MFSDriver object
+ * @return              The operation status.
+ * @retval MFS_NO_ERROR             if the operation has been successfully
+ *                                  completed.
+ * @retval MFS_ERR_INV_STATE        if the driver is in not in @p MFS_READY
+ *                                  state.
+ * @retval MFS_ERR_FLASH_FAILURE    if the flash memory is unusable because HW
+ *                                  failures. Makes the driver enter the
+ *                                  @p MFS_ERROR state.
+ *
+ * @api
+ */
+mfs_error_t mfsWriteCheckpoint(MFSDriver *mfsp) {
+
+  osalDbgCheck(mfsp != NULL);
+
+  if (mfsp->state != MFS_READY) {
+    return MFS_ERR_INV_STATE;
+  }
+
+#if MFS_CFG_USE_INCREMENTAL_GC == TRUE
+  if (mfsp->gc_state == MFS_GC_COPY) {
+    return mfs_gc_complete(mfsp);
+  }
+
+  return mfs_checkpoint_write(mfsp, mfsp->gc_state == MFS_GC_IDLE);
+#else
+  return mfs_checkpoint_write(mfsp, true);
+#endif
+}
+#endif /* MFS_CFG_USE_CHECKPOINTS == TRUE */
+
 #if (MFS_CFG_TRANSACTION_MAX > 0) || defined(__DOXYGEN__)
 /**
  * @brief   Puts the driver in transaction mode.
@@ -1338,6 +2144,14 @@ mfs_error_t mfsStartTransaction(MFSDriver *mfsp, size_t size) {
     return MFS_ERR_OUT_OF_MEM;
   }
 
+#if MFS_CFG_USE_INCREMENTAL_GC == TRUE
+  {
+    bool warning = false;
+
+    RET_ON_ERROR(mfs_gc_reserve(mfsp, rspace, &warning));
+  }
+#endif
+
   /* Checking for immediately (not compacted) available space.*/
   free = (mfs_flash_get_bank_offset(mfsp, mfsp->current_bank) +
           mfsp->config->bank_size) - mfsp->next_offset;
@@ -1434,6 +2248,10 @@ mfs_error_t mfsCommitTransaction(MFSDriver *mfsp) {
   /* Returning to ready mode.*/
   mfsp->state = MFS_READY;
 
+#if MFS_CFG_USE_CHECKPOINTS == TRUE
+  RET_ON_ERROR(mfs_checkpoint_count(mfsp));
+#endif
+
   return MFS_NO_ERROR;
 }
 
@@ -38,6 +38,13 @@
 #define MFS_BANK_MAGIC_2                    0xF0339CC5U
 #define MFS_HEADER_MAGIC_1                  0x5FAE45F0U
 #define MFS_HEADER_MAGIC_2                  0xF045AE5FU
+#define MFS_CHECKPOINT_MAGIC_1              0x3C9A0E61U
+#define MFS_CHECKPOINT_MAGIC_2              0x61E09A3CU
+
+/**
+ * @brief   Checkpoint flag, the other bank was erased at checkpoint time.
+ */
+#define MFS_CHECKPOINT_FLAG_ERASED          0x01U
 
 /*===========================================================================*/
 /* Driver pre-compile time settings.                                         */
@@ -107,6 +114,48 @@
 #if !defined(MFS_CFG_TRANSACTION_MAX) || defined(__DOXYGEN__)
 #define MFS_CFG_TRANSACTION_MAX             16
 #endif
+
+/**
+ * @brief   Enables the records index checkpoints.
+ * @details When enabled the records index is periodically saved in a
+ *          dedicated flash area, on mount the bank is only scanned starting
+ *          from the position stored in the most recent valid checkpoint
+ *          instead of the bank start.
+ * @note    The checkpoints area is specified in the configuration structure,
+ *          it must not overlap the banks.
+ */
+#if !defined(MFS_CFG_USE_CHECKPOINTS) || defined(__DOXYGEN__)
+#define MFS_CFG_USE_CHECKPOINTS             FALSE
+#endif
+
+/**
+ * @brief   Number of write and erase operations between checkpoints.
+ * @note    Zero means that checkpoints are only written after a garbage
+ *          collection or on explicit request.
+ */
+#if !defined(MFS_CFG_CHECKPOINT_INTERVAL) || defined(__DOXYGEN__)
+#define MFS_CFG_CHECKPOINT_INTERVAL         16
+#endif
+
+/**
+ * @brief   Enables the incremental garbage collection.
+ * @details When enabled the garbage collection can be performed in steps
+ *          of bounded duration using @p mfsPerformGarbageCollectionStep(),
+ *          usually from a low priority thread.
+ */
+#if !defined(MFS_CFG_USE_INCREMENTAL_GC) || defined(__DOXYGEN__)
+#define MFS_CFG_USE_INCREMENTAL_GC          FALSE
+#endif
+
+/**
+ * @brief   Incremental garbage collection threshold.
+ * @details An incremental garbage collection cycle is started when the
+ *          free space in the current bank falls below this percentage of
+ *          the bank size.
+ */
+#if !defined(MFS_CFG_GC_THRESHOLD) || defined(__DOXYGEN__)
+#define MFS_CFG_GC_THRESHOLD                25
+#endif
 /** @} */
 
 /*===========================================================================*/
@@ -144,6 +193,14 @@
 #error "invalid MFS_CFG_TRANSACTION_MAX value"
 #endif
 
+#if MFS_CFG_CHECKPOINT_INTERVAL < 0
+#error "invalid MFS_CFG_CHECKPOINT_INTERVAL value"
+#endif
+
+#if (MFS_CFG_GC_THRESHOLD < 1) || (MFS_CFG_GC_THRESHOLD > 100)
+#error "invalid MFS_CFG_GC_THRESHOLD value"
+#endif
+
 /*===========================================================================*/
 /* Driver data structures and types.                                         */
 /*===========================================================================*/
@@ -176,6 +233,7 @@ typedef enum {
   MFS_NO_ERROR = 0,
   MFS_WARN_REPAIR = 1,
   MFS_WARN_GC = 2,
+  MFS_WARN_GC_PENDING = 3,
   MFS_ERR_INV_STATE = -1,
   MFS_ERR_INV_SIZE = -2,
   MFS_ERR_NOT_FOUND = -3,
@@ -196,6 +254,15 @@ typedef enum {
   MFS_BANK_GARBAGE = 2
 } mfs_bank_state_t;
 
+/**
+ * @brief   Type of an incremental garbage collection state.
+ */
+typedef enum {
+  MFS_GC_IDLE = 0,
+  MFS_GC_COPY = 1,
+  MFS_GC_ERASE = 2
+} mfs_gc_state_t;
+
 /**
  * @brief   Type of a record identifier.
  */
@@ -266,6 +333,46 @@ typedef union {
   uint32_t                  hdr32[4];
 } mfs_data_header_t;
 
+/**
+ * @brief   Type of a checkpoint header.
+ * @details This structure is placed before the records index saved in each
+ *          checkpoint slot.
+ */
+typedef union {
+  struct {
+    /**
+     * @brief   Checkpoint magic 1.
+     */
+    uint32_t                magic1;
+    /**
+     * @brief   Checkpoint magic 2.
+     */
+    uint32_t                magic2;
+    /**
+     * @brief   Usage counter of the bank the checkpoint refers to.
+     */
+    uint32_t                counter;
+    /**
+     * @brief   Next free position in the bank at checkpoint time.
+     */
+    uint32_t                next_offset;
+    /**
+     * @brief   Bank the checkpoint refers to.
+     */
+    uint8_t                 bank;
+    /**
+     * @brief   Checkpoint flags.
+     */
+    uint8_t                 flags;
+    /**
+     * @brief   Checkpoint CRC, it includes the records index.
+     */
+    uint16_t                crc;
+  } fields;
+  uint8_t                   hdr8[20];
+  uint32_t                  hdr32[5];
+} mfs_checkpoint_header_t;
+
 typedef struct {
   /**
    * @brief   Offset of the record header.
@@ -313,6 +420,18 @@ typedef struct {
    *          @p bank_size.
    */
   flash_sector_t            bank1_sectors;
+#if (MFS_CFG_USE_CHECKPOINTS == TRUE) || defined(__DOXYGEN__)
+  /**
+   * @brief   Base sector index for the checkpoints area.
+   */
+  flash_sector_t            checkpoint_start;
+  /**
+   * @brief   Number of sectors for the checkpoints area.
+   * @note    The area must be large enough to contain at least one
+   *          checkpoint, larger areas are erased less often.
+   */
+  flash_sector_t            checkpoint_sectors;
+#endif
 } MFSConfig;
 
 /**
@@ -383,6 +502,38 @@ typedef struct {
    * @brief   Buffered operations in current transaction.
    */
   mfs_transaction_op_t      tr_ops[MFS_CFG_TRANSACTION_MAX];
+#endif
+#if (MFS_CFG_USE_CHECKPOINTS == TRUE) || defined(__DOXYGEN__)
+  /**
+   * @brief   Next free checkpoint slot.
+   */
+  uint32_t                  cp_next;
+  /**
+   * @brief   Operations performed since the last checkpoint.
+   */
+  uint32_t                  cp_ops;
+#endif
+#if (MFS_CFG_USE_INCREMENTAL_GC == TRUE) || defined(__DOXYGEN__)
+  /**
+   * @brief   Incremental garbage collection state.
+   */
+  mfs_gc_state_t            gc_state;
+  /**
+   * @brief   Next record to be copied or next sector to be erased.
+   */
+  uint32_t                  gc_index;
+  /**
+   * @brief   Next write offset in the destination bank.
+   */
+  flash_offset_t            gc_offset;
+  /**
+   * @brief   Worst case space required in the destination bank.
+   */
+  flash_offset_t            gc_space;
+  /**
+   * @brief   Records copied in the destination bank.
+   */
+  uint32_t                  gc_copied[(MFS_CFG_MAX_RECORDS + 31) / 32];
 #endif
   /**
    * @brief   Transient buffer.
@@ -436,6 +587,12 @@ extern "C" {
                              size_t n, const uint8_t *buffer);
   mfs_error_t mfsEraseRecord(MFSDriver *devp, mfs_id_t id);
   mfs_error_t mfsPerformGarbageCollection(MFSDriver *mfsp);
+#if MFS_CFG_USE_INCREMENTAL_GC == TRUE
+  mfs_error_t mfsPerformGarbageCollectionStep(MFSDriver *mfsp, unsigned n);
+#endif
+#if MFS_CFG_USE_CHECKPOINTS == TRUE
+  mfs_error_t mfsWriteCheckpoint(MFSDriver *mfsp);
+#endif
 #if MFS_CFG_TRANSACTION_MAX > 0
   mfs_error_t mfsStartTransaction(MFSDriver *mfsp, size_t size);
   mfs_error_t mfsCommitTransaction(MFSDriver *mfsp);
@@ -28,6 +28,8 @@
  * @{
  */
 
+#include <string.h>
+
 #include "hal.h"
 #include "chprintf.h"
 #include "memstreams.h"
@@ -35,6 +37,62 @@
 #define MAX_FILLER 11
 #define FLOAT_PRECISION 9
 
+/*
+ * Output context of chvprintf(), characters are accumulated in a local
+ * buffer and sent to the stream in blocks.
+ */
+typedef struct {
+  BaseSequentialStream  *chp;
+#if CHPRINTF_BUFFER_SIZE > 0
+  size_t                n;
+  uint8_t               buf[CHPRINTF_BUFFER_SIZE];
+#endif
+} out_t;
+
+static void out_flush(out_t *op) {
+
+#if CHPRINTF_BUFFER_SIZE > 0
+  if (op->n > 0U) {
+    (void) streamWrite(op->chp, op->buf, op->n);
+    op->n = 0U;
+  }
+#else
+  (void)op;
+#endif
+}
+
+static void out_put(out_t *op, char c) {
+
+#if CHPRINTF_BUFFER_SIZE > 0
+  op->buf[op->n++] = (uint8_t)c;
+  if (op->n >= (size_t)CHPRINTF_BUFFER_SIZE) {
+    out_flush(op);
+  }
+#else
+  (void) streamPut(op->chp, (uint8_t)c);
+#endif
+}
+
+static void out_write(out_t *op, const char *s, size_t size) {
+
+#if CHPRINTF_BUFFER_SIZE > 0
+  /* Small blocks are merged in the buffer, larger ones are written
+     directly to the stream.*/
+  if (size <= (size_t)CHPRINTF_BUFFER_SIZE - op->n) {
+    memcpy(&op->buf[op->n], s, size);
+    op->n += size;
+    return;
+  }
+  out_flush(op);
+  if (size < (size_t)CHPRINTF_BUFFER_SIZE) {
+    memcpy(op->buf, s, size);
+    op->n = size;
+    return;
+  }
+#endif
+  (void) streamWrite(op->chp, (const uint8_t *)s, size);
+}
+
 static char *long_to_string_with_divisor(char *p,
                                          long num,
                                          unsigned radix,
@@ -100,6 +158,10 @@ static char *ftoa(char *p, double num, unsigned long precision) {
  * @brief   System formatted output function.
  * @details This function implements a minimal @p vprintf()-like functionality
  *          with output on a @p BaseSequentialStream.
+ *          The output is collected in a local buffer of
+ *          @p CHPRINTF_BUFFER_SIZE bytes and sent to the stream using its
+ *          @p write() method, plain text and strings are written as
+ *          whole blocks.
  *          The general parameters format is: %[-][width|*][.precision|*][l|L]p.
  *          The following parameter types (p) are supported:
  *          - <b>x</b> hexadecimal integer.
@@ -123,6 +185,7 @@ static char *ftoa(char *p, double num, unsigned long precision) {
  * @api
  */
 int chvprintf(BaseSequentialStream *chp, const char *fmt, va_list ap) {
+  out_t out;
   char *p, *s, c, filler;
   int i, precision, width;
   int n = 0;
@@ -135,15 +198,25 @@ int chvprintf(BaseSequentialStream *chp, const char *fmt, va_list ap) {
   char tmpbuf[MAX_FILLER + 1];
 #endif
 
+  out.chp = chp;
+#if CHPRINTF_BUFFER_SIZE > 0
+  out.n   = 0U;
+#endif
+
   while (true) {
     c = *fmt++;
     if (c == 0) {
-      return n;
+      break;
     }
     
     if (c != '%') {
-      streamPut(chp, (uint8_t)c);
-      n++;
+      /* Plain text up to the next specifier or the end.*/
+      s = (char *)fmt - 1;
+      while ((*fmt != '%') && (*fmt != 0)) {
+        fmt++;
+      }
+      out_write(&out, s, (size_t)(fmt - s));
+      n += (int)(fmt - s);
       continue;
     }
     
@@ -180,7 +253,7 @@ int chvprintf(BaseSequentialStream *chp, const char *fmt, va_list ap) {
       while (true) {
         c = *fmt++;
         if (c == 0) {
-          return n;
+          goto end;
         }
         if (c >= '0' && c <= '9') {
           c -= '0';
@@ -197,7 +270,7 @@ int chvprintf(BaseSequentialStream *chp, const char *fmt, va_list ap) {
     if (c == '.') {
       c = *fmt++;
       if (c == 0) {
-        return n;
+        goto end;
       }
       if (c == '*') {
         precision = va_arg(ap, int);
@@ -209,7 +282,7 @@ int chvprintf(BaseSequentialStream *chp, const char *fmt, va_list ap) {
           precision = precision * 10 + c;
           c = *fmt++;
           if (c == 0) {
-            return n;
+            goto end;
           }
         }
       }
@@ -220,7 +293,7 @@ int chvprintf(BaseSequentialStream *chp, const char *fmt, va_list ap) {
       is_long = true;
       c = *fmt++;
       if (c == 0) {
-        return n;
+        goto end;
       }
     }
     else {
@@ -312,26 +385,31 @@ unsigned_common:
     }
     if (width < 0) {
       if (*s == '-' && filler == '0') {
-        streamPut(chp, (uint8_t)*s++);
+        out_put(&out, *s++);
         n++;
         i--;
       }
       do {
-        streamPut(chp, (uint8_t)filler);
+        out_put(&out, filler);
         n++;
       } while (++width != 0);
     }
-    while (--i >= 0) {
-      streamPut(chp, (uint8_t)*s++);
-      n++;
+    if (i > 0) {
+      out_write(&out, s, (size_t)i);
+      n += i;
     }
 
     while (width) {
-      streamPut(chp, (uint8_t)filler);
+      out_put(&out, filler);
       n++;
       width--;
     }
   }
+
+end:
+  out_flush(&out);
+
+  return n;
 }
 
 /**
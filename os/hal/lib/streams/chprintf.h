@@ -34,6 +34,16 @@
 #define CHPRINTF_USE_FLOAT          FALSE
 #endif
 
+/**
+ * @brief   Size of the output buffer allocated on the stack by
+ *          @p chvprintf().
+ * @note    Setting this option to zero disables buffering, characters are
+ *          sent to the stream one at time.
+ */
+#if !defined(CHPRINTF_BUFFER_SIZE) || defined(__DOXYGEN__)
+#define CHPRINTF_BUFFER_SIZE        32
+#endif
+
 #ifdef __cplusplus
 extern "C" {
 #endif
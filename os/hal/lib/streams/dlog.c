@@ -0,0 +1,377 @@
+/*
+    ChibiOS - Copyright (C) 2006..2018 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+/**
+ * @file    dlog.c
+ * @brief   Deferred logging code.
+ *
+ * @addtogroup HAL_DLOG
+ * @{
+ */
+
+#include <string.h>
+
+#include "hal.h"
+#include "dlog.h"
+
+/*===========================================================================*/
+/* Driver local definitions.                                                 */
+/*===========================================================================*/
+
+/*
+ * Maximum length of a conversion specification.
+ */
+#define DLOG_SPEC_SIZE      16U
+
+/*
+ * Ordered accesses, records are committed by writing the sequence number
+ * after all the other fields and released by advancing the tail after
+ * having been copied.
+ */
+#if DLOG_USE_ATOMICS == TRUE
+#define DLOG_LOAD_ACQUIRE(p)        __atomic_load_n(p, __ATOMIC_ACQUIRE)
+#define DLOG_STORE_RELEASE(p, v)    __atomic_store_n(p, v, __ATOMIC_RELEASE)
+#else /* DLOG_USE_ATOMICS == FALSE */
+#if defined(__GNUC__) || defined(__DOXYGEN__)
+#define DLOG_BARRIER()   __asm volatile ("" : : : "memory")
+#else
+#define DLOG_BARRIER()   do {                                               \
+  syssts_t sts = osalSysGetStatusAndLockX();                                \
+  osalSysRestoreStatusX(sts);                                               \
+} while (false)
+#endif
+#define DLOG_LOAD_ACQUIRE(p)        dlog_load_acquire(p)
+#define DLOG_STORE_RELEASE(p, v)    do {                                    \
+  DLOG_BARRIER();                                                           \
+  *(p) = (v);                                                               \
+} while (false)
+#endif /* DLOG_USE_ATOMICS == FALSE */
+
+/*===========================================================================*/
+/* Driver exported variables.                                                */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Driver local variables.                                                   */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Driver local functions.                                                   */
+/*===========================================================================*/
+
+#if (DLOG_USE_ATOMICS == FALSE) || defined(__DOXYGEN__)
+static inline uint32_t dlog_load_acquire(const volatile uint32_t *p) {
+  uint32_t x = *p;
+
+  DLOG_BARRIER();
+
+  return x;
+}
+#endif
+
+/*===========================================================================*/
+/* Driver exported functions.                                                */
+/*===========================================================================*/
+
+/**
+ * @brief   Deferred log object initialization.
+ *
+ * @param[out] dlp      pointer to the @p deferred_log_t object to be
+ *                      initialized
+ * @param[in] buf       pointer to the records buffer
+ * @param[in] n         number of records in the buffer, it must be a
+ *                      power of two
+ *
+ * @init
+ */
+void dlogObjectInit(deferred_log_t *dlp, dlog_record_t *buf, size_t n) {
+  size_t i;
+
+  osalDbgCheck((dlp != NULL) && (buf != NULL) &&
+               (n > 0U) && ((n & (n - 1U)) == 0U));
+
+  for (i = 0U; i < n; i++) {
+    buf[i].seq = 0U;
+  }
+  dlp->buffer  = buf;
+  dlp->size    = (uint32_t)n;
+  dlp->head    = 0U;
+  dlp->tail    = 0U;
+  dlp->dropped = 0U;
+}
+
+/**
+ * @brief   Writes a log record.
+ * @details The record slot is reserved using a compare and swap loop, or
+ *          inside a short critical zone if @p DLOG_USE_ATOMICS is disabled,
+ *          the record is then filled and committed. If the log is full
+ *          then the record is discarded and the dropped records counter
+ *          is incremented, the function never waits.
+ * @note    This function is normally invoked through the @p dlogPrintf()
+ *          macro.
+ *
+ * @param[in] dlp       pointer to a @p deferred_log_t object
+ * @param[in] fmt       format string
+ * @param[in] argc      number of valid arguments
+ * @param[in] a1        first argument
+ * @param[in] a2        second argument
+ * @param[in] a3        third argument
+ * @param[in] a4        fourth argument
+ *
+ * @xclass
+ */
+void dlogWriteX(deferred_log_t *dlp, const char *fmt, unsigned argc,
+                dlogarg_t a1, dlogarg_t a2, dlogarg_t a3, dlogarg_t a4) {
+  dlog_record_t *rp;
+  uint32_t idx;
+
+#if DLOG_USE_ATOMICS == TRUE
+  idx = __atomic_load_n(&dlp->head, __ATOMIC_RELAXED);
+  do {
+    /* A negative distance means that the head index is stale, the
+       exchange is going to fail and reload it.*/
+    int32_t used = (int32_t)(idx - DLOG_LOAD_ACQUIRE(&dlp->tail));
+
+    if (used >= (int32_t)dlp->size) {
+      (void) __atomic_fetch_add(&dlp->dropped, 1U, __ATOMIC_RELAXED);
+      return;
+    }
+  } while (!__atomic_compare_exchange_n(&dlp->head, &idx, idx + 1U, true,
+                                        __ATOMIC_RELAXED, __ATOMIC_RELAXED));
+#else
+  syssts_t sts;
+
+  sts = osalSysGetStatusAndLockX();
+  idx = dlp->head;
+  if (idx - dlp->tail >= dlp->size) {
+    dlp->dropped++;
+    osalSysRestoreStatusX(sts);
+    return;
+  }
+  dlp->head = idx + 1U;
+  osalSysRestoreStatusX(sts);
+#endif
+
+  rp = &dlp->buffer[idx & (dlp->size - 1U)];
+  rp->argc    = (uint32_t)argc;
+  rp->time    = osalOsGetSystemTimeX();
+  rp->fmt     = fmt;
+  rp->args[0] = a1;
+  rp->args[1] = a2;
+  rp->args[2] = a3;
+  rp->args[3] = a4;
+  DLOG_STORE_RELEASE(&rp->seq, idx + 1U);
+}
+
+/**
+ * @brief   Fetches the oldest log record.
+ * @note    Records are fetched in order, a record reserved but not yet
+ *          committed by a preempted writer stops the fetching until it
+ *          is completed.
+ * @note    There must be a single reader.
+ *
+ * @param[in] dlp       pointer to a @p deferred_log_t object
+ * @param[out] rp       pointer to the record to be filled
+ * @return              The operation status.
+ * @retval false        if there are no records available.
+ * @retval true         if a record has been fetched.
+ *
+ * @api
+ */
+bool dlogFetch(deferred_log_t *dlp, dlog_record_t *rp) {
+  const dlog_record_t *srcp;
+  uint32_t idx = dlp->tail;
+
+  srcp = &dlp->buffer[idx & (dlp->size - 1U)];
+  if (DLOG_LOAD_ACQUIRE(&srcp->seq) != idx + 1U) {
+    return false;
+  }
+  *rp = *srcp;
+  DLOG_STORE_RELEASE(&dlp->tail, idx + 1U);
+
+  return true;
+}
+
+/**
+ * @brief   Formats a log record.
+ * @details The record is formatted using @p chprintf(), each conversion
+ *          is formatted separately after converting the stored argument
+ *          to the type expected by the conversion. The time stamp is not
+ *          printed.
+ * @note    Unsupported conversions and missing arguments are asserted,
+ *          see @p dlogarg_t.
+ *
+ * @param[in] chp       pointer to a @p BaseSequentialStream implementing object
+ * @param[in] rp        pointer to the record
+ * @return              The number of bytes written.
+ *
+ * @api
+ */
+int dlogFormat(BaseSequentialStream *chp, const dlog_record_t *rp) {
+  const char *fmt = rp->fmt;
+  char spec[DLOG_SPEC_SIZE];
+  unsigned argi = 0U;
+  int n = 0;
+
+  while (*fmt != '\0') {
+    const char *s = fmt;
+    dlogarg_t arg;
+    bool is_long;
+    size_t len;
+    char c;
+
+    /* Plain text up to the next specifier or the end.*/
+    if (*fmt != '%') {
+      while ((*fmt != '%') && (*fmt != '\0')) {
+        fmt++;
+      }
+      len = (size_t)(fmt - s);
+      (void) streamWrite(chp, (const uint8_t *)s, len);
+      n += (int)len;
+      continue;
+    }
+
+    /* Flags, width, precision and long modifier, they are interpreted
+       by chprintf().*/
+    fmt++;
+    while ((*fmt == '-') || (*fmt == '+') || (*fmt == '.') ||
+           ((*fmt >= '0') && (*fmt <= '9'))) {
+      fmt++;
+    }
+    is_long = false;
+    if ((*fmt == 'l') || (*fmt == 'L')) {
+      is_long = true;
+      fmt++;
+    }
+    c = *fmt;
+    if (c == '\0') {
+      break;
+    }
+    fmt++;
+    if ((c >= 'A') && (c <= 'Z')) {
+      is_long = true;
+    }
+
+    len = (size_t)(fmt - s);
+    osalDbgAssert(len < DLOG_SPEC_SIZE, "specification too long");
+    if (len >= DLOG_SPEC_SIZE) {
+      continue;
+    }
+    memcpy(spec, s, len);
+    spec[len] = '\0';
+
+    /* Conversions without arguments.*/
+    if (c == '%') {
+      n += chprintf(chp, spec);
+      continue;
+    }
+
+    /* Fetching the argument.*/
+    osalDbgAssert(argi < rp->argc, "missing argument");
+    arg = argi < rp->argc ? rp->args[argi] : (dlogarg_t)0;
+    argi++;
+
+    switch (c) {
+    case 'c':
+      n += chprintf(chp, spec, (int)arg);
+      break;
+    case 's':
+      n += chprintf(chp, spec, (const char *)arg);
+      break;
+    case 'D':
+    case 'd':
+    case 'I':
+    case 'i':
+      if (is_long) {
+        n += chprintf(chp, spec, (long)(intptr_t)arg);
+      }
+      else {
+        n += chprintf(chp, spec, (int)(intptr_t)arg);
+      }
+      break;
+    case 'X':
+    case 'x':
+    case 'U':
+    case 'u':
+    case 'O':
+    case 'o':
+      if (is_long) {
+        n += chprintf(chp, spec, (unsigned long)arg);
+      }
+      else {
+        n += chprintf(chp, spec, (unsigned)arg);
+      }
+      break;
+    default:
+      /* Floating point, "*" arguments and unknown conversions.*/
+      osalDbgAssert(false, "unsupported conversion");
+      (void) streamWrite(chp, (const uint8_t *)spec, len);
+      n += (int)len;
+      break;
+    }
+  }
+
+  return n;
+}
+
+/**
+ * @brief   Formats all the pending log records.
+ * @details This function is meant to be invoked periodically by a low
+ *          priority thread.
+ *
+ * @param[in] dlp       pointer to a @p deferred_log_t object
+ * @param[in] chp       pointer to a @p BaseSequentialStream implementing object
+ * @return              The number of records formatted.
+ *
+ * @api
+ */
+size_t dlogDrain(deferred_log_t *dlp, BaseSequentialStream *chp) {
+  dlog_record_t r;
+  size_t n = 0U;
+
+  while (dlogFetch(dlp, &r)) {
+    (void) dlogFormat(chp, &r);
+    n++;
+  }
+
+  return n;
+}
+
+/**
+ * @brief   Exports all the pending log records in binary form.
+ * @details Records are written as they are in memory, formatting is left
+ *          to the host. Gaps in the sequence numbers are not possible,
+ *          lost records are only accounted in the dropped counter.
+ *
+ * @param[in] dlp       pointer to a @p deferred_log_t object
+ * @param[in] chp       pointer to a @p BaseSequentialStream implementing object
+ * @return              The number of records exported.
+ *
+ * @api
+ */
+size_t dlogDrainBinary(deferred_log_t *dlp, BaseSequentialStream *chp) {
+  dlog_record_t r;
+  size_t n = 0U;
+
+  while (dlogFetch(dlp, &r)) {
+    (void) streamWrite(chp, (const uint8_t *)&r, sizeof (dlog_record_t));
+    n++;
+  }
+
+  return n;
+}
+
+/** @} */
@@ -0,0 +1,213 @@
+/*
+    ChibiOS - Copyright (C) 2006..2018 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+/**
+ * @file    dlog.h
+ * @brief   Deferred logging header.
+ *
+ * @addtogroup HAL_DLOG
+ * @details Deferred logging, the caller only records the format string
+ *          pointer, a time stamp and the raw arguments into a ring of
+ *          fixed size records. Formatting is performed later by a low
+ *          priority thread using @p dlogDrain() or on the host, using
+ *          the dlog2txt.py script, after exporting the raw records using
+ *          @p dlogDrainBinary().
+ * @{
+ */
+
+#ifndef DLOG_H
+#define DLOG_H
+
+#include "chprintf.h"
+
+/*===========================================================================*/
+/* Driver constants.                                                         */
+/*===========================================================================*/
+
+/**
+ * @brief   Maximum number of arguments in a log record.
+ */
+#define DLOG_MAX_ARGS               4U
+
+/*===========================================================================*/
+/* Driver pre-compile time settings.                                         */
+/*===========================================================================*/
+
+/**
+ * @brief   Lock-free records reservation.
+ * @details If enabled then records are reserved using a compare and swap
+ *          loop, else a short critical zone is used. By default it is
+ *          enabled if the compiler provides native atomic operations on
+ *          32 bits words.
+ */
+#if !defined(DLOG_USE_ATOMICS) || defined(__DOXYGEN__)
+#if (defined(__GCC_ATOMIC_INT_LOCK_FREE) &&                                 \
+     (__GCC_ATOMIC_INT_LOCK_FREE == 2) &&                                   \
+     defined(__GCC_ATOMIC_LONG_LOCK_FREE) &&                                \
+     (__GCC_ATOMIC_LONG_LOCK_FREE == 2)) || defined(__DOXYGEN__)
+#define DLOG_USE_ATOMICS            TRUE
+#else
+#define DLOG_USE_ATOMICS            FALSE
+#endif
+#endif
+
+/*===========================================================================*/
+/* Derived constants and error checks.                                       */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Driver data structures and types.                                         */
+/*===========================================================================*/
+
+/**
+ * @brief   Type of a log argument.
+ * @note    Arguments are stored as native words, the type is recovered
+ *          from the format, only the @p c, @p s, @p d, @p i, @p u, @p x
+ *          and @p o conversions, also in the long forms, are supported.
+ *          Floating point and @p * arguments are not supported. Strings
+ *          must not be modified until the record has been formatted.
+ */
+typedef uintptr_t dlogarg_t;
+
+/**
+ * @brief   Type of a log record.
+ * @note    The binary export writes records as they are in memory, the
+ *          host is expected to resolve the format strings from the
+ *          application image.
+ */
+typedef struct {
+  /**
+   * @brief   Sequence number, it is the record index plus one once the
+   *          record has been completely written.
+   */
+  volatile uint32_t         seq;
+  /**
+   * @brief   Number of arguments.
+   */
+  uint32_t                  argc;
+  /**
+   * @brief   System time of the record.
+   */
+  systime_t                 time;
+  /**
+   * @brief   Format string.
+   */
+  const char                *fmt;
+  /**
+   * @brief   Arguments.
+   */
+  dlogarg_t                 args[DLOG_MAX_ARGS];
+} dlog_record_t;
+
+/**
+ * @brief   Type of a deferred log object.
+ */
+typedef struct {
+  /**
+   * @brief   Pointer to the records buffer.
+   */
+  dlog_record_t             *buffer;
+  /**
+   * @brief   Number of records in the buffer, it is a power of two.
+   */
+  uint32_t                  size;
+  /**
+   * @brief   Index of the next record to be reserved.
+   */
+  volatile uint32_t         head;
+  /**
+   * @brief   Index of the next record to be fetched.
+   */
+  volatile uint32_t         tail;
+  /**
+   * @brief   Number of records lost because the buffer was full.
+   */
+  volatile uint32_t         dropped;
+} deferred_log_t;
+
+/*===========================================================================*/
+/* Driver macros.                                                            */
+/*===========================================================================*/
+
+/**
+ * @name    Arguments count dispatching
+ * @{
+ */
+#define __dlog_select(_0, _1, _2, _3, _4, name, ...) name
+#define __dlog0(dlp, fmt)                                                   \
+  dlogWriteX(dlp, fmt, 0U, 0U, 0U, 0U, 0U)
+#define __dlog1(dlp, fmt, a1)                                               \
+  dlogWriteX(dlp, fmt, 1U, (dlogarg_t)(a1), 0U, 0U, 0U)
+#define __dlog2(dlp, fmt, a1, a2)                                           \
+  dlogWriteX(dlp, fmt, 2U, (dlogarg_t)(a1), (dlogarg_t)(a2), 0U, 0U)
+#define __dlog3(dlp, fmt, a1, a2, a3)                                       \
+  dlogWriteX(dlp, fmt, 3U, (dlogarg_t)(a1), (dlogarg_t)(a2),                \
+             (dlogarg_t)(a3), 0U)
+#define __dlog4(dlp, fmt, a1, a2, a3, a4)                                   \
+  dlogWriteX(dlp, fmt, 4U, (dlogarg_t)(a1), (dlogarg_t)(a2),                \
+             (dlogarg_t)(a3), (dlogarg_t)(a4))
+/** @} */
+
+/**
+ * @brief   Records a log entry.
+ * @details The format string and up to @p DLOG_MAX_ARGS arguments are
+ *          stored in the log, the format uses the same syntax of
+ *          @p chprintf().
+ *
+ * @param[in] dlp       pointer to a @p deferred_log_t object
+ * @param[in] ...       format string followed by the arguments
+ *
+ * @xclass
+ */
+#define dlogPrintf(dlp, ...)                                                \
+  __dlog_select(__VA_ARGS__, __dlog4, __dlog3, __dlog2, __dlog1,            \
+                __dlog0, __dlog_none)(dlp, __VA_ARGS__)
+
+/**
+ * @brief   Returns the number of records lost because the log was full.
+ *
+ * @param[in] dlp       pointer to a @p deferred_log_t object
+ * @return              The number of lost records.
+ *
+ * @xclass
+ */
+#define dlogGetDroppedX(dlp) ((dlp)->dropped)
+
+/*===========================================================================*/
+/* External declarations.                                                    */
+/*===========================================================================*/
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+  void dlogObjectInit(deferred_log_t *dlp, dlog_record_t *buf, size_t n);
+  void dlogWriteX(deferred_log_t *dlp, const char *fmt, unsigned argc,
+                  dlogarg_t a1, dlogarg_t a2, dlogarg_t a3, dlogarg_t a4);
+  bool dlogFetch(deferred_log_t *dlp, dlog_record_t *rp);
+  int dlogFormat(BaseSequentialStream *chp, const dlog_record_t *rp);
+  size_t dlogDrain(deferred_log_t *dlp, BaseSequentialStream *chp);
+  size_t dlogDrainBinary(deferred_log_t *dlp, BaseSequentialStream *chp);
+#ifdef __cplusplus
+}
+#endif
+
+/*===========================================================================*/
+/* Driver inline functions.                                                  */
+/*===========================================================================*/
+
+#endif /* DLOG_H */
+
+/** @} */
@@ -0,0 +1,195 @@
+#!/usr/bin/env python3
+#
+#    ChibiOS - Copyright (C) 2006..2018 Giovanni Di Sirio
+#
+#    Licensed under the Apache License, Version 2.0 (the "License");
+#    you may not use this file except in compliance with the License.
+#    You may obtain a copy of the License at
+#
+#        http://www.apache.org/licenses/LICENSE-2.0
+#
+#    Unless required by applicable law or agreed to in writing, software
+#    distributed under the License is distributed on an "AS IS" BASIS,
+#    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+#    See the License for the specific language governing permissions and
+#    limitations under the License.
+#
+
+"""Formats the deferred log records exported by dlogDrainBinary().
+
+The records contain the addresses of the format strings and of the string
+arguments, they are resolved from the ELF image of the application. The
+output is the same produced by dlogFormat() on the target.
+
+Usage: dlog2txt.py [-o output.txt] [--time-size N] [--time] image.elf input.bin
+"""
+
+import argparse
+import re
+import struct
+import sys
+
+MAX_ARGS = 4
+
+SPEC = re.compile(r"%(-?)(\+?)(0?)(\d*)(?:\.(\d*))?([lL]?)(.?)", re.S)
+
+
+class Image:
+    """Read-only view of the loadable sections of an ELF file."""
+
+    def __init__(self, data):
+        if data[:4] != b"\x7fELF":
+            raise ValueError("not an ELF file")
+        self.data = data
+        self.psize = {1: 4, 2: 8}[data[4]]
+        self.endian = {1: "<", 2: ">"}[data[5]]
+        if self.psize == 4:
+            shoff, = self.unpack("I", 0x20)
+            shentsize, shnum = self.unpack("HH", 0x2E)
+            shfmt = "IIIIII"
+        else:
+            shoff, = self.unpack("Q", 0x28)
+            shentsize, shnum = self.unpack("HH", 0x3A)
+            shfmt = "IIQQQQ"
+        self.sections = []
+        for i in range(shnum):
+            _, stype, _, addr, offset, size = self.unpack(
+                shfmt, shoff + i * shentsize)
+            # Skipping non-allocated and NOBITS sections.
+            if addr != 0 and stype != 8:
+                self.sections.append((addr, offset, size))
+
+    def unpack(self, fmt, offset):
+        return struct.unpack_from(self.endian + fmt, self.data, offset)
+
+    def string(self, addr):
+        if addr == 0:
+            return "(null)"
+        for start, offset, size in self.sections:
+            if start <= addr < start + size:
+                pos = offset + addr - start
+                end = self.data.index(b"\0", pos)
+                return self.data[pos:end].decode("ascii", "replace")
+        raise ValueError("address 0x%x not in the image" % addr)
+
+
+def record_layout(psize, tsize, endian):
+    """Returns the struct format of a dlog_record_t, natural alignment."""
+    fields = [("I", 4), ("I", 4), ({2: "H", 4: "I", 8: "Q"}[tsize], tsize),
+              ({4: "I", 8: "Q"}[psize], psize)] + \
+        [({4: "I", 8: "Q"}[psize], psize)] * MAX_ARGS
+    fmt, pos = endian, 0
+    for code, size in fields:
+        pad = -pos % size
+        fmt += "x" * pad + code
+        pos += pad + size
+    fmt += "x" * (-pos % max(4, psize, tsize))
+    return fmt
+
+
+def signed(x, bits):
+    x &= (1 << bits) - 1
+    return x - (1 << bits) if x >> (bits - 1) else x
+
+
+def format_record(image, fmt, args, isize):
+    """Formats a record following the chprintf() rules."""
+    out = []
+    argi = 0
+    pos = 0
+    lbits = image.psize * 8
+    while pos < len(fmt):
+        if fmt[pos] != "%":
+            end = fmt.find("%", pos)
+            end = len(fmt) if end < 0 else end
+            out.append(fmt[pos:end])
+            pos = end
+            continue
+        m = SPEC.match(fmt, pos)
+        pos = m.end()
+        left, sign, zero, width, prec, lmod, c = m.groups()
+        if c == "":
+            break
+        filler = "0" if zero else " "
+        width = int(width or 0)
+        prec = int(prec or 0)
+        is_long = bool(lmod) or c.isupper()
+        if c == "%":
+            text = "%"
+        else:
+            arg = args[argi] if argi < len(args) else 0
+            argi += 1
+            if c == "c":
+                filler = " "
+                text = chr(arg & 0xFF)
+            elif c == "s":
+                filler = " "
+                text = image.string(arg)
+                if prec:
+                    text = text[:prec]
+            elif c in "dDiI":
+                v = signed(arg, lbits if is_long else isize * 8)
+                text = ("-" if v < 0 else "+" if sign else "") + str(abs(v))
+            elif c in "xXuUoO":
+                v = arg & ((1 << (lbits if is_long else isize * 8)) - 1)
+                text = {"x": "%X", "u": "%d", "o": "%o"}[c.lower()] % v
+            else:
+                raise ValueError("unsupported conversion %r" % m.group(0))
+        pad = max(0, width - len(text))
+        if left:
+            text = text + filler * pad
+        elif filler == "0" and text.startswith("-"):
+            text = "-" + filler * pad + text[1:]
+        else:
+            text = filler * pad + text
+        out.append(text)
+    return "".join(out)
+
+
+def decode(image, data, tsize, isize, show_time):
+    layout = record_layout(image.psize, tsize, image.endian)
+    size = struct.calcsize(layout)
+    lines = []
+    expected = None
+    for offset in range(0, len(data) - size + 1, size):
+        seq, argc, time, fmtp, *args = struct.unpack_from(layout, data,
+                                                          offset)
+        if expected is not None and seq != expected:
+            sys.stderr.write("warning: sequence gap %u..%u\n" %
+                             (expected, seq - 1))
+        expected = seq + 1
+        text = format_record(image, image.string(fmtp), args[:argc], isize)
+        lines.append(("[%u] " % time if show_time else "") + text)
+    if len(data) % size:
+        sys.stderr.write("warning: truncated record\n")
+    return "".join(lines)
+
+
+def main():
+    ap = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    ap.add_argument("image", help="ELF image of the application")
+    ap.add_argument("input", help="binary records")
+    ap.add_argument("-o", "--output", help="output file, default stdout")
+    ap.add_argument("--time-size", type=int, default=4, choices=(2, 4, 8),
+                    help="size of systime_t in bytes, default 4")
+    ap.add_argument("--int-size", type=int, default=4, choices=(2, 4),
+                    help="size of int in bytes, default 4")
+    ap.add_argument("--time", action="store_true",
+                    help="prefix the records with the time stamp")
+    args = ap.parse_args()
+
+    with open(args.image, "rb") as f:
+        image = Image(f.read())
+    with open(args.input, "rb") as f:
+        text = decode(image, f.read(), args.time_size, args.int_size,
+                      args.time)
+
+    if args.output:
+        with open(args.output, "w", newline="") as f:
+            f.write(text)
+    else:
+        sys.stdout.write(text)
+
+
+if __name__ == "__main__":
+    main()
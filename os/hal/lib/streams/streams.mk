@@ -1,7 +1,8 @@
 # RT Shell files.
 STREAMSSRC = $(CHIBIOS)/os/hal/lib/streams/chprintf.c \
              $(CHIBIOS)/os/hal/lib/streams/memstreams.c \
-             $(CHIBIOS)/os/hal/lib/streams/nullstreams.c
+             $(CHIBIOS)/os/hal/lib/streams/nullstreams.c \
+             $(CHIBIOS)/os/hal/lib/streams/dlog.c
 
 STREAMSINC = $(CHIBIOS)/os/hal/lib/streams
 
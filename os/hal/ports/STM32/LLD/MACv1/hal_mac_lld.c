@@ -511,6 +511,11 @@ msg_t mac_lld_get_receive_descriptor(MACDriver *macp,
   /* Iterates through received frames until a valid one is found, invalid
      frames are discarded.*/
   while (!(rdes->rdes0 & STM32_RDES0_OWN)) {
+    /* A zero status marks a descriptor not yet released by the upper
+       layer, the DMA is stalled on it.*/
+    if (rdes->rdes0 == 0U) {
+      break;
+    }
     if (!(rdes->rdes0 & (STM32_RDES0_AFM | STM32_RDES0_ES))
 #if STM32_MAC_IP_CHECKSUM_OFFLOAD
         && (rdes->rdes0 & STM32_RDES0_FT)
@@ -523,6 +528,11 @@ msg_t mac_lld_get_receive_descriptor(MACDriver *macp,
       rdp->physdesc = rdes;
       macp->rxptr   = (stm32_eth_rx_descriptor_t *)rdes->rdes3;
 
+      /* Marking the descriptor as locked, it could be held for a long
+         time in zero-copy mode and must not be parsed again when the
+         ring wraps.*/
+      rdes->rdes0   = 0U;
+
       osalSysUnlock();
       return MSG_OK;
     }
@@ -0,0 +1,405 @@
+/*
+    ChibiOS - Copyright (C) 2006..2018 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+/**
+ * @file    hal_mac_lld.c
+ * @brief   Simulator low level MAC driver code.
+ *
+ * @addtogroup SIMULATOR_MAC
+ * @{
+ */
+
+#include <string.h>
+
+#include "hal.h"
+
+#if (HAL_USE_MAC == TRUE) || defined(__DOXYGEN__)
+
+/*===========================================================================*/
+/* Driver local definitions.                                                 */
+/*===========================================================================*/
+
+/**
+ * @name    Descriptor states
+ * @{
+ */
+#define SIM_MAC_FREE                0U  /**< Owned by the simulated MAC.    */
+#define SIM_MAC_READY               1U  /**< Frame received.                */
+#define SIM_MAC_LOCKED              2U  /**< Owned by a descriptor.         */
+/** @} */
+
+/*===========================================================================*/
+/* Driver exported variables.                                                */
+/*===========================================================================*/
+
+/**
+ * @brief   Ethernet driver 1.
+ */
+MACDriver ETHD1;
+
+/*===========================================================================*/
+/* Driver local variables and types.                                         */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Driver local functions.                                                   */
+/*===========================================================================*/
+
+/**
+ * @brief   Puts a frame on the simulated wire.
+ * @details The frame is copied into the next receive buffer, if the buffer
+ *          has not yet been released then the frame is lost.
+ *
+ * @param[in] macp      pointer to the @p MACDriver object
+ * @param[in] bp        pointer to the frame
+ * @param[in] n         size of the frame
+ *
+ * @notapi
+ */
+static void mac_loopback(MACDriver *macp, const uint8_t *bp, size_t n) {
+  sim_mac_descriptor_t *rdes = &macp->rd[macp->rxfill];
+
+  osalDbgCheckClassS();
+
+  if (rdes->state != SIM_MAC_FREE) {
+    macp->overruns++;
+    return;
+  }
+
+  memcpy(rdes->buffer, bp, n);
+  rdes->size   = n;
+  rdes->state  = SIM_MAC_READY;
+  macp->rxfill = (macp->rxfill + 1U) % SIM_MAC_RECEIVE_BUFFERS;
+  macp->frames++;
+
+  /* Same notifications of a receive interrupt.*/
+  osalThreadDequeueAllI(&macp->rdqueue, MSG_RESET);
+#if MAC_USE_EVENTS == TRUE
+  osalEventBroadcastFlagsI(&macp->rdevent, 0);
+#endif
+}
+
+/*===========================================================================*/
+/* Driver interrupt handlers.                                                */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Driver exported functions.                                                */
+/*===========================================================================*/
+
+/**
+ * @brief   Low level MAC initialization.
+ *
+ * @notapi
+ */
+void mac_lld_init(void) {
+
+  macObjectInit(&ETHD1);
+  ETHD1.link_up = false;
+}
+
+/**
+ * @brief   Configures and activates the MAC peripheral.
+ *
+ * @param[in] macp      pointer to the @p MACDriver object
+ *
+ * @notapi
+ */
+void mac_lld_start(MACDriver *macp) {
+  unsigned i;
+
+  for (i = 0U; i < SIM_MAC_TRANSMIT_BUFFERS; i++) {
+    macp->td[i].state = SIM_MAC_FREE;
+  }
+  for (i = 0U; i < SIM_MAC_RECEIVE_BUFFERS; i++) {
+    macp->rd[i].state = SIM_MAC_FREE;
+  }
+  macp->txnext   = 0U;
+  macp->rxnext   = 0U;
+  macp->rxfill   = 0U;
+  macp->frames   = 0U;
+  macp->overruns = 0U;
+  macp->link_up  = true;
+}
+
+/**
+ * @brief   Deactivates the MAC peripheral.
+ *
+ * @param[in] macp      pointer to the @p MACDriver object
+ *
+ * @notapi
+ */
+void mac_lld_stop(MACDriver *macp) {
+
+  macp->link_up = false;
+}
+
+/**
+ * @brief   Returns a transmission descriptor.
+ * @details One of the available transmission descriptors is locked and
+ *          returned.
+ *
+ * @param[in] macp      pointer to the @p MACDriver object
+ * @param[out] tdp      pointer to a @p MACTransmitDescriptor structure
+ * @return              The operation status.
+ * @retval MSG_OK       the descriptor has been obtained.
+ * @retval MSG_TIMEOUT  descriptor not available.
+ *
+ * @notapi
+ */
+msg_t mac_lld_get_transmit_descriptor(MACDriver *macp,
+                                      MACTransmitDescriptor *tdp) {
+  sim_mac_descriptor_t *tdes;
+
+  if (!macp->link_up) {
+    return MSG_TIMEOUT;
+  }
+
+  osalSysLock();
+
+  tdes = &macp->td[macp->txnext];
+  if (tdes->state != SIM_MAC_FREE) {
+    osalSysUnlock();
+    return MSG_TIMEOUT;
+  }
+  tdes->state  = SIM_MAC_LOCKED;
+  macp->txnext = (macp->txnext + 1U) % SIM_MAC_TRANSMIT_BUFFERS;
+
+  osalSysUnlock();
+
+  tdp->offset   = 0U;
+  tdp->size     = SIM_MAC_BUFFERS_SIZE;
+  tdp->macp     = macp;
+  tdp->physdesc = tdes;
+
+  return MSG_OK;
+}
+
+/**
+ * @brief   Releases a transmit descriptor and starts the transmission of the
+ *          enqueued data as a single frame.
+ * @details The frame is immediately looped back into the receive buffers.
+ *
+ * @param[in] tdp       the pointer to the @p MACTransmitDescriptor structure
+ *
+ * @notapi
+ */
+void mac_lld_release_transmit_descriptor(MACTransmitDescriptor *tdp) {
+  MACDriver *macp = tdp->macp;
+
+  osalDbgAssert(tdp->physdesc->state == SIM_MAC_LOCKED,
+                "descriptor not locked");
+
+  osalSysLock();
+
+  mac_loopback(macp, tdp->physdesc->buffer, tdp->offset);
+
+  /* The transmission is complete, the descriptor is immediately free.*/
+  tdp->physdesc->state = SIM_MAC_FREE;
+  osalThreadDequeueAllI(&macp->tdqueue, MSG_RESET);
+
+  osalOsRescheduleS();
+  osalSysUnlock();
+}
+
+/**
+ * @brief   Returns a receive descriptor.
+ *
+ * @param[in] macp      pointer to the @p MACDriver object
+ * @param[out] rdp      pointer to a @p MACReceiveDescriptor structure
+ * @return              The operation status.
+ * @retval MSG_OK       the descriptor has been obtained.
+ * @retval MSG_TIMEOUT  descriptor not available.
+ *
+ * @notapi
+ */
+msg_t mac_lld_get_receive_descriptor(MACDriver *macp,
+                                     MACReceiveDescriptor *rdp) {
+  sim_mac_descriptor_t *rdes;
+
+  osalSysLock();
+
+  rdes = &macp->rd[macp->rxnext];
+  if (rdes->state != SIM_MAC_READY) {
+    osalSysUnlock();
+    return MSG_TIMEOUT;
+  }
+  rdes->state  = SIM_MAC_LOCKED;
+  macp->rxnext = (macp->rxnext + 1U) % SIM_MAC_RECEIVE_BUFFERS;
+
+  osalSysUnlock();
+
+  rdp->offset   = 0U;
+  rdp->size     = rdes->size;
+  rdp->physdesc = rdes;
+
+  return MSG_OK;
+}
+
+/**
+ * @brief   Releases a receive descriptor.
+ * @details The descriptor and its buffer are made available for more incoming
+ *          frames.
+ *
+ * @param[in] rdp       the pointer to the @p MACReceiveDescriptor structure
+ *
+ * @notapi
+ */
+void mac_lld_release_receive_descriptor(MACReceiveDescriptor *rdp) {
+
+  osalDbgAssert(rdp->physdesc->state == SIM_MAC_LOCKED,
+                "descriptor not locked");
+
+  osalSysLock();
+  rdp->physdesc->state = SIM_MAC_FREE;
+  osalSysUnlock();
+}
+
+/**
+ * @brief   Updates and returns the link status.
+ *
+ * @param[in] macp      pointer to the @p MACDriver object
+ * @return              The link status.
+ * @retval true         if the link is active.
+ * @retval false        if the link is down.
+ *
+ * @notapi
+ */
+bool mac_lld_poll_link_status(MACDriver *macp) {
+
+  return macp->link_up;
+}
+
+/**
+ * @brief   Writes to a transmit descriptor's stream.
+ *
+ * @param[in] tdp       pointer to a @p MACTransmitDescriptor structure
+ * @param[in] buf       pointer to the buffer containing the data to be
+ *                      written
+ * @param[in] size      number of bytes to be written
+ * @return              The number of bytes written into the descriptor's
+ *                      stream, this value can be less than the amount
+ *                      specified in the parameter @p size if the maximum
+ *                      frame size is reached.
+ *
+ * @notapi
+ */
+size_t mac_lld_write_transmit_descriptor(MACTransmitDescriptor *tdp,
+                                         uint8_t *buf,
+                                         size_t size) {
+
+  if (size > tdp->size - tdp->offset) {
+    size = tdp->size - tdp->offset;
+  }
+
+  if (size > 0U) {
+    memcpy(tdp->physdesc->buffer + tdp->offset, buf, size);
+    tdp->offset += size;
+  }
+  return size;
+}
+
+/**
+ * @brief   Reads from a receive descriptor's stream.
+ *
+ * @param[in] rdp       pointer to a @p MACReceiveDescriptor structure
+ * @param[in] buf       pointer to the buffer that will receive the read data
+ * @param[in] size      number of bytes to be read
+ * @return              The number of bytes read from the descriptor's
+ *                      stream, this value can be less than the amount
+ *                      specified in the parameter @p size if there are
+ *                      no more bytes to read.
+ *
+ * @notapi
+ */
+size_t mac_lld_read_receive_descriptor(MACReceiveDescriptor *rdp,
+                                       uint8_t *buf,
+                                       size_t size) {
+
+  if (size > rdp->size - rdp->offset) {
+    size = rdp->size - rdp->offset;
+  }
+
+  if (size > 0U) {
+    memcpy(buf, rdp->physdesc->buffer + rdp->offset, size);
+    rdp->offset += size;
+  }
+  return size;
+}
+
+#if (MAC_USE_ZERO_COPY == TRUE) || defined(__DOXYGEN__)
+/**
+ * @brief   Returns a pointer to the next transmit buffer in the descriptor
+ *          chain.
+ * @note    The API guarantees that enough buffers can be requested to fill
+ *          a whole frame.
+ *
+ * @param[in] tdp       pointer to a @p MACTransmitDescriptor structure
+ * @param[in] size      size of the requested buffer. Specify the frame size
+ *                      on the first call then scale the value down subtracting
+ *                      the amount of data already copied into the previous
+ *                      buffers.
+ * @param[out] sizep    pointer to variable receiving the buffer size, it is
+ *                      zero when the last buffer has already been returned.
+ * @return              Pointer to the returned buffer.
+ * @retval NULL         if the buffer chain has been entirely scanned.
+ *
+ * @notapi
+ */
+uint8_t *mac_lld_get_next_transmit_buffer(MACTransmitDescriptor *tdp,
+                                          size_t size,
+                                          size_t *sizep) {
+
+  if (tdp->offset == 0U) {
+    *sizep      = tdp->size;
+    tdp->offset = size;
+    return tdp->physdesc->buffer;
+  }
+  *sizep = 0U;
+  return NULL;
+}
+
+/**
+ * @brief   Returns a pointer to the next receive buffer in the descriptor
+ *          chain.
+ * @note    The API guarantees that the descriptor chain contains a whole
+ *          frame.
+ *
+ * @param[in] rdp       pointer to a @p MACReceiveDescriptor structure
+ * @param[out] sizep    pointer to variable receiving the buffer size, it is
+ *                      zero when the last buffer has already been returned.
+ * @return              Pointer to the returned buffer.
+ * @retval NULL         if the buffer chain has been entirely scanned.
+ *
+ * @notapi
+ */
+const uint8_t *mac_lld_get_next_receive_buffer(MACReceiveDescriptor *rdp,
+                                               size_t *sizep) {
+
+  if (rdp->size > 0U) {
+    *sizep      = rdp->size;
+    rdp->offset = rdp->size;
+    rdp->size   = 0U;
+    return rdp->physdesc->buffer;
+  }
+  *sizep = 0U;
+  return NULL;
+}
+#endif /* MAC_USE_ZERO_COPY == TRUE */
+
+#endif /* HAL_USE_MAC == TRUE */
+
+/** @} */
@@ -0,0 +1,258 @@
+/*
+    ChibiOS - Copyright (C) 2006..2018 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+/**
+ * @file    hal_mac_lld.h
+ * @brief   Simulator low level MAC driver header.
+ * @details The simulated MAC is a loopback device, transmitted frames are
+ *          copied into the receive buffers ring as if they came back from
+ *          the wire.
+ *
+ * @addtogroup SIMULATOR_MAC
+ * @{
+ */
+
+#ifndef HAL_MAC_LLD_H
+#define HAL_MAC_LLD_H
+
+#if (HAL_USE_MAC == TRUE) || defined(__DOXYGEN__)
+
+/*===========================================================================*/
+/* Driver constants.                                                         */
+/*===========================================================================*/
+
+/**
+ * @brief   This implementation supports the zero-copy mode API.
+ */
+#define MAC_SUPPORTS_ZERO_COPY      TRUE
+
+/*===========================================================================*/
+/* Driver pre-compile time settings.                                         */
+/*===========================================================================*/
+
+/**
+ * @name    Configuration options
+ * @{
+ */
+/**
+ * @brief   Number of available transmit buffers.
+ */
+#if !defined(SIM_MAC_TRANSMIT_BUFFERS) || defined(__DOXYGEN__)
+#define SIM_MAC_TRANSMIT_BUFFERS            2
+#endif
+
+/**
+ * @brief   Number of available receive buffers.
+ */
+#if !defined(SIM_MAC_RECEIVE_BUFFERS) || defined(__DOXYGEN__)
+#define SIM_MAC_RECEIVE_BUFFERS             4
+#endif
+
+/**
+ * @brief   Maximum supported frame size.
+ */
+#if !defined(SIM_MAC_BUFFERS_SIZE) || defined(__DOXYGEN__)
+#define SIM_MAC_BUFFERS_SIZE                1524
+#endif
+/** @} */
+
+/*===========================================================================*/
+/* Derived constants and error checks.                                       */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Driver data structures and types.                                         */
+/*===========================================================================*/
+
+/**
+ * @brief   Type of a simulated buffer descriptor.
+ */
+typedef struct {
+  /**
+   * @brief   Descriptor state.
+   */
+  volatile uint32_t     state;
+  /**
+   * @brief   Size of the frame in the buffer.
+   */
+  size_t                size;
+  /**
+   * @brief   Frame buffer.
+   */
+  uint8_t               buffer[SIM_MAC_BUFFERS_SIZE];
+} sim_mac_descriptor_t;
+
+/**
+ * @brief   Driver configuration structure.
+ */
+typedef struct {
+  /**
+   * @brief MAC address.
+   */
+  uint8_t               *mac_address;
+  /* End of the mandatory fields.*/
+} MACConfig;
+
+/**
+ * @brief   Structure representing a MAC driver.
+ */
+struct MACDriver {
+  /**
+   * @brief Driver state.
+   */
+  macstate_t            state;
+  /**
+   * @brief Current configuration data.
+   */
+  const MACConfig       *config;
+  /**
+   * @brief Transmit semaphore.
+   */
+  threads_queue_t       tdqueue;
+  /**
+   * @brief Receive semaphore.
+   */
+  threads_queue_t       rdqueue;
+#if (MAC_USE_EVENTS == TRUE) || defined(__DOXYGEN__)
+  /**
+   * @brief Receive event.
+   */
+  event_source_t        rdevent;
+#endif
+  /* End of the mandatory fields.*/
+  /**
+   * @brief Link status flag.
+   */
+  bool                  link_up;
+  /**
+   * @brief Index of the next transmit descriptor.
+   */
+  unsigned              txnext;
+  /**
+   * @brief Index of the next receive descriptor to be returned.
+   */
+  unsigned              rxnext;
+  /**
+   * @brief Index of the next receive descriptor to be filled.
+   */
+  unsigned              rxfill;
+  /**
+   * @brief Number of frames looped back.
+   */
+  uint32_t              frames;
+  /**
+   * @brief Number of frames lost because no receive buffers were free.
+   */
+  uint32_t              overruns;
+  /**
+   * @brief Transmit descriptors.
+   */
+  sim_mac_descriptor_t  td[SIM_MAC_TRANSMIT_BUFFERS];
+  /**
+   * @brief Receive descriptors.
+   */
+  sim_mac_descriptor_t  rd[SIM_MAC_RECEIVE_BUFFERS];
+};
+
+/**
+ * @brief   Structure representing a transmit descriptor.
+ */
+typedef struct {
+  /**
+   * @brief Current write offset.
+   */
+  size_t                offset;
+  /**
+   * @brief Available space size.
+   */
+  size_t                size;
+  /* End of the mandatory fields.*/
+  /**
+   * @brief Pointer to the driver owning the descriptor.
+   */
+  MACDriver             *macp;
+  /**
+   * @brief Pointer to the simulated descriptor.
+   */
+  sim_mac_descriptor_t  *physdesc;
+} MACTransmitDescriptor;
+
+/**
+ * @brief   Structure representing a receive descriptor.
+ */
+typedef struct {
+  /**
+   * @brief Current read offset.
+   */
+  size_t                offset;
+  /**
+   * @brief Available data size.
+   */
+  size_t                size;
+  /* End of the mandatory fields.*/
+  /**
+   * @brief Pointer to the simulated descriptor.
+   */
+  sim_mac_descriptor_t  *physdesc;
+} MACReceiveDescriptor;
+
+/*===========================================================================*/
+/* Driver macros.                                                            */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* External declarations.                                                    */
+/*===========================================================================*/
+
+#if !defined(__DOXYGEN__)
+extern MACDriver ETHD1;
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+  void mac_lld_init(void);
+  void mac_lld_start(MACDriver *macp);
+  void mac_lld_stop(MACDriver *macp);
+  msg_t mac_lld_get_transmit_descriptor(MACDriver *macp,
+                                        MACTransmitDescriptor *tdp);
+  void mac_lld_release_transmit_descriptor(MACTransmitDescriptor *tdp);
+  msg_t mac_lld_get_receive_descriptor(MACDriver *macp,
+                                       MACReceiveDescriptor *rdp);
+  void mac_lld_release_receive_descriptor(MACReceiveDescriptor *rdp);
+  bool mac_lld_poll_link_status(MACDriver *macp);
+  size_t mac_lld_write_transmit_descriptor(MACTransmitDescriptor *tdp,
+                                           uint8_t *buf,
+                                           size_t size);
+  size_t mac_lld_read_receive_descriptor(MACReceiveDescriptor *rdp,
+                                         uint8_t *buf,
+                                         size_t size);
+#if (MAC_USE_ZERO_COPY == TRUE) || defined(__DOXYGEN__)
+  uint8_t *mac_lld_get_next_transmit_buffer(MACTransmitDescriptor *tdp,
+                                            size_t size,
+                                            size_t *sizep);
+  const uint8_t *mac_lld_get_next_receive_buffer(MACReceiveDescriptor *rdp,
+                                                 size_t *sizep);
+#endif
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* HAL_USE_MAC == TRUE */
+
+#endif /* HAL_MAC_LLD_H */
+
+/** @} */
@@ -42,10 +42,91 @@
 /* Driver local variables and types.                                         */
 /*===========================================================================*/
 
+#if (OSAL_ST_MODE == OSAL_ST_MODE_FREERUNNING) || defined(__DOXYGEN__)
+/**
+ * @brief   Host time corresponding to system time zero.
+ * @note    The base moves forward when the host serves an alarm late, the
+ *          system time does not include the host delays.
+ */
+static uint64_t st_base_ns;
+
+/**
+ * @brief   Latest system time returned, in nanoseconds from the base.
+ */
+static uint64_t st_last_ns;
+
+/**
+ * @brief   System time of the current alarm, in nanoseconds from the base.
+ */
+static uint64_t st_alarm_ns;
+
+/**
+ * @brief   Current alarm time.
+ */
+static systime_t st_alarm;
+
+/**
+ * @brief   Alarm enabled.
+ */
+static bool st_alarm_active;
+
+/**
+ * @brief   Alarm armed and not yet triggered.
+ */
+static bool st_alarm_armed;
+#endif
+
 /*===========================================================================*/
 /* Driver local functions.                                                   */
 /*===========================================================================*/
 
+#if (OSAL_ST_MODE == OSAL_ST_MODE_FREERUNNING) || defined(__DOXYGEN__)
+/**
+ * @brief   Converts an host time interval to system ticks.
+ *
+ * @param[in] ns        interval in nanoseconds
+ * @return              The number of system ticks.
+ */
+static uint64_t st_ns2ticks(uint64_t ns) {
+
+  return ((ns / 1000000000ULL) * (uint64_t)OSAL_ST_FREQUENCY) +
+         (((ns % 1000000000ULL) * (uint64_t)OSAL_ST_FREQUENCY) /
+          1000000000ULL);
+}
+
+/**
+ * @brief   Converts system ticks to an host time interval.
+ * @note    The result is rounded up so that the alarm never triggers
+ *          before the system time reached the requested value.
+ *
+ * @param[in] ticks     number of system ticks
+ * @return              The interval in nanoseconds.
+ */
+static uint64_t st_ticks2ns(uint64_t ticks) {
+
+  return ((ticks / (uint64_t)OSAL_ST_FREQUENCY) * 1000000000ULL) +
+         ((((ticks % (uint64_t)OSAL_ST_FREQUENCY) * 1000000000ULL) +
+           (uint64_t)OSAL_ST_FREQUENCY - 1ULL) /
+          (uint64_t)OSAL_ST_FREQUENCY);
+}
+
+/**
+ * @brief   Returns the system time in nanoseconds from the base.
+ * @note    The returned values never decrease.
+ *
+ * @return              The system time in nanoseconds.
+ */
+static uint64_t st_get_ns(void) {
+  uint64_t ns = _sim_get_time_ns() - st_base_ns;
+
+  if (ns > st_last_ns) {
+    st_last_ns = ns;
+  }
+
+  return st_last_ns;
+}
+#endif
+
 /*===========================================================================*/
 /* Driver interrupt handlers.                                                */
 /*===========================================================================*/
@@ -60,7 +141,164 @@
  * @notapi
  */
 void st_lld_init(void) {
+
+#if OSAL_ST_MODE == OSAL_ST_MODE_FREERUNNING
+  st_base_ns      = _sim_get_time_ns();
+  st_last_ns      = 0ULL;
+  st_alarm_active = false;
+  st_alarm_armed  = false;
+#endif
+}
+
+#if (OSAL_ST_MODE == OSAL_ST_MODE_FREERUNNING) || defined(__DOXYGEN__)
+/**
+ * @brief   Returns the time counter value.
+ * @note    The counter is derived from the host monotonic clock.
+ *
+ * @return              The counter value.
+ *
+ * @notapi
+ */
+systime_t st_lld_get_counter(void) {
+
+  return (systime_t)st_ns2ticks(st_get_ns());
+}
+
+/**
+ * @brief   Starts the alarm.
+ * @note    Makes sure that no spurious alarms are triggered after
+ *          this call.
+ *
+ * @param[in] time      the time to be set for the first alarm
+ *
+ * @notapi
+ */
+void st_lld_start_alarm(systime_t time) {
+
+  st_alarm_active = true;
+  st_lld_set_alarm(time);
+}
+
+/**
+ * @brief   Stops the alarm interrupt.
+ *
+ * @notapi
+ */
+void st_lld_stop_alarm(void) {
+
+  st_alarm_active = false;
+  st_alarm_armed  = false;
+}
+
+/**
+ * @brief   Sets the alarm time.
+ * @note    An alarm time less than half counter range in the past is
+ *          considered already expired, the alarm triggers immediately.
+ *
+ * @param[in] time      the time to be set for the next alarm
+ *
+ * @notapi
+ */
+void st_lld_set_alarm(systime_t time) {
+  uint64_t now = st_ns2ticks(st_get_ns());
+  systime_t delta = (systime_t)(time - (systime_t)now);
+
+  if (delta > ((systime_t)-1 / (systime_t)2)) {
+    delta = (systime_t)0;
+  }
+  st_alarm       = time;
+  st_alarm_ns    = st_ticks2ns(now + (uint64_t)delta);
+  st_alarm_armed = true;
+}
+
+/**
+ * @brief   Returns the current alarm time.
+ *
+ * @return              The currently set alarm time.
+ *
+ * @notapi
+ */
+systime_t st_lld_get_alarm(void) {
+
+  return st_alarm;
+}
+
+/**
+ * @brief   Determines if the alarm is active.
+ *
+ * @return              The alarm status.
+ * @retval false        if the alarm is not active.
+ * @retval true         is the alarm is active
+ *
+ * @notapi
+ */
+bool st_lld_is_alarm_active(void) {
+
+  return st_alarm_active;
+}
+
+/**
+ * @brief   Returns the host time of the next alarm.
+ *
+ * @param[out] nsp      pointer to the host time of the next alarm
+ * @return              The alarm status.
+ * @retval false        if there is no pending alarm.
+ * @retval true         if there is a pending alarm.
+ *
+ * @notapi
+ */
+bool st_lld_get_deadline(uint64_t *nsp) {
+
+  *nsp = st_base_ns + st_alarm_ns;
+
+  return st_alarm_active && st_alarm_armed;
+}
+
+/**
+ * @brief   Alarm interrupt simulation.
+ * @details The alarm triggers once when the host time reaches the alarm
+ *          time, it is armed again by the next @p st_lld_set_alarm().
+ * @note    The host can resume the process well after the alarm time, a
+ *          late alarm is served on time by moving the base forward, as
+ *          the late ticks of the periodic mode. The system time never
+ *          goes back, a delay already observed by the application is
+ *          retained.
+ *
+ * @return              The interrupt status.
+ * @retval false        if the alarm did not trigger.
+ * @retval true         if the alarm triggered.
+ *
+ * @notapi
+ */
+bool st_lld_serve_interrupt(void) {
+  uint64_t ns;
+
+  if (!st_alarm_active || !st_alarm_armed) {
+    return false;
+  }
+  ns = _sim_get_time_ns() - st_base_ns;
+  if (ns < st_alarm_ns) {
+    return false;
+  }
+  st_alarm_armed = false;
+
+  /* Removing the host delay from the system time.*/
+  if (st_last_ns < st_alarm_ns) {
+    st_last_ns = st_alarm_ns;
+  }
+  st_base_ns += ns - st_last_ns;
+
+  OSAL_IRQ_PROLOGUE();
+
+  osalSysLockFromISR();
+  osalOsTimerHandlerI();
+  osalSysUnlockFromISR();
+
+  OSAL_IRQ_EPILOGUE();
+
+  return true;
 }
+#endif /* OSAL_ST_MODE == OSAL_ST_MODE_FREERUNNING */
 
 #endif /* OSAL_ST_MODE != OSAL_ST_MODE_NONE */
 
@@ -55,6 +55,16 @@
 extern "C" {
 #endif
   void st_lld_init(void);
+#if (OSAL_ST_MODE == OSAL_ST_MODE_FREERUNNING) || defined(__DOXYGEN__)
+  systime_t st_lld_get_counter(void);
+  void st_lld_start_alarm(systime_t time);
+  void st_lld_stop_alarm(void);
+  void st_lld_set_alarm(systime_t time);
+  systime_t st_lld_get_alarm(void);
+  bool st_lld_is_alarm_active(void);
+  bool st_lld_get_deadline(uint64_t *nsp);
+  bool st_lld_serve_interrupt(void);
+#endif
 #ifdef __cplusplus
 }
 #endif
@@ -63,6 +73,7 @@ extern "C" {
 /* Driver inline functions.                                                  */
 /*===========================================================================*/
 
+#if OSAL_ST_MODE != OSAL_ST_MODE_FREERUNNING
 /**
  * @brief   Returns the time counter value.
  *
@@ -135,6 +146,7 @@ static inline bool st_lld_is_alarm_active(void) {
 
   return false;
 }
+#endif /* OSAL_ST_MODE != OSAL_ST_MODE_FREERUNNING */
 
 #endif /* HAL_ST_LLD_H */
 
@@ -0,0 +1,415 @@
+/*
+    ChibiOS - Copyright (C) 2006..2018 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+/**
+ * @file    simulator/posix/hal_can_lld.c
+ * @brief   Posix simulator low level CAN driver code.
+ * @details The simulated peripheral is in loopback mode, the bus is served
+ *          when the simulated interrupts are checked. Each time the TX FIFO
+ *          content is moved on the bus, frames not passing the acceptance
+ *          filters are discarded and frames not fitting in the RX FIFO are
+ *          lost, an overflow error is reported in the latter case.
+ *
+ * @addtogroup POSIX_CAN
+ * @{
+ */
+
+#include "hal.h"
+
+#if (HAL_USE_CAN == TRUE) || defined(__DOXYGEN__)
+
+/*===========================================================================*/
+/* Driver exported variables.                                                */
+/*===========================================================================*/
+
+/** @brief CAN driver 1 identifier.*/
+#if (USE_SIM_CAN1 == TRUE) || defined(__DOXYGEN__)
+CANDriver CAND1;
+#endif
+
+/*===========================================================================*/
+/* Driver local variables and types.                                         */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Driver local functions.                                                   */
+/*===========================================================================*/
+
+/**
+ * @brief   Returns the filter identifier of a frame.
+ *
+ * @param[in] ctfp      pointer to the frame
+ * @return              The frame identifier in filter format.
+ */
+static uint32_t frame_id(const CANTxFrame *ctfp) {
+  uint32_t id;
+
+  if (ctfp->IDE != 0U) {
+    id = (uint32_t)ctfp->EID | CAN_SIM_FILTER_IDE;
+  }
+  else {
+    id = (uint32_t)ctfp->SID;
+  }
+  if (ctfp->RTR != 0U) {
+    id |= CAN_SIM_FILTER_RTR;
+  }
+
+  return id;
+}
+
+/**
+ * @brief   Acceptance filtering.
+ *
+ * @param[in] canp      pointer to the @p CANDriver object
+ * @param[in] id        frame identifier in filter format
+ * @param[out] fmip     index of the matching filter
+ * @return              The filtering result.
+ * @retval false        if the frame has been rejected.
+ * @retval true         if the frame has been accepted.
+ */
+static bool is_accepted(CANDriver *canp, uint32_t id, uint8_t *fmip) {
+  uint32_t i;
+
+  if (canp->nfilters == 0U) {
+    *fmip = 0U;
+    return true;
+  }
+  for (i = 0U; i < canp->nfilters; i++) {
+    if (((id ^ canp->filters[i].id) & canp->filters[i].mask) == 0U) {
+      *fmip = (uint8_t)i;
+      return true;
+    }
+  }
+
+  return false;
+}
+
+/**
+ * @brief   Serves the simulated bus of a driver.
+ *
+ * @param[in] canp      pointer to the @p CANDriver object
+ * @return              The interrupt status.
+ * @retval false        if no event has been generated.
+ * @retval true         if at least one event has been generated.
+ */
+static bool serve(CANDriver *canp) {
+  unsigned moved, received;
+  eventflags_t errors;
+
+  if (canp->state != CAN_READY) {
+    return false;
+  }
+
+  /* Bus transfer.*/
+  osalSysLockFromISR();
+  moved = 0U;
+  received = 0U;
+  errors = 0U;
+  while (canp->txcnt > 0U) {
+    const CANTxFrame *ctfp = &canp->txfifo[canp->txrd];
+    uint8_t fmi;
+
+    if (is_accepted(canp, frame_id(ctfp), &fmi)) {
+      if (canp->rxcnt < (unsigned)SIM_CAN_RX_FIFO_SIZE) {
+        CANRxFrame *crfp = &canp->rxfifo[(canp->rxrd + canp->rxcnt) %
+                                         (unsigned)SIM_CAN_RX_FIFO_SIZE];
+
+        crfp->FMI     = fmi;
+        crfp->TIME    = 0U;
+        crfp->DLC     = ctfp->DLC;
+        crfp->RTR     = ctfp->RTR;
+        crfp->IDE     = ctfp->IDE;
+        crfp->_align1 = ctfp->_align1;
+        crfp->data32[0] = ctfp->data32[0];
+        crfp->data32[1] = ctfp->data32[1];
+        canp->rxcnt++;
+        received++;
+      }
+      else {
+        errors |= CAN_OVERFLOW_ERROR;
+      }
+    }
+    else {
+      canp->rejected++;
+    }
+    canp->txrd = (canp->txrd + 1U) % (unsigned)SIM_CAN_TX_FIFO_SIZE;
+    canp->txcnt--;
+    moved++;
+  }
+  osalSysUnlockFromISR();
+
+  /* Events, generated as from an interrupt handler.*/
+  if (errors != 0U) {
+    _can_error_isr(canp, errors);
+  }
+  if (moved > 0U) {
+    _can_tx_empty_isr(canp, CAN_MAILBOX_TO_MASK(1U));
+  }
+  if (received > 0U) {
+    _can_rx_full_isr(canp, CAN_MAILBOX_TO_MASK(1U));
+  }
+
+  return moved > 0U;
+}
+
+/*===========================================================================*/
+/* Driver interrupt handlers.                                                */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Driver exported functions.                                                */
+/*===========================================================================*/
+
+/**
+ * @brief   Low level CAN driver initialization.
+ *
+ * @notapi
+ */
+void can_lld_init(void) {
+
+#if USE_SIM_CAN1 == TRUE
+  canObjectInit(&CAND1);
+  CAND1.nfilters = 0U;
+#endif
+}
+
+/**
+ * @brief   Configures and activates the CAN peripheral.
+ *
+ * @param[in] canp      pointer to the @p CANDriver object
+ *
+ * @notapi
+ */
+void can_lld_start(CANDriver *canp) {
+
+  canp->txrd     = 0U;
+  canp->txcnt    = 0U;
+  canp->rxrd     = 0U;
+  canp->rxcnt    = 0U;
+  canp->rejected = 0U;
+}
+
+/**
+ * @brief   Deactivates the CAN peripheral.
+ *
+ * @param[in] canp      pointer to the @p CANDriver object
+ *
+ * @notapi
+ */
+void can_lld_stop(CANDriver *canp) {
+
+  canp->txcnt = 0U;
+  canp->rxcnt = 0U;
+}
+
+/**
+ * @brief   Determines whether a frame can be transmitted.
+ *
+ * @param[in] canp      pointer to the @p CANDriver object
+ * @param[in] mailbox   mailbox number, @p CAN_ANY_MAILBOX for any mailbox
+ *
+ * @return              The queue space availability.
+ * @retval false        no space in the transmit queue.
+ * @retval true         transmit slot available.
+ *
+ * @notapi
+ */
+bool can_lld_is_tx_empty(CANDriver *canp, canmbx_t mailbox) {
+
+  if (mailbox > (canmbx_t)CAN_TX_MAILBOXES) {
+    return false;
+  }
+
+  return canp->txcnt < (unsigned)SIM_CAN_TX_FIFO_SIZE;
+}
+
+/**
+ * @brief   Inserts a frame into the transmit queue.
+ *
+ * @param[in] canp      pointer to the @p CANDriver object
+ * @param[in] ctfp      pointer to the CAN frame to be transmitted
+ * @param[in] mailbox   mailbox number,  @p CAN_ANY_MAILBOX for any mailbox
+ *
+ * @notapi
+ */
+void can_lld_transmit(CANDriver *canp,
+                      canmbx_t mailbox,
+                      const CANTxFrame *ctfp) {
+
+  (void)mailbox;
+
+  canp->txfifo[(canp->txrd + canp->txcnt) % (unsigned)SIM_CAN_TX_FIFO_SIZE] =
+      *ctfp;
+  canp->txcnt++;
+}
+
+/**
+ * @brief   Determines whether a frame has been received.
+ *
+ * @param[in] canp      pointer to the @p CANDriver object
+ * @param[in] mailbox   mailbox number, @p CAN_ANY_MAILBOX for any mailbox
+ *
+ * @return              The queue space availability.
+ * @retval false        no space in the transmit queue.
+ * @retval true         transmit slot available.
+ *
+ * @notapi
+ */
+bool can_lld_is_rx_nonempty(CANDriver *canp, canmbx_t mailbox) {
+
+  if (mailbox > (canmbx_t)CAN_RX_MAILBOXES) {
+    return false;
+  }
+
+  return canp->rxcnt > 0U;
+}
+
+/**
+ * @brief   Receives a frame from the input queue.
+ *
+ * @param[in] canp      pointer to the @p CANDriver object
+ * @param[in] mailbox   mailbox number, @p CAN_ANY_MAILBOX for any mailbox
+ * @param[out] crfp     pointer to the buffer where the CAN frame is copied
+ *
+ * @notapi
+ */
+void can_lld_receive(CANDriver *canp,
+                     canmbx_t mailbox,
+                     CANRxFrame *crfp) {
+
+  (void)mailbox;
+
+  *crfp = canp->rxfifo[canp->rxrd];
+  canp->rxrd = (canp->rxrd + 1U) % (unsigned)SIM_CAN_RX_FIFO_SIZE;
+  canp->rxcnt--;
+}
+
+/**
+ * @brief   Tries to abort an ongoing transmission.
+ * @note    The simulated bus transmits frames atomically, there is nothing
+ *          to abort.
+ *
+ * @param[in] canp      pointer to the @p CANDriver object
+ * @param[in] mailbox   mailbox number
+ *
+ * @notapi
+ */
+void can_lld_abort(CANDriver *canp,
+                   canmbx_t mailbox) {
+
+  (void)canp;
+  (void)mailbox;
+}
+
+#if (CAN_USE_SLEEP_MODE == TRUE) || defined(__DOXYGEN__)
+/**
+ * @brief   Enters the sleep mode.
+ *
+ * @param[in] canp      pointer to the @p CANDriver object
+ *
+ * @notapi
+ */
+void can_lld_sleep(CANDriver *canp) {
+
+  (void)canp;
+}
+
+/**
+ * @brief   Enforces leaving the sleep mode.
+ *
+ * @param[in] canp      pointer to the @p CANDriver object
+ *
+ * @notapi
+ */
+void can_lld_wakeup(CANDriver *canp) {
+
+  (void)canp;
+}
+#endif /* CAN_USE_SLEEP_MODE == TRUE */
+
+/**
+ * @brief   Serves the simulated interrupts.
+ *
+ * @return              The interrupt status.
+ * @retval false        if no interrupt has been served.
+ * @retval true         if at least one interrupt has been served.
+ */
+bool can_lld_interrupt_pending(void) {
+  bool b = false;
+
+  OSAL_IRQ_PROLOGUE();
+
+#if USE_SIM_CAN1 == TRUE
+  b = serve(&CAND1) || b;
+#endif
+
+  OSAL_IRQ_EPILOGUE();
+
+  return b;
+}
+
+/**
+ * @brief   Checks for bus activity.
+ * @details The simulator must not sleep while frames are in transit.
+ *
+ * @return              The bus status.
+ * @retval false        if all the drivers are quiet.
+ * @retval true         if an interrupt is going to happen.
+ */
+bool can_lld_is_busy(void) {
+
+#if USE_SIM_CAN1 == TRUE
+  if ((CAND1.state == CAN_READY) && (CAND1.txcnt > 0U)) {
+    return true;
+  }
+#endif
+
+  return false;
+}
+
+/**
+ * @brief   Programs the acceptance filters.
+ * @details A frame is accepted if it matches at least one filter, the index
+ *          of the first matching filter is reported in the @p FMI field of
+ *          the received frame. With no filters all frames are accepted.
+ * @note    This function can only be invoked while the driver is stopped,
+ *          the filters are retained across restarts.
+ *
+ * @param[in] canp      pointer to the @p CANDriver object
+ * @param[in] num       number of filters, up to @p SIM_CAN_MAX_FILTERS
+ * @param[in] cfp       pointer to the filters array, can be @p NULL if
+ *                      @p num is zero
+ *
+ * @api
+ */
+void canSimSetFilters(CANDriver *canp, uint32_t num, const CANFilter *cfp) {
+  uint32_t i;
+
+  osalDbgCheck((canp != NULL) && (num <= (uint32_t)SIM_CAN_MAX_FILTERS) &&
+               ((num == 0U) || (cfp != NULL)));
+
+  osalSysLock();
+  osalDbgAssert(canp->state == CAN_STOP, "invalid state");
+  for (i = 0U; i < num; i++) {
+    canp->filters[i] = cfp[i];
+  }
+  canp->nfilters = num;
+  osalSysUnlock();
+}
+
+#endif /* HAL_USE_CAN == TRUE */
+
+/** @} */
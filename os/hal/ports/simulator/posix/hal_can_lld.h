@@ -0,0 +1,358 @@
+/*
+    ChibiOS - Copyright (C) 2006..2018 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+/**
+ * @file    simulator/posix/hal_can_lld.h
+ * @brief   Posix simulator low level CAN driver header.
+ *
+ * @addtogroup POSIX_CAN
+ * @{
+ */
+
+#ifndef HAL_CAN_LLD_H
+#define HAL_CAN_LLD_H
+
+#if (HAL_USE_CAN == TRUE) || defined(__DOXYGEN__)
+
+/*===========================================================================*/
+/* Driver constants.                                                         */
+/*===========================================================================*/
+
+/**
+ * @brief   This switch defines whether the driver implementation supports
+ *          a low power switch mode with automatic an wakeup feature.
+ */
+#define CAN_SUPPORTS_SLEEP          TRUE
+
+/**
+ * @brief   Number of transmit mailboxes.
+ */
+#define CAN_TX_MAILBOXES            1
+
+/**
+ * @brief   Number of receive mailboxes.
+ */
+#define CAN_RX_MAILBOXES            1
+
+/**
+ * @name    Filter identifier layout
+ * @{
+ */
+#define CAN_SIM_FILTER_IDE          (1U << 29)  /**< @brief Extended ID.    */
+#define CAN_SIM_FILTER_RTR          (1U << 30)  /**< @brief Remote frame.   */
+/** @} */
+
+/*===========================================================================*/
+/* Driver pre-compile time settings.                                         */
+/*===========================================================================*/
+
+/**
+ * @brief   CAND1 driver enable switch.
+ * @details If set to @p TRUE the support for CAND1 is included.
+ * @note    The default is @p TRUE.
+ */
+#if !defined(USE_SIM_CAN1) || defined(__DOXYGEN__)
+#define USE_SIM_CAN1                        TRUE
+#endif
+
+/**
+ * @brief   Size of the simulated transmit FIFO.
+ */
+#if !defined(SIM_CAN_TX_FIFO_SIZE) || defined(__DOXYGEN__)
+#define SIM_CAN_TX_FIFO_SIZE                4
+#endif
+
+/**
+ * @brief   Size of the simulated receive FIFO.
+ */
+#if !defined(SIM_CAN_RX_FIFO_SIZE) || defined(__DOXYGEN__)
+#define SIM_CAN_RX_FIFO_SIZE                8
+#endif
+
+/**
+ * @brief   Number of hardware filters.
+ */
+#if !defined(SIM_CAN_MAX_FILTERS) || defined(__DOXYGEN__)
+#define SIM_CAN_MAX_FILTERS                 14
+#endif
+
+/*===========================================================================*/
+/* Derived constants and error checks.                                       */
+/*===========================================================================*/
+
+#if CAN_USE_SLEEP_MODE && !CAN_SUPPORTS_SLEEP
+#error "CAN sleep mode not supported in this architecture"
+#endif
+
+#if (SIM_CAN_TX_FIFO_SIZE < 1) || (SIM_CAN_RX_FIFO_SIZE < 1)
+#error "invalid simulated CAN FIFO size"
+#endif
+
+/*===========================================================================*/
+/* Driver data structures and types.                                         */
+/*===========================================================================*/
+
+/**
+ * @brief   Type of a structure representing an CAN driver.
+ */
+typedef struct CANDriver CANDriver;
+
+/**
+ * @brief   Type of a transmission mailbox index.
+ */
+typedef uint32_t canmbx_t;
+
+#if defined(CAN_ENFORCE_USE_CALLBACKS) || defined(__DOXYGEN__)
+/**
+ * @brief   Type of a CAN notification callback.
+ *
+ * @param[in] canp      pointer to the @p CANDriver object triggering the
+ *                      callback
+ * @param[in] flags     flags associated to the mailbox callback
+ */
+typedef void (*can_callback_t)(CANDriver *canp, uint32_t flags);
+#endif
+
+/**
+ * @brief   CAN transmission frame.
+ * @note    Accessing the frame data as word16 or word32 is not portable because
+ *          machine data endianness, it can be still useful for a quick filling.
+ */
+typedef struct {
+  /*lint -save -e46 [6.1] Standard types are fine too.*/
+  uint8_t                   DLC:4;          /**< @brief Data length.        */
+  uint8_t                   RTR:1;          /**< @brief Frame type.         */
+  uint8_t                   IDE:1;          /**< @brief Identifier type.    */
+  union {
+    uint32_t                SID:11;         /**< @brief Standard identifier.*/
+    uint32_t                EID:29;         /**< @brief Extended identifier.*/
+    uint32_t                _align1;
+  };
+  /*lint -restore*/
+  union {
+    uint8_t                 data8[8];       /**< @brief Frame data.         */
+    uint16_t                data16[4];      /**< @brief Frame data.         */
+    uint32_t                data32[2];      /**< @brief Frame data.         */
+  };
+} CANTxFrame;
+
+/**
+ * @brief   CAN received frame.
+ * @note    Accessing the frame data as word16 or word32 is not portable because
+ *          machine data endianness, it can be still useful for a quick filling.
+ */
+typedef struct {
+  /*lint -save -e46 [6.1] Standard types are fine too.*/
+  uint8_t                   FMI;            /**< @brief Filter id.          */
+  uint16_t                  TIME;           /**< @brief Time stamp.         */
+  uint8_t                   DLC:4;          /**< @brief Data length.        */
+  uint8_t                   RTR:1;          /**< @brief Frame type.         */
+  uint8_t                   IDE:1;          /**< @brief Identifier type.    */
+  union {
+    uint32_t                SID:11;         /**< @brief Standard identifier.*/
+    uint32_t                EID:29;         /**< @brief Extended identifier.*/
+    uint32_t                _align1;
+  };
+  /*lint -restore*/
+  union {
+    uint8_t                 data8[8];       /**< @brief Frame data.         */
+    uint16_t                data16[4];      /**< @brief Frame data.         */
+    uint32_t                data32[2];      /**< @brief Frame data.         */
+  };
+} CANRxFrame;
+
+/**
+ * @brief   CAN filter.
+ * @details A frame passes the filter if the bits selected by the mask are
+ *          equal in the frame identifier and in the filter identifier. The
+ *          identifiers are right aligned, the @p CAN_SIM_FILTER_IDE and
+ *          @p CAN_SIM_FILTER_RTR bits represent the frame type.
+ */
+typedef struct {
+  /**
+   * @brief   Filter identifier.
+   */
+  uint32_t                  id;
+  /**
+   * @brief   Filter mask.
+   */
+  uint32_t                  mask;
+} CANFilter;
+
+/**
+ * @brief   Driver configuration structure.
+ */
+typedef struct {
+  /* End of the mandatory fields.*/
+  uint32_t                  dummy;
+} CANConfig;
+
+/**
+ * @brief   Structure representing an CAN driver.
+ * @details The simulated peripheral is a loopback, transmitted frames are
+ *          received by the same driver if they pass the filters.
+ */
+struct CANDriver {
+  /**
+   * @brief   Driver state.
+   */
+  canstate_t                state;
+  /**
+   * @brief   Current configuration data.
+   */
+  const CANConfig           *config;
+  /**
+   * @brief   Transmission threads queue.
+   */
+  threads_queue_t           txqueue;
+  /**
+   * @brief   Receive threads queue.
+   */
+  threads_queue_t           rxqueue;
+#if (CAN_ENFORCE_USE_CALLBACKS == FALSE) || defined (__DOXYGEN__)
+  /**
+   * @brief   One or more frames become available.
+   * @note    The flags associated to the listeners will indicate which
+   *          receive mailboxes become non-empty.
+   */
+  event_source_t            rxfull_event;
+  /**
+   * @brief   One or more transmission mailbox become available.
+   * @note    The flags associated to the listeners will indicate which
+   *          transmit mailboxes become empty.
+   */
+  event_source_t            txempty_event;
+  /**
+   * @brief   A CAN bus error happened.
+   * @note    The flags associated to the listeners will indicate the
+   *          error(s) that have occurred.
+   */
+  event_source_t            error_event;
+#if (CAN_USE_SLEEP_MODE == TRUE) || defined (__DOXYGEN__)
+  /**
+   * @brief   Entering sleep state event.
+   */
+  event_source_t            sleep_event;
+  /**
+   * @brief   Exiting sleep state event.
+   */
+  event_source_t            wakeup_event;
+#endif
+#else /* CAN_ENFORCE_USE_CALLBACKS == TRUE */
+  /**
+   * @brief   One or more frames become available.
+   */
+  can_callback_t            rxfull_cb;
+  /**
+   * @brief   One or more transmission mailbox become available.
+   * @note    The flags associated to the callback will indicate which
+   *          transmit mailboxes become empty.
+   */
+  can_callback_t            txempty_cb;
+  /**
+   * @brief   A CAN bus error happened.
+   */
+  can_callback_t            error_cb;
+#if (CAN_USE_SLEEP_MODE == TRUE) || defined (__DOXYGEN__)
+  /**
+   * @brief   Exiting sleep state.
+   */
+  can_callback_t            wakeup_cb;
+#endif
+#endif
+  /* End of the mandatory fields.*/
+  /**
+   * @brief   Simulated transmit FIFO.
+   */
+  CANTxFrame                txfifo[SIM_CAN_TX_FIFO_SIZE];
+  /**
+   * @brief   Transmit FIFO read index.
+   */
+  unsigned                  txrd;
+  /**
+   * @brief   Frames in the transmit FIFO.
+   */
+  unsigned                  txcnt;
+  /**
+   * @brief   Simulated receive FIFO.
+   */
+  CANRxFrame                rxfifo[SIM_CAN_RX_FIFO_SIZE];
+  /**
+   * @brief   Receive FIFO read index.
+   */
+  unsigned                  rxrd;
+  /**
+   * @brief   Frames in the receive FIFO.
+   */
+  unsigned                  rxcnt;
+  /**
+   * @brief   Hardware filters.
+   */
+  CANFilter                 filters[SIM_CAN_MAX_FILTERS];
+  /**
+   * @brief   Number of programmed filters, zero accepts all frames.
+   */
+  uint32_t                  nfilters;
+  /**
+   * @brief   Frames rejected by the filters.
+   */
+  uint32_t                  rejected;
+};
+
+/*===========================================================================*/
+/* Driver macros.                                                            */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* External declarations.                                                    */
+/*===========================================================================*/
+
+#if (USE_SIM_CAN1 == TRUE) && !defined(__DOXYGEN__)
+extern CANDriver CAND1;
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+  void can_lld_init(void);
+  void can_lld_start(CANDriver *canp);
+  void can_lld_stop(CANDriver *canp);
+  bool can_lld_is_tx_empty(CANDriver *canp, canmbx_t mailbox);
+  void can_lld_transmit(CANDriver *canp,
+                        canmbx_t mailbox,
+                        const CANTxFrame *ctfp);
+  bool can_lld_is_rx_nonempty(CANDriver *canp, canmbx_t mailbox);
+  void can_lld_receive(CANDriver *canp,
+                       canmbx_t mailbox,
+                       CANRxFrame *crfp);
+  void can_lld_abort(CANDriver *canp,
+                     canmbx_t mailbox);
+#if CAN_USE_SLEEP_MODE == TRUE
+  void can_lld_sleep(CANDriver *canp);
+  void can_lld_wakeup(CANDriver *canp);
+#endif
+  bool can_lld_interrupt_pending(void);
+  bool can_lld_is_busy(void);
+  void canSimSetFilters(CANDriver *canp, uint32_t num, const CANFilter *cfp);
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* HAL_USE_CAN == TRUE */
+
+#endif /* HAL_CAN_LLD_H */
+
+/** @} */
@@ -0,0 +1,375 @@
+/*
+    ChibiOS - Copyright (C) 2006..2018 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+/**
+ * @file    simulator/posix/hal_i2c_lld.c
+ * @brief   Posix simulator low level I2C driver code.
+ * @details The simulated bus hosts registers file slaves, a transaction
+ *          is completed when the simulated interrupts are checked after
+ *          its bus time elapsed. Transactions addressed to a missing slave
+ *          fail with an acknowledge error.
+ *
+ * @addtogroup POSIX_I2C
+ * @{
+ */
+
+#include "hal.h"
+
+#if (HAL_USE_I2C == TRUE) || defined(__DOXYGEN__)
+
+/*===========================================================================*/
+/* Driver local definitions.                                                 */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Driver exported variables.                                                */
+/*===========================================================================*/
+
+/** @brief I2C1 driver identifier.*/
+#if (USE_SIM_I2C1 == TRUE) || defined(__DOXYGEN__)
+I2CDriver I2CD1;
+#endif
+
+/*===========================================================================*/
+/* Driver local variables and types.                                         */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Driver local functions.                                                   */
+/*===========================================================================*/
+
+/**
+ * @brief   Starts a simulated transaction.
+ *
+ * @param[in] i2cp      pointer to the @p I2CDriver object
+ * @param[in] addr      slave device address
+ * @param[in] txbuf     pointer to the transmit buffer
+ * @param[in] txbytes   number of bytes to be transmitted
+ * @param[out] rxbuf    pointer to the receive buffer
+ * @param[in] rxbytes   number of bytes to be received
+ */
+static void start_transaction(I2CDriver *i2cp, i2caddr_t addr,
+                              const uint8_t *txbuf, size_t txbytes,
+                              uint8_t *rxbuf, size_t rxbytes) {
+  uint64_t nbytes;
+
+  /* Bus time, each byte is followed by an acknowledge bit, a repeated
+     start repeats the address byte.*/
+  nbytes = 1U + (uint64_t)txbytes + (uint64_t)rxbytes;
+  if ((txbytes > 0U) && (rxbytes > 0U)) {
+    nbytes++;
+  }
+
+  i2cp->addr     = addr;
+  i2cp->txbuf    = txbuf;
+  i2cp->txbytes  = txbytes;
+  i2cp->rxbuf    = rxbuf;
+  i2cp->rxbytes  = rxbytes;
+  i2cp->deadline = _sim_get_time_ns() +
+                   ((nbytes * 9000000000ULL) / i2cp->config->clock_speed);
+  i2cp->active   = true;
+}
+
+/**
+ * @brief   Serves the simulated bus of a driver.
+ *
+ * @param[in] i2cp      pointer to the @p I2CDriver object
+ * @return              The interrupt status.
+ * @retval false        if no event has been generated.
+ * @retval true         if a transaction has been completed.
+ */
+static bool serve(I2CDriver *i2cp) {
+  i2c_sim_slave_t *sp;
+  unsigned i;
+  size_t n;
+
+  osalSysLockFromISR();
+  if (!i2cp->active || (_sim_get_time_ns() < i2cp->deadline)) {
+    osalSysUnlockFromISR();
+    return false;
+  }
+  i2cp->active = false;
+  i2cp->transactions++;
+
+  sp = NULL;
+  for (i = 0U; i < i2cp->nslaves; i++) {
+    if (i2cp->slaves[i].addr == i2cp->addr) {
+      sp = &i2cp->slaves[i];
+      break;
+    }
+  }
+
+  if (sp == NULL) {
+    i2cp->errors |= I2C_ACK_FAILURE;
+  }
+  else {
+    if (i2cp->txbytes > 0U) {
+      sp->ptr = (size_t)(i2cp->txbuf[0] & ~I2C_SIM_SUB_MS) % sp->size;
+      for (n = 1U; n < i2cp->txbytes; n++) {
+        sp->regs[sp->ptr] = i2cp->txbuf[n];
+        sp->ptr = (sp->ptr + 1U) % sp->size;
+      }
+    }
+    for (n = 0U; n < i2cp->rxbytes; n++) {
+      i2cp->rxbuf[n] = sp->regs[sp->ptr];
+      sp->ptr = (sp->ptr + 1U) % sp->size;
+    }
+  }
+  osalSysUnlockFromISR();
+
+  /* Events, generated as from an interrupt handler.*/
+  if (sp == NULL) {
+    _i2c_wakeup_error_isr(i2cp);
+  }
+  else {
+    _i2c_wakeup_isr(i2cp);
+  }
+
+  return true;
+}
+
+/*===========================================================================*/
+/* Driver interrupt handlers.                                                */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Driver exported functions.                                                */
+/*===========================================================================*/
+
+/**
+ * @brief   Low level I2C driver initialization.
+ *
+ * @notapi
+ */
+void i2c_lld_init(void) {
+
+#if USE_SIM_I2C1 == TRUE
+  i2cObjectInit(&I2CD1);
+  I2CD1.thread  = NULL;
+  I2CD1.nslaves = 0U;
+  I2CD1.active  = false;
+#endif
+}
+
+/**
+ * @brief   Configures and activates the I2C peripheral.
+ *
+ * @param[in] i2cp      pointer to the @p I2CDriver object
+ *
+ * @notapi
+ */
+void i2c_lld_start(I2CDriver *i2cp) {
+
+  osalDbgAssert(i2cp->config->clock_speed > 0U, "invalid clock");
+
+  i2cp->active       = false;
+  i2cp->transactions = 0U;
+}
+
+/**
+ * @brief   Deactivates the I2C peripheral.
+ *
+ * @param[in] i2cp      pointer to the @p I2CDriver object
+ *
+ * @notapi
+ */
+void i2c_lld_stop(I2CDriver *i2cp) {
+
+  i2cp->active = false;
+}
+
+/**
+ * @brief   Receives data via the I2C bus as master.
+ *
+ * @param[in] i2cp      pointer to the @p I2CDriver object
+ * @param[in] addr      slave device address
+ * @param[out] rxbuf    pointer to the receive buffer
+ * @param[in] rxbytes   number of bytes to be received
+ * @param[in] timeout   the number of ticks before the operation timeouts,
+ *                      the following special values are allowed:
+ *                      - @a TIME_INFINITE no timeout.
+ *                      .
+ * @return              The operation status.
+ * @retval MSG_OK       if the function succeeded.
+ * @retval MSG_RESET    if one or more I2C errors occurred, the errors can
+ *                      be retrieved using @p i2cGetErrors().
+ * @retval MSG_TIMEOUT  if a timeout occurred before operation end. <b>After a
+ *                      timeout the driver must be stopped and restarted
+ *                      because the bus is in an uncertain state</b>.
+ *
+ * @notapi
+ */
+msg_t i2c_lld_master_receive_timeout(I2CDriver *i2cp, i2caddr_t addr,
+                                     uint8_t *rxbuf, size_t rxbytes,
+                                     sysinterval_t timeout) {
+  msg_t msg;
+
+  start_transaction(i2cp, addr, NULL, 0U, rxbuf, rxbytes);
+  msg = osalThreadSuspendTimeoutS(&i2cp->thread, timeout);
+  if (msg == MSG_TIMEOUT) {
+    i2cp->active = false;
+  }
+
+  return msg;
+}
+
+/**
+ * @brief   Transmits data via the I2C bus as master.
+ *
+ * @param[in] i2cp      pointer to the @p I2CDriver object
+ * @param[in] addr      slave device address
+ * @param[in] txbuf     pointer to the transmit buffer
+ * @param[in] txbytes   number of bytes to be transmitted
+ * @param[out] rxbuf    pointer to the receive buffer
+ * @param[in] rxbytes   number of bytes to be received
+ * @param[in] timeout   the number of ticks before the operation timeouts,
+ *                      the following special values are allowed:
+ *                      - @a TIME_INFINITE no timeout.
+ *                      .
+ * @return              The operation status.
+ * @retval MSG_OK       if the function succeeded.
+ * @retval MSG_RESET    if one or more I2C errors occurred, the errors can
+ *                      be retrieved using @p i2cGetErrors().
+ * @retval MSG_TIMEOUT  if a timeout occurred before operation end. <b>After a
+ *                      timeout the driver must be stopped and restarted
+ *                      because the bus is in an uncertain state</b>.
+ *
+ * @notapi
+ */
+msg_t i2c_lld_master_transmit_timeout(I2CDriver *i2cp, i2caddr_t addr,
+                                      const uint8_t *txbuf, size_t txbytes,
+                                      uint8_t *rxbuf, size_t rxbytes,
+                                      sysinterval_t timeout) {
+  msg_t msg;
+
+  start_transaction(i2cp, addr, txbuf, txbytes, rxbuf, rxbytes);
+  msg = osalThreadSuspendTimeoutS(&i2cp->thread, timeout);
+  if (msg == MSG_TIMEOUT) {
+    i2cp->active = false;
+  }
+
+  return msg;
+}
+
+/**
+ * @brief   Starts an asynchronous transmission via the I2C bus as master.
+ *
+ * @param[in] i2cp      pointer to the @p I2CDriver object
+ * @param[in] addr      slave device address
+ * @param[in] txbuf     pointer to the transmit buffer
+ * @param[in] txbytes   number of bytes to be transmitted
+ * @param[out] rxbuf    pointer to the receive buffer
+ * @param[in] rxbytes   number of bytes to be received
+ *
+ * @notapi
+ */
+void i2c_lld_master_start_transmit(I2CDriver *i2cp, i2caddr_t addr,
+                                   const uint8_t *txbuf, size_t txbytes,
+                                   uint8_t *rxbuf, size_t rxbytes) {
+
+  start_transaction(i2cp, addr, txbuf, txbytes, rxbuf, rxbytes);
+}
+
+/**
+ * @brief   Starts an asynchronous reception via the I2C bus as master.
+ *
+ * @param[in] i2cp      pointer to the @p I2CDriver object
+ * @param[in] addr      slave device address
+ * @param[out] rxbuf    pointer to the receive buffer
+ * @param[in] rxbytes   number of bytes to be received
+ *
+ * @notapi
+ */
+void i2c_lld_master_start_receive(I2CDriver *i2cp, i2caddr_t addr,
+                                  uint8_t *rxbuf, size_t rxbytes) {
+
+  start_transaction(i2cp, addr, NULL, 0U, rxbuf, rxbytes);
+}
+
+/**
+ * @brief   Serves the simulated interrupts.
+ *
+ * @return              The interrupt status.
+ * @retval false        if no interrupt has been served.
+ * @retval true         if at least one interrupt has been served.
+ */
+bool i2c_lld_interrupt_pending(void) {
+  bool b = false;
+
+  OSAL_IRQ_PROLOGUE();
+
+#if USE_SIM_I2C1 == TRUE
+  b = serve(&I2CD1) || b;
+#endif
+
+  OSAL_IRQ_EPILOGUE();
+
+  return b;
+}
+
+/**
+ * @brief   Checks for bus activity.
+ * @details The simulator must not sleep while a transaction is in progress.
+ *
+ * @return              The bus status.
+ * @retval false        if all the drivers are quiet.
+ * @retval true         if an interrupt is going to happen.
+ */
+bool i2c_lld_is_busy(void) {
+
+#if USE_SIM_I2C1 == TRUE
+  if (I2CD1.active) {
+    return true;
+  }
+#endif
+
+  return false;
+}
+
+/**
+ * @brief   Adds a simulated slave to the bus.
+ * @details The registers file is accessed by the simulated transactions,
+ *          the application can access it directly in order to simulate
+ *          the device internal activity.
+ *
+ * @param[in] i2cp      pointer to the @p I2CDriver object
+ * @param[in] addr      slave device address
+ * @param[in] regs      pointer to the registers file
+ * @param[in] size      size of the registers file
+ *
+ * @api
+ */
+void i2cSimAddSlave(I2CDriver *i2cp, i2caddr_t addr,
+                    uint8_t *regs, size_t size) {
+  i2c_sim_slave_t *sp;
+
+  osalDbgCheck((i2cp != NULL) && (regs != NULL) && (size > 0U));
+
+  osalSysLock();
+  osalDbgAssert(i2cp->nslaves < (unsigned)SIM_I2C_MAX_SLAVES,
+                "too many slaves");
+  sp = &i2cp->slaves[i2cp->nslaves];
+  sp->addr = addr;
+  sp->regs = regs;
+  sp->size = size;
+  sp->ptr  = 0U;
+  i2cp->nslaves++;
+  osalSysUnlock();
+}
+
+#endif /* HAL_USE_I2C == TRUE */
+
+/** @} */
@@ -0,0 +1,257 @@
+/*
+    ChibiOS - Copyright (C) 2006..2018 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+/**
+ * @file    simulator/posix/hal_i2c_lld.h
+ * @brief   Posix simulator low level I2C driver header.
+ *
+ * @addtogroup POSIX_I2C
+ * @{
+ */
+
+#ifndef HAL_I2C_LLD_H
+#define HAL_I2C_LLD_H
+
+#if (HAL_USE_I2C == TRUE) || defined(__DOXYGEN__)
+
+/*===========================================================================*/
+/* Driver constants.                                                         */
+/*===========================================================================*/
+
+/**
+ * @brief   Asynchronous operations support.
+ */
+#define I2C_SUPPORTS_ASYNC          TRUE
+
+/**
+ * @brief   Register auto-increment bit in the sub-address.
+ * @details The simulated slaves always auto-increment, the bit is ignored.
+ */
+#define I2C_SIM_SUB_MS              0x80U
+
+/*===========================================================================*/
+/* Driver pre-compile time settings.                                         */
+/*===========================================================================*/
+
+/**
+ * @brief   I2CD1 driver enable switch.
+ * @details If set to @p TRUE the support for I2CD1 is included.
+ * @note    The default is @p TRUE.
+ */
+#if !defined(USE_SIM_I2C1) || defined(__DOXYGEN__)
+#define USE_SIM_I2C1                        TRUE
+#endif
+
+/**
+ * @brief   Maximum number of simulated slaves on a bus.
+ */
+#if !defined(SIM_I2C_MAX_SLAVES) || defined(__DOXYGEN__)
+#define SIM_I2C_MAX_SLAVES                  4
+#endif
+
+/*===========================================================================*/
+/* Derived constants and error checks.                                       */
+/*===========================================================================*/
+
+#if SIM_I2C_MAX_SLAVES < 1
+#error "invalid SIM_I2C_MAX_SLAVES value"
+#endif
+
+/*===========================================================================*/
+/* Driver data structures and types.                                         */
+/*===========================================================================*/
+
+/**
+ * @brief   Type representing an I2C address.
+ */
+typedef uint16_t i2caddr_t;
+
+/**
+ * @brief   Type of I2C Driver condition flags.
+ */
+typedef uint32_t i2cflags_t;
+
+/**
+ * @brief   Type of I2C driver configuration structure.
+ */
+typedef struct {
+  /**
+   * @brief   Simulated bus clock in Hz.
+   * @details Each transferred byte takes nine bit times.
+   */
+  uint32_t                  clock_speed;
+} I2CConfig;
+
+/**
+ * @brief   Simulated slave device.
+ * @details The slave is a registers file, the first written byte of a
+ *          transaction selects the register, the following bytes are
+ *          written or read at increasing register addresses wrapping at
+ *          the end of the file.
+ */
+typedef struct {
+  /**
+   * @brief   Slave address.
+   */
+  i2caddr_t                 addr;
+  /**
+   * @brief   Registers file.
+   */
+  uint8_t                   *regs;
+  /**
+   * @brief   Registers file size.
+   */
+  size_t                    size;
+  /**
+   * @brief   Current register.
+   */
+  size_t                    ptr;
+} i2c_sim_slave_t;
+
+/**
+ * @brief   Type of a structure representing an I2C driver.
+ */
+typedef struct I2CDriver I2CDriver;
+
+/**
+ * @brief   Structure representing an I2C driver.
+ */
+struct I2CDriver {
+  /**
+   * @brief   Driver state.
+   */
+  i2cstate_t                state;
+  /**
+   * @brief   Current configuration data.
+   */
+  const I2CConfig           *config;
+  /**
+   * @brief   Error flags.
+   */
+  i2cflags_t                errors;
+#if (I2C_USE_MUTUAL_EXCLUSION == TRUE) || defined(__DOXYGEN__)
+  mutex_t                   mutex;
+#endif
+  /**
+   * @brief   Asynchronous operation end callback or @p NULL.
+   */
+  i2ccallback_t             callback;
+  /**
+   * @brief   Pointer for the callback owner, not used by the driver.
+   */
+  void                      *arg;
+#if defined(I2C_DRIVER_EXT_FIELDS)
+  I2C_DRIVER_EXT_FIELDS
+#endif
+  /* End of the mandatory fields.*/
+  /**
+   * @brief   Thread waiting for I/O completion.
+   */
+  thread_reference_t        thread;
+  /**
+   * @brief   Simulated slaves.
+   */
+  i2c_sim_slave_t           slaves[SIM_I2C_MAX_SLAVES];
+  /**
+   * @brief   Number of simulated slaves.
+   */
+  unsigned                  nslaves;
+  /**
+   * @brief   Transaction in progress.
+   */
+  bool                      active;
+  /**
+   * @brief   Completion time of the transaction in progress.
+   */
+  uint64_t                  deadline;
+  /**
+   * @brief   Slave address of the transaction in progress.
+   */
+  i2caddr_t                 addr;
+  /**
+   * @brief   Transmit buffer of the transaction in progress.
+   */
+  const uint8_t             *txbuf;
+  /**
+   * @brief   Number of bytes to be transmitted.
+   */
+  size_t                    txbytes;
+  /**
+   * @brief   Receive buffer of the transaction in progress.
+   */
+  uint8_t                   *rxbuf;
+  /**
+   * @brief   Number of bytes to be received.
+   */
+  size_t                    rxbytes;
+  /**
+   * @brief   Completed transactions.
+   */
+  uint32_t                  transactions;
+};
+
+/*===========================================================================*/
+/* Driver macros.                                                            */
+/*===========================================================================*/
+
+/**
+ * @brief   Get errors from I2C driver.
+ *
+ * @param[in] i2cp      pointer to the @p I2CDriver object
+ *
+ * @notapi
+ */
+#define i2c_lld_get_errors(i2cp) ((i2cp)->errors)
+
+/*===========================================================================*/
+/* External declarations.                                                    */
+/*===========================================================================*/
+
+#if (USE_SIM_I2C1 == TRUE) && !defined(__DOXYGEN__)
+extern I2CDriver I2CD1;
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+  void i2c_lld_init(void);
+  void i2c_lld_start(I2CDriver *i2cp);
+  void i2c_lld_stop(I2CDriver *i2cp);
+  msg_t i2c_lld_master_transmit_timeout(I2CDriver *i2cp, i2caddr_t addr,
+                                        const uint8_t *txbuf, size_t txbytes,
+                                        uint8_t *rxbuf, size_t rxbytes,
+                                        sysinterval_t timeout);
+  msg_t i2c_lld_master_receive_timeout(I2CDriver *i2cp, i2caddr_t addr,
+                                       uint8_t *rxbuf, size_t rxbytes,
+                                       sysinterval_t timeout);
+  void i2c_lld_master_start_transmit(I2CDriver *i2cp, i2caddr_t addr,
+                                     const uint8_t *txbuf, size_t txbytes,
+                                     uint8_t *rxbuf, size_t rxbytes);
+  void i2c_lld_master_start_receive(I2CDriver *i2cp, i2caddr_t addr,
+                                    uint8_t *rxbuf, size_t rxbytes);
+  bool i2c_lld_interrupt_pending(void);
+  bool i2c_lld_is_busy(void);
+  void i2cSimAddSlave(I2CDriver *i2cp, i2caddr_t addr,
+                      uint8_t *regs, size_t size);
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* HAL_USE_I2C == TRUE */
+
+#endif /* HAL_I2C_LLD_H */
+
+/** @} */
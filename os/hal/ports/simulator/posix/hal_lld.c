@@ -24,7 +24,13 @@
 
 #include <stdio.h>
 #include <stdlib.h>
-#include <sys/time.h>
+#include <time.h>
+#include <poll.h>
+#if defined(__linux__)
+#include <signal.h>
+#include <sys/timerfd.h>
+#include <sys/signalfd.h>
+#endif
 
 #include "hal.h"
 
@@ -36,13 +42,44 @@
 /* Driver local variables and types.                                         */
 /*===========================================================================*/
 
-static struct timeval nextcnt;
-static struct timeval tick = {0UL, 1000000UL / OSAL_ST_FREQUENCY};
+#if OSAL_ST_MODE == OSAL_ST_MODE_PERIODIC
+static uint64_t nextcnt;
+#endif
+
+#if defined(__linux__)
+/**
+ * @brief   Timer descriptor used for sleeping until the next timer event.
+ */
+static int timer_fd = -1;
+
+/**
+ * @brief   Signal descriptor for the termination signals.
+ */
+static int signal_fd = -1;
+#endif
 
 /*===========================================================================*/
 /* Driver local functions.                                                   */
 /*===========================================================================*/
 
+#if defined(__linux__) || defined(__DOXYGEN__)
+/**
+ * @brief   Handles pending termination signals.
+ * @details The termination signals are blocked and received through a
+ *          signal descriptor, this way a simulator sleeping in the idle
+ *          loop terminates with a regular @p exit() and the buffered
+ *          output is not lost.
+ */
+static void sim_check_for_signals(void) {
+  struct signalfd_siginfo si;
+
+  if (read(signal_fd, &si, sizeof (si)) == (ssize_t)sizeof (si)) {
+    printf("\nSimulator terminated by signal %u\n", (unsigned)si.ssi_signo);
+    exit(128 + (int)si.ssi_signo);
+  }
+}
+#endif
+
 /*===========================================================================*/
 /* Driver interrupt handlers.                                                */
 /*===========================================================================*/
@@ -61,15 +98,51 @@ void hal_lld_init(void) {
 #else
   puts("ChibiOS/RT simulator (Linux)\n");
 #endif
-  gettimeofday(&nextcnt, NULL);
-  timeradd(&nextcnt, &tick, &nextcnt);
+
+#if defined(__linux__)
+  {
+    sigset_t set;
+
+    timer_fd = timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
+    if (timer_fd == -1) {
+      puts("Error creating timer descriptor");
+      exit(1);
+    }
+
+    sigemptyset(&set);
+    sigaddset(&set, SIGINT);
+    sigaddset(&set, SIGTERM);
+    sigaddset(&set, SIGHUP);
+    sigprocmask(SIG_BLOCK, &set, NULL);
+    signal_fd = signalfd(-1, &set, SFD_NONBLOCK | SFD_CLOEXEC);
+    if (signal_fd == -1) {
+      puts("Error creating signal descriptor");
+      exit(1);
+    }
+  }
+#endif
+
+#if OSAL_ST_MODE == OSAL_ST_MODE_PERIODIC
+  nextcnt = _sim_get_time_ns() + (1000000000ULL / OSAL_ST_FREQUENCY);
+#endif
+}
+
+/**
+ * @brief   Returns the host monotonic time.
+ *
+ * @return              The host time in nanoseconds.
+ */
+uint64_t _sim_get_time_ns(void) {
+  struct timespec ts;
+
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ((uint64_t)ts.tv_sec * 1000000000ULL) + (uint64_t)ts.tv_nsec;
 }
 
 /**
  * @brief   Interrupt simulation.
  */
 void _sim_check_for_interrupts(void) {
-  struct timeval tv;
   bool int_occurred = false;
 
 #if HAL_USE_SERIAL
@@ -78,10 +151,34 @@ void _sim_check_for_interrupts(void) {
   }
 #endif
 
-  gettimeofday(&tv, NULL);
-  if (timercmp(&tv, &nextcnt, >=)) {
+#if HAL_USE_SIO
+  if (sio_lld_interrupt_pending()) {
+    int_occurred = true;
+  }
+#endif
+
+#if HAL_USE_CAN
+  if (can_lld_interrupt_pending()) {
+    int_occurred = true;
+  }
+#endif
+
+#if HAL_USE_I2C
+  if (i2c_lld_interrupt_pending()) {
+    int_occurred = true;
+  }
+#endif
+
+#if HAL_USE_SPI
+  if (spi_lld_interrupt_pending()) {
+    int_occurred = true;
+  }
+#endif
+
+#if OSAL_ST_MODE == OSAL_ST_MODE_PERIODIC
+  if (_sim_get_time_ns() >= nextcnt) {
     int_occurred = true;
-    timeradd(&nextcnt, &tick, &nextcnt);
+    nextcnt += 1000000000ULL / OSAL_ST_FREQUENCY;
 
     CH_IRQ_PROLOGUE();
 
@@ -91,8 +188,16 @@ void _sim_check_for_interrupts(void) {
 
     CH_IRQ_EPILOGUE();
   }
+#elif OSAL_ST_MODE == OSAL_ST_MODE_FREERUNNING
+  if (st_lld_serve_interrupt()) {
+    int_occurred = true;
+  }
+#endif
 
   if (int_occurred) {
+#if defined(__linux__)
+    sim_check_for_signals();
+#endif
     _dbg_check_lock();
     if (chSchIsPreemptionRequired())
       chSchDoReschedule();
@@ -100,4 +205,109 @@ void _sim_check_for_interrupts(void) {
   }
 }
 
+/**
+ * @brief   Interrupt waiting simulation.
+ * @details The simulator process sleeps until the next timer event, until
+ *          a simulated peripheral has an I/O event or until a termination
+ *          signal is received, pending interrupts are then served. The
+ *          process does not sleep while a simulated SIO line, CAN, I2C or
+ *          SPI bus is busy.
+ */
+void _sim_wait_for_interrupts(void) {
+  struct pollfd fds[4];
+  nfds_t n = 0;
+  uint64_t deadline;
+  bool timed;
+
+#if HAL_USE_SIO
+  /* Frames in transit on a simulated line, no sleeping.*/
+  if (sio_lld_is_busy()) {
+    _sim_check_for_interrupts();
+    return;
+  }
+#endif
+
+#if HAL_USE_CAN
+  /* Frames in transit on a simulated bus, no sleeping.*/
+  if (can_lld_is_busy()) {
+    _sim_check_for_interrupts();
+    return;
+  }
+#endif
+
+#if HAL_USE_I2C
+  /* Transaction in progress on a simulated bus, no sleeping.*/
+  if (i2c_lld_is_busy()) {
+    _sim_check_for_interrupts();
+    return;
+  }
+#endif
+
+#if HAL_USE_SPI
+  /* Transfer in progress on a simulated bus, no sleeping.*/
+  if (spi_lld_is_busy()) {
+    _sim_check_for_interrupts();
+    return;
+  }
+#endif
+
+#if OSAL_ST_MODE == OSAL_ST_MODE_PERIODIC
+  deadline = nextcnt;
+  timed = true;
+#elif OSAL_ST_MODE == OSAL_ST_MODE_FREERUNNING
+  timed = st_lld_get_deadline(&deadline);
+#else
+  deadline = 0ULL;
+  timed = false;
+#endif
+
+#if HAL_USE_SERIAL
+  n += sd_lld_get_pollfds(&fds[n]);
+#endif
+
+#if defined(__linux__)
+  {
+    struct itimerspec its = {{0, 0}, {0, 0}};
+    uint64_t expirations;
+
+    /* The timer is armed for the absolute deadline, an expired deadline
+       makes the descriptor immediately readable.*/
+    if (timed) {
+      its.it_value.tv_sec  = (time_t)(deadline / 1000000000ULL);
+      its.it_value.tv_nsec = (long)(deadline % 1000000000ULL);
+    }
+    timerfd_settime(timer_fd, TFD_TIMER_ABSTIME, &its, NULL);
+
+    fds[n].fd     = timer_fd;
+    fds[n].events = POLLIN;
+    n++;
+    fds[n].fd     = signal_fd;
+    fds[n].events = POLLIN;
+    n++;
+
+    (void)poll(fds, n, -1);
+
+    (void)read(timer_fd, &expirations, sizeof (expirations));
+    sim_check_for_signals();
+  }
+#else
+  {
+    int timeout = -1;
+
+    if (timed) {
+      uint64_t now = _sim_get_time_ns();
+
+      timeout = 0;
+      if (deadline > now) {
+        timeout = (int)((deadline - now + 999999ULL) / 1000000ULL);
+      }
+    }
+
+    (void)poll(fds, n, timeout);
+  }
+#endif
+
+  _sim_check_for_interrupts();
+}
+
 /** @} */
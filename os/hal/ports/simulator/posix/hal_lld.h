@@ -33,6 +33,7 @@
 #include <netdb.h>
 #include <unistd.h>
 #include <fcntl.h>
+#include <poll.h>
 #endif
 #include <stdio.h>
 
@@ -69,7 +70,9 @@
 extern "C" {
 #endif
   void hal_lld_init(void);
+  uint64_t _sim_get_time_ns(void);
   void _sim_check_for_interrupts(void);
+  void _sim_wait_for_interrupts(void);
 #ifdef __cplusplus
 }
 #endif
@@ -215,6 +215,29 @@ static bool outint(SerialDriver *sdp) {
   return false;
 }
 
+/**
+ * @brief   Fills the descriptor to be waited on for a driver.
+ *
+ * @param[in] sdp       pointer to a @p SerialDriver object
+ * @param[out] pfdp     pointer to the descriptor
+ */
+static void pollfd(SerialDriver *sdp, struct pollfd *pfdp) {
+
+  pfdp->revents = 0;
+  if (sdp->com_data != -1) {
+    pfdp->fd     = sdp->com_data;
+    pfdp->events = POLLIN;
+    if (!oqIsEmptyI(&sdp->oqueue)) {
+      pfdp->events |= POLLOUT;
+    }
+  }
+  else {
+    /* Waiting for a connection, a negative descriptor is ignored.*/
+    pfdp->fd     = sdp->com_listen;
+    pfdp->events = POLLIN;
+  }
+}
+
 /*===========================================================================*/
 /* Driver interrupt handlers.                                                */
 /*===========================================================================*/
@@ -293,6 +316,23 @@ bool sd_lld_interrupt_pending(void) {
   return b;
 }
 
+/**
+ * @brief   Returns the descriptors to be waited on for simulated interrupts.
+ * @details The descriptors become ready when a connection is pending, when
+ *          there is incoming data or when outgoing data can be sent.
+ *
+ * @param[out] pfdp     pointer to an array of @p SD_LLD_NUM_POLLFDS
+ *                      descriptors
+ * @return              The number of descriptors.
+ */
+unsigned sd_lld_get_pollfds(struct pollfd *pfdp) {
+
+  pollfd(&SD1, &pfdp[0]);
+  pollfd(&SD2, &pfdp[1]);
+
+  return SD_LLD_NUM_POLLFDS;
+}
+
 #endif /* HAL_USE_SERIAL */
 
 /** @} */
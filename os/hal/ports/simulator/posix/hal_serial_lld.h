@@ -72,6 +72,15 @@
 #define SIM_SD2_PORT                        29002
 #endif
 
+/*===========================================================================*/
+/* Derived constants and error checks.                                       */
+/*===========================================================================*/
+
+/**
+ * @brief   Number of descriptors returned by @p sd_lld_get_pollfds().
+ */
+#define SD_LLD_NUM_POLLFDS                  2U
+
 /*===========================================================================*/
 /* Unsupported event flags and custom events.                                */
 /*===========================================================================*/
@@ -132,6 +141,7 @@ extern "C" {
   void sd_lld_start(SerialDriver *sdp, const SerialConfig *config);
   void sd_lld_stop(SerialDriver *sdp);
   bool sd_lld_interrupt_pending(void);
+  unsigned sd_lld_get_pollfds(struct pollfd *pfdp);
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,337 @@
+/*
+    ChibiOS - Copyright (C) 2006..2018 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+/**
+ * @file    simulator/posix/hal_sio_lld.c
+ * @brief   Posix simulator low level SIO driver code.
+ * @details The simulated peripheral connects its TX line to its RX line,
+ *          the line is served when the simulated interrupts are checked.
+ *          Each time the TX FIFO content is moved into the RX FIFO, frames
+ *          not fitting in the RX FIFO are lost and an overrun error is
+ *          reported. The receive callback is invoked when the RX FIFO
+ *          reaches the threshold or, once, when no frames were received
+ *          since the previous check (idle line).
+ *
+ * @addtogroup POSIX_SIO
+ * @{
+ */
+
+#include "hal.h"
+
+#if (HAL_USE_SIO == TRUE) || defined(__DOXYGEN__)
+
+/*===========================================================================*/
+/* Driver exported variables.                                                */
+/*===========================================================================*/
+
+/** @brief SIO driver 1 identifier.*/
+#if (USE_SIM_SIO1 == TRUE) || defined(__DOXYGEN__)
+SIODriver SIOD1;
+#endif
+
+/*===========================================================================*/
+/* Driver local variables and types.                                         */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Driver local functions.                                                   */
+/*===========================================================================*/
+
+/**
+ * @brief   Serves the simulated line of a driver.
+ *
+ * @param[in] siop      pointer to the @p SIODriver object
+ * @return              The interrupt status.
+ * @retval false        if no callback has been invoked.
+ * @retval true         if at least one callback has been invoked.
+ */
+static bool serve(SIODriver *siop) {
+  const SIOConfig *config;
+  unsigned moved;
+  sioflags_t errors;
+  bool rxne, txend;
+
+  if (siop->state != SIO_READY) {
+    return false;
+  }
+  config = siop->config;
+
+  /* Line transfer.*/
+  osalSysLockFromISR();
+  moved = 0U;
+  errors = SIO_NO_ERROR;
+  while (siop->txcnt > 0U) {
+    uint8_t b = siop->txfifo[siop->txrd];
+
+    siop->txrd = (siop->txrd + 1U) % (unsigned)SIM_SIO_FIFO_SIZE;
+    siop->txcnt--;
+    if (siop->rxcnt < (unsigned)SIM_SIO_FIFO_SIZE) {
+      siop->rxfifo[(siop->rxrd + siop->rxcnt) % (unsigned)SIM_SIO_FIFO_SIZE] = b;
+      siop->rxcnt++;
+    }
+    else {
+      errors |= SIO_OVERRUN_ERROR;
+    }
+    moved++;
+  }
+  siop->flags |= errors;
+
+  /* Threshold and idle line conditions.*/
+  rxne = false;
+  if (moved > 0U) {
+    siop->rxidle = false;
+    rxne = siop->rxcnt >= (unsigned)SIM_SIO_RX_THRESHOLD;
+  }
+  else if ((siop->rxcnt > 0U) && !siop->rxidle) {
+    siop->rxidle = true;
+    rxne = true;
+  }
+  txend = (moved > 0U) && (siop->txcnt == 0U);
+  osalSysUnlockFromISR();
+
+  /* Callbacks, invoked as from an interrupt handler.*/
+  if ((errors != SIO_NO_ERROR) && (config->rxevt_cb != NULL)) {
+    config->rxevt_cb(siop, errors);
+  }
+  if (rxne && (config->rxne_cb != NULL)) {
+    config->rxne_cb(siop);
+  }
+  if ((moved > 0U) && (config->txnf_cb != NULL)) {
+    config->txnf_cb(siop);
+  }
+  if (txend && (config->txend_cb != NULL)) {
+    config->txend_cb(siop);
+  }
+
+  return (moved > 0U) || rxne;
+}
+
+/*===========================================================================*/
+/* Driver interrupt handlers.                                                */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Driver exported functions.                                                */
+/*===========================================================================*/
+
+/**
+ * @brief   Low level SIO driver initialization.
+ *
+ * @notapi
+ */
+void sio_lld_init(void) {
+
+#if USE_SIM_SIO1 == TRUE
+  sioObjectInit(&SIOD1);
+#endif
+}
+
+/**
+ * @brief   Configures and activates the SIO peripheral.
+ *
+ * @param[in] siop      pointer to the @p SIODriver object
+ *
+ * @notapi
+ */
+void sio_lld_start(SIODriver *siop) {
+
+  if (siop->state == SIO_STOP) {
+    siop->rxrd   = 0U;
+    siop->rxcnt  = 0U;
+    siop->txrd   = 0U;
+    siop->txcnt  = 0U;
+    siop->flags  = SIO_NO_ERROR;
+    siop->rxidle = true;
+  }
+}
+
+/**
+ * @brief   Deactivates the SIO peripheral.
+ *
+ * @param[in] siop      pointer to the @p SIODriver object
+ *
+ * @notapi
+ */
+void sio_lld_stop(SIODriver *siop) {
+
+  siop->rxcnt = 0U;
+  siop->txcnt = 0U;
+}
+
+/**
+ * @brief   Returns the pending error flags and clears them.
+ *
+ * @param[in] siop      pointer to the @p SIODriver object
+ * @return              The pending flags.
+ *
+ * @notapi
+ */
+sioflags_t sio_lld_get_flags(SIODriver *siop) {
+  sioflags_t flags = siop->flags;
+
+  siop->flags = SIO_NO_ERROR;
+
+  return flags;
+}
+
+/**
+ * @brief   Returns one frame from the RX FIFO.
+ * @note    If the FIFO is empty then the returned value is unpredictable.
+ *
+ * @param[in] siop      pointer to the @p SIODriver object
+ * @return              The frame from RX FIFO.
+ *
+ * @notapi
+ */
+uint8_t sio_lld_rx_get(SIODriver *siop) {
+  uint8_t b = siop->rxfifo[siop->rxrd];
+
+  if (siop->rxcnt > 0U) {
+    siop->rxrd = (siop->rxrd + 1U) % (unsigned)SIM_SIO_FIFO_SIZE;
+    siop->rxcnt--;
+  }
+
+  return b;
+}
+
+/**
+ * @brief   Pushes one frame into the TX FIFO.
+ * @note    If the FIFO is full then the frame is discarded.
+ *
+ * @param[in] siop      pointer to the @p SIODriver object
+ * @param[in] data      frame to be written
+ *
+ * @notapi
+ */
+void sio_lld_tx_put(SIODriver *siop, uint8_t data) {
+
+  (void) sio_lld_write(siop, &data, 1U);
+}
+
+/**
+ * @brief   Reads data from the RX FIFO.
+ *
+ * @param[in] siop      pointer to the @p SIODriver object
+ * @param[in] buffer    buffer for the received data
+ * @param[in] size      maximum number of frames to read
+ * @return              The number of received frames.
+ *
+ * @notapi
+ */
+size_t sio_lld_read(SIODriver *siop, void *buffer, size_t size) {
+  uint8_t *bp = (uint8_t *)buffer;
+  size_t n = 0U;
+
+  while ((n < size) && (siop->rxcnt > 0U)) {
+    bp[n++] = siop->rxfifo[siop->rxrd];
+    siop->rxrd = (siop->rxrd + 1U) % (unsigned)SIM_SIO_FIFO_SIZE;
+    siop->rxcnt--;
+  }
+
+  return n;
+}
+
+/**
+ * @brief   Writes data into the TX FIFO.
+ *
+ * @param[in] siop      pointer to the @p SIODriver object
+ * @param[out] buffer   buffer containing the data to be transmitted
+ * @param[in] size      maximum number of frames to write
+ * @return              The number of transmitted frames.
+ *
+ * @notapi
+ */
+size_t sio_lld_write(SIODriver *siop, const void *buffer, size_t size) {
+  const uint8_t *bp = (const uint8_t *)buffer;
+  size_t n = 0U;
+
+  while ((n < size) && (siop->txcnt < (unsigned)SIM_SIO_FIFO_SIZE)) {
+    siop->txfifo[(siop->txrd + siop->txcnt) % (unsigned)SIM_SIO_FIFO_SIZE] =
+        bp[n++];
+    siop->txcnt++;
+  }
+
+  return n;
+}
+
+/**
+ * @brief   Control operation on a serial port.
+ *
+ * @param[in] siop      pointer to the @p SIODriver object
+ * @param[in] operation control operation code
+ * @param[in,out] arg   operation argument
+ *
+ * @return              The control operation status.
+ * @retval MSG_OK       in case of success.
+ * @retval MSG_TIMEOUT  in case of operation timeout.
+ * @retval MSG_RESET    in case of operation reset.
+ *
+ * @notapi
+ */
+msg_t sio_lld_control(SIODriver *siop, unsigned int operation, void *arg) {
+
+  (void)siop;
+  (void)operation;
+  (void)arg;
+
+  return MSG_OK;
+}
+
+/**
+ * @brief   Serves the simulated interrupts.
+ *
+ * @return              The interrupt status.
+ * @retval false        if no interrupt has been served.
+ * @retval true         if at least one interrupt has been served.
+ */
+bool sio_lld_interrupt_pending(void) {
+  bool b = false;
+
+  OSAL_IRQ_PROLOGUE();
+
+#if USE_SIM_SIO1 == TRUE
+  b = serve(&SIOD1) || b;
+#endif
+
+  OSAL_IRQ_EPILOGUE();
+
+  return b;
+}
+
+/**
+ * @brief   Checks for line activity.
+ * @details The simulator must not sleep while frames are in transit or an
+ *          idle line condition has still to be notified.
+ *
+ * @return              The line status.
+ * @retval false        if all the drivers are quiet.
+ * @retval true         if an interrupt is going to happen.
+ */
+bool sio_lld_is_busy(void) {
+
+#if USE_SIM_SIO1 == TRUE
+  if ((SIOD1.state == SIO_READY) &&
+      ((SIOD1.txcnt > 0U) || ((SIOD1.rxcnt > 0U) && !SIOD1.rxidle))) {
+    return true;
+  }
+#endif
+
+  return false;
+}
+
+#endif /* HAL_USE_SIO == TRUE */
+
+/** @} */
@@ -0,0 +1,239 @@
+/*
+    ChibiOS - Copyright (C) 2006..2018 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+/**
+ * @file    simulator/posix/hal_sio_lld.h
+ * @brief   Posix simulator low level SIO driver header.
+ *
+ * @addtogroup POSIX_SIO
+ * @{
+ */
+
+#ifndef HAL_SIO_LLD_H
+#define HAL_SIO_LLD_H
+
+#if (HAL_USE_SIO == TRUE) || defined(__DOXYGEN__)
+
+/*===========================================================================*/
+/* Driver constants.                                                         */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Driver pre-compile time settings.                                         */
+/*===========================================================================*/
+
+/**
+ * @brief   SIOD1 driver enable switch.
+ * @details If set to @p TRUE the support for SIOD1 is included.
+ * @note    The default is @p TRUE.
+ */
+#if !defined(USE_SIM_SIO1) || defined(__DOXYGEN__)
+#define USE_SIM_SIO1                        TRUE
+#endif
+
+/**
+ * @brief   Size of the simulated RX and TX FIFOs.
+ */
+#if !defined(SIM_SIO_FIFO_SIZE) || defined(__DOXYGEN__)
+#define SIM_SIO_FIFO_SIZE                   16
+#endif
+
+/**
+ * @brief   RX FIFO threshold.
+ * @details The receive callback is invoked when the RX FIFO contains at
+ *          least this number of frames or when the line becomes idle.
+ */
+#if !defined(SIM_SIO_RX_THRESHOLD) || defined(__DOXYGEN__)
+#define SIM_SIO_RX_THRESHOLD                8
+#endif
+
+/*===========================================================================*/
+/* Derived constants and error checks.                                       */
+/*===========================================================================*/
+
+#if (SIM_SIO_RX_THRESHOLD < 1) ||                                           \
+    (SIM_SIO_RX_THRESHOLD > SIM_SIO_FIFO_SIZE)
+#error "invalid SIM_SIO_RX_THRESHOLD value"
+#endif
+
+/*===========================================================================*/
+/* Driver data structures and types.                                         */
+/*===========================================================================*/
+
+/**
+ * @brief   SIO driver condition flags type.
+ */
+typedef uint32_t sioflags_t;
+
+/**
+ * @brief   Generic SIO notification callback type.
+ *
+ * @param[in] siop     pointer to the @p SIODriver object
+ */
+typedef void (*siocb_t)(SIODriver *siop);
+
+/**
+ * @brief   Receive error SIO notification callback type.
+ *
+ * @param[in] siop     pointer to the @p SIODriver object triggering the
+ *                      callback
+ * @param[in] e         receive error mask
+ */
+typedef void (*sioecb_t)(SIODriver *siop, sioflags_t e);
+
+/**
+ * @brief   Driver configuration structure.
+ */
+struct hal_sio_config {
+  /**
+   * @brief   Receive buffer filled callback.
+   * @note    Can be @p NULL.
+   */
+  siocb_t                   rxne_cb;
+  /**
+   * @brief   End of transmission buffer callback.
+   * @note    Can be @p NULL.
+   */
+  siocb_t                   txnf_cb;
+  /**
+   * @brief   Physical end of transmission callback.
+   * @note    Can be @p NULL.
+   */
+  siocb_t                   txend_cb;
+  /**
+   * @brief   Receive event callback.
+   * @note    Can be @p NULL.
+   */
+  sioecb_t                  rxevt_cb;
+  /* End of the mandatory fields.*/
+};
+
+/**
+ * @brief   Structure representing a SIO driver.
+ * @details The simulated peripheral is a loopback, frames written in the
+ *          TX FIFO are received in the RX FIFO of the same driver.
+ */
+struct hal_sio_driver {
+  /**
+   * @brief Driver state.
+   */
+  siostate_t               state;
+  /**
+   * @brief Current configuration data.
+   */
+  const SIOConfig          *config;
+  /**
+   * @brief User argument, it can be retrieved from within the callbacks.
+   */
+  void                     *arg;
+#if defined(SIO_DRIVER_EXT_FIELDS)
+  SIO_DRIVER_EXT_FIELDS
+#endif
+  /* End of the mandatory fields.*/
+  /**
+   * @brief Simulated RX FIFO.
+   */
+  uint8_t                  rxfifo[SIM_SIO_FIFO_SIZE];
+  /**
+   * @brief RX FIFO read index.
+   */
+  unsigned                 rxrd;
+  /**
+   * @brief Frames in the RX FIFO.
+   */
+  unsigned                 rxcnt;
+  /**
+   * @brief Simulated TX FIFO.
+   */
+  uint8_t                  txfifo[SIM_SIO_FIFO_SIZE];
+  /**
+   * @brief TX FIFO read index.
+   */
+  unsigned                 txrd;
+  /**
+   * @brief Frames in the TX FIFO.
+   */
+  unsigned                 txcnt;
+  /**
+   * @brief Pending error flags.
+   */
+  sioflags_t               flags;
+  /**
+   * @brief The RX idle condition has already been notified.
+   */
+  bool                     rxidle;
+};
+
+/*===========================================================================*/
+/* Driver macros.                                                            */
+/*===========================================================================*/
+
+/**
+ * @brief   Determines the state of the RX FIFO.
+ *
+ * @param[in] siop      pointer to the @p SIODriver object
+ * @return              The RX FIFO state.
+ * @retval false        if RX FIFO is not empty
+ * @retval true         if RX FIFO is empty
+ *
+ * @notapi
+ */
+#define sio_lld_rx_is_empty(siop) ((bool)((siop)->rxcnt == 0U))
+
+/**
+ * @brief   Determines the state of the TX FIFO.
+ *
+ * @param[in] siop      pointer to the @p SIODriver object
+ * @return              The TX FIFO state.
+ * @retval false        if TX FIFO is not full
+ * @retval true         if TX FIFO is full
+ *
+ * @notapi
+ */
+#define sio_lld_tx_is_full(siop)                                            \
+  ((bool)((siop)->txcnt >= (unsigned)SIM_SIO_FIFO_SIZE))
+
+/*===========================================================================*/
+/* External declarations.                                                    */
+/*===========================================================================*/
+
+#if (USE_SIM_SIO1 == TRUE) && !defined(__DOXYGEN__)
+extern SIODriver SIOD1;
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+  void sio_lld_init(void);
+  void sio_lld_start(SIODriver *siop);
+  void sio_lld_stop(SIODriver *siop);
+  sioflags_t sio_lld_get_flags(SIODriver *siop);
+  uint8_t sio_lld_rx_get(SIODriver *siop);
+  void sio_lld_tx_put(SIODriver *siop, uint8_t data);
+  size_t sio_lld_read(SIODriver *siop, void *buffer, size_t size);
+  size_t sio_lld_write(SIODriver *siop, const void *buffer, size_t size);
+  msg_t sio_lld_control(SIODriver *siop, unsigned int operation, void *arg);
+  bool sio_lld_interrupt_pending(void);
+  bool sio_lld_is_busy(void);
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* HAL_USE_SIO == TRUE */
+
+#endif /* HAL_SIO_LLD_H */
+
+/** @} */
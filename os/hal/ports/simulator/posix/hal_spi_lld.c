@@ -0,0 +1,368 @@
+/*
+    ChibiOS - Copyright (C) 2006..2018 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+/**
+ * @file    simulator/posix/hal_spi_lld.c
+ * @brief   Posix simulator low level SPI driver code.
+ * @details The simulated bus hosts a registers file slave selected by the
+ *          chip select, a transfer is completed when the simulated
+ *          interrupts are checked after its bus time elapsed. Frames are
+ *          eight bits wide.
+ *
+ * @addtogroup POSIX_SPI
+ * @{
+ */
+
+#include "hal.h"
+
+#if (HAL_USE_SPI == TRUE) || defined(__DOXYGEN__)
+
+/*===========================================================================*/
+/* Driver local definitions.                                                 */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Driver exported variables.                                                */
+/*===========================================================================*/
+
+/** @brief SPI1 driver identifier.*/
+#if (USE_SIM_SPI1 == TRUE) || defined(__DOXYGEN__)
+SPIDriver SPID1;
+#endif
+
+/*===========================================================================*/
+/* Driver local variables and types.                                         */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Driver local functions.                                                   */
+/*===========================================================================*/
+
+/**
+ * @brief   Exchanges a frame with the simulated slave.
+ *
+ * @param[in] spip      pointer to the @p SPIDriver object
+ * @param[in] frame     frame sent by the master
+ * @return              The frame sent by the slave.
+ */
+static uint8_t slave_exchange(SPIDriver *spip, uint8_t frame) {
+  uint8_t r = 0xFFU;
+
+  if (!spip->selected || (spip->regs == NULL)) {
+    return r;
+  }
+
+  if (spip->command) {
+    spip->command = false;
+    spip->read    = (frame & SPI_SIM_CMD_READ) != 0U;
+    spip->ptr     = (size_t)(frame & ~SPI_SIM_CMD_READ) % spip->size;
+    return r;
+  }
+
+  if (spip->read) {
+    r = spip->regs[spip->ptr];
+  }
+  else {
+    spip->regs[spip->ptr] = frame;
+  }
+  spip->ptr = (spip->ptr + 1U) % spip->size;
+
+  return r;
+}
+
+/**
+ * @brief   Starts a simulated transfer.
+ *
+ * @param[in] spip      pointer to the @p SPIDriver object
+ * @param[in] n         number of frames
+ * @param[in] txbuf     pointer to the transmit buffer or @p NULL
+ * @param[out] rxbuf    pointer to the receive buffer or @p NULL
+ */
+static void start_transfer(SPIDriver *spip, size_t n,
+                           const void *txbuf, void *rxbuf) {
+
+  spip->n        = n;
+  spip->txbuf    = (const uint8_t *)txbuf;
+  spip->rxbuf    = (uint8_t *)rxbuf;
+  spip->deadline = _sim_get_time_ns() +
+                   (((uint64_t)n * 8000000000ULL) / spip->config->clock_speed);
+  spip->active   = true;
+}
+
+/**
+ * @brief   Serves the simulated bus of a driver.
+ *
+ * @param[in] spip      pointer to the @p SPIDriver object
+ * @return              The interrupt status.
+ * @retval false        if no event has been generated.
+ * @retval true         if a transfer has been completed.
+ */
+static bool serve(SPIDriver *spip) {
+  size_t i;
+
+  osalSysLockFromISR();
+  if (!spip->active || (_sim_get_time_ns() < spip->deadline)) {
+    osalSysUnlockFromISR();
+    return false;
+  }
+  spip->active = false;
+  spip->transfers++;
+
+  for (i = 0U; i < spip->n; i++) {
+    uint8_t r;
+
+    r = slave_exchange(spip, spip->txbuf != NULL ? spip->txbuf[i] : 0xFFU);
+    if (spip->rxbuf != NULL) {
+      spip->rxbuf[i] = r;
+    }
+  }
+  osalSysUnlockFromISR();
+
+  /* Events, generated as from an interrupt handler.*/
+  _spi_isr_code(spip);
+
+  return true;
+}
+
+/*===========================================================================*/
+/* Driver interrupt handlers.                                                */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Driver exported functions.                                                */
+/*===========================================================================*/
+
+/**
+ * @brief   Low level SPI driver initialization.
+ *
+ * @notapi
+ */
+void spi_lld_init(void) {
+
+#if USE_SIM_SPI1 == TRUE
+  spiObjectInit(&SPID1);
+  SPID1.regs     = NULL;
+  SPID1.size     = 0U;
+  SPID1.selected = false;
+  SPID1.active   = false;
+#endif
+}
+
+/**
+ * @brief   Configures and activates the SPI peripheral.
+ *
+ * @param[in] spip      pointer to the @p SPIDriver object
+ *
+ * @notapi
+ */
+void spi_lld_start(SPIDriver *spip) {
+
+  osalDbgAssert(spip->config->clock_speed > 0U, "invalid clock");
+
+  spip->selected  = false;
+  spip->active    = false;
+  spip->transfers = 0U;
+}
+
+/**
+ * @brief   Deactivates the SPI peripheral.
+ *
+ * @param[in] spip      pointer to the @p SPIDriver object
+ *
+ * @notapi
+ */
+void spi_lld_stop(SPIDriver *spip) {
+
+  spip->selected = false;
+  spip->active   = false;
+}
+
+/**
+ * @brief   Asserts the slave select signal and prepares for transfers.
+ *
+ * @param[in] spip      pointer to the @p SPIDriver object
+ *
+ * @notapi
+ */
+void spi_lld_select(SPIDriver *spip) {
+
+  spip->selected = true;
+  spip->command  = true;
+}
+
+/**
+ * @brief   Deasserts the slave select signal.
+ * @details The previously selected peripheral is unselected.
+ *
+ * @param[in] spip      pointer to the @p SPIDriver object
+ *
+ * @notapi
+ */
+void spi_lld_unselect(SPIDriver *spip) {
+
+  spip->selected = false;
+}
+
+/**
+ * @brief   Ignores data on the SPI bus.
+ * @details This asynchronous function starts the transmission of a series of
+ *          idle words on the SPI bus and ignores the received data.
+ * @post    At the end of the operation the configured callback is invoked.
+ *
+ * @param[in] spip      pointer to the @p SPIDriver object
+ * @param[in] n         number of words to be ignored
+ *
+ * @notapi
+ */
+void spi_lld_ignore(SPIDriver *spip, size_t n) {
+
+  start_transfer(spip, n, NULL, NULL);
+}
+
+/**
+ * @brief   Exchanges data on the SPI bus.
+ * @details This asynchronous function starts a simultaneous transmit/receive
+ *          operation.
+ * @post    At the end of the operation the configured callback is invoked.
+ *
+ * @param[in] spip      pointer to the @p SPIDriver object
+ * @param[in] n         number of words to be exchanged
+ * @param[in] txbuf     the pointer to the transmit buffer
+ * @param[out] rxbuf    the pointer to the receive buffer
+ *
+ * @notapi
+ */
+void spi_lld_exchange(SPIDriver *spip, size_t n,
+                      const void *txbuf, void *rxbuf) {
+
+  start_transfer(spip, n, txbuf, rxbuf);
+}
+
+/**
+ * @brief   Sends data over the SPI bus.
+ * @details This asynchronous function starts a transmit operation.
+ * @post    At the end of the operation the configured callback is invoked.
+ *
+ * @param[in] spip      pointer to the @p SPIDriver object
+ * @param[in] n         number of words to send
+ * @param[in] txbuf     the pointer to the transmit buffer
+ *
+ * @notapi
+ */
+void spi_lld_send(SPIDriver *spip, size_t n, const void *txbuf) {
+
+  start_transfer(spip, n, txbuf, NULL);
+}
+
+/**
+ * @brief   Receives data from the SPI bus.
+ * @details This asynchronous function starts a receive operation.
+ * @post    At the end of the operation the configured callback is invoked.
+ *
+ * @param[in] spip      pointer to the @p SPIDriver object
+ * @param[in] n         number of words to receive
+ * @param[out] rxbuf    the pointer to the receive buffer
+ *
+ * @notapi
+ */
+void spi_lld_receive(SPIDriver *spip, size_t n, void *rxbuf) {
+
+  start_transfer(spip, n, NULL, rxbuf);
+}
+
+/**
+ * @brief   Exchanges one frame using a polled wait.
+ * @details This synchronous function exchanges one frame using a polled
+ *          synchronization method. This function is useful when exchanging
+ *          small amount of data on high speed channels, usually in this
+ *          situation is much more efficient just wait for completion using
+ *          polling than suspending the thread waiting for an interrupt.
+ *
+ * @param[in] spip      pointer to the @p SPIDriver object
+ * @param[in] frame     the data frame to send over the SPI bus
+ * @return              The received data frame from the SPI bus.
+ */
+uint16_t spi_lld_polled_exchange(SPIDriver *spip, uint16_t frame) {
+
+  return (uint16_t)slave_exchange(spip, (uint8_t)frame);
+}
+
+/**
+ * @brief   Serves the simulated interrupts.
+ *
+ * @return              The interrupt status.
+ * @retval false        if no interrupt has been served.
+ * @retval true         if at least one interrupt has been served.
+ */
+bool spi_lld_interrupt_pending(void) {
+  bool b = false;
+
+  OSAL_IRQ_PROLOGUE();
+
+#if USE_SIM_SPI1 == TRUE
+  b = serve(&SPID1) || b;
+#endif
+
+  OSAL_IRQ_EPILOGUE();
+
+  return b;
+}
+
+/**
+ * @brief   Checks for bus activity.
+ * @details The simulator must not sleep while a transfer is in progress.
+ *
+ * @return              The bus status.
+ * @retval false        if all the drivers are quiet.
+ * @retval true         if an interrupt is going to happen.
+ */
+bool spi_lld_is_busy(void) {
+
+#if USE_SIM_SPI1 == TRUE
+  if (SPID1.active) {
+    return true;
+  }
+#endif
+
+  return false;
+}
+
+/**
+ * @brief   Attaches the simulated slave to the bus.
+ * @details The registers file is accessed by the simulated transfers,
+ *          the application can access it directly in order to simulate
+ *          the device internal activity.
+ *
+ * @param[in] spip      pointer to the @p SPIDriver object
+ * @param[in] regs      pointer to the registers file
+ * @param[in] size      size of the registers file
+ *
+ * @api
+ */
+void spiSimSetSlave(SPIDriver *spip, uint8_t *regs, size_t size) {
+
+  osalDbgCheck((spip != NULL) && (regs != NULL) && (size > 0U));
+
+  osalSysLock();
+  spip->regs = regs;
+  spip->size = size;
+  spip->ptr  = 0U;
+  osalSysUnlock();
+}
+
+#endif /* HAL_USE_SPI == TRUE */
+
+/** @} */
@@ -0,0 +1,147 @@
+/*
+    ChibiOS - Copyright (C) 2006..2018 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+/**
+ * @file    simulator/posix/hal_spi_lld.h
+ * @brief   Posix simulator low level SPI driver header.
+ *
+ * @addtogroup POSIX_SPI
+ * @{
+ */
+
+#ifndef HAL_SPI_LLD_H
+#define HAL_SPI_LLD_H
+
+#if (HAL_USE_SPI == TRUE) || defined(__DOXYGEN__)
+
+/*===========================================================================*/
+/* Driver constants.                                                         */
+/*===========================================================================*/
+
+/**
+ * @brief   Circular mode support flag.
+ */
+#define SPI_SUPPORTS_CIRCULAR           FALSE
+
+/**
+ * @brief   Read bit in the command byte.
+ */
+#define SPI_SIM_CMD_READ                0x80U
+
+/*===========================================================================*/
+/* Driver pre-compile time settings.                                         */
+/*===========================================================================*/
+
+/**
+ * @brief   SPID1 driver enable switch.
+ * @details If set to @p TRUE the support for SPID1 is included.
+ * @note    The default is @p TRUE.
+ */
+#if !defined(USE_SIM_SPI1) || defined(__DOXYGEN__)
+#define USE_SIM_SPI1                    TRUE
+#endif
+
+/*===========================================================================*/
+/* Derived constants and error checks.                                       */
+/*===========================================================================*/
+
+#if SPI_SELECT_MODE != SPI_SELECT_MODE_LLD
+#error "the simulated SPI requires SPI_SELECT_MODE_LLD"
+#endif
+
+/*===========================================================================*/
+/* Driver data structures and types.                                         */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Driver macros.                                                            */
+/*===========================================================================*/
+
+/**
+ * @brief   Low level fields of the SPI driver structure.
+ * @details The simulated slave is a registers file, the first byte after
+ *          the chip select assertion is a command carrying the read bit
+ *          and the register address, the following bytes are written or
+ *          read at increasing register addresses wrapping at the end of
+ *          the file.
+ */
+#define spi_lld_driver_fields                                               \
+  /* Simulated slave registers file.*/                                      \
+  uint8_t                   *regs;                                          \
+  /* Registers file size.*/                                                 \
+  size_t                    size;                                           \
+  /* Current register.*/                                                    \
+  size_t                    ptr;                                            \
+  /* Chip select asserted.*/                                                \
+  bool                      selected;                                       \
+  /* Next byte is a command.*/                                              \
+  bool                      command;                                        \
+  /* Read command in progress.*/                                            \
+  bool                      read;                                           \
+  /* Transfer in progress.*/                                                \
+  bool                      active;                                         \
+  /* Completion time of the transfer in progress.*/                         \
+  uint64_t                  deadline;                                       \
+  /* Number of frames of the transfer in progress.*/                        \
+  size_t                    n;                                              \
+  /* Transmit buffer or NULL.*/                                             \
+  const uint8_t             *txbuf;                                         \
+  /* Receive buffer or NULL.*/                                              \
+  uint8_t                   *rxbuf;                                         \
+  /* Completed transfers.*/                                                 \
+  uint32_t                  transfers
+
+/**
+ * @brief   Low level fields of the SPI configuration structure.
+ */
+#define spi_lld_config_fields                                               \
+  /* Simulated bus clock in Hz.*/                                           \
+  uint32_t                  clock_speed
+
+/*===========================================================================*/
+/* External declarations.                                                    */
+/*===========================================================================*/
+
+#if (USE_SIM_SPI1 == TRUE) && !defined(__DOXYGEN__)
+extern SPIDriver SPID1;
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+  void spi_lld_init(void);
+  void spi_lld_start(SPIDriver *spip);
+  void spi_lld_stop(SPIDriver *spip);
+  void spi_lld_select(SPIDriver *spip);
+  void spi_lld_unselect(SPIDriver *spip);
+  void spi_lld_ignore(SPIDriver *spip, size_t n);
+  void spi_lld_exchange(SPIDriver *spip, size_t n,
+                        const void *txbuf, void *rxbuf);
+  void spi_lld_send(SPIDriver *spip, size_t n, const void *txbuf);
+  void spi_lld_receive(SPIDriver *spip, size_t n, void *rxbuf);
+  uint16_t spi_lld_polled_exchange(SPIDriver *spip, uint16_t frame);
+  bool spi_lld_interrupt_pending(void);
+  bool spi_lld_is_busy(void);
+  void spiSimSetSlave(SPIDriver *spip, uint8_t *regs, size_t size);
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* HAL_USE_SPI == TRUE */
+
+#endif /* HAL_SPI_LLD_H */
+
+/** @} */
@@ -24,6 +24,10 @@
 
 #include "hal.h"
 
+#if OSAL_ST_MODE == OSAL_ST_MODE_FREERUNNING
+#error "tick-less mode not supported by the Win32 simulator"
+#endif
+
 /*===========================================================================*/
 /* Driver exported variables.                                                */
 /*===========================================================================*/
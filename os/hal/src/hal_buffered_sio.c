@@ -0,0 +1,374 @@
+/*
+    ChibiOS - Copyright (C) 2006..2018 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+/**
+ * @file    hal_buffered_sio.c
+ * @brief   Buffered SIO Driver code.
+ *
+ * @addtogroup BUFFERED_SIO
+ * @details Serial channel built on top of a @p SIODriver.
+ *          The SIO low level driver invokes the receive callback when the
+ *          RX FIFO reaches its threshold or when the line becomes idle, the
+ *          whole FIFO content is then moved into the input queue. The
+ *          transmit callback refills the TX FIFO from the output queue as
+ *          far as the FIFO accepts data. In both directions the data is
+ *          copied directly between the FIFO and the queue buffer.
+ * @{
+ */
+
+#include "hal.h"
+
+#if (HAL_USE_SIO == TRUE) || defined(__DOXYGEN__)
+
+/*===========================================================================*/
+/* Driver local definitions.                                                 */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Driver exported variables.                                                */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Driver local variables and types.                                         */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Driver local functions.                                                   */
+/*===========================================================================*/
+
+/**
+ * @brief   Moves the RX FIFO content into the input queue.
+ * @note    If the input queue is full then the remaining FIFO content is
+ *          discarded and the @p BSIO_QUEUE_FULL_ERROR flag is broadcasted.
+ *
+ * @param[in] bsiop     pointer to the @p BufferedSIODriver object
+ *
+ * @notapi
+ */
+static void bsio_pop_rx(BufferedSIODriver *bsiop) {
+  SIODriver *siop = bsiop->siop;
+  eventflags_t flags = CHN_NO_ERROR;
+
+  if (iqIsEmptyI(&bsiop->iqueue) && !sioRXIsEmptyX(siop)) {
+    flags |= CHN_INPUT_AVAILABLE;
+  }
+
+  while (!sioRXIsEmptyX(siop)) {
+    uint8_t *bp;
+    size_t n;
+
+    bp = iqGetEmptyAreaI(&bsiop->iqueue, &n);
+    if (n == (size_t)0) {
+      /* Queue full, the data has nowhere to go.*/
+      do {
+        (void) sioRXGetX(siop);
+      } while (!sioRXIsEmptyX(siop));
+      flags |= BSIO_QUEUE_FULL_ERROR;
+      break;
+    }
+    iqPostFullAreaI(&bsiop->iqueue, sioReadX(siop, bp, n));
+  }
+
+  if (flags != CHN_NO_ERROR) {
+    chnAddFlagsI(bsiop, flags);
+  }
+}
+
+/**
+ * @brief   Moves data from the output queue into the TX FIFO.
+ *
+ * @param[in] bsiop     pointer to the @p BufferedSIODriver object
+ *
+ * @notapi
+ */
+static void bsio_push_tx(BufferedSIODriver *bsiop) {
+  SIODriver *siop = bsiop->siop;
+
+  while (!sioTXIsFullX(siop)) {
+    uint8_t *bp;
+    size_t n, done;
+
+    bp = oqGetFullAreaI(&bsiop->oqueue, &n);
+    if (n == (size_t)0) {
+      break;
+    }
+    done = sioWriteX(siop, bp, n);
+    oqReleaseEmptyAreaI(&bsiop->oqueue, done);
+    if (done < n) {
+      break;
+    }
+  }
+}
+
+/*
+ * SIO callbacks, invoked from the SIO interrupt handlers.
+ */
+
+static void bsio_rxne_cb(SIODriver *siop) {
+  BufferedSIODriver *bsiop = (BufferedSIODriver *)siop->arg;
+
+  osalSysLockFromISR();
+  bsio_pop_rx(bsiop);
+  osalSysUnlockFromISR();
+}
+
+static void bsio_txnf_cb(SIODriver *siop) {
+  BufferedSIODriver *bsiop = (BufferedSIODriver *)siop->arg;
+
+  osalSysLockFromISR();
+  if (oqIsEmptyI(&bsiop->oqueue)) {
+    chnAddFlagsI(bsiop, CHN_OUTPUT_EMPTY);
+  }
+  else {
+    bsio_push_tx(bsiop);
+  }
+  osalSysUnlockFromISR();
+}
+
+static void bsio_txend_cb(SIODriver *siop) {
+  BufferedSIODriver *bsiop = (BufferedSIODriver *)siop->arg;
+
+  osalSysLockFromISR();
+  if (oqIsEmptyI(&bsiop->oqueue)) {
+    chnAddFlagsI(bsiop, CHN_TRANSMISSION_END);
+  }
+  osalSysUnlockFromISR();
+}
+
+static void bsio_rxevt_cb(SIODriver *siop, sioflags_t e) {
+  BufferedSIODriver *bsiop = (BufferedSIODriver *)siop->arg;
+  eventflags_t flags = CHN_NO_ERROR;
+
+  if ((e & SIO_PARITY_ERROR) != 0U) {
+    flags |= BSIO_PARITY_ERROR;
+  }
+  if ((e & SIO_FRAMING_ERROR) != 0U) {
+    flags |= BSIO_FRAMING_ERROR;
+  }
+  if ((e & SIO_OVERRUN_ERROR) != 0U) {
+    flags |= BSIO_OVERRUN_ERROR;
+  }
+  if ((e & SIO_NOISE_ERROR) != 0U) {
+    flags |= BSIO_NOISE_ERROR;
+  }
+  if ((e & SIO_BREAK_DETECTED) != 0U) {
+    flags |= BSIO_BREAK_DETECTED;
+  }
+
+  osalSysLockFromISR();
+  /* Data received before the event is not left behind.*/
+  bsio_pop_rx(bsiop);
+  if (flags != CHN_NO_ERROR) {
+    chnAddFlagsI(bsiop, flags);
+  }
+  osalSysUnlockFromISR();
+}
+
+/*
+ * Output queue notification, the transmission is started if the TX FIFO
+ * has space.
+ */
+static void bsio_onotify(io_queue_t *qp) {
+  BufferedSIODriver *bsiop = (BufferedSIODriver *)qGetLink(qp);
+
+  if (bsiop->state == BSIO_READY) {
+    bsio_push_tx(bsiop);
+  }
+}
+
+/*
+ * Interface implementation, the following functions just invoke the equivalent
+ * queue-level function or macro.
+ */
+
+static size_t _write(void *ip, const uint8_t *bp, size_t n) {
+
+  return oqWriteTimeout(&((BufferedSIODriver *)ip)->oqueue, bp,
+                        n, TIME_INFINITE);
+}
+
+static size_t _read(void *ip, uint8_t *bp, size_t n) {
+
+  return iqReadTimeout(&((BufferedSIODriver *)ip)->iqueue, bp,
+                       n, TIME_INFINITE);
+}
+
+static msg_t _put(void *ip, uint8_t b) {
+
+  return oqPutTimeout(&((BufferedSIODriver *)ip)->oqueue, b, TIME_INFINITE);
+}
+
+static msg_t _get(void *ip) {
+
+  return iqGetTimeout(&((BufferedSIODriver *)ip)->iqueue, TIME_INFINITE);
+}
+
+static msg_t _putt(void *ip, uint8_t b, sysinterval_t timeout) {
+
+  return oqPutTimeout(&((BufferedSIODriver *)ip)->oqueue, b, timeout);
+}
+
+static msg_t _gett(void *ip, sysinterval_t timeout) {
+
+  return iqGetTimeout(&((BufferedSIODriver *)ip)->iqueue, timeout);
+}
+
+static size_t _writet(void *ip, const uint8_t *bp, size_t n,
+                      sysinterval_t timeout) {
+
+  return oqWriteTimeout(&((BufferedSIODriver *)ip)->oqueue, bp, n, timeout);
+}
+
+static size_t _readt(void *ip, uint8_t *bp, size_t n,
+                     sysinterval_t timeout) {
+
+  return iqReadTimeout(&((BufferedSIODriver *)ip)->iqueue, bp, n, timeout);
+}
+
+static msg_t _ctl(void *ip, unsigned int operation, void *arg) {
+  BufferedSIODriver *bsiop = (BufferedSIODriver *)ip;
+
+  osalDbgCheck(bsiop != NULL);
+
+  switch (operation) {
+  case CHN_CTL_NOP:
+    osalDbgCheck(arg == NULL);
+    break;
+  case CHN_CTL_INVALID:
+    osalDbgAssert(false, "invalid CTL operation");
+    break;
+  default:
+    /* Delegating to the SIO driver.*/
+    return sioControlX(bsiop->siop, operation, arg);
+  }
+  return MSG_OK;
+}
+
+static const struct BufferedSIODriverVMT vmt = {
+  (size_t)0,
+  _write, _read, _put, _get,
+  _putt, _gett, _writet, _readt,
+  _ctl
+};
+
+/*===========================================================================*/
+/* Driver exported functions.                                                */
+/*===========================================================================*/
+
+/**
+ * @brief   Initializes a buffered SIO driver object.
+ *
+ * @param[out] bsiop    pointer to a @p BufferedSIODriver structure
+ * @param[in] siop      pointer to the @p SIODriver object to be used, it
+ *                      must not be used by other clients
+ *
+ * @init
+ */
+void bsioObjectInit(BufferedSIODriver *bsiop, SIODriver *siop) {
+
+  bsiop->vmt = &vmt;
+  osalEventObjectInit(&bsiop->event);
+  bsiop->state = BSIO_STOP;
+  bsiop->siop  = siop;
+  iqObjectInit(&bsiop->iqueue, bsiop->ib, BUFFERED_SIO_BUFFERS_SIZE,
+               NULL, bsiop);
+  oqObjectInit(&bsiop->oqueue, bsiop->ob, BUFFERED_SIO_BUFFERS_SIZE,
+               bsio_onotify, bsiop);
+}
+
+/**
+ * @brief   Configures and starts the driver.
+ * @details The configuration is copied and its callbacks are replaced by
+ *          the driver ones, the other fields are passed to the SIO driver
+ *          unchanged.
+ *
+ * @param[in] bsiop     pointer to a @p BufferedSIODriver object
+ * @param[in] config    pointer to the @p SIOConfig object
+ *
+ * @api
+ */
+void bsioStart(BufferedSIODriver *bsiop, const SIOConfig *config) {
+
+  osalDbgCheck((bsiop != NULL) && (config != NULL));
+  osalDbgAssert((bsiop->state == BSIO_STOP) || (bsiop->state == BSIO_READY),
+                "invalid state");
+
+  bsiop->config          = *config;
+  bsiop->config.rxne_cb  = bsio_rxne_cb;
+  bsiop->config.txnf_cb  = bsio_txnf_cb;
+  bsiop->config.txend_cb = bsio_txend_cb;
+  bsiop->config.rxevt_cb = bsio_rxevt_cb;
+  bsiop->siop->arg       = (void *)bsiop;
+
+  sioStart(bsiop->siop, &bsiop->config);
+
+  osalSysLock();
+  bsiop->state = BSIO_READY;
+  /* Data written while stopped is sent now.*/
+  bsio_push_tx(bsiop);
+  osalSysUnlock();
+}
+
+/**
+ * @brief   Stops the driver.
+ * @details Any thread waiting on the driver's queues will be awakened with
+ *          the message @p MSG_RESET.
+ *
+ * @param[in] bsiop     pointer to a @p BufferedSIODriver object
+ *
+ * @api
+ */
+void bsioStop(BufferedSIODriver *bsiop) {
+
+  osalDbgCheck(bsiop != NULL);
+  osalDbgAssert((bsiop->state == BSIO_STOP) || (bsiop->state == BSIO_READY),
+                "invalid state");
+
+  sioStop(bsiop->siop);
+
+  osalSysLock();
+  bsiop->state = BSIO_STOP;
+  oqResetI(&bsiop->oqueue);
+  iqResetI(&bsiop->iqueue);
+  osalOsRescheduleS();
+  osalSysUnlock();
+}
+
+/**
+ * @brief   Control operation on a buffered SIO port.
+ * @note    Operations not handled by the channel are delegated to the SIO
+ *          driver.
+ *
+ * @param[in] bsiop     pointer to a @p BufferedSIODriver object
+ * @param[in] operation control operation code
+ * @param[in,out] arg   operation argument
+ *
+ * @return              The control operation status.
+ * @retval MSG_OK       in case of success.
+ * @retval MSG_TIMEOUT  in case of operation timeout.
+ * @retval MSG_RESET    in case of operation reset.
+ *
+ * @api
+ */
+msg_t bsioControl(BufferedSIODriver *bsiop,
+                  unsigned int operation, void *arg) {
+
+  return _ctl((void *)bsiop, operation, arg);
+}
+
+#endif /* HAL_USE_SIO == TRUE */
+
+/** @} */
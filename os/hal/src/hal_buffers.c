@@ -89,6 +89,7 @@ void ibqObjectInit(input_buffers_queue_t *ibqp, bool suspended, uint8_t *bp,
   ibqp->buffers   = bp;
   ibqp->ptr       = NULL;
   ibqp->top       = NULL;
+  ibqp->reserved  = false;
   ibqp->notify    = infy;
   ibqp->link      = link;
 }
@@ -113,6 +114,7 @@ void ibqResetI(input_buffers_queue_t *ibqp) {
   ibqp->bwrptr    = ibqp->buffers;
   ibqp->ptr       = NULL;
   ibqp->top       = NULL;
+  ibqp->reserved  = false;
   osalThreadDequeueAllI(&ibqp->waiting, MSG_RESET);
 }
 
@@ -386,14 +388,23 @@ size_t ibqReadTimeout(input_buffers_queue_t *ibqp, uint8_t *bp,
       size = n - r;
     }
 
-    /* Smaller chunks in order to not make the critical zone too long,
-       this impacts throughput however.*/
+    /* Large chunks are copied outside the critical zone, the current
+       buffer is owned by the reader and is not accessed by the ISR side.*/
     if (size > (size_t)BUFFERS_CHUNKS_SIZE) {
-      /* Giving the compiler a chance to optimize for a fixed size move.*/
-      memcpy(bp, ibqp->ptr, BUFFERS_CHUNKS_SIZE);
-      bp        += (size_t)BUFFERS_CHUNKS_SIZE;
-      ibqp->ptr += (size_t)BUFFERS_CHUNKS_SIZE;
-      r         += (size_t)BUFFERS_CHUNKS_SIZE;
+      const uint8_t *p = ibqp->ptr;
+
+      osalSysUnlock();
+      memcpy(bp, p, size);
+      osalSysLock();
+
+      /* If the queue has been reset meanwhile then the data is lost.*/
+      if (ibqp->ptr == NULL) {
+        osalSysUnlock();
+        return r;
+      }
+      bp        += size;
+      ibqp->ptr += size;
+      r         += size;
     }
     else {
       memcpy(bp, ibqp->ptr, size);
@@ -416,6 +427,84 @@ size_t ibqReadTimeout(input_buffers_queue_t *ibqp, uint8_t *bp,
   }
 }
 
+/**
+ * @brief   Fetches data from an input buffers queue without copying it.
+ * @details The data remaining in the current buffer is lent to the caller,
+ *          if there is no current buffer then the next filled buffer is
+ *          acquired waiting for it if necessary. The data must be given
+ *          back using @p ibqRelease(), the buffer is returned to the queue
+ *          when all its data has been released.
+ * @note    The data can be accessed outside the critical zone, the ISR side
+ *          does not access a buffer acquired by the reader.
+ *
+ * @param[in] ibqp      pointer to the @p input_buffers_queue_t object
+ * @param[out] bpp      pointer to a variable receiving the data pointer
+ * @param[out] np       pointer to a variable receiving the data size
+ * @param[in] timeout   the number of ticks before the operation timeouts,
+ *                      the following special values are allowed:
+ *                      - @a TIME_IMMEDIATE immediate timeout.
+ *                      - @a TIME_INFINITE no timeout.
+ *                      .
+ * @return              The operation status.
+ * @retval MSG_OK       if data has been fetched.
+ * @retval MSG_TIMEOUT  if the specified time expired.
+ * @retval MSG_RESET    if the queue has been reset or has been put in
+ *                      suspended state.
+ *
+ * @api
+ */
+msg_t ibqFetchTimeout(input_buffers_queue_t *ibqp, const uint8_t **bpp,
+                      size_t *np, sysinterval_t timeout) {
+
+  osalDbgCheck((bpp != NULL) && (np != NULL));
+
+  osalSysLock();
+
+  /* This condition indicates that a new buffer must be acquired.*/
+  if (ibqp->ptr == NULL) {
+    msg_t msg = ibqGetFullBufferTimeoutS(ibqp, timeout);
+    if (msg != MSG_OK) {
+      osalSysUnlock();
+      return msg;
+    }
+  }
+
+  *bpp = ibqp->ptr;
+  *np  = (size_t)ibqp->top - (size_t)ibqp->ptr;
+
+  osalSysUnlock();
+  return MSG_OK;
+}
+
+/**
+ * @brief   Releases data fetched from an input buffers queue.
+ * @details The data is consumed, if the current buffer has been fully
+ *          consumed then it is returned to the queue.
+ * @note    If the queue has been reset after the fetch then the function
+ *          does nothing.
+ *
+ * @param[in] ibqp      pointer to the @p input_buffers_queue_t object
+ * @param[in] n         number of consumed bytes, it cannot exceed the size
+ *                      returned by @p ibqFetchTimeout()
+ *
+ * @api
+ */
+void ibqRelease(input_buffers_queue_t *ibqp, size_t n) {
+
+  osalSysLock();
+
+  if (ibqp->ptr != NULL) {
+    osalDbgCheck(n <= ((size_t)ibqp->top - (size_t)ibqp->ptr));
+
+    ibqp->ptr += n;
+    if (ibqp->ptr >= ibqp->top) {
+      ibqReleaseEmptyBufferS(ibqp);
+    }
+  }
+
+  osalSysUnlock();
+}
+
 /**
  * @brief   Initializes an output buffers queue object.
  *
@@ -445,6 +534,7 @@ void obqObjectInit(output_buffers_queue_t *obqp, bool suspended, uint8_t *bp,
   obqp->buffers   = bp;
   obqp->ptr       = NULL;
   obqp->top       = NULL;
+  obqp->reserved  = false;
   obqp->notify    = onfy;
   obqp->link      = link;
 }
@@ -469,6 +559,7 @@ void obqResetI(output_buffers_queue_t *obqp) {
   obqp->bwrptr    = obqp->buffers;
   obqp->ptr       = NULL;
   obqp->top       = NULL;
+  obqp->reserved  = false;
   osalThreadDequeueAllI(&obqp->waiting, MSG_RESET);
 }
 
@@ -749,14 +840,25 @@ size_t obqWriteTimeout(output_buffers_queue_t *obqp, const uint8_t *bp,
       size = n - w;
     }
 
-    /* Smaller chunks in order to not make the critical zone too long,
-       this impacts throughput however.*/
+    /* Large chunks are copied outside the critical zone, the current
+       buffer is reserved so it is not flushed by the ISR side.*/
     if (size > (size_t)BUFFERS_CHUNKS_SIZE) {
-      /* Giving the compiler a chance to optimize for a fixed size move.*/
-      memcpy(obqp->ptr, bp, (size_t)BUFFERS_CHUNKS_SIZE);
-      bp        += (size_t)BUFFERS_CHUNKS_SIZE;
-      obqp->ptr += (size_t)BUFFERS_CHUNKS_SIZE;
-      w         += (size_t)BUFFERS_CHUNKS_SIZE;
+      uint8_t *p = obqp->ptr;
+
+      obqp->reserved = true;
+      osalSysUnlock();
+      memcpy(p, bp, size);
+      osalSysLock();
+      obqp->reserved = false;
+
+      /* If the queue has been reset meanwhile then the data is lost.*/
+      if (obqp->ptr == NULL) {
+        osalSysUnlock();
+        return w;
+      }
+      bp        += size;
+      obqp->ptr += size;
+      w         += size;
     }
     else {
       memcpy(obqp->ptr, bp, size);
@@ -779,6 +881,88 @@ size_t obqWriteTimeout(output_buffers_queue_t *obqp, const uint8_t *bp,
   }
 }
 
+/**
+ * @brief   Reserves space in an output buffers queue for writing in place.
+ * @details The space remaining in the current buffer is lent to the caller,
+ *          if there is no current buffer then the next empty buffer is
+ *          acquired waiting for it if necessary. The written data must be
+ *          committed using @p obqCommit(), the buffer is posted to the
+ *          queue when it is full, a partially filled buffer is posted by
+ *          a flush operation.
+ * @note    The space can be written outside the critical zone, the buffer
+ *          is not flushed by @p obqTryFlushI() until the commit.
+ *
+ * @param[in] obqp      pointer to the @p output_buffers_queue_t object
+ * @param[out] bpp      pointer to a variable receiving the space pointer
+ * @param[out] np       pointer to a variable receiving the space size
+ * @param[in] timeout   the number of ticks before the operation timeouts,
+ *                      the following special values are allowed:
+ *                      - @a TIME_IMMEDIATE immediate timeout.
+ *                      - @a TIME_INFINITE no timeout.
+ *                      .
+ * @return              The operation status.
+ * @retval MSG_OK       if space has been reserved.
+ * @retval MSG_TIMEOUT  if the specified time expired.
+ * @retval MSG_RESET    if the queue has been reset or has been put in
+ *                      suspended state.
+ *
+ * @api
+ */
+msg_t obqReserveTimeout(output_buffers_queue_t *obqp, uint8_t **bpp,
+                        size_t *np, sysinterval_t timeout) {
+
+  osalDbgCheck((bpp != NULL) && (np != NULL));
+
+  osalSysLock();
+
+  /* This condition indicates that a new buffer must be acquired.*/
+  if (obqp->ptr == NULL) {
+    msg_t msg = obqGetEmptyBufferTimeoutS(obqp, timeout);
+    if (msg != MSG_OK) {
+      osalSysUnlock();
+      return msg;
+    }
+  }
+
+  obqp->reserved = true;
+  *bpp = obqp->ptr;
+  *np  = (size_t)obqp->top - (size_t)obqp->ptr;
+
+  osalSysUnlock();
+  return MSG_OK;
+}
+
+/**
+ * @brief   Commits data written in the space reserved in an output buffers
+ *          queue.
+ * @details If the current buffer has been filled then it is posted to the
+ *          queue.
+ * @note    If the queue has been reset after the reservation then the data
+ *          is lost.
+ *
+ * @param[in] obqp      pointer to the @p output_buffers_queue_t object
+ * @param[in] n         number of written bytes, it cannot exceed the size
+ *                      returned by @p obqReserveTimeout()
+ *
+ * @api
+ */
+void obqCommit(output_buffers_queue_t *obqp, size_t n) {
+
+  osalSysLock();
+
+  obqp->reserved = false;
+  if (obqp->ptr != NULL) {
+    osalDbgCheck(n <= ((size_t)obqp->top - (size_t)obqp->ptr));
+
+    obqp->ptr += n;
+    if (obqp->ptr >= obqp->top) {
+      obqPostFullBufferS(obqp, obqp->bsize - sizeof (size_t));
+    }
+  }
+
+  osalSysUnlock();
+}
+
 /**
  * @brief   Flushes the current, partially filled, buffer to the queue.
  * @note    The notification callback is not invoked because the function
@@ -798,7 +982,7 @@ bool obqTryFlushI(output_buffers_queue_t *obqp) {
 
   /* If queue is empty and there is a buffer partially filled and
      it is not being written.*/
-  if (obqIsEmptyI(obqp) && (obqp->ptr != NULL)) {
+  if (obqIsEmptyI(obqp) && (obqp->ptr != NULL) && !obqp->reserved) {
     size_t size = (size_t)obqp->ptr - ((size_t)obqp->bwrptr + sizeof (size_t));
 
     if (size > 0U) {
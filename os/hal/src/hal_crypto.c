@@ -30,6 +30,29 @@
 /* Driver local definitions.                                                 */
 /*===========================================================================*/
 
+/* The fallback needs its own copy of the transient keys when it implements
+   some of the modes while the LLD implements the base algorithm.*/
+#if (HAL_CRY_USE_FALLBACK == TRUE) && (CRY_LLD_SUPPORTS_AES == TRUE) &&     \
+    ((CRY_LLD_SUPPORTS_AES_ECB == FALSE) ||                                 \
+     (CRY_LLD_SUPPORTS_AES_CBC == FALSE) ||                                 \
+     (CRY_LLD_SUPPORTS_AES_CFB == FALSE) ||                                 \
+     (CRY_LLD_SUPPORTS_AES_CTR == FALSE) ||                                 \
+     (CRY_LLD_SUPPORTS_AES_GCM == FALSE))
+#define CRY_FALLBACK_AES_KEY                TRUE
+#else
+#define CRY_FALLBACK_AES_KEY                FALSE
+#endif
+
+#if (HAL_CRY_USE_FALLBACK == TRUE) &&                                       \
+    ((CRY_LLD_SUPPORTS_HMAC_SHA256 == TRUE) ||                              \
+     (CRY_LLD_SUPPORTS_HMAC_SHA512 == TRUE)) &&                             \
+    ((CRY_LLD_SUPPORTS_HMAC_SHA256 == FALSE) ||                             \
+     (CRY_LLD_SUPPORTS_HMAC_SHA512 == FALSE))
+#define CRY_FALLBACK_HMAC_KEY               TRUE
+#else
+#define CRY_FALLBACK_HMAC_KEY               FALSE
+#endif
+
 /*===========================================================================*/
 /* Driver exported variables.                                                */
 /*===========================================================================*/
@@ -147,7 +170,15 @@ cryerror_t cryLoadAESTransientKey(CRYDriver *cryp,
 
   osalDbgCheck((cryp != NULL) &&  (keyp != NULL));
 
-#if CRY_LLD_SUPPORTS_AES == TRUE
+#if CRY_FALLBACK_AES_KEY == TRUE
+  {
+    cryerror_t err = cry_lld_aes_loadkey(cryp, size, keyp);
+    if (err != CRY_NOERROR) {
+      return err;
+    }
+  }
+  return cry_fallback_aes_loadkey(cryp, size, keyp);
+#elif CRY_LLD_SUPPORTS_AES == TRUE
   return cry_lld_aes_loadkey(cryp, size, keyp);
 #elif HAL_CRY_USE_FALLBACK == TRUE
   return cry_fallback_aes_loadkey(cryp, size, keyp);
@@ -1499,8 +1530,16 @@ cryerror_t cryLoadHMACTransientKey(CRYDriver *cryp,
 
   osalDbgCheck((cryp != NULL) &&  (keyp != NULL));
 
-#if (CRY_LLD_SUPPORTS_HMAC_SHA256 == TRUE) ||                               \
-    (CRY_LLD_SUPPORTS_HMAC_SHA512 == TRUE)
+#if CRY_FALLBACK_HMAC_KEY == TRUE
+  {
+    cryerror_t err = cry_lld_hmac_loadkey(cryp, size, keyp);
+    if (err != CRY_NOERROR) {
+      return err;
+    }
+  }
+  return cry_fallback_hmac_loadkey(cryp, size, keyp);
+#elif (CRY_LLD_SUPPORTS_HMAC_SHA256 == TRUE) ||                             \
+      (CRY_LLD_SUPPORTS_HMAC_SHA512 == TRUE)
   return cry_lld_hmac_loadkey(cryp, size, keyp);
 #elif HAL_CRY_USE_FALLBACK == TRUE
   return cry_fallback_hmac_loadkey(cryp, size, keyp);
@@ -77,6 +77,11 @@ void i2cObjectInit(I2CDriver *i2cp) {
   osalMutexObjectInit(&i2cp->mutex);
 #endif
 
+#if I2C_SUPPORTS_ASYNC == TRUE
+  i2cp->callback = NULL;
+  i2cp->arg      = NULL;
+#endif
+
 #if defined(I2C_DRIVER_EXT_INIT_HOOK)
   I2C_DRIVER_EXT_INIT_HOOK(i2cp);
 #endif
@@ -246,6 +251,81 @@ msg_t i2cMasterReceiveTimeout(I2CDriver *i2cp,
   return rdymsg;
 }
 
+#if (I2C_SUPPORTS_ASYNC == TRUE) || defined(__DOXYGEN__)
+/**
+ * @brief   Starts an asynchronous transmission on the I2C bus.
+ * @details The "read-through-write" transfer is started and the function
+ *          returns immediately, the callback is invoked from the ISR
+ *          context at the end of the operation and can start another one.
+ * @note    There is no timeout, an operation that never ends leaves the
+ *          driver in the active state.
+ *
+ * @param[in] i2cp      pointer to the @p I2CDriver object
+ * @param[in] addr      slave device address (7 bits) without R/W bit
+ * @param[in] txbuf     pointer to transmit buffer
+ * @param[in] txbytes   number of bytes to be transmitted
+ * @param[out] rxbuf    pointer to receive buffer
+ * @param[in] rxbytes   number of bytes to be received, set it to 0 if
+ *                      you want transmit only
+ * @param[in] cb        operation end callback
+ *
+ * @iclass
+ */
+void i2cMasterStartTransmitI(I2CDriver *i2cp,
+                             i2caddr_t addr,
+                             const uint8_t *txbuf,
+                             size_t txbytes,
+                             uint8_t *rxbuf,
+                             size_t rxbytes,
+                             i2ccallback_t cb) {
+
+  osalDbgCheckClassI();
+  osalDbgCheck((i2cp != NULL) &&
+               (txbytes > 0U) && (txbuf != NULL) &&
+               ((rxbytes == 0U) || ((rxbytes > 0U) && (rxbuf != NULL))) &&
+               (cb != NULL));
+  osalDbgAssert(i2cp->state == I2C_READY, "not ready");
+
+  i2cp->errors   = I2C_NO_ERROR;
+  i2cp->state    = I2C_ACTIVE_TX;
+  i2cp->callback = cb;
+  i2c_lld_master_start_transmit(i2cp, addr, txbuf, txbytes, rxbuf, rxbytes);
+}
+
+/**
+ * @brief   Starts an asynchronous reception from the I2C bus.
+ * @details The reception is started and the function returns immediately,
+ *          the callback is invoked from the ISR context at the end of the
+ *          operation and can start another one.
+ * @note    There is no timeout, an operation that never ends leaves the
+ *          driver in the active state.
+ *
+ * @param[in] i2cp      pointer to the @p I2CDriver object
+ * @param[in] addr      slave device address (7 bits) without R/W bit
+ * @param[out] rxbuf    pointer to receive buffer
+ * @param[in] rxbytes   number of bytes to be received
+ * @param[in] cb        operation end callback
+ *
+ * @iclass
+ */
+void i2cMasterStartReceiveI(I2CDriver *i2cp,
+                            i2caddr_t addr,
+                            uint8_t *rxbuf,
+                            size_t rxbytes,
+                            i2ccallback_t cb) {
+
+  osalDbgCheckClassI();
+  osalDbgCheck((i2cp != NULL) && (addr != 0U) &&
+               (rxbytes > 0U) && (rxbuf != NULL) && (cb != NULL));
+  osalDbgAssert(i2cp->state == I2C_READY, "not ready");
+
+  i2cp->errors   = I2C_NO_ERROR;
+  i2cp->state    = I2C_ACTIVE_RX;
+  i2cp->callback = cb;
+  i2c_lld_master_start_receive(i2cp, addr, rxbuf, rxbytes);
+}
+#endif /* I2C_SUPPORTS_ASYNC == TRUE */
+
 #if (I2C_USE_MUTUAL_EXCLUSION == TRUE) || defined(__DOXYGEN__)
 /**
  * @brief   Gains exclusive access to the I2C bus.
@@ -428,6 +428,70 @@ size_t iqReadTimeout(input_queue_t *iqp, uint8_t *bp,
   return max - n;
 }
 
+/**
+ * @brief   Gets the contiguous empty area at the low end of an input queue.
+ * @details This function is meant to be used by drivers able to move data
+ *          in blocks, the returned area can be filled directly then the
+ *          data is made available to the readers using
+ *          @p iqPostFullAreaI(). Because the queue is circular, two
+ *          fill operations can be required in order to use all the free
+ *          space.
+ *
+ * @param[in] iqp       pointer to an @p input_queue_t structure
+ * @param[out] np       pointer to a variable receiving the size of the
+ *                      area, zero if the queue is full
+ * @return              Pointer to the empty area.
+ *
+ * @iclass
+ */
+uint8_t *iqGetEmptyAreaI(input_queue_t *iqp, size_t *np) {
+  size_t n;
+
+  osalDbgCheckClassI();
+
+  /* Empty space limited to the buffer end.*/
+  n = iqGetEmptyI(iqp);
+  /*lint -save -e9033 [10.8] Checked to be safe.*/
+  if (n > (size_t)(iqp->q_top - iqp->q_wrptr)) {
+    n = (size_t)(iqp->q_top - iqp->q_wrptr);
+  }
+  /*lint -restore*/
+
+  *np = n;
+  return iqp->q_wrptr;
+}
+
+/**
+ * @brief   Posts data written into the empty area of an input queue.
+ * @details The data is made available to the readers with a single counter
+ *          update, all the waiting threads are awakened once for the whole
+ *          block instead of once for each byte.
+ *
+ * @param[in] iqp       pointer to an @p input_queue_t structure
+ * @param[in] n         number of bytes written in the area returned by
+ *                      @p iqGetEmptyAreaI(), zero is allowed
+ *
+ * @iclass
+ */
+void iqPostFullAreaI(input_queue_t *iqp, size_t n) {
+
+  osalDbgCheckClassI();
+
+  if (n > 0U) {
+    /*lint -save -e9033 [10.8] Checked to be safe.*/
+    osalDbgAssert(n <= (size_t)(iqp->q_top - iqp->q_wrptr), "overflow");
+    /*lint -restore*/
+
+    iqp->q_counter += n;
+    iqp->q_wrptr += n;
+    if (iqp->q_wrptr >= iqp->q_top) {
+      iqp->q_wrptr = iqp->q_buffer;
+    }
+
+    osalThreadDequeueAllI(&iqp->q_waiting, MSG_OK);
+  }
+}
+
 /**
  * @brief   Initializes an output queue.
  * @details A Semaphore is internally initialized and works as a counter of
@@ -696,4 +760,67 @@ size_t oqWriteTimeout(output_queue_t *oqp, const uint8_t *bp,
   return max - n;
 }
 
+/**
+ * @brief   Gets the contiguous full area at the low end of an output queue.
+ * @details This function is meant to be used by drivers able to move data
+ *          in blocks, the returned area can be transmitted directly then
+ *          the space is returned to the writers using
+ *          @p oqReleaseEmptyAreaI(). Because the queue is circular, two
+ *          transmit operations can be required in order to empty the queue.
+ *
+ * @param[in] oqp       pointer to an @p output_queue_t structure
+ * @param[out] np       pointer to a variable receiving the size of the
+ *                      area, zero if the queue is empty
+ * @return              Pointer to the full area.
+ *
+ * @iclass
+ */
+uint8_t *oqGetFullAreaI(output_queue_t *oqp, size_t *np) {
+  size_t n;
+
+  osalDbgCheckClassI();
+
+  /* Full space limited to the buffer end.*/
+  n = oqGetFullI(oqp);
+  /*lint -save -e9033 [10.8] Checked to be safe.*/
+  if (n > (size_t)(oqp->q_top - oqp->q_rdptr)) {
+    n = (size_t)(oqp->q_top - oqp->q_rdptr);
+  }
+  /*lint -restore*/
+
+  *np = n;
+  return oqp->q_rdptr;
+}
+
+/**
+ * @brief   Releases data read from the full area of an output queue.
+ * @details The space is returned to the writers with a single counter
+ *          update, all the waiting threads are awakened once for the whole
+ *          block instead of once for each byte.
+ *
+ * @param[in] oqp       pointer to an @p output_queue_t structure
+ * @param[in] n         number of bytes consumed from the area returned by
+ *                      @p oqGetFullAreaI(), zero is allowed
+ *
+ * @iclass
+ */
+void oqReleaseEmptyAreaI(output_queue_t *oqp, size_t n) {
+
+  osalDbgCheckClassI();
+
+  if (n > 0U) {
+    /*lint -save -e9033 [10.8] Checked to be safe.*/
+    osalDbgAssert(n <= (size_t)(oqp->q_top - oqp->q_rdptr), "overflow");
+    /*lint -restore*/
+
+    oqp->q_counter += n;
+    oqp->q_rdptr += n;
+    if (oqp->q_rdptr >= oqp->q_top) {
+      oqp->q_rdptr = oqp->q_buffer;
+    }
+
+    osalThreadDequeueAllI(&oqp->q_waiting, MSG_OK);
+  }
+}
+
 /** @} */
@@ -69,6 +69,7 @@ void sioObjectInit(SIODriver *siop) {
 
   siop->state      = SIO_STOP;
   siop->config     = NULL;
+  siop->arg        = NULL;
 
   /* Optional, user-defined initializer.*/
 #if defined(SIO_DRIVER_EXT_INIT_HOOK)
@@ -75,6 +75,7 @@ void spiObjectInit(SPIDriver *spip) {
 #if SPI_USE_MUTUAL_EXCLUSION == TRUE
   osalMutexObjectInit(&spip->mutex);
 #endif
+  spip->arg = NULL;
 #if defined(SPI_DRIVER_EXT_INIT_HOOK)
   SPI_DRIVER_EXT_INIT_HOOK(spip);
 #endif
@@ -182,6 +182,55 @@ msg_t i2c_lld_master_transmit_timeout(I2CDriver *i2cp, i2caddr_t addr,
   return MSG_OK;
 }
 
+#if (I2C_SUPPORTS_ASYNC == TRUE) || defined(__DOXYGEN__)
+/**
+ * @brief   Starts an asynchronous transmission via the I2C bus as master.
+ * @note    At the end of the operation the ISR invokes
+ *          @p _i2c_wakeup_isr() or @p _i2c_wakeup_error_isr().
+ *
+ * @param[in] i2cp      pointer to the @p I2CDriver object
+ * @param[in] addr      slave device address
+ * @param[in] txbuf     pointer to the transmit buffer
+ * @param[in] txbytes   number of bytes to be transmitted
+ * @param[out] rxbuf    pointer to the receive buffer
+ * @param[in] rxbytes   number of bytes to be received
+ *
+ * @notapi
+ */
+void i2c_lld_master_start_transmit(I2CDriver *i2cp, i2caddr_t addr,
+                                   const uint8_t *txbuf, size_t txbytes,
+                                   uint8_t *rxbuf, size_t rxbytes) {
+
+  (void)i2cp;
+  (void)addr;
+  (void)txbuf;
+  (void)txbytes;
+  (void)rxbuf;
+  (void)rxbytes;
+}
+
+/**
+ * @brief   Starts an asynchronous reception via the I2C bus as master.
+ * @note    At the end of the operation the ISR invokes
+ *          @p _i2c_wakeup_isr() or @p _i2c_wakeup_error_isr().
+ *
+ * @param[in] i2cp      pointer to the @p I2CDriver object
+ * @param[in] addr      slave device address
+ * @param[out] rxbuf    pointer to the receive buffer
+ * @param[in] rxbytes   number of bytes to be received
+ *
+ * @notapi
+ */
+void i2c_lld_master_start_receive(I2CDriver *i2cp, i2caddr_t addr,
+                                  uint8_t *rxbuf, size_t rxbytes) {
+
+  (void)i2cp;
+  (void)addr;
+  (void)rxbuf;
+  (void)rxbytes;
+}
+#endif /* I2C_SUPPORTS_ASYNC == TRUE */
+
 #endif /* HAL_USE_I2C == TRUE */
 
 /** @} */
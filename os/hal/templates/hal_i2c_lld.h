@@ -31,6 +31,12 @@
 /* Driver constants.                                                         */
 /*===========================================================================*/
 
+/**
+ * @brief   This switch defines whether the driver implementation supports
+ *          the asynchronous operations.
+ */
+#define I2C_SUPPORTS_ASYNC          TRUE
+
 /*===========================================================================*/
 /* Driver pre-compile time settings.                                         */
 /*===========================================================================*/
@@ -101,6 +107,16 @@ struct I2CDriver {
 #if (I2C_USE_MUTUAL_EXCLUSION == TRUE) || defined(__DOXYGEN__)
   mutex_t                   mutex;
 #endif
+#if (I2C_SUPPORTS_ASYNC == TRUE) || defined(__DOXYGEN__)
+  /**
+   * @brief   Asynchronous operation end callback or @p NULL.
+   */
+  i2ccallback_t             callback;
+  /**
+   * @brief   Pointer for the callback owner, not used by the driver.
+   */
+  void                      *arg;
+#endif
 #if defined(I2C_DRIVER_EXT_FIELDS)
   I2C_DRIVER_EXT_FIELDS
 #endif
@@ -141,6 +157,13 @@ extern "C" {
   msg_t i2c_lld_master_receive_timeout(I2CDriver *i2cp, i2caddr_t addr,
                                        uint8_t *rxbuf, size_t rxbytes,
                                        sysinterval_t timeout);
+#if I2C_SUPPORTS_ASYNC == TRUE
+  void i2c_lld_master_start_transmit(I2CDriver *i2cp, i2caddr_t addr,
+                                     const uint8_t *txbuf, size_t txbytes,
+                                     uint8_t *rxbuf, size_t rxbytes);
+  void i2c_lld_master_start_receive(I2CDriver *i2cp, i2caddr_t addr,
+                                    uint8_t *rxbuf, size_t rxbytes);
+#endif
 #ifdef __cplusplus
 }
 #endif
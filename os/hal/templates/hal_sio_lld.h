@@ -121,6 +121,10 @@ struct hal_sio_driver {
    * @brief Current configuration data.
    */
   const SIOConfig          *config;
+  /**
+   * @brief User argument, it can be retrieved from within the callbacks.
+   */
+  void                     *arg;
 #if defined(SIO_DRIVER_EXT_FIELDS)
   SIO_DRIVER_EXT_FIELDS
 #endif
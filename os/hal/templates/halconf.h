@@ -438,6 +438,21 @@
 #define SERIAL_USB_BUFFERS_NUMBER           2
 #endif
 
+/*===========================================================================*/
+/* SIO driver related settings.                                              */
+/*===========================================================================*/
+
+/**
+ * @brief   Buffered SIO buffers size.
+ * @details Configuration parameter, you can change the depth of the queue
+ *          buffers depending on the requirements of your application.
+ * @note    The default is 64 bytes for both the transmission and receive
+ *          buffers.
+ */
+#if !defined(BUFFERED_SIO_BUFFERS_SIZE) || defined(__DOXYGEN__)
+#define BUFFERED_SIO_BUFFERS_SIZE           64
+#endif
+
 /*===========================================================================*/
 /* SPI driver related settings.                                              */
 /*===========================================================================*/
@@ -28,6 +28,11 @@
  *          - <b>Post</b>: A job is posted to the queue, it will be
  *            returned to the pool after execution.
  *          .
+ *          Jobs dispatchers are an alternative to jobs queues, jobs are
+ *          posted in priority lanes and executed by any number of worker
+ *          threads, each worker takes several pending jobs per wakeup.
+ *          Completion can be notified by callbacks or awaited using
+ *          futures.
  *
  * @addtogroup oslib_jobs_queues
  * @{
@@ -51,10 +56,24 @@
 /* Module pre-compile time settings.                                         */
 /*===========================================================================*/
 
+/**
+ * @brief   Number of priority lanes in jobs dispatchers.
+ * @details Lane zero has the highest priority.
+ *
+ * @note    The default is 4.
+ */
+#if !defined(CH_CFG_JOBS_LANES) || defined(__DOXYGEN__)
+#define CH_CFG_JOBS_LANES                   4
+#endif
+
 /*===========================================================================*/
 /* Derived constants and error checks.                                       */
 /*===========================================================================*/
 
+#if CH_CFG_JOBS_LANES < 1
+#error "invalid CH_CFG_JOBS_LANES value"
+#endif
+
 #if CH_CFG_USE_MEMPOOLS == FALSE
 #error "CH_CFG_USE_JOBS requires CH_CFG_USE_MEMPOOLS"
 #endif
@@ -90,6 +109,26 @@ typedef struct ch_jobs_queue {
  */
 typedef void (*job_function_t)(void *arg);
 
+/**
+ * @brief   Type of a job future.
+ */
+typedef struct ch_job_future {
+  /**
+   * @brief   Threads waiting for the job completion.
+   */
+  threads_queue_t           waiting;
+  /**
+   * @brief   Job result.
+   * @note    Set by the job or completion function using
+   *          @p chJobFutureSetResultX(), it is @p MSG_OK by default.
+   */
+  msg_t                     result;
+  /**
+   * @brief   Job completed flag.
+   */
+  bool                      done;
+} job_future_t;
+
 /**
  * @brief   Type of a job descriptor.
  */
@@ -102,8 +141,59 @@ typedef struct ch_job_descriptor {
    * @brief   Argument to be passed to the job function.
    */
   void                      *jobarg;
+  /**
+   * @brief   Completion function or @p NULL.
+   * @details It is invoked with the job argument after the job function.
+   * @note    Only used by jobs dispatchers.
+   */
+  job_function_t            donefunc;
+  /**
+   * @brief   Future to be completed or @p NULL.
+   * @note    Only used by jobs dispatchers.
+   */
+  job_future_t              *future;
+  /**
+   * @brief   Next job in a dispatcher lane.
+   */
+  struct ch_job_descriptor  *next;
 } job_descriptor_t;
 
+/**
+ * @brief   Type of a jobs lane.
+ */
+typedef struct ch_jobs_lane {
+  /**
+   * @brief   First job in the lane.
+   */
+  job_descriptor_t          *head;
+  /**
+   * @brief   Last job in the lane.
+   */
+  job_descriptor_t          *tail;
+} jobs_lane_t;
+
+/**
+ * @brief   Type of a jobs dispatcher.
+ */
+typedef struct ch_jobs_dispatcher {
+  /**
+   * @brief   Pool of the free jobs.
+   */
+  guarded_memory_pool_t     free;
+  /**
+   * @brief   Counter of the posted jobs, worker threads wait here.
+   */
+  semaphore_t               pending;
+  /**
+   * @brief   Maximum number of jobs taken by a worker per wakeup.
+   */
+  size_t                    batch;
+  /**
+   * @brief   Priority lanes.
+   */
+  jobs_lane_t               lanes[CH_CFG_JOBS_LANES];
+} jobs_dispatcher_t;
+
 /*===========================================================================*/
 /* Module macros.                                                            */
 /*===========================================================================*/
@@ -115,7 +205,28 @@ typedef struct ch_job_descriptor {
 #ifdef __cplusplus
 extern "C" {
 #endif
-
+  void chJobDispatcherObjectInit(jobs_dispatcher_t *jdp,
+                                 size_t jobsn,
+                                 job_descriptor_t *jobsbuf,
+                                 size_t batch);
+  void chJobDispatcherPostI(jobs_dispatcher_t *jdp,
+                            job_descriptor_t *jp,
+                            unsigned lane);
+  void chJobDispatcherPostS(jobs_dispatcher_t *jdp,
+                            job_descriptor_t *jp,
+                            unsigned lane);
+  void chJobDispatcherPost(jobs_dispatcher_t *jdp,
+                           job_descriptor_t *jp,
+                           unsigned lane);
+  msg_t chJobDispatcherDispatchTimeout(jobs_dispatcher_t *jdp,
+                                       sysinterval_t timeout);
+#if defined(_CHIBIOS_RT_) || defined(__DOXYGEN__)
+  thread_t *chJobDispatcherCreateWorker(jobs_dispatcher_t *jdp,
+                                        const char *name,
+                                        void *wsp, size_t size,
+                                        tprio_t prio);
+#endif
+  msg_t chJobFutureWaitTimeout(job_future_t *fp, sysinterval_t timeout);
 #ifdef __cplusplus
 }
 #endif
@@ -392,6 +503,190 @@ static inline msg_t chJobDispatchTimeout(jobs_queue_t *jqp,
   return msg;
 }
 
+/**
+ * @brief   Clears the dispatcher-specific fields of a job object.
+ *
+ * @param[in] jp        pointer to the job object or @p NULL
+ * @return              The pointer to the job object.
+ *
+ * @notapi
+ */
+static inline job_descriptor_t *_job_dispatcher_clear(job_descriptor_t *jp) {
+
+  if (jp != NULL) {
+    jp->donefunc = NULL;
+    jp->future   = NULL;
+  }
+
+  return jp;
+}
+
+/**
+ * @brief   Allocates a free job object from a dispatcher.
+ *
+ * @param[in] jdp       pointer to a @p jobs_dispatcher_t structure
+ * @return              The pointer to the allocated job object.
+ *
+ * @api
+ */
+static inline job_descriptor_t *chJobDispatcherGet(jobs_dispatcher_t *jdp) {
+
+  return _job_dispatcher_clear(
+      (job_descriptor_t *)chGuardedPoolAllocTimeout(&jdp->free,
+                                                    TIME_INFINITE));
+}
+
+/**
+ * @brief   Allocates a free job object from a dispatcher.
+ *
+ * @param[in] jdp       pointer to a @p jobs_dispatcher_t structure
+ * @return              The pointer to the allocated job object.
+ * @retval NULL         if a job object is not immediately available.
+ *
+ * @iclass
+ */
+static inline job_descriptor_t *chJobDispatcherGetI(jobs_dispatcher_t *jdp) {
+
+  return _job_dispatcher_clear(
+      (job_descriptor_t *)chGuardedPoolAllocI(&jdp->free));
+}
+
+/**
+ * @brief   Allocates a free job object from a dispatcher.
+ *
+ * @param[in] jdp       pointer to a @p jobs_dispatcher_t structure
+ * @param[in] timeout   the number of ticks before the operation timeouts,
+ *                      the following special values are allowed:
+ *                      - @a TIME_IMMEDIATE immediate timeout.
+ *                      - @a TIME_INFINITE no timeout.
+ *                      .
+ * @return              The pointer to the allocated job object.
+ * @retval NULL         if a job object is not available within the specified
+ *                      timeout.
+ *
+ * @sclass
+ */
+static inline job_descriptor_t *chJobDispatcherGetTimeoutS(
+                                                    jobs_dispatcher_t *jdp,
+                                                    sysinterval_t timeout) {
+
+  return _job_dispatcher_clear(
+      (job_descriptor_t *)chGuardedPoolAllocTimeoutS(&jdp->free, timeout));
+}
+
+/**
+ * @brief   Allocates a free job object from a dispatcher.
+ *
+ * @param[in] jdp       pointer to a @p jobs_dispatcher_t structure
+ * @param[in] timeout   the number of ticks before the operation timeouts,
+ *                      the following special values are allowed:
+ *                      - @a TIME_IMMEDIATE immediate timeout.
+ *                      - @a TIME_INFINITE no timeout.
+ *                      .
+ * @return              The pointer to the allocated job object.
+ * @retval NULL         if a job object is not available within the specified
+ *                      timeout.
+ *
+ * @api
+ */
+static inline job_descriptor_t *chJobDispatcherGetTimeout(
+                                                    jobs_dispatcher_t *jdp,
+                                                    sysinterval_t timeout) {
+
+  return _job_dispatcher_clear(
+      (job_descriptor_t *)chGuardedPoolAllocTimeout(&jdp->free, timeout));
+}
+
+/**
+ * @brief   Waits for jobs then executes them.
+ *
+ * @param[in] jdp       pointer to a @p jobs_dispatcher_t structure
+ * @return              The function outcome.
+ * @retval MSG_OK       if jobs have been executed.
+ * @retval MSG_JOB_NULL if a @p JOB_NULL has been received.
+ *
+ * @api
+ */
+static inline msg_t chJobDispatcherDispatch(jobs_dispatcher_t *jdp) {
+
+  return chJobDispatcherDispatchTimeout(jdp, TIME_INFINITE);
+}
+
+/**
+ * @brief   Initializes a job future object.
+ * @note    A future can be reused after completion by initializing it
+ *          again.
+ *
+ * @param[out] fp       pointer to a @p job_future_t structure
+ *
+ * @init
+ */
+static inline void chJobFutureObjectInit(job_future_t *fp) {
+
+  chThdQueueObjectInit(&fp->waiting);
+  fp->result = MSG_OK;
+  fp->done   = false;
+}
+
+/**
+ * @brief   Sets the result of the job associated to a future.
+ * @note    Must be called from the job function or the completion
+ *          function, the result is made available to the waiting threads
+ *          when the job completes.
+ *
+ * @param[in] fp        pointer to a @p job_future_t structure
+ * @param[in] msg       the job result
+ *
+ * @xclass
+ */
+static inline void chJobFutureSetResultX(job_future_t *fp, msg_t msg) {
+
+  fp->result = msg;
+}
+
+/**
+ * @brief   Returns the result of the job associated to a future.
+ * @note    The result is only meaningful after the job completed.
+ *
+ * @param[in] fp        pointer to a @p job_future_t structure
+ * @return              The job result.
+ *
+ * @xclass
+ */
+static inline msg_t chJobFutureGetResultX(job_future_t *fp) {
+
+  return fp->result;
+}
+
+/**
+ * @brief   Returns @p true if the job associated to a future completed.
+ *
+ * @param[in] fp        pointer to a @p job_future_t structure
+ * @return              The job state.
+ *
+ * @iclass
+ */
+static inline bool chJobFutureIsDoneI(job_future_t *fp) {
+
+  chDbgCheckClassI();
+
+  return fp->done;
+}
+
+/**
+ * @brief   Waits for the completion of the job associated to a future.
+ *
+ * @param[in] fp        pointer to a @p job_future_t structure
+ * @return              The wait outcome.
+ * @retval MSG_OK       if the job completed.
+ *
+ * @api
+ */
+static inline msg_t chJobFutureWait(job_future_t *fp) {
+
+  return chJobFutureWaitTimeout(fp, TIME_INFINITE);
+}
+
 #endif /* CH_CFG_USE_JOBS == TRUE */
 
 #endif /* CHJOBS_H */
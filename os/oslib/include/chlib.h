@@ -209,6 +209,11 @@
 /* Module macros.                                                            */
 /*===========================================================================*/
 
+/* Kernels without a tracer, the trace hooks are removed.*/
+#if !defined(_CHIBIOS_RT_) && !defined(_trace_sync)
+#define _trace_sync(op, objp, msg)
+#endif
+
 /*===========================================================================*/
 /* External declarations.                                                    */
 /*===========================================================================*/
@@ -38,10 +38,15 @@
  * @brief   Minimum alignment used for heap.
  * @note    Cannot use the sizeof operator in this macro.
  */
-#if (SIZEOF_PTR == 4) || defined(__DOXYGEN__)
+#if (SIZEOF_PTR == 8)
+#define CH_HEAP_ALIGNMENT   16U
+#define CH_HEAP_ALIGNMENT_LOG2 4U
+#elif (SIZEOF_PTR == 4) || defined(__DOXYGEN__)
 #define CH_HEAP_ALIGNMENT   8U
+#define CH_HEAP_ALIGNMENT_LOG2 3U
 #elif (SIZEOF_PTR == 2)
 #define CH_HEAP_ALIGNMENT   4U
+#define CH_HEAP_ALIGNMENT_LOG2 2U
 #else
 #error "unsupported pointer size"
 #endif
@@ -50,6 +55,35 @@
 /* Module pre-compile time settings.                                         */
 /*===========================================================================*/
 
+/**
+ * @brief   TLSF heap allocator.
+ * @details If enabled then heaps use a two-level segregated fit allocator,
+ *          allocation and release times are O(1) and independent from the
+ *          heap fragmentation.
+ * @note    The default is @p FALSE.
+ */
+#if !defined(CH_CFG_USE_HEAP_TLSF) || defined(__DOXYGEN__)
+#define CH_CFG_USE_HEAP_TLSF                FALSE
+#endif
+
+/**
+ * @brief   Log2 of the number of TLSF second level lists.
+ * @note    Higher values reduce the wasted space at the cost of a larger
+ *          heap descriptor.
+ */
+#if !defined(CH_CFG_HEAP_TLSF_SL_LOG2) || defined(__DOXYGEN__)
+#define CH_CFG_HEAP_TLSF_SL_LOG2            4U
+#endif
+
+/**
+ * @brief   Log2 of the TLSF blocks size limit.
+ * @note    Regions larger than this limit are split in multiple blocks,
+ *          allocations larger than this limit always fail.
+ */
+#if !defined(CH_CFG_HEAP_TLSF_FL_MAX) || defined(__DOXYGEN__)
+#define CH_CFG_HEAP_TLSF_FL_MAX             24U
+#endif
+
 /*===========================================================================*/
 /* Derived constants and error checks.                                       */
 /*===========================================================================*/
@@ -62,6 +96,36 @@
 #error "CH_CFG_USE_HEAP requires CH_CFG_USE_MUTEXES and/or CH_CFG_USE_SEMAPHORES"
 #endif
 
+#if (CH_CFG_USE_HEAP_TLSF == TRUE) || defined(__DOXYGEN__)
+/**
+ * @brief   Number of TLSF second level lists.
+ */
+#define CH_HEAP_TLSF_SL_COUNT   (1U << CH_CFG_HEAP_TLSF_SL_LOG2)
+
+/**
+ * @brief   Log2 of the size of the first non-linear TLSF class.
+ * @details Blocks smaller than this size are kept in linearly spaced lists.
+ */
+#define CH_HEAP_TLSF_FL_SHIFT   (CH_CFG_HEAP_TLSF_SL_LOG2 +                 \
+                                 CH_HEAP_ALIGNMENT_LOG2)
+
+/**
+ * @brief   Number of TLSF first level classes.
+ */
+#define CH_HEAP_TLSF_FL_COUNT   (CH_CFG_HEAP_TLSF_FL_MAX -                  \
+                                 CH_HEAP_TLSF_FL_SHIFT + 1U)
+
+#if (CH_CFG_HEAP_TLSF_SL_LOG2 < 1U) || (CH_CFG_HEAP_TLSF_SL_LOG2 > 5U)
+#error "invalid CH_CFG_HEAP_TLSF_SL_LOG2 value"
+#endif
+
+#if (CH_CFG_HEAP_TLSF_FL_MAX <= CH_HEAP_TLSF_FL_SHIFT) ||                   \
+    (CH_CFG_HEAP_TLSF_FL_MAX >= (SIZEOF_PTR * 8U)) ||                       \
+    (CH_HEAP_TLSF_FL_COUNT > 31U)
+#error "invalid CH_CFG_HEAP_TLSF_FL_MAX value"
+#endif
+#endif /* CH_CFG_USE_HEAP_TLSF == TRUE */
+
 /*===========================================================================*/
 /* Module data structures and types.                                         */
 /*===========================================================================*/
@@ -76,6 +140,7 @@ typedef struct memory_heap memory_heap_t;
  */
 typedef union heap_header heap_header_t;
 
+#if (CH_CFG_USE_HEAP_TLSF == FALSE) || defined(__DOXYGEN__)
 /**
  * @brief   Memory heap block header.
  */
@@ -89,6 +154,25 @@ union heap_header {
     size_t              size;       /**< @brief Size of the area in bytes.  */
   } used;
 };
+#else /* CH_CFG_USE_HEAP_TLSF == TRUE */
+/**
+ * @brief   Memory heap block header.
+ * @note    The size field is the size of the area in bytes, the two
+ *          least significant bits are the block status flags. Free blocks
+ *          also store the previous block in free list at the start of the
+ *          area and a back link to the header at the end of the area.
+ */
+union heap_header {
+  struct {
+    heap_header_t       *next;      /**< @brief Next block in free list.    */
+    size_t              size;       /**< @brief Size and flags.             */
+  } free;
+  struct {
+    memory_heap_t       *heap;      /**< @brief Block owner heap.           */
+    size_t              size;       /**< @brief Size and flags.             */
+  } used;
+};
+#endif /* CH_CFG_USE_HEAP_TLSF == TRUE */
 
 /**
  * @brief   Structure describing a memory heap.
@@ -96,7 +180,16 @@ union heap_header {
 struct memory_heap {
   memgetfunc2_t         provider;   /**< @brief Memory blocks provider for
                                                 this heap.                  */
+#if (CH_CFG_USE_HEAP_TLSF == FALSE) || defined(__DOXYGEN__)
   heap_header_t         header;     /**< @brief Free blocks list header.    */
+#endif
+#if (CH_CFG_USE_HEAP_TLSF == TRUE) || defined(__DOXYGEN__)
+  uint32_t              flmap;      /**< @brief First level bitmap.         */
+  uint32_t              slmap[CH_HEAP_TLSF_FL_COUNT];
+                                    /**< @brief Second level bitmaps.       */
+  heap_header_t         *lists[CH_HEAP_TLSF_FL_COUNT][CH_HEAP_TLSF_SL_COUNT];
+                                    /**< @brief Free blocks lists.          */
+#endif
 #if (CH_CFG_USE_MUTEXES == TRUE) || defined(__DOXYGEN__)
   mutex_t               mtx;        /**< @brief Heap access mutex.          */
 #else
@@ -124,6 +217,7 @@ extern "C" {
 #endif
   void _heap_init(void);
   void chHeapObjectInit(memory_heap_t *heapp, void *buf, size_t size);
+  void chHeapAddRegion(memory_heap_t *heapp, void *buf, size_t size);
   void *chHeapAllocAligned(memory_heap_t *heapp, size_t size, unsigned align);
   void chHeapFree(void *p);
   size_t chHeapStatus(memory_heap_t *heapp, size_t *totalp, size_t *largestp);
@@ -136,8 +230,7 @@ extern "C" {
 /*===========================================================================*/
 
 /**
- * @brief   Allocates a block of memory from the heap by using the first-fit
- *          algorithm.
+ * @brief   Allocates a block of memory from the heap.
  * @details The allocated block is guaranteed to be properly aligned for a
  *          pointer data type.
  *
@@ -160,6 +253,8 @@ static inline void *chHeapAlloc(memory_heap_t *heapp, size_t size) {
  * @brief   Returns the size of an allocated block.
  * @note    The returned value is the requested size, the real size is the
  *          same value aligned to the next @p CH_HEAP_ALIGNMENT multiple.
+ * @note    If @p CH_CFG_USE_HEAP_TLSF is enabled then the returned value is
+ *          the real size of the block.
  *
  * @param[in] p         pointer to the memory block
  * @return              Size of the block.
@@ -168,7 +263,12 @@ static inline void *chHeapAlloc(memory_heap_t *heapp, size_t size) {
  */
 static inline size_t chHeapGetSize(const void *p) {
 
+#if CH_CFG_USE_HEAP_TLSF == FALSE
   return ((heap_header_t *)p - 1U)->used.size;
+#else
+  return ((heap_header_t *)p - 1U)->used.size &
+         ~(size_t)MEM_ALIGN_MASK(CH_HEAP_ALIGNMENT);
+#endif
 }
 
 #endif /* CH_CFG_USE_HEAP == TRUE */
@@ -81,6 +81,20 @@ typedef struct {
 } guarded_memory_pool_t;
 #endif /* CH_CFG_USE_SEMAPHORES == TRUE */
 
+/**
+ * @brief   Memory pool magazine descriptor.
+ * @details A magazine is a small LIFO cache of objects placed in front of
+ *          a memory pool. It is meant to be owned by a single thread, or
+ *          core, and is accessed without locking, objects are exchanged
+ *          with the pool in batches.
+ */
+typedef struct {
+  memory_pool_t         *pool;          /**< @brief Backing memory pool.    */
+  void                  **objs;         /**< @brief Cached objects stack.   */
+  size_t                size;           /**< @brief Stack capacity.         */
+  size_t                cnt;            /**< @brief Cached objects count.   */
+} pool_magazine_t;
+
 /*===========================================================================*/
 /* Module macros.                                                            */
 /*===========================================================================*/
@@ -154,6 +168,15 @@ extern "C" {
   void *chPoolAlloc(memory_pool_t *mp);
   void chPoolFreeI(memory_pool_t *mp, void *objp);
   void chPoolFree(memory_pool_t *mp, void *objp);
+  size_t chPoolAllocNI(memory_pool_t *mp, void **objs, size_t n);
+  size_t chPoolAllocN(memory_pool_t *mp, void **objs, size_t n);
+  void chPoolFreeNI(memory_pool_t *mp, void * const *objs, size_t n);
+  void chPoolFreeN(memory_pool_t *mp, void * const *objs, size_t n);
+  void chPoolMagazineObjectInit(pool_magazine_t *mgp, memory_pool_t *mp,
+                                void **objs, size_t size);
+  void *chPoolMagazineAlloc(pool_magazine_t *mgp);
+  void chPoolMagazineFree(pool_magazine_t *mgp, void *objp);
+  void chPoolMagazineFlush(pool_magazine_t *mgp);
 #if CH_CFG_USE_SEMAPHORES == TRUE
   void chGuardedPoolObjectInitAligned(guarded_memory_pool_t *gmp,
                                       size_t size,
@@ -164,6 +187,14 @@ extern "C" {
   void *chGuardedPoolAllocTimeout(guarded_memory_pool_t *gmp,
                                   sysinterval_t timeout);
   void chGuardedPoolFree(guarded_memory_pool_t *gmp, void *objp);
+  size_t chGuardedPoolAllocNTimeoutS(guarded_memory_pool_t *gmp,
+                                     void **objs, size_t n,
+                                     sysinterval_t timeout);
+  size_t chGuardedPoolAllocNTimeout(guarded_memory_pool_t *gmp,
+                                    void **objs, size_t n,
+                                    sysinterval_t timeout);
+  void chGuardedPoolFreeN(guarded_memory_pool_t *gmp,
+                          void * const *objs, size_t n);
 #endif
 #ifdef __cplusplus
 }
@@ -231,6 +262,19 @@ static inline void chPoolAddI(memory_pool_t *mp, void *objp) {
   chPoolFreeI(mp, objp);
 }
 
+/**
+ * @brief   Returns the number of objects cached in a magazine.
+ *
+ * @param[in] mgp       pointer to a @p pool_magazine_t structure
+ * @return              The number of cached objects.
+ *
+ * @xclass
+ */
+static inline size_t chPoolMagazineGetCount(pool_magazine_t *mgp) {
+
+  return mgp->cnt;
+}
+
 #if (CH_CFG_USE_SEMAPHORES == TRUE) || defined(__DOXYGEN__)
 /**
  * @brief   Initializes an empty guarded memory pool.
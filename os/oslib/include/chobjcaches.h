@@ -107,6 +107,37 @@ typedef bool (*oc_writef_t)(objects_cache_t *ocp,
                             oc_object_t *objp,
                             bool async);
 
+/**
+ * @brief   Type of a cache statistics structure.
+ */
+typedef struct {
+  /**
+   * @brief   Objects found in cache.
+   */
+  ucnt_t                hits;
+  /**
+   * @brief   Objects not found in cache.
+   */
+  ucnt_t                misses;
+  /**
+   * @brief   Cached objects discarded in order to reuse their buffers.
+   */
+  ucnt_t                evictions;
+  /**
+   * @brief   Lazy writes performed on eviction, the requesting thread
+   *          waited for them.
+   */
+  ucnt_t                lazy_writes;
+  /**
+   * @brief   Write-back operations performed ahead of eviction.
+   */
+  ucnt_t                write_backs;
+  /**
+   * @brief   Read-ahead operations started.
+   */
+  ucnt_t                read_aheads;
+} oc_stats_t;
+
 /**
  * @brief   Structure representing an hash table element.
  */
@@ -141,6 +172,14 @@ struct ch_oc_lru_header {
    * @brief   Previous in the LRU list.
    */
   oc_object_t           *lru_prev;
+  /**
+   * @brief   Next in the dirty objects list.
+   */
+  oc_object_t           *dirty_next;
+  /**
+   * @brief   Previous in the dirty objects list.
+   */
+  oc_object_t           *dirty_prev;
 };
 
 /**
@@ -163,6 +202,14 @@ struct ch_oc_object {
    * @brief   Previous in the LRU list.
    */
   oc_object_t           *lru_prev;
+  /**
+   * @brief   Next in the dirty objects list.
+   */
+  oc_object_t           *dirty_next;
+  /**
+   * @brief   Previous in the dirty objects list.
+   */
+  oc_object_t           *dirty_prev;
   /**
    * @brief   Object group.
    */
@@ -213,6 +260,8 @@ struct ch_objects_cache {
   void                  *objvp;
   /**
    * @brief   LRU list header.
+   * @note    It is also the header of the dirty objects list, the objects
+   *          in the LRU list requiring a lazy write, in LRU order.
    */
   oc_lru_header_t       lru;
   /**
@@ -231,6 +280,42 @@ struct ch_objects_cache {
    * @brief   Writer functions for cached objects.
    */
   oc_writef_t           writef;
+  /**
+   * @brief   Number of objects in the LRU list requiring a lazy write.
+   */
+  ucnt_t                dirtyn;
+  /**
+   * @brief   Write-back start threshold, zero if disabled.
+   */
+  ucnt_t                wb_high;
+  /**
+   * @brief   Write-back stop threshold.
+   */
+  ucnt_t                wb_low;
+  /**
+   * @brief   Semaphore signaling the write-back dispatcher.
+   */
+  semaphore_t           wb_sem;
+  /**
+   * @brief   Number of objects read ahead, zero if disabled.
+   */
+  ucnt_t                ra_depth;
+  /**
+   * @brief   Group of the last retrieved object.
+   */
+  uint32_t              ra_group;
+  /**
+   * @brief   Key of the last retrieved object.
+   */
+  uint32_t              ra_key;
+  /**
+   * @brief   Sequential access detected on the last retrieved object.
+   */
+  bool                  ra_seq;
+  /**
+   * @brief   Cache statistics.
+   */
+  oc_stats_t            stats;
 };
 
 /*===========================================================================*/
@@ -255,6 +340,9 @@ extern "C" {
   oc_object_t *chCacheGetObject(objects_cache_t *ocp,
                                 uint32_t group,
                                 uint32_t key);
+  oc_object_t *chCacheLookupObject(objects_cache_t *ocp,
+                                   uint32_t group,
+                                   uint32_t key);
   void chCacheReleaseObjectI(objects_cache_t *ocp,
                              oc_object_t *objp);
   bool chCacheReadObject(objects_cache_t *ocp,
@@ -263,6 +351,14 @@ extern "C" {
   bool chCacheWriteObject(objects_cache_t *ocp,
                           oc_object_t *objp,
                           bool async);
+  void chCacheSetWriteBack(objects_cache_t *ocp,
+                           ucnt_t high,
+                           ucnt_t low);
+  msg_t chCacheWriteBackTimeout(objects_cache_t *ocp,
+                                sysinterval_t timeout);
+  void chCacheSetReadAhead(objects_cache_t *ocp, ucnt_t depth);
+  void chCacheGetStats(objects_cache_t *ocp, oc_stats_t *statsp);
+  void chCacheResetStats(objects_cache_t *ocp);
 #ifdef __cplusplus
 }
 #endif
@@ -280,7 +376,8 @@ extern "C" {
  *          - @p OC_FLAG_NOTSYNC invalidates the object and queues it on
  *            the LRU tail.
  *          - @p OC_FLAG_LAZYWRITE is ignored and kept, a write will occur
- *            when the object is removed from the LRU list (lazy write).
+ *            when the object is removed from the LRU list (lazy write) or
+ *            earlier by the write-back dispatcher.
  *          .
  *
  * @param[in] ocp       pointer to the @p objects_cache_t structure
@@ -38,6 +38,19 @@
 /* Module pre-compile time settings.                                         */
 /*===========================================================================*/
 
+/**
+ * @brief   Single producer single consumer pipes.
+ * @details If enabled then pipes are restricted to a single writer thread
+ *          and a single reader thread. Each side only updates its own
+ *          pointer and counter so data transfers do not require locking,
+ *          the zero-copy reserve/commit and peek/release APIs become
+ *          available.
+ * @note    The default is @p FALSE.
+ */
+#if !defined(CH_CFG_PIPES_SPSC) || defined(__DOXYGEN__)
+#define CH_CFG_PIPES_SPSC                   FALSE
+#endif
+
 /*===========================================================================*/
 /* Derived constants and error checks.                                       */
 /*===========================================================================*/
@@ -56,10 +69,21 @@ typedef struct {
                                                     after the buffer.       */
   uint8_t               *wrptr;         /**< @brief Write pointer.          */
   uint8_t               *rdptr;         /**< @brief Read pointer.           */
+#if (CH_CFG_PIPES_SPSC == FALSE) || defined(__DOXYGEN__)
   size_t                cnt;            /**< @brief Bytes in the pipe.      */
+#endif
+#if (CH_CFG_PIPES_SPSC == TRUE) || defined(__DOXYGEN__)
+  volatile size_t       wrcnt;          /**< @brief Total bytes written,
+                                                    updated by the writer
+                                                    only.                   */
+  volatile size_t       rdcnt;          /**< @brief Total bytes read,
+                                                    updated by the reader
+                                                    only.                   */
+#endif
   bool                  reset;          /**< @brief True if in reset state. */
   thread_reference_t    wtr;            /**< @brief Waiting writer.         */
   thread_reference_t    rtr;            /**< @brief Waiting reader.         */
+#if (CH_CFG_PIPES_SPSC == FALSE) || defined(__DOXYGEN__)
 #if (CH_CFG_USE_MUTEXES == TRUE) || defined(__DOXYGEN__)
   mutex_t               cmtx;           /**< @brief Common access mutex.    */
   mutex_t               wmtx;           /**< @brief Write access mutex.     */
@@ -69,6 +93,7 @@ typedef struct {
   semaphore_t           wsem;           /**< @brief Write access semaphore. */
   semaphore_t           rsem;           /**< @brief Read access semaphore.  */
 #endif
+#endif
 } pipe_t;
 
 /*===========================================================================*/
@@ -84,7 +109,19 @@ typedef struct {
  * @param[in] buffer    pointer to the pipe buffer array of @p uint8_t
  * @param[in] size      number of @p uint8_t elements in the buffer array
  */
-#if (CH_CFG_USE_MUTEXES == TRUE) || defined(__DOXYGEN__)
+#if (CH_CFG_PIPES_SPSC == TRUE) || defined(__DOXYGEN__)
+#define _PIPE_DATA(name, buffer, size) {                                    \
+  (uint8_t *)(buffer),                                                      \
+  (uint8_t *)(buffer) + size,                                               \
+  (uint8_t *)(buffer),                                                      \
+  (uint8_t *)(buffer),                                                      \
+  (size_t)0,                                                                \
+  (size_t)0,                                                                \
+  false,                                                                    \
+  NULL,                                                                     \
+  NULL,                                                                     \
+}
+#elif CH_CFG_USE_MUTEXES == TRUE
 #define _PIPE_DATA(name, buffer, size) {                                    \
   (uint8_t *)(buffer),                                                      \
   (uint8_t *)(buffer) + size,                                               \
@@ -139,6 +176,14 @@ extern "C" {
                             size_t n, sysinterval_t timeout);
   size_t chPipeReadTimeout(pipe_t *pp, uint8_t *bp,
                            size_t n, sysinterval_t timeout);
+#if (CH_CFG_PIPES_SPSC == TRUE) || defined(__DOXYGEN__)
+  uint8_t *chPipeWriteReserveTimeout(pipe_t *pp, size_t *np,
+                                     sysinterval_t timeout);
+  void chPipeWriteCommit(pipe_t *pp, size_t n);
+  const uint8_t *chPipeReadPeekTimeout(pipe_t *pp, size_t *np,
+                                       sysinterval_t timeout);
+  void chPipeReadRelease(pipe_t *pp, size_t n);
+#endif
 #ifdef __cplusplus
 }
 #endif
@@ -173,7 +218,11 @@ static inline size_t chPipeGetSize(const pipe_t *pp) {
  */
 static inline size_t chPipeGetUsedCount(const pipe_t *pp) {
 
+#if CH_CFG_PIPES_SPSC == FALSE
   return pp->cnt;
+#else
+  return pp->wrcnt - pp->rdcnt;
+#endif
 }
 
 /**
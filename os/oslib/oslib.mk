@@ -35,6 +35,9 @@ endif
 ifneq ($(findstring CH_CFG_USE_DELEGATES TRUE,$(CHLIBCONF)),)
 LIBSRC += $(CHIBIOS)/os/oslib/src/chdelegates.c
 endif
+ifneq ($(findstring CH_CFG_USE_JOBS TRUE,$(CHLIBCONF)),)
+LIBSRC += $(CHIBIOS)/os/oslib/src/chjobs.c
+endif
 ifneq ($(findstring CH_CFG_USE_FACTORY TRUE,$(CHLIBCONF)),)
 LIBSRC += $(CHIBIOS)/os/oslib/src/chfactory.c
 endif
@@ -46,6 +49,7 @@ LIBSRC := $(CHIBIOS)/os/oslib/src/chmboxes.c \
           $(CHIBIOS)/os/oslib/src/chpipes.c \
           $(CHIBIOS)/os/oslib/src/chobjcaches.c \
           $(CHIBIOS)/os/oslib/src/chdelegates.c \
+          $(CHIBIOS)/os/oslib/src/chjobs.c \
           $(CHIBIOS)/os/oslib/src/chfactory.c
 endif
 
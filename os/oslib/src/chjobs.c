@@ -0,0 +1,377 @@
+/*
+    ChibiOS - Copyright (C) 2006..2018 Giovanni Di Sirio.
+
+    This file is part of ChibiOS.
+
+    ChibiOS is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 3 of the License, or
+    (at your option) any later version.
+
+    ChibiOS is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/**
+ * @file    chjobs.c
+ * @brief   Jobs Dispatchers code.
+ * @details Jobs dispatchers.
+ *          <h2>Operation mode</h2>
+ *          A jobs dispatcher holds posted jobs in a set of priority lanes,
+ *          any number of worker threads can dispatch jobs from the same
+ *          dispatcher. A worker waking up takes, within a single critical
+ *          zone, up to @p batch jobs already pending starting from the
+ *          highest priority lane then executes them. Jobs posted while a
+ *          worker is executing a batch are taken by another worker or in
+ *          the next batch, whatever their priority.<br>
+ *          A job can have a completion function, invoked by the worker
+ *          after the job function, and a future that any number of
+ *          threads can wait on, the future also carries the job result.
+ * @pre     In order to use the jobs dispatchers APIs the
+ *          @p CH_CFG_USE_JOBS option must be enabled in @p chconf.h.
+ * @note    Compatible with RT and NIL.
+ *
+ * @addtogroup oslib_jobs_queues
+ * @{
+ */
+
+#include "ch.h"
+
+#if (CH_CFG_USE_JOBS == TRUE) || defined(__DOXYGEN__)
+
+/*===========================================================================*/
+/* Module local definitions.                                                 */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Module exported variables.                                                */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Module local types.                                                       */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Module local variables.                                                   */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Module local functions.                                                   */
+/*===========================================================================*/
+
+/**
+ * @brief   Removes the highest priority job from the lanes.
+ * @note    A job must be present, the caller must have already consumed
+ *          a @p pending semaphore count.
+ *
+ * @param[in] jdp       pointer to a @p jobs_dispatcher_t structure
+ * @return              The pointer to the removed job object.
+ */
+static job_descriptor_t *job_remove_i(jobs_dispatcher_t *jdp) {
+  jobs_lane_t *lp = &jdp->lanes[0];
+  job_descriptor_t *jp;
+
+  while (lp->head == NULL) {
+    lp++;
+    chDbgAssert(lp < &jdp->lanes[CH_CFG_JOBS_LANES], "no jobs");
+  }
+
+  jp = lp->head;
+  lp->head = jp->next;
+  if (lp->head == NULL) {
+    lp->tail = NULL;
+  }
+
+  return jp;
+}
+
+#if defined(_CHIBIOS_RT_) || defined(__DOXYGEN__)
+/**
+ * @brief   Worker thread function.
+ *
+ * @param[in] arg       pointer to a @p jobs_dispatcher_t structure
+ */
+static THD_FUNCTION(job_worker, arg) {
+  jobs_dispatcher_t *jdp = (jobs_dispatcher_t *)arg;
+  msg_t msg;
+
+  do {
+    msg = chJobDispatcherDispatch(jdp);
+  } while (msg == MSG_OK);
+
+  chThdExit(msg);
+}
+#endif
+
+/*===========================================================================*/
+/* Module exported functions.                                                */
+/*===========================================================================*/
+
+/**
+ * @brief   Initializes a jobs dispatcher object.
+ *
+ * @param[out] jdp      pointer to a @p jobs_dispatcher_t structure
+ * @param[in] jobsn     number of jobs available
+ * @param[in] jobsbuf   pointer to the buffer of jobs, it must be able
+ *                      to hold @p jobsn @p job_descriptor_t structures
+ * @param[in] batch     maximum number of jobs executed by a worker for
+ *                      each wakeup, one disables batching
+ *
+ * @init
+ */
+void chJobDispatcherObjectInit(jobs_dispatcher_t *jdp,
+                               size_t jobsn,
+                               job_descriptor_t *jobsbuf,
+                               size_t batch) {
+  unsigned i;
+
+  chDbgCheck((jdp != NULL) && (jobsn > 0U) && (jobsbuf != NULL) &&
+             (batch > 0U));
+
+  chGuardedPoolObjectInit(&jdp->free, sizeof (job_descriptor_t));
+  chGuardedPoolLoadArray(&jdp->free, (void *)jobsbuf, jobsn);
+  chSemObjectInit(&jdp->pending, (cnt_t)0);
+  jdp->batch = batch;
+  for (i = 0U; i < (unsigned)CH_CFG_JOBS_LANES; i++) {
+    jdp->lanes[i].head = NULL;
+    jdp->lanes[i].tail = NULL;
+  }
+}
+
+/**
+ * @brief   Posts a job object in a lane.
+ * @note    By design the object can be always immediately posted.
+ * @note    A job with @p jobfunc set to @p NULL makes the worker receiving
+ *          it return @p MSG_JOB_NULL after executing the jobs preceding it
+ *          in the same batch.
+ *
+ * @param[in] jdp       pointer to a @p jobs_dispatcher_t structure
+ * @param[in] jp        pointer to the job object to be posted
+ * @param[in] lane      priority lane, zero is the highest priority
+ *
+ * @iclass
+ */
+void chJobDispatcherPostI(jobs_dispatcher_t *jdp,
+                          job_descriptor_t *jp,
+                          unsigned lane) {
+  jobs_lane_t *lp;
+
+  chDbgCheckClassI();
+  chDbgCheck((jdp != NULL) && (jp != NULL) &&
+             (lane < (unsigned)CH_CFG_JOBS_LANES));
+
+  lp = &jdp->lanes[lane];
+  jp->next = NULL;
+  if (lp->tail == NULL) {
+    lp->head = jp;
+  }
+  else {
+    lp->tail->next = jp;
+  }
+  lp->tail = jp;
+
+  chSemSignalI(&jdp->pending);
+}
+
+/**
+ * @brief   Posts a job object in a lane.
+ * @note    By design the object can be always immediately posted.
+ *
+ * @param[in] jdp       pointer to a @p jobs_dispatcher_t structure
+ * @param[in] jp        pointer to the job object to be posted
+ * @param[in] lane      priority lane, zero is the highest priority
+ *
+ * @sclass
+ */
+void chJobDispatcherPostS(jobs_dispatcher_t *jdp,
+                          job_descriptor_t *jp,
+                          unsigned lane) {
+
+  chDbgCheckClassS();
+
+  chJobDispatcherPostI(jdp, jp, lane);
+  chSchRescheduleS();
+}
+
+/**
+ * @brief   Posts a job object in a lane.
+ * @note    By design the object can be always immediately posted.
+ *
+ * @param[in] jdp       pointer to a @p jobs_dispatcher_t structure
+ * @param[in] jp        pointer to the job object to be posted
+ * @param[in] lane      priority lane, zero is the highest priority
+ *
+ * @api
+ */
+void chJobDispatcherPost(jobs_dispatcher_t *jdp,
+                         job_descriptor_t *jp,
+                         unsigned lane) {
+
+  chSysLock();
+  chJobDispatcherPostS(jdp, jp, lane);
+  chSysUnlock();
+}
+
+/**
+ * @brief   Waits for jobs then executes them.
+ * @details The calling thread takes the highest priority pending job and,
+ *          without waiting further, up to @p batch - 1 more pending jobs
+ *          then executes them in priority order. Each executed job is
+ *          followed by its completion function and its future, if any.
+ *
+ * @param[in] jdp       pointer to a @p jobs_dispatcher_t structure
+ * @param[in] timeout   the number of ticks before the operation timeouts,
+ *                      the following special values are allowed:
+ *                      - @a TIME_IMMEDIATE immediate timeout.
+ *                      - @a TIME_INFINITE no timeout.
+ *                      .
+ * @return              The function outcome.
+ * @retval MSG_OK       if jobs have been executed.
+ * @retval MSG_TIMEOUT  if a timeout occurred.
+ * @retval MSG_JOB_NULL if a @p JOB_NULL has been received.
+ *
+ * @api
+ */
+msg_t chJobDispatcherDispatchTimeout(jobs_dispatcher_t *jdp,
+                                     sysinterval_t timeout) {
+  job_descriptor_t *head, *jp;
+  size_t n;
+  msg_t msg;
+
+  chDbgCheck(jdp != NULL);
+
+  chSysLock();
+
+  /* Waiting for a job or a timeout.*/
+  msg = chSemWaitTimeoutS(&jdp->pending, timeout);
+  if (msg != MSG_OK) {
+    chSysUnlock();
+    return msg;
+  }
+
+  /* Taking the first job and the jobs already pending, up to the batch
+     size, a null job terminates the batch.*/
+  head = job_remove_i(jdp);
+  jp   = head;
+  n    = 1U;
+  while ((jp->jobfunc != NULL) && (n < jdp->batch) &&
+         (chSemGetCounterI(&jdp->pending) > (cnt_t)0)) {
+    chSemFastWaitI(&jdp->pending);
+    jp->next = job_remove_i(jdp);
+    jp = jp->next;
+    n++;
+  }
+  jp->next = NULL;
+
+  chSysUnlock();
+
+  /* Executing the batch.*/
+  while (head != NULL) {
+    jp   = head;
+    head = jp->next;
+
+    if (jp->jobfunc != NULL) {
+
+      /* Invoking the job function then the completion function.*/
+      jp->jobfunc(jp->jobarg);
+      if (jp->donefunc != NULL) {
+        jp->donefunc(jp->jobarg);
+      }
+    }
+    else {
+      msg = MSG_JOB_NULL;
+    }
+
+    /* Completing the future, if any.*/
+    if (jp->future != NULL) {
+      chSysLock();
+      jp->future->done = true;
+      chThdDequeueAllI(&jp->future->waiting, MSG_OK);
+      chSchRescheduleS();
+      chSysUnlock();
+    }
+
+    /* Returning the job descriptor object.*/
+    chGuardedPoolFree(&jdp->free, (void *)jp);
+  }
+
+  return msg;
+}
+
+#if defined(_CHIBIOS_RT_) || defined(__DOXYGEN__)
+/**
+ * @brief   Creates a worker thread for a dispatcher.
+ * @details The worker thread dispatches jobs until a @p JOB_NULL is
+ *          received then terminates, the exit code is @p MSG_JOB_NULL.
+ *
+ * @param[in] jdp       pointer to a @p jobs_dispatcher_t structure
+ * @param[in] name      name of the worker thread
+ * @param[out] wsp      pointer to a working area dedicated to the thread
+ * @param[in] size      size of the working area
+ * @param[in] prio      priority level for the worker thread
+ * @return              The pointer to the @p thread_t structure of the
+ *                      worker thread.
+ *
+ * @api
+ */
+thread_t *chJobDispatcherCreateWorker(jobs_dispatcher_t *jdp,
+                                      const char *name,
+                                      void *wsp, size_t size,
+                                      tprio_t prio) {
+  thread_descriptor_t td = {
+    .name  = name,
+    .wbase = (stkalign_t *)wsp,
+    .wend  = (stkalign_t *)((uint8_t *)wsp + size),
+    .prio  = prio,
+    .funcp = job_worker,
+    .arg   = (void *)jdp
+  };
+
+  chDbgCheck(jdp != NULL);
+
+  return chThdCreate(&td);
+}
+#endif
+
+/**
+ * @brief   Waits for the completion of the job associated to a future.
+ * @note    Any number of threads can wait on a future, the job result
+ *          is returned by @p chJobFutureGetResultX().
+ *
+ * @param[in] fp        pointer to a @p job_future_t structure
+ * @param[in] timeout   the number of ticks before the operation timeouts,
+ *                      the following special values are allowed:
+ *                      - @a TIME_IMMEDIATE immediate timeout.
+ *                      - @a TIME_INFINITE no timeout.
+ *                      .
+ * @return              The wait outcome.
+ * @retval MSG_OK       if the job completed.
+ * @retval MSG_TIMEOUT  if a timeout occurred.
+ *
+ * @api
+ */
+msg_t chJobFutureWaitTimeout(job_future_t *fp, sysinterval_t timeout) {
+  msg_t msg;
+
+  chDbgCheck(fp != NULL);
+
+  chSysLock();
+  if (fp->done) {
+    msg = MSG_OK;
+  }
+  else {
+    msg = chThdEnqueueTimeoutS(&fp->waiting, timeout);
+  }
+  chSysUnlock();
+
+  return msg;
+}
+
+#endif /* CH_CFG_USE_JOBS == TRUE */
+
+/** @} */
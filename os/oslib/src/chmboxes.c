@@ -210,6 +210,7 @@ msg_t chMBPostTimeoutS(mailbox_t *mbp, msg_t msg, sysinterval_t timeout) {
         mbp->wrptr = mbp->buffer;
       }
       mbp->cnt++;
+      _trace_sync(CH_TRACE_SYNC_MBX_POST, mbp, msg);
 
       /* If there is a reader waiting then makes it ready.*/
       chThdDequeueNextI(&mbp->qr, MSG_OK);
@@ -257,6 +258,7 @@ msg_t chMBPostI(mailbox_t *mbp, msg_t msg) {
       mbp->wrptr = mbp->buffer;
     }
     mbp->cnt++;
+    _trace_sync(CH_TRACE_SYNC_MBX_POST, mbp, msg);
 
     /* If there is a reader waiting then makes it ready.*/
     chThdDequeueNextI(&mbp->qr, MSG_OK);
@@ -335,6 +337,7 @@ msg_t chMBPostAheadTimeoutS(mailbox_t *mbp, msg_t msg, sysinterval_t timeout) {
       }
       *mbp->rdptr = msg;
       mbp->cnt++;
+      _trace_sync(CH_TRACE_SYNC_MBX_POST, mbp, msg);
 
       /* If there is a reader waiting then makes it ready.*/
       chThdDequeueNextI(&mbp->qr, MSG_OK);
@@ -382,6 +385,7 @@ msg_t chMBPostAheadI(mailbox_t *mbp, msg_t msg) {
     }
     *mbp->rdptr = msg;
     mbp->cnt++;
+    _trace_sync(CH_TRACE_SYNC_MBX_POST, mbp, msg);
 
     /* If there is a reader waiting then makes it ready.*/
     chThdDequeueNextI(&mbp->qr, MSG_OK);
@@ -460,6 +464,7 @@ msg_t chMBFetchTimeoutS(mailbox_t *mbp, msg_t *msgp, sysinterval_t timeout) {
         mbp->rdptr = mbp->buffer;
       }
       mbp->cnt--;
+      _trace_sync(CH_TRACE_SYNC_MBX_FETCH, mbp, *msgp);
 
       /* If there is a writer waiting then makes it ready.*/
       chThdDequeueNextI(&mbp->qw, MSG_OK);
@@ -507,6 +512,7 @@ msg_t chMBFetchI(mailbox_t *mbp, msg_t *msgp) {
       mbp->rdptr = mbp->buffer;
     }
     mbp->cnt--;
+    _trace_sync(CH_TRACE_SYNC_MBX_FETCH, mbp, *msgp);
 
     /* If there is a writer waiting then makes it ready.*/
     chThdDequeueNextI(&mbp->qw, MSG_OK);
@@ -29,6 +29,12 @@
  *          library functions. The main difference is that the OS heap APIs
  *          are guaranteed to be thread safe and there is the ability to
  *          return memory blocks aligned to arbitrary powers of two.<br>
+ *          If @p CH_CFG_USE_HEAP_TLSF is enabled then a two-level
+ *          segregated fit allocator is used instead, free blocks are kept
+ *          in lists indexed by size class and two bitmaps allow to locate
+ *          a suitable block in constant time, allocation and release are
+ *          O(1). A single heap can also span multiple disjoint memory
+ *          regions.<br>
  * @pre     In order to use the heap APIs the @p CH_CFG_USE_HEAP option must
  *          be enabled in @p chconf.h.
  * @note    Compatible with RT and NIL.
@@ -54,6 +60,7 @@
 #define H_UNLOCK(h)     chSemSignal(&(h)->sem)
 #endif
 
+#if CH_CFG_USE_HEAP_TLSF == FALSE
 #define H_BLOCK(hp)     ((hp) + 1U)
 
 #define H_LIMIT(hp)     (H_BLOCK(hp) + H_PAGES(hp))
@@ -74,6 +81,53 @@
   ((size_t)((p1) - (p2)))                                                   \
   /*lint -restore*/
 
+#else /* CH_CFG_USE_HEAP_TLSF == TRUE */
+/*
+ * Block status flags, stored in the least significant bits of the size.
+ */
+#define H_FREE          ((size_t)1)
+#define H_PFREE         ((size_t)2)
+#define H_FLAGS         (H_FREE | H_PFREE)
+
+#define H_BLOCK(hp)     ((hp) + 1U)
+
+#define H_LIMIT(hp)                                                         \
+  ((heap_header_t *)(void *)((uint8_t *)H_BLOCK(hp) + H_BSIZE(hp)))
+
+#define H_NEXT(hp)      ((hp)->free.next)
+
+#define H_PREV(hp)      (*(heap_header_t **)(void *)H_BLOCK(hp))
+
+#define H_BACK(hp)      (((heap_header_t **)(void *)H_LIMIT(hp))[-1])
+
+#define H_PHYS(hp)      (((heap_header_t **)(void *)(hp))[-1])
+
+#define H_BSIZE(hp)     ((hp)->free.size & ~H_FLAGS)
+
+#define H_HEAP(hp)      ((hp)->used.heap)
+
+#define H_IS_FREE(hp)   (((hp)->free.size & H_FREE) != (size_t)0)
+
+#define H_IS_PFREE(hp)  (((hp)->free.size & H_PFREE) != (size_t)0)
+
+/*
+ * Smallest block, an header plus an area able to contain the free block
+ * links.
+ */
+#define H_MIN_BLOCK     (sizeof (heap_header_t) + CH_HEAP_ALIGNMENT)
+
+/*
+ * Largest block area.
+ */
+#define H_MAX_SIZE                                                          \
+  (((size_t)1 << CH_CFG_HEAP_TLSF_FL_MAX) - CH_HEAP_ALIGNMENT)
+
+/*
+ * Smallest size mapped in the non-linear classes.
+ */
+#define H_SMALL_SIZE    ((size_t)1 << CH_HEAP_TLSF_FL_SHIFT)
+#endif /* CH_CFG_USE_HEAP_TLSF == TRUE */
+
 /*===========================================================================*/
 /* Module exported variables.                                                */
 /*===========================================================================*/
@@ -95,10 +149,331 @@ static memory_heap_t default_heap;
 /* Module local functions.                                                   */
 /*===========================================================================*/
 
+#if CH_CFG_USE_HEAP_TLSF == TRUE
+/**
+ * @brief   Returns the index of the most significant bit set.
+ *
+ * @param[in] x         the value, must not be zero
+ * @return              The bit index.
+ */
+static inline unsigned heap_fls(size_t x) {
+#if defined(__GNUC__)
+
+  return (((unsigned)sizeof (unsigned long) * 8U) - 1U) -
+         (unsigned)__builtin_clzl((unsigned long)x);
+#else
+  unsigned n = 0U, s = (unsigned)sizeof (size_t) * 4U;
+
+  while (s > 0U) {
+    if ((x >> s) != (size_t)0) {
+      x >>= s;
+      n += s;
+    }
+    s >>= 1;
+  }
+
+  return n;
+#endif
+}
+
+/**
+ * @brief   Returns the index of the least significant bit set.
+ *
+ * @param[in] x         the value, must not be zero
+ * @return              The bit index.
+ */
+static inline unsigned heap_ffs(uint32_t x) {
+#if defined(__GNUC__)
+
+  return (unsigned)__builtin_ctzl((unsigned long)x);
+#else
+  unsigned n = 0U;
+
+  if ((x & 0x0000FFFFU) == 0U) {
+    n += 16U;
+    x >>= 16;
+  }
+  if ((x & 0x000000FFU) == 0U) {
+    n += 8U;
+    x >>= 8;
+  }
+  if ((x & 0x0000000FU) == 0U) {
+    n += 4U;
+    x >>= 4;
+  }
+  if ((x & 0x00000003U) == 0U) {
+    n += 2U;
+    x >>= 2;
+  }
+  if ((x & 0x00000001U) == 0U) {
+    n += 1U;
+  }
+
+  return n;
+#endif
+}
+
+/**
+ * @brief   Maps a block size to its free list.
+ *
+ * @param[in] size      the block size
+ * @param[out] flp      first level index
+ * @param[out] slp      second level index
+ */
+static void heap_mapping(size_t size, unsigned *flp, unsigned *slp) {
+
+  if (size < H_SMALL_SIZE) {
+    /* Small blocks are kept in linearly spaced lists.*/
+    *flp = 0U;
+    *slp = (unsigned)(size >> CH_HEAP_ALIGNMENT_LOG2);
+  }
+  else {
+    unsigned fl = heap_fls(size);
+
+    *slp = (unsigned)(size >> (fl - CH_CFG_HEAP_TLSF_SL_LOG2)) ^
+           CH_HEAP_TLSF_SL_COUNT;
+    *flp = fl - (CH_HEAP_TLSF_FL_SHIFT - 1U);
+  }
+}
+
+/**
+ * @brief   Inserts a free block in its free list.
+ *
+ * @param[in] heapp     pointer to the heap descriptor
+ * @param[in] hp        pointer to the block header
+ */
+static void heap_insert(memory_heap_t *heapp, heap_header_t *hp) {
+  unsigned fl, sl;
+
+  heap_mapping(H_BSIZE(hp), &fl, &sl);
+  H_NEXT(hp) = heapp->lists[fl][sl];
+  H_PREV(hp) = NULL;
+  if (H_NEXT(hp) != NULL) {
+    H_PREV(H_NEXT(hp)) = hp;
+  }
+  heapp->lists[fl][sl] = hp;
+  heapp->flmap     |= (uint32_t)1U << fl;
+  heapp->slmap[fl] |= (uint32_t)1U << sl;
+}
+
+/**
+ * @brief   Removes a free block from its free list.
+ *
+ * @param[in] heapp     pointer to the heap descriptor
+ * @param[in] hp        pointer to the block header
+ */
+static void heap_remove(memory_heap_t *heapp, heap_header_t *hp) {
+  unsigned fl, sl;
+
+  heap_mapping(H_BSIZE(hp), &fl, &sl);
+  if (H_PREV(hp) != NULL) {
+    H_NEXT(H_PREV(hp)) = H_NEXT(hp);
+  }
+  else {
+    heapp->lists[fl][sl] = H_NEXT(hp);
+  }
+  if (H_NEXT(hp) != NULL) {
+    H_PREV(H_NEXT(hp)) = H_PREV(hp);
+  }
+  if (heapp->lists[fl][sl] == NULL) {
+    heapp->slmap[fl] &= ~((uint32_t)1U << sl);
+    if (heapp->slmap[fl] == 0U) {
+      heapp->flmap &= ~((uint32_t)1U << fl);
+    }
+  }
+}
+
+/**
+ * @brief   Finds and removes a free block of at least the specified size.
+ * @details The head of the list containing the size is used if it is large
+ *          enough, else the first block of the next non-empty list is
+ *          taken, any block in that list is large enough.
+ *
+ * @param[in] heapp     pointer to the heap descriptor
+ * @param[in] size      the required block size
+ * @return              Pointer to the block header.
+ * @retval NULL         if a suitable block is not available.
+ */
+static heap_header_t *heap_find(memory_heap_t *heapp, size_t size) {
+  heap_header_t *hp;
+  unsigned fl, sl;
+
+  heap_mapping(size, &fl, &sl);
+  hp = heapp->lists[fl][sl];
+  if ((hp == NULL) || (H_BSIZE(hp) < size)) {
+    uint32_t map;
+
+    /* Next non-empty list in the same first level class.*/
+    map = 0U;
+    if (sl < (CH_HEAP_TLSF_SL_COUNT - 1U)) {
+      map = heapp->slmap[fl] & (~(uint32_t)0U << (sl + 1U));
+    }
+    if (map == 0U) {
+      /* Next non-empty first level class.*/
+      map = heapp->flmap & (~(uint32_t)0U << (fl + 1U));
+      if (map == 0U) {
+        return NULL;
+      }
+      fl  = heap_ffs(map);
+      map = heapp->slmap[fl];
+    }
+    hp = heapp->lists[fl][heap_ffs(map)];
+  }
+  heap_remove(heapp, hp);
+
+  return hp;
+}
+
+/**
+ * @brief   Marks a block as used.
+ * @details The excess space, if large enough, is split and returned to the
+ *          free lists.
+ *
+ * @param[in] heapp     pointer to the heap descriptor
+ * @param[in] hp        pointer to the block header, the block must have
+ *                      been removed from the free lists
+ * @param[in] size      the required size, aligned to @p CH_HEAP_ALIGNMENT
+ */
+static void heap_use(memory_heap_t *heapp, heap_header_t *hp, size_t size) {
+
+  if (H_BSIZE(hp) >= (size + H_MIN_BLOCK)) {
+    heap_header_t *fp;
+
+    /* Splitting the excess, the following block is already marked as
+       having a free block before it.*/
+    /*lint -save -e9087 [11.3] Safe cast.*/
+    fp = (heap_header_t *)(void *)((uint8_t *)H_BLOCK(hp) + size);
+    /*lint -restore*/
+    fp->free.size = (H_BSIZE(hp) - size - sizeof (heap_header_t)) | H_FREE;
+    H_BACK(fp) = fp;
+    heap_insert(heapp, fp);
+    hp->free.size = size | (hp->free.size & H_PFREE);
+  }
+  else {
+    /* Getting the whole block.*/
+    hp->free.size &= ~H_FREE;
+    H_LIMIT(hp)->free.size &= ~H_PFREE;
+  }
+}
+
+/**
+ * @brief   Allocates a block.
+ *
+ * @param[in] heapp     pointer to the heap descriptor
+ * @param[in] req       the size to be searched, it includes the space
+ *                      required for alignment
+ * @param[in] size      the size to be allocated, aligned to
+ *                      @p CH_HEAP_ALIGNMENT
+ * @param[in] align     desired memory alignment
+ * @return              Pointer to the allocated block header.
+ * @retval NULL         if the block cannot be allocated.
+ */
+static heap_header_t *heap_alloc(memory_heap_t *heapp, size_t req,
+                                 size_t size, unsigned align) {
+  heap_header_t *hp, *ahp;
+
+  hp = heap_find(heapp, req);
+  if (hp == NULL) {
+    return NULL;
+  }
+
+  /* Header aligned to the requested alignment.*/
+  ahp = (heap_header_t *)MEM_ALIGN_NEXT(H_BLOCK(hp), align) - 1U;
+  if (ahp != hp) {
+    size_t gap;
+
+    /* The gap before the aligned header must be large enough to be a free
+       block.*/
+    if ((size_t)((uint8_t *)ahp - (uint8_t *)hp) < H_MIN_BLOCK) {
+      /*lint -save -e9087 [11.3] Safe cast.*/
+      ahp = (heap_header_t *)(void *)((uint8_t *)ahp + align);
+      /*lint -restore*/
+    }
+    gap = (size_t)((uint8_t *)ahp - (uint8_t *)hp);
+
+    /* The gap is returned to the free lists, the aligned block inherits
+       the remaining space.*/
+    ahp->free.size = (H_BSIZE(hp) - gap) | H_FREE | H_PFREE;
+    hp->free.size  = (gap - sizeof (heap_header_t)) |
+                     (hp->free.size & H_FLAGS);
+    H_BACK(hp) = hp;
+    heap_insert(heapp, hp);
+    hp = ahp;
+  }
+
+  heap_use(heapp, hp, size);
+
+  return hp;
+}
+
+/**
+ * @brief   Adds a memory region to an heap.
+ * @details The region is split in free blocks not larger than the blocks
+ *          size limit, a terminator block prevents merging with memory
+ *          outside the region.
+ *
+ * @param[in] heapp     pointer to the heap descriptor
+ * @param[in] buf       region base
+ * @param[in] size      region size
+ */
+static void heap_add_region(memory_heap_t *heapp, void *buf, size_t size) {
+  heap_header_t *hp = (heap_header_t *)MEM_ALIGN_NEXT(buf, CH_HEAP_ALIGNMENT);
+  size_t flags = (size_t)0;
+
+  /* Adjusting the size in case the region was not correctly aligned, the
+     space for the terminator is reserved.*/
+  /*lint -save -e9033 [10.8] Required cast operations.*/
+  size -= (size_t)((uint8_t *)hp - (uint8_t *)buf);
+  /*lint -restore*/
+  size  = MEM_ALIGN_PREV(size, CH_HEAP_ALIGNMENT);
+
+  chDbgAssert(size >= (H_MIN_BLOCK + sizeof (heap_header_t)),
+              "region too small");
+
+  size -= sizeof (heap_header_t);
+  while (size >= H_MIN_BLOCK) {
+    size_t bsize = size - sizeof (heap_header_t);
+
+    if (bsize > H_MAX_SIZE) {
+      bsize = H_MAX_SIZE;
+    }
+    hp->free.size = bsize | H_FREE | flags;
+    H_BACK(hp) = hp;
+    heap_insert(heapp, hp);
+    size  -= bsize + sizeof (heap_header_t);
+    flags  = H_PFREE;
+    hp     = H_LIMIT(hp);
+  }
+
+  /* Terminator, a permanently used empty block.*/
+  H_HEAP(hp)    = NULL;
+  hp->used.size = flags;
+}
+
+/**
+ * @brief   Initializes the TLSF structures of an heap.
+ *
+ * @param[out] heapp    pointer to the heap descriptor
+ */
+static void heap_init(memory_heap_t *heapp) {
+  unsigned fl, sl;
+
+  heapp->flmap = 0U;
+  for (fl = 0U; fl < CH_HEAP_TLSF_FL_COUNT; fl++) {
+    heapp->slmap[fl] = 0U;
+    for (sl = 0U; sl < CH_HEAP_TLSF_SL_COUNT; sl++) {
+      heapp->lists[fl][sl] = NULL;
+    }
+  }
+}
+#endif /* CH_CFG_USE_HEAP_TLSF == TRUE */
+
 /*===========================================================================*/
 /* Module exported functions.                                                */
 /*===========================================================================*/
 
+#if (CH_CFG_USE_HEAP_TLSF == FALSE) || defined(__DOXYGEN__)
+
 /**
  * @brief   Initializes the default heap.
  *
@@ -152,6 +527,44 @@ void chHeapObjectInit(memory_heap_t *heapp, void *buf, size_t size) {
 #endif
 }
 
+/**
+ * @brief   Adds a memory region to a memory heap.
+ * @details Regions do not need to be contiguous, a single heap can span
+ *          several memory areas.
+ * @note    The region base and size are adjusted if the passed buffer
+ *          is not aligned to @p CH_HEAP_ALIGNMENT.
+ *
+ * @param[in] heapp     pointer to a heap descriptor or @p NULL in order to
+ *                      access the default heap.
+ * @param[in] buf       region base
+ * @param[in] size      region size
+ *
+ * @api
+ */
+void chHeapAddRegion(memory_heap_t *heapp, void *buf, size_t size) {
+  heap_header_t *hp = (heap_header_t *)MEM_ALIGN_NEXT(buf, CH_HEAP_ALIGNMENT);
+
+  chDbgCheck((buf != NULL) && (size > 0U));
+
+  /* If an heap is not specified then the default system header is used.*/
+  if (heapp == NULL) {
+    heapp = &default_heap;
+  }
+
+  /* Adjusting the size in case the region was not correctly aligned.*/
+  /*lint -save -e9033 [10.8] Required cast operations.*/
+  size -= (size_t)((uint8_t *)hp - (uint8_t *)buf);
+  /*lint -restore*/
+  size  = MEM_ALIGN_PREV(size, CH_HEAP_ALIGNMENT);
+
+  chDbgAssert(size > sizeof (heap_header_t), "region too small");
+
+  /* The region is inserted in the free blocks list as a released block.*/
+  H_HEAP(hp) = heapp;
+  H_SIZE(hp) = size - sizeof (heap_header_t);
+  chHeapFree(H_BLOCK(hp));
+}
+
 /**
  * @brief   Allocates a block of memory from the heap by using the first-fit
  *          algorithm.
@@ -394,6 +807,276 @@ size_t chHeapStatus(memory_heap_t *heapp, size_t *totalp, size_t *largestp) {
   return n;
 }
 
+#else /* CH_CFG_USE_HEAP_TLSF == TRUE */
+/**
+ * @brief   Initializes the default heap.
+ *
+ * @notapi
+ */
+void _heap_init(void) {
+
+  default_heap.provider = chCoreAllocAlignedWithOffset;
+  heap_init(&default_heap);
+#if (CH_CFG_USE_MUTEXES == TRUE) || defined(__DOXYGEN__)
+  chMtxObjectInit(&default_heap.mtx);
+#else
+  chSemObjectInit(&default_heap.sem, (cnt_t)1);
+#endif
+}
+
+/**
+ * @brief   Initializes a memory heap from a static memory area.
+ * @note    The heap buffer base and size are adjusted if the passed buffer
+ *          is not aligned to @p CH_HEAP_ALIGNMENT. This mean that the
+ *          effective heap size can be less than @p size.
+ *
+ * @param[out] heapp    pointer to the memory heap descriptor to be initialized
+ * @param[in] buf       heap buffer base
+ * @param[in] size      heap size
+ *
+ * @init
+ */
+void chHeapObjectInit(memory_heap_t *heapp, void *buf, size_t size) {
+
+  chDbgCheck((heapp != NULL) && (buf != NULL) && (size > 0U));
+
+  heapp->provider = NULL;
+  heap_init(heapp);
+  heap_add_region(heapp, buf, size);
+#if (CH_CFG_USE_MUTEXES == TRUE) || defined(__DOXYGEN__)
+  chMtxObjectInit(&heapp->mtx);
+#else
+  chSemObjectInit(&heapp->sem, (cnt_t)1);
+#endif
+}
+
+/**
+ * @brief   Adds a memory region to a memory heap.
+ * @details Regions do not need to be contiguous, a single heap can span
+ *          several memory areas.
+ *
+ * @param[in] heapp     pointer to a heap descriptor or @p NULL in order to
+ *                      access the default heap.
+ * @param[in] buf       region base
+ * @param[in] size      region size
+ *
+ * @api
+ */
+void chHeapAddRegion(memory_heap_t *heapp, void *buf, size_t size) {
+
+  chDbgCheck((buf != NULL) && (size > 0U));
+
+  /* If an heap is not specified then the default system header is used.*/
+  if (heapp == NULL) {
+    heapp = &default_heap;
+  }
+
+  H_LOCK(heapp);
+  heap_add_region(heapp, buf, size);
+  H_UNLOCK(heapp);
+}
+
+/**
+ * @brief   Allocates a block of memory from the heap by using the TLSF
+ *          algorithm.
+ * @details The allocated block is guaranteed to be properly aligned to the
+ *          specified alignment.
+ *
+ * @param[in] heapp     pointer to a heap descriptor or @p NULL in order to
+ *                      access the default heap.
+ * @param[in] size      the size of the block to be allocated. Note that the
+ *                      allocated block may be a bit bigger than the requested
+ *                      size for alignment and fragmentation reasons.
+ * @param[in] align     desired memory alignment
+ * @return              A pointer to the aligned allocated block.
+ * @retval NULL         if the block cannot be allocated.
+ *
+ * @api
+ */
+void *chHeapAllocAligned(memory_heap_t *heapp, size_t size, unsigned align) {
+  heap_header_t *hp;
+  size_t req;
+
+  chDbgCheck((size > 0U) && MEM_IS_VALID_ALIGNMENT(align));
+
+  /* If an heap is not specified then the default system header is used.*/
+  if (heapp == NULL) {
+    heapp = &default_heap;
+  }
+
+  /* Minimum alignment is constrained by the heap header structure size.*/
+  if (align < CH_HEAP_ALIGNMENT) {
+    align = CH_HEAP_ALIGNMENT;
+  }
+
+  /* Blocks larger than the limit cannot exist.*/
+  if (size > H_MAX_SIZE) {
+    return NULL;
+  }
+
+  /* Size is aligned to the elementary allocation unit, the searched size
+     includes the worst case space lost for alignment, it is also subject
+     to the limit because it is mapped on the free lists.*/
+  size = MEM_ALIGN_NEXT(size, CH_HEAP_ALIGNMENT);
+  req  = size;
+  if (align > CH_HEAP_ALIGNMENT) {
+    if (((size_t)align + H_MIN_BLOCK) > (H_MAX_SIZE - size)) {
+      return NULL;
+    }
+    req += (size_t)align + H_MIN_BLOCK;
+  }
+
+  /* Taking heap mutex/semaphore.*/
+  H_LOCK(heapp);
+
+  hp = heap_alloc(heapp, req, size, align);
+
+  /* Releasing heap mutex/semaphore.*/
+  H_UNLOCK(heapp);
+
+  /* More memory is required, tries to get a new region from the associated
+     provider else fails.*/
+  if ((hp == NULL) && (heapp->provider != NULL)) {
+    size_t rsize = req + (2U * sizeof (heap_header_t));
+    void *rp;
+
+    rp = heapp->provider(rsize, CH_HEAP_ALIGNMENT, 0U);
+    if (rp != NULL) {
+      H_LOCK(heapp);
+      heap_add_region(heapp, rp, rsize);
+      hp = heap_alloc(heapp, req, size, align);
+      H_UNLOCK(heapp);
+    }
+  }
+
+  if (hp == NULL) {
+    return NULL;
+  }
+
+  /* Setting in the block owner heap.*/
+  H_HEAP(hp) = heapp;
+
+  /*lint -save -e9087 [11.3] Safe cast.*/
+  return (void *)H_BLOCK(hp);
+  /*lint -restore*/
+}
+
+/**
+ * @brief   Frees a previously allocated memory block.
+ *
+ * @param[in] p         pointer to the memory block to be freed
+ *
+ * @api
+ */
+void chHeapFree(void *p) {
+  heap_header_t *hp, *np;
+  memory_heap_t *heapp;
+
+  chDbgCheck((p != NULL) && MEM_IS_ALIGNED(p, CH_HEAP_ALIGNMENT));
+
+  /*lint -save -e9087 [11.3] Safe cast.*/
+  hp = (heap_header_t *)p - 1U;
+  /*lint -restore*/
+  heapp = H_HEAP(hp);
+
+  chDbgAssert(!H_IS_FREE(hp), "not allocated");
+
+  /* Taking heap mutex/semaphore.*/
+  H_LOCK(heapp);
+
+  hp->free.size |= H_FREE;
+
+  /* Merging with the previous block, if free and if the result is within
+     the blocks size limit.*/
+  if (H_IS_PFREE(hp)) {
+    heap_header_t *pp = H_PHYS(hp);
+
+    if ((H_BSIZE(pp) + sizeof (heap_header_t) + H_BSIZE(hp)) <= H_MAX_SIZE) {
+      heap_remove(heapp, pp);
+      pp->free.size += sizeof (heap_header_t) + H_BSIZE(hp);
+      hp = pp;
+    }
+  }
+
+  /* Merging with the next block, same conditions.*/
+  np = H_LIMIT(hp);
+  if (H_IS_FREE(np) &&
+      ((H_BSIZE(hp) + sizeof (heap_header_t) + H_BSIZE(np)) <= H_MAX_SIZE)) {
+    heap_remove(heapp, np);
+    hp->free.size += sizeof (heap_header_t) + H_BSIZE(np);
+  }
+
+  /* Linking the free block.*/
+  H_BACK(hp) = hp;
+  H_LIMIT(hp)->free.size |= H_PFREE;
+  heap_insert(heapp, hp);
+
+  /* Releasing heap mutex/semaphore.*/
+  H_UNLOCK(heapp);
+}
+
+/**
+ * @brief   Reports the heap status.
+ * @note    This function is meant to be used in the test suite, it should
+ *          not be really useful for the application code.
+ * @note    The execution time depends on the number of free blocks.
+ *
+ * @param[in] heapp     pointer to a heap descriptor or @p NULL in order to
+ *                      access the default heap.
+ * @param[in] totalp    pointer to a variable that will receive the total
+ *                      fragmented free space or @p NULL
+ * @param[in] largestp  pointer to a variable that will receive the largest
+ *                      free free block found space or @p NULL
+ * @return              The number of fragments in the heap.
+ *
+ * @api
+ */
+size_t chHeapStatus(memory_heap_t *heapp, size_t *totalp, size_t *largestp) {
+  size_t n, total, largest;
+  unsigned fl, sl;
+
+  if (heapp == NULL) {
+    heapp = &default_heap;
+  }
+
+  H_LOCK(heapp);
+  total   = (size_t)0;
+  largest = (size_t)0;
+  n       = (size_t)0;
+  for (fl = 0U; fl < CH_HEAP_TLSF_FL_COUNT; fl++) {
+    for (sl = 0U; sl < CH_HEAP_TLSF_SL_COUNT; sl++) {
+      heap_header_t *hp = heapp->lists[fl][sl];
+
+      while (hp != NULL) {
+        size_t size = H_BSIZE(hp);
+
+        /* Updating counters.*/
+        n++;
+        total += size;
+        if (size > largest) {
+          largest = size;
+        }
+
+        hp = H_NEXT(hp);
+      }
+    }
+  }
+
+  /* Writing out fragmented free memory.*/
+  if (totalp != NULL) {
+    *totalp = total;
+  }
+
+  /* Writing out unfragmented free memory.*/
+  if (largestp != NULL) {
+    *largestp = largest;
+  }
+  H_UNLOCK(heapp);
+
+  return n;
+}
+#endif /* CH_CFG_USE_HEAP_TLSF == TRUE */
+
 #endif /* CH_CFG_USE_HEAP == TRUE */
 
 /** @} */
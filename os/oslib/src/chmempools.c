@@ -29,7 +29,15 @@
  *          problems.<br>
  *          Memory Pools do not enforce any alignment constraint on the
  *          contained object however the objects must be properly aligned
- *          to contain a pointer to void.
+ *          to contain a pointer to void.<br>
+ *          Objects can be moved in batches using @p chPoolAllocN() and
+ *          @p chPoolFreeN(), a single critical section is used for the
+ *          whole batch. Threads allocating and releasing objects at high
+ *          rate can also place a magazine in front of a pool, a magazine
+ *          is a private LIFO cache of objects refilled from and drained
+ *          to the pool in batches, most operations do not need to enter
+ *          a critical zone and recently released objects are reused
+ *          first.
  * @pre     In order to use the memory pools APIs the @p CH_CFG_USE_MEMPOOLS option
  *          must be enabled in @p chconf.h.
  * @note    Compatible with RT and NIL.
@@ -211,6 +219,212 @@ void chPoolFree(memory_pool_t *mp, void *objp) {
   chSysUnlock();
 }
 
+/**
+ * @brief   Allocates multiple objects from a memory pool.
+ * @pre     The memory pool must already be initialized.
+ *
+ * @param[in] mp        pointer to a @p memory_pool_t structure
+ * @param[out] objs     array receiving the pointers to the allocated
+ *                      objects
+ * @param[in] n         number of objects to be allocated
+ * @return              The number of allocated objects, it can be less
+ *                      than @p n if the pool runs out of objects.
+ *
+ * @iclass
+ */
+size_t chPoolAllocNI(memory_pool_t *mp, void **objs, size_t n) {
+  size_t i;
+
+  chDbgCheckClassI();
+  chDbgCheck((mp != NULL) && (objs != NULL));
+
+  for (i = 0U; i < n; i++) {
+    objs[i] = chPoolAllocI(mp);
+    if (objs[i] == NULL) {
+      break;
+    }
+  }
+
+  return i;
+}
+
+/**
+ * @brief   Allocates multiple objects from a memory pool.
+ * @details The objects are taken from the pool within a single critical
+ *          zone.
+ * @pre     The memory pool must already be initialized.
+ *
+ * @param[in] mp        pointer to a @p memory_pool_t structure
+ * @param[out] objs     array receiving the pointers to the allocated
+ *                      objects
+ * @param[in] n         number of objects to be allocated
+ * @return              The number of allocated objects, it can be less
+ *                      than @p n if the pool runs out of objects.
+ *
+ * @api
+ */
+size_t chPoolAllocN(memory_pool_t *mp, void **objs, size_t n) {
+  size_t i;
+
+  chSysLock();
+  i = chPoolAllocNI(mp, objs, n);
+  chSysUnlock();
+
+  return i;
+}
+
+/**
+ * @brief   Releases multiple objects into a memory pool.
+ * @pre     The memory pool must already be initialized.
+ * @pre     The freed objects must be of the right size for the specified
+ *          memory pool.
+ * @pre     The freed objects must be properly aligned.
+ *
+ * @param[in] mp        pointer to a @p memory_pool_t structure
+ * @param[in] objs      array of pointers to the objects to be released
+ * @param[in] n         number of objects to be released
+ *
+ * @iclass
+ */
+void chPoolFreeNI(memory_pool_t *mp, void * const *objs, size_t n) {
+  size_t i;
+
+  chDbgCheckClassI();
+  chDbgCheck((mp != NULL) && (objs != NULL));
+
+  for (i = 0U; i < n; i++) {
+    chPoolFreeI(mp, objs[i]);
+  }
+}
+
+/**
+ * @brief   Releases multiple objects into a memory pool.
+ * @details The objects are returned to the pool within a single critical
+ *          zone.
+ * @pre     The memory pool must already be initialized.
+ * @pre     The freed objects must be of the right size for the specified
+ *          memory pool.
+ * @pre     The freed objects must be properly aligned.
+ *
+ * @param[in] mp        pointer to a @p memory_pool_t structure
+ * @param[in] objs      array of pointers to the objects to be released
+ * @param[in] n         number of objects to be released
+ *
+ * @api
+ */
+void chPoolFreeN(memory_pool_t *mp, void * const *objs, size_t n) {
+
+  chSysLock();
+  chPoolFreeNI(mp, objs, n);
+  chSysUnlock();
+}
+
+/**
+ * @brief   Initializes a memory pool magazine.
+ * @note    The magazine is not thread safe, it must be accessed by a
+ *          single thread, or from a single core.
+ * @note    Objects cached in a magazine are not available to other users
+ *          of the pool, use @p chPoolMagazineFlush() in order to return
+ *          them.
+ *
+ * @param[out] mgp      pointer to a @p pool_magazine_t structure
+ * @param[in] mp        pointer to the backing @p memory_pool_t structure
+ * @param[in] objs      array used as cache storage
+ * @param[in] size      number of elements in the @p objs array, objects
+ *                      are exchanged with the pool in batches of half
+ *                      this size
+ *
+ * @init
+ */
+void chPoolMagazineObjectInit(pool_magazine_t *mgp, memory_pool_t *mp,
+                              void **objs, size_t size) {
+
+  chDbgCheck((mgp != NULL) && (mp != NULL) && (objs != NULL) &&
+             (size >= 2U));
+
+  mgp->pool = mp;
+  mgp->objs = objs;
+  mgp->size = size;
+  mgp->cnt  = 0U;
+}
+
+/**
+ * @brief   Allocates an object through a magazine.
+ * @details The object is taken from the magazine, if the magazine is
+ *          empty then it is refilled with half its capacity from the
+ *          pool first.
+ *
+ * @param[in] mgp       pointer to a @p pool_magazine_t structure
+ * @return              The pointer to the allocated object.
+ * @retval NULL         if both the magazine and the pool are empty.
+ *
+ * @api
+ */
+void *chPoolMagazineAlloc(pool_magazine_t *mgp) {
+
+  chDbgCheck(mgp != NULL);
+
+  if (mgp->cnt == 0U) {
+    mgp->cnt = chPoolAllocN(mgp->pool, mgp->objs, mgp->size / 2U);
+    if (mgp->cnt == 0U) {
+      return NULL;
+    }
+  }
+
+  mgp->cnt--;
+  return mgp->objs[mgp->cnt];
+}
+
+/**
+ * @brief   Releases an object through a magazine.
+ * @details The object is cached into the magazine, if the magazine is
+ *          full then half its content is returned to the pool first.
+ * @pre     The freed object must be of the right size for the backing
+ *          memory pool.
+ * @pre     The freed object must be properly aligned.
+ *
+ * @param[in] mgp       pointer to a @p pool_magazine_t structure
+ * @param[in] objp      the pointer to the object to be released
+ *
+ * @api
+ */
+void chPoolMagazineFree(pool_magazine_t *mgp, void *objp) {
+
+  chDbgCheck((mgp != NULL) && (objp != NULL));
+
+  if (mgp->cnt >= mgp->size) {
+    size_t i, n = mgp->size / 2U;
+
+    /* The oldest objects are returned, the recently released ones are
+       kept in the magazine.*/
+    chPoolFreeN(mgp->pool, mgp->objs, n);
+    mgp->cnt -= n;
+    for (i = 0U; i < mgp->cnt; i++) {
+      mgp->objs[i] = mgp->objs[i + n];
+    }
+  }
+
+  mgp->objs[mgp->cnt] = objp;
+  mgp->cnt++;
+}
+
+/**
+ * @brief   Returns all the cached objects to the backing pool.
+ *
+ * @param[in] mgp       pointer to a @p pool_magazine_t structure
+ *
+ * @api
+ */
+void chPoolMagazineFlush(pool_magazine_t *mgp) {
+
+  chDbgCheck(mgp != NULL);
+
+  if (mgp->cnt > 0U) {
+    chPoolFreeN(mgp->pool, mgp->objs, mgp->cnt);
+    mgp->cnt = 0U;
+  }
+}
+
 #if (CH_CFG_USE_SEMAPHORES == TRUE) || defined(__DOXYGEN__)
 /**
  * @brief   Initializes an empty guarded memory pool.
@@ -329,6 +543,111 @@ void chGuardedPoolFree(guarded_memory_pool_t *gmp, void *objp) {
   chSchRescheduleS();
   chSysUnlock();
 }
+
+/**
+ * @brief   Allocates multiple objects from a guarded memory pool.
+ * @details The function waits for the first object then takes as many
+ *          of the immediately available objects as possible, up to
+ *          @p n, without waiting again.
+ * @pre     The guarded memory pool must already be initialized.
+ *
+ * @param[in] gmp       pointer to a @p guarded_memory_pool_t structure
+ * @param[out] objs     array receiving the pointers to the allocated
+ *                      objects
+ * @param[in] n         maximum number of objects to be allocated
+ * @param[in] timeout   the number of ticks before the operation timeouts,
+ *                      the following special values are allowed:
+ *                      - @a TIME_IMMEDIATE immediate timeout.
+ *                      - @a TIME_INFINITE no timeout.
+ *                      .
+ * @return              The number of allocated objects.
+ * @retval 0            if the operation timed out.
+ *
+ * @sclass
+ */
+size_t chGuardedPoolAllocNTimeoutS(guarded_memory_pool_t *gmp,
+                                   void **objs, size_t n,
+                                   sysinterval_t timeout) {
+  msg_t msg;
+  size_t i;
+
+  chDbgCheck((gmp != NULL) && (objs != NULL) && (n > 0U));
+
+  msg = chSemWaitTimeoutS(&gmp->sem, timeout);
+  if (msg != MSG_OK) {
+    return (size_t)0;
+  }
+
+  objs[0] = chPoolAllocI(&gmp->pool);
+  for (i = 1U; (i < n) && (chSemGetCounterI(&gmp->sem) > (cnt_t)0); i++) {
+    chSemFastWaitI(&gmp->sem);
+    objs[i] = chPoolAllocI(&gmp->pool);
+  }
+
+  return i;
+}
+
+/**
+ * @brief   Allocates multiple objects from a guarded memory pool.
+ * @details The function waits for the first object then takes as many
+ *          of the immediately available objects as possible, up to
+ *          @p n, without waiting again.
+ * @pre     The guarded memory pool must already be initialized.
+ *
+ * @param[in] gmp       pointer to a @p guarded_memory_pool_t structure
+ * @param[out] objs     array receiving the pointers to the allocated
+ *                      objects
+ * @param[in] n         maximum number of objects to be allocated
+ * @param[in] timeout   the number of ticks before the operation timeouts,
+ *                      the following special values are allowed:
+ *                      - @a TIME_IMMEDIATE immediate timeout.
+ *                      - @a TIME_INFINITE no timeout.
+ *                      .
+ * @return              The number of allocated objects.
+ * @retval 0            if the operation timed out.
+ *
+ * @api
+ */
+size_t chGuardedPoolAllocNTimeout(guarded_memory_pool_t *gmp,
+                                  void **objs, size_t n,
+                                  sysinterval_t timeout) {
+  size_t i;
+
+  chSysLock();
+  i = chGuardedPoolAllocNTimeoutS(gmp, objs, n, timeout);
+  chSysUnlock();
+
+  return i;
+}
+
+/**
+ * @brief   Releases multiple objects into a guarded memory pool.
+ * @details The objects are returned to the pool and the waiting threads
+ *          are signaled within a single critical zone.
+ * @pre     The guarded memory pool must already be initialized.
+ * @pre     The freed objects must be of the right size for the specified
+ *          guarded memory pool.
+ * @pre     The freed objects must be properly aligned.
+ *
+ * @param[in] gmp       pointer to a @p guarded_memory_pool_t structure
+ * @param[in] objs      array of pointers to the objects to be released
+ * @param[in] n         number of objects to be released
+ *
+ * @api
+ */
+void chGuardedPoolFreeN(guarded_memory_pool_t *gmp,
+                        void * const *objs, size_t n) {
+  size_t i;
+
+  chDbgCheck((gmp != NULL) && (objs != NULL));
+
+  chSysLock();
+  for (i = 0U; i < n; i++) {
+    chGuardedPoolFreeI(gmp, objs[i]);
+  }
+  chSchRescheduleS();
+  chSysUnlock();
+}
 #endif
 
 #endif /* CH_CFG_USE_MEMPOOLS == TRUE */
@@ -43,6 +43,16 @@
  *          - <b>Release Object</b>: Releases an object to the cache handling
  *            the media update, if required.
  *          .
+ *          Optional features:
+ *          - <b>Write-back</b>: Objects marked for lazy write are written
+ *            ahead of eviction by a dispatcher thread calling
+ *            @p chCacheWriteBackTimeout(), the number of dirty objects
+ *            is kept between configurable thresholds so that threads
+ *            requesting a buffer do not wait for the media.
+ *          - <b>Read-ahead</b>: When sequential access to the keys of a
+ *            group is detected then the following keys are read
+ *            asynchronously into the cache.
+ *          .
  * @pre     In order to use the pipes APIs the @p CH_CFG_USE_OBJ_CACHES
  *          option must be enabled in @p chconf.h.
  * @note    Compatible with RT and NIL.
@@ -103,6 +113,28 @@
   (objp)->lru_next->lru_prev = (objp)->lru_prev;                            \
 }
 
+/* Insertion on dirty list head (newer objects).*/
+#define DIRTY_INSERT_HEAD(ocp, objp) {                                      \
+  (objp)->dirty_next = (ocp)->lru.dirty_next;                               \
+  (objp)->dirty_prev = (oc_object_t *)&(ocp)->lru;                          \
+  (ocp)->lru.dirty_next->dirty_prev = (objp);                               \
+  (ocp)->lru.dirty_next = (objp);                                           \
+}
+
+/* Insertion on dirty list tail (older objects).*/
+#define DIRTY_INSERT_TAIL(ocp, objp) {                                      \
+  (objp)->dirty_prev = (ocp)->lru.dirty_prev;                               \
+  (objp)->dirty_next = (oc_object_t *)&(ocp)->lru;                          \
+  (ocp)->lru.dirty_prev->dirty_next = (objp);                               \
+  (ocp)->lru.dirty_prev = (objp);                                           \
+}
+
+/* Removal of an object from the dirty list.*/
+#define DIRTY_REMOVE(objp) {                                                \
+  (objp)->dirty_prev->dirty_next = (objp)->dirty_next;                      \
+  (objp)->dirty_next->dirty_prev = (objp)->dirty_prev;                      \
+}
+
 /*===========================================================================*/
 /* Module exported variables.                                                */
 /*===========================================================================*/
@@ -119,6 +151,23 @@
 /* Module local functions.                                                   */
 /*===========================================================================*/
 
+/**
+ * @brief   Clears the cache statistics.
+ *
+ * @param[in] ocp       pointer to the @p objects_cache_t structure
+ *
+ * @notapi
+ */
+static void stats_reset(objects_cache_t *ocp) {
+
+  ocp->stats.hits        = (ucnt_t)0;
+  ocp->stats.misses      = (ucnt_t)0;
+  ocp->stats.evictions   = (ucnt_t)0;
+  ocp->stats.lazy_writes = (ucnt_t)0;
+  ocp->stats.write_backs = (ucnt_t)0;
+  ocp->stats.read_aheads = (ucnt_t)0;
+}
+
 /**
  * @brief   Returns an object pointer from the cache, if present.
  *
@@ -154,6 +203,53 @@ static oc_object_t *hash_get_s(objects_cache_t *ocp,
   return NULL;
 }
 
+/**
+ * @brief   Removes an object from the LRU list taking ownership of it.
+ *
+ * @param[in] ocp       pointer to the @p objects_cache_t structure
+ * @param[in] objp      pointer to the @p oc_object_t structure
+ *
+ * @notapi
+ */
+static void lru_remove_s(objects_cache_t *ocp, oc_object_t *objp) {
+
+  chDbgAssert((objp->obj_flags & OC_FLAG_INLRU) == OC_FLAG_INLRU,
+              "not in LRU");
+  chDbgAssert(chSemGetCounterI(&objp->obj_sem) == (cnt_t)1,
+              "semaphore counter not 1");
+
+  LRU_REMOVE(objp);
+  objp->obj_flags &= ~OC_FLAG_INLRU;
+  if ((objp->obj_flags & OC_FLAG_LAZYWRITE) != 0U) {
+    DIRTY_REMOVE(objp);
+    ocp->dirtyn--;
+  }
+
+  /* Getting the object semaphore, we know there is no wait so
+     using the "fast" variant.*/
+  chSemFastWaitI(&objp->obj_sem);
+}
+
+/**
+ * @brief   Prepares an object buffer taken from the LRU list for reuse.
+ *
+ * @param[in] ocp       pointer to the @p objects_cache_t structure
+ * @param[in] objp      pointer to the @p oc_object_t structure
+ *
+ * @notapi
+ */
+static void lru_reuse_s(objects_cache_t *ocp, oc_object_t *objp) {
+
+  /* Removing from hash table if required.*/
+  if ((objp->obj_flags & OC_FLAG_INHASH) != 0U) {
+    HASH_REMOVE(objp);
+    ocp->stats.evictions++;
+  }
+
+  /* Removing all flags, it is "new" now.*/
+  objp->obj_flags = 0U;
+}
+
 /**
  * @brief   Gets the least recently used object buffer from the LRU list.
  *
@@ -172,34 +268,17 @@ static oc_object_t *lru_get_last_s(objects_cache_t *ocp) {
     /* Now an object buffer is in the LRU for sure, taking it from the
        LRU tail.*/
     objp = ocp->lru.lru_prev;
-
-    chDbgAssert((objp->obj_flags & OC_FLAG_INLRU) == OC_FLAG_INLRU,
-                "not in LRU");
-    chDbgAssert(chSemGetCounterI(&objp->obj_sem) == (cnt_t)1,
-                "semaphore counter not 1");
-
-    LRU_REMOVE(objp);
-    objp->obj_flags &= ~OC_FLAG_INLRU;
-
-    /* Getting the object semaphore, we know there is no wait so
-       using the "fast" variant.*/
-    chSemFastWaitI(&objp->obj_sem);
+    lru_remove_s(ocp, objp);
 
     /* If it is a buffer not needing (lazy) write then it can be used
        right away.*/
     if ((objp->obj_flags & OC_FLAG_LAZYWRITE) == 0U) {
-
-      /* Removing from hash table if required.*/
-      if ((objp->obj_flags & OC_FLAG_INHASH) != 0U) {
-        HASH_REMOVE(objp);
-      }
-
-      /* Removing all flags, it is "new" now.*/
-      objp->obj_flags = 0U;
+      lru_reuse_s(ocp, objp);
 
       return objp;
     }
 
+    ocp->stats.lazy_writes++;
 
     /* Out of critical section.*/
     chSysUnlock();
@@ -215,6 +294,108 @@ static oc_object_t *lru_get_last_s(objects_cache_t *ocp) {
   }
 }
 
+/**
+ * @brief   Gets the least recently used object buffer without waiting.
+ * @details The object is only returned if it can be reused immediately,
+ *          objects requiring a lazy write are not taken.
+ *
+ * @param[in] ocp       pointer to the @p objects_cache_t structure
+ * @return              The pointer to the retrieved object.
+ * @retval NULL         if there is no object immediately reusable.
+ *
+ * @notapi
+ */
+static oc_object_t *lru_get_clean_s(objects_cache_t *ocp) {
+  oc_object_t *objp;
+
+  if (chSemGetCounterI(&ocp->lru_sem) <= (cnt_t)0) {
+    return NULL;
+  }
+
+  objp = ocp->lru.lru_prev;
+  if ((objp->obj_flags & OC_FLAG_LAZYWRITE) != 0U) {
+    return NULL;
+  }
+
+  chSemFastWaitI(&ocp->lru_sem);
+  lru_remove_s(ocp, objp);
+  lru_reuse_s(ocp, objp);
+
+  return objp;
+}
+
+/**
+ * @brief   Gets the dirty object closest to the LRU tail.
+ * @note    Dirty objects are linked in a separate list kept in LRU order,
+ *          the object is taken from its tail in constant time.
+ *
+ * @param[in] ocp       pointer to the @p objects_cache_t structure
+ * @return              The pointer to the retrieved object.
+ * @retval NULL         if there are no dirty objects in the LRU list.
+ *
+ * @notapi
+ */
+static oc_object_t *lru_get_dirty_s(objects_cache_t *ocp) {
+  oc_object_t *objp;
+
+  objp = ocp->lru.dirty_prev;
+  if (objp == (oc_object_t *)&ocp->lru) {
+    return NULL;
+  }
+
+  chSemFastWaitI(&ocp->lru_sem);
+  lru_remove_s(ocp, objp);
+
+  return objp;
+}
+
+/**
+ * @brief   Starts asynchronous reads of the objects following a key.
+ * @details Only keys not already in cache are read, the operation stops
+ *          if an object buffer is not immediately available.
+ *
+ * @param[in] ocp       pointer to the @p objects_cache_t structure
+ * @param[in] group     object group identifier
+ * @param[in] key       last accessed key within the group
+ *
+ * @notapi
+ */
+static void cache_read_ahead(objects_cache_t *ocp,
+                             uint32_t group,
+                             uint32_t key) {
+  ucnt_t i;
+
+  for (i = (ucnt_t)1; i <= ocp->ra_depth; i++) {
+    oc_object_t *objp;
+
+    chSysLock();
+
+    /* Skipping objects already in cache.*/
+    if (hash_get_s(ocp, group, key + (uint32_t)i) != NULL) {
+      chSysUnlock();
+      continue;
+    }
+
+    /* Read-ahead is opportunistic, it does not wait for buffers.*/
+    objp = lru_get_clean_s(ocp);
+    if (objp == NULL) {
+      chSysUnlock();
+      break;
+    }
+
+    objp->obj_group = group;
+    objp->obj_key   = key + (uint32_t)i;
+    objp->obj_flags = OC_FLAG_INHASH | OC_FLAG_NOTSYNC;
+    HASH_INSERT(ocp, objp, group, objp->obj_key);
+    ocp->stats.read_aheads++;
+
+    chSysUnlock();
+
+    /* The reader releases the object when the operation is complete.*/
+    (void) ocp->readf(ocp, objp, true);
+  }
+}
+
 /*===========================================================================*/
 /* Module exported functions.                                                */
 /*===========================================================================*/
@@ -265,6 +446,17 @@ void chCacheObjectInit(objects_cache_t *ocp,
   ocp->lru.hash_prev    = NULL;
   ocp->lru.lru_next     = (oc_object_t *)&ocp->lru;
   ocp->lru.lru_prev     = (oc_object_t *)&ocp->lru;
+  ocp->lru.dirty_next   = (oc_object_t *)&ocp->lru;
+  ocp->lru.dirty_prev   = (oc_object_t *)&ocp->lru;
+  ocp->dirtyn           = (ucnt_t)0;
+  ocp->wb_high          = (ucnt_t)0;
+  ocp->wb_low           = (ucnt_t)0;
+  chSemObjectInit(&ocp->wb_sem, (cnt_t)0);
+  ocp->ra_depth         = (ucnt_t)0;
+  ocp->ra_group         = 0U;
+  ocp->ra_key           = 0U;
+  ocp->ra_seq           = false;
+  stats_reset(ocp);
 
   /* Hash headers initialization.*/
   do {
@@ -305,10 +497,17 @@ oc_object_t *chCacheGetObject(objects_cache_t *ocp,
                               uint32_t group,
                               uint32_t key) {
   oc_object_t *objp;
+  bool seq;
 
   /* Critical section enter, the hash check operation is fast.*/
   chSysLock();
 
+  /* Sequential access detection.*/
+  seq = (group == ocp->ra_group) && (key == ocp->ra_key + 1U);
+  ocp->ra_group = group;
+  ocp->ra_key   = key;
+  ocp->ra_seq   = seq;
+
   /* Checking the cache for a hit.*/
   objp = hash_get_s(ocp, group, key);
   if (objp != NULL) {
@@ -316,21 +515,15 @@ oc_object_t *chCacheGetObject(objects_cache_t *ocp,
     chDbgAssert((objp->obj_flags & OC_FLAG_INHASH) == OC_FLAG_INHASH,
                 "not in hash");
 
+    ocp->stats.hits++;
+
     /* Cache hit, checking if the buffer is owned by some
        other thread.*/
     if (chSemGetCounterI(&objp->obj_sem) > (cnt_t)0) {
-      /* Not owned case, it is in the LRU list.*/
-
-      chDbgAssert((objp->obj_flags & OC_FLAG_INLRU) == OC_FLAG_INLRU,
-                  "not in LRU");
-
-      /* Removing the object from LRU, now it is "owned".*/
-      LRU_REMOVE(objp);
-      objp->obj_flags &= ~OC_FLAG_INLRU;
-
-      /* Getting the object semaphore, we know there is no wait so
-         using the "fast" variant.*/
-      chSemFastWaitI(&objp->obj_sem);
+      /* Not owned case, it is in the LRU list, removing the object
+         from LRU, now it is "owned".*/
+      chSemFastWaitI(&ocp->lru_sem);
+      lru_remove_s(ocp, objp);
     }
     else {
       /* Owned case, some other thread is playing with this object, we
@@ -343,6 +536,8 @@ oc_object_t *chCacheGetObject(objects_cache_t *ocp,
     }
   }
   else {
+    ocp->stats.misses++;
+
     /* Cache miss, getting an object buffer from the LRU list.*/
     objp = lru_get_last_s(ocp);
 
@@ -353,7 +548,56 @@ oc_object_t *chCacheGetObject(objects_cache_t *ocp,
     HASH_INSERT(ocp, objp, group, key);
   }
 
-  /* Out of critical section and returning the object.*/
+  /* Out of critical section.*/
+  chSysUnlock();
+
+  /* In case of sequential access to objects already in cache the
+     read-ahead is continued from here, on misses it is started after
+     the object itself has been read.*/
+  if (seq && ((objp->obj_flags & OC_FLAG_NOTSYNC) == 0U)) {
+    cache_read_ahead(ocp, group, key);
+  }
+
+  return objp;
+}
+
+/**
+ * @brief   Retrieves an object from the cache only if present.
+ * @details Unlike @p chCacheGetObject() no buffer is allocated on miss,
+ *          the cache content and the statistics are not altered. This
+ *          allows to keep the cache coherent with operations performed
+ *          directly on the media.
+ * @note    If the object is owned by another thread then the function
+ *          waits for its release.
+ *
+ * @param[in] ocp       pointer to the @p objects_cache_t structure
+ * @param[in] group     object group identifier
+ * @param[in] key       object identifier within the group
+ * @return              The pointer to the retrieved object.
+ * @retval NULL         if the object is not in cache.
+ *
+ * @api
+ */
+oc_object_t *chCacheLookupObject(objects_cache_t *ocp,
+                                 uint32_t group,
+                                 uint32_t key) {
+  oc_object_t *objp;
+
+  chSysLock();
+
+  objp = hash_get_s(ocp, group, key);
+  if (objp != NULL) {
+    if (chSemGetCounterI(&objp->obj_sem) > (cnt_t)0) {
+      /* Not owned, removing it from the LRU list.*/
+      chSemFastWaitI(&ocp->lru_sem);
+      lru_remove_s(ocp, objp);
+    }
+    else {
+      /* Owned by another thread, waiting for it.*/
+      (void) chSemWaitS(&objp->obj_sem);
+    }
+  }
+
   chSysUnlock();
 
   return objp;
@@ -417,6 +661,23 @@ void chCacheReleaseObjectI(objects_cache_t *ocp,
       /* Low priority data, placing it on tail.*/
       LRU_INSERT_TAIL(ocp, objp);
     }
+
+    /* Dirty objects are also linked in the dirty list, same insertion
+       point so that the list follows the LRU order, the write-back
+       dispatcher is awakened when the high threshold is reached.*/
+    if ((objp->obj_flags & OC_FLAG_LAZYWRITE) != 0U) {
+      if ((objp->obj_flags & OC_FLAG_FORGET) == 0U) {
+        DIRTY_INSERT_HEAD(ocp, objp);
+      }
+      else {
+        DIRTY_INSERT_TAIL(ocp, objp);
+      }
+      ocp->dirtyn++;
+      if ((ocp->wb_high > (ucnt_t)0) && (ocp->dirtyn >= ocp->wb_high) &&
+          (chSemGetCounterI(&ocp->wb_sem) <= (cnt_t)0)) {
+        chSemSignalI(&ocp->wb_sem);
+      }
+    }
     objp->obj_flags &= OC_FLAG_INHASH | OC_FLAG_LAZYWRITE;
     objp->obj_flags |= OC_FLAG_INLRU;
   }
@@ -449,12 +710,30 @@ bool chCacheReadObject(objects_cache_t *ocp,
                        oc_object_t *objp,
                        bool async) {
 
+  uint32_t group = objp->obj_group;
+  uint32_t key   = objp->obj_key;
+  bool seq, result;
+
+  /* Checking if the object is the last one retrieved in a sequence.*/
+  chSysLock();
+  seq = ocp->ra_seq && (group == ocp->ra_group) && (key == ocp->ra_key);
+  chSysUnlock();
+
   /* Marking it as OC_FLAG_NOTSYNC because the read operation is going
      to corrupt it in case of failure. It is responsibility of the read
      implementation to clear it if the operation succeeds.*/
   objp->obj_flags |= OC_FLAG_NOTSYNC;
 
-  return ocp->readf(ocp, objp, async);
+  result = ocp->readf(ocp, objp, async);
+
+  /* Starting the read-ahead after the requested object, the object itself
+     could have been already released in case of asynchronous operation
+     so using the saved identifiers.*/
+  if (seq) {
+    cache_read_ahead(ocp, group, key);
+  }
+
+  return result;
 }
 
 /**
@@ -484,6 +763,149 @@ bool chCacheWriteObject(objects_cache_t *ocp,
   return ocp->writef(ocp, objp, async);
 }
 
+/**
+ * @brief   Configures the write-back of dirty objects.
+ * @details When the number of objects marked for lazy write in the LRU
+ *          list reaches @p high then the write-back dispatcher is
+ *          awakened and writes objects, starting from the LRU tail,
+ *          until their number drops to @p low.
+ *
+ * @param[in] ocp       pointer to the @p objects_cache_t structure
+ * @param[in] high      write-back start threshold, zero disables the
+ *                      write-back
+ * @param[in] low       write-back stop threshold, must be lower than
+ *                      @p high
+ *
+ * @api
+ */
+void chCacheSetWriteBack(objects_cache_t *ocp,
+                         ucnt_t high,
+                         ucnt_t low) {
+
+  chDbgCheck((ocp != NULL) && ((high == (ucnt_t)0) || (low < high)));
+
+  chSysLock();
+  ocp->wb_high = high;
+  ocp->wb_low  = low;
+  chSysUnlock();
+}
+
+/**
+ * @brief   Write-back dispatcher.
+ * @details This function is meant to be called in loop by a dedicated
+ *          thread. It waits for the dirty objects high threshold to be
+ *          reached then writes objects back until the low threshold is
+ *          reached. On timeout all the dirty objects are written back,
+ *          this allows for periodic flushing of idle caches.
+ * @note    Objects are written using the asynchronous mode of the writer
+ *          function which is responsible for releasing them, written
+ *          objects are queued on the LRU tail.
+ *
+ * @param[in] ocp       pointer to the @p objects_cache_t structure
+ * @param[in] timeout   the number of ticks before the operation timeouts,
+ *                      the following special values are allowed:
+ *                      - @a TIME_IMMEDIATE immediate timeout.
+ *                      - @a TIME_INFINITE no timeout.
+ *                      .
+ * @return              A message specifying how the dispatcher has been
+ *                      awakened.
+ * @retval MSG_OK       if the high threshold has been reached.
+ * @retval MSG_TIMEOUT  if the operation timed out.
+ *
+ * @api
+ */
+msg_t chCacheWriteBackTimeout(objects_cache_t *ocp,
+                              sysinterval_t timeout) {
+  ucnt_t target;
+  msg_t msg;
+
+  chDbgCheck(ocp != NULL);
+
+  chSysLock();
+
+  msg = chSemWaitTimeoutS(&ocp->wb_sem, timeout);
+  target = (msg == MSG_OK) ? ocp->wb_low : (ucnt_t)0;
+
+  while (ocp->dirtyn > target) {
+    oc_object_t *objp = lru_get_dirty_s(ocp);
+
+    if (objp == NULL) {
+      break;
+    }
+
+    ocp->stats.write_backs++;
+
+    chSysUnlock();
+
+    /* Written objects are queued on the LRU tail, they were close to
+       eviction anyway.*/
+    objp->obj_flags = OC_FLAG_INHASH | OC_FLAG_FORGET;
+    (void) ocp->writef(ocp, objp, true);
+
+    chSysLock();
+  }
+
+  chSysUnlock();
+
+  return msg;
+}
+
+/**
+ * @brief   Configures the read-ahead.
+ * @details When sequential access to the keys of a group is detected then
+ *          the following @p depth keys are read asynchronously into the
+ *          cache, objects are read only if a buffer can be reused without
+ *          waiting.
+ *
+ * @param[in] ocp       pointer to the @p objects_cache_t structure
+ * @param[in] depth     number of objects to be read ahead, zero disables
+ *                      the read-ahead
+ *
+ * @api
+ */
+void chCacheSetReadAhead(objects_cache_t *ocp, ucnt_t depth) {
+
+  chDbgCheck((ocp != NULL) && (depth < ocp->objn));
+
+  chSysLock();
+  ocp->ra_depth = depth;
+  chSysUnlock();
+}
+
+/**
+ * @brief   Returns a copy of the cache statistics.
+ *
+ * @param[in] ocp       pointer to the @p objects_cache_t structure
+ * @param[out] statsp   pointer to the @p oc_stats_t structure receiving
+ *                      the statistics
+ *
+ * @api
+ */
+void chCacheGetStats(objects_cache_t *ocp, oc_stats_t *statsp) {
+
+  chDbgCheck((ocp != NULL) && (statsp != NULL));
+
+  chSysLock();
+  *statsp = ocp->stats;
+  chSysUnlock();
+}
+
+/**
+ * @brief   Resets the cache statistics.
+ *
+ * @param[in] ocp       pointer to the @p objects_cache_t structure
+ *
+ * @api
+ */
+void chCacheResetStats(objects_cache_t *ocp) {
+
+  chDbgCheck(ocp != NULL);
+
+  chSysLock();
+  stats_reset(ocp);
+  chSysUnlock();
+}
+
 #endif /* CH_CFG_USE_OBJ_CACHES == TRUE */
 
 /** @} */
@@ -29,6 +29,19 @@
  *          - <b>Reset</b>: The pipe is emptied and all the stored data
  *            is lost.
  *          .
+ *          If @p CH_CFG_PIPES_SPSC is enabled then the pipe can be used
+ *          by a single writer and a single reader thread without any
+ *          locking on the data path, the following zero-copy operations
+ *          are also available:
+ *          - <b>Reserve</b>: A contiguous free region of the pipe buffer
+ *            is returned to the writer to be filled in place.
+ *          - <b>Commit</b>: The data written in a reserved region is made
+ *            available to the reader.
+ *          - <b>Peek</b>: A contiguous region of queued data is returned
+ *            to the reader to be accessed in place.
+ *          - <b>Release</b>: The data previously peeked is removed from
+ *            the pipe.
+ *          .
  * @pre     In order to use the pipes APIs the @p CH_CFG_USE_PIPES
  *          option must be enabled in @p chconf.h.
  * @note    Compatible with RT and NIL.
@@ -48,9 +61,21 @@
 /*===========================================================================*/
 
 /*
- * Defaults on the best synchronization mechanism available.
+ * Defaults on the best synchronization mechanism available, in SPSC mode
+ * each side only updates its own pointer and counter so no serialization
+ * is required.
  */
-#if (CH_CFG_USE_MUTEXES == TRUE) || defined(__DOXYGEN__)
+#if CH_CFG_PIPES_SPSC == TRUE
+#define PC_INIT(p)
+#define PC_LOCK(p)
+#define PC_UNLOCK(p)
+#define PW_INIT(p)
+#define PW_LOCK(p)
+#define PW_UNLOCK(p)
+#define PR_INIT(p)
+#define PR_LOCK(p)
+#define PR_UNLOCK(p)
+#elif (CH_CFG_USE_MUTEXES == TRUE) || defined(__DOXYGEN__)
 #define PC_INIT(p)       chMtxObjectInit(&(p)->cmtx)
 #define PC_LOCK(p)       chMtxLock(&(p)->cmtx)
 #define PC_UNLOCK(p)     chMtxUnlock(&(p)->cmtx)
@@ -72,6 +97,37 @@
 #define PR_UNLOCK(p)     chSemSignal(&(p)->rsem)
 #endif
 
+/*
+ * Compiler barrier, the writer and the reader run on the same core so
+ * ordering the accesses to the buffer and to the counters at compiler
+ * level is sufficient.
+ */
+#if defined(__GNUC__) || defined(__DOXYGEN__)
+#define PIPE_BARRIER()   __asm volatile ("" : : : "memory")
+#else
+#define PIPE_BARRIER()   do {port_lock(); port_unlock();} while (false)
+#endif
+
+/*
+ * Accounting of the transferred bytes, in SPSC mode the counters are
+ * updated after the buffer has been accessed.
+ */
+#if CH_CFG_PIPES_SPSC == FALSE
+#define PIPE_COMMIT_WRITE(p, n)  (p)->cnt += (n)
+#define PIPE_COMMIT_READ(p, n)   (p)->cnt -= (n)
+#else
+#define PIPE_COMMIT_WRITE(p, n)                                             \
+  do {                                                                      \
+    PIPE_BARRIER();                                                         \
+    (p)->wrcnt += (n);                                                      \
+  } while (false)
+#define PIPE_COMMIT_READ(p, n)                                              \
+  do {                                                                      \
+    PIPE_BARRIER();                                                         \
+    (p)->rdcnt += (n);                                                      \
+  } while (false)
+#endif
+
 /*===========================================================================*/
 /* Module exported variables.                                                */
 /*===========================================================================*/
@@ -111,7 +167,6 @@ static size_t pipe_write(pipe_t *pp, const uint8_t *bp, size_t n) {
   if (n > chPipeGetFreeCount(pp)) {
     n = chPipeGetFreeCount(pp);
   }
-  pp->cnt += n;
 
   /* Number of bytes before buffer limit.*/
   /*lint -save -e9033 [10.8] Checked to be safe.*/
@@ -134,6 +189,9 @@ static size_t pipe_write(pipe_t *pp, const uint8_t *bp, size_t n) {
     pp->wrptr = pp->buffer;
   }
 
+  /* Data is in the buffer, making it available to the reader.*/
+  PIPE_COMMIT_WRITE(pp, n);
+
   PC_UNLOCK(pp);
 
   return n;
@@ -162,7 +220,6 @@ static size_t pipe_read(pipe_t *pp, uint8_t *bp, size_t n) {
   if (n > chPipeGetUsedCount(pp)) {
     n = chPipeGetUsedCount(pp);
   }
-  pp->cnt -= n;
 
   /* Number of bytes before buffer limit.*/
   /*lint -save -e9033 [10.8] Checked to be safe.*/
@@ -185,11 +242,75 @@ static size_t pipe_read(pipe_t *pp, uint8_t *bp, size_t n) {
     pp->rdptr = pp->buffer;
   }
 
+  /* Data has been copied out, making the space available to the writer.*/
+  PIPE_COMMIT_READ(pp, n);
+
   PC_UNLOCK(pp);
 
   return n;
 }
 
+/**
+ * @brief   Waits for free space or data in the pipe.
+ * @details The calling thread is suspended unless the awaited condition
+ *          already occurred or the pipe is in reset state. The check is
+ *          performed in the same critical zone of the suspension so a
+ *          wakeup cannot be lost.
+ *
+ * @param[in] pp        the pointer to an initialized @p pipe_t object
+ * @param[in] writer    @p true if waiting for free space, @p false if
+ *                      waiting for data
+ * @param[in] timeout   the number of ticks before the operation timeouts,
+ *                      the following special values are allowed:
+ *                      - @a TIME_IMMEDIATE immediate timeout.
+ *                      - @a TIME_INFINITE no timeout.
+ *                      .
+ * @return              The operation status.
+ * @retval MSG_OK       if the awaited condition occurred.
+ * @retval MSG_TIMEOUT  if the operation timed out.
+ * @retval MSG_RESET    if the pipe went in reset state.
+ *
+ * @notapi
+ */
+static msg_t pipe_wait(pipe_t *pp, bool writer, sysinterval_t timeout) {
+  msg_t msg;
+
+  chSysLock();
+  if (pp->reset) {
+    msg = MSG_RESET;
+  }
+  else if (writer && (chPipeGetFreeCount(pp) == (size_t)0)) {
+    msg = chThdSuspendTimeoutS(&pp->wtr, timeout);
+  }
+  else if (!writer && (chPipeGetUsedCount(pp) == (size_t)0)) {
+    msg = chThdSuspendTimeoutS(&pp->rtr, timeout);
+  }
+  else {
+    msg = MSG_OK;
+  }
+  chSysUnlock();
+
+  return msg;
+}
+
+/**
+ * @brief   Resumes a thread waiting on the pipe, if present.
+ * @note    The reference is checked outside the critical zone, this is
+ *          safe because a thread re-checks the pipe state before
+ *          suspending, see @p pipe_wait().
+ *
+ * @param[in] trp       a pointer to a thread reference object
+ *
+ * @notapi
+ */
+static void pipe_wakeup(thread_reference_t *trp) {
+
+  PIPE_BARRIER();
+  if (*trp != NULL) {
+    chThdResume(trp, MSG_OK);
+  }
+}
+
 /*===========================================================================*/
 /* Module exported functions.                                                */
 /*===========================================================================*/
@@ -212,7 +333,12 @@ void chPipeObjectInit(pipe_t *pp, uint8_t *buf, size_t n) {
   pp->rdptr  = buf;
   pp->wrptr  = buf;
   pp->top    = &buf[n];
+#if CH_CFG_PIPES_SPSC == FALSE
   pp->cnt    = (size_t)0;
+#else
+  pp->wrcnt  = (size_t)0;
+  pp->rdcnt  = (size_t)0;
+#endif
   pp->reset  = false;
   pp->wtr    = NULL;
   pp->rtr    = NULL;
@@ -228,20 +354,41 @@ void chPipeObjectInit(pipe_t *pp, uint8_t *buf, size_t n) {
  * @post    The pipe is in reset state, all operations will fail and
  *          return @p MSG_RESET until the mailbox is enabled again using
  *          @p chPipeResumeX().
+ * @note    In SPSC mode the queued data is discarded by moving the read
+ *          side over it, the function must not be invoked while the
+ *          reader is transferring data out of the pipe.
  *
  * @param[in] pp        the pointer to an initialized @p pipe_t object
  *
  * @api
  */
 void chPipeReset(pipe_t *pp) {
+#if CH_CFG_PIPES_SPSC == TRUE
+  size_t n, s1;
+#endif
 
   chDbgCheck(pp != NULL);
 
   PC_LOCK(pp);
 
+#if CH_CFG_PIPES_SPSC == FALSE
   pp->wrptr = pp->buffer;
   pp->rdptr = pp->buffer;
   pp->cnt   = (size_t)0;
+#else
+  n = chPipeGetUsedCount(pp);
+
+  /*lint -save -e9033 [10.8] Checked to be safe.*/
+  s1 = (size_t)(pp->top - pp->rdptr);
+  /*lint -restore*/
+  if (n < s1) {
+    pp->rdptr += n;
+  }
+  else {
+    pp->rdptr = pp->buffer + (n - s1);
+  }
+  pp->rdcnt += n;
+#endif
   pp->reset = true;
 
   chSysLock();
@@ -295,9 +442,7 @@ size_t chPipeWriteTimeout(pipe_t *pp, const uint8_t *bp,
     if (done == (size_t)0) {
       msg_t msg;
 
-      chSysLock();
-      msg = chThdSuspendTimeoutS(&pp->wtr, timeout);
-      chSysUnlock();
+      msg = pipe_wait(pp, true, timeout);
 
       /* Anything except MSG_OK causes the operation to stop.*/
       if (msg != MSG_OK) {
@@ -309,7 +454,7 @@ size_t chPipeWriteTimeout(pipe_t *pp, const uint8_t *bp,
       bp += done;
 
       /* Resuming the reader, if present.*/
-      chThdResume(&pp->rtr, MSG_OK);
+      pipe_wakeup(&pp->rtr);
     }
   }
 
@@ -360,9 +505,7 @@ size_t chPipeReadTimeout(pipe_t *pp, uint8_t *bp,
     if (done == (size_t)0) {
       msg_t msg;
 
-      chSysLock();
-      msg = chThdSuspendTimeoutS(&pp->rtr, timeout);
-      chSysUnlock();
+      msg = pipe_wait(pp, false, timeout);
 
       /* Anything except MSG_OK causes the operation to stop.*/
       if (msg != MSG_OK) {
@@ -374,7 +517,7 @@ size_t chPipeReadTimeout(pipe_t *pp, uint8_t *bp,
       bp += done;
 
       /* Resuming the writer, if present.*/
-      chThdResume(&pp->wtr, MSG_OK);
+      pipe_wakeup(&pp->wtr);
     }
   }
 
@@ -383,6 +526,179 @@ size_t chPipeReadTimeout(pipe_t *pp, uint8_t *bp,
   return max - n;
 }
 
+#if (CH_CFG_PIPES_SPSC == TRUE) || defined(__DOXYGEN__)
+/**
+ * @brief   Reserves a contiguous free region of a pipe.
+ * @details The function returns the free region starting at the write
+ *          pointer, the writer fills it in place, for example as a DMA
+ *          target, then makes the data available to the reader using
+ *          @p chPipeWriteCommit(). If the pipe is full then the function
+ *          waits for free space.
+ * @note    The region never wraps around the end of the pipe buffer, the
+ *          returned size can be smaller than the free space.
+ * @note    This function can only be called from the writer thread.
+ *
+ * @param[in] pp        the pointer to an initialized @p pipe_t object
+ * @param[out] np       pointer to a variable receiving the size of the
+ *                      reserved region
+ * @param[in] timeout   the number of ticks before the operation timeouts,
+ *                      the following special values are allowed:
+ *                      - @a TIME_IMMEDIATE immediate timeout.
+ *                      - @a TIME_INFINITE no timeout.
+ *                      .
+ * @return              Pointer to the reserved region.
+ * @retval NULL         if a timeout occurred or the pipe went in reset
+ *                      state.
+ *
+ * @api
+ */
+uint8_t *chPipeWriteReserveTimeout(pipe_t *pp, size_t *np,
+                                   sysinterval_t timeout) {
+  size_t n, s1;
+
+  chDbgCheck((pp != NULL) && (np != NULL));
+
+  *np = (size_t)0;
+
+  /* If the pipe is in reset state then returns immediately.*/
+  if (pp->reset) {
+    return NULL;
+  }
+
+  /* Waiting for free space, the fast path does not lock.*/
+  while (chPipeGetFreeCount(pp) == (size_t)0) {
+    if (pipe_wait(pp, true, timeout) != MSG_OK) {
+      return NULL;
+    }
+  }
+
+  /* Free space before buffer limit.*/
+  n = chPipeGetFreeCount(pp);
+  /*lint -save -e9033 [10.8] Checked to be safe.*/
+  s1 = (size_t)(pp->top - pp->wrptr);
+  /*lint -restore*/
+  *np = n < s1 ? n : s1;
+
+  return pp->wrptr;
+}
+
+/**
+ * @brief   Commits data written in a reserved region.
+ * @details The specified amount of bytes, written starting from the pointer
+ *          returned by @p chPipeWriteReserveTimeout(), is made available
+ *          to the reader and the reader is resumed if waiting.
+ * @note    This function can only be called from the writer thread.
+ *
+ * @param[in] pp        the pointer to an initialized @p pipe_t object
+ * @param[in] n         the number of bytes to be committed, it must not
+ *                      exceed the reserved size, the value 0 is reserved
+ *
+ * @api
+ */
+void chPipeWriteCommit(pipe_t *pp, size_t n) {
+
+  chDbgCheck((pp != NULL) && (n > 0U) && (n <= chPipeGetFreeCount(pp)));
+
+  /*lint -save -e9033 [10.8] Checked to be safe.*/
+  chDbgAssert(n <= (size_t)(pp->top - pp->wrptr), "out of region");
+  /*lint -restore*/
+
+  pp->wrptr += n;
+  if (pp->wrptr >= pp->top) {
+    pp->wrptr = pp->buffer;
+  }
+  PIPE_COMMIT_WRITE(pp, n);
+
+  /* Resuming the reader, if present.*/
+  pipe_wakeup(&pp->rtr);
+}
+
+/**
+ * @brief   Returns a contiguous region of queued data.
+ * @details The function returns the queued data starting at the read
+ *          pointer, the reader accesses it in place then frees the space
+ *          using @p chPipeReadRelease(). If the pipe is empty then the
+ *          function waits for data.
+ * @note    The region never wraps around the end of the pipe buffer, the
+ *          returned size can be smaller than the queued data.
+ * @note    This function can only be called from the reader thread.
+ *
+ * @param[in] pp        the pointer to an initialized @p pipe_t object
+ * @param[out] np       pointer to a variable receiving the size of the
+ *                      region
+ * @param[in] timeout   the number of ticks before the operation timeouts,
+ *                      the following special values are allowed:
+ *                      - @a TIME_IMMEDIATE immediate timeout.
+ *                      - @a TIME_INFINITE no timeout.
+ *                      .
+ * @return              Pointer to the queued data.
+ * @retval NULL         if a timeout occurred or the pipe went in reset
+ *                      state.
+ *
+ * @api
+ */
+const uint8_t *chPipeReadPeekTimeout(pipe_t *pp, size_t *np,
+                                     sysinterval_t timeout) {
+  size_t n, s1;
+
+  chDbgCheck((pp != NULL) && (np != NULL));
+
+  *np = (size_t)0;
+
+  /* If the pipe is in reset state then returns immediately.*/
+  if (pp->reset) {
+    return NULL;
+  }
+
+  /* Waiting for data, the fast path does not lock.*/
+  while (chPipeGetUsedCount(pp) == (size_t)0) {
+    if (pipe_wait(pp, false, timeout) != MSG_OK) {
+      return NULL;
+    }
+  }
+
+  /* Queued data before buffer limit.*/
+  n = chPipeGetUsedCount(pp);
+  /*lint -save -e9033 [10.8] Checked to be safe.*/
+  s1 = (size_t)(pp->top - pp->rdptr);
+  /*lint -restore*/
+  *np = n < s1 ? n : s1;
+
+  return pp->rdptr;
+}
+
+/**
+ * @brief   Releases data accessed in place.
+ * @details The specified amount of bytes, starting from the pointer
+ *          returned by @p chPipeReadPeekTimeout(), is removed from the
+ *          pipe and the writer is resumed if waiting.
+ * @note    This function can only be called from the reader thread.
+ *
+ * @param[in] pp        the pointer to an initialized @p pipe_t object
+ * @param[in] n         the number of bytes to be released, it must not
+ *                      exceed the peeked size, the value 0 is reserved
+ *
+ * @api
+ */
+void chPipeReadRelease(pipe_t *pp, size_t n) {
+
+  chDbgCheck((pp != NULL) && (n > 0U) && (n <= chPipeGetUsedCount(pp)));
+
+  /*lint -save -e9033 [10.8] Checked to be safe.*/
+  chDbgAssert(n <= (size_t)(pp->top - pp->rdptr), "out of region");
+  /*lint -restore*/
+
+  pp->rdptr += n;
+  if (pp->rdptr >= pp->top) {
+    pp->rdptr = pp->buffer;
+  }
+  PIPE_COMMIT_READ(pp, n);
+
+  /* Resuming the writer, if present.*/
+  pipe_wakeup(&pp->wtr);
+}
+#endif /* CH_CFG_PIPES_SPSC == TRUE */
+
 #endif /* CH_CFG_USE_PIPES == TRUE */
 
 /** @} */
@@ -41,6 +41,30 @@
 /* Module pre-compile time settings.                                         */
 /*===========================================================================*/
 
+/**
+ * @brief   Event listeners index.
+ * @details If enabled then the listeners registered on an event source are
+ *          grouped by their @p wflags mask and a broadcast skips the groups
+ *          not interested in the broadcasted flags, only the matching
+ *          listeners are visited.
+ * @note    Registering a listener becomes O(n) in the number of groups
+ *          on the event source.
+ */
+#if !defined(CH_CFG_USE_EVENTS_INDEX) || defined(__DOXYGEN__)
+#define CH_CFG_USE_EVENTS_INDEX             FALSE
+#endif
+
+/**
+ * @brief   Deferred event broadcasts.
+ * @details If enabled then an event source can be associated to an events
+ *          deferrer, broadcasts on the source just accumulate flags in O(1)
+ *          time and the fan-out to the listeners is performed later by a
+ *          thread invoking @p chEvtDeferrerDispatch().
+ */
+#if !defined(CH_CFG_USE_EVENTS_DEFERRED) || defined(__DOXYGEN__)
+#define CH_CFG_USE_EVENTS_DEFERRED          FALSE
+#endif
+
 /*===========================================================================*/
 /* Derived constants and error checks.                                       */
 /*===========================================================================*/
@@ -66,16 +90,47 @@ struct event_listener {
                                                     by the event source.    */
   eventflags_t          wflags;         /**< @brief Flags that this listener
                                                     interested in.          */
+#if (CH_CFG_USE_EVENTS_INDEX == TRUE) || defined(__DOXYGEN__)
+  event_listener_t      *nextgroup;     /**< @brief First Event Listener of
+                                                    the next group, only
+                                                    valid in the first
+                                                    listener of a group.    */
+#endif
 };
 
+typedef struct event_source event_source_t;
+
+#if (CH_CFG_USE_EVENTS_DEFERRED == TRUE) || defined(__DOXYGEN__)
+/**
+ * @brief   Events Deferrer structure.
+ */
+typedef struct event_deferrer {
+  event_source_t        *head;          /**< @brief First Event Source with
+                                                    deferred flags.         */
+  event_source_t        *tail;          /**< @brief Last Event Source with
+                                                    deferred flags.         */
+  thread_reference_t    tr;             /**< @brief Thread waiting for
+                                                    deferred broadcasts.    */
+} event_deferrer_t;
+#endif
+
 /**
  * @brief   Event Source structure.
  */
-typedef struct event_source {
+struct event_source {
   event_listener_t      *next;          /**< @brief First Event Listener
                                                     registered on the Event
                                                     Source.                 */
-} event_source_t;
+#if (CH_CFG_USE_EVENTS_DEFERRED == TRUE) || defined(__DOXYGEN__)
+  event_deferrer_t      *deferrer;      /**< @brief Associated Events
+                                                    Deferrer or @p NULL.    */
+  event_source_t        *dnext;         /**< @brief Next Event Source in
+                                                    the deferrer queue.     */
+  eventflags_t          dflags;         /**< @brief Deferred flags.         */
+  bool                  dall;           /**< @brief Deferred broadcast
+                                                    without flags.          */
+#endif
+};
 
 /**
  * @brief   Event Handler callback function.
@@ -102,7 +157,12 @@ typedef void (*evhandler_t)(eventid_t id);
  *          source that is part of a bigger structure.
  * @param name          the name of the event source variable
  */
+#if (CH_CFG_USE_EVENTS_DEFERRED == FALSE) || defined(__DOXYGEN__)
 #define _EVENTSOURCE_DATA(name) {(event_listener_t *)(&name)}
+#else
+#define _EVENTSOURCE_DATA(name) {(event_listener_t *)(&name), NULL, NULL,   \
+                                 (eventflags_t)0, false}
+#endif
 
 /**
  * @brief   Static event source initializer.
@@ -135,6 +195,10 @@ extern "C" {
   void chEvtBroadcastFlags(event_source_t *esp, eventflags_t flags);
   void chEvtBroadcastFlagsI(event_source_t *esp, eventflags_t flags);
   void chEvtDispatch(const evhandler_t *handlers, eventmask_t events);
+#if CH_CFG_USE_EVENTS_DEFERRED == TRUE
+  msg_t chEvtDeferrerDispatchTimeout(event_deferrer_t *edp,
+                                     sysinterval_t timeout);
+#endif
 #if (CH_CFG_OPTIMIZE_SPEED == TRUE) || (CH_CFG_USE_EVENTS_TIMEOUT == FALSE)
   eventmask_t chEvtWaitOne(eventmask_t events);
   eventmask_t chEvtWaitAny(eventmask_t events);
@@ -171,7 +235,63 @@ extern "C" {
 static inline void chEvtObjectInit(event_source_t *esp) {
 
   esp->next = (event_listener_t *)esp;
+#if CH_CFG_USE_EVENTS_DEFERRED == TRUE
+  esp->deferrer = NULL;
+  esp->dnext    = NULL;
+  esp->dflags   = (eventflags_t)0;
+  esp->dall     = false;
+#endif
+}
+
+#if (CH_CFG_USE_EVENTS_DEFERRED == TRUE) || defined(__DOXYGEN__)
+/**
+ * @brief   Initializes an Event Source with deferred broadcasts.
+ * @details Broadcasts on the event source are accumulated in O(1) time,
+ *          listeners are signaled when the deferrer is dispatched.
+ * @note    This function can be invoked before the kernel is initialized
+ *          because it just prepares a @p event_source_t structure.
+ *
+ * @param[out] esp      pointer to the @p event_source_t structure
+ * @param[in] edp       pointer to the @p event_deferrer_t structure
+ *
+ * @init
+ */
+static inline void chEvtObjectInitDeferred(event_source_t *esp,
+                                           event_deferrer_t *edp) {
+
+  chEvtObjectInit(esp);
+  esp->deferrer = edp;
+}
+
+/**
+ * @brief   Initializes an Events Deferrer.
+ *
+ * @param[out] edp      pointer to the @p event_deferrer_t structure
+ *
+ * @init
+ */
+static inline void chEvtDeferrerObjectInit(event_deferrer_t *edp) {
+
+  edp->head = NULL;
+  edp->tail = NULL;
+  edp->tr   = NULL;
+}
+
+/**
+ * @brief   Waits for deferred broadcasts then signals the listeners.
+ *
+ * @param[in] edp       pointer to the @p event_deferrer_t structure
+ * @return              The function outcome.
+ * @retval MSG_OK       if deferred broadcasts have been performed.
+ * @retval MSG_RESET    if the waiting thread has been reset.
+ *
+ * @api
+ */
+static inline msg_t chEvtDeferrerDispatch(event_deferrer_t *edp) {
+
+  return chEvtDeferrerDispatchTimeout(edp, TIME_INFINITE);
 }
+#endif /* CH_CFG_USE_EVENTS_DEFERRED == TRUE */
 
 /**
  * @brief   Registers an Event Listener on an Event Source.
@@ -38,10 +38,29 @@
 /* Module pre-compile time settings.                                         */
 /*===========================================================================*/
 
+/**
+ * @brief   Mutexes adaptive spinning.
+ * @details If greater than zero then a thread trying to lock an owned mutex
+ *          polls the mutex, with interrupts enabled, before sleeping. This
+ *          is the maximum number of iterations, the actual number adapts to
+ *          the outcome of the previous locks of the same mutex.
+ * @note    The owner can only release the mutex while the thread is
+ *          spinning if it is made ready by an ISR and preempts the spinning
+ *          thread or if both threads share the same priority level and
+ *          round robin is enabled.
+ */
+#if !defined(CH_CFG_MTX_SPIN_COUNT) || defined(__DOXYGEN__)
+#define CH_CFG_MTX_SPIN_COUNT               0
+#endif
+
 /*===========================================================================*/
 /* Derived constants and error checks.                                       */
 /*===========================================================================*/
 
+#if CH_CFG_MTX_SPIN_COUNT < 0
+#error "invalid CH_CFG_MTX_SPIN_COUNT value"
+#endif
+
 /*===========================================================================*/
 /* Module data structures and types.                                         */
 /*===========================================================================*/
@@ -64,6 +83,10 @@ struct ch_mutex {
 #if (CH_CFG_USE_MUTEXES_RECURSIVE == TRUE) || defined(__DOXYGEN__)
   cnt_t                 cnt;        /**< @brief Mutex recursion counter.    */
 #endif
+#if (CH_CFG_MTX_SPIN_COUNT > 0) || defined(__DOXYGEN__)
+  cnt_t                 spins;      /**< @brief Running average of the
+                                                spins iterations.           */
+#endif
 };
 
 /*===========================================================================*/
@@ -77,11 +100,19 @@ struct ch_mutex {
  *
  * @param[in] name      the name of the mutex variable
  */
+#if (CH_CFG_MTX_SPIN_COUNT == 0) || defined(__DOXYGEN__)
 #if (CH_CFG_USE_MUTEXES_RECURSIVE == TRUE) || defined(__DOXYGEN__)
 #define _MUTEX_DATA(name) {_THREADS_QUEUE_DATA(name.queue), NULL, NULL, 0}
 #else
 #define _MUTEX_DATA(name) {_THREADS_QUEUE_DATA(name.queue), NULL, NULL}
 #endif
+#else /* CH_CFG_MTX_SPIN_COUNT > 0 */
+#if CH_CFG_USE_MUTEXES_RECURSIVE == TRUE
+#define _MUTEX_DATA(name) {_THREADS_QUEUE_DATA(name.queue), NULL, NULL, 0, 0}
+#else
+#define _MUTEX_DATA(name) {_THREADS_QUEUE_DATA(name.queue), NULL, NULL, 0}
+#endif
+#endif /* CH_CFG_MTX_SPIN_COUNT > 0 */
 
 /**
  * @brief   Static mutex initializer.
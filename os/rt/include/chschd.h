@@ -110,10 +110,47 @@
 /* Module pre-compile time settings.                                         */
 /*===========================================================================*/
 
+/**
+ * @brief   Virtual timers heap.
+ * @details If enabled then the armed virtual timers are kept in a binary
+ *          min-heap ordered by absolute deadline instead of the classic
+ *          delta list. Arming and disarming a timer become O(log n)
+ *          operations instead of O(n).
+ * @note    The delta list is faster when just few timers are armed at
+ *          the same time, the heap is meant for systems with hundreds of
+ *          concurrent timeouts.
+ */
+#if !defined(CH_CFG_USE_TIMERS_HEAP) || defined(__DOXYGEN__)
+#define CH_CFG_USE_TIMERS_HEAP              FALSE
+#endif
+
+/**
+ * @brief   Ready list bitmap index.
+ * @details If enabled then the ready list is indexed by a bitmap of the
+ *          priority levels having ready threads and by a pointer to the
+ *          last ready thread of each level. Insertion in the ready list
+ *          becomes O(1) instead of O(n) in the number of ready threads.
+ * @note    The index requires an additional pointer for each priority
+ *          level, 256 pointers.
+ */
+#if !defined(CH_CFG_USE_READY_BITMAP) || defined(__DOXYGEN__)
+#define CH_CFG_USE_READY_BITMAP             FALSE
+#endif
+
 /*===========================================================================*/
 /* Derived constants and error checks.                                       */
 /*===========================================================================*/
 
+/**
+ * @brief   Number of priority levels.
+ */
+#define CH_PRIO_LEVELS          ((unsigned)HIGHPRIO + 1U)
+
+/**
+ * @brief   Number of words in the ready list bitmap.
+ */
+#define CH_PRIO_MAP_WORDS       (CH_PRIO_LEVELS / 32U)
+
 /*===========================================================================*/
 /* Module data structures and types.                                         */
 /*===========================================================================*/
@@ -305,6 +342,7 @@ struct ch_thread {
 #endif
 };
 
+#if (CH_CFG_USE_TIMERS_HEAP == FALSE) || defined(__DOXYGEN__)
 /**
  * @extends virtual_timers_list_t
  *
@@ -343,6 +381,44 @@ struct ch_virtual_timers_list {
                                                 tick event.                 */
 #endif
 };
+#else /* CH_CFG_USE_TIMERS_HEAP == TRUE */
+/**
+ * @brief   Virtual Timer descriptor structure.
+ * @note    The timer is a node of a pointer-linked binary min-heap, the
+ *          heap is kept complete so its depth is always log2(n).
+ */
+struct ch_virtual_timer {
+  virtual_timer_t       *parent;    /**< @brief Parent node in the heap.    */
+  virtual_timer_t       *left;      /**< @brief Left child in the heap.     */
+  virtual_timer_t       *right;     /**< @brief Right child in the heap.    */
+  vttime_t              deadline;   /**< @brief Absolute expiration time.   */
+  vtfunc_t              func;       /**< @brief Timer callback function
+                                                pointer.                    */
+  void                  *par;       /**< @brief Timer callback function
+                                                parameter.                  */
+};
+
+/**
+ * @brief   Virtual timers heap header.
+ * @note    Deadlines are kept as absolute values of a 64 bits time base
+ *          which is extended from the system time in order to make
+ *          comparisons immune to the system time wrap-around.
+ */
+struct ch_virtual_timers_list {
+  virtual_timer_t       *root;      /**< @brief Timer with the nearest
+                                                deadline.                   */
+  ucnt_t                n;          /**< @brief Number of armed timers.     */
+  vttime_t              basetime;   /**< @brief Extended time of the last
+                                                tick event.                 */
+#if (CH_CFG_ST_TIMEDELTA == 0) || defined(__DOXYGEN__)
+  volatile systime_t    systime;    /**< @brief System Time counter.        */
+#endif
+#if (CH_CFG_ST_TIMEDELTA > 0) || defined(__DOXYGEN__)
+  systime_t             lasttime;   /**< @brief System time of the last
+                                                tick event.                 */
+#endif
+};
+#endif /* CH_CFG_USE_TIMERS_HEAP == TRUE */
 
 /**
  * @extends threads_queue_t
@@ -360,6 +436,26 @@ struct ch_ready_list {
   /* End of the fields shared with the thread_t structure.*/
   thread_t              *current;   /**< @brief The currently running
                                                 thread.                     */
+#if (CH_CFG_USE_READY_BITMAP == TRUE) || defined(__DOXYGEN__)
+  /**
+   * @brief   Map of the non-empty words of @p prmask.
+   * @note    Word @p n is represented by bit @p 31-n.
+   */
+  uint32_t              prmap;
+  /**
+   * @brief   Map of the priority levels with ready threads.
+   * @note    Priority @p p is represented by bit @p 31-(p%32) of word
+   *          @p p/32, this way the lowest priority in a word is found
+   *          using a count leading zeros operation.
+   */
+  uint32_t              prmask[CH_PRIO_MAP_WORDS];
+  /**
+   * @brief   Last ready thread for each priority level.
+   * @note    An entry is only valid if the level bit is set in
+   *          @p prmask.
+   */
+  thread_t              *prtail[CH_PRIO_LEVELS];
+#endif
 };
 
 /**
@@ -472,6 +568,9 @@ extern "C" {
   void chSchDoRescheduleBehind(void);
   void chSchDoRescheduleAhead(void);
   void chSchDoReschedule(void);
+#if CH_CFG_USE_READY_BITMAP == TRUE
+  thread_t *rlist_dequeue(thread_t *tp);
+#endif
 #if CH_CFG_OPTIMIZE_SPEED == FALSE
   void queue_prio_insert(thread_t *tp, threads_queue_t *tqp);
   void queue_insert(thread_t *tp, threads_queue_t *tqp);
@@ -630,6 +729,22 @@ static inline thread_t *queue_dequeue(thread_t *tp) {
 }
 #endif /* CH_CFG_OPTIMIZE_SPEED == TRUE */
 
+#if (CH_CFG_USE_READY_BITMAP == FALSE) || defined(__DOXYGEN__)
+/**
+ * @brief   Removes a thread from the ready list.
+ * @note    The thread state is not modified.
+ *
+ * @param[in] tp        the thread to be removed
+ * @return              The removed thread pointer.
+ *
+ * @notapi
+ */
+static inline thread_t *rlist_dequeue(thread_t *tp) {
+
+  return queue_dequeue(tp);
+}
+#endif /* CH_CFG_USE_READY_BITMAP == FALSE */
+
 /**
  * @brief   Determines if the current thread must reschedule.
  * @details This function returns @p true if there is a ready thread with
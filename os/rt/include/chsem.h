@@ -38,10 +38,28 @@
 /* Module pre-compile time settings.                                         */
 /*===========================================================================*/
 
+/**
+ * @brief   Semaphores adaptive spinning.
+ * @details If greater than zero then a thread waiting on a semaphore polls
+ *          the counter, with interrupts enabled, before sleeping. This is
+ *          the maximum number of iterations, the actual number adapts to
+ *          the outcome of the previous waits on the same semaphore.
+ * @note    The counter can only be increased by ISRs while the thread is
+ *          spinning, the spin is useful for semaphores signaled by
+ *          interrupt sources with short latencies.
+ */
+#if !defined(CH_CFG_SEM_SPIN_COUNT) || defined(__DOXYGEN__)
+#define CH_CFG_SEM_SPIN_COUNT               0
+#endif
+
 /*===========================================================================*/
 /* Derived constants and error checks.                                       */
 /*===========================================================================*/
 
+#if CH_CFG_SEM_SPIN_COUNT < 0
+#error "invalid CH_CFG_SEM_SPIN_COUNT value"
+#endif
+
 /*===========================================================================*/
 /* Module data structures and types.                                         */
 /*===========================================================================*/
@@ -53,6 +71,10 @@ typedef struct ch_semaphore {
   threads_queue_t       queue;      /**< @brief Queue of the threads sleeping
                                                 on this semaphore.          */
   cnt_t                 cnt;        /**< @brief The semaphore counter.      */
+#if (CH_CFG_SEM_SPIN_COUNT > 0) || defined(__DOXYGEN__)
+  cnt_t                 spins;      /**< @brief Running average of the
+                                                spins iterations.           */
+#endif
 } semaphore_t;
 
 /*===========================================================================*/
@@ -68,7 +90,11 @@ typedef struct ch_semaphore {
  * @param[in] n         the counter initial value, this value must be
  *                      non-negative
  */
+#if (CH_CFG_SEM_SPIN_COUNT == 0) || defined(__DOXYGEN__)
 #define _SEMAPHORE_DATA(name, n) {_THREADS_QUEUE_DATA(name.queue), n}
+#else
+#define _SEMAPHORE_DATA(name, n) {_THREADS_QUEUE_DATA(name.queue), n, 0}
+#endif
 
 /**
  * @brief   Static semaphore initializer.
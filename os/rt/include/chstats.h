@@ -60,6 +60,10 @@ typedef struct {
                                                 critical zones duration.    */
   time_measurement_t    m_crit_isr; /**< @brief Measurement of ISRs critical
                                                 zones duration.             */
+  ucnt_t                n_spin;     /**< @brief Number of adaptive spins on
+                                                mutexes and semaphores.     */
+  ucnt_t                n_spin_ok;  /**< @brief Number of successful
+                                                adaptive spins.             */
 } kernel_stats_t;
 
 /*===========================================================================*/
@@ -80,6 +84,7 @@ extern "C" {
   void _stats_stop_measure_crit_thd(void);
   void _stats_start_measure_crit_isr(void);
   void _stats_stop_measure_crit_isr(void);
+  void _stats_spin(bool ok);
 #ifdef __cplusplus
 }
 #endif
@@ -97,6 +102,7 @@ extern "C" {
 #define _stats_stop_measure_crit_thd()
 #define _stats_start_measure_crit_isr()
 #define _stats_stop_measure_crit_isr()
+#define _stats_spin(ok)
 
 #endif /* CH_DBG_STATISTICS == FALSE */
 
@@ -253,6 +253,18 @@
 #define chSysGetRealtimeCounterX() (rtcnt_t)port_rt_get_counter_value()
 #endif
 
+/**
+ * @brief   Hint for kernel spin loops.
+ * @details Invoked at each iteration of the adaptive spins of mutexes and
+ *          semaphores, ports can redefine it in order to insert a pause
+ *          or yield instruction.
+ *
+ * @xclass
+ */
+#if !defined(port_spin_hint) || defined(__DOXYGEN__)
+#define port_spin_hint()
+#endif
+
 /**
  * @brief   Performs a context switch.
  * @note    Not a user function, it is meant to be invoked by the scheduler
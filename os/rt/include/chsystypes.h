@@ -90,6 +90,12 @@ typedef struct ch_virtual_timer virtual_timer_t;
  */
 typedef struct ch_virtual_timers_list  virtual_timers_list_t;
 
+/**
+ * @brief   Type of an extended, non wrapping, virtual timers time base.
+ * @note    Only used when @p CH_CFG_USE_TIMERS_HEAP is enabled.
+ */
+typedef uint64_t vttime_t;
+
 /**
  * @brief   Type of a system debug structure.
  */
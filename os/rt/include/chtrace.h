@@ -42,6 +42,22 @@
 #define CH_TRACE_TYPE_ISR_LEAVE             3U
 #define CH_TRACE_TYPE_HALT                  4U
 #define CH_TRACE_TYPE_USER                  5U
+#define CH_TRACE_TYPE_SYNC                  6U
+#define CH_TRACE_TYPE_VT                    7U
+/** @} */
+
+/**
+ * @name    Synchronization trace records operations
+ * @note    The operation code is stored in the @p state field of
+ *          @p CH_TRACE_TYPE_SYNC records.
+ * @{
+ */
+#define CH_TRACE_SYNC_SEM_WAIT              0U
+#define CH_TRACE_SYNC_SEM_SIGNAL            1U
+#define CH_TRACE_SYNC_MTX_LOCK              2U
+#define CH_TRACE_SYNC_MTX_UNLOCK            3U
+#define CH_TRACE_SYNC_MBX_POST              4U
+#define CH_TRACE_SYNC_MBX_FETCH             5U
 /** @} */
 
 /**
@@ -54,13 +70,17 @@
 #define CH_DBG_TRACE_MASK_ISR               2U
 #define CH_DBG_TRACE_MASK_HALT              4U
 #define CH_DBG_TRACE_MASK_USER              8U
+#define CH_DBG_TRACE_MASK_SYNC              16U
+#define CH_DBG_TRACE_MASK_VT                32U
 #define CH_DBG_TRACE_MASK_SLOW              (CH_DBG_TRACE_MASK_SWITCH |     \
                                              CH_DBG_TRACE_MASK_HALT |       \
                                              CH_DBG_TRACE_MASK_USER)
 #define CH_DBG_TRACE_MASK_ALL               (CH_DBG_TRACE_MASK_SWITCH |     \
                                              CH_DBG_TRACE_MASK_ISR |        \
                                              CH_DBG_TRACE_MASK_HALT |       \
-                                             CH_DBG_TRACE_MASK_USER)
+                                             CH_DBG_TRACE_MASK_USER |       \
+                                             CH_DBG_TRACE_MASK_SYNC |       \
+                                             CH_DBG_TRACE_MASK_VT)
 /** @} */
 
 /*===========================================================================*/
@@ -108,6 +128,8 @@ typedef struct {
   uint32_t              type:3;
   /**
    * @brief   Switched out thread state.
+   * @note    For @p CH_TRACE_TYPE_SYNC records this field contains the
+   *          operation code.
    */
   uint32_t              state:5;
   /**
@@ -165,6 +187,35 @@ typedef struct {
        */
       void                  *up2;
     } user;
+    /**
+     * @brief   Structure representing a synchronization operation.
+     */
+    struct {
+      /**
+       * @brief   Object involved in the operation.
+       */
+      void                  *objp;
+      /**
+       * @brief   Operation-dependent value.
+       * @details Counter value after the operation for semaphores,
+       *          non-zero if the mutex was already owned for mutexes,
+       *          the transferred message for mailboxes.
+       */
+      msg_t                 msg;
+    } sync;
+    /**
+     * @brief   Structure representing a virtual timer firing.
+     */
+    struct {
+      /**
+       * @brief   Timer callback function.
+       */
+      vtfunc_t              func;
+      /**
+       * @brief   Timer callback parameter.
+       */
+      void                  *par;
+    } vt;
   } u;
 } ch_trace_event_t;
 /*lint -restore*/
@@ -185,6 +236,14 @@ typedef struct {
    * @brief   Pointer to the buffer front.
    */
   ch_trace_event_t      *ptr;
+  /**
+   * @brief   Number of records not yet fetched using @p chDbgReadTraceI().
+   */
+  size_t                unread;
+  /**
+   * @brief   Number of records overwritten before being fetched.
+   */
+  uint32_t              overflows;
   /**
    * @brief   Ring buffer.
    */
@@ -215,6 +274,12 @@ typedef struct {
 #if !defined(_trace_halt)
 #define _trace_halt(reason)
 #endif
+#if !defined(_trace_sync)
+#define _trace_sync(op, objp, msg)
+#endif
+#if !defined(_trace_vt)
+#define _trace_vt(vtp)
+#endif
 #if !defined(chDbgWriteTraceI)
 #define chDbgWriteTraceI(up1, up2)
 #endif
@@ -223,6 +288,19 @@ typedef struct {
 #endif
 #endif /* CH_DBG_TRACE_MASK == CH_DBG_TRACE_MASK_DISABLED */
 
+#if (CH_DBG_TRACE_MASK != CH_DBG_TRACE_MASK_DISABLED) || defined(__DOXYGEN__)
+/**
+ * @brief   Returns the number of trace records lost.
+ * @details The counter is increased each time a record is overwritten
+ *          before being fetched using @p chDbgReadTraceI().
+ *
+ * @return              The number of records lost since initialization.
+ *
+ * @xclass
+ */
+#define chDbgGetTraceOverflowsX() (ch.dbg.trace_buffer.overflows)
+#endif
+
 /*===========================================================================*/
 /* External declarations.                                                    */
 /*===========================================================================*/
@@ -236,12 +314,15 @@ extern "C" {
   void _trace_isr_enter(const char *isr);
   void _trace_isr_leave(const char *isr);
   void _trace_halt(const char *reason);
+  void _trace_sync(unsigned op, void *objp, msg_t msg);
+  void _trace_vt(virtual_timer_t *vtp);
   void chDbgWriteTraceI(void *up1, void *up2);
   void chDbgWriteTrace(void *up1, void *up2);
   void chDbgSuspendTraceI(uint16_t mask);
   void chDbgSuspendTrace(uint16_t mask);
   void chDbgResumeTraceI(uint16_t mask);
   void chDbgResumeTrace(uint16_t mask);
+  size_t chDbgReadTraceI(ch_trace_event_t *tep, size_t n);
 #endif /* CH_DBG_TRACE_MASK != CH_DBG_TRACE_MASK_DISABLED */
 #ifdef __cplusplus
 }
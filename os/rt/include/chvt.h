@@ -75,6 +75,9 @@ extern "C" {
   void chVTDoSetI(virtual_timer_t *vtp, sysinterval_t delay,
                   vtfunc_t vtfunc, void *par);
   void chVTDoResetI(virtual_timer_t *vtp);
+#if CH_CFG_USE_TIMERS_HEAP == TRUE
+  void _vt_heap_tick(void);
+#endif
 #ifdef __cplusplus
 }
 #endif
@@ -210,6 +213,25 @@ static inline bool chVTGetTimersStateI(sysinterval_t *timep) {
 
   chDbgCheckClassI();
 
+#if CH_CFG_USE_TIMERS_HEAP == TRUE
+  if (ch.vtlist.root == NULL) {
+    return false;
+  }
+
+  if (timep != NULL) {
+    vttime_t now = ch.vtlist.basetime;
+
+#if CH_CFG_ST_TIMEDELTA > 0
+    now += (vttime_t)chTimeDiffX(ch.vtlist.lasttime, chVTGetSystemTimeX());
+#endif
+    if (ch.vtlist.root->deadline > now) {
+      *timep = (sysinterval_t)(ch.vtlist.root->deadline - now);
+    }
+    else {
+      *timep = (sysinterval_t)0;
+    }
+  }
+#else /* CH_CFG_USE_TIMERS_HEAP == FALSE */
   if (&ch.vtlist == (virtual_timers_list_t *)ch.vtlist.next) {
     return false;
   }
@@ -222,6 +244,7 @@ static inline bool chVTGetTimersStateI(sysinterval_t *timep) {
              chTimeDiffX(ch.vtlist.lasttime, chVTGetSystemTimeX());
 #endif
   }
+#endif /* CH_CFG_USE_TIMERS_HEAP == FALSE */
 
   return true;
 }
@@ -369,7 +392,9 @@ static inline void chVTDoTickI(void) {
 
   chDbgCheckClassI();
 
-#if CH_CFG_ST_TIMEDELTA == 0
+#if CH_CFG_USE_TIMERS_HEAP == TRUE
+  _vt_heap_tick();
+#elif CH_CFG_ST_TIMEDELTA == 0
   ch.vtlist.systime++;
   if (&ch.vtlist != (virtual_timers_list_t *)ch.vtlist.next) {
     /* The list is not empty, processing elements on top.*/
@@ -379,6 +404,7 @@ static inline void chVTDoTickI(void) {
       vtfunc_t fn;
 
       vtp = ch.vtlist.next;
+      _trace_vt(vtp);
       fn = vtp->func;
       vtp->func = NULL;
       vtp->next->prev = (virtual_timer_t *)&ch.vtlist;
@@ -418,6 +444,7 @@ static inline void chVTDoTickI(void) {
 
       vtp->next->prev = (virtual_timer_t *)&ch.vtlist;
       ch.vtlist.next = vtp->next;
+      _trace_vt(vtp);
       fn = vtp->func;
       vtp->func = NULL;
 
@@ -50,6 +50,15 @@
  *          An unlimited number of Event Sources can exists in a system and
  *          each thread can be listening on an unlimited number of
  *          them.
+ *          <h2>Scalable broadcasts</h2>
+ *          With @p CH_CFG_USE_EVENTS_INDEX enabled the listeners having
+ *          the same @p wflags mask are grouped and a broadcast skips the
+ *          whole groups not interested in the broadcasted flags.<br>
+ *          With @p CH_CFG_USE_EVENTS_DEFERRED enabled an Event Source can
+ *          be associated to an Events Deferrer, broadcasts only accumulate
+ *          flags in the source and the listeners are signaled later by a
+ *          thread dispatching the deferrer, this keeps ISRs short when
+ *          there are many listeners.
  * @pre     In order to use the Events APIs the @p CH_CFG_USE_EVENTS option
  *          must be enabled in @p chconf.h.
  * @post    Enabling events requires 1-4 (depending on the architecture)
@@ -81,6 +90,138 @@
 /* Module local functions.                                                   */
 /*===========================================================================*/
 
+/**
+ * @brief   Signals the Event Listeners interested in the specified flags.
+ *
+ * @param[in] esp       pointer to the @p event_source_t structure
+ * @param[in] flags     the flags set to be added to the listener flags mask
+ *
+ * @notapi
+ */
+static void evt_broadcast_i(event_source_t *esp, eventflags_t flags) {
+  event_listener_t *elp;
+#if CH_CFG_USE_EVENTS_INDEX == TRUE
+  event_listener_t *end;
+#endif
+
+  elp = esp->next;
+  /*lint -save -e9087 -e740 [11.3, 1.3] Cast required by list handling.*/
+  while (elp != (event_listener_t *)esp) {
+  /*lint -restore*/
+#if CH_CFG_USE_EVENTS_INDEX == TRUE
+    end = elp->nextgroup;
+    /* All the listeners in a group have the same wflags, the whole group
+       is skipped if not interested.*/
+    if ((flags == (eventflags_t)0) ||
+        ((flags & elp->wflags) != (eventflags_t)0)) {
+      do {
+        elp->flags |= flags;
+        chEvtSignalI(elp->listener, elp->events);
+        elp = elp->next;
+      } while (elp != end);
+    }
+    else {
+      elp = end;
+    }
+#else
+    elp->flags |= flags;
+    /* When flags == 0 the thread will always be signaled because the
+       source does not emit any flag.*/
+    if ((flags == (eventflags_t)0) ||
+        ((flags & elp->wflags) != (eventflags_t)0)) {
+      chEvtSignalI(elp->listener, elp->events);
+    }
+    elp = elp->next;
+#endif
+  }
+}
+
+#if (CH_CFG_USE_EVENTS_INDEX == TRUE) || defined(__DOXYGEN__)
+/**
+ * @brief   Removes an Event Listener from the groups of its Event Source.
+ *
+ * @param[in] esp       pointer to the @p event_source_t structure
+ * @param[in] elp       pointer to the @p event_listener_t structure
+ *
+ * @notapi
+ */
+static void evt_unlink_i(event_source_t *esp, event_listener_t *elp) {
+  event_listener_t *p, *gp, *prevgp;
+
+  /* The pointer "p" is the last listener of the previous group, or the
+     source itself before the first group.*/
+  /*lint -save -e9087 -e740 [11.3, 1.3] Cast required by list handling.*/
+  p = (event_listener_t *)esp;
+  /*lint -restore*/
+  prevgp = NULL;
+  gp = esp->next;
+  /*lint -save -e9087 -e740 [11.3, 1.3] Cast required by list handling.*/
+  while (gp != (event_listener_t *)esp) {
+  /*lint -restore*/
+    if (gp == elp) {
+      if (elp->next != elp->nextgroup) {
+        /* The next listener becomes the first of the group.*/
+        elp->next->nextgroup = elp->nextgroup;
+      }
+      /* The previous group is followed by the next listener, it is the
+         first of this group or of the next one if the group is empty.*/
+      if (prevgp != NULL) {
+        prevgp->nextgroup = elp->next;
+      }
+      p->next = elp->next;
+      return;
+    }
+
+    /* Searching the listener within the group.*/
+    p = gp;
+    while (p->next != gp->nextgroup) {
+      if (p->next == elp) {
+        p->next = elp->next;
+        return;
+      }
+      p = p->next;
+    }
+
+    prevgp = gp;
+    gp = gp->nextgroup;
+  }
+}
+#endif /* CH_CFG_USE_EVENTS_INDEX == TRUE */
+
+#if (CH_CFG_USE_EVENTS_DEFERRED == TRUE) || defined(__DOXYGEN__)
+/**
+ * @brief   Accumulates flags in an Event Source with deferred broadcasts.
+ * @details The source is queued in its deferrer, if not already queued,
+ *          and the thread waiting on the deferrer is awakened.
+ *
+ * @param[in] esp       pointer to the @p event_source_t structure
+ * @param[in] flags     the flags set to be added to the listener flags mask
+ *
+ * @notapi
+ */
+static void evt_defer_i(event_source_t *esp, eventflags_t flags) {
+  event_deferrer_t *edp = esp->deferrer;
+
+  if (flags == (eventflags_t)0) {
+    esp->dall = true;
+  }
+  else {
+    esp->dflags |= flags;
+  }
+
+  if ((esp->dnext == NULL) && (edp->tail != esp)) {
+    if (edp->tail == NULL) {
+      edp->head = esp;
+    }
+    else {
+      edp->tail->dnext = esp;
+    }
+    edp->tail = esp;
+    chThdResumeI(&edp->tr, MSG_OK);
+  }
+}
+#endif /* CH_CFG_USE_EVENTS_DEFERRED == TRUE */
+
 /*===========================================================================*/
 /* Module exported functions.                                                */
 /*===========================================================================*/
@@ -108,8 +249,34 @@ void chEvtRegisterMaskWithFlags(event_source_t *esp,
   chDbgCheck((esp != NULL) && (elp != NULL));
 
   chSysLock();
+#if CH_CFG_USE_EVENTS_INDEX == TRUE
+  {
+    event_listener_t *gp = esp->next;
+
+    /* Searching for a group with the same flags mask.*/
+    /*lint -save -e9087 -e740 [11.3, 1.3] Cast required by list handling.*/
+    while ((gp != (event_listener_t *)esp) && (gp->wflags != wflags)) {
+    /*lint -restore*/
+      gp = gp->nextgroup;
+    }
+    /*lint -save -e9087 -e740 [11.3, 1.3] Cast required by list handling.*/
+    if (gp != (event_listener_t *)esp) {
+    /*lint -restore*/
+      /* Inserted after the first listener of the group.*/
+      elp->next = gp->next;
+      gp->next  = elp;
+    }
+    else {
+      /* New group in front of the list.*/
+      elp->next      = esp->next;
+      elp->nextgroup = esp->next;
+      esp->next      = elp;
+    }
+  }
+#else
   elp->next     = esp->next;
   esp->next     = elp;
+#endif
   elp->listener = currp;
   elp->events   = events;
   elp->flags    = (eventflags_t)0;
@@ -131,10 +298,17 @@ void chEvtRegisterMaskWithFlags(event_source_t *esp,
  * @api
  */
 void chEvtUnregister(event_source_t *esp, event_listener_t *elp) {
+#if CH_CFG_USE_EVENTS_INDEX == FALSE
   event_listener_t *p;
+#endif
 
   chDbgCheck((esp != NULL) && (elp != NULL));
 
+#if CH_CFG_USE_EVENTS_INDEX == TRUE
+  chSysLock();
+  evt_unlink_i(esp, elp);
+  chSysUnlock();
+#else
   /*lint -save -e9087 -e740 [11.3, 1.3] Cast required by list handling.*/
   p = (event_listener_t *)esp;
   /*lint -restore*/
@@ -149,6 +323,7 @@ void chEvtUnregister(event_source_t *esp, event_listener_t *elp) {
     p = p->next;
   }
   chSysUnlock();
+#endif
 }
 
 /**
@@ -212,6 +387,9 @@ eventmask_t chEvtAddEvents(eventmask_t events) {
  *          threads registered on the @p event_source_t in addition to the
  *          event flags specified by the threads themselves in the
  *          @p event_listener_t objects.
+ * @note    If the source has been initialized with
+ *          @p chEvtObjectInitDeferred() then the flags are only accumulated
+ *          and the listeners are signaled by the deferrer thread.
  * @post    This function does not reschedule so a call to a rescheduling
  *          function must be performed before unlocking the kernel. Note that
  *          interrupt handlers always reschedule on exit so an explicit
@@ -223,24 +401,18 @@ eventmask_t chEvtAddEvents(eventmask_t events) {
  * @iclass
  */
 void chEvtBroadcastFlagsI(event_source_t *esp, eventflags_t flags) {
-  event_listener_t *elp;
 
   chDbgCheckClassI();
   chDbgCheck(esp != NULL);
 
-  elp = esp->next;
-  /*lint -save -e9087 -e740 [11.3, 1.3] Cast required by list handling.*/
-  while (elp != (event_listener_t *)esp) {
-  /*lint -restore*/
-    elp->flags |= flags;
-    /* When flags == 0 the thread will always be signaled because the
-       source does not emit any flag.*/
-    if ((flags == (eventflags_t)0) ||
-        ((flags & elp->wflags) != (eventflags_t)0)) {
-      chEvtSignalI(elp->listener, elp->events);
-    }
-    elp = elp->next;
+#if CH_CFG_USE_EVENTS_DEFERRED == TRUE
+  if (esp->deferrer != NULL) {
+    evt_defer_i(esp, flags);
+    return;
   }
+#endif
+
+  evt_broadcast_i(esp, flags);
 }
 
 /**
@@ -377,6 +549,79 @@ void chEvtDispatch(const evhandler_t *handlers, eventmask_t events) {
   }
 }
 
+#if (CH_CFG_USE_EVENTS_DEFERRED == TRUE) || defined(__DOXYGEN__)
+/**
+ * @brief   Waits for deferred broadcasts then signals the listeners.
+ * @details The Event Sources queued in the deferrer are broadcasted one
+ *          at time, the critical zone is left between sources.
+ *
+ * @param[in] edp       pointer to the @p event_deferrer_t structure
+ * @param[in] timeout   the number of ticks before the operation timeouts,
+ *                      the following special values are allowed:
+ *                      - @a TIME_IMMEDIATE immediate timeout.
+ *                      - @a TIME_INFINITE no timeout.
+ *                      .
+ * @return              The function outcome.
+ * @retval MSG_OK       if deferred broadcasts have been performed.
+ * @retval MSG_TIMEOUT  if a timeout occurred.
+ * @retval MSG_RESET    if the waiting thread has been reset.
+ *
+ * @api
+ */
+msg_t chEvtDeferrerDispatchTimeout(event_deferrer_t *edp,
+                                   sysinterval_t timeout) {
+  event_source_t *esp;
+  eventflags_t flags;
+  bool all;
+
+  chDbgCheck(edp != NULL);
+
+  chSysLock();
+
+  if (edp->head == NULL) {
+    msg_t msg = chThdSuspendTimeoutS(&edp->tr, timeout);
+    if (edp->head == NULL) {
+      chSysUnlock();
+      return msg;
+    }
+  }
+
+  while (edp->head != NULL) {
+    /* Removing the first source from the queue, new broadcasts on the
+       source will queue it again.*/
+    esp = edp->head;
+    edp->head = esp->dnext;
+    if (edp->head == NULL) {
+      edp->tail = NULL;
+    }
+    esp->dnext = NULL;
+
+    flags = esp->dflags;
+    all   = esp->dall;
+    esp->dflags = (eventflags_t)0;
+    esp->dall   = false;
+
+    /* A deferred broadcast without flags signals all listeners, the
+       accumulated flags are then delivered to the interested ones.*/
+    if (all) {
+      evt_broadcast_i(esp, (eventflags_t)0);
+    }
+    if (flags != (eventflags_t)0) {
+      evt_broadcast_i(esp, flags);
+    }
+    chSchRescheduleS();
+
+    /* Interrupts window between sources.*/
+    chSysUnlock();
+    chSysLock();
+  }
+
+  chSysUnlock();
+
+  return MSG_OK;
+}
+#endif /* CH_CFG_USE_EVENTS_DEFERRED == TRUE */
+
 #if (CH_CFG_OPTIMIZE_SPEED == TRUE) ||                                      \
     (CH_CFG_USE_EVENTS_TIMEOUT == FALSE) ||                                 \
     defined(__DOXYGEN__)
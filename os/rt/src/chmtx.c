@@ -52,6 +52,19 @@
  *          It is possible to enable the recursive behavior by enabling the
  *          option @p CH_CFG_USE_MUTEXES_RECURSIVE.
  *
+ *          <h2>Adaptive spinning</h2>
+ *          If @p CH_CFG_MTX_SPIN_COUNT is greater than zero then
+ *          @p chMtxLock() polls an owned mutex, with interrupts enabled,
+ *          for a limited number of iterations before entering the priority
+ *          inheritance path and sleeping. The number of iterations is
+ *          limited to twice the running average of the previous
+ *          successful spins on the same mutex, a failed spin halves the
+ *          average so that a mutex held for long periods is no more
+ *          polled. Because the kernel runs on a single core, an owner
+ *          with priority not greater than the current thread cannot
+ *          release the mutex during the spin, in that case the spin is
+ *          skipped.
+ *
  *          <h2>The priority inversion problem</h2>
  *          The mutexes in ChibiOS/RT implements the <b>full</b> priority
  *          inheritance mechanism in order handle the priority inversion
@@ -89,6 +102,73 @@
 /* Module local functions.                                                   */
 /*===========================================================================*/
 
+#if (CH_CFG_MTX_SPIN_COUNT > 0) || defined(__DOXYGEN__)
+/**
+ * @brief   Minimum number of iterations of a spin.
+ */
+#define MTX_SPIN_MIN            ((cnt_t)8)
+
+/**
+ * @brief   Polls the mutex owner with interrupts enabled.
+ *
+ * @param[in] mp        pointer to the @p mutex_t structure
+ * @return              The number of performed iterations, zero if the
+ *                      mutex was not owned, owned by the current thread
+ *                      or owned by a thread that cannot run during the
+ *                      spin.
+ *
+ * @notapi
+ */
+static cnt_t mtx_spin(mutex_t *mp) {
+  thread_t * volatile *opp = &mp->owner;
+  thread_t *otp = *opp;
+  cnt_t limit, n;
+
+  /* The owner can only release the mutex during the spin if it is able
+     to preempt the current thread.*/
+  if ((otp == NULL) || (otp->prio <= currp->prio)) {
+    return (cnt_t)0;
+  }
+
+  limit = (mp->spins * (cnt_t)2) + MTX_SPIN_MIN;
+  if (limit > (cnt_t)CH_CFG_MTX_SPIN_COUNT) {
+    limit = (cnt_t)CH_CFG_MTX_SPIN_COUNT;
+  }
+
+  n = (cnt_t)0;
+  while ((*opp != NULL) && (*opp != currp) && (n < limit)) {
+    port_spin_hint();
+    n++;
+  }
+
+  return n;
+}
+
+/**
+ * @brief   Updates the spins average after a spin.
+ *
+ * @param[in] mp        pointer to the @p mutex_t structure
+ * @param[in] n         number of iterations performed by @p mtx_spin()
+ *
+ * @notapi
+ */
+static void mtx_spin_update_s(mutex_t *mp, cnt_t n) {
+
+  if (n > (cnt_t)0) {
+    if (mp->owner == NULL) {
+      /* Successful spin, the average follows the spin duration.*/
+      mp->spins = (mp->spins + n + (cnt_t)1) / (cnt_t)2;
+      _stats_spin(true);
+    }
+    else {
+      /* Failed spin, the budget is halved.*/
+      mp->spins = mp->spins / (cnt_t)2;
+      _stats_spin(false);
+    }
+  }
+}
+#endif /* CH_CFG_MTX_SPIN_COUNT > 0 */
+
 /*===========================================================================*/
 /* Module exported functions.                                                */
 /*===========================================================================*/
@@ -109,6 +189,9 @@ void chMtxObjectInit(mutex_t *mp) {
 #if CH_CFG_USE_MUTEXES_RECURSIVE == TRUE
   mp->cnt = (cnt_t)0;
 #endif
+#if CH_CFG_MTX_SPIN_COUNT > 0
+  mp->spins = (cnt_t)0;
+#endif
 }
 
 /**
@@ -121,8 +204,14 @@ void chMtxObjectInit(mutex_t *mp) {
  * @api
  */
 void chMtxLock(mutex_t *mp) {
+#if CH_CFG_MTX_SPIN_COUNT > 0
+  cnt_t n = mtx_spin(mp);
+#endif
 
   chSysLock();
+#if CH_CFG_MTX_SPIN_COUNT > 0
+  mtx_spin_update_s(mp, n);
+#endif
   chMtxLockS(mp);
   chSysUnlock();
 }
@@ -142,6 +231,8 @@ void chMtxLockS(mutex_t *mp) {
   chDbgCheckClassS();
   chDbgCheck(mp != NULL);
 
+  _trace_sync(CH_TRACE_SYNC_MTX_LOCK, mp, (msg_t)(mp->owner != NULL));
+
   /* Is the mutex already locked? */
   if (mp->owner != NULL) {
 #if CH_CFG_USE_MUTEXES_RECURSIVE == TRUE
@@ -163,6 +254,13 @@ void chMtxLockS(mutex_t *mp) {
       /* Does the running thread have higher priority than the mutex
          owning thread? */
       while (tp->prio < ctp->prio) {
+#if CH_CFG_USE_READY_BITMAP == TRUE
+        /* The ready list index is keyed on the thread priority, a ready
+           thread must be removed before changing it.*/
+        if (tp->state == CH_STATE_READY) {
+          (void) rlist_dequeue(tp);
+        }
+#endif
         /* Make priority of thread tp match the running thread's priority.*/
         tp->prio = ctp->prio;
 
@@ -199,7 +297,11 @@ void chMtxLockS(mutex_t *mp) {
           tp->state = CH_STATE_CURRENT;
 #endif
           /* Re-enqueues tp with its new priority on the ready list.*/
+#if CH_CFG_USE_READY_BITMAP == TRUE
+          (void) chSchReadyI(tp);
+#else
           (void) chSchReadyI(queue_dequeue(tp));
+#endif
           break;
         default:
           /* Nothing to do for other states.*/
@@ -290,6 +392,7 @@ bool chMtxTryLockS(mutex_t *mp) {
     chDbgAssert(mp->cnt >= (cnt_t)1, "counter is not positive");
 
     if (mp->owner == currp) {
+      _trace_sync(CH_TRACE_SYNC_MTX_LOCK, mp, (msg_t)1);
       mp->cnt++;
       return true;
     }
@@ -302,6 +405,7 @@ bool chMtxTryLockS(mutex_t *mp) {
 
   mp->cnt++;
 #endif
+  _trace_sync(CH_TRACE_SYNC_MTX_LOCK, mp, (msg_t)0);
   mp->owner = currp;
   mp->next = currp->mtxlist;
   currp->mtxlist = mp;
@@ -328,6 +432,8 @@ void chMtxUnlock(mutex_t *mp) {
 
   chSysLock();
 
+  _trace_sync(CH_TRACE_SYNC_MTX_UNLOCK, mp, (msg_t)0);
+
   chDbgAssert(ctp->mtxlist != NULL, "owned mutexes list empty");
   chDbgAssert(ctp->mtxlist->owner == ctp, "ownership failure");
 #if CH_CFG_USE_MUTEXES_RECURSIVE == TRUE
@@ -414,6 +520,8 @@ void chMtxUnlockS(mutex_t *mp) {
   chDbgCheckClassS();
   chDbgCheck(mp != NULL);
 
+  _trace_sync(CH_TRACE_SYNC_MTX_UNLOCK, mp, (msg_t)0);
+
   chDbgAssert(ctp->mtxlist != NULL, "owned mutexes list empty");
   chDbgAssert(ctp->mtxlist->owner == ctp, "ownership failure");
 #if CH_CFG_USE_MUTEXES_RECURSIVE == TRUE
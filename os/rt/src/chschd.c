@@ -53,6 +53,132 @@ ch_system_t ch;
 /* Module local functions.                                                   */
 /*===========================================================================*/
 
+#if (CH_CFG_USE_READY_BITMAP == TRUE) || defined(__DOXYGEN__)
+/**
+ * @brief   Count leading zeros.
+ *
+ * @param[in] x         the value, must not be zero
+ * @return              The number of leading zero bits.
+ */
+static inline unsigned rlist_clz(uint32_t x) {
+#if defined(__GNUC__)
+
+  return (unsigned)__builtin_clz(x);
+#else
+  unsigned n = 0U;
+
+  if ((x & 0xFFFF0000U) == 0U) {
+    n += 16U;
+    x <<= 16;
+  }
+  if ((x & 0xFF000000U) == 0U) {
+    n += 8U;
+    x <<= 8;
+  }
+  if ((x & 0xF0000000U) == 0U) {
+    n += 4U;
+    x <<= 4;
+  }
+  if ((x & 0xC0000000U) == 0U) {
+    n += 2U;
+    x <<= 2;
+  }
+  if ((x & 0x80000000U) == 0U) {
+    n += 1U;
+  }
+
+  return n;
+#endif
+}
+
+/**
+ * @brief   Returns the last ready thread with priority greater or equal
+ *          than the specified one.
+ *
+ * @param[in] prio      the priority threshold
+ * @return              The last thread pointer or the ready list header
+ *                      if there are no threads matching the criteria.
+ */
+static thread_t *rlist_last_ge(unsigned prio) {
+  unsigned w = prio >> 5;
+  uint32_t m;
+
+  if (w >= CH_PRIO_MAP_WORDS) {
+    return (thread_t *)&ch.rlist.queue;
+  }
+
+  /* Levels greater or equal than prio inside the same word.*/
+  m = ch.rlist.prmask[w] & (0xFFFFFFFFU >> (prio & 31U));
+  if (m == 0U) {
+    uint32_t s;
+
+    /* Searching the following non-empty word, if any.*/
+    s = ch.rlist.prmap & (0x7FFFFFFFU >> w);
+    if (s == 0U) {
+      return (thread_t *)&ch.rlist.queue;
+    }
+    w = rlist_clz(s);
+    m = ch.rlist.prmask[w];
+  }
+
+  return ch.rlist.prtail[(w << 5) + rlist_clz(m)];
+}
+
+/**
+ * @brief   Marks a priority level as non-empty.
+ *
+ * @param[in] prio      the priority level
+ */
+static inline void rlist_set_level(tprio_t prio) {
+  unsigned w = (unsigned)prio >> 5;
+
+  ch.rlist.prmask[w] |= 0x80000000U >> ((unsigned)prio & 31U);
+  ch.rlist.prmap     |= 0x80000000U >> w;
+}
+
+/**
+ * @brief   Marks a priority level as empty.
+ *
+ * @param[in] prio      the priority level
+ */
+static inline void rlist_clear_level(tprio_t prio) {
+  unsigned w = (unsigned)prio >> 5;
+
+  ch.rlist.prmask[w] &= ~(0x80000000U >> ((unsigned)prio & 31U));
+  if (ch.rlist.prmask[w] == 0U) {
+    ch.rlist.prmap &= ~(0x80000000U >> w);
+  }
+}
+
+/**
+ * @brief   Inserts a thread in the ready list after the specified one.
+ *
+ * @param[in] tp        the thread to be inserted
+ * @param[in] cp        the thread after which @p tp is inserted
+ */
+static inline void rlist_insert_after(thread_t *tp, thread_t *cp) {
+
+  tp->queue.prev             = cp;
+  tp->queue.next             = cp->queue.next;
+  tp->queue.next->queue.prev = tp;
+  cp->queue.next             = tp;
+}
+#endif /* CH_CFG_USE_READY_BITMAP == TRUE */
+
+/**
+ * @brief   Removes the first thread from the ready list.
+ *
+ * @return              The removed thread pointer.
+ */
+static inline thread_t *rlist_remove_first(void) {
+
+#if CH_CFG_USE_READY_BITMAP == TRUE
+  return rlist_dequeue(ch.rlist.queue.next);
+#else
+  return queue_fifo_remove(&ch.rlist.queue);
+#endif
+}
+
 /*===========================================================================*/
 /* Module exported functions.                                                */
 /*===========================================================================*/
@@ -66,6 +192,16 @@ void _scheduler_init(void) {
 
   queue_init(&ch.rlist.queue);
   ch.rlist.prio = NOPRIO;
+#if CH_CFG_USE_READY_BITMAP == TRUE
+  {
+    unsigned i;
+
+    ch.rlist.prmap = 0U;
+    for (i = 0U; i < CH_PRIO_MAP_WORDS; i++) {
+      ch.rlist.prmask[i] = 0U;
+    }
+  }
+#endif
 #if CH_CFG_USE_REGISTRY == TRUE
   ch.rlist.newer = (thread_t *)&ch.rlist;
   ch.rlist.older = (thread_t *)&ch.rlist;
@@ -199,6 +335,38 @@ thread_t *list_remove(threads_list_t *tlp) {
 }
 #endif /* CH_CFG_OPTIMIZE_SPEED */
 
+#if (CH_CFG_USE_READY_BITMAP == TRUE) || defined(__DOXYGEN__)
+/**
+ * @brief   Removes a thread from the ready list.
+ * @note    The thread state is not modified.
+ *
+ * @param[in] tp        the thread to be removed
+ * @return              The removed thread pointer.
+ *
+ * @notapi
+ */
+thread_t *rlist_dequeue(thread_t *tp) {
+
+  /* If the thread is the last of its level then the level index is
+     updated.*/
+  if (ch.rlist.prtail[tp->prio] == tp) {
+    thread_t *pp = tp->queue.prev;
+
+    if (pp->prio == tp->prio) {
+      ch.rlist.prtail[tp->prio] = pp;
+    }
+    else {
+      rlist_clear_level(tp->prio);
+    }
+  }
+
+  tp->queue.prev->queue.next = tp->queue.next;
+  tp->queue.next->queue.prev = tp->queue.prev;
+
+  return tp;
+}
+#endif /* CH_CFG_USE_READY_BITMAP == TRUE */
+
 /**
  * @brief   Inserts a thread in the Ready List placing it behind its peers.
  * @details The thread is positioned behind all threads with higher or equal
@@ -216,7 +384,9 @@ thread_t *list_remove(threads_list_t *tlp) {
  * @iclass
  */
 thread_t *chSchReadyI(thread_t *tp) {
+#if CH_CFG_USE_READY_BITMAP == FALSE
   thread_t *cp;
+#endif
 
   chDbgCheckClassI();
   chDbgCheck(tp != NULL);
@@ -225,6 +395,13 @@ thread_t *chSchReadyI(thread_t *tp) {
               "invalid state");
 
   tp->state = CH_STATE_READY;
+#if CH_CFG_USE_READY_BITMAP == TRUE
+  /* Insertion after the last thread with greater or equal priority, the
+     thread becomes the last of its level.*/
+  rlist_insert_after(tp, rlist_last_ge((unsigned)tp->prio));
+  ch.rlist.prtail[tp->prio] = tp;
+  rlist_set_level(tp->prio);
+#else
   cp = (thread_t *)&ch.rlist.queue;
   do {
     cp = cp->queue.next;
@@ -234,6 +411,7 @@ thread_t *chSchReadyI(thread_t *tp) {
   tp->queue.prev             = cp->queue.prev;
   tp->queue.prev->queue.next = tp;
   cp->queue.prev             = tp;
+#endif
 
   return tp;
 }
@@ -255,7 +433,9 @@ thread_t *chSchReadyI(thread_t *tp) {
  * @iclass
  */
 thread_t *chSchReadyAheadI(thread_t *tp) {
+#if CH_CFG_USE_READY_BITMAP == FALSE
   thread_t *cp;
+#endif
 
   chDbgCheckClassI();
   chDbgCheck(tp != NULL);
@@ -264,6 +444,15 @@ thread_t *chSchReadyAheadI(thread_t *tp) {
               "invalid state");
 
   tp->state = CH_STATE_READY;
+#if CH_CFG_USE_READY_BITMAP == TRUE
+  /* Insertion after the last thread with greater priority, the thread
+     becomes the last of its level only if the level was empty.*/
+  rlist_insert_after(tp, rlist_last_ge((unsigned)tp->prio + 1U));
+  if (tp->queue.next->prio != tp->prio) {
+    ch.rlist.prtail[tp->prio] = tp;
+    rlist_set_level(tp->prio);
+  }
+#else
   cp = (thread_t *)&ch.rlist.queue;
   do {
     cp = cp->queue.next;
@@ -273,6 +462,7 @@ thread_t *chSchReadyAheadI(thread_t *tp) {
   tp->queue.prev             = cp->queue.prev;
   tp->queue.prev->queue.next = tp;
   cp->queue.prev             = tp;
+#endif
 
   return tp;
 }
@@ -301,7 +491,7 @@ void chSchGoSleepS(tstate_t newstate) {
 #endif
 
   /* Next thread in ready list becomes current.*/
-  currp = queue_fifo_remove(&ch.rlist.queue);
+  currp = rlist_remove_first();
   currp->state = CH_STATE_CURRENT;
 
   /* Handling idle-enter hook.*/
@@ -508,7 +698,7 @@ void chSchDoRescheduleBehind(void) {
   thread_t *otp = currp;
 
   /* Picks the first thread from the ready queue and makes it current.*/
-  currp = queue_fifo_remove(&ch.rlist.queue);
+  currp = rlist_remove_first();
   currp->state = CH_STATE_CURRENT;
 
   /* Handling idle-leave hook.*/
@@ -541,7 +731,7 @@ void chSchDoRescheduleAhead(void) {
   thread_t *otp = currp;
 
   /* Picks the first thread from the ready queue and makes it current.*/
-  currp = queue_fifo_remove(&ch.rlist.queue);
+  currp = rlist_remove_first();
   currp->state = CH_STATE_CURRENT;
 
   /* Handling idle-leave hook.*/
@@ -571,7 +761,7 @@ void chSchDoReschedule(void) {
   thread_t *otp = currp;
 
   /* Picks the first thread from the ready queue and makes it current.*/
-  currp = queue_fifo_remove(&ch.rlist.queue);
+  currp = rlist_remove_first();
   currp->state = CH_STATE_CURRENT;
 
   /* Handling idle-leave hook.*/
@@ -49,7 +49,17 @@
  *          also have other uses, queues guards and counters for example.<br>
  *          Semaphores usually use a FIFO queuing strategy but it is possible
  *          to make them order threads by priority by enabling
- *          @p CH_CFG_USE_SEMAPHORES_PRIORITY in @p chconf.h.
+ *          @p CH_CFG_USE_SEMAPHORES_PRIORITY in @p chconf.h.<br>
+ *          If @p CH_CFG_SEM_SPIN_COUNT is greater than zero then the
+ *          @p chSemWait() and @p chSemWaitTimeout() functions poll the
+ *          counter, with interrupts enabled, for a limited number of
+ *          iterations before sleeping. A semaphore signaled by an ISR
+ *          during the spin is taken without context switches. The number
+ *          of iterations is limited to twice the running average of the
+ *          previous successful spins on the same semaphore, a failed spin
+ *          halves the average so that a semaphore not signaled quickly is
+ *          no more polled. The time spent spinning is deducted from the
+ *          @p chSemWaitTimeout() timeout.
  * @pre     In order to use the semaphore APIs the @p CH_CFG_USE_SEMAPHORES
  *          option must be enabled in @p chconf.h.
  * @{
@@ -81,6 +91,63 @@
 #define sem_insert(tp, qp) queue_insert(tp, qp)
 #endif
 
+#if (CH_CFG_SEM_SPIN_COUNT > 0) || defined(__DOXYGEN__)
+/**
+ * @brief   Minimum number of iterations of a spin.
+ */
+#define SEM_SPIN_MIN            ((cnt_t)8)
+
+/**
+ * @brief   Polls the semaphore counter with interrupts enabled.
+ *
+ * @param[in] sp        pointer to a @p semaphore_t structure
+ * @return              The number of performed iterations, zero if the
+ *                      counter was already positive.
+ *
+ * @notapi
+ */
+static cnt_t sem_spin(semaphore_t *sp) {
+  cnt_t limit, n;
+
+  limit = (sp->spins * (cnt_t)2) + SEM_SPIN_MIN;
+  if (limit > (cnt_t)CH_CFG_SEM_SPIN_COUNT) {
+    limit = (cnt_t)CH_CFG_SEM_SPIN_COUNT;
+  }
+
+  n = (cnt_t)0;
+  while ((*(volatile cnt_t *)&sp->cnt <= (cnt_t)0) && (n < limit)) {
+    port_spin_hint();
+    n++;
+  }
+
+  return n;
+}
+
+/**
+ * @brief   Updates the spins average after a spin.
+ *
+ * @param[in] sp        pointer to a @p semaphore_t structure
+ * @param[in] n         number of iterations performed by @p sem_spin()
+ *
+ * @notapi
+ */
+static void sem_spin_update_s(semaphore_t *sp, cnt_t n) {
+
+  if (n > (cnt_t)0) {
+    if (sp->cnt > (cnt_t)0) {
+      /* Successful spin, the average follows the spin duration.*/
+      sp->spins = (sp->spins + n + (cnt_t)1) / (cnt_t)2;
+      _stats_spin(true);
+    }
+    else {
+      /* Failed spin, the budget is halved.*/
+      sp->spins = sp->spins / (cnt_t)2;
+      _stats_spin(false);
+    }
+  }
+}
+#endif /* CH_CFG_SEM_SPIN_COUNT > 0 */
+
 /*===========================================================================*/
 /* Module exported functions.                                                */
 /*===========================================================================*/
@@ -100,6 +167,9 @@ void chSemObjectInit(semaphore_t *sp, cnt_t n) {
 
   queue_init(&sp->queue);
   sp->cnt = n;
+#if CH_CFG_SEM_SPIN_COUNT > 0
+  sp->spins = (cnt_t)0;
+#endif
 }
 
 /**
@@ -174,8 +244,14 @@ void chSemResetWithMessageI(semaphore_t *sp, cnt_t n, msg_t msg) {
  */
 msg_t chSemWait(semaphore_t *sp) {
   msg_t msg;
+#if CH_CFG_SEM_SPIN_COUNT > 0
+  cnt_t n = sem_spin(sp);
+#endif
 
   chSysLock();
+#if CH_CFG_SEM_SPIN_COUNT > 0
+  sem_spin_update_s(sp, n);
+#endif
   msg = chSemWaitS(sp);
   chSysUnlock();
 
@@ -202,6 +278,8 @@ msg_t chSemWaitS(semaphore_t *sp) {
               ((sp->cnt < (cnt_t)0) && queue_notempty(&sp->queue)),
               "inconsistent semaphore");
 
+  _trace_sync(CH_TRACE_SYNC_SEM_WAIT, sp, (msg_t)(sp->cnt - (cnt_t)1));
+
   if (--sp->cnt < (cnt_t)0) {
     currp->u.wtsemp = sp;
     sem_insert(currp, &sp->queue);
@@ -234,8 +312,22 @@ msg_t chSemWaitS(semaphore_t *sp) {
  */
 msg_t chSemWaitTimeout(semaphore_t *sp, sysinterval_t timeout) {
   msg_t msg;
+#if CH_CFG_SEM_SPIN_COUNT > 0
+  systime_t start = chVTGetSystemTimeX();
+  cnt_t n = (timeout == TIME_IMMEDIATE) ? (cnt_t)0 : sem_spin(sp);
+#endif
 
   chSysLock();
+#if CH_CFG_SEM_SPIN_COUNT > 0
+  sem_spin_update_s(sp, n);
+
+  /* The time spent spinning is part of the timeout.*/
+  if ((n > (cnt_t)0) && (timeout != TIME_INFINITE)) {
+    sysinterval_t elapsed = chTimeDiffX(start, chVTGetSystemTimeX());
+
+    timeout = (elapsed >= timeout) ? TIME_IMMEDIATE : timeout - elapsed;
+  }
+#endif
   msg = chSemWaitTimeoutS(sp, timeout);
   chSysUnlock();
 
@@ -269,6 +361,8 @@ msg_t chSemWaitTimeoutS(semaphore_t *sp, sysinterval_t timeout) {
               ((sp->cnt < (cnt_t)0) && queue_notempty(&sp->queue)),
               "inconsistent semaphore");
 
+  _trace_sync(CH_TRACE_SYNC_SEM_WAIT, sp, (msg_t)(sp->cnt - (cnt_t)1));
+
   if (--sp->cnt < (cnt_t)0) {
     if (TIME_IMMEDIATE == timeout) {
       sp->cnt++;
@@ -299,6 +393,7 @@ void chSemSignal(semaphore_t *sp) {
   chDbgAssert(((sp->cnt >= (cnt_t)0) && queue_isempty(&sp->queue)) ||
               ((sp->cnt < (cnt_t)0) && queue_notempty(&sp->queue)),
               "inconsistent semaphore");
+  _trace_sync(CH_TRACE_SYNC_SEM_SIGNAL, sp, (msg_t)(sp->cnt + (cnt_t)1));
   if (++sp->cnt <= (cnt_t)0) {
     chSchWakeupS(queue_fifo_remove(&sp->queue), MSG_OK);
   }
@@ -324,6 +419,8 @@ void chSemSignalI(semaphore_t *sp) {
               ((sp->cnt < (cnt_t)0) && queue_notempty(&sp->queue)),
               "inconsistent semaphore");
 
+  _trace_sync(CH_TRACE_SYNC_SEM_SIGNAL, sp, (msg_t)(sp->cnt + (cnt_t)1));
+
   if (++sp->cnt <= (cnt_t)0) {
     /* Note, it is done this way in order to allow a tail call on
              chSchReadyI().*/
@@ -360,6 +457,8 @@ void chSemAddCounterI(semaphore_t *sp, cnt_t n) {
     }
     n--;
   }
+
+  _trace_sync(CH_TRACE_SYNC_SEM_SIGNAL, sp, (msg_t)sp->cnt);
 }
 
 /**
@@ -387,9 +486,11 @@ msg_t chSemSignalWait(semaphore_t *sps, semaphore_t *spw) {
   chDbgAssert(((spw->cnt >= (cnt_t)0) && queue_isempty(&spw->queue)) ||
               ((spw->cnt < (cnt_t)0) && queue_notempty(&spw->queue)),
               "inconsistent semaphore");
+  _trace_sync(CH_TRACE_SYNC_SEM_SIGNAL, sps, (msg_t)(sps->cnt + (cnt_t)1));
   if (++sps->cnt <= (cnt_t)0) {
     chSchReadyI(queue_fifo_remove(&sps->queue))->u.rdymsg = MSG_OK;
   }
+  _trace_sync(CH_TRACE_SYNC_SEM_WAIT, spw, (msg_t)(spw->cnt - (cnt_t)1));
   if (--spw->cnt < (cnt_t)0) {
     thread_t *ctp = currp;
     sem_insert(ctp, &spw->queue);
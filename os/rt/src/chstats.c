@@ -63,6 +63,8 @@ void _stats_init(void) {
 
   ch.kernel_stats.n_irq = (ucnt_t)0;
   ch.kernel_stats.n_ctxswc = (ucnt_t)0;
+  ch.kernel_stats.n_spin = (ucnt_t)0;
+  ch.kernel_stats.n_spin_ok = (ucnt_t)0;
   chTMObjectInit(&ch.kernel_stats.m_crit_thd);
   chTMObjectInit(&ch.kernel_stats.m_crit_isr);
 }
@@ -121,6 +123,19 @@ void _stats_stop_measure_crit_isr(void) {
   chTMStopMeasurementX(&ch.kernel_stats.m_crit_isr);
 }
 
+/**
+ * @brief   Accounts an adaptive spin on a mutex or a semaphore.
+ *
+ * @param[in] ok        @p true if the spin has been successful
+ */
+void _stats_spin(bool ok) {
+
+  ch.kernel_stats.n_spin++;
+  if (ok) {
+    ch.kernel_stats.n_spin_ok++;
+  }
+}
+
 #endif /* CH_DBG_STATISTICS == TRUE */
 
 /** @} */
@@ -257,10 +257,95 @@ bool chSysIntegrityCheckI(unsigned testmask) {
     if (n != (cnt_t)0) {
       return true;
     }
+
+#if CH_CFG_USE_READY_BITMAP == TRUE
+    /* Each priority level in the ready list must be marked in the bitmap
+       and its last thread must match the tail pointer.*/
+    tp = ch.rlist.queue.next;
+    while (tp != (thread_t *)&ch.rlist.queue) {
+      unsigned w = (unsigned)tp->prio >> 5;
+      uint32_t b = 0x80000000U >> ((unsigned)tp->prio & 31U);
+
+      if (((ch.rlist.prmask[w] & b) == 0U) ||
+          ((ch.rlist.prmap & (0x80000000U >> w)) == 0U)) {
+        return true;
+      }
+      if (tp->queue.next->prio != tp->prio) {
+        if (ch.rlist.prtail[tp->prio] != tp) {
+          return true;
+        }
+        n++;
+      }
+      tp = tp->queue.next;
+    }
+
+    /* The number of levels must match the bits in the bitmap.*/
+    {
+      unsigned i;
+
+      for (i = 0U; i < CH_PRIO_MAP_WORDS; i++) {
+        uint32_t m = ch.rlist.prmask[i];
+
+        while (m != 0U) {
+          m &= m - 1U;
+          n--;
+        }
+      }
+    }
+    if (n != (cnt_t)0) {
+      return true;
+    }
+#endif
   }
 
   /* Timers list integrity check.*/
   if ((testmask & CH_INTEGRITY_VTLIST) != 0U) {
+#if CH_CFG_USE_TIMERS_HEAP == TRUE
+    virtual_timer_t *vtp, *prevp, *nextp;
+
+    /* Walking the heap using the parent links, each node is checked
+       against its children on the first visit.*/
+    n = (cnt_t)0;
+    prevp = NULL;
+    vtp = ch.vtlist.root;
+    while (vtp != NULL) {
+      if (prevp == vtp->parent) {
+        n++;
+        if ((vtp->left != NULL) &&
+            ((vtp->left->parent != vtp) ||
+             (vtp->left->deadline < vtp->deadline))) {
+          return true;
+        }
+        if ((vtp->right != NULL) &&
+            ((vtp->right->parent != vtp) ||
+             (vtp->right->deadline < vtp->deadline))) {
+          return true;
+        }
+        if (vtp->left != NULL) {
+          nextp = vtp->left;
+        }
+        else if (vtp->right != NULL) {
+          nextp = vtp->right;
+        }
+        else {
+          nextp = vtp->parent;
+        }
+      }
+      else if ((prevp == vtp->left) && (vtp->right != NULL)) {
+        nextp = vtp->right;
+      }
+      else {
+        nextp = vtp->parent;
+      }
+      prevp = vtp;
+      vtp = nextp;
+    }
+
+    /* The number of elements must match.*/
+    if (n != (cnt_t)ch.vtlist.n) {
+      return true;
+    }
+#else /* CH_CFG_USE_TIMERS_HEAP == FALSE */
     virtual_timer_t * vtp;
 
     /* Scanning the timers list forward.*/
@@ -282,6 +367,7 @@ bool chSysIntegrityCheckI(unsigned testmask) {
     if (n != (cnt_t)0) {
       return true;
     }
+#endif /* CH_CFG_USE_TIMERS_HEAP == FALSE */
   }
 
 #if CH_CFG_USE_REGISTRY == TRUE
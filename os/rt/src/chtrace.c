@@ -66,6 +66,15 @@ static NOINLINE void trace_next(void) {
   /* Trace hook, useful in order to interface debug tools.*/
   CH_CFG_TRACE_HOOK(ch.dbg.trace_buffer.ptr);
 
+  /* If the buffer is full of unread records then the oldest one has just
+     been overwritten.*/
+  if (ch.dbg.trace_buffer.unread < (size_t)CH_DBG_TRACE_BUFFER_SIZE) {
+    ch.dbg.trace_buffer.unread++;
+  }
+  else {
+    ch.dbg.trace_buffer.overflows++;
+  }
+
   if (++ch.dbg.trace_buffer.ptr >=
       &ch.dbg.trace_buffer.buffer[CH_DBG_TRACE_BUFFER_SIZE]) {
     ch.dbg.trace_buffer.ptr = &ch.dbg.trace_buffer.buffer[0];
@@ -88,6 +97,8 @@ void _trace_init(void) {
   ch.dbg.trace_buffer.suspended = (uint16_t)~CH_DBG_TRACE_MASK;
   ch.dbg.trace_buffer.size      = CH_DBG_TRACE_BUFFER_SIZE;
   ch.dbg.trace_buffer.ptr       = &ch.dbg.trace_buffer.buffer[0];
+  ch.dbg.trace_buffer.unread    = (size_t)0;
+  ch.dbg.trace_buffer.overflows = 0U;
   for (i = 0U; i < (unsigned)CH_DBG_TRACE_BUFFER_SIZE; i++) {
     ch.dbg.trace_buffer.buffer[i].type = CH_TRACE_TYPE_UNUSED;
   }
@@ -169,6 +180,47 @@ void _trace_halt(const char *reason) {
   }
 }
 
+/**
+ * @brief   Inserts in the circular debug trace buffer a synchronization
+ *          operation record.
+ *
+ * @param[in] op        the operation code, one of the
+ *                      @p CH_TRACE_SYNC_xxx constants
+ * @param[in] objp      pointer to the object involved in the operation
+ * @param[in] msg       operation-dependent value
+ *
+ * @notapi
+ */
+void _trace_sync(unsigned op, void *objp, msg_t msg) {
+
+  if ((ch.dbg.trace_buffer.suspended & CH_DBG_TRACE_MASK_SYNC) == 0U) {
+    ch.dbg.trace_buffer.ptr->type        = CH_TRACE_TYPE_SYNC;
+    ch.dbg.trace_buffer.ptr->state       = (uint8_t)op;
+    ch.dbg.trace_buffer.ptr->u.sync.objp = objp;
+    ch.dbg.trace_buffer.ptr->u.sync.msg  = msg;
+    trace_next();
+  }
+}
+
+/**
+ * @brief   Inserts in the circular debug trace buffer a virtual timer
+ *          firing record.
+ *
+ * @param[in] vtp       the virtual timer about to be fired
+ *
+ * @notapi
+ */
+void _trace_vt(virtual_timer_t *vtp) {
+
+  if ((ch.dbg.trace_buffer.suspended & CH_DBG_TRACE_MASK_VT) == 0U) {
+    ch.dbg.trace_buffer.ptr->type       = CH_TRACE_TYPE_VT;
+    ch.dbg.trace_buffer.ptr->state      = 0U;
+    ch.dbg.trace_buffer.ptr->u.vt.func  = vtp->func;
+    ch.dbg.trace_buffer.ptr->u.vt.par   = vtp->par;
+    trace_next();
+  }
+}
+
 /**
  * @brief   Adds an user trace record to the trace buffer.
  *
@@ -260,6 +312,50 @@ void chDbgResumeTrace(uint16_t mask) {
   chDbgResumeTraceI(mask);
   chSysUnlock();
 }
+
+/**
+ * @brief   Fetches the oldest unread records from the trace buffer.
+ * @details The fetched records are marked as read, records overwritten
+ *          before being fetched are accounted in the overflows counter,
+ *          see @p chDbgGetTraceOverflowsX().
+ * @note    This function is meant for a single reader, for example a
+ *          thread draining the trace buffer into a stream.
+ * @note    The records are copied within the critical zone, keep @p n
+ *          small in order to not impact the system latency.
+ *
+ * @param[out] tep      pointer to an array of records to be filled
+ * @param[in] n         maximum number of records to be fetched
+ * @return              The number of records actually fetched.
+ *
+ * @iclass
+ */
+size_t chDbgReadTraceI(ch_trace_event_t *tep, size_t n) {
+  size_t i, rdidx;
+
+  chDbgCheckClassI();
+  chDbgCheck(tep != NULL);
+
+  if (n > ch.dbg.trace_buffer.unread) {
+    n = ch.dbg.trace_buffer.unread;
+  }
+
+  /* The oldest unread record is behind the buffer front.*/
+  rdidx = (size_t)(ch.dbg.trace_buffer.ptr - &ch.dbg.trace_buffer.buffer[0]) +
+          (size_t)CH_DBG_TRACE_BUFFER_SIZE - ch.dbg.trace_buffer.unread;
+  if (rdidx >= (size_t)CH_DBG_TRACE_BUFFER_SIZE) {
+    rdidx -= (size_t)CH_DBG_TRACE_BUFFER_SIZE;
+  }
+
+  for (i = (size_t)0; i < n; i++) {
+    *tep++ = ch.dbg.trace_buffer.buffer[rdidx];
+    if (++rdidx >= (size_t)CH_DBG_TRACE_BUFFER_SIZE) {
+      rdidx = (size_t)0;
+    }
+  }
+  ch.dbg.trace_buffer.unread -= n;
+
+  return n;
+}
 #endif /* CH_DBG_TRACE_MASK != CH_DBG_TRACE_MASK_DISABLED */
 
 /** @} */
@@ -48,6 +48,273 @@
 /* Module local functions.                                                   */
 /*===========================================================================*/
 
+#if (CH_CFG_USE_TIMERS_HEAP == TRUE) || defined(__DOXYGEN__)
+#if (CH_CFG_ST_TIMEDELTA > 0) || defined(__DOXYGEN__)
+/**
+ * @brief   Brings the extended time base up to date.
+ * @note    The extended time can be wrong after a period of inactivity
+ *          longer than the system time range, this is harmless because
+ *          there are no armed timers depending on it in that case.
+ *
+ * @return              The current system time.
+ *
+ * @notapi
+ */
+static systime_t vt_update_basetime(void) {
+  systime_t now = chVTGetSystemTimeX();
+
+  ch.vtlist.basetime += (vttime_t)chTimeDiffX(ch.vtlist.lasttime, now);
+  ch.vtlist.lasttime = now;
+
+  return now;
+}
+
+/**
+ * @brief   Programs the alarm for the timer on top of the heap.
+ *
+ * @param[in] now       the current system time
+ *
+ * @notapi
+ */
+static void vt_set_alarm(systime_t now) {
+  vttime_t delta;
+
+  /* Distance from now to the nearest deadline, making sure to not
+     schedule an event closer than CH_CFG_ST_TIMEDELTA ticks from now.*/
+  if (ch.vtlist.root->deadline > ch.vtlist.basetime) {
+    delta = ch.vtlist.root->deadline - ch.vtlist.basetime;
+  }
+  else {
+    delta = (vttime_t)0;
+  }
+  if (delta < (vttime_t)CH_CFG_ST_TIMEDELTA) {
+    delta = (vttime_t)CH_CFG_ST_TIMEDELTA;
+  }
+  /* The delta could be too large for the physical timer to handle.*/
+  else if (delta > (vttime_t)TIME_MAX_SYSTIME) {
+    delta = (vttime_t)TIME_MAX_SYSTIME;
+  }
+  else {
+    /* Nothing to adjust.*/
+  }
+  port_timer_set_alarm(chTimeAddX(now, (sysinterval_t)delta));
+}
+#endif /* CH_CFG_ST_TIMEDELTA > 0 */
+
+/**
+ * @brief   Returns the heap node at the specified position.
+ * @details Positions are numbered from one in breadth-first order, the
+ *          bits of the position after the most significant one encode
+ *          the path from the root, zero is left and one is right.
+ *
+ * @param[in] pos       position of the node, from 1 to the heap size
+ * @return              Pointer to the timer at the specified position.
+ *
+ * @notapi
+ */
+static virtual_timer_t *vt_heap_get(ucnt_t pos) {
+  virtual_timer_t *vtp = ch.vtlist.root;
+  ucnt_t mask = (ucnt_t)1;
+
+  while ((pos >> 1) >= mask) {
+    mask <<= 1;
+  }
+  mask >>= 1;
+  while (mask > (ucnt_t)0) {
+    if ((pos & mask) != (ucnt_t)0) {
+      vtp = vtp->right;
+    }
+    else {
+      vtp = vtp->left;
+    }
+    mask >>= 1;
+  }
+
+  return vtp;
+}
+
+/**
+ * @brief   Exchanges a timer with its parent in the heap.
+ *
+ * @param[in] vtp       the timer to be moved one level up
+ *
+ * @notapi
+ */
+static void vt_heap_swap_up(virtual_timer_t *vtp) {
+  virtual_timer_t *pp = vtp->parent;
+  virtual_timer_t *gp = pp->parent;
+  virtual_timer_t *lp = vtp->left;
+  virtual_timer_t *rp = vtp->right;
+
+  /* The parent becomes a child of the moved timer.*/
+  if (pp->left == vtp) {
+    vtp->left  = pp;
+    vtp->right = pp->right;
+    if (vtp->right != NULL) {
+      vtp->right->parent = vtp;
+    }
+  }
+  else {
+    vtp->right = pp;
+    vtp->left  = pp->left;
+    if (vtp->left != NULL) {
+      vtp->left->parent = vtp;
+    }
+  }
+
+  /* The parent inherits the children of the moved timer.*/
+  pp->left  = lp;
+  pp->right = rp;
+  if (lp != NULL) {
+    lp->parent = pp;
+  }
+  if (rp != NULL) {
+    rp->parent = pp;
+  }
+  pp->parent  = vtp;
+
+  /* Linking the moved timer to the grandparent.*/
+  vtp->parent = gp;
+  if (gp == NULL) {
+    ch.vtlist.root = vtp;
+  }
+  else if (gp->left == pp) {
+    gp->left = vtp;
+  }
+  else {
+    gp->right = vtp;
+  }
+}
+
+/**
+ * @brief   Moves a timer toward the root until the heap order is restored.
+ *
+ * @param[in] vtp       the timer to be moved
+ *
+ * @notapi
+ */
+static void vt_heap_sift_up(virtual_timer_t *vtp) {
+
+  while ((vtp->parent != NULL) && (vtp->deadline < vtp->parent->deadline)) {
+    vt_heap_swap_up(vtp);
+  }
+}
+
+/**
+ * @brief   Moves a timer toward the leaves until the heap order is restored.
+ *
+ * @param[in] vtp       the timer to be moved
+ *
+ * @notapi
+ */
+static void vt_heap_sift_down(virtual_timer_t *vtp) {
+
+  while (vtp->left != NULL) {
+    virtual_timer_t *cp = vtp->left;
+
+    if ((vtp->right != NULL) && (vtp->right->deadline < cp->deadline)) {
+      cp = vtp->right;
+    }
+    if (cp->deadline >= vtp->deadline) {
+      break;
+    }
+    vt_heap_swap_up(cp);
+  }
+}
+
+/**
+ * @brief   Inserts a timer in the heap.
+ * @note    The timer deadline must be already initialized.
+ *
+ * @param[in] vtp       the timer to be inserted
+ *
+ * @notapi
+ */
+static void vt_heap_insert(virtual_timer_t *vtp) {
+  virtual_timer_t *pp;
+
+  vtp->left  = NULL;
+  vtp->right = NULL;
+  ch.vtlist.n++;
+
+  /* Special case where the heap is empty.*/
+  if (ch.vtlist.n == (ucnt_t)1) {
+    vtp->parent = NULL;
+    ch.vtlist.root = vtp;
+    return;
+  }
+
+  /* The timer is appended in the first free position then moved up.*/
+  pp = vt_heap_get(ch.vtlist.n >> 1);
+  vtp->parent = pp;
+  if ((ch.vtlist.n & (ucnt_t)1) != (ucnt_t)0) {
+    pp->right = vtp;
+  }
+  else {
+    pp->left = vtp;
+  }
+  vt_heap_sift_up(vtp);
+}
+
+/**
+ * @brief   Removes a timer from the heap.
+ *
+ * @param[in] vtp       the timer to be removed
+ *
+ * @notapi
+ */
+static void vt_heap_remove(virtual_timer_t *vtp) {
+  virtual_timer_t *lastp;
+
+  /* Detaching the last timer of the heap.*/
+  lastp = vt_heap_get(ch.vtlist.n);
+  ch.vtlist.n--;
+  if (lastp->parent == NULL) {
+    ch.vtlist.root = NULL;
+    return;
+  }
+  if (lastp->parent->right == lastp) {
+    lastp->parent->right = NULL;
+  }
+  else {
+    lastp->parent->left = NULL;
+  }
+  if (lastp == vtp) {
+    return;
+  }
+
+  /* The last timer takes the place of the removed one.*/
+  lastp->parent = vtp->parent;
+  lastp->left   = vtp->left;
+  lastp->right  = vtp->right;
+  if (lastp->left != NULL) {
+    lastp->left->parent = lastp;
+  }
+  if (lastp->right != NULL) {
+    lastp->right->parent = lastp;
+  }
+  if (lastp->parent == NULL) {
+    ch.vtlist.root = lastp;
+  }
+  else if (lastp->parent->left == vtp) {
+    lastp->parent->left = lastp;
+  }
+  else {
+    lastp->parent->right = lastp;
+  }
+
+  /* Restoring the heap order, the timer can need to move in either
+     direction.*/
+  if ((lastp->parent != NULL) &&
+      (lastp->deadline < lastp->parent->deadline)) {
+    vt_heap_sift_up(lastp);
+  }
+  else {
+    vt_heap_sift_down(lastp);
+  }
+}
+#endif /* CH_CFG_USE_TIMERS_HEAP == TRUE */
+
 /*===========================================================================*/
 /* Module exported functions.                                                */
 /*===========================================================================*/
@@ -60,6 +327,16 @@
  */
 void _vt_init(void) {
 
+#if CH_CFG_USE_TIMERS_HEAP == TRUE
+  ch.vtlist.root = NULL;
+  ch.vtlist.n = (ucnt_t)0;
+  ch.vtlist.basetime = (vttime_t)0;
+#if CH_CFG_ST_TIMEDELTA == 0
+  ch.vtlist.systime = (systime_t)0;
+#else /* CH_CFG_ST_TIMEDELTA > 0 */
+  ch.vtlist.lasttime = (systime_t)0;
+#endif /* CH_CFG_ST_TIMEDELTA > 0 */
+#else /* CH_CFG_USE_TIMERS_HEAP == FALSE */
   ch.vtlist.next = (virtual_timer_t *)&ch.vtlist;
   ch.vtlist.prev = (virtual_timer_t *)&ch.vtlist;
   ch.vtlist.delta = (sysinterval_t)-1;
@@ -68,6 +345,7 @@ void _vt_init(void) {
 #else /* CH_CFG_ST_TIMEDELTA > 0 */
   ch.vtlist.lasttime = (systime_t)0;
 #endif /* CH_CFG_ST_TIMEDELTA > 0 */
+#endif /* CH_CFG_USE_TIMERS_HEAP == FALSE */
 }
 
 /**
@@ -94,8 +372,10 @@ void _vt_init(void) {
  */
 void chVTDoSetI(virtual_timer_t *vtp, sysinterval_t delay,
                 vtfunc_t vtfunc, void *par) {
+#if CH_CFG_USE_TIMERS_HEAP == FALSE
   virtual_timer_t *p;
   sysinterval_t delta;
+#endif
 
   chDbgCheckClassI();
   chDbgCheck((vtp != NULL) && (vtfunc != NULL) && (delay != TIME_IMMEDIATE));
@@ -103,6 +383,42 @@ void chVTDoSetI(virtual_timer_t *vtp, sysinterval_t delay,
   vtp->par = par;
   vtp->func = vtfunc;
 
+#if CH_CFG_USE_TIMERS_HEAP == TRUE
+#if CH_CFG_ST_TIMEDELTA > 0
+  {
+    systime_t now = vt_update_basetime();
+
+    /* If the requested delay is lower than the minimum safe delta then it
+       is raised to the minimum safe value.*/
+    if (delay < (sysinterval_t)CH_CFG_ST_TIMEDELTA) {
+      delay = (sysinterval_t)CH_CFG_ST_TIMEDELTA;
+    }
+
+    vtp->deadline = ch.vtlist.basetime + (vttime_t)delay;
+    vt_heap_insert(vtp);
+
+    /* If the timer became the nearest deadline then the alarm is
+       reprogrammed, the alarm timer is started if it is the only one.*/
+    if (ch.vtlist.root == vtp) {
+      if (ch.vtlist.n == (ucnt_t)1) {
+#if CH_CFG_INTERVALS_SIZE > CH_CFG_ST_RESOLUTION
+        /* The delta could be too large for the physical timer to handle.*/
+        if (delay > (sysinterval_t)TIME_MAX_SYSTIME) {
+          delay = (sysinterval_t)TIME_MAX_SYSTIME;
+        }
+#endif
+        port_timer_start_alarm(chTimeAddX(now, delay));
+      }
+      else {
+        vt_set_alarm(now);
+      }
+    }
+  }
+#else /* CH_CFG_ST_TIMEDELTA == 0 */
+  vtp->deadline = ch.vtlist.basetime + (vttime_t)delay;
+  vt_heap_insert(vtp);
+#endif /* CH_CFG_ST_TIMEDELTA == 0 */
+#else /* CH_CFG_USE_TIMERS_HEAP == FALSE */
 #if CH_CFG_ST_TIMEDELTA > 0
   {
     systime_t now = chVTGetSystemTimeX();
@@ -198,6 +514,7 @@ void chVTDoSetI(virtual_timer_t *vtp, sysinterval_t delay,
   /* Special case when the timer is in last position in the list, the
      value in the header must be restored.*/
   ch.vtlist.delta = (sysinterval_t)-1;
+#endif /* CH_CFG_USE_TIMERS_HEAP == FALSE */
 }
 
 /**
@@ -214,6 +531,43 @@ void chVTDoResetI(virtual_timer_t *vtp) {
   chDbgCheck(vtp != NULL);
   chDbgAssert(vtp->func != NULL, "timer not set or already triggered");
 
+#if CH_CFG_USE_TIMERS_HEAP == TRUE
+#if CH_CFG_ST_TIMEDELTA == 0
+  vt_heap_remove(vtp);
+  vtp->func = NULL;
+#else /* CH_CFG_ST_TIMEDELTA > 0 */
+  {
+    bool first = (bool)(ch.vtlist.root == vtp);
+
+    vt_heap_remove(vtp);
+    vtp->func = NULL;
+
+    /* If the timer was not the nearest deadline then the alarm is not
+       affected.*/
+    if (!first) {
+      return;
+    }
+
+    /* If the heap became empty then the alarm timer is stopped and done.*/
+    if (ch.vtlist.root == NULL) {
+      port_timer_stop_alarm();
+
+      return;
+    }
+
+    /* If the current time surpassed the time of the new nearest deadline
+       then the event interrupt is already pending, else the alarm is moved
+       forward.*/
+    {
+      systime_t now = vt_update_basetime();
+
+      if (ch.vtlist.root->deadline > ch.vtlist.basetime) {
+        vt_set_alarm(now);
+      }
+    }
+  }
+#endif /* CH_CFG_ST_TIMEDELTA > 0 */
+#else /* CH_CFG_USE_TIMERS_HEAP == FALSE */
 #if CH_CFG_ST_TIMEDELTA == 0
 
   /* The delta of the timer is added to the next timer.*/
@@ -294,6 +648,76 @@ void chVTDoResetI(virtual_timer_t *vtp) {
   }
   port_timer_set_alarm(chTimeAddX(ch.vtlist.lasttime, delta));
 #endif /* CH_CFG_ST_TIMEDELTA > 0 */
+#endif /* CH_CFG_USE_TIMERS_HEAP == FALSE */
+}
+
+#if (CH_CFG_USE_TIMERS_HEAP == TRUE) || defined(__DOXYGEN__)
+/**
+ * @brief   Virtual timers heap ticker.
+ * @note    Internal use only, invoked by @p chVTDoTickI() when the
+ *          timers heap is enabled.
+ * @note    The system lock is released before entering the callbacks and
+ *          re-acquired immediately after.
+ *
+ * @notapi
+ */
+void _vt_heap_tick(void) {
+  virtual_timer_t *vtp;
+  vtfunc_t fn;
+
+#if CH_CFG_ST_TIMEDELTA == 0
+  ch.vtlist.systime++;
+  ch.vtlist.basetime++;
+
+  /* Consuming all the timers whose deadline has been reached.*/
+  vtp = ch.vtlist.root;
+  while ((vtp != NULL) && (vtp->deadline <= ch.vtlist.basetime)) {
+    vt_heap_remove(vtp);
+    _trace_vt(vtp);
+    fn = vtp->func;
+    vtp->func = NULL;
+    chSysUnlockFromISR();
+    fn(vtp->par);
+    chSysLockFromISR();
+    vtp = ch.vtlist.root;
+  }
+#else /* CH_CFG_ST_TIMEDELTA > 0 */
+  systime_t now;
+
+  /* Consuming all the timers whose deadline has been reached, the time
+     base is refreshed after each callback because time is flowing.*/
+  while (true) {
+    now = vt_update_basetime();
+    vtp = ch.vtlist.root;
+    if ((vtp == NULL) || (vtp->deadline > ch.vtlist.basetime)) {
+      break;
+    }
+
+    vt_heap_remove(vtp);
+    _trace_vt(vtp);
+    fn = vtp->func;
+    vtp->func = NULL;
+
+    /* If the heap becomes empty then the timer is stopped.*/
+    if (ch.vtlist.root == NULL) {
+      port_timer_stop_alarm();
+    }
+
+    /* The callback is invoked outside the kernel critical zone.*/
+    chSysUnlockFromISR();
+    fn(vtp->par);
+    chSysLockFromISR();
+  }
+
+  /* If the heap is empty, nothing else to do.*/
+  if (ch.vtlist.root == NULL) {
+    return;
+  }
+
+  /* Recalculating the next alarm time.*/
+  vt_set_alarm(now);
+#endif /* CH_CFG_ST_TIMEDELTA > 0 */
 }
+#endif /* CH_CFG_USE_TIMERS_HEAP == TRUE */
 
 /** @} */
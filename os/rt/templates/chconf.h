@@ -140,6 +140,32 @@
 #define CH_CFG_OPTIMIZE_SPEED               TRUE
 #endif
 
+/**
+ * @brief   Virtual timers heap.
+ * @details If enabled then the armed virtual timers are kept in a binary
+ *          min-heap instead of a delta list, set and reset operations
+ *          become O(log n) in the number of armed timers.
+ *
+ * @note    The default is @p FALSE. Enable this if many timers are
+ *          armed at the same time.
+ */
+#if !defined(CH_CFG_USE_TIMERS_HEAP)
+#define CH_CFG_USE_TIMERS_HEAP              FALSE
+#endif
+
+/**
+ * @brief   Ready list bitmap index.
+ * @details If enabled then the ready list is indexed by a bitmap of the
+ *          used priority levels, making threads insertion in the ready
+ *          list O(1) in the number of ready threads.
+ *
+ * @note    The default is @p FALSE. Enable this if many threads can be
+ *          ready at the same time.
+ */
+#if !defined(CH_CFG_USE_READY_BITMAP)
+#define CH_CFG_USE_READY_BITMAP             FALSE
+#endif
+
 /** @} */
 
 /*===========================================================================*/
@@ -204,6 +230,19 @@
 #define CH_CFG_USE_SEMAPHORES_PRIORITY      FALSE
 #endif
 
+/**
+ * @brief   Semaphores adaptive spinning.
+ * @details If greater than zero then threads waiting on semaphores poll
+ *          the counter, up to the specified number of iterations, before
+ *          sleeping.
+ *
+ * @note    The default is zero, spinning disabled.
+ * @note    Requires @p CH_CFG_USE_SEMAPHORES.
+ */
+#if !defined(CH_CFG_SEM_SPIN_COUNT)
+#define CH_CFG_SEM_SPIN_COUNT               0
+#endif
+
 /**
  * @brief   Mutexes APIs.
  * @details If enabled then the mutexes APIs are included in the kernel.
@@ -226,6 +265,19 @@
 #define CH_CFG_USE_MUTEXES_RECURSIVE        FALSE
 #endif
 
+/**
+ * @brief   Mutexes adaptive spinning.
+ * @details If greater than zero then threads locking owned mutexes poll
+ *          the mutex, up to the specified number of iterations, before
+ *          sleeping.
+ *
+ * @note    The default is zero, spinning disabled.
+ * @note    Requires @p CH_CFG_USE_MUTEXES.
+ */
+#if !defined(CH_CFG_MTX_SPIN_COUNT)
+#define CH_CFG_MTX_SPIN_COUNT               0
+#endif
+
 /**
  * @brief   Conditional Variables APIs.
  * @details If enabled then the conditional variables APIs are included
@@ -272,6 +324,31 @@
 #define CH_CFG_USE_EVENTS_TIMEOUT           TRUE
 #endif
 
+/**
+ * @brief   Event listeners index.
+ * @details If enabled then broadcasts only visit the listeners interested
+ *          in the broadcasted flags.
+ *
+ * @note    The default is @p FALSE. Enable this if event sources have
+ *          many listeners with different flags masks.
+ * @note    Requires @p CH_CFG_USE_EVENTS.
+ */
+#if !defined(CH_CFG_USE_EVENTS_INDEX)
+#define CH_CFG_USE_EVENTS_INDEX             FALSE
+#endif
+
+/**
+ * @brief   Deferred event broadcasts.
+ * @details If enabled then event sources can defer the signaling of
+ *          listeners to a thread, broadcasts from ISRs become O(1).
+ *
+ * @note    The default is @p FALSE.
+ * @note    Requires @p CH_CFG_USE_EVENTS.
+ */
+#if !defined(CH_CFG_USE_EVENTS_DEFERRED)
+#define CH_CFG_USE_EVENTS_DEFERRED          FALSE
+#endif
+
 /**
  * @brief   Synchronous Messages APIs.
  * @details If enabled then the synchronous messages APIs are included
@@ -370,6 +447,18 @@
 #define CH_CFG_USE_HEAP                     TRUE
 #endif
 
+/**
+ * @brief   TLSF heap allocator.
+ * @details If enabled then the memory heap uses a two-level segregated fit
+ *          allocator, allocation and release are O(1) operations.
+ *
+ * @note    The default is @p FALSE.
+ * @note    Requires @p CH_CFG_USE_HEAP.
+ */
+#if !defined(CH_CFG_USE_HEAP_TLSF)
+#define CH_CFG_USE_HEAP_TLSF                FALSE
+#endif
+
 /**
  * @brief   Memory Pools Allocator APIs.
  * @details If enabled then the memory pools allocator APIs are included
@@ -403,6 +492,18 @@
 #define CH_CFG_USE_PIPES                    TRUE
 #endif
 
+/**
+ * @brief   Single producer single consumer pipes.
+ * @details If enabled then pipes only support a single writer thread and
+ *          a single reader thread, data transfers do not require locking
+ *          and the zero-copy APIs are included in the kernel.
+ *
+ * @note    The default is @p FALSE.
+ */
+#if !defined(CH_CFG_PIPES_SPSC)
+#define CH_CFG_PIPES_SPSC                   FALSE
+#endif
+
 /**
  * @brief   Objects Caches APIs.
  * @details If enabled then the objects caches APIs are included
@@ -436,6 +537,17 @@
 #define CH_CFG_USE_JOBS                     TRUE
 #endif
 
+/**
+ * @brief   Jobs dispatchers priority lanes.
+ * @details Number of priority lanes in jobs dispatchers, lane zero has
+ *          the highest priority.
+ *
+ * @note    The default is 4.
+ */
+#if !defined(CH_CFG_JOBS_LANES)
+#define CH_CFG_JOBS_LANES                   4
+#endif
+
 /** @} */
 
 /*===========================================================================*/
@@ -0,0 +1,547 @@
+/*
+    ChibiOS - Copyright (C) 2006..2018 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+/**
+ * @file    blkqueue.c
+ * @brief   Block I/O requests queue code.
+ * @details Asynchronous requests are queued on top of a
+ *          @p BaseBlockDevice and served by a worker thread. The pending
+ *          requests are kept ordered by block number and served in
+ *          circular elevator order, adjacent requests of the same type
+ *          are merged in a single multi-block command, the data goes
+ *          through the staging buffer if the request buffers are not
+ *          contiguous in memory.
+ *          A request overlapping a pending write, or a write overlapping
+ *          any pending request, starts a new epoch, requests belonging to
+ *          different epochs are served in submission order. A sync
+ *          request is alone in its epoch so it acts as a barrier.
+ *
+ * @addtogroup blk_queue
+ * @{
+ */
+
+#include <string.h>
+
+#include "ch.h"
+#include "hal.h"
+#include "blkqueue.h"
+
+/*===========================================================================*/
+/* Module local definitions.                                                 */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Module exported variables.                                                */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Module local types.                                                       */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Module local variables.                                                   */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Module local functions.                                                   */
+/*===========================================================================*/
+
+/**
+ * @brief   Checks if a request conflicts with the requests of the last epoch.
+ *
+ * @param[in] bqp       pointer to the @p blkqueue_t object
+ * @param[in] rqp       pointer to the new request
+ * @return              The conflict status.
+ * @retval false        if the request can be reordered.
+ * @retval true         if the request must be served after the pending
+ *                      ones.
+ */
+static bool is_conflicting(blkqueue_t *bqp, const blkq_request_t *rqp) {
+  const blkq_request_t *p;
+
+  for (p = bqp->pending; p != NULL; p = p->next) {
+    if ((p->epoch == bqp->epoch) &&
+        ((p->op == BLKQ_OP_WRITE) || (rqp->op == BLKQ_OP_WRITE)) &&
+        (p->startblk < rqp->startblk + rqp->n) &&
+        (rqp->startblk < p->startblk + p->n)) {
+      return true;
+    }
+  }
+
+  return false;
+}
+
+/**
+ * @brief   Initializes a request and inserts it in the pending list.
+ */
+static void start_request(blkqueue_t *bqp, blkq_request_t *rqp, unsigned op,
+                          uint32_t startblk, uint8_t *buffer, uint32_t n,
+                          blkqcallback_t cb, void *arg) {
+  blkq_request_t **pp;
+
+  osalDbgCheck((bqp != NULL) && (rqp != NULL));
+
+  rqp->op       = op;
+  rqp->startblk = startblk;
+  rqp->n        = n;
+  rqp->buffer   = buffer;
+  rqp->cb       = cb;
+  rqp->arg      = arg;
+  rqp->done     = false;
+  rqp->result   = MSG_OK;
+  chThdQueueObjectInit(&rqp->waiting);
+
+  chMtxLock(&bqp->mtx);
+
+  osalDbgAssert(bqp->state == BLKQ_READY, "not ready");
+
+  if ((op == BLKQ_OP_SYNC) || is_conflicting(bqp, rqp)) {
+    bqp->epoch++;
+  }
+  rqp->epoch = bqp->epoch;
+
+  /* The requests of the last epoch are at the end of the list, the new
+     request is placed after those with a lower or equal block number.*/
+  pp = &bqp->pending;
+  while ((*pp != NULL) &&
+         (((*pp)->epoch != rqp->epoch) || ((*pp)->startblk <= startblk))) {
+    pp = &(*pp)->next;
+  }
+  rqp->next = *pp;
+  *pp = rqp;
+
+  /* Requests following a sync cannot be moved before it.*/
+  if (op == BLKQ_OP_SYNC) {
+    bqp->epoch++;
+  }
+
+  chCondSignal(&bqp->cond);
+  chMtxUnlock(&bqp->mtx);
+}
+
+/**
+ * @brief   Removes the next transfer from the pending list.
+ * @details The first request of the oldest epoch at or after the elevator
+ *          position is selected, or the lowest one if there is none, then
+ *          the following adjacent requests of the same type are appended.
+ *
+ * @param[in] bqp       pointer to the @p blkqueue_t object
+ * @param[out] np       total number of blocks in the transfer
+ * @return              The list of the requests in the transfer.
+ */
+static blkq_request_t *get_transfer(blkqueue_t *bqp, uint32_t *np) {
+  const blkq_config_t *config = bqp->config;
+  blkq_request_t **pp, **firstpp, *rqp, *last;
+  uint32_t epoch, n;
+  bool contiguous;
+
+  epoch = bqp->pending->epoch;
+  firstpp = &bqp->pending;
+  for (pp = &bqp->pending;
+       (*pp != NULL) && ((*pp)->epoch == epoch);
+       pp = &(*pp)->next) {
+    if ((*pp)->startblk >= bqp->head) {
+      firstpp = pp;
+      break;
+    }
+  }
+
+  rqp        = *firstpp;
+  last       = rqp;
+  n          = rqp->n;
+  contiguous = true;
+  if (rqp->op != BLKQ_OP_SYNC) {
+    while (last->next != NULL) {
+      blkq_request_t *p = last->next;
+
+      if ((p->epoch != epoch) || (p->op != rqp->op) ||
+          (p->startblk != rqp->startblk + n) ||
+          (n + p->n > BLKQ_CFG_MAX_BLOCKS)) {
+        break;
+      }
+
+      /* Non-contiguous buffers must fit the staging buffer.*/
+      if ((!contiguous ||
+           (p->buffer != rqp->buffer + ((size_t)n * bqp->blk_size))) &&
+          ((size_t)(n + p->n) * bqp->blk_size > config->size)) {
+        break;
+      }
+      contiguous = contiguous &&
+                   (p->buffer == rqp->buffer + ((size_t)n * bqp->blk_size));
+      n   += p->n;
+      last = p;
+    }
+  }
+
+  *firstpp   = last->next;
+  last->next = NULL;
+  *np        = n;
+
+  return rqp;
+}
+
+/**
+ * @brief   Executes a transfer and completes its requests.
+ *
+ * @param[in] bqp       pointer to the @p blkqueue_t object
+ * @param[in] rqp       list of the requests in the transfer
+ * @param[in] n         total number of blocks in the transfer
+ */
+static void serve_transfer(blkqueue_t *bqp, blkq_request_t *rqp, uint32_t n) {
+  BaseBlockDevice *bdp = bqp->config->bdp;
+  uint8_t *buffer = rqp->buffer;
+  blkq_request_t *p;
+  uint32_t count;
+  bool err;
+
+  /* Merged requests use the staging buffer unless their buffers are
+     contiguous.*/
+  for (p = rqp->next; p != NULL; p = p->next) {
+    if (p->buffer != rqp->buffer +
+                     ((size_t)(p->startblk - rqp->startblk) * bqp->blk_size)) {
+      buffer = bqp->config->buffer;
+      break;
+    }
+  }
+
+  switch (rqp->op) {
+  case BLKQ_OP_READ:
+    err = blkRead(bdp, rqp->startblk, buffer, n);
+    if (!err && (buffer != rqp->buffer)) {
+      for (p = rqp; p != NULL; p = p->next) {
+        memcpy(p->buffer,
+               buffer + ((size_t)(p->startblk - rqp->startblk) * bqp->blk_size),
+               (size_t)p->n * bqp->blk_size);
+      }
+    }
+    bqp->head = rqp->startblk + n;
+    break;
+  case BLKQ_OP_WRITE:
+    if (buffer != rqp->buffer) {
+      for (p = rqp; p != NULL; p = p->next) {
+        memcpy(buffer + ((size_t)(p->startblk - rqp->startblk) * bqp->blk_size),
+               p->buffer, (size_t)p->n * bqp->blk_size);
+      }
+    }
+    err = blkWrite(bdp, rqp->startblk, buffer, n);
+    bqp->head = rqp->startblk + n;
+    break;
+  default:
+    err = blkSync(bdp);
+    n   = 0U;
+    break;
+  }
+
+  count = 0U;
+  for (p = rqp; p != NULL; p = p->next) {
+    count++;
+  }
+
+  chMtxLock(&bqp->mtx);
+  bqp->stats.commands++;
+  bqp->stats.blocks   += n;
+  bqp->stats.requests += count;
+  if (err) {
+    bqp->stats.errors += count;
+  }
+  chMtxUnlock(&bqp->mtx);
+
+  /* Completion, the callback is invoked before the waiting threads are
+     awakened.*/
+  while (rqp != NULL) {
+    p = rqp->next;
+    rqp->result = err ? MSG_RESET : MSG_OK;
+    if (rqp->cb != NULL) {
+      rqp->cb(rqp);
+    }
+
+    chSysLock();
+    rqp->done = true;
+    chThdDequeueAllI(&rqp->waiting, rqp->result);
+    chEvtBroadcastFlagsI(&bqp->event,
+                         err ? BLKQ_REQUEST_FAILED : BLKQ_REQUEST_DONE);
+    chSchRescheduleS();
+    chSysUnlock();
+
+    rqp = p;
+  }
+}
+
+/**
+ * @brief   Worker thread.
+ * @details The thread serves the pending requests until the queue is
+ *          stopped and empty.
+ */
+static THD_FUNCTION(blkq_worker, arg) {
+  blkqueue_t *bqp = (blkqueue_t *)arg;
+
+  while (true) {
+    blkq_request_t *rqp;
+    uint32_t n;
+
+    chMtxLock(&bqp->mtx);
+    while ((bqp->pending == NULL) && (bqp->state == BLKQ_READY)) {
+      (void) chCondWait(&bqp->cond);
+    }
+    if (bqp->pending == NULL) {
+      chMtxUnlock(&bqp->mtx);
+      break;
+    }
+    rqp = get_transfer(bqp, &n);
+    chMtxUnlock(&bqp->mtx);
+
+    serve_transfer(bqp, rqp, n);
+  }
+}
+
+/*===========================================================================*/
+/* Module exported functions.                                                */
+/*===========================================================================*/
+
+/**
+ * @brief   Block queue object initialization.
+ *
+ * @param[out] bqp      pointer to the @p blkqueue_t object
+ *
+ * @init
+ */
+void blkqObjectInit(blkqueue_t *bqp) {
+
+  bqp->state   = BLKQ_STOP;
+  bqp->config  = NULL;
+  bqp->pending = NULL;
+  bqp->epoch   = 0U;
+  bqp->head    = 0U;
+  bqp->worker  = NULL;
+  chMtxObjectInit(&bqp->mtx);
+  chCondObjectInit(&bqp->cond);
+  chEvtObjectInit(&bqp->event);
+  bqp->stats.requests = 0U;
+  bqp->stats.commands = 0U;
+  bqp->stats.blocks   = 0U;
+  bqp->stats.errors   = 0U;
+}
+
+/**
+ * @brief   Starts a block queue.
+ * @details The worker thread is created.
+ *
+ * @param[in] bqp       pointer to the @p blkqueue_t object
+ * @param[in] config    pointer to the @p blkq_config_t structure
+ * @return              The operation status.
+ * @retval HAL_SUCCESS  if the queue has been started.
+ * @retval HAL_FAILED   if the device information is not available.
+ *
+ * @api
+ */
+bool blkqStart(blkqueue_t *bqp, const blkq_config_t *config) {
+  BlockDeviceInfo bdi;
+  thread_descriptor_t td;
+
+  osalDbgCheck((bqp != NULL) && (config != NULL) && (config->bdp != NULL) &&
+               ((config->buffer != NULL) || (config->size == 0U)));
+  osalDbgAssert(bqp->state == BLKQ_STOP, "invalid state");
+
+  if (blkGetInfo(config->bdp, &bdi) != HAL_SUCCESS) {
+    return HAL_FAILED;
+  }
+
+  bqp->config   = config;
+  bqp->blk_size = bdi.blk_size;
+  bqp->head     = 0U;
+  bqp->state    = BLKQ_READY;
+
+  td.name     = "blkq";
+  td.wbase    = (stkalign_t *)config->wsp;
+  td.wend     = (stkalign_t *)((uint8_t *)config->wsp + config->wsize);
+  td.prio     = config->prio;
+  td.funcp    = blkq_worker;
+  td.arg      = (void *)bqp;
+  bqp->worker = chThdCreate(&td);
+
+  return HAL_SUCCESS;
+}
+
+/**
+ * @brief   Stops a block queue.
+ * @details The pending requests are completed then the worker thread is
+ *          terminated.
+ *
+ * @param[in] bqp       pointer to the @p blkqueue_t object
+ *
+ * @api
+ */
+void blkqStop(blkqueue_t *bqp) {
+
+  osalDbgCheck(bqp != NULL);
+
+  chMtxLock(&bqp->mtx);
+  osalDbgAssert((bqp->state == BLKQ_STOP) || (bqp->state == BLKQ_READY),
+                "invalid state");
+  if (bqp->state == BLKQ_STOP) {
+    chMtxUnlock(&bqp->mtx);
+    return;
+  }
+  bqp->state = BLKQ_STOPPING;
+  chCondSignal(&bqp->cond);
+  chMtxUnlock(&bqp->mtx);
+
+  (void) chThdWait(bqp->worker);
+  bqp->worker = NULL;
+  bqp->state  = BLKQ_STOP;
+}
+
+/**
+ * @brief   Starts an asynchronous read.
+ * @note    The callback is invoked from the worker thread, the request
+ *          cannot be started again from within the callback.
+ *
+ * @param[in] bqp       pointer to the @p blkqueue_t object
+ * @param[out] rqp      pointer to the @p blkq_request_t object
+ * @param[in] startblk  first block to read
+ * @param[out] buffer   pointer to the read buffer
+ * @param[in] n         number of blocks to read
+ * @param[in] cb        completion callback or @p NULL
+ * @param[in] arg       callback argument
+ *
+ * @api
+ */
+void blkqStartRead(blkqueue_t *bqp, blkq_request_t *rqp, uint32_t startblk,
+                   uint8_t *buffer, uint32_t n,
+                   blkqcallback_t cb, void *arg) {
+
+  osalDbgCheck((buffer != NULL) && (n > 0U));
+
+  start_request(bqp, rqp, BLKQ_OP_READ, startblk, buffer, n, cb, arg);
+}
+
+/**
+ * @brief   Starts an asynchronous write.
+ * @note    The callback is invoked from the worker thread, the request
+ *          cannot be started again from within the callback.
+ *
+ * @param[in] bqp       pointer to the @p blkqueue_t object
+ * @param[out] rqp      pointer to the @p blkq_request_t object
+ * @param[in] startblk  first block to write
+ * @param[in] buffer    pointer to the data, it must not be modified until
+ *                      the request completion
+ * @param[in] n         number of blocks to write
+ * @param[in] cb        completion callback or @p NULL
+ * @param[in] arg       callback argument
+ *
+ * @api
+ */
+void blkqStartWrite(blkqueue_t *bqp, blkq_request_t *rqp, uint32_t startblk,
+                    const uint8_t *buffer, uint32_t n,
+                    blkqcallback_t cb, void *arg) {
+
+  osalDbgCheck((buffer != NULL) && (n > 0U));
+
+  start_request(bqp, rqp, BLKQ_OP_WRITE, startblk, (uint8_t *)buffer, n,
+                cb, arg);
+}
+
+/**
+ * @brief   Starts an asynchronous device synchronization.
+ * @details The request completes after all the previously started requests
+ *          and the device synchronization, the following requests are
+ *          served after it.
+ *
+ * @param[in] bqp       pointer to the @p blkqueue_t object
+ * @param[out] rqp      pointer to the @p blkq_request_t object
+ * @param[in] cb        completion callback or @p NULL
+ * @param[in] arg       callback argument
+ *
+ * @api
+ */
+void blkqStartSync(blkqueue_t *bqp, blkq_request_t *rqp,
+                   blkqcallback_t cb, void *arg) {
+
+  start_request(bqp, rqp, BLKQ_OP_SYNC, 0U, NULL, 0U, cb, arg);
+}
+
+/**
+ * @brief   Waits for a request completion.
+ *
+ * @param[in] rqp       pointer to a started @p blkq_request_t object
+ * @param[in] timeout   the number of ticks before the operation timeouts,
+ *                      the following special values are allowed:
+ *                      - @a TIME_IMMEDIATE immediate timeout.
+ *                      - @a TIME_INFINITE no timeout.
+ *                      .
+ * @return              The request result.
+ * @retval MSG_OK       if the request has been completed successfully.
+ * @retval MSG_TIMEOUT  if the request is still pending after the specified
+ *                      time.
+ * @retval MSG_RESET    if the device operation failed.
+ *
+ * @api
+ */
+msg_t blkqWaitTimeout(blkq_request_t *rqp, sysinterval_t timeout) {
+  msg_t msg;
+
+  osalDbgCheck(rqp != NULL);
+
+  chSysLock();
+  if (rqp->done) {
+    msg = rqp->result;
+  }
+  else {
+    msg = chThdEnqueueTimeoutS(&rqp->waiting, timeout);
+  }
+  chSysUnlock();
+
+  return msg;
+}
+
+/**
+ * @brief   Returns a copy of the queue statistics.
+ *
+ * @param[in] bqp       pointer to the @p blkqueue_t object
+ * @param[out] statsp   pointer to the @p blkq_stats_t structure receiving
+ *                      the statistics
+ *
+ * @api
+ */
+void blkqGetStats(blkqueue_t *bqp, blkq_stats_t *statsp) {
+
+  osalDbgCheck((bqp != NULL) && (statsp != NULL));
+
+  chMtxLock(&bqp->mtx);
+  *statsp = bqp->stats;
+  chMtxUnlock(&bqp->mtx);
+}
+
+/**
+ * @brief   Resets the queue statistics.
+ *
+ * @param[in] bqp       pointer to the @p blkqueue_t object
+ *
+ * @api
+ */
+void blkqResetStats(blkqueue_t *bqp) {
+
+  osalDbgCheck(bqp != NULL);
+
+  chMtxLock(&bqp->mtx);
+  bqp->stats.requests = 0U;
+  bqp->stats.commands = 0U;
+  bqp->stats.blocks   = 0U;
+  bqp->stats.errors   = 0U;
+  chMtxUnlock(&bqp->mtx);
+}
+
+/** @} */
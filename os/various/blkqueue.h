@@ -0,0 +1,321 @@
+/*
+    ChibiOS - Copyright (C) 2006..2018 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+/**
+ * @file    blkqueue.h
+ * @brief   Block I/O requests queue structures and macros.
+ *
+ * @addtogroup blk_queue
+ * @{
+ */
+
+#ifndef BLKQUEUE_H
+#define BLKQUEUE_H
+
+/*===========================================================================*/
+/* Module constants.                                                         */
+/*===========================================================================*/
+
+/**
+ * @name    Request operations
+ * @{
+ */
+#define BLKQ_OP_READ            0U  /**< @brief Blocks read.                */
+#define BLKQ_OP_WRITE           1U  /**< @brief Blocks write.               */
+#define BLKQ_OP_SYNC            2U  /**< @brief Device synchronization.     */
+/** @} */
+
+/**
+ * @name    Queue event flags
+ * @{
+ */
+#define BLKQ_REQUEST_DONE       (eventflags_t)1 /**< @brief Success.        */
+#define BLKQ_REQUEST_FAILED     (eventflags_t)2 /**< @brief Failure.        */
+/** @} */
+
+/*===========================================================================*/
+/* Module pre-compile time settings.                                         */
+/*===========================================================================*/
+
+/**
+ * @brief   Maximum number of blocks in a merged transfer.
+ * @details Requests are merged until this limit is reached, a larger
+ *          value reduces the number of device commands but increases the
+ *          latency of the requests waiting behind the transfer.
+ */
+#if !defined(BLKQ_CFG_MAX_BLOCKS) || defined(__DOXYGEN__)
+#define BLKQ_CFG_MAX_BLOCKS                 64U
+#endif
+
+/*===========================================================================*/
+/* Derived constants and error checks.                                       */
+/*===========================================================================*/
+
+#if BLKQ_CFG_MAX_BLOCKS < 1U
+#error "invalid BLKQ_CFG_MAX_BLOCKS value"
+#endif
+
+/*
+ * Module dependencies check.
+ */
+#if !CH_CFG_USE_MUTEXES || !CH_CFG_USE_CONDVARS || !CH_CFG_USE_EVENTS ||  \
+    !CH_CFG_USE_WAITEXIT
+#error "Block queues require mutexes, condvars, events and wait exit"
+#endif
+
+/*===========================================================================*/
+/* Module data structures and types.                                         */
+/*===========================================================================*/
+
+/**
+ * @brief   Queue state machine possible states.
+ */
+typedef enum {
+  BLKQ_UNINIT = 0,                  /**< Not initialized.                   */
+  BLKQ_STOP = 1,                    /**< Stopped.                           */
+  BLKQ_READY = 2,                   /**< Accepting requests.                */
+  BLKQ_STOPPING = 3                 /**< Completing the last requests.      */
+} blkqstate_t;
+
+/**
+ * @brief   Type of a block I/O request.
+ */
+typedef struct blkq_request blkq_request_t;
+
+/**
+ * @brief   Type of a request completion callback.
+ *
+ * @param[in] rqp       pointer to the completed @p blkq_request_t object
+ */
+typedef void (*blkqcallback_t)(blkq_request_t *rqp);
+
+/**
+ * @brief   Structure representing a block I/O request.
+ * @note    The fields are owned by the queue from the request start
+ *          until its completion.
+ */
+struct blkq_request {
+  /**
+   * @brief   Next request in the pending list.
+   */
+  blkq_request_t        *next;
+  /**
+   * @brief   Request operation.
+   */
+  unsigned              op;
+  /**
+   * @brief   First block.
+   */
+  uint32_t              startblk;
+  /**
+   * @brief   Number of blocks.
+   */
+  uint32_t              n;
+  /**
+   * @brief   Data buffer.
+   */
+  uint8_t               *buffer;
+  /**
+   * @brief   Completion callback or @p NULL.
+   */
+  blkqcallback_t        cb;
+  /**
+   * @brief   Callback argument.
+   */
+  void                  *arg;
+  /**
+   * @brief   Ordering epoch, requests of different epochs are not
+   *          reordered.
+   */
+  uint32_t              epoch;
+  /**
+   * @brief   Request completed.
+   */
+  bool                  done;
+  /**
+   * @brief   Request result, @p MSG_OK or @p MSG_RESET on failure.
+   */
+  msg_t                 result;
+  /**
+   * @brief   Threads waiting for completion.
+   */
+  threads_queue_t       waiting;
+};
+
+/**
+ * @brief   Type of a queue configuration structure.
+ */
+typedef struct {
+  /**
+   * @brief   Block device, it must be in the @p BLK_READY state.
+   */
+  BaseBlockDevice       *bdp;
+  /**
+   * @brief   Staging buffer for merging requests with non-contiguous
+   *          data buffers or @p NULL.
+   */
+  uint8_t               *buffer;
+  /**
+   * @brief   Size of the staging buffer.
+   */
+  size_t                size;
+  /**
+   * @brief   Working area of the worker thread.
+   */
+  void                  *wsp;
+  /**
+   * @brief   Size of the working area.
+   */
+  size_t                wsize;
+  /**
+   * @brief   Priority of the worker thread.
+   */
+  tprio_t               prio;
+} blkq_config_t;
+
+/**
+ * @brief   Type of the queue statistics.
+ */
+typedef struct {
+  /**
+   * @brief   Completed requests.
+   */
+  uint32_t              requests;
+  /**
+   * @brief   Device commands.
+   */
+  uint32_t              commands;
+  /**
+   * @brief   Transferred blocks.
+   */
+  uint32_t              blocks;
+  /**
+   * @brief   Failed requests.
+   */
+  uint32_t              errors;
+} blkq_stats_t;
+
+/**
+ * @brief   Structure representing a block I/O requests queue.
+ * @details Requests are served by a worker thread in elevator order,
+ *          adjacent requests of the same type are merged in a single
+ *          multi-block device command.
+ */
+typedef struct {
+  /**
+   * @brief   Queue state.
+   */
+  blkqstate_t           state;
+  /**
+   * @brief   Current configuration.
+   */
+  const blkq_config_t   *config;
+  /**
+   * @brief   Device block size.
+   */
+  uint32_t              blk_size;
+  /**
+   * @brief   Pending list mutex.
+   */
+  mutex_t               mtx;
+  /**
+   * @brief   Worker thread wake up condition.
+   */
+  condition_variable_t  cond;
+  /**
+   * @brief   Pending requests ordered by epoch and block.
+   */
+  blkq_request_t        *pending;
+  /**
+   * @brief   Epoch of the last queued request.
+   */
+  uint32_t              epoch;
+  /**
+   * @brief   Elevator position.
+   */
+  uint32_t              head;
+  /**
+   * @brief   Worker thread.
+   */
+  thread_t              *worker;
+  /**
+   * @brief   Completion events source.
+   */
+  event_source_t        event;
+  /**
+   * @brief   Statistics.
+   */
+  blkq_stats_t          stats;
+} blkqueue_t;
+
+/*===========================================================================*/
+/* Module macros.                                                            */
+/*===========================================================================*/
+
+/**
+ * @brief   Returns the completion events source of a queue.
+ *
+ * @param[in] bqp       pointer to the @p blkqueue_t object
+ * @return              Pointer to the @p event_source_t object.
+ *
+ * @special
+ */
+#define blkqGetEventSource(bqp) (&(bqp)->event)
+
+/**
+ * @brief   Determines if a request has been completed.
+ *
+ * @param[in] rqp       pointer to the @p blkq_request_t object
+ * @return              The request state.
+ * @retval false        if the request is pending.
+ * @retval true         if the request has been completed.
+ *
+ * @iclass
+ */
+#define blkqIsRequestDoneI(rqp) ((rqp)->done)
+
+/*===========================================================================*/
+/* External declarations.                                                    */
+/*===========================================================================*/
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+  void blkqObjectInit(blkqueue_t *bqp);
+  bool blkqStart(blkqueue_t *bqp, const blkq_config_t *config);
+  void blkqStop(blkqueue_t *bqp);
+  void blkqStartRead(blkqueue_t *bqp, blkq_request_t *rqp, uint32_t startblk,
+                     uint8_t *buffer, uint32_t n,
+                     blkqcallback_t cb, void *arg);
+  void blkqStartWrite(blkqueue_t *bqp, blkq_request_t *rqp, uint32_t startblk,
+                      const uint8_t *buffer, uint32_t n,
+                      blkqcallback_t cb, void *arg);
+  void blkqStartSync(blkqueue_t *bqp, blkq_request_t *rqp,
+                     blkqcallback_t cb, void *arg);
+  msg_t blkqWaitTimeout(blkq_request_t *rqp, sysinterval_t timeout);
+  void blkqGetStats(blkqueue_t *bqp, blkq_stats_t *statsp);
+  void blkqResetStats(blkqueue_t *bqp);
+#ifdef __cplusplus
+}
+#endif
+
+/*===========================================================================*/
+/* Module inline functions.                                                  */
+/*===========================================================================*/
+
+#endif /* BLKQUEUE_H */
+
+/** @} */
@@ -0,0 +1,624 @@
+/*
+    ChibiOS - Copyright (C) 2006..2018 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+/**
+ * @file    candispatch.c
+ * @brief   CAN receive dispatcher code.
+ * @details Received frames are routed to per-subscription objects FIFOs so
+ *          that each consumer thread only wakes up for the frames it is
+ *          interested in. Frames are dispatched either by a dedicated
+ *          thread listening to the driver receive event or directly from
+ *          the driver receive callback.
+ *          Subscriptions matching a single frame key are kept in an hash
+ *          table, subscriptions with a partial mask are kept in a list
+ *          scanned for each frame. The subscriptions can be compiled in a
+ *          limited number of acceptance filters for the hardware filter
+ *          banks, frames not interesting any subscription are then
+ *          discarded before reaching the dispatcher.
+ *
+ * @addtogroup can_dispatch
+ * @{
+ */
+
+#include "ch.h"
+#include "hal.h"
+#include "candispatch.h"
+
+/*===========================================================================*/
+/* Module local definitions.                                                 */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Module exported variables.                                                */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Module local types.                                                       */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Module local variables.                                                   */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Module local functions.                                                   */
+/*===========================================================================*/
+
+/**
+ * @brief   Returns the key of a received frame.
+ *
+ * @param[in] crfp      pointer to the frame
+ * @return              The frame key.
+ */
+static uint32_t frame_key(const CANRxFrame *crfp) {
+  uint32_t key;
+
+  if (crfp->IDE != 0U) {
+    key = ((uint32_t)crfp->EID & CANDISP_EID_MASK) | CANDISP_IDE;
+  }
+  else {
+    key = (uint32_t)crfp->SID;
+  }
+  if (crfp->RTR != 0U) {
+    key |= CANDISP_RTR;
+  }
+
+  return key;
+}
+
+/**
+ * @brief   Returns the hash table bucket of a frame key.
+ *
+ * @param[in] key       the frame key
+ * @return              The bucket index.
+ */
+static unsigned key_hash(uint32_t key) {
+
+  key ^= (key >> 16) ^ (key >> 8);
+
+  return (unsigned)(key & (CANDISP_CFG_HASH_SIZE - 1U));
+}
+
+/**
+ * @brief   Returns the number of bits set in a mask.
+ *
+ * @param[in] mask      the mask
+ * @return              The number of bits set.
+ */
+static unsigned mask_bits(uint32_t mask) {
+  unsigned n = 0U;
+
+  while (mask != 0U) {
+    mask &= mask - 1U;
+    n++;
+  }
+
+  return n;
+}
+
+/**
+ * @brief   Returns the list containing a subscription.
+ *
+ * @param[in] cdp       pointer to the @p can_dispatcher_t object
+ * @param[in] sp        pointer to the subscription
+ * @return              Pointer to the list head.
+ */
+static candisp_subscription_t **get_list(can_dispatcher_t *cdp,
+                                         const candisp_subscription_t *sp) {
+
+  if (sp->mask == CANDISP_EXACT) {
+    return &cdp->buckets[key_hash(sp->id)];
+  }
+
+  return &cdp->masked;
+}
+
+/**
+ * @brief   Copies a frame in a subscription FIFO.
+ *
+ * @param[in] cdp       pointer to the @p can_dispatcher_t object
+ * @param[in] sp        pointer to the subscription
+ * @param[in] crfp      pointer to the frame
+ */
+static void deliver(can_dispatcher_t *cdp, candisp_subscription_t *sp,
+                    const CANRxFrame *crfp) {
+  candisp_frame_t *fp;
+
+  fp = (candisp_frame_t *)chFifoTakeObjectI(&sp->fifo);
+  if (fp == NULL) {
+    sp->overflows++;
+    cdp->stats.dropped++;
+    return;
+  }
+  fp->frame = *crfp;
+  chFifoSendObjectI(&sp->fifo, (void *)fp);
+  sp->frames++;
+}
+
+/**
+ * @brief   Returns the mask of a filter accepting the frames of two filters.
+ *
+ * @param[in] id1       first filter identifier
+ * @param[in] mask1     first filter mask
+ * @param[in] id2       second filter identifier
+ * @param[in] mask2     second filter mask
+ * @return              The merged filter mask.
+ */
+static uint32_t merge_mask(uint32_t id1, uint32_t mask1,
+                           uint32_t id2, uint32_t mask2) {
+
+  return mask1 & mask2 & ~(id1 ^ id2);
+}
+
+/**
+ * @brief   Adds a subscription to a filters set.
+ * @details If no filter accepts the subscription frames then a new filter
+ *          is added. If the set is full then the two filters, possibly
+ *          including the new one, losing the least mask bits when merged
+ *          are replaced by their merge.
+ *
+ * @param[in,out] fp    pointer to the filters array
+ * @param[in] n         number of filters in the set
+ * @param[in] max       size of the filters array
+ * @param[in] sp        pointer to the subscription
+ * @return              The new number of filters in the set.
+ */
+static uint32_t add_filter(candisp_filter_t *fp, uint32_t n, uint32_t max,
+                           const candisp_subscription_t *sp) {
+  uint32_t i, j, bi, bj, m;
+  unsigned bits, best_bits;
+
+  /* Already accepted by a filter.*/
+  for (i = 0U; i < n; i++) {
+    if (((fp[i].mask & ~sp->mask) == 0U) &&
+        (((fp[i].id ^ sp->id) & fp[i].mask) == 0U)) {
+      return n;
+    }
+  }
+
+  /* Free filter.*/
+  if (n < max) {
+    fp[n].id   = sp->id;
+    fp[n].mask = sp->mask;
+    return n + 1U;
+  }
+
+  /* Searching the closest pair, the index n represents the new filter.*/
+  bi        = 0U;
+  bj        = n;
+  best_bits = 0U;
+  for (i = 0U; i < n; i++) {
+    for (j = i + 1U; j <= n; j++) {
+      if (j < n) {
+        m = merge_mask(fp[i].id, fp[i].mask, fp[j].id, fp[j].mask);
+      }
+      else {
+        m = merge_mask(fp[i].id, fp[i].mask, sp->id, sp->mask);
+      }
+      bits = mask_bits(m);
+      if (bits > best_bits) {
+        bi        = i;
+        bj        = j;
+        best_bits = bits;
+      }
+    }
+  }
+
+  /* Merging the pair, the new filter takes the freed slot if it is not
+     part of the pair.*/
+  if (bj < n) {
+    fp[bi].mask = merge_mask(fp[bi].id, fp[bi].mask, fp[bj].id, fp[bj].mask);
+    fp[bj].id   = sp->id;
+    fp[bj].mask = sp->mask;
+  }
+  else {
+    fp[bi].mask = merge_mask(fp[bi].id, fp[bi].mask, sp->id, sp->mask);
+  }
+  fp[bi].id &= fp[bi].mask;
+
+  return n;
+}
+
+/**
+ * @brief   Dispatcher thread.
+ * @details The thread drains the driver receive mailboxes each time the
+ *          receive event is broadcast, one frame at time in order to
+ *          keep the critical zones short.
+ */
+#if (CAN_ENFORCE_USE_CALLBACKS == FALSE) || defined(__DOXYGEN__)
+static THD_FUNCTION(candisp_thread, arg) {
+  can_dispatcher_t *cdp = (can_dispatcher_t *)arg;
+  CANDriver *canp = cdp->config->canp;
+  event_listener_t el;
+
+  chEvtRegisterMask(&canp->rxfull_event, &el, EVENT_MASK(0));
+  while (!chThdShouldTerminateX()) {
+    while (true) {
+      CANRxFrame frame;
+
+      chSysLock();
+      if (canTryReceiveI(canp, CAN_ANY_MAILBOX, &frame)) {
+        chSysUnlock();
+        break;
+      }
+      candispDispatchI(cdp, &frame);
+      chSchRescheduleS();
+      chSysUnlock();
+    }
+    (void) chEvtWaitAny(ALL_EVENTS);
+  }
+  chEvtUnregister(&canp->rxfull_event, &el);
+}
+#endif
+
+/*===========================================================================*/
+/* Module exported functions.                                                */
+/*===========================================================================*/
+
+/**
+ * @brief   CAN dispatcher object initialization.
+ *
+ * @param[out] cdp      pointer to the @p can_dispatcher_t object
+ *
+ * @init
+ */
+void candispObjectInit(can_dispatcher_t *cdp) {
+  unsigned i;
+
+  cdp->state  = CANDISP_STOP;
+  cdp->config = NULL;
+  chMtxObjectInit(&cdp->mtx);
+  for (i = 0U; i < CANDISP_CFG_HASH_SIZE; i++) {
+    cdp->buckets[i] = NULL;
+  }
+  cdp->masked = NULL;
+  cdp->count  = 0U;
+  cdp->thread = NULL;
+  cdp->stats.frames    = 0U;
+  cdp->stats.unmatched = 0U;
+  cdp->stats.dropped   = 0U;
+}
+
+/**
+ * @brief   Starts a CAN dispatcher.
+ * @details If a working area is specified then the dispatcher thread is
+ *          created, the thread serves the frames received by the driver.
+ * @note    The dispatcher thread requires the driver events, it is not
+ *          available if @p CAN_ENFORCE_USE_CALLBACKS is @p TRUE.
+ *
+ * @param[in] cdp       pointer to the @p can_dispatcher_t object
+ * @param[in] config    pointer to the @p candisp_config_t structure
+ *
+ * @api
+ */
+void candispStart(can_dispatcher_t *cdp, const candisp_config_t *config) {
+
+  osalDbgCheck((cdp != NULL) && (config != NULL) && (config->canp != NULL));
+  osalDbgAssert(cdp->state == CANDISP_STOP, "invalid state");
+
+  cdp->config = config;
+  cdp->state  = CANDISP_READY;
+
+  if (config->wsp != NULL) {
+#if CAN_ENFORCE_USE_CALLBACKS == FALSE
+    thread_descriptor_t td;
+
+    td.name     = "candisp";
+    td.wbase    = (stkalign_t *)config->wsp;
+    td.wend     = (stkalign_t *)((uint8_t *)config->wsp + config->wsize);
+    td.prio     = config->prio;
+    td.funcp    = candisp_thread;
+    td.arg      = (void *)cdp;
+    cdp->thread = chThdCreate(&td);
+#else
+    osalDbgAssert(false, "thread mode not supported");
+#endif
+  }
+}
+
+/**
+ * @brief   Stops a CAN dispatcher.
+ * @details The dispatcher thread, if any, is terminated. The subscriptions
+ *          are retained.
+ *
+ * @param[in] cdp       pointer to the @p can_dispatcher_t object
+ *
+ * @api
+ */
+void candispStop(can_dispatcher_t *cdp) {
+
+  osalDbgCheck(cdp != NULL);
+  osalDbgAssert((cdp->state == CANDISP_STOP) || (cdp->state == CANDISP_READY),
+                "invalid state");
+
+  if (cdp->thread != NULL) {
+    chThdTerminate(cdp->thread);
+    chEvtSignal(cdp->thread, EVENT_MASK(1));
+    (void) chThdWait(cdp->thread);
+    cdp->thread = NULL;
+  }
+
+  chSysLock();
+  cdp->state = CANDISP_STOP;
+  chSysUnlock();
+}
+
+/**
+ * @brief   Subscription object initialization.
+ * @details A frame matches the subscription if the bits selected by the
+ *          mask are equal in the frame key and in the identifier, the
+ *          @p CANDISP_EXACT mask selects a single frame key.
+ *
+ * @param[out] sp       pointer to the @p candisp_subscription_t object
+ * @param[in] id        subscription identifier, see @p CANDISP_STD() and
+ *                      @p CANDISP_EXT()
+ * @param[in] mask      subscription mask
+ * @param[in] frames    pointer to an array of @p n frame slots
+ * @param[in] msgs      pointer to an array of @p n messages
+ * @param[in] n         size of the subscription FIFO
+ *
+ * @init
+ */
+void candispSubscriptionObjectInit(candisp_subscription_t *sp,
+                                   uint32_t id, uint32_t mask,
+                                   candisp_frame_t *frames, msg_t *msgs,
+                                   size_t n) {
+
+  osalDbgCheck((sp != NULL) && (frames != NULL) && (msgs != NULL) &&
+               (n > 0U) && ((mask & ~CANDISP_EXACT) == 0U));
+
+  sp->next      = NULL;
+  sp->id        = id & mask;
+  sp->mask      = mask;
+  sp->frames    = 0U;
+  sp->overflows = 0U;
+  chFifoObjectInit(&sp->fifo, sizeof (candisp_frame_t), n,
+                   (void *)frames, msgs);
+}
+
+/**
+ * @brief   Adds a subscription to a dispatcher.
+ * @note    A frame matching several subscriptions is copied in all of them.
+ *
+ * @param[in] cdp       pointer to the @p can_dispatcher_t object
+ * @param[in] sp        pointer to the @p candisp_subscription_t object
+ *
+ * @api
+ */
+void candispSubscribe(can_dispatcher_t *cdp, candisp_subscription_t *sp) {
+  candisp_subscription_t **lpp;
+
+  osalDbgCheck((cdp != NULL) && (sp != NULL));
+
+  chMtxLock(&cdp->mtx);
+  lpp = get_list(cdp, sp);
+  chSysLock();
+  sp->next = *lpp;
+  *lpp = sp;
+  cdp->count++;
+  chSysUnlock();
+  chMtxUnlock(&cdp->mtx);
+}
+
+/**
+ * @brief   Removes a subscription from a dispatcher.
+ * @note    The frames already in the subscription FIFO can still be
+ *          received.
+ *
+ * @param[in] cdp       pointer to the @p can_dispatcher_t object
+ * @param[in] sp        pointer to the @p candisp_subscription_t object
+ *
+ * @api
+ */
+void candispUnsubscribe(can_dispatcher_t *cdp, candisp_subscription_t *sp) {
+  candisp_subscription_t **lpp;
+
+  osalDbgCheck((cdp != NULL) && (sp != NULL));
+
+  chMtxLock(&cdp->mtx);
+  lpp = get_list(cdp, sp);
+  while ((*lpp != NULL) && (*lpp != sp)) {
+    lpp = &(*lpp)->next;
+  }
+  osalDbgAssert(*lpp != NULL, "not subscribed");
+  chSysLock();
+  *lpp = sp->next;
+  sp->next = NULL;
+  cdp->count--;
+  chSysUnlock();
+  chMtxUnlock(&cdp->mtx);
+}
+
+/**
+ * @brief   Receives a frame from a subscription.
+ *
+ * @param[in] sp        pointer to the @p candisp_subscription_t object
+ * @param[out] crfp     pointer to the buffer where the frame is copied
+ * @param[in] timeout   the number of ticks before the operation timeouts,
+ *                      the following special values are allowed:
+ *                      - @a TIME_IMMEDIATE immediate timeout.
+ *                      - @a TIME_INFINITE no timeout.
+ *                      .
+ * @return              The operation result.
+ * @retval MSG_OK       if a frame has been received.
+ * @retval MSG_TIMEOUT  if no frame has been received within the specified
+ *                      timeout.
+ *
+ * @api
+ */
+msg_t candispReceiveTimeout(candisp_subscription_t *sp, CANRxFrame *crfp,
+                            sysinterval_t timeout) {
+  candisp_frame_t *fp;
+  msg_t msg;
+
+  osalDbgCheck((sp != NULL) && (crfp != NULL));
+
+  msg = chFifoReceiveObjectTimeout(&sp->fifo, (void **)&fp, timeout);
+  if (msg == MSG_OK) {
+    *crfp = fp->frame;
+    chFifoReturnObject(&sp->fifo, (void *)fp);
+  }
+
+  return msg;
+}
+
+/**
+ * @brief   Dispatches a frame.
+ * @details The frame is copied in the FIFOs of all the matching
+ *          subscriptions.
+ *
+ * @param[in] cdp       pointer to the @p can_dispatcher_t object
+ * @param[in] crfp      pointer to the frame
+ *
+ * @iclass
+ */
+void candispDispatchI(can_dispatcher_t *cdp, const CANRxFrame *crfp) {
+  candisp_subscription_t *sp;
+  uint32_t key;
+  bool matched;
+
+  chDbgCheckClassI();
+  osalDbgCheck((cdp != NULL) && (crfp != NULL));
+
+  if (cdp->state != CANDISP_READY) {
+    return;
+  }
+
+  key = frame_key(crfp);
+  matched = false;
+  cdp->stats.frames++;
+
+  for (sp = cdp->buckets[key_hash(key)]; sp != NULL; sp = sp->next) {
+    if (sp->id == key) {
+      deliver(cdp, sp, crfp);
+      matched = true;
+    }
+  }
+  for (sp = cdp->masked; sp != NULL; sp = sp->next) {
+    if (((key ^ sp->id) & sp->mask) == 0U) {
+      deliver(cdp, sp, crfp);
+      matched = true;
+    }
+  }
+
+  if (!matched) {
+    cdp->stats.unmatched++;
+  }
+}
+
+/**
+ * @brief   Dispatches all the frames received by the driver.
+ * @note    This function is meant to be invoked from the driver receive
+ *          callback when the dispatcher has no thread.
+ *
+ * @param[in] cdp       pointer to the @p can_dispatcher_t object
+ *
+ * @iclass
+ */
+void candispServeI(can_dispatcher_t *cdp) {
+  CANRxFrame frame;
+
+  chDbgCheckClassI();
+  osalDbgCheck(cdp != NULL);
+
+  if (cdp->state != CANDISP_READY) {
+    return;
+  }
+
+  while (!canTryReceiveI(cdp->config->canp, CAN_ANY_MAILBOX, &frame)) {
+    candispDispatchI(cdp, &frame);
+  }
+}
+
+/**
+ * @brief   Compiles the subscriptions in a set of acceptance filters.
+ * @details The returned filters accept at least all the frames matching
+ *          the subscriptions, if there are more subscriptions than filters
+ *          then some filters are widened and some unwanted frames are
+ *          accepted too, those are discarded by the dispatcher.
+ * @note    The filters are meant to be converted by the application in
+ *          the format of the hardware filter banks.
+ * @note    The compilation is greedy, the result depends on the order of
+ *          the subscriptions and is not guaranteed to be optimal.
+ *
+ * @param[in] cdp       pointer to the @p can_dispatcher_t object
+ * @param[out] fp       pointer to an array of @p n filters
+ * @param[in] n         maximum number of filters, must be at least one
+ * @return              The number of filters written in the array, zero if
+ *                      there are no subscriptions.
+ *
+ * @api
+ */
+uint32_t candispGetFilters(can_dispatcher_t *cdp,
+                           candisp_filter_t *fp, uint32_t n) {
+  const candisp_subscription_t *sp;
+  uint32_t nf;
+  unsigned i;
+
+  osalDbgCheck((cdp != NULL) && (fp != NULL) && (n > 0U));
+
+  chMtxLock(&cdp->mtx);
+  nf = 0U;
+  for (i = 0U; i < CANDISP_CFG_HASH_SIZE; i++) {
+    for (sp = cdp->buckets[i]; sp != NULL; sp = sp->next) {
+      nf = add_filter(fp, nf, n, sp);
+    }
+  }
+  for (sp = cdp->masked; sp != NULL; sp = sp->next) {
+    nf = add_filter(fp, nf, n, sp);
+  }
+  chMtxUnlock(&cdp->mtx);
+
+  return nf;
+}
+
+/**
+ * @brief   Returns a copy of the dispatcher statistics.
+ *
+ * @param[in] cdp       pointer to the @p can_dispatcher_t object
+ * @param[out] statsp   pointer to the @p candisp_stats_t structure
+ *                      receiving the statistics
+ *
+ * @api
+ */
+void candispGetStats(can_dispatcher_t *cdp, candisp_stats_t *statsp) {
+
+  osalDbgCheck((cdp != NULL) && (statsp != NULL));
+
+  chSysLock();
+  *statsp = cdp->stats;
+  chSysUnlock();
+}
+
+/**
+ * @brief   Resets the dispatcher statistics.
+ *
+ * @param[in] cdp       pointer to the @p can_dispatcher_t object
+ *
+ * @api
+ */
+void candispResetStats(can_dispatcher_t *cdp) {
+
+  osalDbgCheck(cdp != NULL);
+
+  chSysLock();
+  cdp->stats.frames    = 0U;
+  cdp->stats.unmatched = 0U;
+  cdp->stats.dropped   = 0U;
+  chSysUnlock();
+}
+
+/** @} */
@@ -0,0 +1,301 @@
+/*
+    ChibiOS - Copyright (C) 2006..2018 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+/**
+ * @file    candispatch.h
+ * @brief   CAN receive dispatcher structures and macros.
+ *
+ * @addtogroup can_dispatch
+ * @{
+ */
+
+#ifndef CANDISPATCH_H
+#define CANDISPATCH_H
+
+/*===========================================================================*/
+/* Module constants.                                                         */
+/*===========================================================================*/
+
+/**
+ * @name    Frame key layout
+ * @details Frames are matched using a key composed of the right aligned
+ *          identifier and of two flags representing the frame type.
+ * @{
+ */
+#define CANDISP_IDE             (1U << 29)  /**< @brief Extended frame.     */
+#define CANDISP_RTR             (1U << 30)  /**< @brief Remote frame.       */
+#define CANDISP_EID_MASK        0x1FFFFFFFU /**< @brief Identifier bits.    */
+/** @} */
+
+/**
+ * @brief   Mask of a subscription matching a single frame key.
+ */
+#define CANDISP_EXACT           (CANDISP_EID_MASK | CANDISP_IDE | CANDISP_RTR)
+
+/*===========================================================================*/
+/* Module pre-compile time settings.                                         */
+/*===========================================================================*/
+
+/**
+ * @brief   Number of buckets of the exact subscriptions hash table.
+ * @note    Must be a power of two.
+ */
+#if !defined(CANDISP_CFG_HASH_SIZE) || defined(__DOXYGEN__)
+#define CANDISP_CFG_HASH_SIZE               16U
+#endif
+
+/*===========================================================================*/
+/* Derived constants and error checks.                                       */
+/*===========================================================================*/
+
+#if (CANDISP_CFG_HASH_SIZE < 1U) ||                                         \
+    ((CANDISP_CFG_HASH_SIZE & (CANDISP_CFG_HASH_SIZE - 1U)) != 0U)
+#error "CANDISP_CFG_HASH_SIZE must be a power of two"
+#endif
+
+/*
+ * Module dependencies check.
+ */
+#if !HAL_USE_CAN || !CH_CFG_USE_OBJ_FIFOS || !CH_CFG_USE_MUTEXES ||         \
+    !CH_CFG_USE_EVENTS || !CH_CFG_USE_WAITEXIT
+#error "CAN dispatcher requires CAN, objects FIFOs, mutexes, events, wait exit"
+#endif
+
+/*===========================================================================*/
+/* Module data structures and types.                                         */
+/*===========================================================================*/
+
+/**
+ * @brief   Dispatcher state machine possible states.
+ */
+typedef enum {
+  CANDISP_UNINIT = 0,               /**< Not initialized.                   */
+  CANDISP_STOP = 1,                 /**< Stopped.                           */
+  CANDISP_READY = 2                 /**< Dispatching frames.                */
+} candispstate_t;
+
+/**
+ * @brief   Type of a frame slot in a subscription FIFO.
+ * @note    The union makes the slot size compatible with the objects FIFO
+ *          alignment requirements.
+ */
+typedef union {
+  CANRxFrame            frame;
+  void                  *align;
+} candisp_frame_t;
+
+/**
+ * @brief   Type of an acceptance filter.
+ * @details A frame passes the filter if the bits selected by the mask are
+ *          equal in the frame key and in the filter identifier.
+ */
+typedef struct {
+  /**
+   * @brief   Filter identifier.
+   */
+  uint32_t              id;
+  /**
+   * @brief   Filter mask.
+   */
+  uint32_t              mask;
+} candisp_filter_t;
+
+/**
+ * @brief   Type of a subscription.
+ */
+typedef struct candisp_subscription candisp_subscription_t;
+
+/**
+ * @brief   Structure representing a subscription.
+ * @details Matching frames are copied in the subscription objects FIFO,
+ *          frames not fitting in the FIFO are lost and counted.
+ */
+struct candisp_subscription {
+  /**
+   * @brief   Next subscription in the same list.
+   */
+  candisp_subscription_t *next;
+  /**
+   * @brief   Subscription identifier.
+   */
+  uint32_t              id;
+  /**
+   * @brief   Subscription mask.
+   */
+  uint32_t              mask;
+  /**
+   * @brief   Received frames FIFO.
+   */
+  objects_fifo_t        fifo;
+  /**
+   * @brief   Delivered frames.
+   */
+  uint32_t              frames;
+  /**
+   * @brief   Frames lost because the FIFO was full.
+   */
+  uint32_t              overflows;
+};
+
+/**
+ * @brief   Type of a dispatcher configuration structure.
+ */
+typedef struct {
+  /**
+   * @brief   CAN driver, it must be started by the application.
+   */
+  CANDriver             *canp;
+  /**
+   * @brief   Working area of the dispatcher thread or @p NULL.
+   * @details If @p NULL then no thread is created and the application
+   *          must invoke @p candispServeI() when frames are received,
+   *          usually from the driver receive callback.
+   */
+  void                  *wsp;
+  /**
+   * @brief   Size of the working area.
+   */
+  size_t                wsize;
+  /**
+   * @brief   Priority of the dispatcher thread.
+   * @note    It should be higher than the priority of the consumers.
+   */
+  tprio_t               prio;
+} candisp_config_t;
+
+/**
+ * @brief   Type of the dispatcher statistics.
+ */
+typedef struct {
+  /**
+   * @brief   Dispatched frames.
+   */
+  uint32_t              frames;
+  /**
+   * @brief   Frames not matching any subscription.
+   */
+  uint32_t              unmatched;
+  /**
+   * @brief   Deliveries lost because of full subscription FIFOs.
+   */
+  uint32_t              dropped;
+} candisp_stats_t;
+
+/**
+ * @brief   Structure representing a CAN receive dispatcher.
+ * @details Received frames are routed to the matching subscriptions,
+ *          exact subscriptions are found through an hash table, masked
+ *          subscriptions are scanned linearly.
+ */
+typedef struct {
+  /**
+   * @brief   Dispatcher state.
+   */
+  candispstate_t        state;
+  /**
+   * @brief   Current configuration.
+   */
+  const candisp_config_t *config;
+  /**
+   * @brief   Subscriptions changes mutex.
+   */
+  mutex_t               mtx;
+  /**
+   * @brief   Exact subscriptions hash table.
+   */
+  candisp_subscription_t *buckets[CANDISP_CFG_HASH_SIZE];
+  /**
+   * @brief   Masked subscriptions list.
+   */
+  candisp_subscription_t *masked;
+  /**
+   * @brief   Number of subscriptions.
+   */
+  uint32_t              count;
+  /**
+   * @brief   Dispatcher thread or @p NULL.
+   */
+  thread_t              *thread;
+  /**
+   * @brief   Statistics.
+   */
+  candisp_stats_t       stats;
+} can_dispatcher_t;
+
+/*===========================================================================*/
+/* Module macros.                                                            */
+/*===========================================================================*/
+
+/**
+ * @brief   Key of a standard data frame.
+ *
+ * @param[in] sid       standard identifier
+ */
+#define CANDISP_STD(sid)        ((uint32_t)(sid) & 0x7FFU)
+
+/**
+ * @brief   Key of an extended data frame.
+ *
+ * @param[in] eid       extended identifier
+ */
+#define CANDISP_EXT(eid)        (((uint32_t)(eid) & CANDISP_EID_MASK) |     \
+                                 CANDISP_IDE)
+
+/**
+ * @brief   Returns the number of subscriptions.
+ *
+ * @param[in] cdp       pointer to the @p can_dispatcher_t object
+ * @return              The number of subscriptions.
+ *
+ * @special
+ */
+#define candispGetSubscriptionsX(cdp) ((cdp)->count)
+
+/*===========================================================================*/
+/* External declarations.                                                    */
+/*===========================================================================*/
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+  void candispObjectInit(can_dispatcher_t *cdp);
+  void candispStart(can_dispatcher_t *cdp, const candisp_config_t *config);
+  void candispStop(can_dispatcher_t *cdp);
+  void candispSubscriptionObjectInit(candisp_subscription_t *sp,
+                                     uint32_t id, uint32_t mask,
+                                     candisp_frame_t *frames, msg_t *msgs,
+                                     size_t n);
+  void candispSubscribe(can_dispatcher_t *cdp, candisp_subscription_t *sp);
+  void candispUnsubscribe(can_dispatcher_t *cdp, candisp_subscription_t *sp);
+  msg_t candispReceiveTimeout(candisp_subscription_t *sp, CANRxFrame *crfp,
+                              sysinterval_t timeout);
+  void candispDispatchI(can_dispatcher_t *cdp, const CANRxFrame *crfp);
+  void candispServeI(can_dispatcher_t *cdp);
+  uint32_t candispGetFilters(can_dispatcher_t *cdp,
+                             candisp_filter_t *fp, uint32_t n);
+  void candispGetStats(can_dispatcher_t *cdp, candisp_stats_t *statsp);
+  void candispResetStats(can_dispatcher_t *cdp);
+#ifdef __cplusplus
+}
+#endif
+
+/*===========================================================================*/
+/* Module inline functions.                                                  */
+/*===========================================================================*/
+
+#endif /* CANDISPATCH_H */
+
+/** @} */
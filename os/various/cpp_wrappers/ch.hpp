@@ -1607,6 +1607,8 @@ namespace chibios_rt {
 
     /**
      * @brief   Performs a wait operation on a semaphore.
+     * @note    If @p CH_CFG_SEM_SPIN_COUNT is greater than zero then the
+     *          thread spins on the counter before sleeping.
      *
      * @return              A message specifying how the invoking thread has
      *                      been released from the semaphore.
@@ -1642,6 +1644,9 @@ namespace chibios_rt {
     /**
      * @brief   Performs a wait operation on a semaphore with timeout
      *          specification.
+     * @note    If @p CH_CFG_SEM_SPIN_COUNT is greater than zero then the
+     *          thread spins on the counter before sleeping, the spin is
+     *          skipped if the timeout is @p TIME_IMMEDIATE.
      *
      * @param[in] timeout   the number of ticks before the operation timeouts,
      *                      the following special values are allowed:
@@ -2021,6 +2026,8 @@ namespace chibios_rt {
      * @brief   Locks the specified mutex.
      * @post    The mutex is locked and inserted in the per-thread stack of
      *          owned mutexes.
+     * @note    If @p CH_CFG_MTX_SPIN_COUNT is greater than zero then the
+     *          thread spins on an owned mutex before sleeping.
      *
      * @api
      */
@@ -2911,6 +2918,38 @@ namespace chibios_rt {
 
       chPoolFreeI(&pool, objp);
     }
+
+    /**
+     * @brief   Allocates multiple objects from a memory pool.
+     * @pre     The memory pool must be already been initialized.
+     *
+     * @param[out] objs     array receiving the pointers to the allocated
+     *                      objects
+     * @param[in] n         number of objects to be allocated
+     * @return              The number of allocated objects.
+     *
+     * @api
+     */
+    size_t allocN(void **objs, size_t n) {
+
+      return chPoolAllocN(&pool, objs, n);
+    }
+
+    /**
+     * @brief   Releases multiple objects into a memory pool.
+     * @pre     The memory pool must be already been initialized.
+     * @pre     The freed objects must be of the right size for the
+     *          specified memory pool.
+     *
+     * @param[in] objs      array of pointers to the objects to be released
+     * @param[in] n         number of objects to be released
+     *
+     * @api
+     */
+    void freeN(void * const *objs, size_t n) {
+
+      chPoolFreeN(&pool, objs, n);
+    }
   };
 
   /*------------------------------------------------------------------------*
@@ -3017,6 +3056,19 @@ namespace chibios_rt {
     Heap(Heap &&) = default;
     Heap &operator=(Heap &&) = default;
 
+    /**
+     * @brief   Adds a memory region to the heap.
+     *
+     * @param[in] buffer    region base
+     * @param[in] size      the size of the memory area located at \e buffer
+     *
+     * @api
+     */
+    void addRegion(void *buffer, const size_t size) {
+
+      chHeapAddRegion(&heap, buffer, size);
+    }
+
     /**
      * @brief   Allocates an object from a heap.
      * @pre     The heap must be already been initialized.
@@ -4,31 +4,135 @@
 /* This is a stub disk I/O module that acts as front end of the existing */
 /* disk I/O modules and attach it to FatFs module with common interface. */
 /*-----------------------------------------------------------------------*/
+/* The device is accessed through its BaseBlockDevice interface, any     */
+/* block device can be used by defining FATFS_HAL_DEVICE_TYPE and        */
+/* FATFS_HAL_DEVICE. Optional layers are placed between FatFs and the    */
+/* device, from the top:                                                 */
+/* - Sectors cache, single sector accesses are served from an objects    */
+/*   cache with lazy write, multi-sector transfers bypass it.            */
+/* - Write coalescing, contiguous writes are merged into larger device   */
+/*   commands, the pending data is written on CTRL_SYNC.                 */
+/* - Bounce buffer, transfers to/from buffers not satisfying the DMA     */
+/*   alignment are performed through an aligned static buffer.           */
+/* The layers have static state, the drive must not be accessed by more  */
+/* than one volume concurrently.                                         */
+/*-----------------------------------------------------------------------*/
+
+#include <string.h>
 
 #include "hal.h"
 #include "ffconf.h"
 #include "ff.h"
 #include "diskio.h"
 
-#if HAL_USE_MMC_SPI && HAL_USE_SDC
-#error "cannot specify both MMC_SPI and SDC drivers"
+/*-----------------------------------------------------------------------*/
+/* Configuration options.                                                */
+
+/* Required alignment of the buffers passed to the device, must be a
+   power of two.*/
+#if !defined(FATFS_DMA_ALIGNMENT)
+#define FATFS_DMA_ALIGNMENT         4U
 #endif
 
-#if !defined(FATFS_HAL_DEVICE)
-#if HAL_USE_MMC_SPI
-#define FATFS_HAL_DEVICE MMCD1
-#else
-#define FATFS_HAL_DEVICE SDCD1
+/* Size of the bounce buffer in sectors, zero disables it and buffers are
+   passed unchanged to the device.*/
+#if !defined(FATFS_BOUNCE_SECTORS)
+#define FATFS_BOUNCE_SECTORS        1U
 #endif
+
+/* Enables the merging of contiguous writes.*/
+#if !defined(FATFS_USE_WRITE_COALESCING)
+#define FATFS_USE_WRITE_COALESCING  FALSE
+#endif
+
+/* Size of the write coalescing buffer in sectors, writes of at least this
+   size are not buffered.*/
+#if !defined(FATFS_COALESCE_SECTORS)
+#define FATFS_COALESCE_SECTORS      8U
+#endif
+
+/* Enables the sectors cache, it requires CH_CFG_USE_OBJ_CACHES.*/
+#if !defined(FATFS_USE_CACHE)
+#define FATFS_USE_CACHE             FALSE
+#endif
+
+/* Number of sectors in the cache.*/
+#if !defined(FATFS_CACHE_SECTORS)
+#define FATFS_CACHE_SECTORS         8U
+#endif
+
+/* Number of elements in the cache hash table, must be a power of two and
+   not lower than FATFS_CACHE_SECTORS.*/
+#if !defined(FATFS_CACHE_HASH_SIZE)
+#define FATFS_CACHE_HASH_SIZE       16U
+#endif
+
+/* Number of sectors read ahead on sequential cached reads, zero disables
+   the read-ahead.*/
+#if !defined(FATFS_CACHE_READ_AHEAD)
+#define FATFS_CACHE_READ_AHEAD      0U
+#endif
+
+/*-----------------------------------------------------------------------*/
+/* Device selection and checks.                                          */
+
+/* By default the MMC_SPI or SDC driver is used, a different block device
+   type must be declared by a header included from ffconf.h.*/
+
+#if !defined(FATFS_HAL_DEVICE_TYPE)
+#if HAL_USE_MMC_SPI && HAL_USE_SDC
+#error "cannot specify both MMC_SPI and SDC drivers"
 #endif
 
 #if HAL_USE_MMC_SPI
-extern MMCDriver FATFS_HAL_DEVICE;
+#define FATFS_HAL_DEVICE_TYPE       MMCDriver
+#define FATFS_HAL_DEVICE_ERASE      mmcErase
+#define FATFS_HAL_ERASE_BLOCK       1U
+#if !defined(FATFS_HAL_DEVICE)
+#define FATFS_HAL_DEVICE            MMCD1
+#endif
 #elif HAL_USE_SDC
-extern SDCDriver FATFS_HAL_DEVICE;
+#define FATFS_HAL_DEVICE_TYPE       SDCDriver
+#define FATFS_HAL_DEVICE_ERASE      sdcErase
+#define FATFS_HAL_ERASE_BLOCK       256U /* 512b blocks in one erase block */
+#if !defined(FATFS_HAL_DEVICE)
+#define FATFS_HAL_DEVICE            SDCD1
+#endif
 #else
 #error "MMC_SPI or SDC driver must be specified"
 #endif
+#endif /* !defined(FATFS_HAL_DEVICE_TYPE) */
+
+#if !defined(FATFS_HAL_DEVICE)
+#error "FATFS_HAL_DEVICE must be specified with FATFS_HAL_DEVICE_TYPE"
+#endif
+
+#if !defined(FATFS_HAL_ERASE_BLOCK)
+#define FATFS_HAL_ERASE_BLOCK       1U
+#endif
+
+#if (FATFS_DMA_ALIGNMENT == 0U) ||                                          \
+    ((FATFS_DMA_ALIGNMENT & (FATFS_DMA_ALIGNMENT - 1U)) != 0U)
+#error "FATFS_DMA_ALIGNMENT must be a power of two"
+#endif
+
+#if (FATFS_USE_WRITE_COALESCING == TRUE) && (FATFS_COALESCE_SECTORS < 2U)
+#error "invalid FATFS_COALESCE_SECTORS value"
+#endif
+
+#if FATFS_USE_CACHE == TRUE
+#if CH_CFG_USE_OBJ_CACHES != TRUE
+#error "FATFS_USE_CACHE requires CH_CFG_USE_OBJ_CACHES"
+#endif
+
+#if (FATFS_CACHE_SECTORS < 1U) ||                                           \
+    (FATFS_CACHE_HASH_SIZE < FATFS_CACHE_SECTORS) ||                        \
+    ((FATFS_CACHE_HASH_SIZE & (FATFS_CACHE_HASH_SIZE - 1U)) != 0U)
+#error "invalid FATFS_CACHE_SECTORS or FATFS_CACHE_HASH_SIZE value"
+#endif
+#endif /* FATFS_USE_CACHE == TRUE */
+
+extern FATFS_HAL_DEVICE_TYPE FATFS_HAL_DEVICE;
 
 #if HAL_USE_RTC
 extern RTCDriver RTCD1;
@@ -37,8 +141,309 @@ extern RTCDriver RTCD1;
 /*-----------------------------------------------------------------------*/
 /* Correspondence between physical drive number and physical drive.      */
 
-#define MMC     0
-#define SDC     0
+#define DRV     0
+
+/* Size of a sector, the HAL block devices only support 512 bytes.*/
+#define SECTOR_SIZE     512U
+
+#define IS_ALIGNED(p)   (((size_t)(p) & (FATFS_DMA_ALIGNMENT - 1U)) == 0U)
+
+/* The device as a generic block device.*/
+static BaseBlockDevice *const bbdp = (BaseBlockDevice *)&FATFS_HAL_DEVICE;
+
+
+
+/*-----------------------------------------------------------------------*/
+/* Device access with bounce buffer                                      */
+
+#if FATFS_BOUNCE_SECTORS > 0U
+ALIGNED_VAR(FATFS_DMA_ALIGNMENT)
+static uint8_t bounce_buf[FATFS_BOUNCE_SECTORS * SECTOR_SIZE];
+#endif
+
+static bool dev_read(uint32_t sector, uint8_t *buf, uint32_t n) {
+
+#if FATFS_BOUNCE_SECTORS > 0U
+  if (!IS_ALIGNED(buf)) {
+    while (n > 0U) {
+      uint32_t chunk = n < FATFS_BOUNCE_SECTORS ? n : FATFS_BOUNCE_SECTORS;
+
+      if (blkRead(bbdp, sector, bounce_buf, chunk))
+        return HAL_FAILED;
+      memcpy(buf, bounce_buf, (size_t)chunk * SECTOR_SIZE);
+      buf    += (size_t)chunk * SECTOR_SIZE;
+      sector += chunk;
+      n      -= chunk;
+    }
+    return HAL_SUCCESS;
+  }
+#endif
+
+  return blkRead(bbdp, sector, buf, n);
+}
+
+static bool dev_write(uint32_t sector, const uint8_t *buf, uint32_t n) {
+
+#if FATFS_BOUNCE_SECTORS > 0U
+  if (!IS_ALIGNED(buf)) {
+    while (n > 0U) {
+      uint32_t chunk = n < FATFS_BOUNCE_SECTORS ? n : FATFS_BOUNCE_SECTORS;
+
+      memcpy(bounce_buf, buf, (size_t)chunk * SECTOR_SIZE);
+      if (blkWrite(bbdp, sector, bounce_buf, chunk))
+        return HAL_FAILED;
+      buf    += (size_t)chunk * SECTOR_SIZE;
+      sector += chunk;
+      n      -= chunk;
+    }
+    return HAL_SUCCESS;
+  }
+#endif
+
+  return blkWrite(bbdp, sector, buf, n);
+}
+
+
+
+/*-----------------------------------------------------------------------*/
+/* Write coalescing                                                      */
+
+#if FATFS_USE_WRITE_COALESCING == TRUE
+ALIGNED_VAR(FATFS_DMA_ALIGNMENT)
+static uint8_t wc_buf[FATFS_COALESCE_SECTORS * SECTOR_SIZE];
+static uint32_t wc_start;
+static uint32_t wc_n;
+
+/* Writes the pending run, if any.*/
+static bool wc_flush(void) {
+  uint32_t n = wc_n;
+
+  if (n == 0U)
+    return HAL_SUCCESS;
+  wc_n = 0U;
+
+  return dev_write(wc_start, wc_buf, n);
+}
+
+static bool media_read(uint32_t sector, uint8_t *buf, uint32_t n) {
+
+  /* The pending run is written first if overlapping the read.*/
+  if ((wc_n > 0U) && (sector < wc_start + wc_n) && (wc_start < sector + n)) {
+    if (wc_flush())
+      return HAL_FAILED;
+  }
+
+  return dev_read(sector, buf, n);
+}
+
+static bool media_write(uint32_t sector, const uint8_t *buf, uint32_t n) {
+
+  /* A non contiguous write terminates the pending run.*/
+  if ((wc_n > 0U) && (sector != wc_start + wc_n)) {
+    if (wc_flush())
+      return HAL_FAILED;
+  }
+
+  while (n > 0U) {
+    uint32_t chunk;
+
+    /* Large writes go to the device directly.*/
+    if ((wc_n == 0U) && (n >= FATFS_COALESCE_SECTORS))
+      return dev_write(sector, buf, n);
+
+    if (wc_n == 0U)
+      wc_start = sector;
+    chunk = FATFS_COALESCE_SECTORS - wc_n;
+    if (chunk > n)
+      chunk = n;
+    memcpy(&wc_buf[wc_n * SECTOR_SIZE], buf, (size_t)chunk * SECTOR_SIZE);
+    wc_n   += chunk;
+    buf    += (size_t)chunk * SECTOR_SIZE;
+    sector += chunk;
+    n      -= chunk;
+
+    if (wc_n == FATFS_COALESCE_SECTORS) {
+      if (wc_flush())
+        return HAL_FAILED;
+    }
+  }
+
+  return HAL_SUCCESS;
+}
+
+static bool media_flush(void) {
+
+  return wc_flush();
+}
+#else /* FATFS_USE_WRITE_COALESCING != TRUE */
+#define media_read(sector, buf, n)      dev_read(sector, buf, n)
+#define media_write(sector, buf, n)     dev_write(sector, buf, n)
+#define media_flush()                   HAL_SUCCESS
+#endif /* FATFS_USE_WRITE_COALESCING != TRUE */
+
+
+
+/*-----------------------------------------------------------------------*/
+/* Sectors cache                                                         */
+
+#if FATFS_USE_CACHE == TRUE
+static objects_cache_t cache;
+static oc_hash_header_t cache_hash[FATFS_CACHE_HASH_SIZE];
+static oc_object_t cache_objs[FATFS_CACHE_SECTORS];
+ALIGNED_VAR(FATFS_DMA_ALIGNMENT)
+static uint8_t cache_bufs[FATFS_CACHE_SECTORS][SECTOR_SIZE];
+static bool cache_ready;
+
+/* Set on lazy write failures, reported on the next CTRL_SYNC.*/
+static bool cache_error;
+
+static bool cache_readf(objects_cache_t *ocp, oc_object_t *objp, bool async) {
+  bool result;
+
+  result = media_read(objp->obj_key, (uint8_t *)objp->dptr, 1U);
+  if (!result)
+    objp->obj_flags &= ~OC_FLAG_NOTSYNC;
+
+  if (async)
+    chCacheReleaseObject(ocp, objp);
+
+  return result;
+}
+
+static bool cache_writef(objects_cache_t *ocp, oc_object_t *objp, bool async) {
+  bool result;
+
+  result = media_write(objp->obj_key, (const uint8_t *)objp->dptr, 1U);
+  if (result) {
+    /* The cached data does not match the media anymore.*/
+    objp->obj_flags |= OC_FLAG_NOTSYNC;
+    cache_error = true;
+  }
+
+  if (async)
+    chCacheReleaseObject(ocp, objp);
+
+  return result;
+}
+
+static void cache_init(void) {
+  unsigned i;
+
+  if (cache_ready)
+    return;
+
+  chCacheObjectInit(&cache, FATFS_CACHE_HASH_SIZE, cache_hash,
+                    FATFS_CACHE_SECTORS, sizeof (oc_object_t), cache_objs,
+                    cache_readf, cache_writef);
+  for (i = 0U; i < FATFS_CACHE_SECTORS; i++)
+    cache_objs[i].dptr = cache_bufs[i];
+  chCacheSetReadAhead(&cache, FATFS_CACHE_READ_AHEAD);
+  cache_error = false;
+  cache_ready = true;
+}
+
+static bool cached_read(uint32_t sector, uint8_t *buf, uint32_t n) {
+  oc_object_t *objp;
+
+  if (n == 1U) {
+    objp = chCacheGetObject(&cache, 0U, sector);
+    if ((objp->obj_flags & OC_FLAG_NOTSYNC) != 0U) {
+      if (chCacheReadObject(&cache, objp, false)) {
+        /* Still marked as not in sync, it is invalidated.*/
+        chCacheReleaseObject(&cache, objp);
+        return HAL_FAILED;
+      }
+    }
+    memcpy(buf, objp->dptr, SECTOR_SIZE);
+    chCacheReleaseObject(&cache, objp);
+    return HAL_SUCCESS;
+  }
+
+  /* Multi-sector reads bypass the cache, data of dirty cached sectors is
+     more recent than the media one.*/
+  if (media_read(sector, buf, n))
+    return HAL_FAILED;
+  while (n > 0U) {
+    objp = chCacheLookupObject(&cache, 0U, sector);
+    if (objp != NULL) {
+      if ((objp->obj_flags & (OC_FLAG_NOTSYNC | OC_FLAG_LAZYWRITE)) ==
+          OC_FLAG_LAZYWRITE)
+        memcpy(buf, objp->dptr, SECTOR_SIZE);
+      chCacheReleaseObject(&cache, objp);
+    }
+    buf += SECTOR_SIZE;
+    sector++;
+    n--;
+  }
+
+  return HAL_SUCCESS;
+}
+
+static bool cached_write(uint32_t sector, const uint8_t *buf, uint32_t n) {
+  oc_object_t *objp;
+  bool result;
+
+  if (n == 1U) {
+    objp = chCacheGetObject(&cache, 0U, sector);
+    memcpy(objp->dptr, buf, SECTOR_SIZE);
+    objp->obj_flags &= ~OC_FLAG_NOTSYNC;
+    objp->obj_flags |= OC_FLAG_LAZYWRITE;
+    chCacheReleaseObject(&cache, objp);
+    return HAL_SUCCESS;
+  }
+
+  /* Multi-sector writes bypass the cache, cached copies are updated and
+     no more need to be written.*/
+  result = media_write(sector, buf, n);
+  while (n > 0U) {
+    objp = chCacheLookupObject(&cache, 0U, sector);
+    if (objp != NULL) {
+      objp->obj_flags &= ~OC_FLAG_LAZYWRITE;
+      if (result) {
+        objp->obj_flags |= OC_FLAG_NOTSYNC;
+      }
+      else {
+        memcpy(objp->dptr, buf, SECTOR_SIZE);
+        objp->obj_flags &= ~OC_FLAG_NOTSYNC;
+      }
+      chCacheReleaseObject(&cache, objp);
+    }
+    buf += SECTOR_SIZE;
+    sector++;
+    n--;
+  }
+
+  return result;
+}
+
+static bool cached_flush(void) {
+  bool result;
+
+  /* Writing back all the dirty sectors.*/
+  while (chCacheWriteBackTimeout(&cache, TIME_IMMEDIATE) == MSG_OK) {
+  }
+  result = cache_error;
+  cache_error = false;
+
+  return media_flush() || result;
+}
+#else /* FATFS_USE_CACHE != TRUE */
+#define cache_init()
+#define cached_read(sector, buf, n)     media_read(sector, buf, n)
+#define cached_write(sector, buf, n)    media_write(sector, buf, n)
+#define cached_flush()                  media_flush()
+#endif /* FATFS_USE_CACHE != TRUE */
+
+/* Writes all the buffered data and synchronizes the device.*/
+static DRESULT disk_flush(void) {
+  bool result;
+
+  result = cached_flush();
+  if (blkSync(bbdp))
+    result = HAL_FAILED;
+
+  return result ? RES_ERROR : RES_OK;
+}
 
 
 
@@ -52,25 +457,15 @@ DSTATUS disk_initialize (
   DSTATUS stat;
 
   switch (pdrv) {
-#if HAL_USE_MMC_SPI
-  case MMC:
+  case DRV:
     stat = 0;
     /* It is initialized externally, just reads the status.*/
-    if (blkGetDriverState(&FATFS_HAL_DEVICE) != BLK_READY)
+    if (blkGetDriverState(bbdp) != BLK_READY)
       stat |= STA_NOINIT;
-    if (mmcIsWriteProtected(&FATFS_HAL_DEVICE))
+    if (blkIsWriteProtected(bbdp))
       stat |=  STA_PROTECT;
+    cache_init();
     return stat;
-#else
-  case SDC:
-    stat = 0;
-    /* It is initialized externally, just reads the status.*/
-    if (blkGetDriverState(&FATFS_HAL_DEVICE) != BLK_READY)
-      stat |= STA_NOINIT;
-    if (sdcIsWriteProtected(&FATFS_HAL_DEVICE))
-      stat |=  STA_PROTECT;
-    return stat;
-#endif
   }
   return STA_NOINIT;
 }
@@ -87,25 +482,14 @@ DSTATUS disk_status (
   DSTATUS stat;
 
   switch (pdrv) {
-#if HAL_USE_MMC_SPI
-  case MMC:
+  case DRV:
     stat = 0;
     /* It is initialized externally, just reads the status.*/
-    if (blkGetDriverState(&FATFS_HAL_DEVICE) != BLK_READY)
+    if (blkGetDriverState(bbdp) != BLK_READY)
       stat |= STA_NOINIT;
-    if (mmcIsWriteProtected(&FATFS_HAL_DEVICE))
+    if (blkIsWriteProtected(bbdp))
       stat |= STA_PROTECT;
     return stat;
-#else
-  case SDC:
-    stat = 0;
-    /* It is initialized externally, just reads the status.*/
-    if (blkGetDriverState(&FATFS_HAL_DEVICE) != BLK_READY)
-      stat |= STA_NOINIT;
-    if (sdcIsWriteProtected(&FATFS_HAL_DEVICE))
-      stat |= STA_PROTECT;
-    return stat;
-#endif
   }
   return STA_NOINIT;
 }
@@ -123,29 +507,12 @@ DRESULT disk_read (
 )
 {
   switch (pdrv) {
-#if HAL_USE_MMC_SPI
-  case MMC:
-    if (blkGetDriverState(&FATFS_HAL_DEVICE) != BLK_READY)
+  case DRV:
+    if (blkGetDriverState(bbdp) != BLK_READY)
       return RES_NOTRDY;
-    if (mmcStartSequentialRead(&FATFS_HAL_DEVICE, sector))
+    if (cached_read((uint32_t)sector, (uint8_t *)buff, (uint32_t)count))
       return RES_ERROR;
-    while (count > 0) {
-      if (mmcSequentialRead(&FATFS_HAL_DEVICE, buff))
-        return RES_ERROR;
-      buff += MMCSD_BLOCK_SIZE;
-      count--;
-    }
-    if (mmcStopSequentialRead(&FATFS_HAL_DEVICE))
-        return RES_ERROR;
     return RES_OK;
-#else
-  case SDC:
-    if (blkGetDriverState(&FATFS_HAL_DEVICE) != BLK_READY)
-      return RES_NOTRDY;
-    if (sdcRead(&FATFS_HAL_DEVICE, sector, buff, count))
-      return RES_ERROR;
-    return RES_OK;
-#endif
   }
   return RES_PARERR;
 }
@@ -164,31 +531,15 @@ DRESULT disk_write (
 )
 {
   switch (pdrv) {
-#if HAL_USE_MMC_SPI
-  case MMC:
-    if (blkGetDriverState(&FATFS_HAL_DEVICE) != BLK_READY)
-        return RES_NOTRDY;
-    if (mmcIsWriteProtected(&FATFS_HAL_DEVICE))
-        return RES_WRPRT;
-    if (mmcStartSequentialWrite(&FATFS_HAL_DEVICE, sector))
-        return RES_ERROR;
-    while (count > 0) {
-        if (mmcSequentialWrite(&FATFS_HAL_DEVICE, buff))
-            return RES_ERROR;
-        buff += MMCSD_BLOCK_SIZE;
-        count--;
-    }
-    if (mmcStopSequentialWrite(&FATFS_HAL_DEVICE))
-        return RES_ERROR;
-    return RES_OK;
-#else
-  case SDC:
-    if (blkGetDriverState(&FATFS_HAL_DEVICE) != BLK_READY)
+  case DRV:
+    if (blkGetDriverState(bbdp) != BLK_READY)
       return RES_NOTRDY;
-    if (sdcWrite(&FATFS_HAL_DEVICE, sector, buff, count))
+    if (blkIsWriteProtected(bbdp))
+      return RES_WRPRT;
+    if (cached_write((uint32_t)sector, (const uint8_t *)buff,
+                     (uint32_t)count))
       return RES_ERROR;
     return RES_OK;
-#endif
   }
   return RES_PARERR;
 }
@@ -205,52 +556,41 @@ DRESULT disk_ioctl (
     void *buff        /* Buffer to send/receive control data */
 )
 {
+  BlockDeviceInfo bdi;
+
   (void)buff;
 
   switch (pdrv) {
-#if HAL_USE_MMC_SPI
-  case MMC:
-    switch (cmd) {
-    case CTRL_SYNC:
-        return RES_OK;
-#if FF_MAX_SS > FF_MIN_SS
-    case GET_SECTOR_SIZE:
-        *((WORD *)buff) = MMCSD_BLOCK_SIZE;
-        return RES_OK;
-#endif
-#if FF_USE_TRIM
-    case CTRL_TRIM:
-        mmcErase(&FATFS_HAL_DEVICE, *((DWORD *)buff), *((DWORD *)buff + 1));
-        return RES_OK;
-#endif
-    default:
-        return RES_PARERR;
-    }
-#else
-  case SDC:
+  case DRV:
     switch (cmd) {
     case CTRL_SYNC:
-        return RES_OK;
+        /* Buffered data is written before synchronizing the device.*/
+        return disk_flush();
     case GET_SECTOR_COUNT:
-        *((DWORD *)buff) = mmcsdGetCardCapacity(&FATFS_HAL_DEVICE);
+        if (blkGetInfo(bbdp, &bdi))
+          return RES_NOTRDY;
+        *((DWORD *)buff) = (DWORD)bdi.blk_num;
         return RES_OK;
 #if FF_MAX_SS > FF_MIN_SS
     case GET_SECTOR_SIZE:
-        *((WORD *)buff) = MMCSD_BLOCK_SIZE;
+        *((WORD *)buff) = SECTOR_SIZE;
         return RES_OK;
 #endif
     case GET_BLOCK_SIZE:
-        *((DWORD *)buff) = 256; /* 512b blocks in one erase block */
+        *((DWORD *)buff) = FATFS_HAL_ERASE_BLOCK;
         return RES_OK;
-#if FF_USE_TRIM
+#if FF_USE_TRIM && defined(FATFS_HAL_DEVICE_ERASE)
     case CTRL_TRIM:
-        sdcErase(&FATFS_HAL_DEVICE, *((DWORD *)buff), *((DWORD *)buff + 1));
+        /* Buffered writes must not land after the erase.*/
+        if (disk_flush() != RES_OK)
+          return RES_ERROR;
+        FATFS_HAL_DEVICE_ERASE(&FATFS_HAL_DEVICE, *((DWORD *)buff),
+                               *((DWORD *)buff + 1));
         return RES_OK;
 #endif
     default:
         return RES_PARERR;
     }
-#endif
   }
   return RES_PARERR;
 }
@@ -62,19 +62,60 @@
 #include "arch/cc.h"
 #include "arch/sys_arch.h"
 
+#if CH_CFG_USE_MEMPOOLS != TRUE
+#error "sys_arch requires CH_CFG_USE_MEMPOOLS"
+#endif
+
+#if (SYS_ARCH_NUM_SEMS < 1) || (SYS_ARCH_NUM_MBOXES < 1)
+#error "invalid sys_arch pool sizes"
+#endif
+
+#if SYS_ARCH_MBOX_SIZE < 1
+#error "mailbox sizes not configured in lwipopts.h"
+#endif
+
+/* Mailbox with its messages buffer.*/
+typedef struct {
+  mailbox_t     mb;
+  msg_t         buf[SYS_ARCH_MBOX_SIZE];
+} sys_arch_mbox_t;
+
+#if LWIP_NETCONN_SEM_PER_THREAD
+/* Association between a thread and its netconn semaphore.*/
+typedef struct {
+  thread_t      *tp;
+  sys_sem_t     sem;
+} sys_arch_thread_sem_t;
+#endif
+
+sys_arch_stats_t sys_arch_stats;
+
+static semaphore_t sems[SYS_ARCH_NUM_SEMS];
+static sys_arch_mbox_t mboxes[SYS_ARCH_NUM_MBOXES];
+static MEMORYPOOL_DECL(sems_pool, sizeof (semaphore_t),
+                       PORT_NATURAL_ALIGN, NULL);
+static MEMORYPOOL_DECL(mboxes_pool, sizeof (sys_arch_mbox_t),
+                       PORT_NATURAL_ALIGN, NULL);
+#if LWIP_NETCONN_SEM_PER_THREAD
+static sys_arch_thread_sem_t thread_sems[SYS_ARCH_NUM_THREAD_SEMS];
+#endif
+
 void sys_init(void) {
 
+  chPoolLoadArray(&sems_pool, sems, SYS_ARCH_NUM_SEMS);
+  chPoolLoadArray(&mboxes_pool, mboxes, SYS_ARCH_NUM_MBOXES);
 }
 
 err_t sys_sem_new(sys_sem_t *sem, u8_t count) {
 
-  *sem = chHeapAlloc(NULL, sizeof(semaphore_t));
+  *sem = chPoolAlloc(&sems_pool);
   if (*sem == 0) {
     SYS_STATS_INC(sem.err);
     return ERR_MEM;
   }
   else {
     chSemObjectInit(*sem, (cnt_t)count);
+    sys_arch_stats.sem_allocs++;
     SYS_STATS_INC_USED(sem);
     return ERR_OK;
   }
@@ -82,7 +123,7 @@ err_t sys_sem_new(sys_sem_t *sem, u8_t count) {
 
 void sys_sem_free(sys_sem_t *sem) {
 
-  chHeapFree(*sem);
+  chPoolFree(&sems_pool, *sem);
   *sem = SYS_SEM_NULL;
   SYS_STATS_DEC(sem.used);
 }
@@ -127,15 +168,24 @@ void sys_sem_set_invalid(sys_sem_t *sem) {
 }
 
 err_t sys_mbox_new(sys_mbox_t *mbox, int size) {
+  sys_arch_mbox_t *mbp;
+
+  chDbgAssert(size <= SYS_ARCH_MBOX_SIZE, "mailbox too large");
 
-  *mbox = chHeapAlloc(NULL, sizeof(mailbox_t) + sizeof(msg_t) * size);
-  if (*mbox == 0) {
+  /* All mailboxes have the same size, a zero size request means default
+     size.*/
+  (void)size;
+  mbp = chPoolAlloc(&mboxes_pool);
+  if (mbp == NULL) {
+    *mbox = SYS_MBOX_NULL;
     SYS_STATS_INC(mbox.err);
     return ERR_MEM;
   }
   else {
-    chMBObjectInit(*mbox, (void *)(((uint8_t *)*mbox) + sizeof(mailbox_t)), size);
-    SYS_STATS_INC(mbox.used);
+    chMBObjectInit(&mbp->mb, mbp->buf, SYS_ARCH_MBOX_SIZE);
+    *mbox = &mbp->mb;
+    sys_arch_stats.mbox_allocs++;
+    SYS_STATS_INC_USED(mbox);
     return ERR_OK;
   }
 }
@@ -154,19 +204,36 @@ void sys_mbox_free(sys_mbox_t *mbox) {
     SYS_STATS_INC(mbox.err);
     chMBReset(*mbox);
   }
-  chHeapFree(*mbox);
+  chPoolFree(&mboxes_pool, *mbox);
   *mbox = SYS_MBOX_NULL;
   SYS_STATS_DEC(mbox.used);
 }
 
 void sys_mbox_post(sys_mbox_t *mbox, void *msg) {
 
-  chMBPostTimeout(*mbox, (msg_t)msg, TIME_INFINITE);
+  chSysLock();
+  /* Fast path, there is space in the mailbox and no need to go through
+     the timeout handling.*/
+  if (chMBPostI(*mbox, (msg_t)msg) != MSG_OK) {
+    (void) chMBPostTimeoutS(*mbox, (msg_t)msg, TIME_INFINITE);
+  }
+  else {
+    chSchRescheduleS();
+  }
+  chSysUnlock();
 }
 
 err_t sys_mbox_trypost(sys_mbox_t *mbox, void *msg) {
+  msg_t msg1;
+
+  chSysLock();
+  msg1 = chMBPostI(*mbox, (msg_t)msg);
+  if (msg1 == MSG_OK) {
+    chSchRescheduleS();
+  }
+  chSysUnlock();
 
-  if (chMBPostTimeout(*mbox, (msg_t)msg, TIME_IMMEDIATE) == MSG_TIMEOUT) {
+  if (msg1 != MSG_OK) {
     SYS_STATS_INC(mbox.err);
     return ERR_MEM;
   }
@@ -206,6 +273,73 @@ void sys_mbox_set_invalid(sys_mbox_t *mbox) {
   *mbox = SYS_MBOX_NULL;
 }
 
+#if LWIP_NETCONN_SEM_PER_THREAD
+/* Returns the netconn semaphore of the current thread, it is allocated on
+   first use. The callers have no failure path so the system is halted if
+   the semaphore cannot be allocated, SYS_ARCH_NUM_THREAD_SEMS must cover
+   all the threads using the netconn API.*/
+sys_sem_t *sys_arch_netconn_sem_get(void) {
+  thread_t *tp = chThdGetSelfX();
+  unsigned i;
+
+  for (i = 0U; i < SYS_ARCH_NUM_THREAD_SEMS; i++) {
+    if (thread_sems[i].tp == tp) {
+      return &thread_sems[i].sem;
+    }
+  }
+
+  sys_arch_netconn_sem_alloc();
+  for (i = 0U; i < SYS_ARCH_NUM_THREAD_SEMS; i++) {
+    if (thread_sems[i].tp == tp) {
+      return &thread_sems[i].sem;
+    }
+  }
+
+  /* Table full or semaphores pool empty.*/
+  chSysHalt("netconn semaphores exhausted");
+
+  return NULL;
+}
+
+void sys_arch_netconn_sem_alloc(void) {
+  thread_t *tp = chThdGetSelfX();
+  sys_sem_t sem;
+  unsigned i;
+
+  if (sys_sem_new(&sem, 0) != ERR_OK) {
+    return;
+  }
+
+  chSysLock();
+  for (i = 0U; i < SYS_ARCH_NUM_THREAD_SEMS; i++) {
+    if (thread_sems[i].tp == NULL) {
+      thread_sems[i].tp  = tp;
+      thread_sems[i].sem = sem;
+      chSysUnlock();
+      return;
+    }
+  }
+  chSysUnlock();
+
+  sys_sem_free(&sem);
+}
+
+void sys_arch_netconn_sem_free(void) {
+  thread_t *tp = chThdGetSelfX();
+  unsigned i;
+
+  for (i = 0U; i < SYS_ARCH_NUM_THREAD_SEMS; i++) {
+    if (thread_sems[i].tp == tp) {
+      sys_sem_free(&thread_sems[i].sem);
+      chSysLock();
+      thread_sems[i].tp = NULL;
+      chSysUnlock();
+      return;
+    }
+  }
+}
+#endif /* LWIP_NETCONN_SEM_PER_THREAD */
+
 sys_thread_t sys_thread_new(const char *name, lwip_thread_fn thread,
                             void *arg, int stacksize, int prio) {
   thread_t *tp;
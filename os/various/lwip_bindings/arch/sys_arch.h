@@ -65,4 +65,67 @@ typedef syssts_t        sys_prot_t;
 /* let sys.h use binary semaphores for mutexes */
 #define LWIP_COMPAT_MUTEX 1
 
+/*
+ * Semaphores and mailboxes are allocated from static pools, the sizes are
+ * derived from lwipopts.h and can be overridden there.
+ */
+
+/* Semaphores pool size, netconns, mutexes and API calls.*/
+#if !defined(SYS_ARCH_NUM_SEMS)
+#define SYS_ARCH_NUM_SEMS       (MEMP_NUM_NETCONN + 4 + SYS_ARCH_NUM_THREAD_SEMS)
+#endif
+
+/* Mailboxes pool size, the tcpip mailbox plus receive and accept mailboxes
+   for each netconn.*/
+#if !defined(SYS_ARCH_NUM_MBOXES)
+#define SYS_ARCH_NUM_MBOXES     (1 + (MEMP_NUM_NETCONN * 2))
+#endif
+
+#define SYS_ARCH_MAX(a, b)      ((a) > (b) ? (a) : (b))
+
+/* Slots in each mailbox, the largest of the configured mailbox sizes.*/
+#if !defined(SYS_ARCH_MBOX_SIZE)
+#define SYS_ARCH_MBOX_SIZE                                                  \
+  SYS_ARCH_MAX(SYS_ARCH_MAX(TCPIP_MBOX_SIZE, DEFAULT_ACCEPTMBOX_SIZE),      \
+               SYS_ARCH_MAX(SYS_ARCH_MAX(DEFAULT_RAW_RECVMBOX_SIZE,         \
+                                         DEFAULT_UDP_RECVMBOX_SIZE),        \
+                            DEFAULT_TCP_RECVMBOX_SIZE))
+#endif
+
+#if LWIP_NETCONN_SEM_PER_THREAD
+/* Maximum number of threads using the netconn API at the same time, the
+   system is halted if more threads use it.*/
+#if !defined(SYS_ARCH_NUM_THREAD_SEMS)
+#define SYS_ARCH_NUM_THREAD_SEMS    4
+#endif
+
+#define LWIP_NETCONN_THREAD_SEM_GET()   sys_arch_netconn_sem_get()
+#define LWIP_NETCONN_THREAD_SEM_ALLOC() sys_arch_netconn_sem_alloc()
+#define LWIP_NETCONN_THREAD_SEM_FREE()  sys_arch_netconn_sem_free()
+#else
+#undef SYS_ARCH_NUM_THREAD_SEMS
+#define SYS_ARCH_NUM_THREAD_SEMS    0
+#endif
+
+/* Allocation counters, allocations failed because of empty pools are
+   counted by SYS_STATS.*/
+typedef struct {
+  uint32_t      sem_allocs;
+  uint32_t      mbox_allocs;
+} sys_arch_stats_t;
+
+extern sys_arch_stats_t sys_arch_stats;
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+#if LWIP_NETCONN_SEM_PER_THREAD
+  sys_sem_t *sys_arch_netconn_sem_get(void);
+  void sys_arch_netconn_sem_alloc(void);
+  void sys_arch_netconn_sem_free(void);
+#endif
+#ifdef __cplusplus
+}
+#endif
+
 #endif /* __SYS_ARCH_H__ */
@@ -79,6 +79,30 @@
 #include <lwip/autoip.h>
 #endif
 
+#if LWIP_USE_ZERO_COPY == TRUE
+#include <string.h>
+
+#if MAC_USE_ZERO_COPY != TRUE
+#error "LWIP_USE_ZERO_COPY requires MAC_USE_ZERO_COPY"
+#endif
+
+#if !LWIP_SUPPORT_CUSTOM_PBUF
+#error "LWIP_USE_ZERO_COPY requires LWIP_SUPPORT_CUSTOM_PBUF"
+#endif
+
+#if ETH_PAD_SIZE
+#error "LWIP_USE_ZERO_COPY requires ETH_PAD_SIZE == 0"
+#endif
+
+#if CH_CFG_USE_MEMPOOLS != TRUE
+#error "LWIP_USE_ZERO_COPY requires CH_CFG_USE_MEMPOOLS"
+#endif
+
+#if LWIP_ZERO_COPY_RX_PBUFS < 1
+#error "invalid LWIP_ZERO_COPY_RX_PBUFS value"
+#endif
+#endif /* LWIP_USE_ZERO_COPY == TRUE */
+
 #define PERIODIC_TIMER_ID       1
 #define FRAME_RECEIVED_ID       2
 
@@ -92,6 +116,100 @@ thread_reference_t lwip_trp = NULL;
  */
 static THD_WORKING_AREA(wa_lwip_thread, LWIP_THREAD_STACK_SIZE);
 
+#if LWIP_USE_ZERO_COPY == TRUE
+/*
+ * Custom pbuf referring a MAC receive buffer, the descriptor stays locked
+ * until lwIP frees the pbuf.
+ */
+typedef struct {
+  struct pbuf_custom    pc;
+  MACReceiveDescriptor  rd;
+} rx_pbuf_t;
+
+/*
+ * Receive wrappers and their pool.
+ */
+static rx_pbuf_t rx_pbufs[LWIP_ZERO_COPY_RX_PBUFS];
+static memory_pool_t rx_pbufs_pool;
+
+/*
+ * Called by lwIP when the last reference to a received frame is dropped,
+ * the buffer is given back to the MAC.
+ */
+static void rx_pbuf_free(struct pbuf *p) {
+  rx_pbuf_t *rxp = (rx_pbuf_t *)p;
+
+  macReleaseReceiveDescriptor(&rxp->rd);
+  chPoolFree(&rx_pbufs_pool, rxp);
+}
+
+/*
+ * Wraps the MAC buffer of a received frame into a custom pbuf.
+ * Returns NULL if there are no free wrappers or if the frame is not
+ * contained in a single buffer, the descriptor is left untouched in
+ * that case.
+ */
+static struct pbuf *rx_pbuf_alloc(MACReceiveDescriptor *rdp) {
+  rx_pbuf_t *rxp;
+  const uint8_t *bp;
+  size_t size;
+  struct pbuf *p;
+
+  rxp = chPoolAlloc(&rx_pbufs_pool);
+  if (rxp == NULL)
+    return NULL;
+
+  /* Working on a copy of the descriptor so that the caller can still
+     read the frame on failure.*/
+  rxp->rd = *rdp;
+  bp = macGetNextReceiveBuffer(&rxp->rd, &size);
+  if ((bp == NULL) || (size < rdp->size)) {
+    chPoolFree(&rx_pbufs_pool, rxp);
+    return NULL;
+  }
+
+  rxp->pc.custom_free_function = rx_pbuf_free;
+  p = pbuf_alloced_custom(PBUF_RAW, (u16_t)rdp->size, PBUF_REF, &rxp->pc,
+                          (void *)bp, (u16_t)size);
+  if (p == NULL)
+    chPoolFree(&rx_pbufs_pool, rxp);
+
+  return p;
+}
+
+/*
+ * Writes a pbuf chain into the transmit buffers of a descriptor.
+ */
+static void tx_write_chain(MACTransmitDescriptor *tdp, struct pbuf *p) {
+  size_t left = (size_t)p->tot_len;
+  size_t bsize = 0U;
+  uint8_t *bp = NULL;
+  struct pbuf *q;
+
+  for (q = p; q != NULL; q = q->next) {
+    const uint8_t *src = (const uint8_t *)q->payload;
+    size_t len = (size_t)q->len;
+
+    while (len > 0U) {
+      size_t n;
+
+      if (bsize == 0U) {
+        bp = macGetNextTransmitBuffer(tdp, left, &bsize);
+        if (bp == NULL)
+          return;                       /* Frame truncated.*/
+      }
+      n = len < bsize ? len : bsize;
+      memcpy(bp, src, n);
+      bp    += n;
+      bsize -= n;
+      src   += n;
+      len   -= n;
+      left  -= n;
+    }
+  }
+}
+#endif /* LWIP_USE_ZERO_COPY == TRUE */
+
 /*
  * Initialization.
  */
@@ -136,9 +254,14 @@ static err_t low_level_output(struct netif *netif, struct pbuf *p) {
   pbuf_header(p, -ETH_PAD_SIZE);        /* drop the padding word */
 #endif
 
+#if LWIP_USE_ZERO_COPY == TRUE
+  (void)q;
+  tx_write_chain(&td, p);
+#else
   /* Iterates through the pbuf chain. */
   for(q = p; q != NULL; q = q->next)
     macWriteTransmitDescriptor(&td, (uint8_t *)q->payload, (size_t)q->len);
+#endif
   macReleaseTransmitDescriptor(&td);
 
   MIB2_STATS_NETIF_ADD(netif, ifoutoctets, p->tot_len);
@@ -188,19 +311,37 @@ static bool low_level_input(struct netif *netif, struct pbuf **pbuf) {
   len += ETH_PAD_SIZE;        /* allow room for Ethernet padding */
 #endif
 
-  /* We allocate a pbuf chain of pbufs from the pool. */
-  *pbuf = pbuf_alloc(PBUF_RAW, len, PBUF_POOL);
+#if LWIP_USE_ZERO_COPY == TRUE
+  /* The MAC buffer is passed to lwIP if possible, it is released when the
+     pbuf is freed. If not possible then the frame is copied.*/
+  *pbuf = rx_pbuf_alloc(&rd);
+  if (*pbuf == NULL)
+#endif
+  {
+    /* We allocate a pbuf chain of pbufs from the pool. */
+    *pbuf = pbuf_alloc(PBUF_RAW, len, PBUF_POOL);
+
+    if (*pbuf != NULL) {
+#if ETH_PAD_SIZE
+      pbuf_header(*pbuf, -ETH_PAD_SIZE); /* drop the padding word */
+#endif
+
+      /* Iterates through the pbuf chain. */
+      for(q = *pbuf; q != NULL; q = q->next)
+        macReadReceiveDescriptor(&rd, (uint8_t *)q->payload, (size_t)q->len);
+      macReleaseReceiveDescriptor(&rd);
+
+#if ETH_PAD_SIZE
+      pbuf_header(*pbuf, ETH_PAD_SIZE); /* reclaim the padding word */
+#endif
+    }
+  }
 
   if (*pbuf != NULL) {
 #if ETH_PAD_SIZE
     pbuf_header(*pbuf, -ETH_PAD_SIZE); /* drop the padding word */
 #endif
 
-    /* Iterates through the pbuf chain. */
-    for(q = *pbuf; q != NULL; q = q->next)
-      macReadReceiveDescriptor(&rd, (uint8_t *)q->payload, (size_t)q->len);
-    macReleaseReceiveDescriptor(&rd);
-
     MIB2_STATS_NETIF_ADD(netif, ifinoctets, (*pbuf)->tot_len);
 
     if (*(uint8_t *)((*pbuf)->payload) & 1) {
@@ -361,6 +502,11 @@ static THD_FUNCTION(lwip_thread, p) {
 
   MIB2_INIT_NETIF(&thisif, snmp_ifType_ethernet_csmacd, 0);
 
+#if LWIP_USE_ZERO_COPY == TRUE
+  chPoolObjectInit(&rx_pbufs_pool, sizeof (rx_pbuf_t), NULL);
+  chPoolLoadArray(&rx_pbufs_pool, rx_pbufs, LWIP_ZERO_COPY_RX_PBUFS);
+#endif
+
   /* Add interface. */
   result = netifapi_netif_add(&thisif, &ip, &netmask, &gateway, NULL, ethernetif_init, tcpip_input);
   if (result != ERR_OK)
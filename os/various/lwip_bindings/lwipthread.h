@@ -103,6 +103,32 @@
 #define LWIP_LINK_SPEED                     100000000
 #endif
 
+/**
+ * @brief   Zero-copy MAC interface.
+ * @details If enabled, received frames are passed to lwIP as custom pbufs
+ *          referring the MAC receive buffers, each buffer is returned to
+ *          the MAC when lwIP frees the pbuf. Transmitted pbuf chains are
+ *          written directly into the MAC transmit buffers.
+ * @note    Requires @p MAC_USE_ZERO_COPY and @p LWIP_SUPPORT_CUSTOM_PBUF,
+ *          @p ETH_PAD_SIZE must be zero.
+ */
+#if !defined(LWIP_USE_ZERO_COPY) || defined(__DOXYGEN__)
+#define LWIP_USE_ZERO_COPY                  FALSE
+#endif
+
+/**
+ * @brief   Number of received frames lwIP can hold in zero-copy mode.
+ * @details Frames received while all the wrappers are in use are copied
+ *          into @p PBUF_POOL pbufs and the MAC buffer is released
+ *          immediately.
+ * @note    Keep this value below the number of MAC receive buffers, frames
+ *          queued by TCP or by the IP reassembly keep their MAC buffer
+ *          locked.
+ */
+#if !defined(LWIP_ZERO_COPY_RX_PBUFS) || defined(__DOXYGEN__)
+#define LWIP_ZERO_COPY_RX_PBUFS             2
+#endif
+
 /**
  * @brief   MAC Address byte 0.
  */
@@ -0,0 +1,286 @@
+/*
+    ChibiOS - Copyright (C) 2006..2018 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+/**
+ * @file    ramdisk.c
+ * @brief   RAM disk block device code.
+ * @details A @p BaseBlockDevice implementation over a RAM area, it can be
+ *          used as a stand-in for real media when testing or benchmarking
+ *          file systems. The number of commands and blocks transferred is
+ *          counted, a fixed latency can be added to each command in order
+ *          to emulate the overhead of real media.
+ *
+ * @addtogroup ram_disk
+ * @{
+ */
+
+#include <string.h>
+
+#include "hal.h"
+#include "ramdisk.h"
+
+/*===========================================================================*/
+/* Module local definitions.                                                 */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Module exported variables.                                                */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Module local types.                                                       */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Module local variables.                                                   */
+/*===========================================================================*/
+
+static bool rd_is_inserted(void *instance) {
+
+  (void)instance;
+
+  return true;
+}
+
+static bool rd_is_protected(void *instance) {
+
+  return ((RamDisk *)instance)->readonly;
+}
+
+static bool rd_connect(void *instance) {
+  RamDisk *rdp = (RamDisk *)instance;
+
+  if (rdp->state == BLK_ACTIVE) {
+    rdp->state = BLK_READY;
+  }
+
+  return HAL_SUCCESS;
+}
+
+static bool rd_disconnect(void *instance) {
+  RamDisk *rdp = (RamDisk *)instance;
+
+  if (rdp->state == BLK_READY) {
+    rdp->state = BLK_ACTIVE;
+  }
+
+  return HAL_SUCCESS;
+}
+
+static bool rd_read(void *instance, uint32_t startblk,
+                    uint8_t *buffer, uint32_t n) {
+  RamDisk *rdp = (RamDisk *)instance;
+
+  if ((startblk >= rdp->blk_num) || (n > rdp->blk_num - startblk)) {
+    return HAL_FAILED;
+  }
+
+  rdp->state = BLK_READING;
+  if (rdp->latency != (sysinterval_t)0) {
+    osalThreadSleep(rdp->latency);
+  }
+  memcpy(buffer, rdp->storage + ((size_t)startblk * rdp->blk_size),
+         (size_t)n * rdp->blk_size);
+  rdp->stats.reads++;
+  rdp->stats.blocks_read += n;
+  rdp->state = BLK_READY;
+
+  return HAL_SUCCESS;
+}
+
+static bool rd_write(void *instance, uint32_t startblk,
+                     const uint8_t *buffer, uint32_t n) {
+  RamDisk *rdp = (RamDisk *)instance;
+
+  if (rdp->readonly ||
+      (startblk >= rdp->blk_num) || (n > rdp->blk_num - startblk)) {
+    return HAL_FAILED;
+  }
+
+  rdp->state = BLK_WRITING;
+  if (rdp->latency != (sysinterval_t)0) {
+    osalThreadSleep(rdp->latency);
+  }
+  memcpy(rdp->storage + ((size_t)startblk * rdp->blk_size), buffer,
+         (size_t)n * rdp->blk_size);
+  rdp->stats.writes++;
+  rdp->stats.blocks_written += n;
+  rdp->state = BLK_READY;
+
+  return HAL_SUCCESS;
+}
+
+static bool rd_sync(void *instance) {
+
+  (void)instance;
+
+  return HAL_SUCCESS;
+}
+
+static bool rd_get_info(void *instance, BlockDeviceInfo *bdip) {
+  RamDisk *rdp = (RamDisk *)instance;
+
+  bdip->blk_size = rdp->blk_size;
+  bdip->blk_num  = rdp->blk_num;
+
+  return HAL_SUCCESS;
+}
+
+static const struct RamDiskVMT vmt = {
+  (size_t)0,
+  rd_is_inserted,
+  rd_is_protected,
+  rd_connect,
+  rd_disconnect,
+  rd_read,
+  rd_write,
+  rd_sync,
+  rd_get_info
+};
+
+/*===========================================================================*/
+/* Module local functions.                                                   */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Module exported functions.                                                */
+/*===========================================================================*/
+
+/**
+ * @brief   RAM disk object initialization.
+ *
+ * @param[out] rdp      pointer to the @p RamDisk object
+ *
+ * @init
+ */
+void ramdiskObjectInit(RamDisk *rdp) {
+
+  rdp->vmt      = &vmt;
+  rdp->state    = BLK_STOP;
+  rdp->storage  = NULL;
+  rdp->blk_size = 0U;
+  rdp->blk_num  = 0U;
+  rdp->readonly = false;
+  rdp->latency  = (sysinterval_t)0;
+  ramdiskResetStats(rdp);
+}
+
+/**
+ * @brief   Starts a RAM disk.
+ * @note    The device is left in the @p BLK_READY state, an explicit
+ *          connection is not required.
+ *
+ * @param[in] rdp       pointer to the @p RamDisk object
+ * @param[in] storage   pointer to the storage area, it must be at least
+ *                      @p blksize * @p blknum bytes large
+ * @param[in] blksize   size of a block in bytes
+ * @param[in] blknum    number of blocks
+ * @param[in] readonly  write protection
+ *
+ * @api
+ */
+void ramdiskStart(RamDisk *rdp, uint8_t *storage, uint32_t blksize,
+                  uint32_t blknum, bool readonly) {
+
+  osalDbgCheck((rdp != NULL) && (storage != NULL) && (blksize > 0U));
+
+  osalSysLock();
+  osalDbgAssert((rdp->state == BLK_STOP) || (rdp->state == BLK_READY),
+                "invalid state");
+  rdp->storage  = storage;
+  rdp->blk_size = blksize;
+  rdp->blk_num  = blknum;
+  rdp->readonly = readonly;
+  rdp->state    = BLK_READY;
+  osalSysUnlock();
+}
+
+/**
+ * @brief   Stops a RAM disk.
+ *
+ * @param[in] rdp       pointer to the @p RamDisk object
+ *
+ * @api
+ */
+void ramdiskStop(RamDisk *rdp) {
+
+  osalDbgCheck(rdp != NULL);
+
+  osalSysLock();
+  osalDbgAssert((rdp->state == BLK_STOP) || (rdp->state == BLK_READY),
+                "invalid state");
+  rdp->storage = NULL;
+  rdp->state   = BLK_STOP;
+  osalSysUnlock();
+}
+
+/**
+ * @brief   Sets the emulated command latency.
+ * @details Each read or write command suspends the caller for the
+ *          specified time, independently of the number of blocks.
+ *
+ * @param[in] rdp       pointer to the @p RamDisk object
+ * @param[in] latency   command latency, zero disables the emulation
+ *
+ * @api
+ */
+void ramdiskSetLatency(RamDisk *rdp, sysinterval_t latency) {
+
+  osalDbgCheck(rdp != NULL);
+
+  osalSysLock();
+  rdp->latency = latency;
+  osalSysUnlock();
+}
+
+/**
+ * @brief   Returns a copy of the commands statistics.
+ *
+ * @param[in] rdp       pointer to the @p RamDisk object
+ * @param[out] statsp   pointer to the @p ramdisk_stats_t structure
+ *                      receiving the statistics
+ *
+ * @api
+ */
+void ramdiskGetStats(RamDisk *rdp, ramdisk_stats_t *statsp) {
+
+  osalDbgCheck((rdp != NULL) && (statsp != NULL));
+
+  osalSysLock();
+  *statsp = rdp->stats;
+  osalSysUnlock();
+}
+
+/**
+ * @brief   Resets the commands statistics.
+ *
+ * @param[in] rdp       pointer to the @p RamDisk object
+ *
+ * @api
+ */
+void ramdiskResetStats(RamDisk *rdp) {
+
+  osalDbgCheck(rdp != NULL);
+
+  osalSysLock();
+  rdp->stats.reads          = 0U;
+  rdp->stats.blocks_read    = 0U;
+  rdp->stats.writes         = 0U;
+  rdp->stats.blocks_written = 0U;
+  osalSysUnlock();
+}
+
+/** @} */
@@ -0,0 +1,146 @@
+/*
+    ChibiOS - Copyright (C) 2006..2018 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+/**
+ * @file    ramdisk.h
+ * @brief   RAM disk block device structures and macros.
+ *
+ * @addtogroup ram_disk
+ * @{
+ */
+
+#ifndef RAMDISK_H
+#define RAMDISK_H
+
+/*===========================================================================*/
+/* Module constants.                                                         */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Module pre-compile time settings.                                         */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Derived constants and error checks.                                       */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Module data structures and types.                                         */
+/*===========================================================================*/
+
+/**
+ * @brief   @p RamDisk specific methods.
+ */
+#define _ramdisk_methods                                                    \
+  _base_block_device_methods
+
+/**
+ * @extends BaseBlockDeviceVMT
+ *
+ * @brief   @p RamDisk virtual methods table.
+ */
+struct RamDiskVMT {
+  _ramdisk_methods
+};
+
+/**
+ * @brief   Type of the RAM disk statistics.
+ */
+typedef struct {
+  /**
+   * @brief   Read commands.
+   */
+  uint32_t              reads;
+  /**
+   * @brief   Blocks read.
+   */
+  uint32_t              blocks_read;
+  /**
+   * @brief   Write commands.
+   */
+  uint32_t              writes;
+  /**
+   * @brief   Blocks written.
+   */
+  uint32_t              blocks_written;
+} ramdisk_stats_t;
+
+/**
+ * @extends BaseBlockDevice
+ *
+ * @brief   Structure representing a RAM disk.
+ */
+typedef struct {
+  /**
+   * @brief   Virtual Methods Table.
+   */
+  const struct RamDiskVMT   *vmt;
+  _base_block_device_data
+  /**
+   * @brief   Storage area.
+   */
+  uint8_t               *storage;
+  /**
+   * @brief   Block size.
+   */
+  uint32_t              blk_size;
+  /**
+   * @brief   Number of blocks.
+   */
+  uint32_t              blk_num;
+  /**
+   * @brief   Write protection.
+   */
+  bool                  readonly;
+  /**
+   * @brief   Emulated latency of each read or write command.
+   */
+  sysinterval_t         latency;
+  /**
+   * @brief   Commands statistics.
+   */
+  ramdisk_stats_t       stats;
+} RamDisk;
+
+/*===========================================================================*/
+/* Module macros.                                                            */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* External declarations.                                                    */
+/*===========================================================================*/
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+  void ramdiskObjectInit(RamDisk *rdp);
+  void ramdiskStart(RamDisk *rdp, uint8_t *storage, uint32_t blksize,
+                    uint32_t blknum, bool readonly);
+  void ramdiskStop(RamDisk *rdp);
+  void ramdiskSetLatency(RamDisk *rdp, sysinterval_t latency);
+  void ramdiskGetStats(RamDisk *rdp, ramdisk_stats_t *statsp);
+  void ramdiskResetStats(RamDisk *rdp);
+#ifdef __cplusplus
+}
+#endif
+
+/*===========================================================================*/
+/* Module inline functions.                                                  */
+/*===========================================================================*/
+
+#endif /* RAMDISK_H */
+
+/** @} */
@@ -0,0 +1,247 @@
+#!/usr/bin/env python3
+#
+#    ChibiOS - Copyright (C) 2006..2018 Giovanni Di Sirio
+#
+#    Licensed under the Apache License, Version 2.0 (the "License");
+#    you may not use this file except in compliance with the License.
+#    You may obtain a copy of the License at
+#
+#        http://www.apache.org/licenses/LICENSE-2.0
+#
+#    Unless required by applicable law or agreed to in writing, software
+#    distributed under the License is distributed on an "AS IS" BASIS,
+#    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+#    See the License for the specific language governing permissions and
+#    limitations under the License.
+#
+
+"""Converts a ChibiOS trace stream into Chrome trace JSON.
+
+The input is the binary stream produced by the trace_stream module, the
+output can be loaded in chrome://tracing or in the Perfetto UI.
+
+Usage: trace2json.py [-o output.json] [--rtfreq HZ] input.bin
+"""
+
+import argparse
+import json
+import sys
+
+TYPE_SWITCH = 1
+TYPE_ISR_ENTER = 2
+TYPE_ISR_LEAVE = 3
+TYPE_HALT = 4
+TYPE_USER = 5
+TYPE_SYNC = 6
+TYPE_VT = 7
+
+TAG_OVERFLOW = 0x08
+TAG_STRING = 0x10
+TAG_THREAD = 0x18
+
+RTSTAMP_RANGE = 1 << 24
+
+STATE_NAMES = ("READY", "CURRENT", "WTSTART", "SUSPENDED", "QUEUED",
+               "WTSEM", "WTMTX", "WTCOND", "SLEEPING", "WTEXIT", "WTOREVT",
+               "WTANDEVT", "SNDMSGQ", "SNDMSG", "WTMSG", "FINAL")
+
+SYNC_NAMES = ("sem wait", "sem signal", "mtx lock", "mtx unlock",
+              "mbx post", "mbx fetch")
+
+# Pseudo thread identifiers for the non-thread tracks.
+TID_ISR = 1
+TID_TIMERS = 2
+TID_UNKNOWN = 3
+
+
+class Reader:
+    def __init__(self, data):
+        self.data = data
+        self.pos = 0
+
+    def eof(self):
+        return self.pos >= len(self.data)
+
+    def u8(self):
+        if self.pos >= len(self.data):
+            raise EOFError
+        b = self.data[self.pos]
+        self.pos += 1
+        return b
+
+    def raw(self, n):
+        if self.pos + n > len(self.data):
+            raise EOFError
+        b = self.data[self.pos:self.pos + n]
+        self.pos += n
+        return b
+
+    def uint(self, n):
+        return int.from_bytes(self.raw(n), "little")
+
+    def varint(self):
+        x = 0
+        shift = 0
+        while True:
+            b = self.u8()
+            x |= (b & 0x7F) << shift
+            shift += 7
+            if b < 0x80:
+                return x
+
+
+class Decoder:
+    def __init__(self, data, rtfreq=None):
+        self.r = Reader(data)
+        if self.r.raw(4) != b"CHTS":
+            raise ValueError("not a ChibiOS trace stream")
+        version = self.r.u8()
+        if version != 1:
+            raise ValueError("unsupported stream version %d" % version)
+        self.psize = self.r.u8()
+        self.tsize = self.r.u8()
+        self.r.u8()
+        self.stfreq = self.r.uint(4)
+        hdr_rtfreq = self.r.uint(4)
+        self.rtfreq = hdr_rtfreq if rtfreq is None else rtfreq
+        self.ticks = 0
+        self.cycles = 0
+        self.strings = {}
+        self.threads = {}
+        self.current = None
+        self.slice_start = None
+        self.events = []
+
+    def ptr(self):
+        return self.r.uint(self.psize)
+
+    def string(self, addr):
+        if addr == 0:
+            return "NULL"
+        return self.strings.get(addr, "0x%x" % addr)
+
+    def tid(self, tp):
+        return TID_UNKNOWN if tp is None else tp
+
+    def timestamp(self, dt, drt):
+        """Returns the event time in microseconds."""
+        self.ticks += dt
+        if self.rtfreq:
+            # The realtime stamp is only 24 bits wide, the system time is
+            # used in order to recover the number of wraps in between.
+            expected = dt * self.rtfreq / self.stfreq
+            wraps = max(0, round((expected - drt) / RTSTAMP_RANGE))
+            self.cycles += drt + wraps * RTSTAMP_RANGE
+            return self.cycles * 1e6 / self.rtfreq
+        return self.ticks * 1e6 / self.stfreq
+
+    def emit(self, **ev):
+        ev.setdefault("pid", 0)
+        self.events.append(ev)
+
+    def instant(self, ts, name, tid, args=None, scope="t"):
+        self.emit(name=name, ph="i", ts=ts, tid=tid, s=scope, args=args or {})
+
+    def event(self, tag):
+        etype = tag & 7
+        state = tag >> 3
+        ts = self.timestamp(self.r.varint(), self.r.varint())
+        if etype == TYPE_SWITCH:
+            ntp = self.ptr()
+            wtobjp = self.ptr()
+            if self.slice_start is not None:
+                self.emit(name="running", ph="X", ts=self.slice_start,
+                          dur=ts - self.slice_start,
+                          tid=self.tid(self.current),
+                          args={"out_state": STATE_NAMES[state]
+                                if state < len(STATE_NAMES) else state,
+                                "wtobjp": "0x%x" % wtobjp})
+            self.current = ntp
+            self.slice_start = ts
+        elif etype in (TYPE_ISR_ENTER, TYPE_ISR_LEAVE):
+            name = self.string(self.ptr())
+            self.emit(name=name, ph="B" if etype == TYPE_ISR_ENTER else "E",
+                      ts=ts, tid=TID_ISR)
+        elif etype == TYPE_HALT:
+            self.instant(ts, "halt", self.tid(self.current),
+                         {"reason": self.string(self.ptr())}, "g")
+        elif etype == TYPE_USER:
+            up1 = self.ptr()
+            up2 = self.ptr()
+            self.instant(ts, "user", self.tid(self.current),
+                         {"up1": "0x%x" % up1, "up2": "0x%x" % up2})
+        elif etype == TYPE_SYNC:
+            objp = self.ptr()
+            z = self.varint_signed()
+            name = SYNC_NAMES[state] if state < len(SYNC_NAMES) else \
+                "sync %d" % state
+            self.instant(ts, name, self.tid(self.current),
+                         {"object": "0x%x" % objp, "value": z})
+        elif etype == TYPE_VT:
+            func = self.ptr()
+            par = self.ptr()
+            self.instant(ts, "vt 0x%x" % func, TID_TIMERS,
+                         {"func": "0x%x" % func, "par": "0x%x" % par})
+
+    def varint_signed(self):
+        z = self.r.varint()
+        return (z >> 1) ^ -(z & 1)
+
+    def decode(self):
+        try:
+            while not self.r.eof():
+                tag = self.r.u8()
+                if tag == TAG_OVERFLOW:
+                    lost = self.r.varint()
+                    ts = (self.cycles * 1e6 / self.rtfreq if self.rtfreq
+                          else self.ticks * 1e6 / self.stfreq)
+                    self.instant(ts, "overflow", TID_UNKNOWN,
+                                 {"lost": lost}, "g")
+                elif tag in (TAG_STRING, TAG_THREAD):
+                    addr = self.ptr()
+                    text = self.r.raw(self.r.u8()).decode("ascii", "replace")
+                    if tag == TAG_STRING:
+                        self.strings[addr] = text
+                    else:
+                        self.threads[addr] = text
+                elif tag & 7:
+                    self.event(tag)
+                else:
+                    raise ValueError("invalid tag 0x%02x at offset %d" %
+                                     (tag, self.r.pos - 1))
+        except EOFError:
+            sys.stderr.write("warning: truncated stream\n")
+
+        meta = [(TID_ISR, "ISRs"), (TID_TIMERS, "Virtual timers"),
+                (TID_UNKNOWN, "Unknown")]
+        seen = {ev["tid"] for ev in self.events}
+        for tp in sorted(seen):
+            if tp > TID_UNKNOWN:
+                meta.append((tp, "%s (0x%x)" % (self.threads.get(tp, "thread"),
+                                                tp)))
+        for tid, name in meta:
+            self.emit(name="thread_name", ph="M", tid=tid,
+                      args={"name": name})
+        return {"traceEvents": self.events, "displayTimeUnit": "ns"}
+
+
+def main():
+    ap = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    ap.add_argument("input", help="binary trace stream")
+    ap.add_argument("-o", "--output", help="output file, default stdout")
+    ap.add_argument("--rtfreq", type=int,
+                    help="realtime counter frequency, overrides the header")
+    args = ap.parse_args()
+
+    with open(args.input, "rb") as f:
+        trace = Decoder(f.read(), args.rtfreq).decode()
+
+    if args.output:
+        with open(args.output, "w") as f:
+            json.dump(trace, f)
+    else:
+        json.dump(trace, sys.stdout)
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,377 @@
+/*
+    ChibiOS - Copyright (C) 2006..2018 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+/**
+ * @file    trace_stream.c
+ * @brief   Streaming trace exporter code.
+ *
+ * @addtogroup TRACE_STREAM
+ * @{
+ */
+
+#include "ch.h"
+#include "hal.h"
+#include "trace_stream.h"
+
+/*===========================================================================*/
+/* Module local definitions.                                                 */
+/*===========================================================================*/
+
+/**
+ * @brief   Mask of the realtime stamp field in trace records.
+ */
+#define RTSTAMP_MASK                0x00FFFFFFU
+
+/*===========================================================================*/
+/* Module exported variables.                                                */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Module local types.                                                       */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Module local variables.                                                   */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Module local functions.                                                   */
+/*===========================================================================*/
+
+static uint8_t *put_varint(uint8_t *p, uint32_t x) {
+
+  while (x >= 0x80U) {
+    *p++ = (uint8_t)(x | 0x80U);
+    x >>= 7;
+  }
+  *p++ = (uint8_t)x;
+
+  return p;
+}
+
+static uint8_t *put_u32(uint8_t *p, uint32_t x) {
+
+  *p++ = (uint8_t)x;
+  *p++ = (uint8_t)(x >> 8);
+  *p++ = (uint8_t)(x >> 16);
+  *p++ = (uint8_t)(x >> 24);
+
+  return p;
+}
+
+static uint8_t *put_ptr(uint8_t *p, uintptr_t x) {
+  unsigned i;
+
+  for (i = 0U; i < sizeof (void *); i++) {
+    *p++ = (uint8_t)x;
+    x >>= 8;
+  }
+
+  return p;
+}
+
+static uint8_t *put_string(uint8_t *p, uint8_t tag,
+                           const void *id, const char *s) {
+  uint8_t *lenp;
+  unsigned n = 0U;
+
+  *p++ = tag;
+  p = put_ptr(p, (uintptr_t)id);
+  lenp = p++;
+  while ((n < (unsigned)TRACE_STREAM_STRING_SIZE) && (s[n] != '\0')) {
+    *p++ = (uint8_t)s[n++];
+  }
+  *lenp = (uint8_t)n;
+
+  return p;
+}
+
+/*
+ * Sends a string definition unless the string is known to be already
+ * defined in the stream.
+ */
+static uint8_t *define_string(TraceStreamEncoder *tsep,
+                              uint8_t *p, const char *s) {
+  unsigned i;
+
+  if (s == NULL) {
+    return p;
+  }
+
+  for (i = 0U; i < (unsigned)TRACE_STREAM_STRINGS_NUM; i++) {
+    if (tsep->tse_strings[i] == s) {
+      return p;
+    }
+  }
+
+  tsep->tse_strings[tsep->tse_next] = s;
+  if (++tsep->tse_next >= (unsigned)TRACE_STREAM_STRINGS_NUM) {
+    tsep->tse_next = 0U;
+  }
+
+  return put_string(p, (uint8_t)TRACE_STREAM_TAG_STRING, s, s);
+}
+
+/*===========================================================================*/
+/* Module exported functions.                                                */
+/*===========================================================================*/
+
+/**
+ * @brief   Initializes a trace stream encoder.
+ * @note    An encoder must be initialized each time a new stream is
+ *          started, the first event after the header is encoded relative
+ *          to a zero time stamp.
+ *
+ * @param[out] tsep     pointer to the @p TraceStreamEncoder object
+ *
+ * @api
+ */
+void traceStreamEncoderInit(TraceStreamEncoder *tsep) {
+  unsigned i;
+
+  tsep->tse_time    = (systime_t)0;
+  tsep->tse_rtstamp = 0U;
+  tsep->tse_next    = 0U;
+  for (i = 0U; i < (unsigned)TRACE_STREAM_STRINGS_NUM; i++) {
+    tsep->tse_strings[i] = NULL;
+  }
+}
+
+/**
+ * @brief   Encodes the stream header.
+ *
+ * @param[out] buf      output buffer, at least
+ *                      @p TRACE_STREAM_HEADER_SIZE bytes
+ * @param[in] rtfreq    realtime counter frequency, zero if unknown
+ * @return              The number of bytes written in the buffer.
+ *
+ * @api
+ */
+size_t traceStreamEncodeHeader(uint8_t *buf, uint32_t rtfreq) {
+  uint8_t *p = buf;
+
+  *p++ = (uint8_t)'C';
+  *p++ = (uint8_t)'H';
+  *p++ = (uint8_t)'T';
+  *p++ = (uint8_t)'S';
+  *p++ = (uint8_t)TRACE_STREAM_VERSION;
+  *p++ = (uint8_t)sizeof (void *);
+  *p++ = (uint8_t)sizeof (systime_t);
+  *p++ = 0U;
+  p = put_u32(p, (uint32_t)CH_CFG_ST_FREQUENCY);
+  p = put_u32(p, rtfreq);
+
+  return (size_t)(p - buf);
+}
+
+/**
+ * @brief   Encodes an overflow record.
+ *
+ * @param[out] buf      output buffer, at least
+ *                      @p TRACE_STREAM_RECORD_SIZE bytes
+ * @param[in] n         number of trace records lost
+ * @return              The number of bytes written in the buffer.
+ *
+ * @api
+ */
+size_t traceStreamEncodeOverflow(uint8_t *buf, uint32_t n) {
+  uint8_t *p = buf;
+
+  *p++ = (uint8_t)TRACE_STREAM_TAG_OVERFLOW;
+  p = put_varint(p, n);
+
+  return (size_t)(p - buf);
+}
+
+#if (CH_CFG_USE_REGISTRY == TRUE) || defined(__DOXYGEN__)
+/**
+ * @brief   Encodes a thread name record.
+ * @note    Nothing is encoded for threads without a name.
+ *
+ * @param[out] buf      output buffer, at least
+ *                      @p TRACE_STREAM_RECORD_SIZE bytes
+ * @param[in] tp        pointer to the thread
+ * @return              The number of bytes written in the buffer.
+ *
+ * @api
+ */
+size_t traceStreamEncodeThread(uint8_t *buf, thread_t *tp) {
+  const char *name = chRegGetThreadNameX(tp);
+
+  if (name == NULL) {
+    return (size_t)0;
+  }
+
+  return (size_t)(put_string(buf, (uint8_t)TRACE_STREAM_TAG_THREAD,
+                             tp, name) - buf);
+}
+#endif
+
+/**
+ * @brief   Encodes a trace record.
+ * @details Time stamps are encoded as variable length deltas from the
+ *          previous record, strings are sent once as definitions then
+ *          referred by address.
+ * @note    This function does not use kernel services and can be invoked
+ *          from @p CH_CFG_TRACE_HOOK() in order to implement a streaming
+ *          backend not requiring a drain thread.
+ *
+ * @param[in,out] tsep  pointer to the @p TraceStreamEncoder object
+ * @param[out] buf      output buffer, at least
+ *                      @p TRACE_STREAM_RECORD_SIZE bytes
+ * @param[in] tep       pointer to the trace record
+ * @return              The number of bytes written in the buffer.
+ *
+ * @api
+ */
+size_t traceStreamEncode(TraceStreamEncoder *tsep, uint8_t *buf,
+                         const ch_trace_event_t *tep) {
+  uint8_t *p = buf;
+  uint32_t rtstamp;
+  msg_t msg;
+
+  /* Unused records are skipped.*/
+  if (tep->type == CH_TRACE_TYPE_UNUSED) {
+    return (size_t)0;
+  }
+
+  /* Strings referred by the record are defined first.*/
+  if ((tep->type == CH_TRACE_TYPE_ISR_ENTER) ||
+      (tep->type == CH_TRACE_TYPE_ISR_LEAVE)) {
+    p = define_string(tsep, p, tep->u.isr.name);
+  }
+  else if (tep->type == CH_TRACE_TYPE_HALT) {
+    p = define_string(tsep, p, tep->u.halt.reason);
+  }
+  else {
+    /* Nothing to define.*/
+  }
+
+  /* Tag and time stamps deltas.*/
+  rtstamp = (uint32_t)tep->rtstamp;
+  *p++ = (uint8_t)(tep->type | (tep->state << 3));
+  p = put_varint(p, (uint32_t)chTimeDiffX(tsep->tse_time, tep->time));
+  p = put_varint(p, (rtstamp - tsep->tse_rtstamp) & RTSTAMP_MASK);
+  tsep->tse_time    = tep->time;
+  tsep->tse_rtstamp = rtstamp;
+
+  /* Record-specific payload.*/
+  switch (tep->type) {
+  case CH_TRACE_TYPE_SWITCH:
+    p = put_ptr(p, (uintptr_t)tep->u.sw.ntp);
+    p = put_ptr(p, (uintptr_t)tep->u.sw.wtobjp);
+    break;
+  case CH_TRACE_TYPE_ISR_ENTER:
+  case CH_TRACE_TYPE_ISR_LEAVE:
+    p = put_ptr(p, (uintptr_t)tep->u.isr.name);
+    break;
+  case CH_TRACE_TYPE_HALT:
+    p = put_ptr(p, (uintptr_t)tep->u.halt.reason);
+    break;
+  case CH_TRACE_TYPE_USER:
+    p = put_ptr(p, (uintptr_t)tep->u.user.up1);
+    p = put_ptr(p, (uintptr_t)tep->u.user.up2);
+    break;
+  case CH_TRACE_TYPE_SYNC:
+    /* Messages are zig-zag encoded, small negative values are short.*/
+    msg = tep->u.sync.msg;
+    p = put_ptr(p, (uintptr_t)tep->u.sync.objp);
+    p = put_varint(p, ((uint32_t)msg << 1) ^ (uint32_t)(0 - (msg < 0)));
+    break;
+  case CH_TRACE_TYPE_VT:
+    p = put_ptr(p, (uintptr_t)tep->u.vt.func);
+    p = put_ptr(p, (uintptr_t)tep->u.vt.par);
+    break;
+  default:
+    break;
+  }
+
+  return (size_t)(p - buf);
+}
+
+/**
+ * @brief   Trace stream drain thread.
+ * @details The thread sends the stream header and the names of the
+ *          registered threads then copies the trace buffer content to the
+ *          configured channel, lost records are notified in the stream
+ *          using overflow records.
+ * @note    The thread should run at low priority, the records produced by
+ *          the drain thread itself and by the output channel are streamed
+ *          as well.
+ * @note    The thread can be stopped using @p chThdTerminate().
+ *
+ * @param[in] p         pointer to a @p TraceStreamConfig structure
+ */
+THD_FUNCTION(traceStreamThread, p) {
+  const TraceStreamConfig *tscp = p;
+  BaseSequentialStream *chp = tscp->tsc_channel;
+  TraceStreamEncoder tse;
+  ch_trace_event_t records[TRACE_STREAM_CHUNK_SIZE];
+  uint8_t buf[(TRACE_STREAM_CHUNK_SIZE + 1) * TRACE_STREAM_RECORD_SIZE];
+  uint32_t overflows, lost;
+  size_t i, n, size;
+
+  chDbgCheck((chp != NULL) && (tscp->tsc_period != (sysinterval_t)0));
+
+#if CH_CFG_USE_REGISTRY == TRUE
+  chRegSetThreadName(TRACE_STREAM_THREAD_NAME);
+#endif
+
+  traceStreamEncoderInit(&tse);
+  (void) streamWrite(chp, buf, traceStreamEncodeHeader(buf, tscp->tsc_rtfreq));
+
+#if CH_CFG_USE_REGISTRY == TRUE
+  {
+    thread_t *tp = chRegFirstThread();
+    do {
+      size = traceStreamEncodeThread(buf, tp);
+      if (size > (size_t)0) {
+        (void) streamWrite(chp, buf, size);
+      }
+      tp = chRegNextThread(tp);
+    } while (tp != NULL);
+  }
+#endif
+
+  /* Records produced before the stream start are not reported as lost.*/
+  overflows = chDbgGetTraceOverflowsX();
+
+  while (!chThdShouldTerminateX()) {
+    chSysLock();
+    n    = chDbgReadTraceI(records, (size_t)TRACE_STREAM_CHUNK_SIZE);
+    lost = chDbgGetTraceOverflowsX() - overflows;
+    chSysUnlock();
+
+    size = (size_t)0;
+    if (lost > 0U) {
+      overflows += lost;
+      size += traceStreamEncodeOverflow(&buf[size], lost);
+    }
+    for (i = (size_t)0; i < n; i++) {
+      size += traceStreamEncode(&tse, &buf[size], &records[i]);
+    }
+    if (size > (size_t)0) {
+      (void) streamWrite(chp, buf, size);
+    }
+
+    /* Waiting for more records if the buffer has been emptied.*/
+    if (n < (size_t)TRACE_STREAM_CHUNK_SIZE) {
+      chThdSleep(tscp->tsc_period);
+    }
+  }
+}
+
+/** @} */
@@ -0,0 +1,191 @@
+/*
+    ChibiOS - Copyright (C) 2006..2018 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+/**
+ * @file    trace_stream.h
+ * @brief   Streaming trace exporter header.
+ *
+ * @addtogroup TRACE_STREAM
+ * @{
+ */
+
+#ifndef TRACE_STREAM_H
+#define TRACE_STREAM_H
+
+/*===========================================================================*/
+/* Module constants.                                                         */
+/*===========================================================================*/
+
+/**
+ * @brief   Stream format version.
+ */
+#define TRACE_STREAM_VERSION        1U
+
+/**
+ * @brief   Stream header size.
+ * @details The header is composed of the "CHTS" magic, the format version,
+ *          the sizes of pointers and of @p systime_t, a reserved byte, the
+ *          system tick frequency and the realtime counter frequency, both
+ *          encoded as 32 bits little endian values.
+ */
+#define TRACE_STREAM_HEADER_SIZE    16U
+
+/**
+ * @name    Special records tags
+ * @note    Trace events are encoded with a tag containing the record type
+ *          in bits 0..2 and the record state in bits 3..7, the record type
+ *          is never zero for events.
+ * @{
+ */
+#define TRACE_STREAM_TAG_OVERFLOW   0x08U
+#define TRACE_STREAM_TAG_STRING     0x10U
+#define TRACE_STREAM_TAG_THREAD     0x18U
+/** @} */
+
+/*===========================================================================*/
+/* Module pre-compile time settings.                                         */
+/*===========================================================================*/
+
+/**
+ * @brief   Number of trace records fetched at once by the drain thread.
+ */
+#if !defined(TRACE_STREAM_CHUNK_SIZE) || defined(__DOXYGEN__)
+#define TRACE_STREAM_CHUNK_SIZE     8
+#endif
+
+/**
+ * @brief   Number of string definitions remembered by the encoder.
+ * @details ISR names and halt reasons are sent once as string definitions
+ *          then referred by address, the encoder remembers the last
+ *          strings sent.
+ */
+#if !defined(TRACE_STREAM_STRINGS_NUM) || defined(__DOXYGEN__)
+#define TRACE_STREAM_STRINGS_NUM    16
+#endif
+
+/**
+ * @brief   Maximum length of strings sent in the stream.
+ * @note    Longer strings are truncated.
+ */
+#if !defined(TRACE_STREAM_STRING_SIZE) || defined(__DOXYGEN__)
+#define TRACE_STREAM_STRING_SIZE    32
+#endif
+
+/**
+ * @brief   Drain thread name.
+ */
+#if !defined(TRACE_STREAM_THREAD_NAME) || defined(__DOXYGEN__)
+#define TRACE_STREAM_THREAD_NAME    "trace"
+#endif
+
+/*===========================================================================*/
+/* Derived constants and error checks.                                       */
+/*===========================================================================*/
+
+#if CH_DBG_TRACE_MASK == CH_DBG_TRACE_MASK_DISABLED
+#error "TRACE_STREAM requires CH_DBG_TRACE_MASK"
+#endif
+
+#if (TRACE_STREAM_CHUNK_SIZE < 1) || (TRACE_STREAM_STRINGS_NUM < 1)
+#error "invalid TRACE_STREAM settings"
+#endif
+
+#if (TRACE_STREAM_STRING_SIZE < 1) || (TRACE_STREAM_STRING_SIZE > 127)
+#error "TRACE_STREAM_STRING_SIZE out of range (1..127)"
+#endif
+
+/**
+ * @brief   Worst case size of an encoded record.
+ * @details A string definition followed by an event: two tags, a string
+ *          length, two time stamps deltas, up to three pointers and a
+ *          message encoded as a variable length integer.
+ */
+#define TRACE_STREAM_RECORD_SIZE    (17U + (3U * sizeof (void *)) +         \
+                                     TRACE_STREAM_STRING_SIZE)
+
+/*===========================================================================*/
+/* Module data structures and types.                                         */
+/*===========================================================================*/
+
+/**
+ * @brief   Trace stream encoder state.
+ */
+typedef struct {
+  systime_t             tse_time;           /**< @brief Time stamp of the
+                                                 last event.                */
+  uint32_t              tse_rtstamp;        /**< @brief Realtime stamp of
+                                                 the last event.            */
+  unsigned              tse_next;           /**< @brief Next string slot to
+                                                 be replaced.               */
+  const char            *tse_strings[TRACE_STREAM_STRINGS_NUM];
+                                            /**< @brief Strings already
+                                                 defined in the stream.     */
+} TraceStreamEncoder;
+
+/**
+ * @brief   Trace stream drain thread configuration.
+ */
+typedef struct {
+  BaseSequentialStream  *tsc_channel;       /**< @brief Output channel.     */
+  uint32_t              tsc_rtfreq;         /**< @brief Realtime counter
+                                                 frequency, zero if
+                                                 unknown.                   */
+  sysinterval_t         tsc_period;         /**< @brief Polling period when
+                                                 the trace buffer is
+                                                 empty.                     */
+} TraceStreamConfig;
+
+/*===========================================================================*/
+/* Module macros.                                                            */
+/*===========================================================================*/
+
+/**
+ * @brief   Working area size for the drain thread.
+ */
+#define TRACE_STREAM_WA_SIZE                                                \
+  THD_WORKING_AREA_SIZE(256U + sizeof (TraceStreamEncoder) +               \
+                        (TRACE_STREAM_CHUNK_SIZE *                          \
+                         sizeof (ch_trace_event_t)) +                       \
+                        ((TRACE_STREAM_CHUNK_SIZE + 1) *                    \
+                         TRACE_STREAM_RECORD_SIZE))
+
+/*===========================================================================*/
+/* External declarations.                                                    */
+/*===========================================================================*/
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+  void traceStreamEncoderInit(TraceStreamEncoder *tsep);
+  size_t traceStreamEncodeHeader(uint8_t *buf, uint32_t rtfreq);
+  size_t traceStreamEncodeOverflow(uint8_t *buf, uint32_t n);
+#if (CH_CFG_USE_REGISTRY == TRUE) || defined(__DOXYGEN__)
+  size_t traceStreamEncodeThread(uint8_t *buf, thread_t *tp);
+#endif
+  size_t traceStreamEncode(TraceStreamEncoder *tsep, uint8_t *buf,
+                           const ch_trace_event_t *tep);
+  THD_FUNCTION(traceStreamThread, p);
+#ifdef __cplusplus
+}
+#endif
+
+/*===========================================================================*/
+/* Module inline functions.                                                  */
+/*===========================================================================*/
+
+#endif /* TRACE_STREAM_H */
+
+/** @} */
@@ -0,0 +1,237 @@
+/*
+    ChibiOS - Copyright (C) 2006..2018 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+/**
+ * @file    ram_flash.c
+ * @brief   RAM flash stand-in code.
+ * @details The emulated device behaves like a NOR flash, the erased state
+ *          is all ones and program operations can only clear bits.
+ *
+ * @addtogroup RAM_FLASH
+ * @{
+ */
+
+#include <string.h>
+
+#include "hal.h"
+#include "ram_flash.h"
+
+/*===========================================================================*/
+/* Driver local definitions.                                                 */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Driver exported variables.                                                */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Driver local variables and types.                                         */
+/*===========================================================================*/
+
+static const flash_descriptor_t *rfl_get_descriptor(void *instance);
+static flash_error_t rfl_read(void *instance, flash_offset_t offset,
+                              size_t n, uint8_t *rp);
+static flash_error_t rfl_program(void *instance, flash_offset_t offset,
+                                 size_t n, const uint8_t *pp);
+static flash_error_t rfl_start_erase_all(void *instance);
+static flash_error_t rfl_start_erase_sector(void *instance,
+                                            flash_sector_t sector);
+static flash_error_t rfl_query_erase(void *instance, uint32_t *msec);
+static flash_error_t rfl_verify_erase(void *instance,
+                                      flash_sector_t sector);
+
+/**
+ * @brief   Virtual methods table.
+ */
+static const struct BaseFlashVMT rfl_vmt = {
+  (size_t)0,
+  rfl_get_descriptor, rfl_read, rfl_program,
+  rfl_start_erase_all, rfl_start_erase_sector,
+  rfl_query_erase, rfl_verify_erase
+};
+
+/*===========================================================================*/
+/* Driver local functions.                                                   */
+/*===========================================================================*/
+
+static const flash_descriptor_t *rfl_get_descriptor(void *instance) {
+  RamFlashDriver *devp = (RamFlashDriver *)instance;
+
+  osalDbgCheck(instance != NULL);
+  osalDbgAssert(devp->state == FLASH_READY, "invalid state");
+
+  return &devp->descriptor;
+}
+
+static flash_error_t rfl_read(void *instance, flash_offset_t offset,
+                              size_t n, uint8_t *rp) {
+  RamFlashDriver *devp = (RamFlashDriver *)instance;
+
+  osalDbgCheck((instance != NULL) && (rp != NULL) && (n > 0U));
+  osalDbgCheck((size_t)offset + n <= (size_t)devp->descriptor.size);
+  osalDbgAssert(devp->state == FLASH_READY, "invalid state");
+
+  memcpy((void *)rp, (const void *)&devp->config->buffer[offset], n);
+
+  return FLASH_NO_ERROR;
+}
+
+static flash_error_t rfl_program(void *instance, flash_offset_t offset,
+                                 size_t n, const uint8_t *pp) {
+  RamFlashDriver *devp = (RamFlashDriver *)instance;
+  uint8_t *p;
+
+  osalDbgCheck((instance != NULL) && (pp != NULL) && (n > 0U));
+  osalDbgCheck((size_t)offset + n <= (size_t)devp->descriptor.size);
+  osalDbgAssert(devp->state == FLASH_READY, "invalid state");
+
+  /* Programming can only clear bits, like in a real NOR device.*/
+  p = &devp->config->buffer[offset];
+  while (n > 0U) {
+    *p++ &= *pp++;
+    n--;
+  }
+
+  return FLASH_NO_ERROR;
+}
+
+static flash_error_t rfl_start_erase_all(void *instance) {
+  RamFlashDriver *devp = (RamFlashDriver *)instance;
+
+  osalDbgCheck(instance != NULL);
+  osalDbgAssert(devp->state == FLASH_READY, "invalid state");
+
+  memset((void *)devp->config->buffer, 0xFF, devp->descriptor.size);
+
+  return FLASH_NO_ERROR;
+}
+
+static flash_error_t rfl_start_erase_sector(void *instance,
+                                            flash_sector_t sector) {
+  RamFlashDriver *devp = (RamFlashDriver *)instance;
+
+  osalDbgCheck(instance != NULL);
+  osalDbgCheck(sector < devp->descriptor.sectors_count);
+  osalDbgAssert(devp->state == FLASH_READY, "invalid state");
+
+  memset((void *)&devp->config->buffer[sector * devp->descriptor.sectors_size],
+         0xFF, devp->descriptor.sectors_size);
+
+  return FLASH_NO_ERROR;
+}
+
+static flash_error_t rfl_query_erase(void *instance, uint32_t *msec) {
+  RamFlashDriver *devp = (RamFlashDriver *)instance;
+
+  osalDbgCheck(instance != NULL);
+  osalDbgAssert(devp->state == FLASH_READY, "invalid state");
+
+  /* Erase operations are immediate.*/
+  if (msec != NULL) {
+    *msec = 0U;
+  }
+
+  return FLASH_NO_ERROR;
+}
+
+static flash_error_t rfl_verify_erase(void *instance,
+                                      flash_sector_t sector) {
+  RamFlashDriver *devp = (RamFlashDriver *)instance;
+  const uint8_t *p;
+  uint32_t n;
+
+  osalDbgCheck(instance != NULL);
+  osalDbgCheck(sector < devp->descriptor.sectors_count);
+  osalDbgAssert(devp->state == FLASH_READY, "invalid state");
+
+  p = &devp->config->buffer[sector * devp->descriptor.sectors_size];
+  for (n = 0U; n < devp->descriptor.sectors_size; n++) {
+    if (*p++ != (uint8_t)0xFF) {
+      return FLASH_ERROR_VERIFY;
+    }
+  }
+
+  return FLASH_NO_ERROR;
+}
+
+/*===========================================================================*/
+/* Driver exported functions.                                                */
+/*===========================================================================*/
+
+/**
+ * @brief   Initializes an instance.
+ *
+ * @param[out] devp     pointer to the @p RamFlashDriver object
+ *
+ * @init
+ */
+void rflObjectInit(RamFlashDriver *devp) {
+
+  osalDbgCheck(devp != NULL);
+
+  devp->vmt    = &rfl_vmt;
+  devp->state  = FLASH_STOP;
+  devp->config = NULL;
+}
+
+/**
+ * @brief   Configures and activates a RAM flash driver.
+ * @note    The buffer content is preserved, it is not erased on start.
+ *
+ * @param[in] devp      pointer to the @p RamFlashDriver object
+ * @param[in] config    pointer to the configuration
+ *
+ * @api
+ */
+void rflStart(RamFlashDriver *devp, const RamFlashConfig *config) {
+
+  osalDbgCheck((devp != NULL) && (config != NULL) &&
+               (config->buffer != NULL));
+  osalDbgAssert((devp->state == FLASH_STOP) || (devp->state == FLASH_READY),
+                "invalid state");
+
+  devp->config                   = config;
+  devp->descriptor.attributes    = FLASH_ATTR_ERASED_IS_ONE |
+                                   FLASH_ATTR_MEMORY_MAPPED |
+                                   FLASH_ATTR_REWRITABLE;
+  devp->descriptor.page_size     = 1U;
+  devp->descriptor.sectors_count = config->sectors_count;
+  devp->descriptor.sectors       = NULL;
+  devp->descriptor.sectors_size  = config->sectors_size;
+  devp->descriptor.address       = config->buffer;
+  devp->descriptor.size          = config->sectors_size *
+                                   (uint32_t)config->sectors_count;
+  devp->state                    = FLASH_READY;
+}
+
+/**
+ * @brief   Deactivates a RAM flash driver.
+ *
+ * @param[in] devp      pointer to the @p RamFlashDriver object
+ *
+ * @api
+ */
+void rflStop(RamFlashDriver *devp) {
+
+  osalDbgCheck(devp != NULL);
+  osalDbgAssert((devp->state == FLASH_STOP) || (devp->state == FLASH_READY),
+                "invalid state");
+
+  devp->config = NULL;
+  devp->state  = FLASH_STOP;
+}
+
+/** @} */
@@ -0,0 +1,109 @@
+/*
+    ChibiOS - Copyright (C) 2006..2018 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+/**
+ * @file    ram_flash.h
+ * @brief   RAM flash stand-in header.
+ * @details This driver emulates a NOR flash device using a RAM buffer, it
+ *          is meant for testing flash-based modules on platforms without
+ *          a flash device, for example the simulators.
+ *
+ * @addtogroup RAM_FLASH
+ * @{
+ */
+
+#ifndef RAM_FLASH_H
+#define RAM_FLASH_H
+
+#include "hal_flash.h"
+
+/*===========================================================================*/
+/* Driver constants.                                                         */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Driver pre-compile time settings.                                         */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Derived constants and error checks.                                       */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Driver data structures and types.                                         */
+/*===========================================================================*/
+
+/**
+ * @brief   Type of a RAM flash configuration structure.
+ */
+typedef struct {
+  /**
+   * @brief   Buffer used as flash array.
+   * @note    The buffer size must be @p sectors_size * @p sectors_count.
+   */
+  uint8_t                   *buffer;
+  /**
+   * @brief   Size of the emulated sectors.
+   */
+  uint32_t                  sectors_size;
+  /**
+   * @brief   Number of emulated sectors.
+   */
+  flash_sector_t            sectors_count;
+} RamFlashConfig;
+
+/**
+ * @extends BaseFlash
+ *
+ * @brief   Type of a RAM flash driver.
+ */
+typedef struct {
+  /**
+   * @brief   RamFlashDriver Virtual Methods Table.
+   */
+  const struct BaseFlashVMT *vmt;
+  _base_flash_data
+  /**
+   * @brief   Current configuration data.
+   */
+  const RamFlashConfig      *config;
+  /**
+   * @brief   Device descriptor.
+   */
+  flash_descriptor_t        descriptor;
+} RamFlashDriver;
+
+/*===========================================================================*/
+/* Driver macros.                                                            */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* External declarations.                                                    */
+/*===========================================================================*/
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+  void rflObjectInit(RamFlashDriver *devp);
+  void rflStart(RamFlashDriver *devp, const RamFlashConfig *config);
+  void rflStop(RamFlashDriver *devp);
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* RAM_FLASH_H */
+
+/** @} */
@@ -24,6 +24,7 @@
  * - @subpage mfs_test_sequence_001
  * - @subpage mfs_test_sequence_002
  * - @subpage mfs_test_sequence_003
+ * - @subpage mfs_test_sequence_004
  * .
  */
 
@@ -48,6 +49,9 @@ const testsequence_t * const mfs_test_suite_array[] = {
   &mfs_test_sequence_001,
   &mfs_test_sequence_002,
   &mfs_test_sequence_003,
+#if ((MFS_CFG_USE_CHECKPOINTS == TRUE) || (MFS_CFG_USE_INCREMENTAL_GC == TRUE)) || defined(__DOXYGEN__)
+  &mfs_test_sequence_004,
+#endif
   NULL
 };
 
@@ -0,0 +1,558 @@
+/*
+    ChibiOS - Copyright (C) 2006..2018 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+#include "hal.h"
+#include "mfs_test_root.h"
+
+/**
+ * @file    mfs_test_sequence_004.c
+ * @brief   Test Sequence 004 code.
+ *
+ * @page mfs_test_sequence_004 [4] Checkpoints and incremental garbage collection tests
+ *
+ * File: @ref mfs_test_sequence_004.c
+ *
+ * <h2>Description</h2>
+ * The records index checkpoints and the incremental garbage collection
+ * are tested.
+ *
+ * <h2>Conditions</h2>
+ * This sequence is only executed if the following preprocessor condition
+ * evaluates to true:
+ * - (MFS_CFG_USE_CHECKPOINTS == TRUE) || (MFS_CFG_USE_INCREMENTAL_GC == TRUE)
+ * .
+ *
+ * <h2>Test Cases</h2>
+ * - @subpage mfs_test_004_001
+ * - @subpage mfs_test_004_002
+ * - @subpage mfs_test_004_003
+ * - @subpage mfs_test_004_004
+ * .
+ */
+
+#if ((MFS_CFG_USE_CHECKPOINTS == TRUE) || (MFS_CFG_USE_INCREMENTAL_GC == TRUE)) || defined(__DOXYGEN__)
+
+/****************************************************************************
+ * Shared code.
+ ****************************************************************************/
+
+#include <string.h>
+#include "hal_mfs.h"
+
+static bool record_check(mfs_id_t id, const uint8_t *p, size_t n) {
+  size_t size = sizeof mfs_buffer;
+
+  if (mfsReadRecord(&mfs1, id, &size, mfs_buffer) != MFS_NO_ERROR) {
+    return false;
+  }
+  return (size == n) && (memcmp(p, mfs_buffer, n) == 0);
+}
+
+static bool record_erased(mfs_id_t id) {
+  size_t size = sizeof mfs_buffer;
+
+  return mfsReadRecord(&mfs1, id, &size, mfs_buffer) == MFS_ERR_NOT_FOUND;
+}
+
+#if MFS_CFG_USE_CHECKPOINTS == TRUE
+static const uint8_t zeros[4] = {0, 0, 0, 0};
+
+static flash_error_t checkpoints_erase(void) {
+  flash_sector_t sector = mfscfg1.checkpoint_start;
+  flash_sector_t n      = mfscfg1.checkpoint_sectors;
+
+  while (n--) {
+    flash_error_t ferr;
+
+    ferr = flashStartEraseSector(mfscfg1.flashp, sector);
+    if (ferr != FLASH_NO_ERROR)
+      return ferr;
+    ferr = flashWaitErase(mfscfg1.flashp);
+    if (ferr != FLASH_NO_ERROR)
+      return ferr;
+    sector++;
+  }
+  return FLASH_NO_ERROR;
+}
+#endif
+
+#if MFS_CFG_USE_INCREMENTAL_GC == TRUE
+static mfs_error_t gc_cycle_start(void) {
+  unsigned i;
+
+  for (i = 0; i < 1000U; i++) {
+    mfs_error_t err;
+
+    err = mfsWriteRecord(&mfs1, (mfs_id_t)(i % 4U) + 1U,
+                         sizeof mfs_pattern32, mfs_pattern32);
+    if (err != MFS_NO_ERROR)
+      return err;
+    err = mfsPerformGarbageCollectionStep(&mfs1, 1U);
+    if (err != MFS_NO_ERROR)
+      return err;
+  }
+  return MFS_NO_ERROR;
+}
+#endif
+
+/****************************************************************************
+ * Test cases.
+ ****************************************************************************/
+
+#if (MFS_CFG_USE_CHECKPOINTS == TRUE) || defined(__DOXYGEN__)
+/**
+ * @page mfs_test_004_001 [4.1] Mount from checkpoint
+ *
+ * <h2>Description</h2>
+ * A checkpoint of the records index is written, the mount procedure is
+ * expected to restore the index from the checkpoint and to scan only
+ * the records written after it.
+ *
+ * <h2>Conditions</h2>
+ * This test is only executed if the following preprocessor condition
+ * evaluates to true:
+ * - MFS_CFG_USE_CHECKPOINTS == TRUE
+ * .
+ *
+ * <h2>Test Steps</h2>
+ * - [4.1.1] Writing record 1 twice and record 2, the offset of the
+ *   obsolete instance of record 1 is saved.
+ * - [4.1.2] Writing a checkpoint then erasing record 2 and creating
+ *   record 3, MFS_NO_ERROR is expected.
+ * - [4.1.3] Corrupting the obsolete instance of record 1 then mounting
+ *   again, the corrupted data is before the checkpoint so it is not
+ *   scanned, MFS_NO_ERROR is expected and the records must be as
+ *   expected.
+ * - [4.1.4] Erasing the checkpoints area then mounting again, the
+ *   whole bank is scanned and the corrupted data is detected,
+ *   MFS_WARN_REPAIR is expected and the records must be as expected.
+ * .
+ */
+
+static void mfs_test_004_001_setup(void) {
+  bank_erase(MFS_BANK_0);
+  bank_erase(MFS_BANK_1);
+  mfsStart(&mfs1, &mfscfg1);
+}
+
+static void mfs_test_004_001_teardown(void) {
+  mfsStop(&mfs1);
+}
+
+static void mfs_test_004_001_execute(void) {
+  mfs_error_t err;
+  flash_offset_t old_offset;
+
+  /* [4.1.1] Writing record 1 twice and record 2, the offset of the
+     obsolete instance of record 1 is saved.*/
+  test_set_step(1);
+  {
+    err = mfsWriteRecord(&mfs1, 1, sizeof mfs_pattern16, mfs_pattern16);
+    test_assert(err == MFS_NO_ERROR, "error creating record 1");
+    old_offset = mfs1.descriptors[0].offset;
+    err = mfsWriteRecord(&mfs1, 1, sizeof mfs_pattern32, mfs_pattern32);
+    test_assert(err == MFS_NO_ERROR, "error updating record 1");
+    err = mfsWriteRecord(&mfs1, 2, sizeof mfs_pattern10, mfs_pattern10);
+    test_assert(err == MFS_NO_ERROR, "error creating record 2");
+  }
+  test_end_step(1);
+
+  /* [4.1.2] Writing a checkpoint then erasing record 2 and creating
+     record 3, MFS_NO_ERROR is expected.*/
+  test_set_step(2);
+  {
+    err = mfsWriteCheckpoint(&mfs1);
+    test_assert(err == MFS_NO_ERROR, "error writing checkpoint");
+    err = mfsEraseRecord(&mfs1, 2);
+    test_assert(err == MFS_NO_ERROR, "error erasing record 2");
+    err = mfsWriteRecord(&mfs1, 3, sizeof mfs_pattern16, mfs_pattern16);
+    test_assert(err == MFS_NO_ERROR, "error creating record 3");
+  }
+  test_end_step(2);
+
+  /* [4.1.3] Corrupting the obsolete instance of record 1 then mounting
+     again, the corrupted data is before the checkpoint so it is not
+     scanned, MFS_NO_ERROR is expected and the records must be as
+     expected.*/
+  test_set_step(3);
+  {
+    test_assert(flashProgram(mfscfg1.flashp,
+                             old_offset + sizeof (mfs_data_header_t),
+                             sizeof zeros, zeros) == FLASH_NO_ERROR,
+                "program failed");
+    mfsStop(&mfs1);
+    err = mfsStart(&mfs1, &mfscfg1);
+    test_assert(err == MFS_NO_ERROR, "mount failed");
+    test_assert(record_check(1, mfs_pattern32, sizeof mfs_pattern32),
+                "wrong record 1");
+    test_assert(record_erased(2), "record 2 not erased");
+    test_assert(record_check(3, mfs_pattern16, sizeof mfs_pattern16),
+                "wrong record 3");
+  }
+  test_end_step(3);
+
+  /* [4.1.4] Erasing the checkpoints area then mounting again, the
+     whole bank is scanned and the corrupted data is detected,
+     MFS_WARN_REPAIR is expected and the records must be as expected.*/
+  test_set_step(4);
+  {
+    mfsStop(&mfs1);
+    test_assert(checkpoints_erase() == FLASH_NO_ERROR, "erase failed");
+    err = mfsStart(&mfs1, &mfscfg1);
+    test_assert(err == MFS_WARN_REPAIR, "anomaly not detected");
+    test_assert(record_check(1, mfs_pattern32, sizeof mfs_pattern32),
+                "wrong record 1");
+    test_assert(record_erased(2), "record 2 not erased");
+    test_assert(record_check(3, mfs_pattern16, sizeof mfs_pattern16),
+                "wrong record 3");
+  }
+  test_end_step(4);
+}
+
+static const testcase_t mfs_test_004_001 = {
+  "Mount from checkpoint",
+  mfs_test_004_001_setup,
+  mfs_test_004_001_teardown,
+  mfs_test_004_001_execute
+};
+#endif /* MFS_CFG_USE_CHECKPOINTS == TRUE */
+
+#if (MFS_CFG_USE_CHECKPOINTS == TRUE) || defined(__DOXYGEN__)
+/**
+ * @page mfs_test_004_002 [4.2] Checkpoints area rotation
+ *
+ * <h2>Description</h2>
+ * Checkpoints are written more times than the available slots, the
+ * checkpoints area is erased when full and mounting must always
+ * restore the most recent state.
+ *
+ * <h2>Conditions</h2>
+ * This test is only executed if the following preprocessor condition
+ * evaluates to true:
+ * - MFS_CFG_USE_CHECKPOINTS == TRUE
+ * .
+ *
+ * <h2>Test Steps</h2>
+ * - [4.2.1] Writing a record of increasing size and a checkpoint
+ *   repeatedly, the storage is mounted again after each checkpoint,
+ *   MFS_NO_ERROR is expected and the record must be found.
+ * .
+ */
+
+static void mfs_test_004_002_setup(void) {
+  bank_erase(MFS_BANK_0);
+  bank_erase(MFS_BANK_1);
+  mfsStart(&mfs1, &mfscfg1);
+}
+
+static void mfs_test_004_002_teardown(void) {
+  mfsStop(&mfs1);
+}
+
+static void mfs_test_004_002_execute(void) {
+  unsigned i;
+  mfs_error_t err;
+
+  /* [4.2.1] Writing a record of increasing size and a checkpoint
+     repeatedly, the storage is mounted again after each checkpoint,
+     MFS_NO_ERROR is expected and the record must be found.*/
+  test_set_step(1);
+  {
+    for (i = 0; i < 64U; i++) {
+      err = mfsWriteRecord(&mfs1, 1, (size_t)i + 1U, mfs_pattern512);
+      test_assert(!MFS_IS_ERROR(err), "error writing record");
+      err = mfsWriteCheckpoint(&mfs1);
+      test_assert(err == MFS_NO_ERROR, "error writing checkpoint");
+      mfsStop(&mfs1);
+      err = mfsStart(&mfs1, &mfscfg1);
+      test_assert(err == MFS_NO_ERROR, "mount failed");
+      test_assert(record_check(1, mfs_pattern512, (size_t)i + 1U),
+                  "wrong record content");
+    }
+  }
+  test_end_step(1);
+}
+
+static const testcase_t mfs_test_004_002 = {
+  "Checkpoints area rotation",
+  mfs_test_004_002_setup,
+  mfs_test_004_002_teardown,
+  mfs_test_004_002_execute
+};
+#endif /* MFS_CFG_USE_CHECKPOINTS == TRUE */
+
+#if (MFS_CFG_USE_INCREMENTAL_GC == TRUE) || defined(__DOXYGEN__)
+/**
+ * @page mfs_test_004_003 [4.3] Incremental garbage collection
+ *
+ * <h2>Description</h2>
+ * An incremental garbage collection cycle is performed in steps while
+ * records are written and erased, write operations must not trigger a
+ * full garbage collection.
+ *
+ * <h2>Conditions</h2>
+ * This test is only executed if the following preprocessor condition
+ * evaluates to true:
+ * - MFS_CFG_USE_INCREMENTAL_GC == TRUE
+ * .
+ *
+ * <h2>Test Steps</h2>
+ * - [4.3.1] Updating records until an incremental garbage collection
+ *   cycle is started, MFS_WARN_GC_PENDING is expected.
+ * - [4.3.2] Updating record 1, erasing record 2 and creating record 5
+ *   while performing steps, MFS_NO_ERROR is expected for all
+ *   operations.
+ * - [4.3.3] Performing steps until the cycle is complete, the bank
+ *   must be switched and the old bank must be erased.
+ * - [4.3.4] Checking the records content, then mounting again and
+ *   checking the records content again.
+ * .
+ */
+
+static void mfs_test_004_003_setup(void) {
+  bank_erase(MFS_BANK_0);
+  bank_erase(MFS_BANK_1);
+  mfsStart(&mfs1, &mfscfg1);
+}
+
+static void mfs_test_004_003_teardown(void) {
+  mfsStop(&mfs1);
+}
+
+static void mfs_test_004_003_execute(void) {
+  unsigned i;
+  mfs_error_t err;
+  mfs_bank_t bank;
+
+  /* [4.3.1] Updating records until an incremental garbage collection
+     cycle is started, MFS_WARN_GC_PENDING is expected.*/
+  test_set_step(1);
+  {
+    bank = mfs1.current_bank;
+    err = gc_cycle_start();
+    test_assert(err == MFS_WARN_GC_PENDING, "cycle not started");
+  }
+  test_end_step(1);
+
+  /* [4.3.2] Updating record 1, erasing record 2 and creating record 5
+     while performing steps, MFS_NO_ERROR is expected for all
+     operations.*/
+  test_set_step(2);
+  {
+    err = mfsWriteRecord(&mfs1, 1, sizeof mfs_pattern16, mfs_pattern16);
+    test_assert(err == MFS_NO_ERROR, "error updating record 1");
+    err = mfsPerformGarbageCollectionStep(&mfs1, 1U);
+    test_assert(err == MFS_WARN_GC_PENDING, "cycle ended early");
+    err = mfsEraseRecord(&mfs1, 2);
+    test_assert(err == MFS_NO_ERROR, "error erasing record 2");
+    err = mfsPerformGarbageCollectionStep(&mfs1, 1U);
+    test_assert(err == MFS_WARN_GC_PENDING, "cycle ended early");
+    err = mfsWriteRecord(&mfs1, 5, sizeof mfs_pattern10, mfs_pattern10);
+    test_assert(err == MFS_NO_ERROR, "error creating record 5");
+  }
+  test_end_step(2);
+
+  /* [4.3.3] Performing steps until the cycle is complete, the bank
+     must be switched and the old bank must be erased.*/
+  test_set_step(3);
+  {
+    i = 0;
+    do {
+      err = mfsPerformGarbageCollectionStep(&mfs1, 1U);
+      i++;
+    } while ((err == MFS_WARN_GC_PENDING) && (i < 100U));
+    test_assert(err == MFS_NO_ERROR, "cycle not completed");
+    test_assert(mfs1.current_bank != bank, "bank not switched");
+    test_assert(bank_verify_erased(bank) == FLASH_NO_ERROR,
+                "old bank not erased");
+  }
+  test_end_step(3);
+
+  /* [4.3.4] Checking the records content, then mounting again and
+     checking the records content again.*/
+  test_set_step(4);
+  {
+    for (i = 0; i < 2U; i++) {
+      test_assert(record_check(1, mfs_pattern16, sizeof mfs_pattern16),
+                  "wrong record 1");
+      test_assert(record_erased(2), "record 2 not erased");
+      test_assert(record_check(3, mfs_pattern32, sizeof mfs_pattern32),
+                  "wrong record 3");
+      test_assert(record_check(4, mfs_pattern32, sizeof mfs_pattern32),
+                  "wrong record 4");
+      test_assert(record_check(5, mfs_pattern10, sizeof mfs_pattern10),
+                  "wrong record 5");
+      mfsStop(&mfs1);
+      err = mfsStart(&mfs1, &mfscfg1);
+      test_assert(err == MFS_NO_ERROR, "mount failed");
+    }
+  }
+  test_end_step(4);
+}
+
+static const testcase_t mfs_test_004_003 = {
+  "Incremental garbage collection",
+  mfs_test_004_003_setup,
+  mfs_test_004_003_teardown,
+  mfs_test_004_003_execute
+};
+#endif /* MFS_CFG_USE_INCREMENTAL_GC == TRUE */
+
+#if (MFS_CFG_USE_INCREMENTAL_GC == TRUE) || defined(__DOXYGEN__)
+/**
+ * @page mfs_test_004_004 [4.4] Interrupted incremental garbage collection
+ *
+ * <h2>Description</h2>
+ * An incremental garbage collection cycle is interrupted by a new
+ * mount, the incomplete destination bank must be discarded without
+ * losing data.
+ *
+ * <h2>Conditions</h2>
+ * This test is only executed if the following preprocessor condition
+ * evaluates to true:
+ * - MFS_CFG_USE_INCREMENTAL_GC == TRUE
+ * .
+ *
+ * <h2>Test Steps</h2>
+ * - [4.4.1] Updating records until an incremental garbage collection
+ *   cycle is started, MFS_WARN_GC_PENDING is expected.
+ * - [4.4.2] Performing a step and updating record 1 then mounting
+ *   again without completing the cycle, the destination bank must be
+ *   erased, MFS_WARN_REPAIR is expected.
+ * - [4.4.3] Checking the records content, the update performed during
+ *   the cycle must be preserved.
+ * - [4.4.4] Starting a new cycle and completing it using
+ *   mfsPerformGarbageCollection(), MFS_NO_ERROR is expected and the
+ *   records must be preserved.
+ * .
+ */
+
+static void mfs_test_004_004_setup(void) {
+  bank_erase(MFS_BANK_0);
+  bank_erase(MFS_BANK_1);
+  mfsStart(&mfs1, &mfscfg1);
+}
+
+static void mfs_test_004_004_teardown(void) {
+  mfsStop(&mfs1);
+}
+
+static void mfs_test_004_004_execute(void) {
+  mfs_error_t err;
+  mfs_bank_t bank, other;
+
+  /* [4.4.1] Updating records until an incremental garbage collection
+     cycle is started, MFS_WARN_GC_PENDING is expected.*/
+  test_set_step(1);
+  {
+    bank  = mfs1.current_bank;
+    other = bank == MFS_BANK_0 ? MFS_BANK_1 : MFS_BANK_0;
+    err = gc_cycle_start();
+    test_assert(err == MFS_WARN_GC_PENDING, "cycle not started");
+  }
+  test_end_step(1);
+
+  /* [4.4.2] Performing a step and updating record 1 then mounting
+     again without completing the cycle, the destination bank must be
+     erased, MFS_WARN_REPAIR is expected.*/
+  test_set_step(2);
+  {
+    err = mfsPerformGarbageCollectionStep(&mfs1, 1U);
+    test_assert(err == MFS_WARN_GC_PENDING, "cycle ended early");
+    err = mfsWriteRecord(&mfs1, 1, sizeof mfs_pattern16, mfs_pattern16);
+    test_assert(err == MFS_NO_ERROR, "error updating record 1");
+    mfsStop(&mfs1);
+    err = mfsStart(&mfs1, &mfscfg1);
+    test_assert(err == MFS_WARN_REPAIR, "unexpected mount result");
+    test_assert(mfs1.current_bank == bank, "bank switched");
+    test_assert(bank_verify_erased(other) == FLASH_NO_ERROR,
+                "destination bank not erased");
+  }
+  test_end_step(2);
+
+  /* [4.4.3] Checking the records content, the update performed during
+     the cycle must be preserved.*/
+  test_set_step(3);
+  {
+    test_assert(record_check(1, mfs_pattern16, sizeof mfs_pattern16),
+                "wrong record 1");
+    test_assert(record_check(2, mfs_pattern32, sizeof mfs_pattern32),
+                "wrong record 2");
+    test_assert(record_check(3, mfs_pattern32, sizeof mfs_pattern32),
+                "wrong record 3");
+    test_assert(record_check(4, mfs_pattern32, sizeof mfs_pattern32),
+                "wrong record 4");
+  }
+  test_end_step(3);
+
+  /* [4.4.4] Starting a new cycle and completing it using
+     mfsPerformGarbageCollection(), MFS_NO_ERROR is expected and the
+     records must be preserved.*/
+  test_set_step(4);
+  {
+    err = mfsPerformGarbageCollectionStep(&mfs1, 1U);
+    test_assert(err == MFS_WARN_GC_PENDING, "cycle not started");
+    err = mfsPerformGarbageCollection(&mfs1);
+    test_assert(err == MFS_NO_ERROR, "garbage collection failed");
+    test_assert(mfs1.gc_state == MFS_GC_IDLE, "cycle not completed");
+    test_assert(record_check(1, mfs_pattern16, sizeof mfs_pattern16),
+                "wrong record 1");
+    test_assert(record_check(4, mfs_pattern32, sizeof mfs_pattern32),
+                "wrong record 4");
+  }
+  test_end_step(4);
+}
+
+static const testcase_t mfs_test_004_004 = {
+  "Interrupted incremental garbage collection",
+  mfs_test_004_004_setup,
+  mfs_test_004_004_teardown,
+  mfs_test_004_004_execute
+};
+#endif /* MFS_CFG_USE_INCREMENTAL_GC == TRUE */
+
+/****************************************************************************
+ * Exported data.
+ ****************************************************************************/
+
+/**
+ * @brief   Array of test cases.
+ */
+const testcase_t * const mfs_test_sequence_004_array[] = {
+#if (MFS_CFG_USE_CHECKPOINTS == TRUE) || defined(__DOXYGEN__)
+  &mfs_test_004_001,
+#endif
+#if (MFS_CFG_USE_CHECKPOINTS == TRUE) || defined(__DOXYGEN__)
+  &mfs_test_004_002,
+#endif
+#if (MFS_CFG_USE_INCREMENTAL_GC == TRUE) || defined(__DOXYGEN__)
+  &mfs_test_004_003,
+#endif
+#if (MFS_CFG_USE_INCREMENTAL_GC == TRUE) || defined(__DOXYGEN__)
+  &mfs_test_004_004,
+#endif
+  NULL
+};
+
+/**
+ * @brief   Checkpoints and incremental garbage collection tests.
+ */
+const testsequence_t mfs_test_sequence_004 = {
+  "Checkpoints and incremental garbage collection tests",
+  mfs_test_sequence_004_array
+};
+
+#endif /* (MFS_CFG_USE_CHECKPOINTS == TRUE) || (MFS_CFG_USE_INCREMENTAL_GC == TRUE) */
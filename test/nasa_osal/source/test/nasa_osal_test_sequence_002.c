@@ -20,6 +20,7 @@
  * - @subpage nasa_osal_test_002_002
  * - @subpage nasa_osal_test_002_003
  * - @subpage nasa_osal_test_002_004
+ * - @subpage nasa_osal_test_002_005
  * .
  */
 
@@ -368,6 +369,134 @@ static const testcase_t nasa_osal_test_002_004 = {
   nasa_osal_test_002_004_execute
 };
 
+/**
+ * @page nasa_osal_test_002_005 [2.5] OS_QueueReserve() and OS_QueueFetch() zero-copy functionality
+ *
+ * <h2>Description</h2>
+ * Messages are written in place into reserved buffers and retrieved
+ * without copy, buffers exhaustion and invalid pointers are checked.
+ *
+ * <h2>Test Steps</h2>
+ * - [2.5.1] Creating a queue with depth 2 and retrieving it by name.
+ * - [2.5.2] Reserving all buffers then a further reservation in
+ *   non-blocking mode, an error is expected.
+ * - [2.5.3] Committing the messages with invalid parameters then in
+ *   order, errors are expected on invalid parameters.
+ * - [2.5.4] Fetching and releasing the messages, the order and the
+ *   content are checked.
+ * - [2.5.5] Copy and zero-copy operations are mixed on the same queue.
+ * .
+ */
+
+static void nasa_osal_test_002_005_setup(void) {
+  qid = 0;
+}
+
+static void nasa_osal_test_002_005_teardown(void) {
+  if (qid != 0) {
+    (void) OS_QueueDelete(qid);
+  }
+}
+
+static void nasa_osal_test_002_005_execute(void) {
+  void *msg1, *msg2, *msg3;
+
+  /* [2.5.1] Creating a queue with depth 2 and retrieving it by name.*/
+  test_set_step(1);
+  {
+    int32 err;
+    uint32 local_qid;
+
+    err = OS_QueueCreate(&qid, "zero copy queue", 2, MESSAGE_SIZE, 0);
+    test_assert(err == OS_SUCCESS, "queue creation failed");
+
+    err = OS_QueueGetIdByName(&local_qid, "zero copy queue");
+    test_assert(err == OS_SUCCESS, "queue not found");
+    test_assert(local_qid == qid, "wrong queue id");
+  }
+
+  /* [2.5.2] Reserving all buffers then a further reservation in
+     non-blocking mode, an error is expected.*/
+  test_set_step(2);
+  {
+    int32 err;
+
+    err = OS_QueueReserve(qid, &msg1, OS_CHECK);
+    test_assert(err == OS_SUCCESS, "reservation failed");
+    err = OS_QueueReserve(qid, &msg2, OS_CHECK);
+    test_assert(err == OS_SUCCESS, "reservation failed");
+    err = OS_QueueReserve(qid, &msg3, OS_CHECK);
+    test_assert(err == OS_QUEUE_FULL, "unexpected error code");
+  }
+
+  /* [2.5.3] Committing the messages with invalid parameters then in
+     order, errors are expected on invalid parameters.*/
+  test_set_step(3);
+  {
+    int32 err;
+
+    err = OS_QueueCommit(qid, (char *)msg1 + 1, 6);
+    test_assert(err == OS_INVALID_POINTER, "invalid pointer not detected");
+    err = OS_QueueCommit(qid, msg1, MESSAGE_SIZE + 1);
+    test_assert(err == OS_QUEUE_INVALID_SIZE, "invalid size not detected");
+
+    strcpy(msg1, "Hello");
+    err = OS_QueueCommit(qid, msg1, 6);
+    test_assert(err == OS_SUCCESS, "commit failed");
+    strcpy(msg2, "World");
+    err = OS_QueueCommit(qid, msg2, 6);
+    test_assert(err == OS_SUCCESS, "commit failed");
+  }
+
+  /* [2.5.4] Fetching and releasing the messages, the order and the
+     content are checked.*/
+  test_set_step(4);
+  {
+    int32 err;
+    void *data;
+    uint32 size;
+
+    err = OS_QueueFetch(qid, &data, &size, OS_CHECK);
+    test_assert(err == OS_SUCCESS, "fetch failed");
+    test_assert((size == 6) && (strcmp(data, "Hello") == 0), "wrong message");
+    err = OS_QueueRelease(qid, data);
+    test_assert(err == OS_SUCCESS, "release failed");
+
+    err = OS_QueueFetch(qid, &data, &size, OS_CHECK);
+    test_assert(err == OS_SUCCESS, "fetch failed");
+    test_assert((size == 6) && (strcmp(data, "World") == 0), "wrong message");
+    err = OS_QueueRelease(qid, data);
+    test_assert(err == OS_SUCCESS, "release failed");
+
+    err = OS_QueueFetch(qid, &data, &size, OS_CHECK);
+    test_assert(err == OS_QUEUE_EMPTY, "unexpected error code");
+  }
+
+  /* [2.5.5] Copy and zero-copy operations are mixed on the same queue.*/
+  test_set_step(5);
+  {
+    int32 err;
+    void *data;
+    uint32 size;
+
+    err = OS_QueuePut(qid, "Hello World", 12, 0);
+    test_assert(err == OS_SUCCESS, "put failed");
+    err = OS_QueueFetch(qid, &data, &size, OS_CHECK);
+    test_assert(err == OS_SUCCESS, "fetch failed");
+    test_assert((size == 12) && (strcmp(data, "Hello World") == 0),
+                "wrong message");
+    err = OS_QueueRelease(qid, data);
+    test_assert(err == OS_SUCCESS, "release failed");
+  }
+}
+
+static const testcase_t nasa_osal_test_002_005 = {
+  "OS_QueueReserve() and OS_QueueFetch() zero-copy functionality",
+  nasa_osal_test_002_005_setup,
+  nasa_osal_test_002_005_teardown,
+  nasa_osal_test_002_005_execute
+};
+
 /****************************************************************************
  * Exported data.
  ****************************************************************************/
@@ -380,6 +509,7 @@ const testcase_t * const nasa_osal_test_sequence_002_array[] = {
   &nasa_osal_test_002_002,
   &nasa_osal_test_002_003,
   &nasa_osal_test_002_004,
+  &nasa_osal_test_002_005,
   NULL
 };
 
@@ -107,7 +107,6 @@ static void nasa_osal_test_004_001_execute(void) {
      an error is expected.*/
   test_set_step(4);
   {
-#if 0 /* Semaphore name currently not implemented.*/
     int32 err;
 
     err = OS_BinSemCreate(&bsid,
@@ -115,7 +114,6 @@ static void nasa_osal_test_004_001_execute(void) {
                          0,
                          0);
     test_assert(err == OS_ERR_NAME_TOO_LONG, "name limit not detected");
-#endif
   }
 
   /* [4.1.5] OS_BinSemDelete() is invoked with timer_id set to -1, an
@@ -134,15 +132,13 @@ static void nasa_osal_test_004_001_execute(void) {
   test_set_step(6);
   {
     int32 err;
-    uint32 bsid1; /*, bsid2;*/
+    uint32 bsid1, bsid2;
 
     err = OS_BinSemCreate(&bsid1, "my semaphore", 0, 0);
     test_assert(err == OS_SUCCESS, "semaphore creation failed");
 
-#if 0 /* Semaphore name currently not implemented.*/
     err = OS_BinSemCreate(&bsid2, "my semaphore", 0, 0);
     test_assert(err == OS_ERR_NAME_TAKEN, "name conflict not detected");
-#endif
 
     err = OS_BinSemDelete(bsid1);
     test_assert(err == OS_SUCCESS, "semaphore deletion failed");
@@ -38,6 +38,7 @@
  * <h2>Test Cases</h2>
  * - @subpage oslib_test_003_001
  * - @subpage oslib_test_003_002
+ * - @subpage oslib_test_003_003
  * .
  */
 
@@ -98,7 +99,7 @@ static void oslib_test_003_001_execute(void) {
 
     test_assert((pipe1.rdptr == pipe1.buffer) &&
                 (pipe1.wrptr == pipe1.buffer) &&
-                (pipe1.cnt == 0),
+                (chPipeGetUsedCount(&pipe1) == 0),
                 "invalid pipe state");
   }
   test_end_step(1);
@@ -112,7 +113,7 @@ static void oslib_test_003_001_execute(void) {
     test_assert(n == 0, "not reset");
     test_assert((pipe1.rdptr == pipe1.buffer) &&
                 (pipe1.wrptr == pipe1.buffer) &&
-                (pipe1.cnt == 0),
+                (chPipeGetUsedCount(&pipe1) == 0),
                 "invalid pipe state");
   }
   test_end_step(2);
@@ -127,7 +128,7 @@ static void oslib_test_003_001_execute(void) {
     test_assert(n == 0, "not reset");
     test_assert((pipe1.rdptr == pipe1.buffer) &&
                 (pipe1.wrptr == pipe1.buffer) &&
-                (pipe1.cnt == 0),
+                (chPipeGetUsedCount(&pipe1) == 0),
                 "invalid pipe state");
   }
   test_end_step(3);
@@ -138,7 +139,7 @@ static void oslib_test_003_001_execute(void) {
     chPipeResume(&pipe1);
     test_assert((pipe1.rdptr == pipe1.buffer) &&
                 (pipe1.wrptr == pipe1.buffer) &&
-                (pipe1.cnt == 0),
+                (chPipeGetUsedCount(&pipe1) == 0),
                 "invalid pipe state");
   }
   test_end_step(4);
@@ -152,7 +153,7 @@ static void oslib_test_003_001_execute(void) {
     test_assert(n == PIPE_SIZE, "wrong size");
     test_assert((pipe1.rdptr == pipe1.buffer) &&
                 (pipe1.wrptr == pipe1.buffer) &&
-                (pipe1.cnt == PIPE_SIZE),
+                (chPipeGetUsedCount(&pipe1) == PIPE_SIZE),
                 "invalid pipe state");
   }
   test_end_step(5);
@@ -167,7 +168,7 @@ static void oslib_test_003_001_execute(void) {
     test_assert(n == PIPE_SIZE, "wrong size");
     test_assert((pipe1.rdptr == pipe1.buffer) &&
                 (pipe1.wrptr == pipe1.buffer) &&
-                (pipe1.cnt == 0),
+                (chPipeGetUsedCount(&pipe1) == 0),
                 "invalid pipe state");
     test_assert(memcmp(pipe_pattern, buf, PIPE_SIZE) == 0, "content mismatch");
   }
@@ -182,7 +183,7 @@ static void oslib_test_003_001_execute(void) {
     test_assert(n == 4, "wrong size");
     test_assert((pipe1.rdptr != pipe1.wrptr) &&
                 (pipe1.rdptr == pipe1.buffer) &&
-                (pipe1.cnt == 4),
+                (chPipeGetUsedCount(&pipe1) == 4),
                 "invalid pipe state");
   }
   test_end_step(7);
@@ -196,7 +197,7 @@ static void oslib_test_003_001_execute(void) {
     test_assert(n == PIPE_SIZE - 4, "wrong size");
     test_assert((pipe1.rdptr == pipe1.buffer) &&
                 (pipe1.wrptr == pipe1.buffer) &&
-                (pipe1.cnt == PIPE_SIZE),
+                (chPipeGetUsedCount(&pipe1) == PIPE_SIZE),
                 "invalid pipe state");
   }
   test_end_step(8);
@@ -211,7 +212,7 @@ static void oslib_test_003_001_execute(void) {
     test_assert(n == 4, "wrong size");
     test_assert((pipe1.rdptr != pipe1.buffer) &&
                 (pipe1.wrptr == pipe1.buffer) &&
-                (pipe1.cnt == PIPE_SIZE - 4),
+                (chPipeGetUsedCount(&pipe1) == PIPE_SIZE - 4),
                 "invalid pipe state");
     test_assert(memcmp(pipe_pattern, buf, 4) == 0, "content mismatch");
   }
@@ -227,7 +228,7 @@ static void oslib_test_003_001_execute(void) {
     test_assert(n == PIPE_SIZE - 4, "wrong size");
     test_assert((pipe1.rdptr == pipe1.buffer) &&
                 (pipe1.wrptr == pipe1.buffer) &&
-                (pipe1.cnt == 0),
+                (chPipeGetUsedCount(&pipe1) == 0),
                 "invalid pipe state");
     test_assert(memcmp(pipe_pattern, buf, PIPE_SIZE - 4) == 0, "content mismatch");
   }
@@ -242,7 +243,7 @@ static void oslib_test_003_001_execute(void) {
     test_assert(n == 5, "wrong size");
     test_assert((pipe1.rdptr != pipe1.wrptr) &&
                 (pipe1.rdptr == pipe1.buffer) &&
-                (pipe1.cnt == 5),
+                (chPipeGetUsedCount(&pipe1) == 5),
                 "invalid pipe state");
   }
   test_end_step(11);
@@ -257,7 +258,7 @@ static void oslib_test_003_001_execute(void) {
     test_assert(n == 5, "wrong size");
     test_assert((pipe1.rdptr == pipe1.wrptr) &&
                 (pipe1.wrptr != pipe1.buffer) &&
-                (pipe1.cnt == 0),
+                (chPipeGetUsedCount(&pipe1) == 0),
                 "invalid pipe state");
     test_assert(memcmp(pipe_pattern, buf, 5) == 0, "content mismatch");
   }
@@ -272,7 +273,7 @@ static void oslib_test_003_001_execute(void) {
     test_assert(n == PIPE_SIZE, "wrong size");
     test_assert((pipe1.rdptr == pipe1.wrptr) &&
                 (pipe1.wrptr != pipe1.buffer) &&
-                (pipe1.cnt == PIPE_SIZE),
+                (chPipeGetUsedCount(&pipe1) == PIPE_SIZE),
                 "invalid pipe state");
   }
   test_end_step(13);
@@ -287,7 +288,7 @@ static void oslib_test_003_001_execute(void) {
     test_assert(n == PIPE_SIZE, "wrong size");
     test_assert((pipe1.rdptr == pipe1.wrptr) &&
                 (pipe1.wrptr != pipe1.buffer) &&
-                (pipe1.cnt == 0),
+                (chPipeGetUsedCount(&pipe1) == 0),
                 "invalid pipe state");
     test_assert(memcmp(pipe_pattern, buf, PIPE_SIZE) == 0, "content mismatch");
   }
@@ -329,7 +330,7 @@ static void oslib_test_003_002_execute(void) {
     test_assert(n == 0, "wrong size");
     test_assert((pipe1.rdptr == pipe1.buffer) &&
                 (pipe1.wrptr == pipe1.buffer) &&
-                (pipe1.cnt == 0),
+                (chPipeGetUsedCount(&pipe1) == 0),
                 "invalid pipe state");
   }
   test_end_step(1);
@@ -343,7 +344,7 @@ static void oslib_test_003_002_execute(void) {
     test_assert(n == PIPE_SIZE / 2, "wrong size");
     test_assert((pipe1.rdptr == pipe1.wrptr) &&
                 (pipe1.wrptr == pipe1.buffer) &&
-                (pipe1.cnt == PIPE_SIZE / 2),
+                (chPipeGetUsedCount(&pipe1) == PIPE_SIZE / 2),
                 "invalid pipe state");
   }
   test_end_step(2);
@@ -356,6 +357,161 @@ static const testcase_t oslib_test_003_002 = {
   oslib_test_003_002_execute
 };
 
+#if (CH_CFG_PIPES_SPSC == TRUE) || defined(__DOXYGEN__)
+/**
+ * @page oslib_test_003_003 [3.3] Pipes zero-copy API
+ *
+ * <h2>Description</h2>
+ * The zero-copy reserve/commit and peek/release API is tested, regions
+ * must never wrap around the buffer boundary.
+ *
+ * <h2>Conditions</h2>
+ * This test is only executed if the following preprocessor condition
+ * evaluates to true:
+ * - CH_CFG_PIPES_SPSC == TRUE
+ * .
+ *
+ * <h2>Test Steps</h2>
+ * - [3.3.1] Reserving on an empty pipe, the region must cover the
+ *   whole buffer.
+ * - [3.3.2] Filling part of the region in place and committing it.
+ * - [3.3.3] Peeking the queued data, the content must match and the
+ *   pipe state must not change.
+ * - [3.3.4] Releasing part of the data.
+ * - [3.3.5] Reserving at the end of the buffer, the region must stop
+ *   at the buffer boundary.
+ * - [3.3.6] Reserving at the start of the buffer, the region must stop
+ *   at the read pointer.
+ * - [3.3.7] Reserving on a full pipe, a timeout is expected.
+ * - [3.3.8] Peeking and releasing wrapped data, two regions are
+ *   returned.
+ * - [3.3.9] Peeking on an empty pipe, a timeout is expected.
+ * .
+ */
+
+static void oslib_test_003_003_setup(void) {
+  chPipeObjectInit(&pipe1, buffer, PIPE_SIZE);
+}
+
+static void oslib_test_003_003_execute(void) {
+  uint8_t *wp;
+  const uint8_t *rp;
+  size_t n;
+
+  /* [3.3.1] Reserving on an empty pipe, the region must cover the
+     whole buffer.*/
+  test_set_step(1);
+  {
+    wp = chPipeWriteReserveTimeout(&pipe1, &n, TIME_IMMEDIATE);
+    test_assert((wp == buffer) && (n == PIPE_SIZE), "wrong region");
+  }
+  test_end_step(1);
+
+  /* [3.3.2] Filling part of the region in place and committing it.*/
+  test_set_step(2);
+  {
+    memcpy(wp, pipe_pattern, 10);
+    chPipeWriteCommit(&pipe1, 10);
+    test_assert((pipe1.wrptr == buffer + 10) &&
+                (chPipeGetUsedCount(&pipe1) == 10),
+                "invalid pipe state");
+  }
+  test_end_step(2);
+
+  /* [3.3.3] Peeking the queued data, the content must match and the
+     pipe state must not change.*/
+  test_set_step(3);
+  {
+    rp = chPipeReadPeekTimeout(&pipe1, &n, TIME_IMMEDIATE);
+    test_assert((rp == buffer) && (n == 10), "wrong region");
+    test_assert(memcmp(pipe_pattern, rp, 10) == 0, "content mismatch");
+    test_assert(chPipeGetUsedCount(&pipe1) == 10, "invalid pipe state");
+  }
+  test_end_step(3);
+
+  /* [3.3.4] Releasing part of the data.*/
+  test_set_step(4);
+  {
+    chPipeReadRelease(&pipe1, 8);
+    test_assert((pipe1.rdptr == buffer + 8) &&
+                (chPipeGetUsedCount(&pipe1) == 2),
+                "invalid pipe state");
+  }
+  test_end_step(4);
+
+  /* [3.3.5] Reserving at the end of the buffer, the region must stop
+     at the buffer boundary.*/
+  test_set_step(5);
+  {
+    wp = chPipeWriteReserveTimeout(&pipe1, &n, TIME_IMMEDIATE);
+    test_assert((wp == buffer + 10) && (n == PIPE_SIZE - 10), "wrong region");
+    memcpy(wp, pipe_pattern, n);
+    chPipeWriteCommit(&pipe1, n);
+    test_assert((pipe1.wrptr == buffer) &&
+                (chPipeGetUsedCount(&pipe1) == PIPE_SIZE - 8),
+                "invalid pipe state");
+  }
+  test_end_step(5);
+
+  /* [3.3.6] Reserving at the start of the buffer, the region must stop
+     at the read pointer.*/
+  test_set_step(6);
+  {
+    wp = chPipeWriteReserveTimeout(&pipe1, &n, TIME_IMMEDIATE);
+    test_assert((wp == buffer) && (n == 8), "wrong region");
+    memcpy(wp, pipe_pattern, n);
+    chPipeWriteCommit(&pipe1, n);
+    test_assert((pipe1.wrptr == buffer + 8) &&
+                (chPipeGetUsedCount(&pipe1) == PIPE_SIZE),
+                "invalid pipe state");
+  }
+  test_end_step(6);
+
+  /* [3.3.7] Reserving on a full pipe, a timeout is expected.*/
+  test_set_step(7);
+  {
+    wp = chPipeWriteReserveTimeout(&pipe1, &n, TIME_IMMEDIATE);
+    test_assert((wp == NULL) && (n == 0), "not full");
+  }
+  test_end_step(7);
+
+  /* [3.3.8] Peeking and releasing wrapped data, two regions are
+     returned.*/
+  test_set_step(8);
+  {
+    rp = chPipeReadPeekTimeout(&pipe1, &n, TIME_IMMEDIATE);
+    test_assert((rp == buffer + 8) && (n == PIPE_SIZE - 8), "wrong region");
+    test_assert((memcmp(pipe_pattern + 8, rp, 2) == 0) &&
+                (memcmp(pipe_pattern, rp + 2, n - 2) == 0),
+                "content mismatch");
+    chPipeReadRelease(&pipe1, n);
+    rp = chPipeReadPeekTimeout(&pipe1, &n, TIME_IMMEDIATE);
+    test_assert((rp == buffer) && (n == 8), "wrong region");
+    test_assert(memcmp(pipe_pattern, rp, n) == 0, "content mismatch");
+    chPipeReadRelease(&pipe1, n);
+    test_assert((pipe1.rdptr == pipe1.wrptr) &&
+                (chPipeGetUsedCount(&pipe1) == 0),
+                "invalid pipe state");
+  }
+  test_end_step(8);
+
+  /* [3.3.9] Peeking on an empty pipe, a timeout is expected.*/
+  test_set_step(9);
+  {
+    rp = chPipeReadPeekTimeout(&pipe1, &n, TIME_IMMEDIATE);
+    test_assert((rp == NULL) && (n == 0), "not empty");
+  }
+  test_end_step(9);
+}
+
+static const testcase_t oslib_test_003_003 = {
+  "Pipes zero-copy API",
+  oslib_test_003_003_setup,
+  NULL,
+  oslib_test_003_003_execute
+};
+#endif /* CH_CFG_PIPES_SPSC == TRUE */
+
 /****************************************************************************
  * Exported data.
  ****************************************************************************/
@@ -366,6 +522,9 @@ static const testcase_t oslib_test_003_002 = {
 const testcase_t * const oslib_test_sequence_003_array[] = {
   &oslib_test_003_001,
   &oslib_test_003_002,
+#if (CH_CFG_PIPES_SPSC == TRUE) || defined(__DOXYGEN__)
+  &oslib_test_003_003,
+#endif
   NULL
 };
 
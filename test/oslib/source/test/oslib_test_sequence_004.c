@@ -37,6 +37,7 @@
  *
  * <h2>Test Cases</h2>
  * - @subpage oslib_test_004_001
+ * - @subpage oslib_test_004_002
  * .
  */
 
@@ -54,10 +55,29 @@ static msg_t msg_queue[JOBS_QUEUE_SIZE];
 
 static void job_slow(void *arg) {
 
-  test_emit_token((int)arg);
+  test_emit_token((int)(intptr_t)arg);
   chThdSleepMilliseconds(10);
 }
 
+#define JOBS_DISPATCHER_SIZE 8
+
+static jobs_dispatcher_t jd;
+static job_descriptor_t jobs2[JOBS_DISPATCHER_SIZE];
+static job_future_t future;
+
+static void job_emit(void *arg) {
+
+  test_emit_token((int)(intptr_t)arg);
+}
+
+static void job_done(void *arg) {
+
+  (void)arg;
+
+  test_emit_token('e');
+  chJobFutureSetResultX(&future, (msg_t)'f');
+}
+
 static THD_WORKING_AREA(wa1Thread1, 256);
 static THD_WORKING_AREA(wa2Thread1, 256);
 static THD_FUNCTION(Thread1, arg) {
@@ -70,6 +90,15 @@ static THD_FUNCTION(Thread1, arg) {
   } while (msg == MSG_OK);
 }
 
+static THD_FUNCTION(Thread2, arg) {
+
+  (void)arg;
+
+  if (chJobFutureWait(&future) == MSG_OK) {
+    test_emit_token((int)chJobFutureGetResultX(&future));
+  }
+}
+
 /****************************************************************************
  * Test cases.
  ****************************************************************************/
@@ -132,7 +161,7 @@ static void oslib_test_004_001_execute(void) {
     for (i = 0; i < 8; i++) {
       jdp = chJobGet(&jq);
       jdp->jobfunc = job_slow;
-      jdp->jobarg  = (void *)('a' + i);
+      jdp->jobarg  = (void *)(uintptr_t)('a' + i);
       chJobPost(&jq, jdp);
     }
   }
@@ -165,6 +194,120 @@ static const testcase_t oslib_test_004_001 = {
   oslib_test_004_001_execute
 };
 
+#if (CH_CFG_JOBS_LANES >= 4) || defined(__DOXYGEN__)
+/**
+ * @page oslib_test_004_002 [4.2] Dispatcher lanes and futures test
+ *
+ * <h2>Description</h2>
+ * The jobs dispatcher API is tested for functionality, jobs are posted
+ * in reverse priority order and must be executed in lanes order, the
+ * completion function and the future of a job are verified, the
+ * future is waited by two threads and carries the job result.
+ *
+ * <h2>Conditions</h2>
+ * This test is only executed if the following preprocessor condition
+ * evaluates to true:
+ * - CH_CFG_JOBS_LANES >= 4
+ * .
+ *
+ * <h2>Test Steps</h2>
+ * - [4.2.1] Initializing the Jobs Dispatcher object with a batch size
+ *   of two.
+ * - [4.2.2] Starting a worker thread with lower priority and a thread
+ *   waiting on the future with higher priority.
+ * - [4.2.3] Posting jobs in reverse priority order, the lowest priority
+ *   job has a completion function and a future.
+ * - [4.2.4] Waiting on the future, all jobs must have been executed in
+ *   lanes order and both waiting threads must have been released with
+ *   the job result.
+ * - [4.2.5] Posting a null job, the worker thread must exit.
+ * .
+ */
+
+static void oslib_test_004_002_execute(void) {
+  thread_t *tp1, *tp2;
+  msg_t msg;
+
+  /* [4.2.1] Initializing the Jobs Dispatcher object with a batch size
+     of two.*/
+  test_set_step(1);
+  {
+    chJobDispatcherObjectInit(&jd, JOBS_DISPATCHER_SIZE, jobs2, 2);
+    chJobFutureObjectInit(&future);
+  }
+  test_end_step(1);
+
+  /* [4.2.2] Starting a worker thread with lower priority and a thread
+     waiting on the future with higher priority.*/
+  test_set_step(2);
+  {
+    tp1 = chJobDispatcherCreateWorker(&jd, "worker",
+                                      wa1Thread1, sizeof (wa1Thread1),
+                                      chThdGetPriorityX() - 1);
+    tp2 = chThdCreateStatic(wa2Thread1, sizeof (wa2Thread1),
+                            chThdGetPriorityX() + 1, Thread2, NULL);
+  }
+  test_end_step(2);
+
+  /* [4.2.3] Posting jobs in reverse priority order, the lowest priority
+     job has a completion function and a future.*/
+  test_set_step(3);
+  {
+    unsigned i;
+    job_descriptor_t *jdp;
+
+    jdp = chJobDispatcherGet(&jd);
+    jdp->jobfunc  = job_emit;
+    jdp->jobarg   = (void *)(uintptr_t)'d';
+    jdp->donefunc = job_done;
+    jdp->future   = &future;
+    chJobDispatcherPost(&jd, jdp, 3);
+    for (i = 0; i < 3; i++) {
+      jdp = chJobDispatcherGet(&jd);
+      jdp->jobfunc = job_emit;
+      jdp->jobarg  = (void *)(uintptr_t)('c' - i);
+      chJobDispatcherPost(&jd, jdp, 2 - i);
+    }
+  }
+  test_end_step(3);
+
+  /* [4.2.4] Waiting on the future, all jobs must have been executed in
+     lanes order and both waiting threads must have been released with
+     the job result.*/
+  test_set_step(4);
+  {
+    msg = chJobFutureWait(&future);
+    test_assert(msg == MSG_OK, "wrong wait message");
+    test_assert(future.done, "future not completed");
+    test_assert(chJobFutureGetResultX(&future) == (msg_t)'f', "wrong result");
+    chThdWait(tp2);
+    test_assert_sequence("abcdef", "unexpected tokens");
+  }
+  test_end_step(4);
+
+  /* [4.2.5] Posting a null job, the worker thread must exit.*/
+  test_set_step(5);
+  {
+    job_descriptor_t *jdp;
+
+    jdp = chJobDispatcherGet(&jd);
+    jdp->jobfunc = NULL;
+    jdp->jobarg  = NULL;
+    chJobDispatcherPost(&jd, jdp, 0);
+    msg = chThdWait(tp1);
+    test_assert(msg == MSG_JOB_NULL, "wrong exit message");
+  }
+  test_end_step(5);
+}
+
+static const testcase_t oslib_test_004_002 = {
+  "Dispatcher lanes and futures test",
+  NULL,
+  NULL,
+  oslib_test_004_002_execute
+};
+#endif /* CH_CFG_JOBS_LANES >= 4 */
+
 /****************************************************************************
  * Exported data.
  ****************************************************************************/
@@ -174,6 +317,9 @@ static const testcase_t oslib_test_004_001 = {
  */
 const testcase_t * const oslib_test_sequence_004_array[] = {
   &oslib_test_004_001,
+#if (CH_CFG_JOBS_LANES >= 4) || defined(__DOXYGEN__)
+  &oslib_test_004_002,
+#endif
   NULL
 };
 
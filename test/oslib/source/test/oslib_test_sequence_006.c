@@ -37,6 +37,7 @@
  *
  * <h2>Test Cases</h2>
  * - @subpage oslib_test_006_001
+ * - @subpage oslib_test_006_002
  * .
  */
 
@@ -80,11 +81,13 @@ static bool obj_read(objects_cache_t *ocp,
 static bool obj_write(objects_cache_t *ocp,
                       oc_object_t *objp,
                       bool async) {
-  (void)ocp;
-  (void)async;
 
   test_emit_token('A' + objp->obj_key);
 
+  if (async) {
+    chCacheReleaseObject(ocp, objp);
+  }
+
   return false;
 }
 
@@ -243,6 +246,151 @@ static const testcase_t oslib_test_006_001 = {
   oslib_test_006_001_execute
 };
 
+/**
+ * @page oslib_test_006_002 [6.2] Write-back, read-ahead and statistics
+ *
+ * <h2>Description</h2>
+ * Dirty objects are written back by the write-back dispatcher
+ * according to the configured thresholds, then sequential access is
+ * performed with read-ahead enabled. The cache statistics are checked.
+ *
+ * <h2>Test Steps</h2>
+ * - [6.2.1] Cache initialization, write-back thresholds set to 3 and
+ *   1.
+ * - [6.2.2] Getting and releasing three objects marked for lazy write,
+ *   no writes must occur.
+ * - [6.2.3] Calling the write-back dispatcher, the high threshold has
+ *   been reached so the oldest dirty objects must be written until the
+ *   low threshold.
+ * - [6.2.4] Calling the write-back dispatcher again, on timeout all
+ *   the remaining dirty objects must be written.
+ * - [6.2.5] Reading objects sequentially with a read-ahead depth of 2,
+ *   the following objects must be read in advance.
+ * - [6.2.6] Checking the statistics.
+ * - [6.2.7] Looking up objects, a cached object must be returned
+ *   without reading it, a missing object must not be loaded.
+ * .
+ */
+
+static void oslib_test_006_002_execute(void) {
+  uint32_t i;
+  oc_object_t *objp;
+  oc_stats_t stats;
+  msg_t msg;
+
+  /* [6.2.1] Cache initialization, write-back thresholds set to 3 and
+     1.*/
+  test_set_step(1);
+  {
+    chCacheObjectInit(&cache1,
+                      NUM_HASH_ENTRIES,
+                      hash_headers,
+                      NUM_OBJECTS,
+                      sizeof (cached_object_t),
+                      objects,
+                      obj_read,
+                      obj_write);
+    chCacheSetWriteBack(&cache1, 3, 1);
+  }
+  test_end_step(1);
+
+  /* [6.2.2] Getting and releasing three objects marked for lazy write,
+     no writes must occur.*/
+  test_set_step(2);
+  {
+    for (i = 0; i < 3; i++) {
+      objp = chCacheGetObject(&cache1, 0U, i);
+      objp->obj_flags &= ~OC_FLAG_NOTSYNC;
+      objp->obj_flags |= OC_FLAG_LAZYWRITE;
+      chCacheReleaseObject(&cache1, objp);
+    }
+
+    test_assert_sequence("", "unexpected tokens");
+  }
+  test_end_step(2);
+
+  /* [6.2.3] Calling the write-back dispatcher, the high threshold has
+     been reached so the oldest dirty objects must be written until the
+     low threshold.*/
+  test_set_step(3);
+  {
+    msg = chCacheWriteBackTimeout(&cache1, TIME_IMMEDIATE);
+
+    test_assert(msg == MSG_OK, "not signaled");
+    test_assert_sequence("AB", "unexpected tokens");
+  }
+  test_end_step(3);
+
+  /* [6.2.4] Calling the write-back dispatcher again, on timeout all
+     the remaining dirty objects must be written.*/
+  test_set_step(4);
+  {
+    msg = chCacheWriteBackTimeout(&cache1, TIME_IMMEDIATE);
+    chCacheGetStats(&cache1, &stats);
+
+    test_assert(msg == MSG_TIMEOUT, "signaled");
+    test_assert_sequence("C", "unexpected tokens");
+    test_assert(stats.write_backs == 3, "wrong write-backs counter");
+    test_assert(stats.lazy_writes == 0, "wrong lazy writes counter");
+  }
+  test_end_step(4);
+
+  /* [6.2.5] Reading objects sequentially with a read-ahead depth of 2,
+     the following objects must be read in advance.*/
+  test_set_step(5);
+  {
+    chCacheSetReadAhead(&cache1, 2);
+    chCacheResetStats(&cache1);
+    for (i = 10; i < 14; i++) {
+      objp = chCacheGetObject(&cache1, 0U, i);
+      if ((objp->obj_flags & OC_FLAG_NOTSYNC) != 0U) {
+        (void) chCacheReadObject(&cache1, objp, false);
+      }
+      chCacheReleaseObject(&cache1, objp);
+    }
+
+    test_assert_sequence("klmnop", "unexpected tokens");
+  }
+  test_end_step(5);
+
+  /* [6.2.6] Checking the statistics.*/
+  test_set_step(6);
+  {
+    chCacheGetStats(&cache1, &stats);
+
+    test_assert(stats.hits == 2, "wrong hits counter");
+    test_assert(stats.misses == 2, "wrong misses counter");
+    test_assert(stats.read_aheads == 4, "wrong read-aheads counter");
+    test_assert(stats.write_backs == 0, "wrong write-backs counter");
+  }
+  test_end_step(6);
+
+  /* [6.2.7] Looking up objects, a cached object must be returned
+     without reading it, a missing object must not be loaded.*/
+  test_set_step(7);
+  {
+    objp = chCacheLookupObject(&cache1, 0U, 15U);
+    test_assert(objp != NULL, "not found");
+    test_assert((objp->obj_flags & OC_FLAG_NOTSYNC) == 0U, "not in sync");
+    chCacheReleaseObject(&cache1, objp);
+
+    objp = chCacheLookupObject(&cache1, 0U, 100U);
+    test_assert(objp == NULL, "found");
+
+    chCacheGetStats(&cache1, &stats);
+    test_assert(stats.misses == 2, "wrong misses counter");
+    test_assert_sequence("", "unexpected tokens");
+  }
+  test_end_step(7);
+}
+
+static const testcase_t oslib_test_006_002 = {
+  "Write-back, read-ahead and statistics",
+  NULL,
+  NULL,
+  oslib_test_006_002_execute
+};
+
 /****************************************************************************
  * Exported data.
  ****************************************************************************/
@@ -252,6 +400,7 @@ static const testcase_t oslib_test_006_001 = {
  */
 const testcase_t * const oslib_test_sequence_006_array[] = {
   &oslib_test_006_001,
+  &oslib_test_006_002,
   NULL
 };
 
@@ -39,6 +39,8 @@
  * - @subpage oslib_test_007_001
  * - @subpage oslib_test_007_002
  * - @subpage oslib_test_007_003
+ * - @subpage oslib_test_007_004
+ * - @subpage oslib_test_007_005
  * .
  */
 
@@ -50,11 +52,11 @@
 
 #define MEMORY_POOL_SIZE 4
 
-static uint32_t objects[MEMORY_POOL_SIZE];
-static MEMORYPOOL_DECL(mp1, sizeof (uint32_t), PORT_NATURAL_ALIGN, NULL);
+static void *objects[MEMORY_POOL_SIZE];
+static MEMORYPOOL_DECL(mp1, sizeof (void *), PORT_NATURAL_ALIGN, NULL);
 
 #if CH_CFG_USE_SEMAPHORES
-static GUARDEDMEMORYPOOL_DECL(gmp1, sizeof (uint32_t), PORT_NATURAL_ALIGN);
+static GUARDEDMEMORYPOOL_DECL(gmp1, sizeof (void *), PORT_NATURAL_ALIGN);
 #endif
 
 static void *null_provider(size_t size, unsigned align) {
@@ -89,7 +91,7 @@ static void *null_provider(size_t size, unsigned align) {
  */
 
 static void oslib_test_007_001_setup(void) {
-  chPoolObjectInit(&mp1, sizeof (uint32_t), NULL);
+  chPoolObjectInit(&mp1, sizeof (void *), NULL);
 }
 
 static void oslib_test_007_001_execute(void) {
@@ -144,7 +146,7 @@ static void oslib_test_007_001_execute(void) {
      more memory.*/
   test_set_step(7);
   {
-    chPoolObjectInit(&mp1, sizeof (uint32_t), null_provider);
+    chPoolObjectInit(&mp1, sizeof (void *), null_provider);
     test_assert(chPoolAlloc(&mp1) == NULL, "provider returned memory");
   }
   test_end_step(7);
@@ -183,7 +185,7 @@ static const testcase_t oslib_test_007_001 = {
  */
 
 static void oslib_test_007_002_setup(void) {
-  chGuardedPoolObjectInit(&gmp1, sizeof (uint32_t));
+  chGuardedPoolObjectInit(&gmp1, sizeof (void *));
 }
 
 static void oslib_test_007_002_execute(void) {
@@ -266,7 +268,7 @@ static const testcase_t oslib_test_007_002 = {
  */
 
 static void oslib_test_007_003_setup(void) {
-  chGuardedPoolObjectInit(&gmp1, sizeof (uint32_t));
+  chGuardedPoolObjectInit(&gmp1, sizeof (void *));
 }
 
 static void oslib_test_007_003_execute(void) {
@@ -288,6 +290,214 @@ static const testcase_t oslib_test_007_003 = {
 };
 #endif /* CH_CFG_USE_SEMAPHORES */
 
+/**
+ * @page oslib_test_007_004 [7.4] Bulk operations and magazines
+ *
+ * <h2>Description</h2>
+ * The bulk allocation and release functions are tested, then a
+ * magazine is placed in front of the pool and its refill, drain, LIFO
+ * and flush behaviors are tested.
+ *
+ * <h2>Test Steps</h2>
+ * - [7.4.1] Loading the pool with 8 objects.
+ * - [7.4.2] Bulk allocation of more objects than available, only the
+ *   available objects must be returned.
+ * - [7.4.3] Bulk release then partial bulk allocation.
+ * - [7.4.4] Initializing a magazine with capacity 4, the first
+ *   allocation must refill it with half its capacity.
+ * - [7.4.5] Emptying the pool through the magazine.
+ * - [7.4.6] Releasing all objects through the magazine, the oldest
+ *   objects must be drained to the pool in batches.
+ * - [7.4.7] Allocating from the magazine, the most recently released
+ *   object must be returned.
+ * - [7.4.8] Flushing the magazine, all objects must be back in the
+ *   pool.
+ * .
+ */
+
+static void oslib_test_007_004_setup(void) {
+  chPoolObjectInit(&mp1, sizeof (void *), NULL);
+}
+
+static void oslib_test_007_004_execute(void) {
+  unsigned i;
+  void *buf[8];
+  void *objs[9];
+  void *cache[4];
+  pool_magazine_t mag;
+
+  /* [7.4.1] Loading the pool with 8 objects.*/
+  test_set_step(1);
+  {
+    chPoolLoadArray(&mp1, buf, 8);
+  }
+  test_end_step(1);
+
+  /* [7.4.2] Bulk allocation of more objects than available, only the
+     available objects must be returned.*/
+  test_set_step(2);
+  {
+    test_assert(chPoolAllocN(&mp1, objs, 9) == 8, "wrong number of objects");
+    test_assert(chPoolAlloc(&mp1) == NULL, "list not empty");
+  }
+  test_end_step(2);
+
+  /* [7.4.3] Bulk release then partial bulk allocation.*/
+  test_set_step(3);
+  {
+    chPoolFreeN(&mp1, objs, 8);
+    test_assert(chPoolAllocN(&mp1, objs, 3) == 3, "wrong number of objects");
+    chPoolFreeN(&mp1, objs, 3);
+  }
+  test_end_step(3);
+
+  /* [7.4.4] Initializing a magazine with capacity 4, the first
+     allocation must refill it with half its capacity.*/
+  test_set_step(4);
+  {
+    chPoolMagazineObjectInit(&mag, &mp1, cache, 4);
+    objs[0] = chPoolMagazineAlloc(&mag);
+    test_assert(objs[0] != NULL, "allocation failed");
+    test_assert(chPoolMagazineGetCount(&mag) == 1, "wrong cached count");
+  }
+  test_end_step(4);
+
+  /* [7.4.5] Emptying the pool through the magazine.*/
+  test_set_step(5);
+  {
+    for (i = 1; i < 8; i++) {
+      objs[i] = chPoolMagazineAlloc(&mag);
+      test_assert(objs[i] != NULL, "allocation failed");
+    }
+    test_assert(chPoolMagazineAlloc(&mag) == NULL, "list not empty");
+    test_assert(chPoolMagazineGetCount(&mag) == 0, "wrong cached count");
+  }
+  test_end_step(5);
+
+  /* [7.4.6] Releasing all objects through the magazine, the oldest
+     objects must be drained to the pool in batches.*/
+  test_set_step(6);
+  {
+    for (i = 0; i < 8; i++) {
+      chPoolMagazineFree(&mag, objs[i]);
+    }
+    test_assert(chPoolMagazineGetCount(&mag) == 4, "wrong cached count");
+    test_assert(chPoolAlloc(&mp1) == objs[3], "wrong drained object");
+    chPoolFree(&mp1, objs[3]);
+  }
+  test_end_step(6);
+
+  /* [7.4.7] Allocating from the magazine, the most recently released
+     object must be returned.*/
+  test_set_step(7);
+  {
+    test_assert(chPoolMagazineAlloc(&mag) == objs[7], "not LIFO");
+    chPoolMagazineFree(&mag, objs[7]);
+  }
+  test_end_step(7);
+
+  /* [7.4.8] Flushing the magazine, all objects must be back in the
+     pool.*/
+  test_set_step(8);
+  {
+    chPoolMagazineFlush(&mag);
+    test_assert(chPoolMagazineGetCount(&mag) == 0, "wrong cached count");
+    test_assert(chPoolAllocN(&mp1, objs, 9) == 8, "wrong number of objects");
+  }
+  test_end_step(8);
+}
+
+static const testcase_t oslib_test_007_004 = {
+  "Bulk operations and magazines",
+  oslib_test_007_004_setup,
+  NULL,
+  oslib_test_007_004_execute
+};
+
+#if (CH_CFG_USE_SEMAPHORES) || defined(__DOXYGEN__)
+/**
+ * @page oslib_test_007_005 [7.5] Guarded Memory Pools bulk operations
+ *
+ * <h2>Description</h2>
+ * The bulk allocation and release functions of guarded memory pools
+ * are tested.
+ *
+ * <h2>Conditions</h2>
+ * This test is only executed if the following preprocessor condition
+ * evaluates to true:
+ * - CH_CFG_USE_SEMAPHORES
+ * .
+ *
+ * <h2>Test Steps</h2>
+ * - [7.5.1] Adding the objects to the pool using
+ *   chGuardedPoolLoadArray().
+ * - [7.5.2] Bulk allocation of more objects than available, only the
+ *   available objects must be returned without waiting.
+ * - [7.5.3] Bulk release, the counter must be updated.
+ * - [7.5.4] Emptying the pool then trying a bulk allocation with 100mS
+ *   timeout, must fail because the pool is empty.
+ * .
+ */
+
+static void oslib_test_007_005_setup(void) {
+  chGuardedPoolObjectInit(&gmp1, sizeof (void *));
+}
+
+static void oslib_test_007_005_execute(void) {
+  void *objs[MEMORY_POOL_SIZE + 1];
+  cnt_t cnt;
+
+  /* [7.5.1] Adding the objects to the pool using
+     chGuardedPoolLoadArray().*/
+  test_set_step(1);
+  {
+    chGuardedPoolLoadArray(&gmp1, objects, MEMORY_POOL_SIZE);
+  }
+  test_end_step(1);
+
+  /* [7.5.2] Bulk allocation of more objects than available, only the
+     available objects must be returned without waiting.*/
+  test_set_step(2);
+  {
+    test_assert(chGuardedPoolAllocNTimeout(&gmp1, objs, MEMORY_POOL_SIZE + 1,
+                                           TIME_IMMEDIATE) == MEMORY_POOL_SIZE,
+                "wrong number of objects");
+    test_assert(chGuardedPoolAllocTimeout(&gmp1, TIME_IMMEDIATE) == NULL, "list not empty");
+  }
+  test_end_step(2);
+
+  /* [7.5.3] Bulk release, the counter must be updated.*/
+  test_set_step(3);
+  {
+    chGuardedPoolFreeN(&gmp1, objs, MEMORY_POOL_SIZE);
+    chSysLock();
+    cnt = chGuardedPoolGetCounterI(&gmp1);
+    chSysUnlock();
+    test_assert(cnt == (cnt_t)MEMORY_POOL_SIZE, "wrong counter");
+  }
+  test_end_step(3);
+
+  /* [7.5.4] Emptying the pool then trying a bulk allocation with 100mS
+     timeout, must fail because the pool is empty.*/
+  test_set_step(4);
+  {
+    test_assert(chGuardedPoolAllocNTimeout(&gmp1, objs, MEMORY_POOL_SIZE,
+                                           TIME_IMMEDIATE) == MEMORY_POOL_SIZE,
+                "wrong number of objects");
+    test_assert(chGuardedPoolAllocNTimeout(&gmp1, objs, 1, TIME_MS2I(100)) == 0,
+                "list not empty");
+  }
+  test_end_step(4);
+}
+
+static const testcase_t oslib_test_007_005 = {
+  "Guarded Memory Pools bulk operations",
+  oslib_test_007_005_setup,
+  NULL,
+  oslib_test_007_005_execute
+};
+#endif /* CH_CFG_USE_SEMAPHORES */
+
 /****************************************************************************
  * Exported data.
  ****************************************************************************/
@@ -302,6 +512,10 @@ const testcase_t * const oslib_test_sequence_007_array[] = {
 #endif
 #if (CH_CFG_USE_SEMAPHORES) || defined(__DOXYGEN__)
   &oslib_test_007_003,
+#endif
+  &oslib_test_007_004,
+#if (CH_CFG_USE_SEMAPHORES) || defined(__DOXYGEN__)
+  &oslib_test_007_005,
 #endif
   NULL
 };
@@ -38,6 +38,9 @@
  * <h2>Test Cases</h2>
  * - @subpage oslib_test_008_001
  * - @subpage oslib_test_008_002
+ * - @subpage oslib_test_008_003
+ * - @subpage oslib_test_008_004
+ * - @subpage oslib_test_008_005
  * .
  */
 
@@ -50,8 +53,28 @@
 #define ALLOC_SIZE 16
 #define HEAP_SIZE (ALLOC_SIZE * 8)
 
+#define STRESS_BLOCKS 8
+#define STRESS_CYCLES 1000
+
+#if PORT_SUPPORTS_RT == TRUE
+#define stress_now() chSysGetRealtimeCounterX()
+#else
+#define stress_now() (rtcnt_t)0
+#endif
+
 static memory_heap_t test_heap;
 static uint8_t test_heap_buffer[HEAP_SIZE];
+static uint8_t test_heap_buffer2[HEAP_SIZE * 4];
+
+/*
+ * Second region, a gap is left at both ends so that it is never
+ * contiguous to the first region.
+ */
+static void add_second_region(void) {
+
+  chHeapAddRegion(&test_heap, test_heap_buffer2 + CH_HEAP_ALIGNMENT,
+                  sizeof (test_heap_buffer2) - (2U * CH_HEAP_ALIGNMENT));
+}
 
 /****************************************************************************
  * Test cases.
@@ -268,6 +291,281 @@ static const testcase_t oslib_test_008_002 = {
   oslib_test_008_002_execute
 };
 
+/**
+ * @page oslib_test_008_003 [8.3] Multiple regions
+ *
+ * <h2>Description</h2>
+ * A second, non contiguous, memory region is added to an heap.
+ * Allocations not fitting the first region must be served from the
+ * second one.
+ *
+ * <h2>Test Steps</h2>
+ * - [8.3.1] Adding the second region, two free blocks are expected and
+ *   the free space must increase.
+ * - [8.3.2] Allocating a block larger than the first region, it must
+ *   be allocated from the second region.
+ * - [8.3.3] Freeing the block, the heap must return to the previous
+ *   state.
+ * .
+ */
+
+static void oslib_test_008_003_setup(void) {
+  chHeapObjectInit(&test_heap, test_heap_buffer, sizeof(test_heap_buffer));
+}
+
+static void oslib_test_008_003_execute(void) {
+  void *p1;
+  size_t n, total1, total2;
+
+  /* [8.3.1] Adding the second region, two free blocks are expected and
+     the free space must increase.*/
+  test_set_step(1);
+  {
+    (void)chHeapStatus(&test_heap, &total1, NULL);
+    add_second_region();
+    n = chHeapStatus(&test_heap, &total2, NULL);
+    test_assert(n == 2, "wrong number of fragments");
+    test_assert(total2 > total1, "region not added");
+  }
+  test_end_step(1);
+
+  /* [8.3.2] Allocating a block larger than the first region, it must
+     be allocated from the second region.*/
+  test_set_step(2);
+  {
+    p1 = chHeapAlloc(&test_heap, HEAP_SIZE);
+    test_assert(p1 != NULL, "allocation failed");
+    test_assert(((uint8_t *)p1 > test_heap_buffer2) &&
+                ((uint8_t *)p1 < test_heap_buffer2 + sizeof (test_heap_buffer2)),
+                "wrong region");
+  }
+  test_end_step(2);
+
+  /* [8.3.3] Freeing the block, the heap must return to the previous
+     state.*/
+  test_set_step(3);
+  {
+    chHeapFree(p1);
+    n = chHeapStatus(&test_heap, &total1, NULL);
+    test_assert(n == 2, "wrong number of fragments");
+    test_assert(total1 == total2, "free space changed");
+  }
+  test_end_step(3);
+}
+
+static const testcase_t oslib_test_008_003 = {
+  "Multiple regions",
+  oslib_test_008_003_setup,
+  NULL,
+  oslib_test_008_003_execute
+};
+
+/**
+ * @page oslib_test_008_004 [8.4] Fragmentation and latency stress
+ *
+ * <h2>Description</h2>
+ * A pseudo-random sequence of allocations and releases of variable
+ * size is performed on an heap composed of two regions. The worst case
+ * execution times of allocations and releases and the number of failed
+ * allocations are printed. The heap is expected to return to the
+ * initial state after releasing all blocks.
+ *
+ * <h2>Test Steps</h2>
+ * - [8.4.1] Adding the second region then registering the initial
+ *   state.
+ * - [8.4.2] Performing a pseudo-random sequence of allocations and
+ *   releases, the worst case times are measured.
+ * - [8.4.3] Releasing all blocks, the heap must return to the initial
+ *   state.
+ * - [8.4.4] Printing the results.
+ * .
+ */
+
+static void oslib_test_008_004_setup(void) {
+  chHeapObjectInit(&test_heap, test_heap_buffer, sizeof(test_heap_buffer));
+}
+
+static void oslib_test_008_004_execute(void) {
+  void *blocks[STRESS_BLOCKS];
+  unsigned i, fails;
+  uint32_t seed;
+  rtcnt_t amax, fmax;
+  size_t n1, n2, total1, total2;
+
+  /* [8.4.1] Adding the second region then registering the initial
+     state.*/
+  test_set_step(1);
+  {
+    add_second_region();
+    n1 = chHeapStatus(&test_heap, &total1, NULL);
+    for (i = 0; i < STRESS_BLOCKS; i++) {
+      blocks[i] = NULL;
+    }
+  }
+  test_end_step(1);
+
+  /* [8.4.2] Performing a pseudo-random sequence of allocations and
+     releases, the worst case times are measured.*/
+  test_set_step(2);
+  {
+    seed  = 1U;
+    fails = 0U;
+    amax  = (rtcnt_t)0;
+    fmax  = (rtcnt_t)0;
+    for (i = 0; i < STRESS_CYCLES; i++) {
+      unsigned j;
+      rtcnt_t t;
+
+      seed = (seed * 1103515245U) + 12345U;
+      j = (unsigned)(seed >> 16) % STRESS_BLOCKS;
+      if (blocks[j] == NULL) {
+        size_t size = (size_t)((seed >> 8) % (ALLOC_SIZE * 4U)) + 1U;
+
+        t = stress_now();
+        blocks[j] = chHeapAlloc(&test_heap, size);
+        t = stress_now() - t;
+        if (blocks[j] == NULL) {
+          fails++;
+        }
+        if (t > amax) {
+          amax = t;
+        }
+      }
+      else {
+        t = stress_now();
+        chHeapFree(blocks[j]);
+        t = stress_now() - t;
+        blocks[j] = NULL;
+        if (t > fmax) {
+          fmax = t;
+        }
+      }
+    }
+  }
+  test_end_step(2);
+
+  /* [8.4.3] Releasing all blocks, the heap must return to the initial
+     state.*/
+  test_set_step(3);
+  {
+    for (i = 0; i < STRESS_BLOCKS; i++) {
+      if (blocks[i] != NULL) {
+        chHeapFree(blocks[i]);
+      }
+    }
+    n2 = chHeapStatus(&test_heap, &total2, NULL);
+    test_assert(n1 == n2, "fragmentation changed");
+    test_assert(total1 == total2, "free space changed");
+  }
+  test_end_step(3);
+
+  /* [8.4.4] Printing the results.*/
+  test_set_step(4);
+  {
+    test_print("--- Alloc max: ");
+    test_printn((uint32_t)amax);
+    test_println(" cycles");
+    test_print("--- Free max:  ");
+    test_printn((uint32_t)fmax);
+    test_println(" cycles");
+    test_print("--- Failures:  ");
+    test_printn(fails);
+    test_println("");
+  }
+  test_end_step(4);
+}
+
+static const testcase_t oslib_test_008_004 = {
+  "Fragmentation and latency stress",
+  oslib_test_008_004_setup,
+  NULL,
+  oslib_test_008_004_execute
+};
+
+#if (CH_CFG_USE_HEAP_TLSF == TRUE) || defined(__DOXYGEN__)
+/**
+ * @page oslib_test_008_005 [8.5] Allocation limits
+ *
+ * <h2>Description</h2>
+ * Allocations larger than the largest block, by themselves or because
+ * of the space reserved for alignment, must fail without affecting the
+ * heap.
+ *
+ * <h2>Conditions</h2>
+ * This test is only executed if the following preprocessor condition
+ * evaluates to true:
+ * - CH_CFG_USE_HEAP_TLSF == TRUE
+ * .
+ *
+ * <h2>Test Steps</h2>
+ * - [8.5.1] Registering the initial state.
+ * - [8.5.2] Allocating blocks larger than the limit, the allocations
+ *   must fail.
+ * - [8.5.3] Allocating blocks just under the limit with a large
+ *   alignment, the allocations must fail.
+ * - [8.5.4] The heap must be unchanged and still usable.
+ * .
+ */
+
+static void oslib_test_008_005_setup(void) {
+  chHeapObjectInit(&test_heap, test_heap_buffer, sizeof(test_heap_buffer));
+}
+
+static void oslib_test_008_005_execute(void) {
+  size_t limit, size, n1, n2, total1, total2;
+  void *p1;
+
+  /* [8.5.1] Registering the initial state.*/
+  test_set_step(1);
+  {
+    limit = ((size_t)1 << CH_CFG_HEAP_TLSF_FL_MAX) - CH_HEAP_ALIGNMENT;
+    n1 = chHeapStatus(&test_heap, &total1, NULL);
+  }
+  test_end_step(1);
+
+  /* [8.5.2] Allocating blocks larger than the limit, the allocations
+     must fail.*/
+  test_set_step(2);
+  {
+    p1 = chHeapAlloc(&test_heap, limit + 1U);
+    test_assert(p1 == NULL, "allocation not failed");
+    p1 = chHeapAlloc(&test_heap, (size_t)-1);
+    test_assert(p1 == NULL, "allocation not failed");
+  }
+  test_end_step(2);
+
+  /* [8.5.3] Allocating blocks just under the limit with a large
+     alignment, the allocations must fail.*/
+  test_set_step(3);
+  {
+    for (size = limit - 1024U; size <= limit; size += CH_HEAP_ALIGNMENT) {
+      p1 = chHeapAllocAligned(&test_heap, size, 1024U);
+      test_assert(p1 == NULL, "allocation not failed");
+    }
+  }
+  test_end_step(3);
+
+  /* [8.5.4] The heap must be unchanged and still usable.*/
+  test_set_step(4);
+  {
+    n2 = chHeapStatus(&test_heap, &total2, NULL);
+    test_assert(n1 == n2, "fragmentation changed");
+    test_assert(total1 == total2, "free space changed");
+    p1 = chHeapAlloc(&test_heap, ALLOC_SIZE);
+    test_assert(p1 != NULL, "allocation failed");
+    chHeapFree(p1);
+  }
+  test_end_step(4);
+}
+
+static const testcase_t oslib_test_008_005 = {
+  "Allocation limits",
+  oslib_test_008_005_setup,
+  NULL,
+  oslib_test_008_005_execute
+};
+#endif /* CH_CFG_USE_HEAP_TLSF == TRUE */
+
 /****************************************************************************
  * Exported data.
  ****************************************************************************/
@@ -278,6 +576,11 @@ static const testcase_t oslib_test_008_002 = {
 const testcase_t * const oslib_test_sequence_008_array[] = {
   &oslib_test_008_001,
   &oslib_test_008_002,
+  &oslib_test_008_003,
+  &oslib_test_008_004,
+#if (CH_CFG_USE_HEAP_TLSF == TRUE) || defined(__DOXYGEN__)
+  &oslib_test_008_005,
+#endif
   NULL
 };
 
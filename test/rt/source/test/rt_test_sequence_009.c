@@ -42,6 +42,8 @@
  * - @subpage rt_test_009_005
  * - @subpage rt_test_009_006
  * - @subpage rt_test_009_007
+ * - @subpage rt_test_009_008
+ * - @subpage rt_test_009_009
  * .
  */
 
@@ -73,6 +75,18 @@ static THD_FUNCTION(evt_thread7, p) {
   chEvtBroadcast(&es2);
 }
 
+#if CH_CFG_USE_EVENTS_DEFERRED || defined(__DOXYGEN__)
+static event_deferrer_t ed1;
+
+static THD_FUNCTION(evt_thread9, p) {
+  msg_t msg;
+
+  do {
+    msg = chEvtDeferrerDispatch((event_deferrer_t *)p);
+  } while (msg == MSG_OK);
+}
+#endif
+
 /****************************************************************************
  * Test cases.
  ****************************************************************************/
@@ -573,6 +587,210 @@ static const testcase_t rt_test_009_007 = {
   rt_test_009_007_execute
 };
 
+/**
+ * @page rt_test_009_008 [9.8] Broadcasting with flags filtering
+ *
+ * <h2>Description</h2>
+ * Listeners interested in different flags are registered on the same
+ * Event Source, broadcasts must only signal the listeners interested
+ * in the broadcasted flags, also after unregistering some of them.
+ *
+ * <h2>Test Steps</h2>
+ * - [9.8.1] Registering four listeners, two interested in flag 1 and
+ *   two interested in flag 2.
+ * - [9.8.2] Broadcasting flag 1, only the listeners interested in
+ *   flag 1 must be signaled.
+ * - [9.8.3] Unregistering one listener for each flag then
+ *   broadcasting both flags, the remaining listeners must be
+ *   signaled.
+ * - [9.8.4] Unregistering the remaining listeners, the Event Source
+ *   must not have listeners and broadcasts must not signal events.
+ * .
+ */
+
+static void rt_test_009_008_setup(void) {
+  chEvtGetAndClearEvents(ALL_EVENTS);
+  chEvtObjectInit(&es1);
+}
+
+static void rt_test_009_008_execute(void) {
+  eventmask_t m;
+  event_listener_t el1, el2, el3, el4;
+
+  /* [9.8.1] Registering four listeners, two interested in flag 1 and
+     two interested in flag 2.*/
+  test_set_step(1);
+  {
+    chEvtRegisterMaskWithFlags(&es1, &el1, 1, 1);
+    chEvtRegisterMaskWithFlags(&es1, &el2, 2, 2);
+    chEvtRegisterMaskWithFlags(&es1, &el3, 4, 1);
+    chEvtRegisterMaskWithFlags(&es1, &el4, 8, 2);
+  }
+  test_end_step(1);
+
+  /* [9.8.2] Broadcasting flag 1, only the listeners interested in
+     flag 1 must be signaled.*/
+  test_set_step(2);
+  {
+    chEvtBroadcastFlags(&es1, 1);
+    m = chEvtGetAndClearEvents(ALL_EVENTS);
+    test_assert(m == 5, "wrong events");
+    test_assert(chEvtGetAndClearFlags(&el1) == 1, "wrong flags");
+    test_assert(chEvtGetAndClearFlags(&el2) == 0, "wrong flags");
+    test_assert(chEvtGetAndClearFlags(&el3) == 1, "wrong flags");
+    test_assert(chEvtGetAndClearFlags(&el4) == 0, "wrong flags");
+  }
+  test_end_step(2);
+
+  /* [9.8.3] Unregistering one listener for each flag then
+     broadcasting both flags, the remaining listeners must be
+     signaled.*/
+  test_set_step(3);
+  {
+    chEvtUnregister(&es1, &el1);
+    chEvtUnregister(&es1, &el4);
+    chEvtBroadcastFlags(&es1, 3);
+    m = chEvtGetAndClearEvents(ALL_EVENTS);
+    test_assert(m == 6, "wrong events");
+  }
+  test_end_step(3);
+
+  /* [9.8.4] Unregistering the remaining listeners, the Event Source
+     must not have listeners and broadcasts must not signal events.*/
+  test_set_step(4);
+  {
+    chEvtUnregister(&es1, &el3);
+    chEvtUnregister(&es1, &el2);
+    test_assert(!chEvtIsListeningI(&es1), "stuck listener");
+    chEvtBroadcastFlags(&es1, 3);
+    m = chEvtGetAndClearEvents(ALL_EVENTS);
+    test_assert(m == 0, "stuck event");
+  }
+  test_end_step(4);
+}
+
+static const testcase_t rt_test_009_008 = {
+  "Broadcasting with flags filtering",
+  rt_test_009_008_setup,
+  NULL,
+  rt_test_009_008_execute
+};
+
+#if (CH_CFG_USE_EVENTS_DEFERRED) || defined(__DOXYGEN__)
+/**
+ * @page rt_test_009_009 [9.9] Deferred broadcasting
+ *
+ * <h2>Description</h2>
+ * An Event Source with deferred broadcasts is tested, broadcasts must
+ * only accumulate flags and the listeners must be signaled when the
+ * deferrer is dispatched.
+ *
+ * <h2>Conditions</h2>
+ * This test is only executed if the following preprocessor condition
+ * evaluates to true:
+ * - CH_CFG_USE_EVENTS_DEFERRED
+ * .
+ *
+ * <h2>Test Steps</h2>
+ * - [9.9.1] Registering two listeners interested in flag 1 and flag
+ *   2.
+ * - [9.9.2] Broadcasting flags 1 and 2 separately, no events must be
+ *   signaled before dispatching the deferrer.
+ * - [9.9.3] Dispatching the deferrer, both listeners must be signaled
+ *   with the accumulated flags.
+ * - [9.9.4] Dispatching the deferrer again, a timeout is expected.
+ * - [9.9.5] Starting a dispatcher thread at higher priority, a
+ *   broadcast without flags must signal all listeners immediately.
+ * - [9.9.6] Stopping the dispatcher thread and unregistering the
+ *   listeners.
+ * .
+ */
+
+static void rt_test_009_009_setup(void) {
+  chEvtGetAndClearEvents(ALL_EVENTS);
+  chEvtDeferrerObjectInit(&ed1);
+  chEvtObjectInitDeferred(&es1, &ed1);
+}
+
+static void rt_test_009_009_execute(void) {
+  eventmask_t m;
+  msg_t msg;
+  event_listener_t el1, el2;
+
+  /* [9.9.1] Registering two listeners interested in flag 1 and flag
+     2.*/
+  test_set_step(1);
+  {
+    chEvtRegisterMaskWithFlags(&es1, &el1, 1, 1);
+    chEvtRegisterMaskWithFlags(&es1, &el2, 2, 2);
+  }
+  test_end_step(1);
+
+  /* [9.9.2] Broadcasting flags 1 and 2 separately, no events must be
+     signaled before dispatching the deferrer.*/
+  test_set_step(2);
+  {
+    chEvtBroadcastFlags(&es1, 1);
+    chEvtBroadcastFlags(&es1, 2);
+    m = chEvtGetAndClearEvents(ALL_EVENTS);
+    test_assert(m == 0, "premature event");
+  }
+  test_end_step(2);
+
+  /* [9.9.3] Dispatching the deferrer, both listeners must be signaled
+     with the accumulated flags.*/
+  test_set_step(3);
+  {
+    msg = chEvtDeferrerDispatchTimeout(&ed1, TIME_IMMEDIATE);
+    test_assert(msg == MSG_OK, "wrong message");
+    m = chEvtGetAndClearEvents(ALL_EVENTS);
+    test_assert(m == 3, "wrong events");
+    test_assert(chEvtGetAndClearFlags(&el1) == 1, "wrong flags");
+    test_assert(chEvtGetAndClearFlags(&el2) == 2, "wrong flags");
+  }
+  test_end_step(3);
+
+  /* [9.9.4] Dispatching the deferrer again, a timeout is expected.*/
+  test_set_step(4);
+  {
+    msg = chEvtDeferrerDispatchTimeout(&ed1, TIME_IMMEDIATE);
+    test_assert(msg == MSG_TIMEOUT, "wrong message");
+  }
+  test_end_step(4);
+
+  /* [9.9.5] Starting a dispatcher thread at higher priority, a
+     broadcast without flags must signal all listeners immediately.*/
+  test_set_step(5);
+  {
+    threads[0] = chThdCreateStatic(wa[0], WA_SIZE, chThdGetPriorityX() + 1,
+                                   evt_thread9, &ed1);
+    chEvtBroadcast(&es1);
+    m = chEvtGetAndClearEvents(ALL_EVENTS);
+    test_assert(m == 3, "wrong events");
+  }
+  test_end_step(5);
+
+  /* [9.9.6] Stopping the dispatcher thread and unregistering the
+     listeners.*/
+  test_set_step(6);
+  {
+    chThdResume(&ed1.tr, MSG_RESET);
+    test_wait_threads();
+    chEvtUnregister(&es1, &el1);
+    chEvtUnregister(&es1, &el2);
+    test_assert(!chEvtIsListeningI(&es1), "stuck listener");
+  }
+  test_end_step(6);
+}
+
+static const testcase_t rt_test_009_009 = {
+  "Deferred broadcasting",
+  rt_test_009_009_setup,
+  NULL,
+  rt_test_009_009_execute
+};
+#endif /* CH_CFG_USE_EVENTS_DEFERRED */
+
 /****************************************************************************
  * Exported data.
  ****************************************************************************/
@@ -590,6 +808,10 @@ const testcase_t * const rt_test_sequence_009_array[] = {
   &rt_test_009_006,
 #endif
   &rt_test_009_007,
+  &rt_test_009_008,
+#if (CH_CFG_USE_EVENTS_DEFERRED) || defined(__DOXYGEN__)
+  &rt_test_009_009,
+#endif
   NULL
 };
 
@@ -46,6 +46,8 @@
  * - @subpage rt_test_011_010
  * - @subpage rt_test_011_011
  * - @subpage rt_test_011_012
+ * - @subpage rt_test_011_013
+ * - @subpage rt_test_011_014
  * .
  */
 
@@ -62,6 +64,17 @@ static mutex_t mtx1;
 
 static void tmo(void *param) {(void)param;}
 
+#if CH_CFG_USE_TM
+static void bmk_print_tm(const char *name, time_measurement_t *tmp) {
+
+  test_print(name);
+  test_printn((uint32_t)tmp->best);
+  test_print("/");
+  test_printn((uint32_t)tmp->worst);
+  test_println(" RT ticks (best/worst)");
+}
+#endif
+
 #if CH_CFG_USE_MESSAGES
 static THD_FUNCTION(bmk_thread1, p) {
   thread_t *tp;
@@ -1034,6 +1047,191 @@ static const testcase_t rt_test_011_012 = {
   rt_test_011_012_execute
 };
 
+#if (CH_CFG_USE_TM) || defined(__DOXYGEN__)
+/**
+ * @page rt_test_011_013 [11.13] Virtual Timers scalability
+ *
+ * <h2>Description</h2>
+ * An increasing number of virtual timers is armed, for each step the
+ * best and worst case times required to set and reset an additional
+ * timer are measured.<br> The timer being measured has the longest
+ * delay so it is the worst case for a delta list implementation.
+ *
+ * <h2>Conditions</h2>
+ * This test is only executed if the following preprocessor condition
+ * evaluates to true:
+ * - CH_CFG_USE_TM
+ * .
+ *
+ * <h2>Test Steps</h2>
+ * - [11.13.1] The number of timers that can be allocated in the shared
+ *   test buffer is calculated.
+ * - [11.13.2] For each step the timers are armed, the set/reset time of
+ *   an additional timer is measured 64 times, the results are printed
+ *   then the timers are disarmed.
+ * .
+ */
+
+static void rt_test_011_013_execute(void) {
+  static virtual_timer_t vt1;
+  virtual_timer_t *vtp = (virtual_timer_t *)test_buffer;
+  time_measurement_t tmset, tmreset;
+  unsigned i, j, n, ntimers;
+
+  /* [11.13.1] The number of timers that can be allocated in the shared
+     test buffer is calculated.*/
+  test_set_step(1);
+  {
+    ntimers = sizeof (test_buffer) / sizeof (virtual_timer_t);
+    if (ntimers > 256U) {
+      ntimers = 256U;
+    }
+    for (i = 0; i < ntimers; i++) {
+      chVTObjectInit(&vtp[i]);
+    }
+  }
+  test_end_step(1);
+
+  /* [11.13.2] For each step the timers are armed, the set/reset time of
+     an additional timer is measured 64 times, the results are printed
+     then the timers are disarmed.*/
+  test_set_step(2);
+  {
+    for (n = 1U; n <= ntimers; n = n * 4U) {
+      chTMObjectInit(&tmset);
+      chTMObjectInit(&tmreset);
+      chSysLock();
+      for (i = 0; i < n; i++) {
+        chVTDoSetI(&vtp[i],
+                   TIME_MS2I(10000) + (sysinterval_t)((i * 7919U) % n),
+                   tmo, NULL);
+      }
+      for (j = 0; j < 64U; j++) {
+        chTMStartMeasurementX(&tmset);
+        chVTDoSetI(&vt1, TIME_MS2I(10000) + (sysinterval_t)n, tmo, NULL);
+        chTMStopMeasurementX(&tmset);
+        chTMStartMeasurementX(&tmreset);
+        chVTDoResetI(&vt1);
+        chTMStopMeasurementX(&tmreset);
+      }
+      for (i = 0; i < n; i++) {
+        chVTDoResetI(&vtp[i]);
+      }
+      chSysUnlock();
+
+      test_print("--- Timers: ");
+      test_printn(n);
+      test_println("");
+      bmk_print_tm("--- Set   : ", &tmset);
+      bmk_print_tm("--- Reset : ", &tmreset);
+    }
+  }
+  test_end_step(2);
+}
+
+static const testcase_t rt_test_011_013 = {
+  "Virtual Timers scalability",
+  NULL,
+  NULL,
+  rt_test_011_013_execute
+};
+#endif /* CH_CFG_USE_TM */
+
+#if (CH_CFG_USE_TM) || defined(__DOXYGEN__)
+/**
+ * @page rt_test_011_014 [11.14] Ready list scalability
+ *
+ * <h2>Description</h2>
+ * An increasing number of threads is inserted in the ready list, for
+ * each step the best and worst case times required to make ready an
+ * additional thread are measured.<br> The threads are not real threads,
+ * they are inserted and removed with the kernel locked so they are
+ * never scheduled. The thread being measured has the lowest priority so
+ * it is the worst case for a linear ready list implementation.
+ *
+ * <h2>Conditions</h2>
+ * This test is only executed if the following preprocessor condition
+ * evaluates to true:
+ * - CH_CFG_USE_TM
+ * .
+ *
+ * <h2>Test Steps</h2>
+ * - [11.14.1] The number of threads that can be allocated in the shared
+ *   test buffer is calculated, priorities are spread between LOWPRIO
+ *   and NORMALPRIO.
+ * - [11.14.2] For each step the threads are made ready, the time
+ *   required to make ready an additional thread is measured 64 times,
+ *   the results are printed then the threads are removed from the ready
+ *   list.
+ * .
+ */
+
+static void rt_test_011_014_execute(void) {
+  static thread_t probe;
+  thread_t *tp = (thread_t *)test_buffer;
+  time_measurement_t tmready;
+  unsigned i, j, n, nthreads;
+
+  /* [11.14.1] The number of threads that can be allocated in the shared
+     test buffer is calculated, priorities are spread between LOWPRIO
+     and NORMALPRIO.*/
+  test_set_step(1);
+  {
+    nthreads = sizeof (test_buffer) / sizeof (thread_t);
+    if (nthreads > 256U) {
+      nthreads = 256U;
+    }
+    for (i = 0; i < nthreads; i++) {
+      tp[i].state = CH_STATE_SUSPENDED;
+      tp[i].prio  = LOWPRIO + (tprio_t)1 +
+                    (tprio_t)(i % (unsigned)(NORMALPRIO - LOWPRIO - 1));
+    }
+    probe.prio = LOWPRIO;
+  }
+  test_end_step(1);
+
+  /* [11.14.2] For each step the threads are made ready, the time
+     required to make ready an additional thread is measured 64 times,
+     the results are printed then the threads are removed from the ready
+     list.*/
+  test_set_step(2);
+  {
+    for (n = 1U; n <= nthreads; n = n * 4U) {
+      chTMObjectInit(&tmready);
+      chSysLock();
+      for (i = 0; i < n; i++) {
+        (void) chSchReadyI(&tp[i]);
+      }
+      for (j = 0; j < 64U; j++) {
+        probe.state = CH_STATE_SUSPENDED;
+        chTMStartMeasurementX(&tmready);
+        (void) chSchReadyI(&probe);
+        chTMStopMeasurementX(&tmready);
+        (void) rlist_dequeue(&probe);
+      }
+      for (i = 0; i < n; i++) {
+        (void) rlist_dequeue(&tp[i]);
+        tp[i].state = CH_STATE_SUSPENDED;
+      }
+      chSysUnlock();
+
+      test_print("--- Threads: ");
+      test_printn(n);
+      test_println("");
+      bmk_print_tm("--- Ready  : ", &tmready);
+    }
+  }
+  test_end_step(2);
+}
+
+static const testcase_t rt_test_011_014 = {
+  "Ready list scalability",
+  NULL,
+  NULL,
+  rt_test_011_014_execute
+};
+#endif /* CH_CFG_USE_TM */
+
 /****************************************************************************
  * Exported data.
  ****************************************************************************/
@@ -1066,6 +1264,12 @@ const testcase_t * const rt_test_sequence_011_array[] = {
   &rt_test_011_011,
 #endif
   &rt_test_011_012,
+#if (CH_CFG_USE_TM) || defined(__DOXYGEN__)
+  &rt_test_011_013,
+#endif
+#if (CH_CFG_USE_TM) || defined(__DOXYGEN__)
+  &rt_test_011_014,
+#endif
   NULL
 };
 
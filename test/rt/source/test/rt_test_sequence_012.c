@@ -0,0 +1,1173 @@
+/*
+    ChibiOS - Copyright (C) 2006..2018 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+#include "hal.h"
+#include "rt_test_root.h"
+
+/**
+ * @file    rt_test_sequence_012.c
+ * @brief   Test Sequence 012 code.
+ *
+ * @page rt_test_sequence_012 [12] Latency benchmarks
+ *
+ * File: @ref rt_test_sequence_012.c
+ *
+ * <h2>Description</h2>
+ * This module implements a series of latency benchmarks, each
+ * operation is measured using the realtime counter and the
+ * distribution of the measurements is collected in an histogram.<br>
+ * The 50th percentile, 99th percentile and worst case of each
+ * benchmark are printed in a machine-readable CSV or JSON line, the
+ * format is selected using BMK_CFG_OUTPUT_JSON. The output allows to
+ * detect performance regressions between successive ChibiOS/RT
+ * releases.
+ *
+ * <h2>Conditions</h2>
+ * This sequence is only executed if the following preprocessor condition
+ * evaluates to true:
+ * - CH_CFG_USE_TM
+ * .
+ *
+ * <h2>Test Cases</h2>
+ * - @subpage rt_test_012_001
+ * - @subpage rt_test_012_002
+ * - @subpage rt_test_012_003
+ * - @subpage rt_test_012_004
+ * - @subpage rt_test_012_005
+ * - @subpage rt_test_012_006
+ * - @subpage rt_test_012_007
+ * - @subpage rt_test_012_008
+ * - @subpage rt_test_012_009
+ * - @subpage rt_test_012_010
+ * - @subpage rt_test_012_011
+ * .
+ */
+
+#if (CH_CFG_USE_TM) || defined(__DOXYGEN__)
+
+/****************************************************************************
+ * Shared code.
+ ****************************************************************************/
+
+#include "ch.h"
+
+/*
+ * Number of measurements for each benchmark.
+ */
+#define BMK_SAMPLES             1000U
+
+/*
+ * Number of measurements for benchmarks requiring a timer event.
+ */
+#define BMK_TIMER_SAMPLES       64U
+
+/*
+ * Machine-readable output format, CSV lines if FALSE, JSON lines if TRUE.
+ */
+#if !defined(BMK_CFG_OUTPUT_JSON)
+#define BMK_CFG_OUTPUT_JSON     FALSE
+#endif
+
+/*
+ * Latency histogram, the range of each power of two is split in
+ * BMK_HIST_SUB linear buckets, values below BMK_HIST_SUB are exact.
+ */
+#define BMK_HIST_SUB_BITS       3U
+#define BMK_HIST_SUB            (1U << BMK_HIST_SUB_BITS)
+#define BMK_HIST_BUCKETS        ((32U - BMK_HIST_SUB_BITS + 1U) * BMK_HIST_SUB)
+
+typedef struct {
+  uint32_t      n;
+  rtcnt_t       max;
+  uint16_t      counts[BMK_HIST_BUCKETS];
+} bmk_hist_t;
+
+static time_measurement_t tm;
+static bmk_hist_t hist1, hist2;
+static thread_reference_t tr1;
+static virtual_timer_t vt1;
+
+static void bmk_hist_init(bmk_hist_t *hp) {
+  unsigned i;
+
+  hp->n   = 0U;
+  hp->max = (rtcnt_t)0;
+  for (i = 0U; i < BMK_HIST_BUCKETS; i++) {
+    hp->counts[i] = 0U;
+  }
+}
+
+static unsigned bmk_hist_index(rtcnt_t v) {
+  unsigned msb;
+
+  if (v < (rtcnt_t)BMK_HIST_SUB) {
+    return (unsigned)v;
+  }
+  msb = 31U;
+  while ((v & ((rtcnt_t)1 << msb)) == (rtcnt_t)0) {
+    msb--;
+  }
+  return ((msb - BMK_HIST_SUB_BITS + 1U) << BMK_HIST_SUB_BITS) +
+         (unsigned)((v >> (msb - BMK_HIST_SUB_BITS)) & (BMK_HIST_SUB - 1U));
+}
+
+static rtcnt_t bmk_hist_upper(unsigned b) {
+  unsigned shift;
+
+  if (b < BMK_HIST_SUB) {
+    return (rtcnt_t)b;
+  }
+  shift = (b >> BMK_HIST_SUB_BITS) - 1U;
+  return ((rtcnt_t)(BMK_HIST_SUB + (b & (BMK_HIST_SUB - 1U))) << shift) +
+         (((rtcnt_t)1 << shift) - (rtcnt_t)1);
+}
+
+static void bmk_hist_add(bmk_hist_t *hp, rtcnt_t v) {
+  unsigned b = bmk_hist_index(v);
+
+  if (hp->counts[b] < 0xFFFFU) {
+    hp->counts[b]++;
+  }
+  if (v > hp->max) {
+    hp->max = v;
+  }
+  hp->n++;
+}
+
+static rtcnt_t bmk_hist_percentile(bmk_hist_t *hp, uint32_t pct) {
+  uint32_t rank, acc;
+  unsigned b;
+
+  rank = ((hp->n * pct) + 99U) / 100U;
+  acc = 0U;
+  for (b = 0U; b < BMK_HIST_BUCKETS; b++) {
+    acc += hp->counts[b];
+    if ((acc > 0U) && (acc >= rank)) {
+      rtcnt_t upper = bmk_hist_upper(b);
+      return upper < hp->max ? upper : hp->max;
+    }
+  }
+  return hp->max;
+}
+
+/*
+ * Stops the measurement and accounts the sample, samples smaller than the
+ * calibration offset wrap around and are accounted as zero.
+ */
+static void bmk_stop_and_add(bmk_hist_t *hp) {
+  rtcnt_t t;
+
+  chTMStopMeasurementX(&tm);
+  t = tm.last;
+  if (t > ((rtcnt_t)-1 / 2U)) {
+    t = (rtcnt_t)0;
+  }
+  bmk_hist_add(hp, t);
+}
+
+/*
+ * Prints a benchmark result as a CSV or JSON line, the values are
+ * expressed in realtime counter cycles:
+ * BMK,<name>,<samples>,<p50>,<p99>,<max>
+ * {"bmk":"<name>","samples":<samples>,"p50":<p50>,"p99":<p99>,"max":<max>}
+ */
+static void bmk_hist_print(const char *name, bmk_hist_t *hp) {
+
+#if BMK_CFG_OUTPUT_JSON == TRUE
+  test_print("{\"bmk\":\"");
+  test_print(name);
+  test_print("\",\"samples\":");
+  test_printn(hp->n);
+  test_print(",\"p50\":");
+  test_printn((uint32_t)bmk_hist_percentile(hp, 50U));
+  test_print(",\"p99\":");
+  test_printn((uint32_t)bmk_hist_percentile(hp, 99U));
+  test_print(",\"max\":");
+  test_printn((uint32_t)hp->max);
+  test_println("}");
+#else
+  test_print("BMK,");
+  test_print(name);
+  test_print(",");
+  test_printn(hp->n);
+  test_print(",");
+  test_printn((uint32_t)bmk_hist_percentile(hp, 50U));
+  test_print(",");
+  test_printn((uint32_t)bmk_hist_percentile(hp, 99U));
+  test_print(",");
+  test_printn((uint32_t)hp->max);
+  test_println("");
+#endif
+}
+
+static void bmk_null_cb(void *p) {
+
+  (void)p;
+}
+
+#if (CH_DBG_STATISTICS == TRUE) &&                                          \
+    ((CH_CFG_SEM_SPIN_COUNT > 0) || (CH_CFG_MTX_SPIN_COUNT > 0))
+static ucnt_t spin_base, spin_ok_base;
+
+static void bmk_spin_mark(void) {
+
+  spin_base    = ch.kernel_stats.n_spin;
+  spin_ok_base = ch.kernel_stats.n_spin_ok;
+}
+
+/*
+ * Prints the adaptive spins accounted since the last mark as a CSV or
+ * JSON line:
+ * SPIN,<name>,<spins>,<successful spins>
+ * {"spin":"<name>","spins":<spins>,"ok":<successful spins>}
+ */
+static void bmk_spin_print(const char *name) {
+
+#if BMK_CFG_OUTPUT_JSON == TRUE
+  test_print("{\"spin\":\"");
+  test_print(name);
+  test_print("\",\"spins\":");
+  test_printn(ch.kernel_stats.n_spin - spin_base);
+  test_print(",\"ok\":");
+  test_printn(ch.kernel_stats.n_spin_ok - spin_ok_base);
+  test_println("}");
+#else
+  test_print("SPIN,");
+  test_print(name);
+  test_print(",");
+  test_printn(ch.kernel_stats.n_spin - spin_base);
+  test_print(",");
+  test_printn(ch.kernel_stats.n_spin_ok - spin_ok_base);
+  test_println("");
+#endif
+}
+#else
+#define bmk_spin_mark()
+#define bmk_spin_print(name)
+#endif
+
+static THD_FUNCTION(bmk_thread_yield, p) {
+
+  (void)p;
+  while (true) {
+    chTMStartMeasurementX(&tm);
+    chThdYield();
+    if (chThdShouldTerminateX()) {
+      break;
+    }
+    bmk_stop_and_add(&hist1);
+  }
+}
+
+#if CH_CFG_USE_SEMAPHORES || defined(__DOXYGEN__)
+static semaphore_t sem1;
+
+static THD_FUNCTION(bmk_thread_sem, p) {
+
+  (void)p;
+  while (true) {
+    chSemWait(&sem1);
+    if (chThdShouldTerminateX()) {
+      break;
+    }
+    bmk_stop_and_add(&hist1);
+  }
+}
+
+static void bmk_sem_signal_cb(void *p) {
+
+  (void)p;
+  chSysLockFromISR();
+  chTMStartMeasurementX(&tm);
+  chSemSignalI(&sem1);
+  chSysUnlockFromISR();
+}
+#endif
+
+#if CH_CFG_USE_MUTEXES || defined(__DOXYGEN__)
+static mutex_t mtx1;
+
+static THD_FUNCTION(bmk_thread_mtx, p) {
+  msg_t msg;
+
+  (void)p;
+  while (true) {
+    chSysLock();
+    msg = chThdSuspendS(&tr1);
+    chSysUnlock();
+    if (msg != MSG_OK) {
+      break;
+    }
+    chMtxLock(&mtx1);
+    bmk_stop_and_add(&hist1);
+    chMtxUnlock(&mtx1);
+  }
+}
+
+static THD_FUNCTION(bmk_thread_mtx_owner, p) {
+  unsigned i;
+
+  (void)p;
+  for (i = 0; i < BMK_TIMER_SAMPLES; i++) {
+    chMtxLock(&mtx1);
+    chThdSleepMilliseconds(1);
+    chTMStartMeasurementX(&tm);
+    chMtxUnlock(&mtx1);
+    chSysLock();
+    (void) chThdSuspendS(&tr1);
+    chSysUnlock();
+  }
+}
+#endif
+
+#if CH_CFG_USE_MAILBOXES || defined(__DOXYGEN__)
+static msg_t mb_buffer[4];
+static mailbox_t mb1;
+
+static THD_FUNCTION(bmk_thread_mbox, p) {
+  msg_t msg;
+
+  (void)p;
+  while (true) {
+    (void) chMBFetchTimeout(&mb1, &msg, TIME_INFINITE);
+    if (msg == (msg_t)0) {
+      break;
+    }
+    bmk_stop_and_add(&hist1);
+  }
+}
+#endif
+
+#if CH_CFG_USE_EVENTS || defined(__DOXYGEN__)
+static EVENTSOURCE_DECL(es1);
+
+static THD_FUNCTION(bmk_thread_evt, p) {
+  event_listener_t el;
+
+  (void)p;
+  chEvtRegister(&es1, &el, 0);
+  while (true) {
+    (void) chEvtWaitAny(ALL_EVENTS);
+    if (chThdShouldTerminateX()) {
+      break;
+    }
+    bmk_stop_and_add(&hist1);
+  }
+  chEvtUnregister(&es1, &el);
+}
+
+/*
+ * Listeners for the broadcast scalability benchmarks, each listener is
+ * interested in one of eight flags.
+ */
+#define BMK_LISTENERS           64U
+
+static event_source_t es2;
+static event_listener_t els[BMK_LISTENERS];
+
+static void bmk_evt_register(unsigned from, unsigned to) {
+
+  while (from < to) {
+    chEvtRegisterMaskWithFlags(&es2, &els[from], 1,
+                               (eventflags_t)1 << (from & 7U));
+    from++;
+  }
+}
+
+static void bmk_evt_unregister(unsigned n) {
+
+  while (n > 0U) {
+    n--;
+    chEvtUnregister(&es2, &els[n]);
+  }
+}
+
+#if CH_CFG_USE_EVENTS_DEFERRED || defined(__DOXYGEN__)
+static event_deferrer_t ed1;
+#endif
+#endif
+
+static void bmk_wakeup_cb(void *p) {
+
+  (void)p;
+  chSysLockFromISR();
+  chTMStartMeasurementX(&tm);
+  chThdResumeI(&tr1, MSG_OK);
+  chSysUnlockFromISR();
+}
+
+static THD_FUNCTION(bmk_thread_wakeup, p) {
+  msg_t msg;
+
+  (void)p;
+  while (true) {
+    chSysLock();
+    msg = chThdSuspendS(&tr1);
+    if (msg == MSG_OK) {
+      bmk_stop_and_add(&hist1);
+    }
+    chSysUnlock();
+    if (msg != MSG_OK) {
+      break;
+    }
+  }
+}
+
+/****************************************************************************
+ * Test cases.
+ ****************************************************************************/
+
+/**
+ * @page rt_test_012_001 [12.1] Context switch latency
+ *
+ * <h2>Description</h2>
+ * Two threads at the same priority level yield to each other, the time
+ * between the yield and the return in the other thread is measured.
+ * The histogram of the measured latencies is printed.
+ *
+ * <h2>Test Steps</h2>
+ * - [12.1.1] A thread is created at the same priority level of the
+ *   current thread.
+ * - [12.1.2] The two threads yield to each other, each switch is
+ *   measured. The result is printed.
+ * .
+ */
+
+static void rt_test_012_001_setup(void) {
+  chTMObjectInit(&tm);
+  bmk_hist_init(&hist1);
+}
+
+static void rt_test_012_001_execute(void) {
+  unsigned i;
+
+  /* [12.1.1] A thread is created at the same priority level of the
+     current thread.*/
+  test_set_step(1);
+  {
+    threads[0] = chThdCreateStatic(wa[0], WA_SIZE, chThdGetPriorityX(),
+                                   bmk_thread_yield, NULL);
+  }
+  test_end_step(1);
+
+  /* [12.1.2] The two threads yield to each other, each switch is
+     measured. The result is printed.*/
+  test_set_step(2);
+  {
+    for (i = 0; i < BMK_SAMPLES; i++) {
+      chTMStartMeasurementX(&tm);
+      chThdYield();
+      bmk_stop_and_add(&hist1);
+    }
+    test_terminate_threads();
+    test_wait_threads();
+    bmk_hist_print("ctxsw", &hist1);
+  }
+  test_end_step(2);
+}
+
+static const testcase_t rt_test_012_001 = {
+  "Context switch latency",
+  rt_test_012_001_setup,
+  NULL,
+  rt_test_012_001_execute
+};
+
+#if (CH_CFG_USE_SEMAPHORES) || defined(__DOXYGEN__)
+/**
+ * @page rt_test_012_002 [12.2] Semaphore signal-wait latency
+ *
+ * <h2>Description</h2>
+ * A thread waiting on a semaphore is signaled by a lower priority
+ * thread, the time between the signal and the return from wait is
+ * measured. The histogram of the measured latencies is printed.
+ *
+ * <h2>Conditions</h2>
+ * This test is only executed if the following preprocessor condition
+ * evaluates to true:
+ * - CH_CFG_USE_SEMAPHORES
+ * .
+ *
+ * <h2>Test Steps</h2>
+ * - [12.2.1] A thread is created at higher priority, the thread waits
+ *   on the semaphore.
+ * - [12.2.2] The semaphore is signaled repeatedly, each wakeup is
+ *   measured. The result is printed.
+ * .
+ */
+
+static void rt_test_012_002_setup(void) {
+  chTMObjectInit(&tm);
+  bmk_hist_init(&hist1);
+  chSemObjectInit(&sem1, 0);
+}
+
+static void rt_test_012_002_execute(void) {
+  unsigned i;
+
+  /* [12.2.1] A thread is created at higher priority, the thread waits
+     on the semaphore.*/
+  test_set_step(1);
+  {
+    threads[0] = chThdCreateStatic(wa[0], WA_SIZE, chThdGetPriorityX() + 1,
+                                   bmk_thread_sem, NULL);
+  }
+  test_end_step(1);
+
+  /* [12.2.2] The semaphore is signaled repeatedly, each wakeup is
+     measured. The result is printed.*/
+  test_set_step(2);
+  {
+    for (i = 0; i < BMK_SAMPLES; i++) {
+      chTMStartMeasurementX(&tm);
+      chSemSignal(&sem1);
+    }
+    test_terminate_threads();
+    chSemSignal(&sem1);
+    test_wait_threads();
+    bmk_hist_print("sem_signal_wait", &hist1);
+  }
+  test_end_step(2);
+}
+
+static const testcase_t rt_test_012_002 = {
+  "Semaphore signal-wait latency",
+  rt_test_012_002_setup,
+  NULL,
+  rt_test_012_002_execute
+};
+#endif /* CH_CFG_USE_SEMAPHORES */
+
+#if (CH_CFG_USE_MUTEXES) || defined(__DOXYGEN__)
+/**
+ * @page rt_test_012_003 [12.3] Mutex handoff latency
+ *
+ * <h2>Description</h2>
+ * A thread waiting on a mutex owned by a lower priority thread gets
+ * the mutex when it is released, the time between the unlock and the
+ * return from lock is measured. The histogram of the measured
+ * latencies is printed.
+ *
+ * <h2>Conditions</h2>
+ * This test is only executed if the following preprocessor condition
+ * evaluates to true:
+ * - CH_CFG_USE_MUTEXES
+ * .
+ *
+ * <h2>Test Steps</h2>
+ * - [12.3.1] A thread is created at higher priority, the thread waits
+ *   to be resumed.
+ * - [12.3.2] The mutex is locked and the thread is resumed in order to
+ *   block on the mutex, the mutex is then unlocked and the handoff is
+ *   measured. The result is printed.
+ * .
+ */
+
+static void rt_test_012_003_setup(void) {
+  chTMObjectInit(&tm);
+  bmk_hist_init(&hist1);
+  chMtxObjectInit(&mtx1);
+}
+
+static void rt_test_012_003_execute(void) {
+  unsigned i;
+
+  /* [12.3.1] A thread is created at higher priority, the thread waits
+     to be resumed.*/
+  test_set_step(1);
+  {
+    threads[0] = chThdCreateStatic(wa[0], WA_SIZE, chThdGetPriorityX() + 1,
+                                   bmk_thread_mtx, NULL);
+  }
+  test_end_step(1);
+
+  /* [12.3.2] The mutex is locked and the thread is resumed in order to
+     block on the mutex, the mutex is then unlocked and the handoff is
+     measured. The result is printed.*/
+  test_set_step(2);
+  {
+    for (i = 0; i < BMK_SAMPLES; i++) {
+      chMtxLock(&mtx1);
+      chThdResume(&tr1, MSG_OK);
+      chTMStartMeasurementX(&tm);
+      chMtxUnlock(&mtx1);
+    }
+    chThdResume(&tr1, MSG_RESET);
+    test_wait_threads();
+    bmk_hist_print("mtx_handoff", &hist1);
+  }
+  test_end_step(2);
+}
+
+static const testcase_t rt_test_012_003 = {
+  "Mutex handoff latency",
+  rt_test_012_003_setup,
+  NULL,
+  rt_test_012_003_execute
+};
+#endif /* CH_CFG_USE_MUTEXES */
+
+#if (CH_CFG_USE_MAILBOXES) || defined(__DOXYGEN__)
+/**
+ * @page rt_test_012_004 [12.4] Mailbox post-fetch latency
+ *
+ * <h2>Description</h2>
+ * A thread waiting on a mailbox receives messages posted by a lower
+ * priority thread, the time between the post and the return from fetch
+ * is measured. The histogram of the measured latencies is printed.
+ *
+ * <h2>Conditions</h2>
+ * This test is only executed if the following preprocessor condition
+ * evaluates to true:
+ * - CH_CFG_USE_MAILBOXES
+ * .
+ *
+ * <h2>Test Steps</h2>
+ * - [12.4.1] A thread is created at higher priority, the thread waits
+ *   on the mailbox.
+ * - [12.4.2] Messages are posted repeatedly, each fetch is measured.
+ *   The result is printed.
+ * .
+ */
+
+static void rt_test_012_004_setup(void) {
+  chTMObjectInit(&tm);
+  bmk_hist_init(&hist1);
+  chMBObjectInit(&mb1, mb_buffer, 4);
+}
+
+static void rt_test_012_004_execute(void) {
+  unsigned i;
+
+  /* [12.4.1] A thread is created at higher priority, the thread waits
+     on the mailbox.*/
+  test_set_step(1);
+  {
+    threads[0] = chThdCreateStatic(wa[0], WA_SIZE, chThdGetPriorityX() + 1,
+                                   bmk_thread_mbox, NULL);
+  }
+  test_end_step(1);
+
+  /* [12.4.2] Messages are posted repeatedly, each fetch is measured.
+     The result is printed.*/
+  test_set_step(2);
+  {
+    for (i = 0; i < BMK_SAMPLES; i++) {
+      chTMStartMeasurementX(&tm);
+      (void) chMBPostTimeout(&mb1, (msg_t)1, TIME_INFINITE);
+    }
+    (void) chMBPostTimeout(&mb1, (msg_t)0, TIME_INFINITE);
+    test_wait_threads();
+    bmk_hist_print("mbox_post_fetch", &hist1);
+  }
+  test_end_step(2);
+}
+
+static const testcase_t rt_test_012_004 = {
+  "Mailbox post-fetch latency",
+  rt_test_012_004_setup,
+  NULL,
+  rt_test_012_004_execute
+};
+#endif /* CH_CFG_USE_MAILBOXES */
+
+#if (CH_CFG_USE_EVENTS) || defined(__DOXYGEN__)
+/**
+ * @page rt_test_012_005 [12.5] Event broadcast latency
+ *
+ * <h2>Description</h2>
+ * A thread waiting for events is awakened by a broadcast performed by
+ * a lower priority thread, the time between the broadcast and the
+ * return from wait is measured. The histogram of the measured
+ * latencies is printed.
+ *
+ * <h2>Conditions</h2>
+ * This test is only executed if the following preprocessor condition
+ * evaluates to true:
+ * - CH_CFG_USE_EVENTS
+ * .
+ *
+ * <h2>Test Steps</h2>
+ * - [12.5.1] A thread is created at higher priority, the thread
+ *   registers on the event source and waits for events.
+ * - [12.5.2] Events are broadcast repeatedly, each wakeup is measured.
+ *   The result is printed.
+ * .
+ */
+
+static void rt_test_012_005_setup(void) {
+  chTMObjectInit(&tm);
+  bmk_hist_init(&hist1);
+}
+
+static void rt_test_012_005_execute(void) {
+  unsigned i;
+
+  /* [12.5.1] A thread is created at higher priority, the thread
+     registers on the event source and waits for events.*/
+  test_set_step(1);
+  {
+    threads[0] = chThdCreateStatic(wa[0], WA_SIZE, chThdGetPriorityX() + 1,
+                                   bmk_thread_evt, NULL);
+  }
+  test_end_step(1);
+
+  /* [12.5.2] Events are broadcast repeatedly, each wakeup is measured.
+     The result is printed.*/
+  test_set_step(2);
+  {
+    for (i = 0; i < BMK_SAMPLES; i++) {
+      chTMStartMeasurementX(&tm);
+      chEvtBroadcast(&es1);
+    }
+    test_terminate_threads();
+    chEvtBroadcast(&es1);
+    test_wait_threads();
+    bmk_hist_print("evt_broadcast", &hist1);
+  }
+  test_end_step(2);
+}
+
+static const testcase_t rt_test_012_005 = {
+  "Event broadcast latency",
+  rt_test_012_005_setup,
+  NULL,
+  rt_test_012_005_execute
+};
+#endif /* CH_CFG_USE_EVENTS */
+
+/**
+ * @page rt_test_012_006 [12.6] Virtual timers arm and disarm latency
+ *
+ * <h2>Description</h2>
+ * A virtual timer is repeatedly armed and disarmed, the time required
+ * by each operation is measured. The histograms of the measured
+ * latencies are printed.
+ *
+ * <h2>Test Steps</h2>
+ * - [12.6.1] The timer is armed and disarmed repeatedly, both
+ *   operations are measured. The results are printed.
+ * .
+ */
+
+static void rt_test_012_006_setup(void) {
+  chTMObjectInit(&tm);
+  bmk_hist_init(&hist1);
+  bmk_hist_init(&hist2);
+}
+
+static void rt_test_012_006_execute(void) {
+  unsigned i;
+
+  /* [12.6.1] The timer is armed and disarmed repeatedly, both
+     operations are measured. The results are printed.*/
+  test_set_step(1);
+  {
+    chSysLock();
+    for (i = 0; i < BMK_SAMPLES; i++) {
+      chTMStartMeasurementX(&tm);
+      chVTDoSetI(&vt1, TIME_MS2I(10), bmk_null_cb, NULL);
+      bmk_stop_and_add(&hist1);
+      chTMStartMeasurementX(&tm);
+      chVTDoResetI(&vt1);
+      bmk_stop_and_add(&hist2);
+    }
+    chSysUnlock();
+    bmk_hist_print("vt_set", &hist1);
+    bmk_hist_print("vt_reset", &hist2);
+  }
+  test_end_step(1);
+}
+
+static const testcase_t rt_test_012_006 = {
+  "Virtual timers arm and disarm latency",
+  rt_test_012_006_setup,
+  NULL,
+  rt_test_012_006_execute
+};
+
+/**
+ * @page rt_test_012_007 [12.7] ISR to thread wakeup latency
+ *
+ * <h2>Description</h2>
+ * A thread is resumed from a virtual timer callback running in ISR
+ * context, the time between the resume in the callback and the return
+ * in the thread is measured. The histogram of the measured latencies
+ * is printed.
+ *
+ * <h2>Test Steps</h2>
+ * - [12.7.1] A thread is created at higher priority, the thread waits
+ *   to be resumed.
+ * - [12.7.2] A one-shot timer resumes the thread, the wakeup is
+ *   measured. The operation is repeated and the result is printed.
+ * .
+ */
+
+static void rt_test_012_007_setup(void) {
+  chTMObjectInit(&tm);
+  bmk_hist_init(&hist1);
+}
+
+static void rt_test_012_007_execute(void) {
+  unsigned i;
+
+  /* [12.7.1] A thread is created at higher priority, the thread waits
+     to be resumed.*/
+  test_set_step(1);
+  {
+    threads[0] = chThdCreateStatic(wa[0], WA_SIZE, chThdGetPriorityX() + 1,
+                                   bmk_thread_wakeup, NULL);
+  }
+  test_end_step(1);
+
+  /* [12.7.2] A one-shot timer resumes the thread, the wakeup is
+     measured. The operation is repeated and the result is printed.*/
+  test_set_step(2);
+  {
+    for (i = 0; i < BMK_TIMER_SAMPLES; i++) {
+      chVTSet(&vt1, TIME_MS2I(1), bmk_wakeup_cb, NULL);
+      chThdSleepMilliseconds(3);
+    }
+    chThdResume(&tr1, MSG_RESET);
+    test_wait_threads();
+    bmk_hist_print("isr_wakeup", &hist1);
+  }
+  test_end_step(2);
+}
+
+static const testcase_t rt_test_012_007 = {
+  "ISR to thread wakeup latency",
+  rt_test_012_007_setup,
+  NULL,
+  rt_test_012_007_execute
+};
+
+#if (CH_CFG_USE_EVENTS) || defined(__DOXYGEN__)
+/**
+ * @page rt_test_012_008 [12.8] Event broadcast scalability
+ *
+ * <h2>Description</h2>
+ * An increasing number of listeners is registered on an event source,
+ * each listener is interested in one of eight flags. The time
+ * required by a broadcast from I-class context, signaling one
+ * listener in eight, is measured for each number of listeners. The
+ * histograms of the measured latencies are printed.
+ *
+ * <h2>Conditions</h2>
+ * This test is only executed if the following preprocessor condition
+ * evaluates to true:
+ * - CH_CFG_USE_EVENTS
+ * .
+ *
+ * <h2>Test Steps</h2>
+ * - [12.8.1] The number of listeners is doubled up to BMK_LISTENERS,
+ *   the broadcast is measured for each number of listeners. The
+ *   results are printed.
+ * .
+ */
+
+static void rt_test_012_008_setup(void) {
+  chTMObjectInit(&tm);
+  chEvtObjectInit(&es2);
+}
+
+static void rt_test_012_008_execute(void) {
+  static const char * const names[] = {
+    "evt_flags_8", "evt_flags_16", "evt_flags_32", "evt_flags_64"
+  };
+  unsigned i, j, n;
+
+  /* [12.8.1] The number of listeners is doubled up to BMK_LISTENERS,
+     the broadcast is measured for each number of listeners. The
+     results are printed.*/
+  test_set_step(1);
+  {
+    n = 0U;
+    for (j = 0U; j < 4U; j++) {
+      bmk_evt_register(n, 8U << j);
+      n = 8U << j;
+      bmk_hist_init(&hist1);
+      chSysLock();
+      for (i = 0; i < BMK_SAMPLES; i++) {
+        chTMStartMeasurementX(&tm);
+        chEvtBroadcastFlagsI(&es2, 1);
+        bmk_stop_and_add(&hist1);
+      }
+      chSysUnlock();
+      (void) chEvtGetAndClearEvents(ALL_EVENTS);
+      bmk_hist_print(names[j], &hist1);
+    }
+    bmk_evt_unregister(n);
+  }
+  test_end_step(1);
+}
+
+static const testcase_t rt_test_012_008 = {
+  "Event broadcast scalability",
+  rt_test_012_008_setup,
+  NULL,
+  rt_test_012_008_execute
+};
+#endif /* CH_CFG_USE_EVENTS */
+
+#if (CH_CFG_USE_EVENTS_DEFERRED) || defined(__DOXYGEN__)
+/**
+ * @page rt_test_012_009 [12.9] Deferred event broadcast
+ *
+ * <h2>Description</h2>
+ * BMK_LISTENERS listeners are registered on an event source with
+ * deferred broadcasts, the time required by a broadcast from I-class
+ * context and the time required by the fan-out to the listeners are
+ * measured. The histograms of the measured latencies are printed.
+ *
+ * <h2>Conditions</h2>
+ * This test is only executed if the following preprocessor condition
+ * evaluates to true:
+ * - CH_CFG_USE_EVENTS_DEFERRED
+ * .
+ *
+ * <h2>Test Steps</h2>
+ * - [12.9.1] The listeners are registered.
+ * - [12.9.2] Broadcasts are performed and the deferrer is dispatched,
+ *   both operations are measured. The results are printed.
+ * .
+ */
+
+static void rt_test_012_009_setup(void) {
+  chTMObjectInit(&tm);
+  bmk_hist_init(&hist1);
+  bmk_hist_init(&hist2);
+  chEvtDeferrerObjectInit(&ed1);
+  chEvtObjectInitDeferred(&es2, &ed1);
+}
+
+static void rt_test_012_009_execute(void) {
+  unsigned i;
+
+  /* [12.9.1] The listeners are registered.*/
+  test_set_step(1);
+  {
+    bmk_evt_register(0U, BMK_LISTENERS);
+  }
+  test_end_step(1);
+
+  /* [12.9.2] Broadcasts are performed and the deferrer is dispatched,
+     both operations are measured. The results are printed.*/
+  test_set_step(2);
+  {
+    for (i = 0; i < BMK_SAMPLES; i++) {
+      chSysLock();
+      chTMStartMeasurementX(&tm);
+      chEvtBroadcastFlagsI(&es2, 1);
+      bmk_stop_and_add(&hist1);
+      chSysUnlock();
+      chTMStartMeasurementX(&tm);
+      (void) chEvtDeferrerDispatchTimeout(&ed1, TIME_IMMEDIATE);
+      bmk_stop_and_add(&hist2);
+    }
+    (void) chEvtGetAndClearEvents(ALL_EVENTS);
+    bmk_evt_unregister(BMK_LISTENERS);
+    bmk_hist_print("evt_deferred_post", &hist1);
+    bmk_hist_print("evt_deferred_fanout", &hist2);
+  }
+  test_end_step(2);
+}
+
+static const testcase_t rt_test_012_009 = {
+  "Deferred event broadcast",
+  rt_test_012_009_setup,
+  NULL,
+  rt_test_012_009_execute
+};
+#endif /* CH_CFG_USE_EVENTS_DEFERRED */
+
+#if (CH_CFG_USE_SEMAPHORES) || defined(__DOXYGEN__)
+/**
+ * @page rt_test_012_010 [12.10] Semaphore ISR signal-wait latency
+ *
+ * <h2>Description</h2>
+ * A thread waiting on a semaphore is signaled by a virtual timer
+ * callback running in ISR context, the time between the signal and
+ * the return from wait is measured. If CH_CFG_SEM_SPIN_COUNT is
+ * greater than zero then the thread can take the semaphore while
+ * spinning, without context switches. The histogram of the measured
+ * latencies and the spins statistics are printed.
+ *
+ * <h2>Conditions</h2>
+ * This test is only executed if the following preprocessor condition
+ * evaluates to true:
+ * - CH_CFG_USE_SEMAPHORES
+ * .
+ *
+ * <h2>Test Steps</h2>
+ * - [12.10.1] A one-shot timer signals the semaphore while the thread
+ *   waits on it, the wakeup is measured. The operation is repeated
+ *   and the results are printed.
+ * .
+ */
+
+static void rt_test_012_010_setup(void) {
+  chTMObjectInit(&tm);
+  bmk_hist_init(&hist1);
+  chSemObjectInit(&sem1, 0);
+  bmk_spin_mark();
+}
+
+static void rt_test_012_010_execute(void) {
+  unsigned i;
+
+  /* [12.10.1] A one-shot timer signals the semaphore while the thread
+     waits on it, the wakeup is measured. The operation is repeated
+     and the results are printed.*/
+  test_set_step(1);
+  {
+    for (i = 0; i < BMK_TIMER_SAMPLES; i++) {
+      chVTSet(&vt1, TIME_MS2I(1), bmk_sem_signal_cb, NULL);
+      (void) chSemWait(&sem1);
+      bmk_stop_and_add(&hist1);
+    }
+    bmk_hist_print("sem_isr_signal_wait", &hist1);
+    bmk_spin_print("sem_isr_signal_wait");
+  }
+  test_end_step(1);
+}
+
+static const testcase_t rt_test_012_010 = {
+  "Semaphore ISR signal-wait latency",
+  rt_test_012_010_setup,
+  NULL,
+  rt_test_012_010_execute
+};
+#endif /* CH_CFG_USE_SEMAPHORES */
+
+#if (CH_CFG_USE_MUTEXES) || defined(__DOXYGEN__)
+/**
+ * @page rt_test_012_011 [12.11] Mutex release-lock latency
+ *
+ * <h2>Description</h2>
+ * A higher priority thread locks a mutex and sleeps, the thread under
+ * test tries to lock the same mutex. The owner is awakened by the
+ * system tick and releases the mutex, the time between the release
+ * and the return from lock is measured. If CH_CFG_MTX_SPIN_COUNT is
+ * greater than zero then the thread under test can take the mutex
+ * while spinning, without sleeping on it. The histogram of the
+ * measured latencies and the spins statistics are printed.
+ *
+ * <h2>Conditions</h2>
+ * This test is only executed if the following preprocessor condition
+ * evaluates to true:
+ * - CH_CFG_USE_MUTEXES
+ * .
+ *
+ * <h2>Test Steps</h2>
+ * - [12.11.1] A thread is created at higher priority, the thread
+ *   repeatedly locks the mutex, sleeps and releases it.
+ * - [12.11.2] The mutex is locked repeatedly while owned by the
+ *   sleeping thread, each lock is measured. The result is printed.
+ * .
+ */
+
+static void rt_test_012_011_setup(void) {
+  chTMObjectInit(&tm);
+  bmk_hist_init(&hist1);
+  chMtxObjectInit(&mtx1);
+  bmk_spin_mark();
+}
+
+static void rt_test_012_011_execute(void) {
+  unsigned i;
+
+  /* [12.11.1] A thread is created at higher priority, the thread
+     repeatedly locks the mutex, sleeps and releases it.*/
+  test_set_step(1);
+  {
+    threads[0] = chThdCreateStatic(wa[0], WA_SIZE, chThdGetPriorityX() + 1,
+                                   bmk_thread_mtx_owner, NULL);
+  }
+  test_end_step(1);
+
+  /* [12.11.2] The mutex is locked repeatedly while owned by the
+     sleeping thread, each lock is measured. The result is printed.*/
+  test_set_step(2);
+  {
+    for (i = 0; i < BMK_TIMER_SAMPLES; i++) {
+      chMtxLock(&mtx1);
+      bmk_stop_and_add(&hist1);
+      chMtxUnlock(&mtx1);
+      chThdResume(&tr1, MSG_OK);
+    }
+    test_wait_threads();
+    bmk_hist_print("mtx_release_lock", &hist1);
+    bmk_spin_print("mtx_release_lock");
+  }
+  test_end_step(2);
+}
+
+static const testcase_t rt_test_012_011 = {
+  "Mutex release-lock latency",
+  rt_test_012_011_setup,
+  NULL,
+  rt_test_012_011_execute
+};
+#endif /* CH_CFG_USE_MUTEXES */
+
+/****************************************************************************
+ * Exported data.
+ ****************************************************************************/
+
+/**
+ * @brief   Array of test cases.
+ */
+const testcase_t * const rt_test_sequence_012_array[] = {
+  &rt_test_012_001,
+#if (CH_CFG_USE_SEMAPHORES) || defined(__DOXYGEN__)
+  &rt_test_012_002,
+#endif
+#if (CH_CFG_USE_MUTEXES) || defined(__DOXYGEN__)
+  &rt_test_012_003,
+#endif
+#if (CH_CFG_USE_MAILBOXES) || defined(__DOXYGEN__)
+  &rt_test_012_004,
+#endif
+#if (CH_CFG_USE_EVENTS) || defined(__DOXYGEN__)
+  &rt_test_012_005,
+#endif
+  &rt_test_012_006,
+  &rt_test_012_007,
+#if (CH_CFG_USE_EVENTS) || defined(__DOXYGEN__)
+  &rt_test_012_008,
+#endif
+#if (CH_CFG_USE_EVENTS_DEFERRED) || defined(__DOXYGEN__)
+  &rt_test_012_009,
+#endif
+#if (CH_CFG_USE_SEMAPHORES) || defined(__DOXYGEN__)
+  &rt_test_012_010,
+#endif
+#if (CH_CFG_USE_MUTEXES) || defined(__DOXYGEN__)
+  &rt_test_012_011,
+#endif
+  NULL
+};
+
+/**
+ * @brief   Latency benchmarks.
+ */
+const testsequence_t rt_test_sequence_012 = {
+  "Latency benchmarks",
+  rt_test_sequence_012_array
+};
+
+#endif /* CH_CFG_USE_TM */
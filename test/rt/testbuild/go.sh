@@ -3,16 +3,17 @@ export XOPT XDEFS
 
 XOPT="-ggdb -O0 -fomit-frame-pointer -DTEST_DELAY_BETWEEN_TESTS=0 -fprofile-arcs -ftest-coverage"
 XDEFS=""
+MAKEFILE=Makefile
 
 function clean() {
   echo -n "  * Cleaning..."
-  make clean > /dev/null
+  make -f $MAKEFILE clean > /dev/null
   echo "OK"
 }
 
 function compile() {
   echo -n "  * Building..."
-  if ! make > buildlog.txt
+  if ! make -f $MAKEFILE > buildlog.txt
   then
     echo "failed"
     clean
@@ -39,7 +40,7 @@ function coverage() {
   mkdir reports/${1}_gcov 2> /dev/null
   echo "Configuration $2" > gcovlog.txt
   echo "----------------------------------------------------------------" >> gcovlog.txt
-  if ! make gcov >> gcovlog.txt 2> /dev/null
+  if ! make -f $MAKEFILE gcov >> gcovlog.txt 2> /dev/null
   then
     echo "failed"
     clean
@@ -52,7 +53,7 @@ function coverage() {
 
 function misra() {
   echo -n "  * Analysing..."
-  if ! make misra > misralog.txt 2> misraerrlog.txt
+  if ! make -f $MAKEFILE misra > misralog.txt 2> misraerrlog.txt
   then
     echo "failed"
     clean
@@ -78,6 +79,12 @@ function test() {
   clean
 }
 
+function test_x64() {
+  MAKEFILE=Makefile_x64
+  test "$1" "$2"
+  MAKEFILE=Makefile
+}
+
 function partial() {
   compile
   execute_test
@@ -122,6 +129,18 @@ test cfg32 "-DCH_CFG_ST_RESOLUTION=16 -DCH_CFG_INTERVALS_SIZE=64"
 test cfg33 "-DCH_CFG_INTERVALS_SIZE=64"
 test cfg34 "-DCH_CFG_USE_OBJ_FIFOS=FALSE"
 test cfg35 "-DCH_CFG_USE_FACTORY=FALSE"
+test cfg36 "-DCH_CFG_USE_TIMERS_HEAP=TRUE"
+test cfg37 "-DCH_CFG_USE_TIMERS_HEAP=TRUE -DCH_CFG_ST_RESOLUTION=16 -DCH_CFG_INTERVALS_SIZE=64"
+test cfg38 "-DCH_CFG_USE_READY_BITMAP=TRUE"
+test cfg39 "-DCH_CFG_USE_READY_BITMAP=TRUE -DCH_CFG_TIME_QUANTUM=0 -DCH_CFG_OPTIMIZE_SPEED=FALSE"
+test cfg40 "-DCH_CFG_PIPES_SPSC=TRUE"
+test cfg41 "-DCH_CFG_USE_HEAP_TLSF=TRUE"
+test cfg42 "-DCH_CFG_USE_HEAP_TLSF=TRUE -DCH_CFG_USE_MUTEXES=FALSE -DCH_CFG_USE_CONDVARS=FALSE"
+test cfg43 "-DCH_DBG_TRACE_MASK=CH_DBG_TRACE_MASK_ALL -DCH_CFG_USE_TIMERS_HEAP=TRUE -DCH_CFG_USE_MUTEXES_RECURSIVE=TRUE"
+test cfg44 "-DCH_CFG_SEM_SPIN_COUNT=256 -DCH_CFG_MTX_SPIN_COUNT=256 -DCH_DBG_STATISTICS=TRUE"
+test cfg45 "-DCH_CFG_SEM_SPIN_COUNT=256 -DCH_CFG_MTX_SPIN_COUNT=256 -DCH_CFG_USE_MUTEXES_RECURSIVE=TRUE -DCH_DBG_ENABLE_ASSERTS=TRUE"
+test_x64 cfg46 "-DCH_CFG_ST_TIMEDELTA=2 -DCH_CFG_TIME_QUANTUM=0 -DCH_DBG_THREADS_PROFILING=FALSE"
+test_x64 cfg47 "-DCH_CFG_ST_TIMEDELTA=2 -DCH_CFG_TIME_QUANTUM=0 -DCH_DBG_THREADS_PROFILING=FALSE -DCH_CFG_USE_TIMERS_HEAP=TRUE"
 
 rm *log.txt 2> /dev/null
 echo
@@ -19,6 +19,7 @@
 #include "chprintf.h"
 
 #include "portab.h"
+#include "crypto_bench.h"
 
 /*
  * LED blinker thread, times are in milliseconds.
@@ -36,6 +37,14 @@ static THD_FUNCTION(Thread1, arg) {
   }
 }
 
+/*
+ * Validation and benchmark configuration.
+ */
+static const crypto_bench_config_t bench_config = {
+  (BaseSequentialStream *)&PORTAB_SD1,
+  &CRYD1
+};
+
 /*
  * Application entry point.
  */
@@ -60,6 +69,9 @@ int main(void) {
   /* Starting Crypto driver.*/
   cryStart(&CRYD1, NULL);
 
+  /* Validation and throughput report on the serial port.*/
+  crypto_bench_execute(&bench_config);
+
   /* Creates the blinker thread.*/
   chThdCreateStatic(waThread1, sizeof(waThread1), NORMALPRIO, Thread1, NULL);
 
@@ -0,0 +1,143 @@
+/*
+    ChibiOS - Copyright (C) 2006..2018 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+/**
+ * @file    bench_timer.c
+ * @brief   Benchmarks timing helper code.
+ *
+ * @addtogroup BENCH_TIMER
+ * @{
+ */
+
+#include "ch.h"
+
+#include "bench_timer.h"
+
+/*===========================================================================*/
+/* Module local definitions.                                                 */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Module exported variables.                                                */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Module local types.                                                       */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Module local variables.                                                   */
+/*===========================================================================*/
+
+#if PORT_SUPPORTS_RT == TRUE
+/*
+ * Realtime counter frequency, zero if not yet measured.
+ */
+static uint64_t rt_frequency = (uint64_t)BENCH_TIMER_CFG_RT_FREQUENCY;
+#endif
+
+/*===========================================================================*/
+/* Module local functions.                                                   */
+/*===========================================================================*/
+
+#if PORT_SUPPORTS_RT == TRUE
+/*
+ * Counts the realtime counter cycles between two system ticks separated
+ * by the calibration time, both samples are taken just after a wakeup.
+ */
+static void rt_calibrate(void) {
+  systime_t start;
+  rtcnt_t cnt;
+
+  chThdSleep(1);
+  start = chVTGetSystemTime();
+  cnt = chSysGetRealtimeCounterX();
+  chThdSleepUntil(chTimeAddX(start, TIME_MS2I(BENCH_TIMER_CFG_CALIBRATION)));
+  cnt = chSysGetRealtimeCounterX() - cnt;
+
+  rt_frequency = ((uint64_t)cnt * 1000U) /
+                 (uint64_t)BENCH_TIMER_CFG_CALIBRATION;
+}
+#endif
+
+/*===========================================================================*/
+/* Module exported functions.                                                */
+/*===========================================================================*/
+
+/**
+ * @brief   Starts a measurement.
+ * @note    The first call can take @p BENCH_TIMER_CFG_CALIBRATION
+ *          milliseconds because the counter frequency is measured.
+ *
+ * @param[out] btp      pointer to the @p bench_timer_t object
+ */
+void bench_timer_start(bench_timer_t *btp) {
+
+#if PORT_SUPPORTS_RT == TRUE
+  if (rt_frequency == 0U) {
+    rt_calibrate();
+  }
+  btp->time = chVTGetSystemTimeX();
+  btp->cnt  = chSysGetRealtimeCounterX();
+#else
+  btp->time = chVTGetSystemTimeX();
+#endif
+}
+
+/**
+ * @brief   Time elapsed since the start of the measurement.
+ *
+ * @param[in] btp       pointer to the @p bench_timer_t object
+ * @return              The elapsed time in microseconds.
+ */
+uint64_t bench_timer_elapsed_us(const bench_timer_t *btp) {
+  uint64_t us;
+
+#if PORT_SUPPORTS_RT == TRUE
+  rtcnt_t cnt = chSysGetRealtimeCounterX() - btp->cnt;
+
+  /* The counter is only used while far from wrapping.*/
+  us = (uint64_t)TIME_I2MS(chTimeDiffX(btp->time, chVTGetSystemTimeX())) *
+       1000U;
+  if (us < ((((uint64_t)(rtcnt_t)-1) / 2U) * 1000000U) / rt_frequency) {
+    us = ((uint64_t)cnt * 1000000U) / rt_frequency;
+  }
+#else
+  us = (uint64_t)TIME_I2MS(chTimeDiffX(btp->time, chVTGetSystemTimeX())) *
+       1000U;
+#endif
+
+  return us;
+}
+
+/**
+ * @brief   Events per second since the start of the measurement.
+ *
+ * @param[in] btp       pointer to the @p bench_timer_t object
+ * @param[in] n         number of events counted since the start
+ * @return              The rate, zero if no time elapsed.
+ */
+uint32_t bench_timer_rate(const bench_timer_t *btp, uint64_t n) {
+  uint64_t us = bench_timer_elapsed_us(btp);
+
+  if (us == 0U) {
+    return 0U;
+  }
+
+  return (uint32_t)((n * 1000000U) / us);
+}
+
+/** @} */
@@ -0,0 +1,109 @@
+/*
+    ChibiOS - Copyright (C) 2006..2018 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+/**
+ * @file    bench_timer.h
+ * @brief   Benchmarks timing helper header.
+ * @details Intervals are measured using the realtime counter, the system
+ *          time is used for intervals longer than half the counter wrap
+ *          period or if the port has no realtime counter. The counter
+ *          frequency is measured against the system time on first use
+ *          unless specified by @p BENCH_TIMER_CFG_RT_FREQUENCY.
+ *
+ * @addtogroup BENCH_TIMER
+ * @{
+ */
+
+#ifndef BENCH_TIMER_H
+#define BENCH_TIMER_H
+
+/*===========================================================================*/
+/* Module constants.                                                         */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Module pre-compile time settings.                                         */
+/*===========================================================================*/
+
+/**
+ * @name    Configuration options
+ * @{
+ */
+/**
+ * @brief   Realtime counter frequency in Hz.
+ * @note    Zero means that the frequency is measured at runtime.
+ */
+#if !defined(BENCH_TIMER_CFG_RT_FREQUENCY) || defined(__DOXYGEN__)
+#define BENCH_TIMER_CFG_RT_FREQUENCY        0
+#endif
+
+/**
+ * @brief   Duration of the frequency measurement in milliseconds.
+ */
+#if !defined(BENCH_TIMER_CFG_CALIBRATION) || defined(__DOXYGEN__)
+#define BENCH_TIMER_CFG_CALIBRATION         200
+#endif
+/** @} */
+
+/*===========================================================================*/
+/* Derived constants and error checks.                                       */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Module data structures and types.                                         */
+/*===========================================================================*/
+
+/**
+ * @brief   Type of a benchmark timer.
+ */
+typedef struct {
+  /**
+   * @brief   System time at start.
+   */
+  systime_t             time;
+#if (PORT_SUPPORTS_RT == TRUE) || defined(__DOXYGEN__)
+  /**
+   * @brief   Realtime counter at start.
+   */
+  rtcnt_t               cnt;
+#endif
+} bench_timer_t;
+
+/*===========================================================================*/
+/* Module macros.                                                            */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* External declarations.                                                    */
+/*===========================================================================*/
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+  void bench_timer_start(bench_timer_t *btp);
+  uint64_t bench_timer_elapsed_us(const bench_timer_t *btp);
+  uint32_t bench_timer_rate(const bench_timer_t *btp, uint64_t n);
+#ifdef __cplusplus
+}
+#endif
+
+/*===========================================================================*/
+/* Module inline functions.                                                  */
+/*===========================================================================*/
+
+#endif /* BENCH_TIMER_H */
+
+/** @} */
@@ -0,0 +1,298 @@
+/*
+    ChibiOS - Copyright (C) 2006..2018 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+/**
+ * @file    blkqueue_bench.c
+ * @brief   Block queue IOPS benchmark code.
+ *
+ * @addtogroup BLKQUEUE_BENCH
+ * @{
+ */
+
+#include "ch.h"
+#include "hal.h"
+
+#include "chprintf.h"
+#include "bench_timer.h"
+#include "blkqueue_bench.h"
+
+/*===========================================================================*/
+/* Module local definitions.                                                 */
+/*===========================================================================*/
+
+/**
+ * @name    Test modes
+ * @{
+ */
+#define MODE_DIRECT_WRITE       0U
+#define MODE_DIRECT_READ        1U
+#define MODE_QUEUED_WRITE       2U
+#define MODE_QUEUED_RANDOM      3U
+#define MODE_QUEUED_READ        4U
+/** @} */
+
+/*===========================================================================*/
+/* Module exported variables.                                                */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Module local types.                                                       */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Module local variables.                                                   */
+/*===========================================================================*/
+
+static THD_WORKING_AREA(wa_clients[BLKQUEUE_BENCH_CFG_THREADS],
+                        BLKQUEUE_BENCH_CFG_STACK_SIZE);
+
+static THD_WORKING_AREA(wa_worker, BLKQUEUE_BENCH_CFG_STACK_SIZE);
+
+static uint8_t buffers[BLKQUEUE_BENCH_CFG_THREADS][BLKQUEUE_BENCH_CFG_DEPTH]
+                      [BLKQUEUE_BENCH_CFG_BLOCK_SIZE];
+
+static uint8_t staging[BLKQUEUE_BENCH_CFG_DEPTH * BLKQUEUE_BENCH_CFG_BLOCK_SIZE];
+
+static blkq_request_t requests[BLKQUEUE_BENCH_CFG_THREADS]
+                              [BLKQUEUE_BENCH_CFG_DEPTH];
+
+static blkqueue_t bq;
+
+/*
+ * Serializes the direct accesses to the device.
+ */
+static MUTEX_DECL(device_mtx);
+
+static BaseBlockDevice *bench_bdp;
+
+static unsigned bench_mode;
+
+/*
+ * Data errors counter.
+ */
+static volatile uint32_t errors;
+
+/*===========================================================================*/
+/* Module local functions.                                                   */
+/*===========================================================================*/
+
+/*
+ * Block pattern, the content only depends on the block number.
+ */
+static void fill_block(uint8_t *bp, uint32_t blk) {
+  unsigned i;
+
+  for (i = 0U; i < BLKQUEUE_BENCH_CFG_BLOCK_SIZE; i++) {
+    bp[i] = (uint8_t)(blk + (i * 7U));
+  }
+}
+
+static void check_block(const uint8_t *bp, uint32_t blk) {
+  unsigned i;
+
+  for (i = 0U; i < BLKQUEUE_BENCH_CFG_BLOCK_SIZE; i++) {
+    if (bp[i] != (uint8_t)(blk + (i * 7U))) {
+      errors++;
+      return;
+    }
+  }
+}
+
+/*
+ * Client thread, the argument is the thread index. The thread transfers
+ * the blocks of its own area one at time.
+ */
+static THD_FUNCTION(client_thread, arg) {
+  unsigned t = (unsigned)(uintptr_t)arg;
+  uint32_t base = (uint32_t)t * BLKQUEUE_BENCH_CFG_BLOCKS;
+  uint32_t seed = base + 1U;
+  unsigned i, slot;
+
+  for (i = 0U; i < BLKQUEUE_BENCH_CFG_BLOCKS; i++) {
+    uint32_t blk;
+    uint8_t *bp;
+
+    slot = i % BLKQUEUE_BENCH_CFG_DEPTH;
+    bp   = buffers[t][slot];
+
+    if (bench_mode == MODE_QUEUED_RANDOM) {
+      seed = (seed * 1103515245U) + 12345U;
+      blk  = base + ((seed >> 8) % BLKQUEUE_BENCH_CFG_BLOCKS);
+    }
+    else {
+      blk = base + i;
+    }
+
+    switch (bench_mode) {
+    case MODE_DIRECT_WRITE:
+      fill_block(bp, blk);
+      chMtxLock(&device_mtx);
+      if (blkWrite(bench_bdp, blk, bp, 1U) != HAL_SUCCESS) {
+        errors++;
+      }
+      chMtxUnlock(&device_mtx);
+      break;
+    case MODE_DIRECT_READ:
+      chMtxLock(&device_mtx);
+      if (blkRead(bench_bdp, blk, bp, 1U) != HAL_SUCCESS) {
+        errors++;
+      }
+      chMtxUnlock(&device_mtx);
+      check_block(bp, blk);
+      break;
+    default:
+      /* Reusing the oldest request slot.*/
+      if (i >= BLKQUEUE_BENCH_CFG_DEPTH) {
+        if (blkqWaitTimeout(&requests[t][slot], TIME_INFINITE) != MSG_OK) {
+          errors++;
+        }
+        if (bench_mode == MODE_QUEUED_READ) {
+          check_block(bp, requests[t][slot].startblk);
+        }
+      }
+      if (bench_mode == MODE_QUEUED_READ) {
+        blkqStartRead(&bq, &requests[t][slot], blk, bp, 1U, NULL, NULL);
+      }
+      else {
+        fill_block(bp, blk);
+        blkqStartWrite(&bq, &requests[t][slot], blk, bp, 1U, NULL, NULL);
+      }
+      break;
+    }
+  }
+
+  /* Waiting for the requests still in flight.*/
+  if (bench_mode >= MODE_QUEUED_WRITE) {
+    for (slot = 0U; slot < BLKQUEUE_BENCH_CFG_DEPTH; slot++) {
+      if (blkqWaitTimeout(&requests[t][slot], TIME_INFINITE) != MSG_OK) {
+        errors++;
+      }
+      if (bench_mode == MODE_QUEUED_READ) {
+        check_block(buffers[t][slot], requests[t][slot].startblk);
+      }
+    }
+  }
+}
+
+static void bench_run(const blkqueue_bench_config_t *cfg,
+                      const char *name, unsigned mode) {
+  thread_t *tps[BLKQUEUE_BENCH_CFG_THREADS];
+  ramdisk_stats_t stats;
+  bench_timer_t bt;
+  uint32_t total;
+  unsigned t;
+
+  chprintf(cfg->out, "--- %-14s: ", name);
+
+  if (cfg->rdp != NULL) {
+    ramdiskResetStats(cfg->rdp);
+  }
+  bench_mode = mode;
+  errors     = 0U;
+
+  bench_timer_start(&bt);
+
+  for (t = 0U; t < BLKQUEUE_BENCH_CFG_THREADS; t++) {
+    tps[t] = chThdCreateStatic(wa_clients[t], sizeof (wa_clients[t]),
+                               chThdGetPriorityX() - 1, client_thread,
+                               (void *)(uintptr_t)t);
+  }
+  for (t = 0U; t < BLKQUEUE_BENCH_CFG_THREADS; t++) {
+    (void) chThdWait(tps[t]);
+  }
+
+  total = (uint32_t)BLKQUEUE_BENCH_CFG_THREADS * BLKQUEUE_BENCH_CFG_BLOCKS;
+  chprintf(cfg->out, "%7u IOPS, %7u KB/s",
+           (unsigned)bench_timer_rate(&bt, total),
+           (unsigned)(bench_timer_rate(&bt, (uint64_t)total *
+                                            BLKQUEUE_BENCH_CFG_BLOCK_SIZE) /
+                      1024U));
+
+  if (cfg->rdp != NULL) {
+    ramdiskGetStats(cfg->rdp, &stats);
+    chprintf(cfg->out, ", %5u commands",
+             (unsigned)(stats.reads + stats.writes));
+  }
+  if (errors > 0U) {
+    chprintf(cfg->out, ", %u errors", (unsigned)errors);
+  }
+  chprintf(cfg->out, "\r\n");
+}
+
+/*===========================================================================*/
+/* Module exported functions.                                                */
+/*===========================================================================*/
+
+/**
+ * @brief   Block queue IOPS benchmark.
+ * @note    The content of the device is overwritten.
+ *
+ * @param[in] cfg       pointer to the configuration structure
+ */
+void blkqueue_bench_execute(const blkqueue_bench_config_t *cfg) {
+  blkq_config_t bqcfg;
+  BlockDeviceInfo bdi;
+  sysinterval_t latency = (sysinterval_t)0;
+
+  chprintf(cfg->out, "\r\n*** Block queue IOPS, %u threads, %u blocks "
+                     "each, %u requests in flight",
+           (unsigned)BLKQUEUE_BENCH_CFG_THREADS,
+           (unsigned)BLKQUEUE_BENCH_CFG_BLOCKS,
+           (unsigned)BLKQUEUE_BENCH_CFG_DEPTH);
+  if (cfg->rdp != NULL) {
+    chprintf(cfg->out, ", %u ms latency",
+             (unsigned)BLKQUEUE_BENCH_CFG_LATENCY);
+  }
+  chprintf(cfg->out, "\r\n");
+
+  if ((blkGetInfo(cfg->bdp, &bdi) != HAL_SUCCESS) ||
+      (bdi.blk_size != BLKQUEUE_BENCH_CFG_BLOCK_SIZE) ||
+      (bdi.blk_num < (uint32_t)BLKQUEUE_BENCH_CFG_THREADS *
+                     BLKQUEUE_BENCH_CFG_BLOCKS)) {
+    chprintf(cfg->out, "--- Unsuitable device\r\n");
+    return;
+  }
+  bench_bdp = cfg->bdp;
+
+  if (cfg->rdp != NULL) {
+    latency = cfg->rdp->latency;
+    ramdiskSetLatency(cfg->rdp, TIME_MS2I(BLKQUEUE_BENCH_CFG_LATENCY));
+  }
+
+  bench_run(cfg, "Direct write", MODE_DIRECT_WRITE);
+  bench_run(cfg, "Direct read", MODE_DIRECT_READ);
+
+  bqcfg.bdp    = cfg->bdp;
+  bqcfg.buffer = staging;
+  bqcfg.size   = sizeof (staging);
+  bqcfg.wsp    = wa_worker;
+  bqcfg.wsize  = sizeof (wa_worker);
+  bqcfg.prio   = chThdGetPriorityX() + 1;
+  blkqObjectInit(&bq);
+  (void) blkqStart(&bq, &bqcfg);
+
+  bench_run(cfg, "Queued write", MODE_QUEUED_WRITE);
+  bench_run(cfg, "Queued random", MODE_QUEUED_RANDOM);
+  bench_run(cfg, "Queued read", MODE_QUEUED_READ);
+
+  blkqStop(&bq);
+
+  if (cfg->rdp != NULL) {
+    ramdiskSetLatency(cfg->rdp, latency);
+  }
+}
+
+/** @} */
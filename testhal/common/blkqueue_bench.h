@@ -0,0 +1,147 @@
+/*
+    ChibiOS - Copyright (C) 2006..2018 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+/**
+ * @file    blkqueue_bench.h
+ * @brief   Block queue IOPS benchmark header.
+ * @details Several client threads perform single block transfers, each
+ *          one in its own area of the device, first calling the block
+ *          device directly then through a block queue keeping several
+ *          requests in flight. The data is checked, IOPS, throughput and
+ *          device commands are reported.
+ *
+ * @addtogroup BLKQUEUE_BENCH
+ * @{
+ */
+
+#ifndef BLKQUEUE_BENCH_H
+#define BLKQUEUE_BENCH_H
+
+#include "ramdisk.h"
+#include "blkqueue.h"
+
+/*===========================================================================*/
+/* Module constants.                                                         */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Module pre-compile time settings.                                         */
+/*===========================================================================*/
+
+/**
+ * @name    Configuration options
+ * @{
+ */
+/**
+ * @brief   Number of client threads.
+ */
+#if !defined(BLKQUEUE_BENCH_CFG_THREADS) || defined(__DOXYGEN__)
+#define BLKQUEUE_BENCH_CFG_THREADS          4
+#endif
+
+/**
+ * @brief   Number of blocks transferred by each thread.
+ * @note    The device must have at least
+ *          @p BLKQUEUE_BENCH_CFG_THREADS * @p BLKQUEUE_BENCH_CFG_BLOCKS
+ *          blocks.
+ */
+#if !defined(BLKQUEUE_BENCH_CFG_BLOCKS) || defined(__DOXYGEN__)
+#define BLKQUEUE_BENCH_CFG_BLOCKS           256
+#endif
+
+/**
+ * @brief   Requests in flight for each thread.
+ */
+#if !defined(BLKQUEUE_BENCH_CFG_DEPTH) || defined(__DOXYGEN__)
+#define BLKQUEUE_BENCH_CFG_DEPTH            8
+#endif
+
+/**
+ * @brief   Device block size.
+ */
+#if !defined(BLKQUEUE_BENCH_CFG_BLOCK_SIZE) || defined(__DOXYGEN__)
+#define BLKQUEUE_BENCH_CFG_BLOCK_SIZE       512
+#endif
+
+/**
+ * @brief   Emulated command latency in milliseconds.
+ * @details The latency is applied to the RAM disk, if any, for the duration
+ *          of the benchmark, without it the commands cost is just a copy
+ *          and merging requests makes little difference.
+ */
+#if !defined(BLKQUEUE_BENCH_CFG_LATENCY) || defined(__DOXYGEN__)
+#define BLKQUEUE_BENCH_CFG_LATENCY          1
+#endif
+
+/**
+ * @brief   Stack size of the client and worker threads.
+ */
+#if !defined(BLKQUEUE_BENCH_CFG_STACK_SIZE) || defined(__DOXYGEN__)
+#define BLKQUEUE_BENCH_CFG_STACK_SIZE       512
+#endif
+/** @} */
+
+/*===========================================================================*/
+/* Derived constants and error checks.                                       */
+/*===========================================================================*/
+
+#if (BLKQUEUE_BENCH_CFG_THREADS < 1) || (BLKQUEUE_BENCH_CFG_DEPTH < 1) ||   \
+    ((BLKQUEUE_BENCH_CFG_BLOCKS % BLKQUEUE_BENCH_CFG_DEPTH) != 0)
+#error "invalid BLKQUEUE_BENCH_CFG_* settings"
+#endif
+
+/*===========================================================================*/
+/* Module data structures and types.                                         */
+/*===========================================================================*/
+
+typedef struct {
+  /**
+   * @brief   Stream for output.
+   */
+  BaseSequentialStream  *out;
+  /**
+   * @brief   Block device, it must be in the @p BLK_READY state.
+   */
+  BaseBlockDevice       *bdp;
+  /**
+   * @brief   RAM disk behind the device or @p NULL.
+   */
+  RamDisk               *rdp;
+} blkqueue_bench_config_t;
+
+/*===========================================================================*/
+/* Module macros.                                                            */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* External declarations.                                                    */
+/*===========================================================================*/
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+  void blkqueue_bench_execute(const blkqueue_bench_config_t *cfg);
+#ifdef __cplusplus
+}
+#endif
+
+/*===========================================================================*/
+/* Module inline functions.                                                  */
+/*===========================================================================*/
+
+#endif /* BLKQUEUE_BENCH_H */
+
+/** @} */
@@ -0,0 +1,435 @@
+/*
+    ChibiOS - Copyright (C) 2006..2018 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+/**
+ * @file    bsched_bench.c
+ * @brief   Bus scheduler benchmark code.
+ *
+ * @addtogroup BSCHED_BENCH
+ * @{
+ */
+
+#include "ch.h"
+#include "hal.h"
+
+#include "chprintf.h"
+#include "bench_timer.h"
+#include "bsched_bench.h"
+
+/*===========================================================================*/
+/* Module local definitions.                                                 */
+/*===========================================================================*/
+
+/**
+ * @name    Test modes
+ * @{
+ */
+#define MODE_DIRECT             0U
+#define MODE_THREADS            1U
+#define MODE_CALLBACKS          2U
+#define MODE_MIXED              3U
+/** @} */
+
+/**
+ * @brief   Read bit of the register address.
+ */
+#define REG_READ                0x80U
+
+/**
+ * @brief   Registers accessed by a client.
+ */
+#define CLIENT_REGS             (BSCHED_BENCH_CFG_XFERS * BSCHED_BENCH_CFG_SIZE)
+
+/*===========================================================================*/
+/* Module exported variables.                                                */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Module local types.                                                       */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Module local variables.                                                   */
+/*===========================================================================*/
+
+static THD_WORKING_AREA(wa_clients[BSCHED_BENCH_CFG_CLIENTS],
+                        BSCHED_BENCH_CFG_STACK_SIZE);
+
+static uint8_t rxbufs[BSCHED_BENCH_CFG_CLIENTS][CLIENT_REGS];
+
+static uint8_t regs[BSCHED_BENCH_CFG_CLIENTS][BSCHED_BENCH_CFG_XFERS];
+
+static bsched_xfer_t xfers[BSCHED_BENCH_CFG_CLIENTS][BSCHED_BENCH_CFG_XFERS];
+
+static bsched_chain_t chains[BSCHED_BENCH_CFG_CLIENTS];
+
+static uint32_t remaining[BSCHED_BENCH_CFG_CLIENTS];
+
+static BSchedDriver bsched;
+
+static BSchedConfig bsched_cfg;
+
+/*
+ * Signaled by the callback clients on completion.
+ */
+static SEMAPHORE_DECL(done_sem, 0);
+
+static const bsched_bench_config_t *bench_cfg;
+
+static unsigned bench_mode;
+
+/*
+ * Data errors counter.
+ */
+static volatile uint32_t errors;
+
+/*===========================================================================*/
+/* Module local functions.                                                   */
+/*===========================================================================*/
+
+/*
+ * Registers pattern, the content only depends on the register address.
+ */
+static uint8_t reg_value(unsigned reg) {
+
+  return (uint8_t)((reg * 7U) + 1U);
+}
+
+/*
+ * Checks the data of a client and clears the buffer for the next chain.
+ */
+static void check_client(unsigned c) {
+  unsigned i;
+
+  for (i = 0U; i < CLIENT_REGS; i++) {
+    if (rxbufs[c][i] != reg_value((c * CLIENT_REGS) + i)) {
+      errors++;
+      break;
+    }
+  }
+  for (i = 0U; i < CLIENT_REGS; i++) {
+    rxbufs[c][i] = 0U;
+  }
+}
+
+/*
+ * Executes a transfer through the bus driver, the bus is owned by the
+ * caller.
+ */
+static msg_t direct_xfer(const bsched_xfer_t *xp) {
+
+#if HAL_USE_I2C == TRUE
+  if (bench_cfg->bus == BSCHED_BUS_I2C) {
+    return i2cMasterTransmitTimeout(bench_cfg->i2cp, (i2caddr_t)xp->addr,
+                                    xp->txbuf, xp->txn,
+                                    xp->rxbuf, xp->rxn, TIME_INFINITE);
+  }
+#endif
+#if HAL_USE_SPI == TRUE
+  if (bench_cfg->bus == BSCHED_BUS_SPI) {
+    spiSelect(bench_cfg->spip);
+    spiSend(bench_cfg->spip, xp->txn, xp->txbuf);
+    if (xp->rxn > 0U) {
+      spiReceive(bench_cfg->spip, xp->rxn, xp->rxbuf);
+    }
+    spiUnselect(bench_cfg->spip);
+    return MSG_OK;
+  }
+#endif
+  return MSG_RESET;
+}
+
+/*
+ * Executes the transfers of a client chain through the bus driver.
+ */
+static void direct_chain(unsigned c) {
+  unsigned k;
+
+  for (k = 0U; k < BSCHED_BENCH_CFG_XFERS; k++) {
+    if (direct_xfer(&xfers[c][k]) != MSG_OK) {
+      errors++;
+    }
+  }
+}
+
+/*
+ * Bus ownership for the direct accesses without scheduler.
+ */
+static void direct_acquire(bool acquire) {
+
+#if HAL_USE_I2C == TRUE
+  if (bench_cfg->bus == BSCHED_BUS_I2C) {
+    if (acquire) {
+      i2cAcquireBus(bench_cfg->i2cp);
+    }
+    else {
+      i2cReleaseBus(bench_cfg->i2cp);
+    }
+  }
+#endif
+#if HAL_USE_SPI == TRUE
+  if (bench_cfg->bus == BSCHED_BUS_SPI) {
+    if (acquire) {
+      spiAcquireBus(bench_cfg->spip);
+    }
+    else {
+      spiReleaseBus(bench_cfg->spip);
+    }
+  }
+#endif
+}
+
+/*
+ * Chain completion callback, the chain is resubmitted until the client
+ * count is exhausted.
+ */
+static void chain_cb(bsched_chain_t *chp) {
+  unsigned c = (unsigned)(uintptr_t)chp->arg;
+
+  if (chp->result != MSG_OK) {
+    errors++;
+  }
+  check_client(c);
+  if (--remaining[c] > 0U) {
+    bschedSubmitI(&bsched, chp);
+  }
+  else {
+    chSemSignalI(&done_sem);
+  }
+}
+
+/*
+ * Client thread, the argument is the client index.
+ */
+static THD_FUNCTION(client_thread, arg) {
+  unsigned c = (unsigned)(uintptr_t)arg;
+  unsigned i;
+
+  for (i = 0U; i < BSCHED_BENCH_CFG_CHAINS; i++) {
+    switch (bench_mode) {
+    case MODE_DIRECT:
+      direct_acquire(true);
+      direct_chain(c);
+      direct_acquire(false);
+      break;
+    case MODE_THREADS:
+      bschedSubmit(&bsched, &chains[c]);
+      if (bschedWaitTimeout(&chains[c], TIME_INFINITE) != MSG_OK) {
+        errors++;
+      }
+      break;
+    default:
+      /* Synchronous accesses competing with the running chains.*/
+      bschedAcquireBus(&bsched);
+      direct_chain(c);
+      bschedReleaseBus(&bsched);
+      break;
+    }
+    check_client(c);
+  }
+}
+
+static void bench_run(const char *name, unsigned mode) {
+  thread_t *tps[BSCHED_BENCH_CFG_CLIENTS];
+  bsched_stats_t stats;
+  bench_timer_t bt;
+  uint32_t total, bits;
+  unsigned c;
+
+  chprintf(bench_cfg->out, "--- %-14s: ", name);
+
+  if (mode != MODE_DIRECT) {
+    bschedResetStats(&bsched);
+  }
+  bench_mode = mode;
+  errors     = 0U;
+
+  bench_timer_start(&bt);
+
+  for (c = 0U; c < BSCHED_BENCH_CFG_CLIENTS; c++) {
+    remaining[c] = BSCHED_BENCH_CFG_CHAINS;
+    if ((mode == MODE_CALLBACKS) || ((mode == MODE_MIXED) && (c > 0U))) {
+      tps[c] = NULL;
+      bschedSubmit(&bsched, &chains[c]);
+    }
+    else {
+      tps[c] = chThdCreateStatic(wa_clients[c], sizeof (wa_clients[c]),
+                                 chThdGetPriorityX() - 1, client_thread,
+                                 (void *)(uintptr_t)c);
+    }
+  }
+  for (c = 0U; c < BSCHED_BENCH_CFG_CLIENTS; c++) {
+    if (tps[c] != NULL) {
+      (void) chThdWait(tps[c]);
+    }
+    else {
+      chSemWait(&done_sem);
+    }
+  }
+
+  total = (uint32_t)BSCHED_BENCH_CFG_CLIENTS * BSCHED_BENCH_CFG_CHAINS;
+  chprintf(bench_cfg->out, "%7u chains/s",
+           (unsigned)bench_timer_rate(&bt, total));
+
+  /* Bits on the wire for a chain, I2C frames are nine bits with address,
+     register and repeated start address bytes, SPI frames are eight bits
+     with the register byte.*/
+  if (bench_cfg->bitrate > 0U) {
+    if (bench_cfg->bus == BSCHED_BUS_I2C) {
+      bits = (3U + BSCHED_BENCH_CFG_SIZE) * 9U;
+    }
+    else {
+      bits = (1U + BSCHED_BENCH_CFG_SIZE) * 8U;
+    }
+    bits *= BSCHED_BENCH_CFG_XFERS;
+    chprintf(bench_cfg->out, ", bus %3u%%",
+             (unsigned)(((uint64_t)bench_timer_rate(&bt,
+                                                    (uint64_t)total * bits) *
+                         100U) / bench_cfg->bitrate));
+  }
+
+  if (mode != MODE_DIRECT) {
+    bschedGetStats(&bsched, &stats);
+    chprintf(bench_cfg->out, ", %5u chains, %5u acquisitions",
+             (unsigned)stats.chains, (unsigned)stats.acquisitions);
+  }
+  if (errors > 0U) {
+    chprintf(bench_cfg->out, ", %u errors", (unsigned)errors);
+  }
+  chprintf(bench_cfg->out, "\r\n");
+}
+
+/*
+ * Writes the pattern in the registers of all clients, the bus driver is
+ * started.
+ */
+static bool write_pattern(void) {
+  uint8_t buf[1U + CLIENT_REGS];
+  bsched_xfer_t x;
+  unsigned c, i;
+
+  for (c = 0U; c < BSCHED_BENCH_CFG_CLIENTS; c++) {
+    buf[0] = (uint8_t)(c * CLIENT_REGS);
+    for (i = 0U; i < CLIENT_REGS; i++) {
+      buf[1U + i] = reg_value((c * CLIENT_REGS) + i);
+    }
+    bschedXferObjectInit(&x, xfers[c][0].addr, buf, sizeof (buf), NULL, 0U);
+    if (direct_xfer(&x) != MSG_OK) {
+      return false;
+    }
+  }
+
+  return true;
+}
+
+/*===========================================================================*/
+/* Module exported functions.                                                */
+/*===========================================================================*/
+
+/**
+ * @brief   Bus scheduler benchmark.
+ * @note    The registers of the devices are overwritten.
+ * @note    The bus driver must be stopped.
+ *
+ * @param[in] cfg       pointer to the configuration structure
+ */
+void bsched_bench_execute(const bsched_bench_config_t *cfg) {
+  uint16_t addr = 0U;
+  unsigned c, k;
+  bool ok;
+
+  chprintf(cfg->out, "\r\n*** Bus scheduler, %s, %u clients, %u chains "
+                     "each, %u x %u bytes per chain\r\n",
+           cfg->bus == BSCHED_BUS_I2C ? "I2C" : "SPI",
+           (unsigned)BSCHED_BENCH_CFG_CLIENTS,
+           (unsigned)BSCHED_BENCH_CFG_CHAINS,
+           (unsigned)BSCHED_BENCH_CFG_XFERS,
+           (unsigned)BSCHED_BENCH_CFG_SIZE);
+
+  bench_cfg = cfg;
+  bsched_cfg.bus = cfg->bus;
+#if HAL_USE_I2C == TRUE
+  bsched_cfg.i2cp   = cfg->i2cp;
+  bsched_cfg.i2ccfg = cfg->i2ccfg;
+#endif
+#if HAL_USE_SPI == TRUE
+  bsched_cfg.spip   = cfg->spip;
+  bsched_cfg.spicfg = cfg->spicfg;
+#endif
+
+  for (c = 0U; c < BSCHED_BENCH_CFG_CLIENTS; c++) {
+#if HAL_USE_I2C == TRUE
+    if (cfg->bus == BSCHED_BUS_I2C) {
+      addr = (uint16_t)cfg->addrs[c];
+    }
+#endif
+    for (k = 0U; k < BSCHED_BENCH_CFG_XFERS; k++) {
+      regs[c][k] = (uint8_t)(((c * CLIENT_REGS) +
+                              (k * BSCHED_BENCH_CFG_SIZE)) | REG_READ);
+      bschedXferObjectInit(&xfers[c][k], addr, &regs[c][k], 1U,
+                           &rxbufs[c][k * BSCHED_BENCH_CFG_SIZE],
+                           BSCHED_BENCH_CFG_SIZE);
+    }
+    bschedChainObjectInit(&chains[c], xfers[c], BSCHED_BENCH_CFG_XFERS,
+                          NULL, (void *)(uintptr_t)c);
+  }
+
+  /* Direct accesses.*/
+#if HAL_USE_I2C == TRUE
+  if (cfg->bus == BSCHED_BUS_I2C) {
+    i2cStart(cfg->i2cp, cfg->i2ccfg);
+  }
+#endif
+#if HAL_USE_SPI == TRUE
+  if (cfg->bus == BSCHED_BUS_SPI) {
+    spiStart(cfg->spip, cfg->spicfg);
+  }
+#endif
+  ok = write_pattern();
+  if (ok) {
+    bench_run("Direct", MODE_DIRECT);
+  }
+  else {
+    chprintf(cfg->out, "--- Device not responding\r\n");
+  }
+#if HAL_USE_I2C == TRUE
+  if (cfg->bus == BSCHED_BUS_I2C) {
+    i2cStop(cfg->i2cp);
+  }
+#endif
+#if HAL_USE_SPI == TRUE
+  if (cfg->bus == BSCHED_BUS_SPI) {
+    spiStop(cfg->spip);
+  }
+#endif
+
+  if (!ok) {
+    return;
+  }
+
+  /* Scheduled accesses.*/
+  bschedObjectInit(&bsched);
+  bschedStart(&bsched, &bsched_cfg);
+  bench_run("Threads", MODE_THREADS);
+  for (c = 0U; c < BSCHED_BENCH_CFG_CLIENTS; c++) {
+    chains[c].cb = chain_cb;
+  }
+  bench_run("Callbacks", MODE_CALLBACKS);
+  bench_run("Mixed", MODE_MIXED);
+  bschedStop(&bsched);
+}
+
+/** @} */
@@ -0,0 +1,176 @@
+/*
+    ChibiOS - Copyright (C) 2006..2018 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+/**
+ * @file    bsched_bench.h
+ * @brief   Bus scheduler benchmark header.
+ * @details Several clients read register blocks from devices sharing a
+ *          bus. The clients first access the bus driver directly, each
+ *          one acquiring the bus for its own transfers, then the same
+ *          transfers are executed as bus scheduler chains submitted from
+ *          threads, resubmitted from the completion callbacks and mixed
+ *          with a thread acquiring the bus. Chains throughput and bus
+ *          utilization are reported.
+ * @note    The devices are registers files, the benchmark writes a known
+ *          pattern before reading it back so it is meant for simulated
+ *          buses.
+ *
+ * @addtogroup BSCHED_BENCH
+ * @{
+ */
+
+#ifndef BSCHED_BENCH_H
+#define BSCHED_BENCH_H
+
+#include "hal_bus_scheduler.h"
+
+/*===========================================================================*/
+/* Module constants.                                                         */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Module pre-compile time settings.                                         */
+/*===========================================================================*/
+
+/**
+ * @name    Configuration options
+ * @{
+ */
+/**
+ * @brief   Number of clients.
+ */
+#if !defined(BSCHED_BENCH_CFG_CLIENTS) || defined(__DOXYGEN__)
+#define BSCHED_BENCH_CFG_CLIENTS            3
+#endif
+
+/**
+ * @brief   Number of chains executed by each client.
+ */
+#if !defined(BSCHED_BENCH_CFG_CHAINS) || defined(__DOXYGEN__)
+#define BSCHED_BENCH_CFG_CHAINS             300
+#endif
+
+/**
+ * @brief   Number of transfers in a chain.
+ */
+#if !defined(BSCHED_BENCH_CFG_XFERS) || defined(__DOXYGEN__)
+#define BSCHED_BENCH_CFG_XFERS              2
+#endif
+
+/**
+ * @brief   Number of bytes read by a transfer.
+ */
+#if !defined(BSCHED_BENCH_CFG_SIZE) || defined(__DOXYGEN__)
+#define BSCHED_BENCH_CFG_SIZE               12
+#endif
+
+/**
+ * @brief   Stack size of the client threads.
+ */
+#if !defined(BSCHED_BENCH_CFG_STACK_SIZE) || defined(__DOXYGEN__)
+#define BSCHED_BENCH_CFG_STACK_SIZE         512
+#endif
+/** @} */
+
+/*===========================================================================*/
+/* Derived constants and error checks.                                       */
+/*===========================================================================*/
+
+#if (BSCHED_BENCH_CFG_CLIENTS < 1) || (BSCHED_BENCH_CFG_CHAINS < 1) ||      \
+    (BSCHED_BENCH_CFG_XFERS < 1) || (BSCHED_BENCH_CFG_SIZE < 1)
+#error "invalid BSCHED_BENCH_CFG_* settings"
+#endif
+
+/* Registers are addressed with seven bits.*/
+#if BSCHED_BENCH_CFG_CLIENTS * BSCHED_BENCH_CFG_XFERS *                     \
+    BSCHED_BENCH_CFG_SIZE > 128
+#error "BSCHED_BENCH_CFG_* settings exceed the registers space"
+#endif
+
+/*===========================================================================*/
+/* Module data structures and types.                                         */
+/*===========================================================================*/
+
+/**
+ * @brief   Type of a benchmark configuration.
+ * @details Each client accesses its own range of registers, on I2C the
+ *          clients can be assigned to different devices. The register
+ *          address of a read is sent with bit 7 set, it is the read bit of
+ *          the ST SPI protocol and the auto-increment bit of the ST I2C
+ *          protocol.
+ */
+typedef struct {
+  /**
+   * @brief   Stream for output.
+   */
+  BaseSequentialStream  *out;
+  /**
+   * @brief   Bus type.
+   */
+  unsigned              bus;
+#if (HAL_USE_I2C == TRUE) || defined(__DOXYGEN__)
+  /**
+   * @brief   I2C driver.
+   */
+  I2CDriver             *i2cp;
+  /**
+   * @brief   I2C configuration.
+   */
+  const I2CConfig       *i2ccfg;
+  /**
+   * @brief   I2C slave address of each client.
+   */
+  const i2caddr_t       *addrs;
+#endif
+#if (HAL_USE_SPI == TRUE) || defined(__DOXYGEN__)
+  /**
+   * @brief   SPI driver.
+   */
+  SPIDriver             *spip;
+  /**
+   * @brief   SPI configuration without callback.
+   */
+  const SPIConfig       *spicfg;
+#endif
+  /**
+   * @brief   Bus bit rate for the utilization estimate, zero if unknown.
+   */
+  uint32_t              bitrate;
+} bsched_bench_config_t;
+
+/*===========================================================================*/
+/* Module macros.                                                            */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* External declarations.                                                    */
+/*===========================================================================*/
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+  void bsched_bench_execute(const bsched_bench_config_t *cfg);
+#ifdef __cplusplus
+}
+#endif
+
+/*===========================================================================*/
+/* Module inline functions.                                                  */
+/*===========================================================================*/
+
+#endif /* BSCHED_BENCH_H */
+
+/** @} */
@@ -0,0 +1,192 @@
+/*
+    ChibiOS - Copyright (C) 2006..2018 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+/**
+ * @file    bsio_bench.c
+ * @brief   Buffered SIO throughput benchmark code.
+ *
+ * @addtogroup BSIO_BENCH
+ * @{
+ */
+
+#include "ch.h"
+#include "hal.h"
+
+#include "chprintf.h"
+#include "bench_timer.h"
+#include "bsio_bench.h"
+
+/*===========================================================================*/
+/* Module local definitions.                                                 */
+/*===========================================================================*/
+
+/**
+ * @brief   Error events reported by the benchmark.
+ */
+#define ERROR_FLAGS             (BSIO_PARITY_ERROR | BSIO_FRAMING_ERROR |   \
+                                 BSIO_OVERRUN_ERROR | BSIO_NOISE_ERROR |    \
+                                 BSIO_BREAK_DETECTED | BSIO_QUEUE_FULL_ERROR)
+
+/*===========================================================================*/
+/* Module exported variables.                                                */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Module local types.                                                       */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Module local variables.                                                   */
+/*===========================================================================*/
+
+static THD_WORKING_AREA(wa_writer, BSIO_BENCH_CFG_STACK_SIZE);
+
+static BufferedSIODriver *writer_bsiop;
+
+static uint8_t txbuf[BSIO_BENCH_CFG_MAX_CHUNK];
+
+static uint8_t rxbuf[BSIO_BENCH_CFG_MAX_CHUNK];
+
+/*===========================================================================*/
+/* Module local functions.                                                   */
+/*===========================================================================*/
+
+/*
+ * Pattern byte at the specified stream offset.
+ */
+static uint8_t pattern(size_t offset) {
+
+  return (uint8_t)(offset ^ (offset >> 8));
+}
+
+/*
+ * Writer thread, the argument is the chunk size. The thread sends the whole
+ * transfer size then terminates.
+ */
+static THD_FUNCTION(writer_thread, arg) {
+  size_t chunk = (size_t)arg;
+  size_t offset = 0U;
+
+  while (offset < BSIO_BENCH_CFG_TRANSFER_SIZE) {
+    size_t i;
+
+    for (i = 0U; i < chunk; i++) {
+      txbuf[i] = pattern(offset + i);
+    }
+    if (chnWriteTimeout(writer_bsiop, txbuf, chunk,
+                        TIME_MS2I(BSIO_BENCH_CFG_TIMEOUT)) != chunk) {
+      break;
+    }
+    offset += chunk;
+  }
+}
+
+/*
+ * Transfer benchmark using the specified chunk size for both writing and
+ * reading.
+ */
+static bool bench_transfer(const bsio_bench_config_t *cfg,
+                           event_listener_t *elp, size_t chunk) {
+  bench_timer_t bt;
+  eventflags_t flags;
+  thread_t *tp;
+  size_t offset;
+
+  chprintf(cfg->out, "--- Chunk %4u : ", (unsigned)chunk);
+
+  (void) chEvtGetAndClearFlags(elp);
+
+  bench_timer_start(&bt);
+
+  /* The writer runs below the reader, the input queue is drained as soon
+     as the data is available.*/
+  writer_bsiop = cfg->bsiop;
+  tp = chThdCreateStatic(wa_writer, sizeof (wa_writer),
+                         chThdGetPriorityX() - 1, writer_thread,
+                         (void *)chunk);
+
+  offset = 0U;
+  while (offset < BSIO_BENCH_CFG_TRANSFER_SIZE) {
+    size_t i, n;
+
+    n = chnReadTimeout(cfg->bsiop, rxbuf, chunk,
+                       TIME_MS2I(BSIO_BENCH_CFG_TIMEOUT));
+    for (i = 0U; i < n; i++) {
+      if (rxbuf[i] != pattern(offset + i)) {
+        break;
+      }
+    }
+    if ((i < n) || (n < chunk)) {
+      chprintf(cfg->out, "%s at offset %u\r\n",
+               i < n ? "data mismatch" : "data lost",
+               (unsigned)(offset + i));
+      (void) chThdWait(tp);
+      return false;
+    }
+    offset += n;
+  }
+
+  chprintf(cfg->out, "%8u KB/s",
+           (unsigned)(bench_timer_rate(&bt, BSIO_BENCH_CFG_TRANSFER_SIZE) /
+                      1024U));
+  (void) chThdWait(tp);
+
+  flags = chEvtGetAndClearFlags(elp);
+  if ((flags & ERROR_FLAGS) != (eventflags_t)0) {
+    chprintf(cfg->out, ", error flags %x", (unsigned)(flags & ERROR_FLAGS));
+  }
+  chprintf(cfg->out, "\r\n");
+
+  return true;
+}
+
+/*===========================================================================*/
+/* Module exported functions.                                                */
+/*===========================================================================*/
+
+/**
+ * @brief   Buffered SIO throughput benchmark.
+ * @details The driver is started and stopped by the benchmark.
+ *
+ * @param[in] cfg       pointer to the configuration structure
+ */
+void bsio_bench_execute(const bsio_bench_config_t *cfg) {
+  static const size_t chunks[] = {1U, 16U, BUFFERED_SIO_BUFFERS_SIZE,
+                                  BSIO_BENCH_CFG_MAX_CHUNK};
+  event_listener_t el;
+  unsigned i;
+
+  chprintf(cfg->out, "\r\n*** Buffered SIO throughput, %u bytes transfers, "
+                     "%u bytes queues\r\n",
+           (unsigned)BSIO_BENCH_CFG_TRANSFER_SIZE,
+           (unsigned)BUFFERED_SIO_BUFFERS_SIZE);
+
+  bsioStart(cfg->bsiop, cfg->siocfg);
+  chEvtRegisterMaskWithFlags(chnGetEventSource(cfg->bsiop), &el,
+                             EVENT_MASK(0), ERROR_FLAGS);
+
+  for (i = 0U; i < sizeof (chunks) / sizeof (chunks[0]); i++) {
+    if ((chunks[i] <= BSIO_BENCH_CFG_MAX_CHUNK) &&
+        !bench_transfer(cfg, &el, chunks[i])) {
+      break;
+    }
+  }
+
+  chEvtUnregister(chnGetEventSource(cfg->bsiop), &el);
+  bsioStop(cfg->bsiop);
+}
+
+/** @} */
@@ -0,0 +1,123 @@
+/*
+    ChibiOS - Copyright (C) 2006..2018 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+/**
+ * @file    bsio_bench.h
+ * @brief   Buffered SIO throughput benchmark header.
+ * @details A writer thread sends a known pattern through a
+ *          @p BufferedSIODriver while the calling thread receives and
+ *          checks it, the SIO line must be looped back, externally or by
+ *          the simulator. The transfer is repeated using different chunk
+ *          sizes, the throughput and any error event are reported.
+ *
+ * @addtogroup BSIO_BENCH
+ * @{
+ */
+
+#ifndef BSIO_BENCH_H
+#define BSIO_BENCH_H
+
+/*===========================================================================*/
+/* Module constants.                                                         */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Module pre-compile time settings.                                         */
+/*===========================================================================*/
+
+/**
+ * @name    Configuration options
+ * @{
+ */
+/**
+ * @brief   Number of bytes transferred for each chunk size.
+ */
+#if !defined(BSIO_BENCH_CFG_TRANSFER_SIZE) || defined(__DOXYGEN__)
+#define BSIO_BENCH_CFG_TRANSFER_SIZE        (64 * 1024)
+#endif
+
+/**
+ * @brief   Largest chunk size.
+ */
+#if !defined(BSIO_BENCH_CFG_MAX_CHUNK) || defined(__DOXYGEN__)
+#define BSIO_BENCH_CFG_MAX_CHUNK            256
+#endif
+
+/**
+ * @brief   Receive timeout in milliseconds, lost data is detected this way.
+ */
+#if !defined(BSIO_BENCH_CFG_TIMEOUT) || defined(__DOXYGEN__)
+#define BSIO_BENCH_CFG_TIMEOUT              1000
+#endif
+
+/**
+ * @brief   Stack size of the writer thread.
+ */
+#if !defined(BSIO_BENCH_CFG_STACK_SIZE) || defined(__DOXYGEN__)
+#define BSIO_BENCH_CFG_STACK_SIZE           512
+#endif
+/** @} */
+
+/*===========================================================================*/
+/* Derived constants and error checks.                                       */
+/*===========================================================================*/
+
+#if (BSIO_BENCH_CFG_TRANSFER_SIZE % BSIO_BENCH_CFG_MAX_CHUNK) != 0
+#error "BSIO_BENCH_CFG_TRANSFER_SIZE not multiple of BSIO_BENCH_CFG_MAX_CHUNK"
+#endif
+
+/*===========================================================================*/
+/* Module data structures and types.                                         */
+/*===========================================================================*/
+
+typedef struct {
+  /**
+   * @brief   Stream for output.
+   */
+  BaseSequentialStream  *out;
+  /**
+   * @brief   Buffered SIO driver, already initialized and stopped.
+   */
+  BufferedSIODriver     *bsiop;
+  /**
+   * @brief   SIO configuration.
+   */
+  const SIOConfig       *siocfg;
+} bsio_bench_config_t;
+
+/*===========================================================================*/
+/* Module macros.                                                            */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* External declarations.                                                    */
+/*===========================================================================*/
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+  void bsio_bench_execute(const bsio_bench_config_t *cfg);
+#ifdef __cplusplus
+}
+#endif
+
+/*===========================================================================*/
+/* Module inline functions.                                                  */
+/*===========================================================================*/
+
+#endif /* BSIO_BENCH_H */
+
+/** @} */
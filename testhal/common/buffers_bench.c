@@ -0,0 +1,250 @@
+/*
+    ChibiOS - Copyright (C) 2006..2018 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+/**
+ * @file    buffers_bench.c
+ * @brief   Buffers queues throughput benchmark code.
+ *
+ * @addtogroup BUFFERS_BENCH
+ * @{
+ */
+
+#include <string.h>
+
+#include "ch.h"
+#include "hal.h"
+
+#include "chprintf.h"
+#include "bench_timer.h"
+#include "buffers_bench.h"
+
+/*===========================================================================*/
+/* Module local definitions.                                                 */
+/*===========================================================================*/
+
+/**
+ * @brief   Chunk size value selecting the zero-copy API.
+ */
+#define ZERO_COPY               ((size_t)0)
+
+/*===========================================================================*/
+/* Module exported variables.                                                */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Module local types.                                                       */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Module local variables.                                                   */
+/*===========================================================================*/
+
+static THD_WORKING_AREA(wa_writer, BUFFERS_BENCH_CFG_STACK_SIZE);
+
+static input_buffers_queue_t ibq;
+
+static output_buffers_queue_t obq;
+
+static uint8_t ib[BQ_BUFFER_SIZE(BUFFERS_BENCH_CFG_BUFFERS_NUMBER,
+                                 BUFFERS_BENCH_CFG_BUFFER_SIZE)];
+
+static uint8_t ob[BQ_BUFFER_SIZE(BUFFERS_BENCH_CFG_BUFFERS_NUMBER,
+                                 BUFFERS_BENCH_CFG_BUFFER_SIZE)];
+
+static uint8_t txbuf[BUFFERS_BENCH_CFG_MAX_CHUNK];
+
+static uint8_t rxbuf[BUFFERS_BENCH_CFG_MAX_CHUNK];
+
+/*===========================================================================*/
+/* Module local functions.                                                   */
+/*===========================================================================*/
+
+/*
+ * Pattern byte at the specified stream offset.
+ */
+static uint8_t pattern(size_t offset) {
+
+  return (uint8_t)(offset ^ (offset >> 8));
+}
+
+/*
+ * Simulated endpoint, moves a full output buffer into an empty input buffer
+ * if both are available. It is invoked by the queues notifications, on a
+ * real device this would be done by the USB interrupt handlers.
+ */
+static void endpoint_transfer(io_buffers_queue_t *bqp) {
+  uint8_t *src, *dst;
+  size_t n;
+
+  (void)bqp;
+
+  src = obqGetFullBufferI(&obq, &n);
+  if (src == NULL) {
+    return;
+  }
+  dst = ibqGetEmptyBufferI(&ibq);
+  if (dst == NULL) {
+    return;
+  }
+  memcpy(dst, src, n);
+  ibqPostFullBufferI(&ibq, n);
+  obqReleaseEmptyBufferI(&obq);
+}
+
+/*
+ * Writer thread, the argument is the chunk size. The thread sends the whole
+ * transfer size, flushes the queue then terminates.
+ */
+static THD_FUNCTION(writer_thread, arg) {
+  size_t chunk = (size_t)arg;
+  size_t offset = 0U;
+
+  while (offset < BUFFERS_BENCH_CFG_TRANSFER_SIZE) {
+    size_t i, n;
+
+    if (chunk == ZERO_COPY) {
+      uint8_t *bp;
+
+      if (obqReserveTimeout(&obq, &bp, &n,
+                            TIME_MS2I(BUFFERS_BENCH_CFG_TIMEOUT)) != MSG_OK) {
+        break;
+      }
+      if (n > BUFFERS_BENCH_CFG_TRANSFER_SIZE - offset) {
+        n = BUFFERS_BENCH_CFG_TRANSFER_SIZE - offset;
+      }
+      for (i = 0U; i < n; i++) {
+        bp[i] = pattern(offset + i);
+      }
+      obqCommit(&obq, n);
+    }
+    else {
+      n = chunk;
+      for (i = 0U; i < n; i++) {
+        txbuf[i] = pattern(offset + i);
+      }
+      if (obqWriteTimeout(&obq, txbuf, n,
+                          TIME_MS2I(BUFFERS_BENCH_CFG_TIMEOUT)) != n) {
+        break;
+      }
+    }
+    offset += n;
+  }
+  obqFlush(&obq);
+}
+
+/*
+ * Transfer benchmark using the specified chunk size for both writing and
+ * reading.
+ */
+static bool bench_transfer(const buffers_bench_config_t *cfg, size_t chunk) {
+  bench_timer_t bt;
+  thread_t *tp;
+  size_t offset;
+
+  if (chunk == ZERO_COPY) {
+    chprintf(cfg->out, "--- Zero-copy  : ");
+  }
+  else {
+    chprintf(cfg->out, "--- Chunk %4u : ", (unsigned)chunk);
+  }
+
+  bench_timer_start(&bt);
+
+  /* The writer runs at the same priority of the reader because the
+     simulated endpoint can wake up the peer thread from within the queues
+     notifications, the threads alternate when a queue becomes full or
+     empty.*/
+  tp = chThdCreateStatic(wa_writer, sizeof (wa_writer),
+                         chThdGetPriorityX(), writer_thread,
+                         (void *)chunk);
+
+  offset = 0U;
+  while (offset < BUFFERS_BENCH_CFG_TRANSFER_SIZE) {
+    const uint8_t *bp;
+    size_t i, n;
+
+    if (chunk == ZERO_COPY) {
+      if (ibqFetchTimeout(&ibq, &bp, &n,
+                          TIME_MS2I(BUFFERS_BENCH_CFG_TIMEOUT)) != MSG_OK) {
+        n = 0U;
+      }
+    }
+    else {
+      bp = rxbuf;
+      n = ibqReadTimeout(&ibq, rxbuf, chunk,
+                         TIME_MS2I(BUFFERS_BENCH_CFG_TIMEOUT));
+    }
+    for (i = 0U; i < n; i++) {
+      if (bp[i] != pattern(offset + i)) {
+        break;
+      }
+    }
+    if (chunk == ZERO_COPY) {
+      ibqRelease(&ibq, n);
+    }
+    if ((i < n) || (n == 0U) || ((chunk != ZERO_COPY) && (n < chunk))) {
+      chprintf(cfg->out, "%s at offset %u\r\n",
+               i < n ? "data mismatch" : "data lost",
+               (unsigned)(offset + i));
+      (void) chThdWait(tp);
+      return false;
+    }
+    offset += n;
+  }
+
+  chprintf(cfg->out, "%8u KB/s\r\n",
+           (unsigned)(bench_timer_rate(&bt, BUFFERS_BENCH_CFG_TRANSFER_SIZE) /
+                      1024U));
+  (void) chThdWait(tp);
+
+  return true;
+}
+
+/*===========================================================================*/
+/* Module exported functions.                                                */
+/*===========================================================================*/
+
+/**
+ * @brief   Buffers queues throughput benchmark.
+ *
+ * @param[in] cfg       pointer to the configuration structure
+ */
+void buffers_bench_execute(const buffers_bench_config_t *cfg) {
+  static const size_t chunks[] = {16U, BUFFERS_CHUNKS_SIZE,
+                                  BUFFERS_BENCH_CFG_BUFFER_SIZE,
+                                  BUFFERS_BENCH_CFG_MAX_CHUNK, ZERO_COPY};
+  unsigned i;
+
+  chprintf(cfg->out, "\r\n*** Buffers queues throughput, %u bytes transfers, "
+                     "%ux%u bytes buffers\r\n",
+           (unsigned)BUFFERS_BENCH_CFG_TRANSFER_SIZE,
+           (unsigned)BUFFERS_BENCH_CFG_BUFFERS_NUMBER,
+           (unsigned)BUFFERS_BENCH_CFG_BUFFER_SIZE);
+
+  ibqObjectInit(&ibq, false, ib, BUFFERS_BENCH_CFG_BUFFER_SIZE,
+                BUFFERS_BENCH_CFG_BUFFERS_NUMBER, endpoint_transfer, NULL);
+  obqObjectInit(&obq, false, ob, BUFFERS_BENCH_CFG_BUFFER_SIZE,
+                BUFFERS_BENCH_CFG_BUFFERS_NUMBER, endpoint_transfer, NULL);
+
+  for (i = 0U; i < sizeof (chunks) / sizeof (chunks[0]); i++) {
+    if ((chunks[i] <= BUFFERS_BENCH_CFG_MAX_CHUNK) &&
+        !bench_transfer(cfg, chunks[i])) {
+      break;
+    }
+  }
+}
+
+/** @} */
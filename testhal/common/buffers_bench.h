@@ -0,0 +1,131 @@
+/*
+    ChibiOS - Copyright (C) 2006..2018 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+/**
+ * @file    buffers_bench.h
+ * @brief   Buffers queues throughput benchmark header.
+ * @details An output and an input buffers queue are connected by a
+ *          simulated bulk endpoint, a full output buffer is moved into an
+ *          empty input buffer as soon as both are available, like a USB
+ *          loopback. A writer thread sends a known pattern while the calling
+ *          thread receives and checks it, the transfer is repeated using
+ *          the copy API with different chunk sizes and using the zero-copy
+ *          API, the throughput is reported.
+ *
+ * @addtogroup BUFFERS_BENCH
+ * @{
+ */
+
+#ifndef BUFFERS_BENCH_H
+#define BUFFERS_BENCH_H
+
+/*===========================================================================*/
+/* Module constants.                                                         */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Module pre-compile time settings.                                         */
+/*===========================================================================*/
+
+/**
+ * @name    Configuration options
+ * @{
+ */
+/**
+ * @brief   Number of bytes transferred for each test.
+ */
+#if !defined(BUFFERS_BENCH_CFG_TRANSFER_SIZE) || defined(__DOXYGEN__)
+#define BUFFERS_BENCH_CFG_TRANSFER_SIZE     (1024 * 1024)
+#endif
+
+/**
+ * @brief   Size of the queues buffers, the same of the USB CDC driver.
+ */
+#if !defined(BUFFERS_BENCH_CFG_BUFFER_SIZE) || defined(__DOXYGEN__)
+#define BUFFERS_BENCH_CFG_BUFFER_SIZE       256
+#endif
+
+/**
+ * @brief   Number of buffers in each queue.
+ */
+#if !defined(BUFFERS_BENCH_CFG_BUFFERS_NUMBER) || defined(__DOXYGEN__)
+#define BUFFERS_BENCH_CFG_BUFFERS_NUMBER    2
+#endif
+
+/**
+ * @brief   Largest chunk size used with the copy API.
+ */
+#if !defined(BUFFERS_BENCH_CFG_MAX_CHUNK) || defined(__DOXYGEN__)
+#define BUFFERS_BENCH_CFG_MAX_CHUNK         1024
+#endif
+
+/**
+ * @brief   Receive timeout in milliseconds, lost data is detected this way.
+ */
+#if !defined(BUFFERS_BENCH_CFG_TIMEOUT) || defined(__DOXYGEN__)
+#define BUFFERS_BENCH_CFG_TIMEOUT           1000
+#endif
+
+/**
+ * @brief   Stack size of the writer thread.
+ */
+#if !defined(BUFFERS_BENCH_CFG_STACK_SIZE) || defined(__DOXYGEN__)
+#define BUFFERS_BENCH_CFG_STACK_SIZE        512
+#endif
+/** @} */
+
+/*===========================================================================*/
+/* Derived constants and error checks.                                       */
+/*===========================================================================*/
+
+#if (BUFFERS_BENCH_CFG_TRANSFER_SIZE % BUFFERS_BENCH_CFG_MAX_CHUNK) != 0
+#error "BUFFERS_BENCH_CFG_TRANSFER_SIZE not multiple of BUFFERS_BENCH_CFG_MAX_CHUNK"
+#endif
+
+/*===========================================================================*/
+/* Module data structures and types.                                         */
+/*===========================================================================*/
+
+typedef struct {
+  /**
+   * @brief   Stream for output.
+   */
+  BaseSequentialStream  *out;
+} buffers_bench_config_t;
+
+/*===========================================================================*/
+/* Module macros.                                                            */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* External declarations.                                                    */
+/*===========================================================================*/
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+  void buffers_bench_execute(const buffers_bench_config_t *cfg);
+#ifdef __cplusplus
+}
+#endif
+
+/*===========================================================================*/
+/* Module inline functions.                                                  */
+/*===========================================================================*/
+
+#endif /* BUFFERS_BENCH_H */
+
+/** @} */
@@ -0,0 +1,257 @@
+/*
+    ChibiOS - Copyright (C) 2006..2018 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+/**
+ * @file    candisp_bench.c
+ * @brief   CAN dispatcher benchmark code.
+ *
+ * @addtogroup CANDISP_BENCH
+ * @{
+ */
+
+#include "ch.h"
+#include "hal.h"
+
+#include "chprintf.h"
+#include "bench_timer.h"
+#include "candisp_bench.h"
+
+/*===========================================================================*/
+/* Module local definitions.                                                 */
+/*===========================================================================*/
+
+/*
+ * Identifiers used by the test, the masked subscription receives extended
+ * frames with the low byte of the identifier changing.
+ */
+#define BENCH_STD_BASE          0x100U
+#define BENCH_EXT_BASE          0x18FF5500U
+#define BENCH_EXT_MASK          (CANDISP_EXACT & ~0xFFU)
+#define BENCH_NOISE_BASE        0x500U
+
+/*===========================================================================*/
+/* Module exported variables.                                                */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Module local types.                                                       */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Module local variables.                                                   */
+/*===========================================================================*/
+
+static THD_WORKING_AREA(wa_consumers[CANDISP_BENCH_CFG_CONSUMERS],
+                        CANDISP_BENCH_CFG_STACK_SIZE);
+
+static THD_WORKING_AREA(wa_dispatcher, CANDISP_BENCH_CFG_STACK_SIZE);
+
+static candisp_frame_t frames[CANDISP_BENCH_CFG_CONSUMERS]
+                             [CANDISP_BENCH_CFG_FIFO_SIZE];
+
+static msg_t msgs[CANDISP_BENCH_CFG_CONSUMERS][CANDISP_BENCH_CFG_FIFO_SIZE];
+
+static candisp_subscription_t subs[CANDISP_BENCH_CFG_CONSUMERS];
+
+static can_dispatcher_t cd;
+
+/*
+ * Lost and out of sequence frames counter.
+ */
+static volatile uint32_t errors;
+
+/*===========================================================================*/
+/* Module local functions.                                                   */
+/*===========================================================================*/
+
+/*
+ * Key of the frames sent to a consumer in a round.
+ */
+static uint32_t consumer_key(unsigned c, uint32_t round) {
+
+  if (c == (unsigned)CANDISP_BENCH_CFG_CONSUMERS - 1U) {
+    return CANDISP_EXT(BENCH_EXT_BASE + (round & 0xFFU));
+  }
+
+  return CANDISP_STD(BENCH_STD_BASE + c);
+}
+
+static void send_frame(CANDriver *canp, uint32_t key, uint32_t round) {
+  CANTxFrame ctf;
+
+  ctf.IDE = (key & CANDISP_IDE) != 0U ? 1U : 0U;
+  ctf.RTR = 0U;
+  ctf.DLC = 8U;
+  if (ctf.IDE != 0U) {
+    ctf.EID = key & CANDISP_EID_MASK;
+  }
+  else {
+    ctf.SID = key;
+  }
+  ctf.data32[0] = round;
+  ctf.data32[1] = key;
+  (void) canTransmitTimeout(canp, CAN_ANY_MAILBOX, &ctf, TIME_INFINITE);
+}
+
+/*
+ * Consumer thread, the argument is the consumer index. The frames are
+ * expected in sequence, missing frames are counted as errors.
+ */
+static THD_FUNCTION(consumer_thread, arg) {
+  unsigned c = (unsigned)(uintptr_t)arg;
+  uint32_t expected = 0U;
+  CANRxFrame crf;
+
+  while (expected < (uint32_t)CANDISP_BENCH_CFG_FRAMES) {
+    if (candispReceiveTimeout(&subs[c], &crf,
+                              TIME_MS2I(100)) != MSG_OK) {
+      break;
+    }
+    if ((crf.data32[0] < expected) ||
+        (crf.data32[1] != consumer_key(c, crf.data32[0]))) {
+      errors++;
+      continue;
+    }
+    errors += crf.data32[0] - expected;
+    expected = crf.data32[0] + 1U;
+  }
+  errors += (uint32_t)CANDISP_BENCH_CFG_FRAMES - expected;
+}
+
+static void bench_run(const candisp_bench_config_t *cfg, const char *name) {
+  thread_t *tps[CANDISP_BENCH_CFG_CONSUMERS];
+  candisp_stats_t stats;
+  bench_timer_t bt;
+  uint32_t round, total;
+  unsigned c, i;
+
+  chprintf(cfg->out, "--- %-14s: ", name);
+
+  candispResetStats(&cd);
+  errors = 0U;
+
+  bench_timer_start(&bt);
+
+  for (c = 0U; c < (unsigned)CANDISP_BENCH_CFG_CONSUMERS; c++) {
+    tps[c] = chThdCreateStatic(wa_consumers[c], sizeof (wa_consumers[c]),
+                               chThdGetPriorityX() + 1, consumer_thread,
+                               (void *)(uintptr_t)c);
+  }
+
+  /* The calling thread is the sender, the unwanted frames go first so
+     that all the frames have been dispatched when the consumers are
+     done.*/
+  for (round = 0U; round < (uint32_t)CANDISP_BENCH_CFG_FRAMES; round++) {
+    for (i = 0U; i < (unsigned)CANDISP_BENCH_CFG_NOISE; i++) {
+      send_frame(cfg->canp,
+                 CANDISP_STD(BENCH_NOISE_BASE + ((round + i) & 0xFFU)),
+                 round);
+    }
+    for (c = 0U; c < (unsigned)CANDISP_BENCH_CFG_CONSUMERS; c++) {
+      send_frame(cfg->canp, consumer_key(c, round), round);
+    }
+  }
+
+  for (c = 0U; c < (unsigned)CANDISP_BENCH_CFG_CONSUMERS; c++) {
+    (void) chThdWait(tps[c]);
+  }
+
+  total = (uint32_t)CANDISP_BENCH_CFG_FRAMES *
+          ((uint32_t)CANDISP_BENCH_CFG_CONSUMERS + CANDISP_BENCH_CFG_NOISE);
+  candispGetStats(&cd, &stats);
+  chprintf(cfg->out, "%7u frames/s, %6u dispatched, %6u unmatched, "
+                     "%4u dropped",
+           (unsigned)bench_timer_rate(&bt, total),
+           (unsigned)stats.frames, (unsigned)stats.unmatched,
+           (unsigned)stats.dropped);
+  if (errors > 0U) {
+    chprintf(cfg->out, ", %u errors", (unsigned)errors);
+  }
+  chprintf(cfg->out, "\r\n");
+}
+
+/*===========================================================================*/
+/* Module exported functions.                                                */
+/*===========================================================================*/
+
+/**
+ * @brief   CAN dispatcher benchmark.
+ * @note    The driver must be started in loopback mode, it is restarted
+ *          when the filters are programmed.
+ *
+ * @param[in] cfg       pointer to the configuration structure
+ */
+void candisp_bench_execute(const candisp_bench_config_t *cfg) {
+  candisp_filter_t filters[CANDISP_BENCH_CFG_CONSUMERS];
+  candisp_config_t cdcfg;
+  uint32_t n;
+  unsigned c;
+
+  chprintf(cfg->out, "\r\n*** CAN dispatcher, %u consumers, %u frames "
+                     "each, %u unwanted frames every %u\r\n",
+           (unsigned)CANDISP_BENCH_CFG_CONSUMERS,
+           (unsigned)CANDISP_BENCH_CFG_FRAMES,
+           (unsigned)CANDISP_BENCH_CFG_NOISE,
+           (unsigned)CANDISP_BENCH_CFG_CONSUMERS);
+
+  candispObjectInit(&cd);
+  for (c = 0U; c < (unsigned)CANDISP_BENCH_CFG_CONSUMERS; c++) {
+    if (c == (unsigned)CANDISP_BENCH_CFG_CONSUMERS - 1U) {
+      candispSubscriptionObjectInit(&subs[c], CANDISP_EXT(BENCH_EXT_BASE),
+                                    BENCH_EXT_MASK, frames[c], msgs[c],
+                                    CANDISP_BENCH_CFG_FIFO_SIZE);
+    }
+    else {
+      candispSubscriptionObjectInit(&subs[c], consumer_key(c, 0U),
+                                    CANDISP_EXACT, frames[c], msgs[c],
+                                    CANDISP_BENCH_CFG_FIFO_SIZE);
+    }
+    candispSubscribe(&cd, &subs[c]);
+  }
+
+  cdcfg.canp  = cfg->canp;
+  cdcfg.wsp   = wa_dispatcher;
+  cdcfg.wsize = sizeof (wa_dispatcher);
+  cdcfg.prio  = chThdGetPriorityX() + 2;
+  candispStart(&cd, &cdcfg);
+
+  bench_run(cfg, "All frames");
+
+  if ((cfg->setfilters != NULL) && (cfg->nfilters > 0U)) {
+    n = cfg->nfilters;
+    if (n > (uint32_t)CANDISP_BENCH_CFG_CONSUMERS) {
+      n = (uint32_t)CANDISP_BENCH_CFG_CONSUMERS;
+    }
+    n = candispGetFilters(&cd, filters, n);
+
+    canStop(cfg->canp);
+    cfg->setfilters(cfg->canp, n, filters);
+    canStart(cfg->canp, cfg->cancfg);
+
+    bench_run(cfg, "HW filters");
+
+    canStop(cfg->canp);
+    cfg->setfilters(cfg->canp, 0U, NULL);
+    canStart(cfg->canp, cfg->cancfg);
+  }
+
+  candispStop(&cd);
+  for (c = 0U; c < (unsigned)CANDISP_BENCH_CFG_CONSUMERS; c++) {
+    candispUnsubscribe(&cd, &subs[c]);
+  }
+}
+
+/** @} */
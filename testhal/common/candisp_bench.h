@@ -0,0 +1,156 @@
+/*
+    ChibiOS - Copyright (C) 2006..2018 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+/**
+ * @file    candisp_bench.h
+ * @brief   CAN dispatcher benchmark header.
+ * @details A sender transmits frames for several consumer threads mixed
+ *          with frames nobody is interested in, each consumer receives its
+ *          frames from a dispatcher subscription and checks the sequence.
+ *          The test is performed accepting all frames then with the
+ *          subscriptions compiled in the hardware filters, throughput and
+ *          dispatcher counters are reported.
+ *
+ * @addtogroup CANDISP_BENCH
+ * @{
+ */
+
+#ifndef CANDISP_BENCH_H
+#define CANDISP_BENCH_H
+
+#include "candispatch.h"
+
+/*===========================================================================*/
+/* Module constants.                                                         */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Module pre-compile time settings.                                         */
+/*===========================================================================*/
+
+/**
+ * @name    Configuration options
+ * @{
+ */
+/**
+ * @brief   Number of consumer threads.
+ * @note    The last consumer uses a masked subscription, the others
+ *          subscribe to a single identifier.
+ */
+#if !defined(CANDISP_BENCH_CFG_CONSUMERS) || defined(__DOXYGEN__)
+#define CANDISP_BENCH_CFG_CONSUMERS         4
+#endif
+
+/**
+ * @brief   Number of frames sent to each consumer.
+ */
+#if !defined(CANDISP_BENCH_CFG_FRAMES) || defined(__DOXYGEN__)
+#define CANDISP_BENCH_CFG_FRAMES            2000
+#endif
+
+/**
+ * @brief   Unwanted frames sent for each round of consumer frames.
+ */
+#if !defined(CANDISP_BENCH_CFG_NOISE) || defined(__DOXYGEN__)
+#define CANDISP_BENCH_CFG_NOISE             4
+#endif
+
+/**
+ * @brief   Size of the subscription FIFOs.
+ */
+#if !defined(CANDISP_BENCH_CFG_FIFO_SIZE) || defined(__DOXYGEN__)
+#define CANDISP_BENCH_CFG_FIFO_SIZE         8
+#endif
+
+/**
+ * @brief   Stack size of the consumer and dispatcher threads.
+ */
+#if !defined(CANDISP_BENCH_CFG_STACK_SIZE) || defined(__DOXYGEN__)
+#define CANDISP_BENCH_CFG_STACK_SIZE        512
+#endif
+/** @} */
+
+/*===========================================================================*/
+/* Derived constants and error checks.                                       */
+/*===========================================================================*/
+
+#if (CANDISP_BENCH_CFG_CONSUMERS < 1) || (CANDISP_BENCH_CFG_FRAMES < 1) ||  \
+    (CANDISP_BENCH_CFG_FIFO_SIZE < 1)
+#error "invalid CANDISP_BENCH_CFG_* settings"
+#endif
+
+/*===========================================================================*/
+/* Module data structures and types.                                         */
+/*===========================================================================*/
+
+/**
+ * @brief   Type of a filters programming function.
+ * @details The function converts the filters in the hardware format and
+ *          programs them, the driver is stopped when it is invoked.
+ *
+ * @param[in] canp      pointer to the @p CANDriver object
+ * @param[in] n         number of filters, zero for accepting all frames
+ * @param[in] fp        pointer to the filters
+ */
+typedef void (*candisp_bench_setfilters_t)(CANDriver *canp, uint32_t n,
+                                           const candisp_filter_t *fp);
+
+typedef struct {
+  /**
+   * @brief   Stream for output.
+   */
+  BaseSequentialStream  *out;
+  /**
+   * @brief   CAN driver, it must be in loopback mode.
+   */
+  CANDriver             *canp;
+  /**
+   * @brief   CAN driver configuration.
+   */
+  const CANConfig       *cancfg;
+  /**
+   * @brief   Filters programming function or @p NULL.
+   */
+  candisp_bench_setfilters_t setfilters;
+  /**
+   * @brief   Number of hardware filters.
+   */
+  uint32_t              nfilters;
+} candisp_bench_config_t;
+
+/*===========================================================================*/
+/* Module macros.                                                            */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* External declarations.                                                    */
+/*===========================================================================*/
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+  void candisp_bench_execute(const candisp_bench_config_t *cfg);
+#ifdef __cplusplus
+}
+#endif
+
+/*===========================================================================*/
+/* Module inline functions.                                                  */
+/*===========================================================================*/
+
+#endif /* CANDISP_BENCH_H */
+
+/** @} */
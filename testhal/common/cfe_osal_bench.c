@@ -0,0 +1,233 @@
+/*
+    ChibiOS - Copyright (C) 2006..2018 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+/**
+ * @file    cfe_osal_bench.c
+ * @brief   NASA cFE OSAL benchmark code.
+ *
+ * @addtogroup CFE_OSAL_BENCH
+ * @{
+ */
+
+#include <string.h>
+
+#include "ch.h"
+#include "hal.h"
+
+#include "chprintf.h"
+#include "cfe_osal_bench.h"
+
+/*===========================================================================*/
+/* Module local definitions.                                                 */
+/*===========================================================================*/
+
+/**
+ * @brief   Depth of the queue used by the throughput benchmarks.
+ */
+#define QUEUE_DEPTH             8U
+
+/*===========================================================================*/
+/* Module exported variables.                                                */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Module local types.                                                       */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Module local variables.                                                   */
+/*===========================================================================*/
+
+static uint32 qids[CFE_OSAL_BENCH_CFG_NUM_QUEUES];
+
+static uint8_t msgbuf[CFE_OSAL_BENCH_CFG_MSG_SIZE];
+
+/*===========================================================================*/
+/* Module local functions.                                                   */
+/*===========================================================================*/
+
+static void make_name(char *name, unsigned i) {
+
+  (void) chsnprintf(name, OS_MAX_API_NAME, "bench q%u", i);
+}
+
+static void delete_queues(void) {
+  unsigned i;
+
+  for (i = 0U; i < CFE_OSAL_BENCH_CFG_NUM_QUEUES; i++) {
+    if (qids[i] != 0U) {
+      (void) OS_QueueDelete(qids[i]);
+      qids[i] = 0U;
+    }
+  }
+}
+
+/*
+ * Prints the number of operations per second and the time per operation
+ * in nanoseconds.
+ */
+static void print_rate(const cfe_osal_bench_config_t *cfg,
+                       uint32_t ops, systime_t start) {
+  time_msecs_t ms;
+
+  ms = chTimeI2MS(chTimeDiffX(start, chVTGetSystemTimeX()));
+  if (ms == (time_msecs_t)0) {
+    ms = (time_msecs_t)1;
+  }
+  chprintf(cfg->out, "%8u ops/s", (unsigned)(((uint64_t)ops * 1000U) / ms));
+  if (ops > 0U) {
+    chprintf(cfg->out, ", %6u ns/op",
+             (unsigned)(((uint64_t)ms * 1000000U) / ops));
+  }
+  chprintf(cfg->out, "\r\n");
+}
+
+/*
+ * Lookup benchmark, the queues are retrieved by name in a round robin
+ * order for the configured time.
+ */
+static void bench_lookup(const cfe_osal_bench_config_t *cfg) {
+  char name[OS_MAX_API_NAME];
+  systime_t start, end;
+  uint32_t ops;
+  unsigned i;
+  uint32 id;
+
+  chprintf(cfg->out, "--- Lookup, %3u queues    : ",
+           (unsigned)CFE_OSAL_BENCH_CFG_NUM_QUEUES);
+
+  for (i = 0U; i < CFE_OSAL_BENCH_CFG_NUM_QUEUES; i++) {
+    make_name(name, i);
+    if (OS_QueueCreate(&qids[i], name, 1, 4, 0) != OS_SUCCESS) {
+      chprintf(cfg->out, "queue creation failed\r\n");
+      delete_queues();
+      return;
+    }
+  }
+
+  /* Aligning to the next tick.*/
+  chThdSleep(1);
+  start = chVTGetSystemTime();
+  end = chTimeAddX(start, TIME_MS2I(CFE_OSAL_BENCH_CFG_DURATION));
+
+  ops = 0U;
+  i = 0U;
+  do {
+    make_name(name, i);
+    if ((OS_QueueGetIdByName(&id, name) != OS_SUCCESS) || (id != qids[i])) {
+      chprintf(cfg->out, "lookup failed\r\n");
+      delete_queues();
+      return;
+    }
+    ops++;
+    if (++i >= CFE_OSAL_BENCH_CFG_NUM_QUEUES) {
+      i = 0U;
+    }
+#if defined(SIMULATOR)
+    _sim_check_for_interrupts();
+#endif
+  } while (chVTIsSystemTimeWithinX(start, end));
+
+  print_rate(cfg, ops, start);
+
+  delete_queues();
+}
+
+/*
+ * Throughput benchmark, messages are sent and received on the same queue
+ * by the same thread so that only the queue overhead is measured.
+ */
+static void bench_queue(const cfe_osal_bench_config_t *cfg, bool zerocopy) {
+  systime_t start, end;
+  uint32_t ops;
+  uint32 qid, size;
+  int32 err;
+  void *p;
+
+  chprintf(cfg->out, "--- Queue %s, %4u bytes : ",
+           zerocopy ? "zero-copy" : "copy     ",
+           (unsigned)CFE_OSAL_BENCH_CFG_MSG_SIZE);
+
+  if (OS_QueueCreate(&qid, "bench queue", QUEUE_DEPTH,
+                     CFE_OSAL_BENCH_CFG_MSG_SIZE, 0) != OS_SUCCESS) {
+    chprintf(cfg->out, "queue creation failed\r\n");
+    return;
+  }
+
+  /* Aligning to the next tick.*/
+  chThdSleep(1);
+  start = chVTGetSystemTime();
+  end = chTimeAddX(start, TIME_MS2I(CFE_OSAL_BENCH_CFG_DURATION));
+
+  ops = 0U;
+  do {
+    if (zerocopy) {
+      err = OS_QueueReserve(qid, &p, OS_CHECK);
+      if (err == OS_SUCCESS) {
+        *(uint32_t *)p = ops;
+        err = OS_QueueCommit(qid, p, CFE_OSAL_BENCH_CFG_MSG_SIZE);
+      }
+      if (err == OS_SUCCESS) {
+        err = OS_QueueFetch(qid, &p, &size, OS_CHECK);
+      }
+      if (err == OS_SUCCESS) {
+        err = OS_QueueRelease(qid, p);
+      }
+    }
+    else {
+      err = OS_QueuePut(qid, msgbuf, CFE_OSAL_BENCH_CFG_MSG_SIZE, 0);
+      if (err == OS_SUCCESS) {
+        err = OS_QueueGet(qid, msgbuf, CFE_OSAL_BENCH_CFG_MSG_SIZE,
+                          &size, OS_CHECK);
+      }
+    }
+    if (err != OS_SUCCESS) {
+      chprintf(cfg->out, "queue error %d\r\n", (int)err);
+      (void) OS_QueueDelete(qid);
+      return;
+    }
+    ops++;
+#if defined(SIMULATOR)
+    _sim_check_for_interrupts();
+#endif
+  } while (chVTIsSystemTimeWithinX(start, end));
+
+  print_rate(cfg, ops, start);
+
+  (void) OS_QueueDelete(qid);
+}
+
+/*===========================================================================*/
+/* Module exported functions.                                                */
+/*===========================================================================*/
+
+/**
+ * @brief   NASA cFE OSAL benchmark.
+ *
+ * @param[in] cfg       pointer to the configuration structure
+ */
+void cfe_osal_bench_execute(const cfe_osal_bench_config_t *cfg) {
+
+  chprintf(cfg->out, "\r\n*** NASA cFE OSAL benchmark\r\n");
+
+  memset(msgbuf, 0x55, sizeof (msgbuf));
+
+  bench_lookup(cfg);
+  bench_queue(cfg, false);
+  bench_queue(cfg, true);
+}
+
+/** @} */
@@ -0,0 +1,110 @@
+/*
+    ChibiOS - Copyright (C) 2006..2018 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+/**
+ * @file    cfe_osal_bench.h
+ * @brief   NASA cFE OSAL benchmark header.
+ * @details The time required for name lookups is measured with many named
+ *          queues in the system, then the queues throughput is measured
+ *          using both the copy and the zero-copy API. The OSAL must be
+ *          already initialized.
+ *
+ * @addtogroup CFE_OSAL_BENCH
+ * @{
+ */
+
+#ifndef CFE_OSAL_BENCH_H
+#define CFE_OSAL_BENCH_H
+
+#include "osapi.h"
+
+/*===========================================================================*/
+/* Module constants.                                                         */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Module pre-compile time settings.                                         */
+/*===========================================================================*/
+
+/**
+ * @name    Configuration options
+ * @{
+ */
+/**
+ * @brief   Number of named queues created for the lookup benchmark.
+ */
+#if !defined(CFE_OSAL_BENCH_CFG_NUM_QUEUES) || defined(__DOXYGEN__)
+#define CFE_OSAL_BENCH_CFG_NUM_QUEUES       (OS_MAX_QUEUES - 1)
+#endif
+
+/**
+ * @brief   Size of the messages used by the throughput benchmarks.
+ */
+#if !defined(CFE_OSAL_BENCH_CFG_MSG_SIZE) || defined(__DOXYGEN__)
+#define CFE_OSAL_BENCH_CFG_MSG_SIZE         128
+#endif
+
+/**
+ * @brief   Duration of each benchmark in milliseconds.
+ */
+#if !defined(CFE_OSAL_BENCH_CFG_DURATION) || defined(__DOXYGEN__)
+#define CFE_OSAL_BENCH_CFG_DURATION         1000
+#endif
+/** @} */
+
+/*===========================================================================*/
+/* Derived constants and error checks.                                       */
+/*===========================================================================*/
+
+#if (CFE_OSAL_BENCH_CFG_NUM_QUEUES < 1) ||                                  \
+    (CFE_OSAL_BENCH_CFG_NUM_QUEUES >= OS_MAX_QUEUES)
+#error "invalid CFE_OSAL_BENCH_CFG_NUM_QUEUES value"
+#endif
+
+/*===========================================================================*/
+/* Module data structures and types.                                         */
+/*===========================================================================*/
+
+typedef struct {
+  /**
+   * @brief   Stream for output.
+   */
+  BaseSequentialStream  *out;
+} cfe_osal_bench_config_t;
+
+/*===========================================================================*/
+/* Module macros.                                                            */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* External declarations.                                                    */
+/*===========================================================================*/
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+  void cfe_osal_bench_execute(const cfe_osal_bench_config_t *cfg);
+#ifdef __cplusplus
+}
+#endif
+
+/*===========================================================================*/
+/* Module inline functions.                                                  */
+/*===========================================================================*/
+
+#endif /* CFE_OSAL_BENCH_H */
+
+/** @} */
@@ -0,0 +1,628 @@
+/*
+    ChibiOS - Copyright (C) 2006..2018 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+/**
+ * @file    crypto_bench.c
+ * @brief   Crypto driver validation and benchmark code.
+ *
+ * @addtogroup CRYPTO_BENCH
+ * @{
+ */
+
+#include <string.h>
+
+#include "ch.h"
+#include "hal.h"
+
+#include "chprintf.h"
+#include "crypto_bench.h"
+
+#include "ref_sha.h"
+#include "ref_hmac.h"
+#include "ref_gcm.h"
+
+/*===========================================================================*/
+/* Module local definitions.                                                 */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Module exported variables.                                                */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Module local types.                                                       */
+/*===========================================================================*/
+
+typedef bool (*check_t)(CRYDriver *cryp);
+
+typedef cryerror_t (*bench_t)(CRYDriver *cryp, uint8_t *buf, size_t n);
+
+/*===========================================================================*/
+/* Module local variables.                                                   */
+/*===========================================================================*/
+
+static uint8_t buffer[CRYPTO_BENCH_CFG_BUFFER_SIZE];
+
+/*
+ * NIST SP800-38A vectors.
+ */
+static const uint8_t aes_key128[16] = {
+  0x2B, 0x7E, 0x15, 0x16, 0x28, 0xAE, 0xD2, 0xA6,
+  0xAB, 0xF7, 0x15, 0x88, 0x09, 0xCF, 0x4F, 0x3C
+};
+
+static const uint8_t aes_key192[24] = {
+  0x8E, 0x73, 0xB0, 0xF7, 0xDA, 0x0E, 0x64, 0x52,
+  0xC8, 0x10, 0xF3, 0x2B, 0x80, 0x90, 0x79, 0xE5,
+  0x62, 0xF8, 0xEA, 0xD2, 0x52, 0x2C, 0x6B, 0x7B
+};
+
+static const uint8_t aes_key256[32] = {
+  0x60, 0x3D, 0xEB, 0x10, 0x15, 0xCA, 0x71, 0xBE,
+  0x2B, 0x73, 0xAE, 0xF0, 0x85, 0x7D, 0x77, 0x81,
+  0x1F, 0x35, 0x2C, 0x07, 0x3B, 0x61, 0x08, 0xD7,
+  0x2D, 0x98, 0x10, 0xA3, 0x09, 0x14, 0xDF, 0xF4
+};
+
+static const uint8_t aes_iv[16] = {
+  0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07,
+  0x08, 0x09, 0x0A, 0x0B, 0x0C, 0x0D, 0x0E, 0x0F
+};
+
+static const uint8_t aes_ctr[16] = {
+  0xF0, 0xF1, 0xF2, 0xF3, 0xF4, 0xF5, 0xF6, 0xF7,
+  0xF8, 0xF9, 0xFA, 0xFB, 0xFC, 0xFD, 0xFE, 0xFF
+};
+
+static const uint8_t aes_plain[64] = {
+  0x6B, 0xC1, 0xBE, 0xE2, 0x2E, 0x40, 0x9F, 0x96,
+  0xE9, 0x3D, 0x7E, 0x11, 0x73, 0x93, 0x17, 0x2A,
+  0xAE, 0x2D, 0x8A, 0x57, 0x1E, 0x03, 0xAC, 0x9C,
+  0x9E, 0xB7, 0x6F, 0xAC, 0x45, 0xAF, 0x8E, 0x51,
+  0x30, 0xC8, 0x1C, 0x46, 0xA3, 0x5C, 0xE4, 0x11,
+  0xE5, 0xFB, 0xC1, 0x19, 0x1A, 0x0A, 0x52, 0xEF,
+  0xF6, 0x9F, 0x24, 0x45, 0xDF, 0x4F, 0x9B, 0x17,
+  0xAD, 0x2B, 0x41, 0x7B, 0xE6, 0x6C, 0x37, 0x10
+};
+
+static const uint8_t aes_ecb128[64] = {
+  0x3A, 0xD7, 0x7B, 0xB4, 0x0D, 0x7A, 0x36, 0x60,
+  0xA8, 0x9E, 0xCA, 0xF3, 0x24, 0x66, 0xEF, 0x97,
+  0xF5, 0xD3, 0xD5, 0x85, 0x03, 0xB9, 0x69, 0x9D,
+  0xE7, 0x85, 0x89, 0x5A, 0x96, 0xFD, 0xBA, 0xAF,
+  0x43, 0xB1, 0xCD, 0x7F, 0x59, 0x8E, 0xCE, 0x23,
+  0x88, 0x1B, 0x00, 0xE3, 0xED, 0x03, 0x06, 0x88,
+  0x7B, 0x0C, 0x78, 0x5E, 0x27, 0xE8, 0xAD, 0x3F,
+  0x82, 0x23, 0x20, 0x71, 0x04, 0x72, 0x5D, 0xD4
+};
+
+static const uint8_t aes_ecb192[64] = {
+  0xBD, 0x33, 0x4F, 0x1D, 0x6E, 0x45, 0xF2, 0x5F,
+  0xF7, 0x12, 0xA2, 0x14, 0x57, 0x1F, 0xA5, 0xCC,
+  0x97, 0x41, 0x04, 0x84, 0x6D, 0x0A, 0xD3, 0xAD,
+  0x77, 0x34, 0xEC, 0xB3, 0xEC, 0xEE, 0x4E, 0xEF,
+  0xEF, 0x7A, 0xFD, 0x22, 0x70, 0xE2, 0xE6, 0x0A,
+  0xDC, 0xE0, 0xBA, 0x2F, 0xAC, 0xE6, 0x44, 0x4E,
+  0x9A, 0x4B, 0x41, 0xBA, 0x73, 0x8D, 0x6C, 0x72,
+  0xFB, 0x16, 0x69, 0x16, 0x03, 0xC1, 0x8E, 0x0E
+};
+
+static const uint8_t aes_ecb256[64] = {
+  0xF3, 0xEE, 0xD1, 0xBD, 0xB5, 0xD2, 0xA0, 0x3C,
+  0x06, 0x4B, 0x5A, 0x7E, 0x3D, 0xB1, 0x81, 0xF8,
+  0x59, 0x1C, 0xCB, 0x10, 0xD4, 0x10, 0xED, 0x26,
+  0xDC, 0x5B, 0xA7, 0x4A, 0x31, 0x36, 0x28, 0x70,
+  0xB6, 0xED, 0x21, 0xB9, 0x9C, 0xA6, 0xF4, 0xF9,
+  0xF1, 0x53, 0xE7, 0xB1, 0xBE, 0xAF, 0xED, 0x1D,
+  0x23, 0x30, 0x4B, 0x7A, 0x39, 0xF9, 0xF3, 0xFF,
+  0x06, 0x7D, 0x8D, 0x8F, 0x9E, 0x24, 0xEC, 0xC7
+};
+
+static const uint8_t aes_cbc128[64] = {
+  0x76, 0x49, 0xAB, 0xAC, 0x81, 0x19, 0xB2, 0x46,
+  0xCE, 0xE9, 0x8E, 0x9B, 0x12, 0xE9, 0x19, 0x7D,
+  0x50, 0x86, 0xCB, 0x9B, 0x50, 0x72, 0x19, 0xEE,
+  0x95, 0xDB, 0x11, 0x3A, 0x91, 0x76, 0x78, 0xB2,
+  0x73, 0xBE, 0xD6, 0xB8, 0xE3, 0xC1, 0x74, 0x3B,
+  0x71, 0x16, 0xE6, 0x9E, 0x22, 0x22, 0x95, 0x16,
+  0x3F, 0xF1, 0xCA, 0xA1, 0x68, 0x1F, 0xAC, 0x09,
+  0x12, 0x0E, 0xCA, 0x30, 0x75, 0x86, 0xE1, 0xA7
+};
+
+static const uint8_t aes_cfb128[64] = {
+  0x3B, 0x3F, 0xD9, 0x2E, 0xB7, 0x2D, 0xAD, 0x20,
+  0x33, 0x34, 0x49, 0xF8, 0xE8, 0x3C, 0xFB, 0x4A,
+  0xC8, 0xA6, 0x45, 0x37, 0xA0, 0xB3, 0xA9, 0x3F,
+  0xCD, 0xE3, 0xCD, 0xAD, 0x9F, 0x1C, 0xE5, 0x8B,
+  0x26, 0x75, 0x1F, 0x67, 0xA3, 0xCB, 0xB1, 0x40,
+  0xB1, 0x80, 0x8C, 0xF1, 0x87, 0xA4, 0xF4, 0xDF,
+  0xC0, 0x4B, 0x05, 0x35, 0x7C, 0x5D, 0x1C, 0x0E,
+  0xEA, 0xC4, 0xC6, 0x6F, 0x9F, 0xF7, 0xF2, 0xE6
+};
+
+static const uint8_t aes_ctr128[64] = {
+  0x87, 0x4D, 0x61, 0x91, 0xB6, 0x20, 0xE3, 0x26,
+  0x1B, 0xEF, 0x68, 0x64, 0x99, 0x0D, 0xB6, 0xCE,
+  0x98, 0x06, 0xF6, 0x6B, 0x79, 0x70, 0xFD, 0xFF,
+  0x86, 0x17, 0x18, 0x7B, 0xB9, 0xFF, 0xFD, 0xFF,
+  0x5A, 0xE4, 0xDF, 0x3E, 0xDB, 0xD5, 0xD3, 0x5E,
+  0x5B, 0x4F, 0x09, 0x02, 0x0D, 0xB0, 0x3E, 0xAB,
+  0x1E, 0x03, 0x1D, 0xDA, 0x2F, 0xBE, 0x03, 0xD1,
+  0x79, 0x21, 0x70, 0xA0, 0xF3, 0x00, 0x9C, 0xEE
+};
+
+/*
+ * Hash messages, same as the test/crypto suite.
+ */
+static const uint8_t sha_msg0[] = "abc";
+static const uint8_t sha_msg1[] =
+  "abcdbcdecdefdefgefghfghighijhijkijkljklmklmnlmnomnopnopq";
+
+static const uint8_t hmac_key[20] = {
+  0x0B, 0x0B, 0x0B, 0x0B, 0x0B, 0x0B, 0x0B, 0x0B, 0x0B, 0x0B,
+  0x0B, 0x0B, 0x0B, 0x0B, 0x0B, 0x0B, 0x0B, 0x0B, 0x0B, 0x0B
+};
+
+static const uint8_t hmac_msg[] = "Hi There";
+
+/*===========================================================================*/
+/* Module local functions.                                                   */
+/*===========================================================================*/
+
+static bool check_aes_ecb(CRYDriver *cryp) {
+  static const struct {
+    const uint8_t *key;
+    size_t        size;
+    const uint8_t *ref;
+  } v[] = {
+    {aes_key128, sizeof (aes_key128), aes_ecb128},
+    {aes_key192, sizeof (aes_key192), aes_ecb192},
+    {aes_key256, sizeof (aes_key256), aes_ecb256}
+  };
+  unsigned i;
+
+  for (i = 0U; i < sizeof (v) / sizeof (v[0]); i++) {
+    if (cryLoadAESTransientKey(cryp, v[i].size, v[i].key) != CRY_NOERROR) {
+      return false;
+    }
+    if ((cryEncryptAES_ECB(cryp, 0, sizeof (aes_plain), aes_plain,
+                           buffer) != CRY_NOERROR) ||
+        (memcmp(buffer, v[i].ref, sizeof (aes_plain)) != 0)) {
+      return false;
+    }
+    if ((cryDecryptAES_ECB(cryp, 0, sizeof (aes_plain), buffer,
+                           buffer) != CRY_NOERROR) ||
+        (memcmp(buffer, aes_plain, sizeof (aes_plain)) != 0)) {
+      return false;
+    }
+  }
+
+  return true;
+}
+
+static bool check_aes_cbc(CRYDriver *cryp) {
+
+  if ((cryLoadAESTransientKey(cryp, sizeof (aes_key128),
+                              aes_key128) != CRY_NOERROR) ||
+      (cryEncryptAES_CBC(cryp, 0, sizeof (aes_plain), aes_plain,
+                         buffer, aes_iv) != CRY_NOERROR) ||
+      (memcmp(buffer, aes_cbc128, sizeof (aes_plain)) != 0)) {
+    return false;
+  }
+  if ((cryDecryptAES_CBC(cryp, 0, sizeof (aes_plain), buffer,
+                         buffer, aes_iv) != CRY_NOERROR) ||
+      (memcmp(buffer, aes_plain, sizeof (aes_plain)) != 0)) {
+    return false;
+  }
+
+  return true;
+}
+
+static bool check_aes_cfb(CRYDriver *cryp) {
+
+  /* The odd size checks the handling of a partial last block.*/
+  if ((cryLoadAESTransientKey(cryp, sizeof (aes_key128),
+                              aes_key128) != CRY_NOERROR) ||
+      (cryEncryptAES_CFB(cryp, 0, sizeof (aes_plain) - 5U, aes_plain,
+                         buffer, aes_iv) != CRY_NOERROR) ||
+      (memcmp(buffer, aes_cfb128, sizeof (aes_plain) - 5U) != 0)) {
+    return false;
+  }
+  if ((cryDecryptAES_CFB(cryp, 0, sizeof (aes_plain) - 5U, buffer,
+                         buffer, aes_iv) != CRY_NOERROR) ||
+      (memcmp(buffer, aes_plain, sizeof (aes_plain) - 5U) != 0)) {
+    return false;
+  }
+
+  return true;
+}
+
+static bool check_aes_ctr(CRYDriver *cryp) {
+
+  if ((cryLoadAESTransientKey(cryp, sizeof (aes_key128),
+                              aes_key128) != CRY_NOERROR) ||
+      (cryEncryptAES_CTR(cryp, 0, sizeof (aes_plain) - 5U, aes_plain,
+                         buffer, aes_ctr) != CRY_NOERROR) ||
+      (memcmp(buffer, aes_ctr128, sizeof (aes_plain) - 5U) != 0)) {
+    return false;
+  }
+  if ((cryDecryptAES_CTR(cryp, 0, sizeof (aes_plain) - 5U, buffer,
+                         buffer, aes_ctr) != CRY_NOERROR) ||
+      (memcmp(buffer, aes_plain, sizeof (aes_plain) - 5U) != 0)) {
+    return false;
+  }
+
+  return true;
+}
+
+static bool check_aes_gcm(CRYDriver *cryp) {
+  static const struct {
+    const uint8_t *k, *iv, *p, *a, *c, *t;
+    size_t        psize;
+  } v[] = {
+    {K3, IV3, P3, A3, C3, T3, P3_LEN},
+    {K4, IV4, P4, A4, C4, T4, P4_LEN},
+    {K5, IV5, P5, A5, C5, T5, P5_LEN}
+  };
+  uint8_t tag[16];
+  unsigned i;
+
+  for (i = 0U; i < sizeof (v) / sizeof (v[0]); i++) {
+    if (cryLoadAESTransientKey(cryp, K3_LEN, v[i].k) != CRY_NOERROR) {
+      return false;
+    }
+    if ((cryEncryptAES_GCM(cryp, 0, AAD3_LEN, v[i].a, v[i].psize, v[i].p,
+                           buffer, v[i].iv, sizeof (tag),
+                           tag) != CRY_NOERROR) ||
+        (memcmp(buffer, v[i].c, v[i].psize) != 0) ||
+        (memcmp(tag, v[i].t, sizeof (tag)) != 0)) {
+      return false;
+    }
+    if ((cryDecryptAES_GCM(cryp, 0, AAD3_LEN, v[i].a, v[i].psize, buffer,
+                           buffer, v[i].iv, sizeof (tag),
+                           tag) != CRY_NOERROR) ||
+        (memcmp(buffer, v[i].p, v[i].psize) != 0)) {
+      return false;
+    }
+
+    /* A corrupted tag must be rejected.*/
+    tag[0] ^= 1U;
+    if (cryDecryptAES_GCM(cryp, 0, AAD3_LEN, v[i].a, v[i].psize, v[i].c,
+                          buffer, v[i].iv, sizeof (tag),
+                          tag) != CRY_ERR_AUTH_FAILED) {
+      return false;
+    }
+  }
+
+  return true;
+}
+
+/*
+ * The hashes are computed twice, in a single update and one byte at time,
+ * in order to exercise both the direct and the buffered paths.
+ */
+static bool check_sha1(CRYDriver *cryp) {
+  static const struct {
+    const uint8_t *msg;
+    size_t        size;
+    const uint8_t *ref;
+  } v[] = {
+    {sha_msg0, 0,                    refSHA_SHA1_EMPTY},
+    {sha_msg0, sizeof (sha_msg0) - 1U, refSHA_SHA1_3},
+    {sha_msg1, sizeof (sha_msg1) - 1U, refSHA_SHA1_56},
+    {buffer,   64,                   refSHA_SHA1_64},
+    {buffer,   128,                  refSHA_SHA1_128}
+  };
+  SHA1Context ctx;
+  uint8_t digest[20];
+  unsigned i, j;
+
+  memset(buffer, 'a', 128);
+  for (i = 0U; i < sizeof (v) / sizeof (v[0]); i++) {
+    (void) crySHA1Init(cryp, &ctx);
+    (void) crySHA1Update(cryp, &ctx, v[i].size, v[i].msg);
+    (void) crySHA1Final(cryp, &ctx, digest);
+    if (memcmp(digest, v[i].ref, sizeof (digest)) != 0) {
+      return false;
+    }
+    (void) crySHA1Init(cryp, &ctx);
+    for (j = 0U; j < v[i].size; j++) {
+      (void) crySHA1Update(cryp, &ctx, 1, &v[i].msg[j]);
+    }
+    (void) crySHA1Final(cryp, &ctx, digest);
+    if (memcmp(digest, v[i].ref, sizeof (digest)) != 0) {
+      return false;
+    }
+  }
+
+  return true;
+}
+
+static bool check_sha256(CRYDriver *cryp) {
+  static const struct {
+    const uint8_t *msg;
+    size_t        size;
+    const uint8_t *ref;
+  } v[] = {
+    {sha_msg0, sizeof (sha_msg0) - 1U, refSHA_SHA256_3},
+    {sha_msg1, sizeof (sha_msg1) - 1U, refSHA_SHA256_56},
+    {buffer,   64,                   refSHA_SHA256_64},
+    {buffer,   128,                  refSHA_SHA256_128}
+  };
+  SHA256Context ctx;
+  uint8_t digest[32];
+  unsigned i, j;
+
+  memset(buffer, 'a', 128);
+  for (i = 0U; i < sizeof (v) / sizeof (v[0]); i++) {
+    (void) crySHA256Init(cryp, &ctx);
+    (void) crySHA256Update(cryp, &ctx, v[i].size, v[i].msg);
+    (void) crySHA256Final(cryp, &ctx, digest);
+    if (memcmp(digest, v[i].ref, sizeof (digest)) != 0) {
+      return false;
+    }
+    (void) crySHA256Init(cryp, &ctx);
+    for (j = 0U; j < v[i].size; j++) {
+      (void) crySHA256Update(cryp, &ctx, 1, &v[i].msg[j]);
+    }
+    (void) crySHA256Final(cryp, &ctx, digest);
+    if (memcmp(digest, v[i].ref, sizeof (digest)) != 0) {
+      return false;
+    }
+  }
+
+  return true;
+}
+
+static bool check_sha512(CRYDriver *cryp) {
+  static const struct {
+    const uint8_t *msg;
+    size_t        size;
+    const uint8_t *ref;
+  } v[] = {
+    {sha_msg0, sizeof (sha_msg0) - 1U, refSHA_SHA512_3},
+    {sha_msg1, sizeof (sha_msg1) - 1U, refSHA_SHA512_56},
+    {buffer,   64,                   refSHA_SHA512_64},
+    {buffer,   128,                  refSHA_SHA512_128}
+  };
+  SHA512Context ctx;
+  uint8_t digest[64];
+  unsigned i, j;
+
+  memset(buffer, 'a', 128);
+  for (i = 0U; i < sizeof (v) / sizeof (v[0]); i++) {
+    (void) crySHA512Init(cryp, &ctx);
+    (void) crySHA512Update(cryp, &ctx, v[i].size, v[i].msg);
+    (void) crySHA512Final(cryp, &ctx, digest);
+    if (memcmp(digest, v[i].ref, sizeof (digest)) != 0) {
+      return false;
+    }
+    (void) crySHA512Init(cryp, &ctx);
+    for (j = 0U; j < v[i].size; j++) {
+      (void) crySHA512Update(cryp, &ctx, 1, &v[i].msg[j]);
+    }
+    (void) crySHA512Final(cryp, &ctx, digest);
+    if (memcmp(digest, v[i].ref, sizeof (digest)) != 0) {
+      return false;
+    }
+  }
+
+  return true;
+}
+
+static bool check_hmac(CRYDriver *cryp) {
+  HMACSHA256Context ctx256;
+  HMACSHA512Context ctx512;
+  uint8_t digest[64];
+
+  if ((cryLoadHMACTransientKey(cryp, sizeof (hmac_key),
+                               hmac_key) != CRY_NOERROR) ||
+      (cryHMACSHA256Init(cryp, &ctx256) != CRY_NOERROR) ||
+      (cryHMACSHA256Update(cryp, &ctx256, sizeof (hmac_msg) - 1U,
+                           hmac_msg) != CRY_NOERROR) ||
+      (cryHMACSHA256Final(cryp, &ctx256, digest) != CRY_NOERROR) ||
+      (memcmp(digest, refHMAC_HMAC256_1, 32) != 0)) {
+    return false;
+  }
+  if ((cryHMACSHA512Init(cryp, &ctx512) != CRY_NOERROR) ||
+      (cryHMACSHA512Update(cryp, &ctx512, sizeof (hmac_msg) - 1U,
+                           hmac_msg) != CRY_NOERROR) ||
+      (cryHMACSHA512Final(cryp, &ctx512, digest) != CRY_NOERROR) ||
+      (memcmp(digest, refHMAC_HMAC512_1, 64) != 0)) {
+    return false;
+  }
+
+  return true;
+}
+
+static cryerror_t bench_aes_ecb(CRYDriver *cryp, uint8_t *buf, size_t n) {
+
+  return cryEncryptAES_ECB(cryp, 0, n, buf, buf);
+}
+
+static cryerror_t bench_aes_cbc(CRYDriver *cryp, uint8_t *buf, size_t n) {
+
+  return cryEncryptAES_CBC(cryp, 0, n, buf, buf, aes_iv);
+}
+
+static cryerror_t bench_aes_cbc_dec(CRYDriver *cryp, uint8_t *buf, size_t n) {
+
+  return cryDecryptAES_CBC(cryp, 0, n, buf, buf, aes_iv);
+}
+
+static cryerror_t bench_aes_cfb(CRYDriver *cryp, uint8_t *buf, size_t n) {
+
+  return cryEncryptAES_CFB(cryp, 0, n, buf, buf, aes_iv);
+}
+
+static cryerror_t bench_aes_ctr(CRYDriver *cryp, uint8_t *buf, size_t n) {
+
+  return cryEncryptAES_CTR(cryp, 0, n, buf, buf, aes_ctr);
+}
+
+static cryerror_t bench_aes_gcm(CRYDriver *cryp, uint8_t *buf, size_t n) {
+  uint8_t tag[16];
+
+  return cryEncryptAES_GCM(cryp, 0, 0, buf, n, buf, buf, aes_ctr,
+                           sizeof (tag), tag);
+}
+
+static cryerror_t bench_sha1(CRYDriver *cryp, uint8_t *buf, size_t n) {
+  SHA1Context ctx;
+
+  (void) crySHA1Init(cryp, &ctx);
+  (void) crySHA1Update(cryp, &ctx, n, buf);
+  return crySHA1Final(cryp, &ctx, buf);
+}
+
+static cryerror_t bench_sha256(CRYDriver *cryp, uint8_t *buf, size_t n) {
+  SHA256Context ctx;
+
+  (void) crySHA256Init(cryp, &ctx);
+  (void) crySHA256Update(cryp, &ctx, n, buf);
+  return crySHA256Final(cryp, &ctx, buf);
+}
+
+static cryerror_t bench_sha512(CRYDriver *cryp, uint8_t *buf, size_t n) {
+  SHA512Context ctx;
+
+  (void) crySHA512Init(cryp, &ctx);
+  (void) crySHA512Update(cryp, &ctx, n, buf);
+  return crySHA512Final(cryp, &ctx, buf);
+}
+
+static cryerror_t bench_hmac256(CRYDriver *cryp, uint8_t *buf, size_t n) {
+  HMACSHA256Context ctx;
+
+  (void) cryHMACSHA256Init(cryp, &ctx);
+  (void) cryHMACSHA256Update(cryp, &ctx, n, buf);
+  return cryHMACSHA256Final(cryp, &ctx, buf);
+}
+
+/*
+ * Runs an operation repeatedly for the configured time and prints the
+ * throughput in MB/s.
+ */
+static void bench(const crypto_bench_config_t *cfg,
+                  const char *name, bench_t fn) {
+  systime_t start, end;
+  uint32_t n, rate;
+
+  chprintf(cfg->out, "--- %-14s: ", name);
+
+  /* Aligning to the next tick.*/
+  chThdSleep(1);
+  start = chVTGetSystemTime();
+  end = chTimeAddX(start, TIME_MS2I(CRYPTO_BENCH_CFG_DURATION));
+
+  n = 0U;
+  do {
+    if (fn(cfg->cryp, buffer, sizeof (buffer)) != CRY_NOERROR) {
+      chprintf(cfg->out, "failed\r\n");
+      return;
+    }
+    n++;
+#if defined(SIMULATOR)
+    _sim_check_for_interrupts();
+#endif
+  } while (chVTIsSystemTimeWithinX(start, end));
+
+  /* Rate in units of 10KB/s, printed as MB/s with two decimals.*/
+  rate = (uint32_t)(((uint64_t)n * sizeof (buffer)) /
+                    ((uint64_t)CRYPTO_BENCH_CFG_DURATION * 10U));
+  chprintf(cfg->out, "%u.%02u MB/s\r\n",
+           rate / 100U, rate % 100U);
+}
+
+/*===========================================================================*/
+/* Module exported functions.                                                */
+/*===========================================================================*/
+
+/**
+ * @brief   Checks all the algorithms against the known answers.
+ *
+ * @param[in] cfg       pointer to the configuration structure
+ * @return              The test result.
+ * @retval true         if all the checks passed.
+ */
+bool crypto_bench_validate(const crypto_bench_config_t *cfg) {
+  static const struct {
+    const char  *name;
+    check_t     check;
+  } checks[] = {
+    {"AES-ECB",     check_aes_ecb},
+    {"AES-CBC",     check_aes_cbc},
+    {"AES-CFB",     check_aes_cfb},
+    {"AES-CTR",     check_aes_ctr},
+    {"AES-GCM",     check_aes_gcm},
+    {"SHA1",        check_sha1},
+    {"SHA256",      check_sha256},
+    {"SHA512",      check_sha512},
+    {"HMAC-SHA2",   check_hmac}
+  };
+  bool result = true;
+  unsigned i;
+
+  for (i = 0U; i < sizeof (checks) / sizeof (checks[0]); i++) {
+    bool ok = checks[i].check(cfg->cryp);
+
+    chprintf(cfg->out, "--- %-14s: %s\r\n",
+             checks[i].name, ok ? "OK" : "FAILED");
+    result = result && ok;
+  }
+
+  return result;
+}
+
+/**
+ * @brief   Validation and throughput benchmark.
+ *
+ * @param[in] cfg       pointer to the configuration structure
+ */
+void crypto_bench_execute(const crypto_bench_config_t *cfg) {
+  static const struct {
+    const char  *name;
+    bench_t     fn;
+  } benches[] = {
+    {"AES128-ECB",  bench_aes_ecb},
+    {"AES128-CBC",  bench_aes_cbc},
+    {"AES128-CBC/D", bench_aes_cbc_dec},
+    {"AES128-CFB",  bench_aes_cfb},
+    {"AES128-CTR",  bench_aes_ctr},
+    {"AES128-GCM",  bench_aes_gcm},
+    {"SHA1",        bench_sha1},
+    {"SHA256",      bench_sha256},
+    {"SHA512",      bench_sha512},
+    {"HMAC-SHA256", bench_hmac256}
+  };
+  unsigned i;
+
+  chprintf(cfg->out, "\r\n*** Crypto validation\r\n");
+  if (!crypto_bench_validate(cfg)) {
+    chprintf(cfg->out, "*** Validation failed\r\n");
+    return;
+  }
+
+  chprintf(cfg->out, "\r\n*** Crypto throughput, %u bytes buffers\r\n",
+           (unsigned)sizeof (buffer));
+  memset(buffer, 0x55, sizeof (buffer));
+  (void) cryLoadAESTransientKey(cfg->cryp, sizeof (aes_key128), aes_key128);
+  for (i = 0U; i < sizeof (benches) / sizeof (benches[0]); i++) {
+    bench(cfg, benches[i].name, benches[i].fn);
+  }
+}
+
+/** @} */
@@ -0,0 +1,104 @@
+/*
+    ChibiOS - Copyright (C) 2006..2018 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+/**
+ * @file    crypto_bench.h
+ * @brief   Crypto driver validation and benchmark header.
+ * @details The known answers are taken from the test/crypto reference
+ *          files (ref_sha.c, ref_hmac.c and ref_gcm.c) and from
+ *          NIST SP800-38A for the AES modes.
+ *
+ * @addtogroup CRYPTO_BENCH
+ * @{
+ */
+
+#ifndef CRYPTO_BENCH_H
+#define CRYPTO_BENCH_H
+
+/*===========================================================================*/
+/* Module constants.                                                         */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Module pre-compile time settings.                                         */
+/*===========================================================================*/
+
+/**
+ * @name    Configuration options
+ * @{
+ */
+/**
+ * @brief   Size of the buffer processed by each benchmark call.
+ */
+#if !defined(CRYPTO_BENCH_CFG_BUFFER_SIZE) || defined(__DOXYGEN__)
+#define CRYPTO_BENCH_CFG_BUFFER_SIZE        4096
+#endif
+
+/**
+ * @brief   Duration of each benchmark in milliseconds.
+ */
+#if !defined(CRYPTO_BENCH_CFG_DURATION) || defined(__DOXYGEN__)
+#define CRYPTO_BENCH_CFG_DURATION           1000
+#endif
+/** @} */
+
+/*===========================================================================*/
+/* Derived constants and error checks.                                       */
+/*===========================================================================*/
+
+#if (CRYPTO_BENCH_CFG_BUFFER_SIZE % 16) != 0
+#error "CRYPTO_BENCH_CFG_BUFFER_SIZE must be a multiple of 16"
+#endif
+
+/*===========================================================================*/
+/* Module data structures and types.                                         */
+/*===========================================================================*/
+
+typedef struct {
+  /**
+   * @brief   Stream for output.
+   */
+  BaseSequentialStream  *out;
+  /**
+   * @brief   Crypto driver, it must be already started.
+   */
+  CRYDriver             *cryp;
+} crypto_bench_config_t;
+
+/*===========================================================================*/
+/* Module macros.                                                            */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* External declarations.                                                    */
+/*===========================================================================*/
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+  bool crypto_bench_validate(const crypto_bench_config_t *cfg);
+  void crypto_bench_execute(const crypto_bench_config_t *cfg);
+#ifdef __cplusplus
+}
+#endif
+
+/*===========================================================================*/
+/* Module inline functions.                                                  */
+/*===========================================================================*/
+
+#endif /* CRYPTO_BENCH_H */
+
+/** @} */
@@ -0,0 +1,354 @@
+/*
+    ChibiOS - Copyright (C) 2006..2018 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+
+/**
+ * @file    dlog_bench.c
+ * @brief   Deferred logging validation and benchmark code.
+ *
+ * @addtogroup DLOG_BENCH
+ * @{
+ */
+
+#include <string.h>
+
+#include "ch.h"
+#include "hal.h"
+
+#include "chprintf.h"
+#include "memstreams.h"
+#include "nullstreams.h"
+#include "dlog_bench.h"
+#include "bench_timer.h"
+
+/*===========================================================================*/
+/* Module local definitions.                                                 */
+/*===========================================================================*/
+
+/*
+ * Writers in the concurrency check, two threads and a virtual timer.
+ */
+#define WRITERS             3U
+
+/*===========================================================================*/
+/* Module exported variables.                                                */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Module local types.                                                       */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Module local variables.                                                   */
+/*===========================================================================*/
+
+static deferred_log_t dlog;
+
+static dlog_record_t records[DLOG_BENCH_CFG_LOG_SIZE];
+
+static char text[256];
+
+static virtual_timer_t vt;
+
+static volatile unsigned vt_writes;
+
+static THD_WORKING_AREA(wa_writer1, 256);
+static THD_WORKING_AREA(wa_writer2, 256);
+
+/*
+ * Expected output of the records written by write_known().
+ */
+static const char known_text[] =
+  "no arguments\r\n"
+  "-5 123 -2147483647\r\n"
+  "  -42|7    |-0003|+9\r\n"
+  "123456789 BEEF 17\r\n"
+  "-100000 12345678\r\n"
+  "ok|str|abc\r\n"
+  "   right|left  |\r\n"
+  "100%\r\n";
+
+/*===========================================================================*/
+/* Module local functions.                                                   */
+/*===========================================================================*/
+
+/*
+ * Records covering all the supported conversions.
+ */
+static void write_known(deferred_log_t *dlp) {
+
+  dlogPrintf(dlp, "no arguments\r\n");
+  dlogPrintf(dlp, "%d %d %d\r\n", -5, 123, -2147483647);
+  dlogPrintf(dlp, "%5d|%-5d|%05d|%+d\r\n", -42, 7, -3, 9);
+  dlogPrintf(dlp, "%u %x %o\r\n", 123456789U, 0xBEEFU, 15U);
+  dlogPrintf(dlp, "%ld %lx\r\n", -100000L, 0x12345678UL);
+  dlogPrintf(dlp, "%c%c|%s|%.3s\r\n", 'o', 'k', "str", "abcdef");
+  dlogPrintf(dlp, "%8s|%-6s|\r\n", "right", "left");
+  dlogPrintf(dlp, "100%%\r\n");
+}
+
+/*
+ * Formatting of known records.
+ */
+static bool check_format(void) {
+  MemoryStream ms;
+  size_t n;
+
+  dlogObjectInit(&dlog, records, DLOG_BENCH_CFG_LOG_SIZE);
+  write_known(&dlog);
+
+  msObjectInit(&ms, (uint8_t *)text, sizeof (text) - 1U, 0U);
+  n = dlogDrain(&dlog, (BaseSequentialStream *)&ms);
+  text[ms.eos] = '\0';
+
+  return (n == 8U) && (strcmp(text, known_text) == 0);
+}
+
+/*
+ * A full log drops records without waiting.
+ */
+static bool check_overflow(void) {
+  dlog_record_t r;
+  unsigned i;
+
+  dlogObjectInit(&dlog, records, DLOG_BENCH_CFG_LOG_SIZE);
+  for (i = 0U; i < DLOG_BENCH_CFG_LOG_SIZE + 2U; i++) {
+    dlogPrintf(&dlog, "%u\r\n", i);
+  }
+  if (dlogGetDroppedX(&dlog) != 2U) {
+    return false;
+  }
+  for (i = 0U; i < DLOG_BENCH_CFG_LOG_SIZE; i++) {
+    if (!dlogFetch(&dlog, &r) || (r.args[0] != (dlogarg_t)i)) {
+      return false;
+    }
+  }
+
+  return !dlogFetch(&dlog, &r);
+}
+
+/*
+ * Concurrency check writers, a record is the writer identifier and a
+ * counter.
+ */
+static THD_FUNCTION(writer, arg) {
+  unsigned id = (unsigned)(uintptr_t)arg;
+  unsigned i;
+
+  chRegSetThreadName("dlog_writer");
+
+  for (i = 0U; i < DLOG_BENCH_CFG_WRITES; i++) {
+    dlogPrintf(&dlog, "%u %u\r\n", id, i);
+    if ((i & 15U) == 15U) {
+      chThdSleep((sysinterval_t)1);
+    }
+  }
+}
+
+static void vt_cb(void *p) {
+
+  (void)p;
+
+  chSysLockFromISR();
+  dlogPrintf(&dlog, "%u %u\r\n", WRITERS - 1U, vt_writes);
+  if (++vt_writes < DLOG_BENCH_CFG_WRITES) {
+    chVTSetI(&vt, (sysinterval_t)1, vt_cb, NULL);
+  }
+  chSysUnlockFromISR();
+}
+
+/*
+ * Records written concurrently by two threads and by a virtual timer
+ * callback, preempting each other, are drained by the calling thread.
+ * Each writer records must be received in order, lost records must be
+ * accounted in the dropped counter.
+ */
+static bool check_concurrency(void) {
+  unsigned next[WRITERS] = {0U, 0U, 0U};
+  thread_t *tp1, *tp2;
+  size_t received = 0U;
+  bool ok = true;
+  dlog_record_t r;
+
+  dlogObjectInit(&dlog, records, DLOG_BENCH_CFG_LOG_SIZE);
+  vt_writes = 0U;
+  chVTObjectInit(&vt);
+  chVTSet(&vt, (sysinterval_t)1, vt_cb, NULL);
+  tp1 = chThdCreateStatic(wa_writer1, sizeof (wa_writer1),
+                          chThdGetPriorityX() + 1, writer, (void *)0);
+  tp2 = chThdCreateStatic(wa_writer2, sizeof (wa_writer2),
+                          chThdGetPriorityX() + 1, writer, (void *)1);
+
+  while (true) {
+    /* Writers state sampled before draining, records written before
+       completion are not missed.*/
+    bool done = chThdTerminatedX(tp1) && chThdTerminatedX(tp2) &&
+                (vt_writes >= DLOG_BENCH_CFG_WRITES);
+
+    while (dlogFetch(&dlog, &r)) {
+      unsigned id = (unsigned)r.args[0];
+
+      if ((r.argc != 2U) || (id >= WRITERS) ||
+          (r.args[1] < (dlogarg_t)next[id])) {
+        ok = false;
+      }
+      else {
+        next[id] = (unsigned)r.args[1] + 1U;
+      }
+      received++;
+    }
+    if (done) {
+      break;
+    }
+    chThdSleep((sysinterval_t)1);
+  }
+  (void) chThdWait(tp1);
+  (void) chThdWait(tp2);
+
+  return ok && (received + dlogGetDroppedX(&dlog) ==
+                (size_t)WRITERS * DLOG_BENCH_CFG_WRITES);
+}
+
+/*
+ * Recording cost, the log is reset when full, the reset is not timed.
+ */
+static void bench_write(const dlog_bench_config_t *cfg) {
+  bench_timer_t bt;
+  uint64_t us = 0U;
+  unsigned i, j;
+
+  chprintf(cfg->out, "--- dlogPrintf(), 2 arguments     : ");
+
+  for (i = 0U; i < DLOG_BENCH_CFG_RECORDS; i += DLOG_BENCH_CFG_LOG_SIZE) {
+    dlogObjectInit(&dlog, records, DLOG_BENCH_CFG_LOG_SIZE);
+    bench_timer_start(&bt);
+    for (j = 0U; j < DLOG_BENCH_CFG_LOG_SIZE; j++) {
+      dlogPrintf(&dlog, "sample %u: %d\r\n", j, -(int)j);
+    }
+    us += bench_timer_elapsed_us(&bt);
+  }
+
+  chprintf(cfg->out, "%9u ns/record\r\n",
+           (unsigned)((us * 1000U) / DLOG_BENCH_CFG_RECORDS));
+}
+
+/*
+ * Formatting cost of the same records, in place and deferred.
+ */
+static void bench_format(const dlog_bench_config_t *cfg) {
+  NullStream ns;
+  bench_timer_t bt;
+  uint64_t us = 0U;
+  unsigned i, j;
+
+  nullObjectInit(&ns);
+
+  chprintf(cfg->out, "--- chprintf(), 2 arguments       : ");
+  bench_timer_start(&bt);
+  for (i = 0U; i < DLOG_BENCH_CFG_RECORDS; i++) {
+    chprintf((BaseSequentialStream *)&ns, "sample %u: %d\r\n", i, -(int)i);
+  }
+  chprintf(cfg->out, "%9u ns/record\r\n",
+           (unsigned)((bench_timer_elapsed_us(&bt) * 1000U) /
+                      DLOG_BENCH_CFG_RECORDS));
+
+  chprintf(cfg->out, "--- dlogDrain(), 2 arguments      : ");
+  for (i = 0U; i < DLOG_BENCH_CFG_RECORDS; i += DLOG_BENCH_CFG_LOG_SIZE) {
+    dlogObjectInit(&dlog, records, DLOG_BENCH_CFG_LOG_SIZE);
+    for (j = 0U; j < DLOG_BENCH_CFG_LOG_SIZE; j++) {
+      dlogPrintf(&dlog, "sample %u: %d\r\n", j, -(int)j);
+    }
+    bench_timer_start(&bt);
+    (void) dlogDrain(&dlog, (BaseSequentialStream *)&ns);
+    us += bench_timer_elapsed_us(&bt);
+  }
+  chprintf(cfg->out, "%9u ns/record\r\n",
+           (unsigned)((us * 1000U) / DLOG_BENCH_CFG_RECORDS));
+}
+
+/*===========================================================================*/
+/* Module exported functions.                                                */
+/*===========================================================================*/
+
+/**
+ * @brief   Validation of the deferred logging.
+ *
+ * @param[in] cfg       pointer to the configuration structure
+ * @return              The validation result.
+ * @retval true         if all the checks passed.
+ */
+bool dlog_bench_validate(const dlog_bench_config_t *cfg) {
+  static const struct {
+    const char  *name;
+    bool        (*check)(void);
+  } checks[] = {
+    {"Formatting",  check_format},
+    {"Overflow",    check_overflow},
+    {"Concurrency", check_concurrency}
+  };
+  bool result = true;
+  unsigned i;
+
+  for (i = 0U; i < sizeof (checks) / sizeof (checks[0]); i++) {
+    bool ok = checks[i].check();
+
+    chprintf(cfg->out, "--- %-14s: %s\r\n",
+             checks[i].name, ok ? "OK" : "FAILED");
+    result = result && ok;
+  }
+
+  return result;
+}
+
+/**
+ * @brief   Exports known records for host decoding.
+ * @details The same records are exported in binary form and formatted,
+ *          the host decoder output is expected to match the formatted
+ *          text.
+ *
+ * @param[in] binp      stream receiving the binary records
+ * @param[in] txtp      stream receiving the formatted records
+ */
+void dlog_bench_export(BaseSequentialStream *binp,
+                       BaseSequentialStream *txtp) {
+
+  dlogObjectInit(&dlog, records, DLOG_BENCH_CFG_LOG_SIZE);
+  write_known(&dlog);
+  (void) dlogDrainBinary(&dlog, binp);
+  write_known(&dlog);
+  (void) dlogDrain(&dlog, txtp);
+}
+
+/**
+ * @brief   Validation and benchmark.
+ *
+ * @param[in] cfg       pointer to the configuration structure
+ */
+void dlog_bench_execute(const dlog_bench_config_t *cfg) {
+
+  chprintf(cfg->out, "\r\n*** Deferred logging validation\r\n");
+  if (!dlog_bench_validate(cfg)) {
+    chprintf(cfg->out, "*** Validation failed\r\n");
+    return;
+  }
+
+  chprintf(cfg->out, "\r\n*** Deferred logging, %u records\r\n",
+           (unsigned)DLOG_BENCH_CFG_RECORDS);
+  bench_write(cfg);
+  bench_format(cfg);
+}
+
+/** @} */
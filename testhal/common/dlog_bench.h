@@ -0,0 +1,114 @@
+/*
+    ChibiOS - Copyright (C) 2006..2018 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+
+/**
+ * @file    dlog_bench.h
+ * @brief   Deferred logging validation and benchmark header.
+ * @details The records formatting is checked against known outputs, the
+ *          log is then filled concurrently by threads and by a virtual
+ *          timer callback while being drained. The cost of recording is
+ *          compared with the cost of formatting.
+ *
+ * @addtogroup DLOG_BENCH
+ * @{
+ */
+
+#ifndef DLOG_BENCH_H
+#define DLOG_BENCH_H
+
+#include "dlog.h"
+
+/*===========================================================================*/
+/* Module constants.                                                         */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Module pre-compile time settings.                                         */
+/*===========================================================================*/
+
+/**
+ * @name    Configuration options
+ * @{
+ */
+/**
+ * @brief   Number of records written by each benchmark.
+ */
+#if !defined(DLOG_BENCH_CFG_RECORDS) || defined(__DOXYGEN__)
+#define DLOG_BENCH_CFG_RECORDS              200000
+#endif
+
+/**
+ * @brief   Number of records written by each writer in the concurrency
+ *          check.
+ */
+#if !defined(DLOG_BENCH_CFG_WRITES) || defined(__DOXYGEN__)
+#define DLOG_BENCH_CFG_WRITES               2000
+#endif
+
+/**
+ * @brief   Number of records in the log, it must be a power of two.
+ */
+#if !defined(DLOG_BENCH_CFG_LOG_SIZE) || defined(__DOXYGEN__)
+#define DLOG_BENCH_CFG_LOG_SIZE             256
+#endif
+/** @} */
+
+/*===========================================================================*/
+/* Derived constants and error checks.                                       */
+/*===========================================================================*/
+
+#if (DLOG_BENCH_CFG_LOG_SIZE & (DLOG_BENCH_CFG_LOG_SIZE - 1)) != 0
+#error "DLOG_BENCH_CFG_LOG_SIZE must be a power of two"
+#endif
+
+/*===========================================================================*/
+/* Module data structures and types.                                         */
+/*===========================================================================*/
+
+typedef struct {
+  /**
+   * @brief   Stream for output.
+   */
+  BaseSequentialStream  *out;
+} dlog_bench_config_t;
+
+/*===========================================================================*/
+/* Module macros.                                                            */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* External declarations.                                                    */
+/*===========================================================================*/
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+  bool dlog_bench_validate(const dlog_bench_config_t *cfg);
+  void dlog_bench_export(BaseSequentialStream *binp,
+                         BaseSequentialStream *txtp);
+  void dlog_bench_execute(const dlog_bench_config_t *cfg);
+#ifdef __cplusplus
+}
+#endif
+
+/*===========================================================================*/
+/* Module inline functions.                                                  */
+/*===========================================================================*/
+
+#endif /* DLOG_BENCH_H */
+
+/** @} */
@@ -0,0 +1,276 @@
+/*
+    ChibiOS - Copyright (C) 2006..2018 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+/**
+ * @file    fatfs_bench.c
+ * @brief   FatFS throughput benchmark code.
+ *
+ * @addtogroup FATFS_BENCH
+ * @{
+ */
+
+#include <string.h>
+
+#include "ch.h"
+#include "hal.h"
+
+#include "chprintf.h"
+#include "fatfs_bench.h"
+
+/*===========================================================================*/
+/* Module local definitions.                                                 */
+/*===========================================================================*/
+
+#define SECTOR_SIZE             512U
+
+/*===========================================================================*/
+/* Module exported variables.                                                */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Module local types.                                                       */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Module local variables.                                                   */
+/*===========================================================================*/
+
+/*
+ * Data buffer, one extra word allows for unaligned transfers.
+ */
+static uint32_t buffer[(FATFS_BENCH_CFG_MAX_CHUNK / sizeof (uint32_t)) + 1U];
+
+static FIL file;
+
+/*
+ * Random generator state.
+ */
+static uint32_t seed;
+
+/*===========================================================================*/
+/* Module local functions.                                                   */
+/*===========================================================================*/
+
+static uint32_t next_random(void) {
+
+  seed = (seed * 1103515245U) + 12345U;
+
+  return seed >> 8;
+}
+
+static void stats_reset(const fatfs_bench_config_t *cfg) {
+
+  if (cfg->rdp != NULL) {
+    ramdiskResetStats(cfg->rdp);
+  }
+}
+
+/*
+ * Prints the device commands issued during a benchmark, the average number
+ * of blocks per command shows the effect of the write coalescing.
+ */
+static void stats_print(const fatfs_bench_config_t *cfg) {
+  ramdisk_stats_t stats;
+  uint32_t cmds, blocks;
+
+  if (cfg->rdp == NULL) {
+    chprintf(cfg->out, "\r\n");
+    return;
+  }
+
+  ramdiskGetStats(cfg->rdp, &stats);
+  cmds   = stats.reads + stats.writes;
+  blocks = stats.blocks_read + stats.blocks_written;
+  chprintf(cfg->out, ", %u cmds", (unsigned)cmds);
+  if (cmds > 0U) {
+    blocks = (blocks * 10U) / cmds;
+    chprintf(cfg->out, ", %u.%u blks/cmd", blocks / 10U, blocks % 10U);
+  }
+  chprintf(cfg->out, "\r\n");
+}
+
+static void print_rate(const fatfs_bench_config_t *cfg,
+                       uint64_t bytes, systime_t start) {
+  time_msecs_t ms;
+
+  ms = chTimeI2MS(chTimeDiffX(start, chVTGetSystemTimeX()));
+  if (ms == (time_msecs_t)0) {
+    ms = (time_msecs_t)1;
+  }
+  chprintf(cfg->out, "%8u KB/s",
+           (unsigned)((bytes * 1000U) / ((uint64_t)ms * 1024U)));
+}
+
+/*
+ * Sequential benchmark, the whole file is written or read repeatedly
+ * using the specified chunk size for the configured time.
+ */
+static bool bench_seq(const fatfs_bench_config_t *cfg, bool wr,
+                      size_t chunk, bool aligned) {
+  uint8_t *bp = aligned ? (uint8_t *)buffer : (uint8_t *)buffer + 1;
+  systime_t start, end;
+  uint64_t bytes;
+  bool ok;
+  UINT n;
+
+  chprintf(cfg->out, "--- %s %5u %s : ", wr ? "Write" : "Read ",
+           (unsigned)chunk, aligned ? "aligned  " : "unaligned");
+
+  if (f_open(&file, cfg->path, wr ? FA_WRITE | FA_OPEN_ALWAYS : FA_READ) !=
+      FR_OK) {
+    chprintf(cfg->out, "open failed\r\n");
+    return false;
+  }
+
+  stats_reset(cfg);
+
+  /* Aligning to the next tick.*/
+  chThdSleep(1);
+  start = chVTGetSystemTime();
+  end = chTimeAddX(start, TIME_MS2I(FATFS_BENCH_CFG_DURATION));
+
+  bytes = 0U;
+  ok = true;
+  do {
+    size_t left = FATFS_BENCH_CFG_FILE_SIZE;
+
+    ok = f_lseek(&file, 0U) == FR_OK;
+    while (ok && (left > 0U)) {
+      FRESULT err = wr ? f_write(&file, bp, (UINT)chunk, &n) :
+                         f_read(&file, bp, (UINT)chunk, &n);
+      ok = (err == FR_OK) && (n == (UINT)chunk);
+      left  -= chunk;
+      bytes += chunk;
+    }
+#if defined(SIMULATOR)
+    _sim_check_for_interrupts();
+#endif
+  } while (ok && chVTIsSystemTimeWithinX(start, end));
+
+  if (!ok) {
+    chprintf(cfg->out, "%s failed\r\n", wr ? "write" : "read");
+    (void) f_close(&file);
+    return false;
+  }
+
+  /* Buffered data is part of the measure.*/
+  if (f_close(&file) != FR_OK) {
+    chprintf(cfg->out, "close failed\r\n");
+    return false;
+  }
+
+  print_rate(cfg, bytes, start);
+  stats_print(cfg);
+
+  return true;
+}
+
+/*
+ * Random benchmark, single sectors are written or read at random sector
+ * aligned file offsets for the configured time.
+ */
+static void bench_random(const fatfs_bench_config_t *cfg, bool wr) {
+  systime_t start, end;
+  uint32_t ops;
+  UINT n;
+
+  chprintf(cfg->out, "--- Random %s        : ", wr ? "write" : "read ");
+
+  if (f_open(&file, cfg->path, wr ? FA_WRITE : FA_READ) != FR_OK) {
+    chprintf(cfg->out, "open failed\r\n");
+    return;
+  }
+
+  stats_reset(cfg);
+  seed = 0x12345678U;
+
+  /* Aligning to the next tick.*/
+  chThdSleep(1);
+  start = chVTGetSystemTime();
+  end = chTimeAddX(start, TIME_MS2I(FATFS_BENCH_CFG_DURATION));
+
+  ops = 0U;
+  do {
+    FSIZE_t ofs = (FSIZE_t)(next_random() %
+                            (FATFS_BENCH_CFG_FILE_SIZE / SECTOR_SIZE)) *
+                  SECTOR_SIZE;
+    FRESULT err;
+
+    err = f_lseek(&file, ofs);
+    if (err == FR_OK) {
+      err = wr ? f_write(&file, buffer, SECTOR_SIZE, &n) :
+                 f_read(&file, buffer, SECTOR_SIZE, &n);
+    }
+    if ((err != FR_OK) || (n != SECTOR_SIZE)) {
+      chprintf(cfg->out, "%s failed\r\n", wr ? "write" : "read");
+      (void) f_close(&file);
+      return;
+    }
+    ops++;
+#if defined(SIMULATOR)
+    _sim_check_for_interrupts();
+#endif
+  } while (chVTIsSystemTimeWithinX(start, end));
+
+  if (f_close(&file) != FR_OK) {
+    chprintf(cfg->out, "close failed\r\n");
+    return;
+  }
+
+  print_rate(cfg, (uint64_t)ops * SECTOR_SIZE, start);
+  chprintf(cfg->out, ", %u ops/s",
+           (unsigned)(((uint64_t)ops * 1000U) / FATFS_BENCH_CFG_DURATION));
+  stats_print(cfg);
+}
+
+/*===========================================================================*/
+/* Module exported functions.                                                */
+/*===========================================================================*/
+
+/**
+ * @brief   FatFS throughput benchmark.
+ * @details The benchmark file is created, or overwritten, on the mounted
+ *          volume and removed at the end.
+ *
+ * @param[in] cfg       pointer to the configuration structure
+ */
+void fatfs_bench_execute(const fatfs_bench_config_t *cfg) {
+  static const size_t chunks[] = {SECTOR_SIZE, 4096U,
+                                  FATFS_BENCH_CFG_MAX_CHUNK};
+  unsigned i;
+
+  chprintf(cfg->out, "\r\n*** FatFS throughput, %u bytes file\r\n",
+           (unsigned)FATFS_BENCH_CFG_FILE_SIZE);
+
+  memset(buffer, 0x55, sizeof (buffer));
+
+  for (i = 0U; i < sizeof (chunks) / sizeof (chunks[0]); i++) {
+    if (!bench_seq(cfg, true, chunks[i], true) ||
+        !bench_seq(cfg, false, chunks[i], true) ||
+        !bench_seq(cfg, true, chunks[i], false) ||
+        !bench_seq(cfg, false, chunks[i], false)) {
+      (void) f_unlink(cfg->path);
+      return;
+    }
+  }
+
+  bench_random(cfg, true);
+  bench_random(cfg, false);
+
+  (void) f_unlink(cfg->path);
+}
+
+/** @} */
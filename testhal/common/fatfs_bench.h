@@ -0,0 +1,120 @@
+/*
+    ChibiOS - Copyright (C) 2006..2018 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+/**
+ * @file    fatfs_bench.h
+ * @brief   FatFS throughput benchmark header.
+ * @details A file is written and read sequentially using different chunk
+ *          sizes and aligned or unaligned buffers, then random single
+ *          sector accesses are performed. The volume must be already
+ *          mounted, if the drive is a @p RamDisk then the number of
+ *          device commands is also reported.
+ *
+ * @addtogroup FATFS_BENCH
+ * @{
+ */
+
+#ifndef FATFS_BENCH_H
+#define FATFS_BENCH_H
+
+#include "ff.h"
+#include "ramdisk.h"
+
+/*===========================================================================*/
+/* Module constants.                                                         */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Module pre-compile time settings.                                         */
+/*===========================================================================*/
+
+/**
+ * @name    Configuration options
+ * @{
+ */
+/**
+ * @brief   Size of the benchmark file.
+ */
+#if !defined(FATFS_BENCH_CFG_FILE_SIZE) || defined(__DOXYGEN__)
+#define FATFS_BENCH_CFG_FILE_SIZE           (256 * 1024)
+#endif
+
+/**
+ * @brief   Largest chunk size used by the sequential benchmarks.
+ */
+#if !defined(FATFS_BENCH_CFG_MAX_CHUNK) || defined(__DOXYGEN__)
+#define FATFS_BENCH_CFG_MAX_CHUNK           16384
+#endif
+
+/**
+ * @brief   Duration of the random access benchmarks in milliseconds.
+ */
+#if !defined(FATFS_BENCH_CFG_DURATION) || defined(__DOXYGEN__)
+#define FATFS_BENCH_CFG_DURATION            1000
+#endif
+/** @} */
+
+/*===========================================================================*/
+/* Derived constants and error checks.                                       */
+/*===========================================================================*/
+
+#if (FATFS_BENCH_CFG_MAX_CHUNK < 512) ||                                    \
+    ((FATFS_BENCH_CFG_FILE_SIZE % FATFS_BENCH_CFG_MAX_CHUNK) != 0)
+#error "invalid FATFS_BENCH_CFG_MAX_CHUNK value"
+#endif
+
+/*===========================================================================*/
+/* Module data structures and types.                                         */
+/*===========================================================================*/
+
+typedef struct {
+  /**
+   * @brief   Stream for output.
+   */
+  BaseSequentialStream  *out;
+  /**
+   * @brief   Path of the benchmark file on a mounted volume.
+   */
+  const char            *path;
+  /**
+   * @brief   RAM disk behind the volume or @p NULL.
+   */
+  RamDisk               *rdp;
+} fatfs_bench_config_t;
+
+/*===========================================================================*/
+/* Module macros.                                                            */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* External declarations.                                                    */
+/*===========================================================================*/
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+  void fatfs_bench_execute(const fatfs_bench_config_t *cfg);
+#ifdef __cplusplus
+}
+#endif
+
+/*===========================================================================*/
+/* Module inline functions.                                                  */
+/*===========================================================================*/
+
+#endif /* FATFS_BENCH_H */
+
+/** @} */
@@ -0,0 +1,287 @@
+/*
+    ChibiOS - Copyright (C) 2006..2018 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+/**
+ * @file    jobs_bench.c
+ * @brief   Jobs queues and dispatchers benchmark code.
+ *
+ * @addtogroup JOBS_BENCH
+ * @{
+ */
+
+#include "ch.h"
+#include "hal.h"
+
+#include "chprintf.h"
+#include "bench_timer.h"
+#include "jobs_bench.h"
+
+/*===========================================================================*/
+/* Module local definitions.                                                 */
+/*===========================================================================*/
+
+/**
+ * @brief   Maximum number of worker threads.
+ */
+#define MAX_WORKERS             2U
+
+/**
+ * @brief   Lane of the null jobs terminating the workers.
+ */
+#define LAST_LANE               ((unsigned)CH_CFG_JOBS_LANES - 1U)
+
+/*===========================================================================*/
+/* Module exported variables.                                                */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Module local types.                                                       */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Module local variables.                                                   */
+/*===========================================================================*/
+
+static THD_WORKING_AREA(wa_worker1, JOBS_BENCH_CFG_WORKER_STACK_SIZE);
+static THD_WORKING_AREA(wa_worker2, JOBS_BENCH_CFG_WORKER_STACK_SIZE);
+
+static void *const wa_workers[MAX_WORKERS] = {wa_worker1, wa_worker2};
+
+static job_descriptor_t jobs[JOBS_BENCH_CFG_DESCRIPTORS];
+static msg_t msgs[JOBS_BENCH_CFG_DESCRIPTORS];
+
+static jobs_queue_t jq;
+static jobs_dispatcher_t jd;
+
+static binary_semaphore_t done_sem;
+static volatile uint32_t executed;
+
+/*===========================================================================*/
+/* Module local functions.                                                   */
+/*===========================================================================*/
+
+static void job_count(void *arg) {
+
+  (void)arg;
+
+  executed++;
+}
+
+static void job_signal(void *arg) {
+
+  (void)arg;
+
+  chBSemSignal(&done_sem);
+}
+
+/*
+ * Worker of the mailbox based jobs queue.
+ */
+static THD_FUNCTION(queue_worker, arg) {
+  jobs_queue_t *jqp = (jobs_queue_t *)arg;
+
+  chRegSetThreadName("queue_worker");
+
+  while (chJobDispatch(jqp) != MSG_JOB_NULL) {
+  }
+}
+
+static void print_rate(const jobs_bench_config_t *cfg,
+                       const bench_timer_t *btp) {
+
+  chprintf(cfg->out, "%9u jobs/s\r\n",
+           (unsigned)bench_timer_rate(btp, (uint64_t)executed));
+}
+
+static void print_latency(const jobs_bench_config_t *cfg,
+                          const bench_timer_t *btp, uint32_t n) {
+
+  chprintf(cfg->out, "%9u ns/job\r\n",
+           (unsigned)((bench_timer_elapsed_us(btp) * 1000U) / n));
+}
+
+/*
+ * Throughput of the mailbox based jobs queue, a single worker.
+ */
+static void bench_queue(const jobs_bench_config_t *cfg) {
+  job_descriptor_t *jp;
+  bench_timer_t bt;
+  thread_t *tp;
+  uint32_t i;
+
+  chprintf(cfg->out, "--- Queue,      1 worker,  batch 1 : ");
+
+  chJobObjectInit(&jq, JOBS_BENCH_CFG_DESCRIPTORS, jobs, msgs);
+  executed = 0U;
+  tp = chThdCreateStatic(wa_worker1, sizeof (wa_worker1),
+                         chThdGetPriorityX(), queue_worker, &jq);
+
+  bench_timer_start(&bt);
+  for (i = 0U; i < (uint32_t)JOBS_BENCH_CFG_JOBS; i++) {
+    jp = chJobGet(&jq);
+    jp->jobfunc = job_count;
+    jp->jobarg  = NULL;
+    chJobPost(&jq, jp);
+  }
+  jp = chJobGet(&jq);
+  jp->jobfunc = NULL;
+  chJobPost(&jq, jp);
+  (void) chThdWait(tp);
+
+  print_rate(cfg, &bt);
+}
+
+/*
+ * Throughput of a jobs dispatcher with the specified batch size and
+ * workers number, the jobs are spread over all the lanes.
+ */
+static void bench_dispatcher(const jobs_bench_config_t *cfg,
+                             size_t batch, unsigned nworkers) {
+  thread_t *tps[MAX_WORKERS];
+  job_descriptor_t *jp;
+  bench_timer_t bt;
+  uint32_t i;
+  unsigned w;
+
+  chprintf(cfg->out, "--- Dispatcher, %u worker%s batch %u : ",
+           nworkers, nworkers > 1U ? "s," : ", ", (unsigned)batch);
+
+  chJobDispatcherObjectInit(&jd, JOBS_BENCH_CFG_DESCRIPTORS, jobs, batch);
+  executed = 0U;
+  for (w = 0U; w < nworkers; w++) {
+    tps[w] = chJobDispatcherCreateWorker(&jd, "dispatcher_worker",
+                                         wa_workers[w],
+                                         sizeof (wa_worker1),
+                                         chThdGetPriorityX());
+  }
+
+  bench_timer_start(&bt);
+  for (i = 0U; i < (uint32_t)JOBS_BENCH_CFG_JOBS; i++) {
+    jp = chJobDispatcherGet(&jd);
+    jp->jobfunc = job_count;
+    jp->jobarg  = NULL;
+    chJobDispatcherPost(&jd, jp, (unsigned)i % (unsigned)CH_CFG_JOBS_LANES);
+  }
+  for (w = 0U; w < nworkers; w++) {
+    jp = chJobDispatcherGet(&jd);
+    jp->jobfunc = NULL;
+    chJobDispatcherPost(&jd, jp, LAST_LANE);
+  }
+  for (w = 0U; w < nworkers; w++) {
+    (void) chThdWait(tps[w]);
+  }
+
+  print_rate(cfg, &bt);
+}
+
+/*
+ * Round trip of a job posted on the mailbox based jobs queue, the job
+ * signals a semaphore the poster waits on.
+ */
+static void bench_queue_latency(const jobs_bench_config_t *cfg) {
+  uint32_t i, n = (uint32_t)JOBS_BENCH_CFG_JOBS / 10U;
+  job_descriptor_t *jp;
+  bench_timer_t bt;
+  thread_t *tp;
+
+  chprintf(cfg->out, "--- Queue round trip, semaphore    : ");
+
+  chJobObjectInit(&jq, JOBS_BENCH_CFG_DESCRIPTORS, jobs, msgs);
+  chBSemObjectInit(&done_sem, true);
+  tp = chThdCreateStatic(wa_worker1, sizeof (wa_worker1),
+                         chThdGetPriorityX(), queue_worker, &jq);
+
+  bench_timer_start(&bt);
+  for (i = 0U; i < n; i++) {
+    jp = chJobGet(&jq);
+    jp->jobfunc = job_signal;
+    jp->jobarg  = NULL;
+    chJobPost(&jq, jp);
+    (void) chBSemWait(&done_sem);
+  }
+  print_latency(cfg, &bt, n);
+
+  jp = chJobGet(&jq);
+  jp->jobfunc = NULL;
+  chJobPost(&jq, jp);
+  (void) chThdWait(tp);
+}
+
+/*
+ * Round trip of a job posted on a jobs dispatcher and waited on using
+ * a future.
+ */
+static void bench_dispatcher_latency(const jobs_bench_config_t *cfg) {
+  uint32_t i, n = (uint32_t)JOBS_BENCH_CFG_JOBS / 10U;
+  job_descriptor_t *jp;
+  job_future_t future;
+  bench_timer_t bt;
+  thread_t *tp;
+
+  chprintf(cfg->out, "--- Dispatcher round trip, future  : ");
+
+  chJobDispatcherObjectInit(&jd, JOBS_BENCH_CFG_DESCRIPTORS, jobs, 1U);
+  tp = chJobDispatcherCreateWorker(&jd, "dispatcher_worker", wa_worker1,
+                                   sizeof (wa_worker1), chThdGetPriorityX());
+
+  bench_timer_start(&bt);
+  for (i = 0U; i < n; i++) {
+    chJobFutureObjectInit(&future);
+    jp = chJobDispatcherGet(&jd);
+    jp->jobfunc = job_count;
+    jp->jobarg  = NULL;
+    jp->future  = &future;
+    chJobDispatcherPost(&jd, jp, 0U);
+    (void) chJobFutureWait(&future);
+  }
+  print_latency(cfg, &bt, n);
+
+  jp = chJobDispatcherGet(&jd);
+  jp->jobfunc = NULL;
+  chJobDispatcherPost(&jd, jp, LAST_LANE);
+  (void) chThdWait(tp);
+}
+
+/*===========================================================================*/
+/* Module exported functions.                                                */
+/*===========================================================================*/
+
+/**
+ * @brief   Jobs benchmark.
+ * @details The workers run at the priority of the calling thread, the
+ *          posted jobs accumulate until the descriptors are exhausted
+ *          then the workers drain them.
+ *
+ * @param[in] cfg       pointer to the configuration structure
+ */
+void jobs_bench_execute(const jobs_bench_config_t *cfg) {
+
+  chprintf(cfg->out, "\r\n*** Jobs throughput, %u jobs, %u descriptors\r\n",
+           (unsigned)JOBS_BENCH_CFG_JOBS,
+           (unsigned)JOBS_BENCH_CFG_DESCRIPTORS);
+
+  bench_queue(cfg);
+  bench_dispatcher(cfg, 1U, 1U);
+  bench_dispatcher(cfg, JOBS_BENCH_CFG_MAX_BATCH, 1U);
+  bench_dispatcher(cfg, JOBS_BENCH_CFG_MAX_BATCH, MAX_WORKERS);
+
+  chprintf(cfg->out, "\r\n*** Jobs latency\r\n");
+
+  bench_queue_latency(cfg);
+  bench_dispatcher_latency(cfg);
+}
+
+/** @} */
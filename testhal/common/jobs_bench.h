@@ -0,0 +1,119 @@
+/*
+    ChibiOS - Copyright (C) 2006..2018 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+/**
+ * @file    jobs_bench.h
+ * @brief   Jobs queues and dispatchers benchmark header.
+ * @details Empty jobs are posted by the calling thread and executed by
+ *          lower priority workers, the mailbox based jobs queue is
+ *          compared with jobs dispatchers using different batch sizes and
+ *          workers counts. The round trip time of a job waited on using a
+ *          future is also measured.
+ *
+ * @addtogroup JOBS_BENCH
+ * @{
+ */
+
+#ifndef JOBS_BENCH_H
+#define JOBS_BENCH_H
+
+/*===========================================================================*/
+/* Module constants.                                                         */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Module pre-compile time settings.                                         */
+/*===========================================================================*/
+
+/**
+ * @name    Configuration options
+ * @{
+ */
+/**
+ * @brief   Number of jobs posted by each throughput benchmark.
+ */
+#if !defined(JOBS_BENCH_CFG_JOBS) || defined(__DOXYGEN__)
+#define JOBS_BENCH_CFG_JOBS                 200000
+#endif
+
+/**
+ * @brief   Number of job descriptors.
+ */
+#if !defined(JOBS_BENCH_CFG_DESCRIPTORS) || defined(__DOXYGEN__)
+#define JOBS_BENCH_CFG_DESCRIPTORS          16
+#endif
+
+/**
+ * @brief   Largest batch size used by the dispatcher benchmarks.
+ */
+#if !defined(JOBS_BENCH_CFG_MAX_BATCH) || defined(__DOXYGEN__)
+#define JOBS_BENCH_CFG_MAX_BATCH            8
+#endif
+
+/**
+ * @brief   Stack size of the worker threads.
+ */
+#if !defined(JOBS_BENCH_CFG_WORKER_STACK_SIZE) || defined(__DOXYGEN__)
+#define JOBS_BENCH_CFG_WORKER_STACK_SIZE    256
+#endif
+/** @} */
+
+/*===========================================================================*/
+/* Derived constants and error checks.                                       */
+/*===========================================================================*/
+
+#if JOBS_BENCH_CFG_MAX_BATCH > JOBS_BENCH_CFG_DESCRIPTORS
+#error "JOBS_BENCH_CFG_MAX_BATCH exceeds JOBS_BENCH_CFG_DESCRIPTORS"
+#endif
+
+#if CH_CFG_USE_WAITEXIT == FALSE
+#error "jobs_bench requires CH_CFG_USE_WAITEXIT"
+#endif
+
+/*===========================================================================*/
+/* Module data structures and types.                                         */
+/*===========================================================================*/
+
+typedef struct {
+  /**
+   * @brief   Stream for output.
+   */
+  BaseSequentialStream  *out;
+} jobs_bench_config_t;
+
+/*===========================================================================*/
+/* Module macros.                                                            */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* External declarations.                                                    */
+/*===========================================================================*/
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+  void jobs_bench_execute(const jobs_bench_config_t *cfg);
+#ifdef __cplusplus
+}
+#endif
+
+/*===========================================================================*/
+/* Module inline functions.                                                  */
+/*===========================================================================*/
+
+#endif /* JOBS_BENCH_H */
+
+/** @} */
@@ -0,0 +1,329 @@
+/*
+    ChibiOS - Copyright (C) 2006..2018 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+/**
+ * @file    lwip_bench.c
+ * @brief   lwIP MAC interface benchmark code.
+ *
+ * @addtogroup LWIP_BENCH
+ * @{
+ */
+
+#include <string.h>
+
+#include "ch.h"
+#include "hal.h"
+
+#include "chprintf.h"
+#include "lwipthread.h"
+#include "lwip_bench.h"
+
+#include <lwip/pbuf.h>
+#include <lwip/stats.h>
+#include <lwip/api.h>
+
+/*===========================================================================*/
+/* Module local definitions.                                                 */
+/*===========================================================================*/
+
+#define ETH_HEADER_SIZE         14U
+#define ETH_MAX_FRAME_SIZE      1514U
+
+/*===========================================================================*/
+/* Module exported variables.                                                */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Module local types.                                                       */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Module local variables.                                                   */
+/*===========================================================================*/
+
+/*
+ * Frame payload, referred by the benchmark pbufs.
+ */
+static uint8_t payload[ETH_MAX_FRAME_SIZE - ETH_HEADER_SIZE];
+
+#if LWIP_NETCONN && LWIP_NETIF_LOOPBACK
+/*
+ * Churn benchmark server thread and its termination flag.
+ */
+static THD_WORKING_AREA(wa_churn_server, LWIP_BENCH_CFG_SERVER_STACK_SIZE);
+static volatile bool churn_stop;
+#endif
+
+/*===========================================================================*/
+/* Module local functions.                                                   */
+/*===========================================================================*/
+
+/*
+ * Builds a two pbufs frame, an header pbuf followed by a payload pbuf
+ * referring static data, as lwIP does for TCP segments.
+ */
+static struct pbuf *make_frame(struct netif *netif, size_t size) {
+  struct pbuf *hdr, *pl;
+  uint8_t *hp;
+
+  hdr = pbuf_alloc(PBUF_RAW, (u16_t)ETH_HEADER_SIZE, PBUF_RAM);
+  if (hdr == NULL) {
+    return NULL;
+  }
+  pl = pbuf_alloc(PBUF_RAW, (u16_t)(size - ETH_HEADER_SIZE), PBUF_ROM);
+  if (pl == NULL) {
+    (void) pbuf_free(hdr);
+    return NULL;
+  }
+  pl->payload = payload;
+
+  /* Sending to ourselves.*/
+  hp = (uint8_t *)hdr->payload;
+  memcpy(&hp[0], netif->hwaddr, 6U);
+  memcpy(&hp[6], netif->hwaddr, 6U);
+  hp[12] = (uint8_t)(LWIP_BENCH_ETHTYPE >> 8);
+  hp[13] = (uint8_t)(LWIP_BENCH_ETHTYPE & 0xFFU);
+
+  pbuf_cat(hdr, pl);
+
+  return hdr;
+}
+
+/*
+ * Sends frames of the specified size for the configured time and prints
+ * the achieved rate.
+ */
+static void bench(const lwip_bench_config_t *cfg, size_t size) {
+  struct netif *netif = cfg->netif;
+  systime_t start, end;
+  uint32_t n, rate;
+  struct pbuf *p;
+#if LINK_STATS
+  STAT_COUNTER recv;
+#endif
+
+  chprintf(cfg->out, "--- %4u bytes  : ", (unsigned)size);
+
+  p = make_frame(netif, size);
+  if (p == NULL) {
+    chprintf(cfg->out, "out of memory\r\n");
+    return;
+  }
+
+#if LINK_STATS
+  recv = lwip_stats.link.recv;
+#endif
+
+  /* Aligning to the next tick.*/
+  chThdSleep(1);
+  start = chVTGetSystemTime();
+  end = chTimeAddX(start, TIME_MS2I(LWIP_BENCH_CFG_DURATION));
+
+  n = 0U;
+  do {
+    if (netif->linkoutput(netif, p) != ERR_OK) {
+      chprintf(cfg->out, "failed\r\n");
+      (void) pbuf_free(p);
+      return;
+    }
+    n++;
+#if defined(SIMULATOR)
+    _sim_check_for_interrupts();
+#endif
+  } while (chVTIsSystemTimeWithinX(start, end));
+
+  (void) pbuf_free(p);
+
+  /* Rate in units of 10Kbit/s, printed as Mbit/s with two decimals.*/
+  rate = (uint32_t)(((uint64_t)n * size * 8U) /
+                    ((uint64_t)LWIP_BENCH_CFG_DURATION * 10U));
+  chprintf(cfg->out, "%8u frames/s, %u.%02u Mbit/s",
+           (unsigned)(((uint64_t)n * 1000U) / LWIP_BENCH_CFG_DURATION),
+           rate / 100U, rate % 100U);
+#if LINK_STATS
+  /* Other frames, ARP for example, can be received during the test.*/
+  recv = (STAT_COUNTER)(lwip_stats.link.recv - recv);
+  chprintf(cfg->out, ", %u lost",
+           (unsigned)((STAT_COUNTER)n > recv ? (STAT_COUNTER)n - recv : 0U));
+#endif
+  chprintf(cfg->out, "\r\n");
+}
+
+#if LWIP_NETCONN && LWIP_NETIF_LOOPBACK
+/*
+ * Accepts connections and discards the received data until stopped, the
+ * stop flag is checked after each accepted connection.
+ */
+static THD_FUNCTION(churn_server, arg) {
+  struct netconn *listener = arg;
+  struct netconn *conn;
+  struct netbuf *nb;
+
+  chRegSetThreadName("churn_server");
+
+  while (!churn_stop && (netconn_accept(listener, &conn) == ERR_OK)) {
+    while (netconn_recv(conn, &nb) == ERR_OK) {
+      netbuf_delete(nb);
+    }
+    (void) netconn_close(conn);
+    (void) netconn_delete(conn);
+  }
+
+#if LWIP_NETCONN_SEM_PER_THREAD
+  LWIP_NETCONN_THREAD_SEM_FREE();
+#endif
+}
+
+/*
+ * Opens a connection, sends the specified amount of data and closes it.
+ */
+static bool churn_connect(const ip_addr_t *addr, size_t size) {
+  struct netconn *conn;
+  err_t err;
+
+  conn = netconn_new(NETCONN_TCP);
+  if (conn == NULL) {
+    return false;
+  }
+
+  err = netconn_connect(conn, addr, LWIP_BENCH_CFG_CHURN_PORT);
+  if ((err == ERR_OK) && (size > 0U)) {
+    err = netconn_write(conn, payload, size, NETCONN_NOCOPY);
+  }
+  (void) netconn_close(conn);
+  (void) netconn_delete(conn);
+
+  return err == ERR_OK;
+}
+#endif /* LWIP_NETCONN && LWIP_NETIF_LOOPBACK */
+
+/*===========================================================================*/
+/* Module exported functions.                                                */
+/*===========================================================================*/
+
+/**
+ * @brief   Loopback throughput benchmark.
+ * @details Each frame is written into the MAC by the interface output
+ *          function, looped back and received by the lwIP thread.
+ *
+ * @param[in] cfg       pointer to the configuration structure
+ */
+void lwip_bench_execute(const lwip_bench_config_t *cfg) {
+  static const size_t sizes[] = {64U, 256U, 512U, 1024U, ETH_MAX_FRAME_SIZE};
+  tprio_t prio;
+  unsigned i;
+
+  chprintf(cfg->out, "\r\n*** lwIP loopback throughput, %s mode\r\n",
+           LWIP_USE_ZERO_COPY == TRUE ? "zero-copy" : "copy");
+
+  /* The benchmark thread must run below the lwIP thread so that each looped
+     frame is consumed before the next one is sent, the priorities are casts
+     so this cannot be checked by the preprocessor.*/
+  chDbgAssert(LWIP_THREAD_PRIORITY > LOWPRIO, "lwIP thread priority too low");
+
+  memset(payload, 0x55, sizeof (payload));
+  prio = chThdSetPriority(LWIP_THREAD_PRIORITY - 1);
+  for (i = 0U; i < sizeof (sizes) / sizeof (sizes[0]); i++) {
+    bench(cfg, sizes[i]);
+  }
+  (void) chThdSetPriority(prio);
+}
+
+#if (LWIP_NETCONN && LWIP_NETIF_LOOPBACK) || defined(__DOXYGEN__)
+/**
+ * @brief   Connections churn benchmark.
+ * @details TCP connections are repeatedly opened towards a local server,
+ *          used to send @p LWIP_BENCH_CFG_CHURN_SIZE bytes and closed. The
+ *          connections rate, the payload throughput and the number of
+ *          @p sys_arch semaphores and mailboxes allocated for each
+ *          connection are printed.
+ *
+ * @param[in] cfg       pointer to the configuration structure
+ */
+void lwip_bench_churn(const lwip_bench_config_t *cfg) {
+  const ip_addr_t *addr = netif_ip_addr4(cfg->netif);
+  struct netconn *listener;
+  thread_t *tp;
+  systime_t start, end;
+  uint32_t n, failed, allocs, rate;
+
+  chprintf(cfg->out, "\r\n*** lwIP connections churn, %u bytes each\r\n",
+           (unsigned)LWIP_BENCH_CFG_CHURN_SIZE);
+
+  listener = netconn_new(NETCONN_TCP);
+  if ((listener == NULL) ||
+      (netconn_bind(listener, IP_ADDR_ANY, LWIP_BENCH_CFG_CHURN_PORT) != ERR_OK) ||
+      (netconn_listen(listener) != ERR_OK)) {
+    chprintf(cfg->out, "--- listener failed\r\n");
+    if (listener != NULL) {
+      (void) netconn_delete(listener);
+    }
+    return;
+  }
+
+  /* The server runs above the client so that the accepted connections do
+     not pile up in the listener backlog.*/
+  churn_stop = false;
+  tp = chThdCreateStatic(wa_churn_server, sizeof (wa_churn_server),
+                         chThdGetPriorityX() + 1, churn_server, listener);
+
+  memset(payload, 0x55, sizeof (payload));
+  allocs = sys_arch_stats.sem_allocs + sys_arch_stats.mbox_allocs;
+
+  /* Aligning to the next tick.*/
+  chThdSleep(1);
+  start = chVTGetSystemTime();
+  end = chTimeAddX(start, TIME_MS2I(LWIP_BENCH_CFG_DURATION));
+
+  n = 0U;
+  failed = 0U;
+  do {
+    if (churn_connect(addr, LWIP_BENCH_CFG_CHURN_SIZE)) {
+      n++;
+    }
+    else {
+      failed++;
+    }
+#if defined(SIMULATOR)
+    _sim_check_for_interrupts();
+#endif
+  } while (chVTIsSystemTimeWithinX(start, end));
+
+  allocs = sys_arch_stats.sem_allocs + sys_arch_stats.mbox_allocs - allocs;
+
+  /* Releasing the server from netconn_accept().*/
+  churn_stop = true;
+  (void) churn_connect(addr, 0U);
+  (void) chThdWait(tp);
+  (void) netconn_delete(listener);
+
+  /* Rate in units of 10Kbit/s, printed as Mbit/s with two decimals.*/
+  rate = (uint32_t)(((uint64_t)n * LWIP_BENCH_CFG_CHURN_SIZE * 8U) /
+                    ((uint64_t)LWIP_BENCH_CFG_DURATION * 10U));
+  chprintf(cfg->out, "--- Connections : %u/s, %u failed\r\n",
+           (unsigned)(((uint64_t)n * 1000U) / LWIP_BENCH_CFG_DURATION),
+           (unsigned)failed);
+  chprintf(cfg->out, "--- Throughput  : %u.%02u Mbit/s\r\n",
+           rate / 100U, rate % 100U);
+  if (n > 0U) {
+    allocs = (allocs * 100U) / n;
+    chprintf(cfg->out, "--- Allocations : %u.%02u per connection\r\n",
+             allocs / 100U, allocs % 100U);
+  }
+}
+#endif /* LWIP_NETCONN && LWIP_NETIF_LOOPBACK */
+
+/** @} */
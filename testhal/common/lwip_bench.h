@@ -0,0 +1,132 @@
+/*
+    ChibiOS - Copyright (C) 2006..2018 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+/**
+ * @file    lwip_bench.h
+ * @brief   lwIP MAC interface benchmark header.
+ * @details Frames are sent through the lwIP network interface and received
+ *          back by the lwIP thread, a loopback MAC is required, for example
+ *          the simulator MAC driver. The lwIP thread must have been started
+ *          using @p lwipInit().
+ *          The connections churn benchmark uses the netconn API towards
+ *          the interface own address, it requires @p LWIP_NETIF_LOOPBACK.
+ *
+ * @addtogroup LWIP_BENCH
+ * @{
+ */
+
+#ifndef LWIP_BENCH_H
+#define LWIP_BENCH_H
+
+#include <lwip/netif.h>
+
+/*===========================================================================*/
+/* Module constants.                                                         */
+/*===========================================================================*/
+
+/**
+ * @brief   Ethernet type of the benchmark frames.
+ * @note    This is the IEEE local experimental type, the lwIP thread
+ *          discards these frames on reception.
+ */
+#define LWIP_BENCH_ETHTYPE                  0x88B5U
+
+/*===========================================================================*/
+/* Module pre-compile time settings.                                         */
+/*===========================================================================*/
+
+/**
+ * @name    Configuration options
+ * @{
+ */
+/**
+ * @brief   Duration of each benchmark in milliseconds.
+ */
+#if !defined(LWIP_BENCH_CFG_DURATION) || defined(__DOXYGEN__)
+#define LWIP_BENCH_CFG_DURATION             1000
+#endif
+
+/**
+ * @brief   TCP port used by the connections churn benchmark.
+ */
+#if !defined(LWIP_BENCH_CFG_CHURN_PORT) || defined(__DOXYGEN__)
+#define LWIP_BENCH_CFG_CHURN_PORT           5001
+#endif
+
+/**
+ * @brief   Bytes sent over each connection by the churn benchmark.
+ */
+#if !defined(LWIP_BENCH_CFG_CHURN_SIZE) || defined(__DOXYGEN__)
+#define LWIP_BENCH_CFG_CHURN_SIZE           1024
+#endif
+
+/**
+ * @brief   Stack size of the churn benchmark server thread.
+ */
+#if !defined(LWIP_BENCH_CFG_SERVER_STACK_SIZE) || defined(__DOXYGEN__)
+#define LWIP_BENCH_CFG_SERVER_STACK_SIZE    1024
+#endif
+/** @} */
+
+/*===========================================================================*/
+/* Derived constants and error checks.                                       */
+/*===========================================================================*/
+
+#if LWIP_BENCH_CFG_CHURN_SIZE > 1500
+#error "LWIP_BENCH_CFG_CHURN_SIZE must not exceed 1500"
+#endif
+
+/*===========================================================================*/
+/* Module data structures and types.                                         */
+/*===========================================================================*/
+
+typedef struct {
+  /**
+   * @brief   Stream for output.
+   */
+  BaseSequentialStream  *out;
+  /**
+   * @brief   Network interface, it must be bound to a loopback MAC.
+   */
+  struct netif          *netif;
+} lwip_bench_config_t;
+
+/*===========================================================================*/
+/* Module macros.                                                            */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* External declarations.                                                    */
+/*===========================================================================*/
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+  void lwip_bench_execute(const lwip_bench_config_t *cfg);
+#if (LWIP_NETCONN && LWIP_NETIF_LOOPBACK) || defined(__DOXYGEN__)
+  void lwip_bench_churn(const lwip_bench_config_t *cfg);
+#endif
+#ifdef __cplusplus
+}
+#endif
+
+/*===========================================================================*/
+/* Module inline functions.                                                  */
+/*===========================================================================*/
+
+#endif /* LWIP_BENCH_H */
+
+/** @} */
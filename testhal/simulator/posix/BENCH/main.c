@@ -0,0 +1,196 @@
+/*
+    ChibiOS - Copyright (C) 2006..2018 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+#include <stdlib.h>
+
+#include "ch.h"
+#include "hal.h"
+
+#include "console.h"
+#include "jobs_bench.h"
+#include "bsio_bench.h"
+#include "buffers_bench.h"
+#include "blkqueue_bench.h"
+#include "candisp_bench.h"
+#include "bsched_bench.h"
+
+/*
+ * RAM disk size in blocks, enough for the block queue benchmark.
+ */
+#define RAMDISK_BLOCKS      (BLKQUEUE_BENCH_CFG_THREADS * BLKQUEUE_BENCH_CFG_BLOCKS)
+
+/*
+ * Simulated buses clocks.
+ */
+#define I2C_CLOCK           400000U
+#define SPI_CLOCK           8000000U
+
+/*
+ * Benchmarks configurations.
+ */
+static const jobs_bench_config_t jobs_bench_config = {
+  (BaseSequentialStream *)&CD1
+};
+
+static const SIOConfig sio_config = {
+  NULL,
+  NULL,
+  NULL,
+  NULL
+};
+
+static BufferedSIODriver BSIOD1;
+
+static const bsio_bench_config_t bsio_bench_config = {
+  (BaseSequentialStream *)&CD1,
+  &BSIOD1,
+  &sio_config
+};
+
+static const buffers_bench_config_t buffers_bench_config = {
+  (BaseSequentialStream *)&CD1
+};
+
+static RamDisk RAMD1;
+
+static uint8_t storage[RAMDISK_BLOCKS * BLKQUEUE_BENCH_CFG_BLOCK_SIZE];
+
+static const blkqueue_bench_config_t blkqueue_bench_config = {
+  (BaseSequentialStream *)&CD1,
+  (BaseBlockDevice *)&RAMD1,
+  &RAMD1
+};
+
+static const CANConfig can_config = {
+  0U
+};
+
+/*
+ * The dispatcher filters have the same layout of the simulated ones.
+ */
+static void can_set_filters(CANDriver *canp, uint32_t n,
+                            const candisp_filter_t *fp) {
+  CANFilter filters[SIM_CAN_MAX_FILTERS];
+  uint32_t i;
+
+  for (i = 0U; i < n; i++) {
+    filters[i].id   = fp[i].id;
+    filters[i].mask = fp[i].mask;
+  }
+  canSimSetFilters(canp, n, filters);
+}
+
+static const candisp_bench_config_t candisp_bench_config = {
+  (BaseSequentialStream *)&CD1,
+  &CAND1,
+  &can_config,
+  can_set_filters,
+  SIM_CAN_MAX_FILTERS
+};
+
+/*
+ * Registers files of the simulated bus devices, the I2C clients are
+ * assigned to different devices.
+ */
+static uint8_t i2c_regs[BSCHED_BENCH_CFG_CLIENTS][128];
+
+static uint8_t spi_regs[128];
+
+static const i2caddr_t i2c_addrs[BSCHED_BENCH_CFG_CLIENTS] = {
+  0x6A,
+  0x5C,
+  0x5F
+};
+
+static const I2CConfig i2c_config = {
+  I2C_CLOCK
+};
+
+static const SPIConfig spi_config = {
+  .end_cb       = NULL,
+  .clock_speed  = SPI_CLOCK
+};
+
+static const bsched_bench_config_t bsched_i2c_bench_config = {
+  (BaseSequentialStream *)&CD1,
+  BSCHED_BUS_I2C,
+  &I2CD1,
+  &i2c_config,
+  i2c_addrs,
+  &SPID1,
+  &spi_config,
+  I2C_CLOCK
+};
+
+static const bsched_bench_config_t bsched_spi_bench_config = {
+  (BaseSequentialStream *)&CD1,
+  BSCHED_BUS_SPI,
+  &I2CD1,
+  &i2c_config,
+  i2c_addrs,
+  &SPID1,
+  &spi_config,
+  SPI_CLOCK
+};
+
+/*
+ * Simulator main.
+ */
+int main(int argc, char *argv[]) {
+  unsigned i;
+
+  (void)argc;
+  (void)argv;
+
+  /*
+   * System initializations.
+   * - HAL initialization, this also initializes the configured device drivers
+   *   and performs the board-specific initializations.
+   * - Kernel initialization, the main() function becomes a thread and the
+   *   RTOS is active.
+   */
+  halInit();
+  conInit();
+  chSysInit();
+
+  /*
+   * Benchmarks, executed in sequence.
+   */
+  jobs_bench_execute(&jobs_bench_config);
+
+  bsioObjectInit(&BSIOD1, &SIOD1);
+  bsio_bench_execute(&bsio_bench_config);
+
+  buffers_bench_execute(&buffers_bench_config);
+
+  ramdiskObjectInit(&RAMD1);
+  ramdiskStart(&RAMD1, storage, BLKQUEUE_BENCH_CFG_BLOCK_SIZE,
+               RAMDISK_BLOCKS, false);
+  blkqueue_bench_execute(&blkqueue_bench_config);
+
+  canStart(&CAND1, &can_config);
+  candisp_bench_execute(&candisp_bench_config);
+  canStop(&CAND1);
+
+  for (i = 0U; i < BSCHED_BENCH_CFG_CLIENTS; i++) {
+    i2cSimAddSlave(&I2CD1, i2c_addrs[i], i2c_regs[i], sizeof (i2c_regs[i]));
+  }
+  spiSimSetSlave(&SPID1, spi_regs, sizeof (spi_regs));
+  bsched_bench_execute(&bsched_i2c_bench_config);
+  bsched_bench_execute(&bsched_spi_bench_config);
+
+  exit(0);
+}
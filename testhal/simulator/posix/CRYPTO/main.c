@@ -0,0 +1,69 @@
+/*
+    ChibiOS - Copyright (C) 2006..2018 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "ch.h"
+#include "hal.h"
+
+#include "console.h"
+#include "crypto_bench.h"
+
+/*
+ * Crypto driver, there is no simulator LLD so the driver runs in
+ * standalone mode using the software fallback.
+ */
+static CRYDriver CRYD1;
+
+/*
+ * Validation and benchmark configuration.
+ */
+static const crypto_bench_config_t bench_config = {
+  (BaseSequentialStream *)&CD1,
+  &CRYD1
+};
+
+/*
+ * Simulator main.
+ */
+int main(int argc, char *argv[]) {
+  bool ok;
+
+  /*
+   * System initializations.
+   * - HAL initialization, this also initializes the configured device drivers
+   *   and performs the board-specific initializations.
+   * - Kernel initialization, the main() function becomes a thread and the
+   *   RTOS is active.
+   */
+  halInit();
+  conInit();
+  chSysInit();
+
+  /* Starting Crypto driver.*/
+  cryObjectInit(&CRYD1);
+  cryStart(&CRYD1, NULL);
+
+  /* Known answers validation, the throughput report is only produced
+     on request.*/
+  if ((argc > 1) && (strcmp(argv[1], "bench") == 0)) {
+    crypto_bench_execute(&bench_config);
+  }
+  ok = crypto_bench_validate(&bench_config);
+
+  exit(ok ? 0 : 1);
+}
@@ -0,0 +1,97 @@
+/*
+    ChibiOS - Copyright (C) 2006..2018 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "ch.h"
+#include "hal.h"
+
+#include "console.h"
+#include "memstreams.h"
+#include "dlog_bench.h"
+
+/*
+ * Validation and benchmark configuration.
+ */
+static const dlog_bench_config_t bench_config = {
+  (BaseSequentialStream *)&CD1
+};
+
+/*
+ * Buffers for the exported records.
+ */
+static uint8_t bin_buffer[4096];
+static uint8_t txt_buffer[4096];
+
+/*
+ * Writes a memory stream content into a host file.
+ */
+static bool write_file(const char *name, const MemoryStream *msp) {
+  FILE *f;
+  bool ok;
+
+  f = fopen(name, "wb");
+  if (f == NULL) {
+    return false;
+  }
+  ok = fwrite(msp->buffer, 1, msp->eos, f) == msp->eos;
+  fclose(f);
+
+  return ok;
+}
+
+/*
+ * Simulator main.
+ */
+int main(int argc, char *argv[]) {
+  bool ok;
+
+  /*
+   * System initializations.
+   * - HAL initialization, this also initializes the configured device drivers
+   *   and performs the board-specific initializations.
+   * - Kernel initialization, the main() function becomes a thread and the
+   *   RTOS is active.
+   */
+  halInit();
+  conInit();
+  chSysInit();
+
+  if ((argc > 1) && (strcmp(argv[1], "bench") == 0)) {
+    /* Validation and benchmark.*/
+    dlog_bench_execute(&bench_config);
+    ok = true;
+  }
+  else if ((argc > 3) && (strcmp(argv[1], "export") == 0)) {
+    /* Known records exported in binary form and formatted, for
+       comparison with the host decoder output.*/
+    MemoryStream bin, txt;
+
+    msObjectInit(&bin, bin_buffer, sizeof (bin_buffer), 0U);
+    msObjectInit(&txt, txt_buffer, sizeof (txt_buffer), 0U);
+    dlog_bench_export((BaseSequentialStream *)&bin,
+                      (BaseSequentialStream *)&txt);
+    ok = write_file(argv[2], &bin) && write_file(argv[3], &txt);
+  }
+  else {
+    /* Validation only.*/
+    ok = dlog_bench_validate(&bench_config);
+  }
+
+  exit(ok ? 0 : 1);
+}
@@ -0,0 +1,85 @@
+/*
+    ChibiOS - Copyright (C) 2006..2018 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+#include <stdlib.h>
+
+#include "ch.h"
+#include "hal.h"
+
+#include "console.h"
+#include "ramdisk.h"
+#include "ff.h"
+#include "fatfs_bench.h"
+#include "chprintf.h"
+
+/*
+ * RAM disk size in sectors and cluster size in bytes.
+ */
+#define RAMDISK_SECTORS     8192U
+#define CLUSTER_SIZE        4096U
+
+/*
+ * RAM disk accessed by the FatFS bindings.
+ */
+RamDisk RAMD1;
+
+static uint8_t storage[RAMDISK_SECTORS * 512U];
+static uint8_t work[FF_MAX_SS];
+static FATFS fs;
+
+/*
+ * Benchmark configuration.
+ */
+static const fatfs_bench_config_t fatfs_bench_config = {
+  (BaseSequentialStream *)&CD1,
+  "/bench.bin",
+  &RAMD1
+};
+
+/*
+ * Simulator main.
+ */
+int main(int argc, char *argv[]) {
+
+  (void)argc;
+  (void)argv;
+
+  /*
+   * System initializations.
+   * - HAL initialization, this also initializes the configured device drivers
+   *   and performs the board-specific initializations.
+   * - Kernel initialization, the main() function becomes a thread and the
+   *   RTOS is active.
+   */
+  halInit();
+  conInit();
+  chSysInit();
+
+  /*
+   * Formatting and mounting the RAM disk.
+   */
+  ramdiskObjectInit(&RAMD1);
+  ramdiskStart(&RAMD1, storage, 512U, RAMDISK_SECTORS, false);
+  if ((f_mkfs("", FM_FAT | FM_SFD, CLUSTER_SIZE, work, sizeof (work)) != FR_OK) ||
+      (f_mount(&fs, "", 1) != FR_OK)) {
+    chprintf((BaseSequentialStream *)&CD1, "RAM disk mount failed\r\n");
+    exit(1);
+  }
+
+  fatfs_bench_execute(&fatfs_bench_config);
+
+  exit(0);
+}
@@ -0,0 +1,86 @@
+/*
+ * Copyright (c) 2001-2003 Swedish Institute of Computer Science.
+ * All rights reserved. 
+ * 
+ * Redistribution and use in source and binary forms, with or without modification, 
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ * 3. The name of the author may not be used to endorse or promote products
+ *    derived from this software without specific prior written permission. 
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR IMPLIED 
+ * WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF 
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT 
+ * SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, 
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT 
+ * OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS 
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN 
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING 
+ * IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY 
+ * OF SUCH DAMAGE.
+ *
+ * This file is part of the lwIP TCP/IP stack.
+ * 
+ * Author: Simon Goldschmidt
+ *
+ */
+
+#ifndef LWIP_HDR_LWIPOPTS_H__
+#define LWIP_HDR_LWIPOPTS_H__
+
+/* Fixed settings mandated by the ChibiOS integration.*/
+#include "static_lwipopts.h"
+
+/* Optional, application-specific settings.*/
+#if !defined(TCPIP_MBOX_SIZE)
+#define TCPIP_MBOX_SIZE                 MEMP_NUM_PBUF
+#endif
+#if !defined(TCPIP_THREAD_STACKSIZE)
+#define TCPIP_THREAD_STACKSIZE          4096
+#endif
+
+/* The benchmarks run below the lwIP threads.*/
+#if !defined(TCPIP_THREAD_PRIO)
+#define TCPIP_THREAD_PRIO               (NORMALPRIO + 2)
+#endif
+#if !defined(LWIP_THREAD_PRIORITY)
+#define LWIP_THREAD_PRIORITY            (NORMALPRIO + 1)
+#endif
+#if !defined(LWIP_THREAD_STACK_SIZE)
+#define LWIP_THREAD_STACK_SIZE          4096
+#endif
+
+/* The host headers already provide the byte order functions.*/
+#define LWIP_DONT_PROVIDE_BYTEORDER_FUNCTIONS
+
+/* The BSD sockets API clashes with the host headers and it is not used.*/
+#define LWIP_SOCKET                     0
+
+/* Required by the zero-copy mode.*/
+#define LWIP_SUPPORT_CUSTOM_PBUF        1
+
+/* Connections to the interface own address are looped back.*/
+#define LWIP_NETIF_LOOPBACK             1
+#define LWIP_HAVE_LOOPIF                0
+
+/* Statistics used by the benchmark.*/
+#define LWIP_STATS                      1
+#define LINK_STATS                      1
+#define LWIP_STATS_DISPLAY              0
+#define LWIP_STATS_LARGE                1
+
+/* Sized for the connections churn benchmark.*/
+#define MEM_SIZE                        32768
+#define MEMP_NUM_PBUF                   32
+#define MEMP_NUM_TCP_PCB                16
+#define MEMP_NUM_NETCONN                8
+#define PBUF_POOL_SIZE                  32
+#define DEFAULT_ACCEPTMBOX_SIZE         4
+#define DEFAULT_TCP_RECVMBOX_SIZE       8
+
+#endif /* LWIP_HDR_LWIPOPTS_H__ */
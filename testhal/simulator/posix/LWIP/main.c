@@ -0,0 +1,67 @@
+/*
+    ChibiOS - Copyright (C) 2006..2018 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+#include <stdlib.h>
+
+#include "ch.h"
+#include "hal.h"
+
+#include "console.h"
+#include "lwipthread.h"
+#include "lwip_bench.h"
+
+/*
+ * Benchmark configuration, the lwIP thread sets the simulated MAC
+ * interface as the default one.
+ */
+static lwip_bench_config_t lwip_bench_config = {
+  (BaseSequentialStream *)&CD1,
+  NULL
+};
+
+/*
+ * Simulator main.
+ */
+int main(int argc, char *argv[]) {
+
+  (void)argc;
+  (void)argv;
+
+  /*
+   * System initializations.
+   * - HAL initialization, this also initializes the configured device drivers
+   *   and performs the board-specific initializations.
+   * - Kernel initialization, the main() function becomes a thread and the
+   *   RTOS is active.
+   */
+  halInit();
+  conInit();
+  chSysInit();
+
+  /*
+   * lwIP initialization with the default static address, the function
+   * returns when the interface has been added.
+   */
+  lwipInit(NULL);
+  lwip_bench_config.netif = netif_default;
+
+  lwip_bench_execute(&lwip_bench_config);
+#if LWIP_NETCONN && LWIP_NETIF_LOOPBACK
+  lwip_bench_churn(&lwip_bench_config);
+#endif
+
+  exit(0);
+}
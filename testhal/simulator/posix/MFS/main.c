@@ -0,0 +1,87 @@
+/*
+    ChibiOS - Copyright (C) 2006..2018 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+#include <stdlib.h>
+
+#include "ch.h"
+#include "hal.h"
+
+#include "console.h"
+#include "hal_mfs.h"
+#include "ram_flash.h"
+
+#include "mfs_test_root.h"
+
+/*
+ * Emulated flash geometry, two banks of two sectors and a checkpoints
+ * area of two sectors.
+ */
+#define SECTORS_SIZE        2048U
+#define SECTORS_COUNT       6U
+
+static uint8_t flash_buffer[SECTORS_SIZE * SECTORS_COUNT];
+
+static const RamFlashConfig rflcfg1 = {
+  flash_buffer,
+  SECTORS_SIZE,
+  SECTORS_COUNT
+};
+
+static RamFlashDriver RFL1;
+
+const MFSConfig mfscfg1 = {
+  .flashp             = (BaseFlash *)&RFL1,
+  .erased             = 0xFFFFFFFFU,
+  .bank_size          = 4096U,
+  .bank0_start        = 0U,
+  .bank0_sectors      = 2U,
+  .bank1_start        = 2U,
+  .bank1_sectors      = 2U,
+#if MFS_CFG_USE_CHECKPOINTS == TRUE
+  .checkpoint_start   = 4U,
+  .checkpoint_sectors = 2U
+#endif
+};
+
+/*
+ * Simulator main.
+ */
+int main(int argc, char *argv[]) {
+  msg_t result;
+
+  (void)argc;
+  (void)argv;
+
+  /*
+   * System initializations.
+   * - HAL initialization, this also initializes the configured device drivers
+   *   and performs the board-specific initializations.
+   * - Kernel initialization, the main() function becomes a thread and the
+   *   RTOS is active.
+   */
+  halInit();
+  conInit();
+  chSysInit();
+
+  /* Starting the RAM flash, initially erased.*/
+  rflObjectInit(&RFL1);
+  rflStart(&RFL1, &rflcfg1);
+  flashStartEraseAll(&RFL1);
+
+  result = test_execute((BaseSequentialStream *)&CD1, &mfs_test_suite);
+
+  exit(result == MSG_OK ? 0 : 1);
+}
@@ -0,0 +1,58 @@
+/*
+    ChibiOS - Copyright (C) 2006..2018 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+#include <stdlib.h>
+
+#include "ch.h"
+#include "hal.h"
+
+#include "console.h"
+#include "nasa_osal_test_root.h"
+#include "osapi.h"
+#include "cfe_osal_bench.h"
+
+/*
+ * Benchmark configuration.
+ */
+static const cfe_osal_bench_config_t cfe_osal_bench_config = {
+  (BaseSequentialStream *)&CD1
+};
+
+/*
+ * Simulator main.
+ */
+int main(int argc, char *argv[]) {
+  msg_t result;
+
+  (void)argc;
+  (void)argv;
+
+  /*
+   * System initializations.
+   * - HAL initialization, this also initializes the configured device drivers
+   *   and performs the board-specific initializations.
+   * - OSAL initialization, this also initializes the kernel, the main()
+   *   function becomes a thread and the RTOS is active.
+   */
+  halInit();
+  conInit();
+  (void) OS_API_Init();
+
+  result = test_execute((BaseSequentialStream *)&CD1, &nasa_osal_test_suite);
+  cfe_osal_bench_execute(&cfe_osal_bench_config);
+
+  exit(result == (msg_t)0 ? 0 : 1);
+}
@@ -0,0 +1,177 @@
+/*
+    This file has been generated from an objects description, do not edit.
+*/
+
+/**
+ * @file    chobjects.c
+ * @brief   Static kernel objects code.
+ *
+ * @addtogroup static_objects
+ * @details All the kernel objects described in the objects description
+ *          file and their buffers are allocated statically in a single
+ *          structure, the heap is never used.<br>
+ *          Objects can be accessed directly as fields of @p ch_objects,
+ *          by identifier in constant time using @p chObjectsGetX() or by
+ *          name using @p chObjectsFind(). The names index is an hash
+ *          table computed by the generator, a lookup requires hashing
+ *          the name and, usually, a single string comparison.
+ * @{
+ */
+
+#include <string.h>
+
+#include "chobjects.h"
+
+/*===========================================================================*/
+/* Module local definitions.                                                 */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Module exported variables.                                                */
+/*===========================================================================*/
+
+/**
+ * @brief   Static objects.
+ */
+ch_objects_t ch_objects;
+
+/**
+ * @brief   Static objects index, ordered by identifier.
+ */
+const ch_object_t ch_objects_index[CH_OBJECTS_NUM] = {
+  {"reader", 19651U, CH_OBJECT_THREAD, (void *)&ch_objects.reader},
+  {"writer", 39027U, CH_OBJECT_THREAD, (void *)&ch_objects.writer},
+  {"sem_ready", 6303U, CH_OBJECT_SEMAPHORE, (void *)&ch_objects.sem_ready},
+  {"bsem_done", 12072U, CH_OBJECT_BINARY_SEMAPHORE, (void *)&ch_objects.bsem_done},
+  {"mtx_bus", 41170U, CH_OBJECT_MUTEX, (void *)&ch_objects.mtx_bus},
+  {"evt_tick", 9849U, CH_OBJECT_EVENT_SOURCE, (void *)&ch_objects.evt_tick},
+  {"mb_cmd", 57232U, CH_OBJECT_MAILBOX, (void *)&ch_objects.mb_cmd},
+  {"pool_msg", 61662U, CH_OBJECT_MEMORY_POOL, (void *)&ch_objects.pool_msg},
+  {"pool_req", 507U, CH_OBJECT_GUARDED_MEMORY_POOL, (void *)&ch_objects.pool_req},
+  {"fifo_pkt", 32742U, CH_OBJECT_OBJECTS_FIFO, (void *)&ch_objects.fifo_pkt},
+  {"pipe_log", 48435U, CH_OBJECT_PIPE, (void *)&ch_objects.pipe_log}
+};
+
+/*===========================================================================*/
+/* Module local types.                                                       */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Module local variables.                                                   */
+/*===========================================================================*/
+
+/**
+ * @brief   Names index, positions in @p ch_objects_index plus one.
+ */
+static const uint16_t ch_objects_names[CH_OBJECTS_INDEX_SIZE] = {
+  0U, 0U, 0U, 1U, 0U, 0U, 10U, 0U,
+  4U, 0U, 0U, 0U, 0U, 0U, 0U, 0U,
+  7U, 0U, 5U, 2U, 11U, 0U, 0U, 0U,
+  0U, 6U, 0U, 9U, 0U, 0U, 8U, 3U
+};
+
+/*
+ * Threads functions, defined by the application.
+ */
+THD_FUNCTION(reader_thread, arg);
+THD_FUNCTION(writer_thread, arg);
+
+/**
+ * @brief   Threads descriptors.
+ */
+static const thread_descriptor_t ch_objects_threads[2] = {
+  {
+    "reader",
+    THD_WORKING_AREA_BASE(ch_objects.reader_wa),
+    THD_WORKING_AREA_END(ch_objects.reader_wa),
+    NORMALPRIO + 1,
+    reader_thread,
+    NULL
+  },
+  {
+    "writer",
+    THD_WORKING_AREA_BASE(ch_objects.writer_wa),
+    THD_WORKING_AREA_END(ch_objects.writer_wa),
+    NORMALPRIO,
+    writer_thread,
+    NULL
+  }
+};
+
+/*===========================================================================*/
+/* Module local functions.                                                   */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Module exported functions.                                                */
+/*===========================================================================*/
+
+/**
+ * @brief   Initializes the static objects and starts the static threads.
+ * @details Threads are started last, in declaration order, when all the
+ *          other objects are already initialized.
+ *
+ * @init
+ */
+void chObjectsInit(void) {
+
+  chSemObjectInit(&ch_objects.sem_ready, (cnt_t)0);
+  chBSemObjectInit(&ch_objects.bsem_done, true);
+  chMtxObjectInit(&ch_objects.mtx_bus);
+  chEvtObjectInit(&ch_objects.evt_tick);
+  chMBObjectInit(&ch_objects.mb_cmd, ch_objects.mb_cmd_buf,
+                 (size_t)8);
+  chPoolObjectInit(&ch_objects.pool_msg,
+                   MEM_ALIGN_NEXT(32, PORT_NATURAL_ALIGN), NULL);
+  chPoolLoadArray(&ch_objects.pool_msg,
+                  (void *)ch_objects.pool_msg_buf, (size_t)16);
+  chGuardedPoolObjectInit(&ch_objects.pool_req,
+                          MEM_ALIGN_NEXT(sizeof (uint32_t), PORT_NATURAL_ALIGN));
+  chGuardedPoolLoadArray(&ch_objects.pool_req,
+                         (void *)ch_objects.pool_req_buf, (size_t)4);
+  chFifoObjectInit(&ch_objects.fifo_pkt,
+                   MEM_ALIGN_NEXT(64, PORT_NATURAL_ALIGN),
+                   (size_t)4, (void *)ch_objects.fifo_pkt_buf,
+                   ch_objects.fifo_pkt_msgbuf);
+  chPipeObjectInit(&ch_objects.pipe_log, ch_objects.pipe_log_buf,
+                   (size_t)128);
+  ch_objects.reader = chThdCreate(&ch_objects_threads[0]);
+  ch_objects.writer = chThdCreate(&ch_objects_threads[1]);
+}
+
+/**
+ * @brief   Finds a static object by name.
+ *
+ * @param[in] name      name of the object
+ * @return              Pointer to the object index entry.
+ * @retval NULL         if an object with the specified name does not exist.
+ *
+ * @api
+ */
+const ch_object_t *chObjectsFind(const char *name) {
+  const ch_object_t *op;
+  const char *p;
+  uint32_t h, i;
+
+  chDbgCheck(name != NULL);
+
+  /* Same hash computed by the generator.*/
+  h = 0U;
+  for (p = name; *p != '\0'; p++) {
+    h = ((h * 31U) + ((uint32_t)(uint8_t)*p - 32U)) & 0xFFFFU;
+  }
+
+  /* Linear probing, the index always contains at least one free slot.*/
+  i = h & (CH_OBJECTS_INDEX_SIZE - 1U);
+  while (ch_objects_names[i] != 0U) {
+    op = &ch_objects_index[ch_objects_names[i] - 1U];
+    if (((uint32_t)op->hash == h) && (strcmp(op->name, name) == 0)) {
+      return op;
+    }
+    i = (i + 1U) & (CH_OBJECTS_INDEX_SIZE - 1U);
+  }
+
+  return NULL;
+}
+
+/** @} */
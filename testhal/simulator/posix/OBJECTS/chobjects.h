@@ -0,0 +1,174 @@
+/*
+    This file has been generated from an objects description, do not edit.
+*/
+
+/**
+ * @file    chobjects.h
+ * @brief   Static kernel objects header.
+ *
+ * @addtogroup static_objects
+ * @{
+ */
+
+#ifndef CHOBJECTS_H
+#define CHOBJECTS_H
+
+#include "ch.h"
+
+/*===========================================================================*/
+/* Module constants.                                                         */
+/*===========================================================================*/
+
+/**
+ * @brief   Number of static objects.
+ */
+#define CH_OBJECTS_NUM                      11U
+
+/**
+ * @brief   Size of the names index, a power of two.
+ */
+#define CH_OBJECTS_INDEX_SIZE               32U
+
+/**
+ * @name    Objects identifiers
+ * @{
+ */
+#define CH_OBJ_ID_READER                    0U
+#define CH_OBJ_ID_WRITER                    1U
+#define CH_OBJ_ID_SEM_READY                 2U
+#define CH_OBJ_ID_BSEM_DONE                 3U
+#define CH_OBJ_ID_MTX_BUS                   4U
+#define CH_OBJ_ID_EVT_TICK                  5U
+#define CH_OBJ_ID_MB_CMD                    6U
+#define CH_OBJ_ID_POOL_MSG                  7U
+#define CH_OBJ_ID_POOL_REQ                  8U
+#define CH_OBJ_ID_FIFO_PKT                  9U
+#define CH_OBJ_ID_PIPE_LOG                  10U
+/** @} */
+
+/*===========================================================================*/
+/* Module pre-compile time settings.                                         */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Derived constants and error checks.                                       */
+/*===========================================================================*/
+
+/**
+ * @brief   Size, in @p stkalign_t units, of a buffer of objects.
+ * @details Each object is rounded up to @p PORT_NATURAL_ALIGN.
+ *
+ * @param[in] size      size of an object
+ * @param[in] n         number of objects
+ */
+#define CH_OBJECTS_BUF_SIZE(size, n)                                        \
+  (((MEM_ALIGN_NEXT((size), PORT_NATURAL_ALIGN) * (n)) +                    \
+    sizeof (stkalign_t) - 1U) / sizeof (stkalign_t))
+
+/*===========================================================================*/
+/* Module data structures and types.                                         */
+/*===========================================================================*/
+
+/**
+ * @brief   Type of a static object type.
+ */
+typedef enum {
+  CH_OBJECT_THREAD = 0,
+  CH_OBJECT_SEMAPHORE = 1,
+  CH_OBJECT_BINARY_SEMAPHORE = 2,
+  CH_OBJECT_MUTEX = 3,
+  CH_OBJECT_EVENT_SOURCE = 4,
+  CH_OBJECT_MAILBOX = 5,
+  CH_OBJECT_MEMORY_POOL = 6,
+  CH_OBJECT_GUARDED_MEMORY_POOL = 7,
+  CH_OBJECT_OBJECTS_FIFO = 8,
+  CH_OBJECT_PIPE = 9
+} ch_object_type_t;
+
+/**
+ * @brief   Type of a static object index entry.
+ */
+typedef struct {
+  /**
+   * @brief   Object name.
+   */
+  const char            *name;
+  /**
+   * @brief   Hash of the object name.
+   */
+  uint16_t              hash;
+  /**
+   * @brief   Object type.
+   */
+  ch_object_type_t      type;
+  /**
+   * @brief   Pointer to the object, for threads it is a pointer to the
+   *          @p thread_t pointer.
+   */
+  void                  *objp;
+} ch_object_t;
+
+/**
+ * @brief   Type of the static objects structure.
+ * @details Control blocks are grouped at the beginning of the structure,
+ *          buffers follow and threads working areas are placed last.
+ */
+typedef struct {
+  thread_t              *reader;
+  thread_t              *writer;
+  semaphore_t           sem_ready;
+  binary_semaphore_t    bsem_done;
+  mutex_t               mtx_bus;
+  event_source_t        evt_tick;
+  mailbox_t             mb_cmd;
+  memory_pool_t         pool_msg;
+  guarded_memory_pool_t pool_req;
+  objects_fifo_t        fifo_pkt;
+  pipe_t                pipe_log;
+  msg_t                 mb_cmd_buf[8];
+  stkalign_t            pool_msg_buf[CH_OBJECTS_BUF_SIZE(32, 16)];
+  stkalign_t            pool_req_buf[CH_OBJECTS_BUF_SIZE(sizeof (uint32_t), 4)];
+  stkalign_t            fifo_pkt_buf[CH_OBJECTS_BUF_SIZE(64, 4)];
+  msg_t                 fifo_pkt_msgbuf[4];
+  uint8_t               pipe_log_buf[128];
+  stkalign_t            reader_wa[THD_WORKING_AREA_SIZE(256) / sizeof (stkalign_t)];
+  stkalign_t            writer_wa[THD_WORKING_AREA_SIZE(256) / sizeof (stkalign_t)];
+} ch_objects_t;
+
+/*===========================================================================*/
+/* Module macros.                                                            */
+/*===========================================================================*/
+
+/**
+ * @brief   Returns a static object by identifier.
+ *
+ * @param[in] id        the object identifier, a @p CH_OBJ_ID_xxx constant
+ * @return              Pointer to the object index entry.
+ *
+ * @xclass
+ */
+#define chObjectsGetX(id) (&ch_objects_index[(id)])
+
+/*===========================================================================*/
+/* External declarations.                                                    */
+/*===========================================================================*/
+
+extern ch_objects_t ch_objects;
+extern const ch_object_t ch_objects_index[CH_OBJECTS_NUM];
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+  void chObjectsInit(void);
+  const ch_object_t *chObjectsFind(const char *name);
+#ifdef __cplusplus
+}
+#endif
+
+/*===========================================================================*/
+/* Module inline functions.                                                  */
+/*===========================================================================*/
+
+#endif /* CHOBJECTS_H */
+
+/** @} */
@@ -0,0 +1,193 @@
+/*
+    ChibiOS - Copyright (C) 2006..2018 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "ch.h"
+#include "hal.h"
+
+#include "chprintf.h"
+#include "console.h"
+#include "chobjects.h"
+
+/*
+ * Number of messages exchanged by the writer and reader threads.
+ */
+#define ITERATIONS          32U
+
+static BaseSequentialStream *chp = (BaseSequentialStream *)&CD1;
+static bool ok = true;
+static uint32_t total;
+
+/*
+ * Reports a check result.
+ */
+static void check(bool cond, const char *what) {
+
+  chprintf(chp, "%s: %s\r\n", cond ? "ok" : "FAILED", what);
+  ok = ok && cond;
+}
+
+/*
+ * Writer thread, started by chObjectsInit(). Posts messages allocated from
+ * the pool after the main thread signals the ready semaphore.
+ */
+THD_FUNCTION(writer_thread, arg) {
+  uint32_t i, *p;
+
+  (void)arg;
+
+  (void) chSemWait(&ch_objects.sem_ready);
+  for (i = 1U; i <= ITERATIONS; i++) {
+    p = chPoolAlloc(&ch_objects.pool_msg);
+    if (p == NULL) {
+      break;
+    }
+    *p = i;
+    (void) chMBPostTimeout(&ch_objects.mb_cmd, (msg_t)p, TIME_INFINITE);
+  }
+}
+
+/*
+ * Reader thread, started by chObjectsInit(). Accumulates the messages,
+ * logs them in the pipe and signals the completion.
+ */
+THD_FUNCTION(reader_thread, arg) {
+  uint32_t i, *p;
+  msg_t msg;
+  uint8_t c;
+
+  (void)arg;
+
+  for (i = 1U; i <= ITERATIONS; i++) {
+    (void) chMBFetchTimeout(&ch_objects.mb_cmd, &msg, TIME_INFINITE);
+    p = (uint32_t *)msg;
+    chMtxLock(&ch_objects.mtx_bus);
+    total += *p;
+    chMtxUnlock(&ch_objects.mtx_bus);
+    chPoolFree(&ch_objects.pool_msg, p);
+    c = (uint8_t)*p;
+    (void) chPipeWriteTimeout(&ch_objects.pipe_log, &c, 1U, TIME_INFINITE);
+    chEvtBroadcast(&ch_objects.evt_tick);
+  }
+  chBSemSignal(&ch_objects.bsem_done);
+}
+
+/*
+ * Simulator main.
+ */
+int main(void) {
+  static const char *names[CH_OBJECTS_NUM] = {
+    "reader", "writer", "sem_ready", "bsem_done", "mtx_bus", "evt_tick",
+    "mb_cmd", "pool_msg", "pool_req", "fifo_pkt", "pipe_log"
+  };
+  const ch_object_t *op;
+  event_listener_t el;
+  uint8_t buf[CH_OBJECTS_NUM * 16U];
+  void *objs[5];
+  unsigned i;
+  bool found;
+
+  /*
+   * System initializations.
+   * - HAL initialization, this also initializes the configured device drivers
+   *   and performs the board-specific initializations.
+   * - Kernel initialization, the main() function becomes a thread and the
+   *   RTOS is active.
+   */
+  halInit();
+  conInit();
+  chSysInit();
+
+  /*
+   * Static objects initialization, the threads are started.
+   */
+  chObjectsInit();
+
+  /*
+   * Lookups by identifier and by name.
+   */
+  found = true;
+  for (i = 0U; i < CH_OBJECTS_NUM; i++) {
+    op = chObjectsFind(names[i]);
+    found = found && (op == chObjectsGetX(i)) &&
+            (strcmp(op->name, names[i]) == 0);
+  }
+  check(found, "objects found by name");
+  check((chObjectsFind("") == NULL) && (chObjectsFind("read") == NULL) &&
+        (chObjectsFind("readers") == NULL) &&
+        (chObjectsFind("pool_log") == NULL), "unknown names not found");
+  op = chObjectsGetX(CH_OBJ_ID_READER);
+  check((op->type == CH_OBJECT_THREAD) &&
+        (*(thread_t **)op->objp == ch_objects.reader) &&
+        (ch_objects.reader != NULL), "thread entry");
+  op = chObjectsGetX(CH_OBJ_ID_POOL_REQ);
+  check((op->type == CH_OBJECT_GUARDED_MEMORY_POOL) &&
+        (op->objp == (void *)&ch_objects.pool_req), "guarded pool entry");
+  check((chRegGetThreadNameX(ch_objects.writer) != NULL) &&
+        (strcmp(chRegGetThreadNameX(ch_objects.writer), "writer") == 0) &&
+        (ch_objects.reader->prio == NORMALPRIO + 1),
+        "threads descriptors");
+
+  /*
+   * Workload, the main thread releases the writer then waits for the reader
+   * to complete.
+   */
+  chEvtRegister(&ch_objects.evt_tick, &el, 0);
+  chSemSignal(&ch_objects.sem_ready);
+  check(chBSemWaitTimeout(&ch_objects.bsem_done, TIME_MS2I(1000)) == MSG_OK,
+        "completion signaled");
+  check(total == (ITERATIONS * (ITERATIONS + 1U)) / 2U, "messages exchanged");
+  check(chEvtGetAndClearEvents(ALL_EVENTS) == EVENT_MASK(0), "events broadcast");
+  check(chPipeReadTimeout(&ch_objects.pipe_log, buf, sizeof (buf),
+                          TIME_IMMEDIATE) == ITERATIONS, "pipe written");
+  check((chThdWait(ch_objects.reader) == MSG_OK) &&
+        (chThdWait(ch_objects.writer) == MSG_OK), "threads terminated");
+  chEvtUnregister(&ch_objects.evt_tick, &el);
+
+  /*
+   * Guarded pool and objects FIFO capacities.
+   */
+  for (i = 0U; i < 5U; i++) {
+    objs[i] = chGuardedPoolAllocTimeout(&ch_objects.pool_req, TIME_IMMEDIATE);
+  }
+  check((objs[3] != NULL) && (objs[4] == NULL), "guarded pool capacity");
+  for (i = 0U; i < 4U; i++) {
+    chGuardedPoolFree(&ch_objects.pool_req, objs[i]);
+  }
+  for (i = 0U; i < 5U; i++) {
+    objs[i] = chFifoTakeObjectTimeout(&ch_objects.fifo_pkt, TIME_IMMEDIATE);
+  }
+  check((objs[3] != NULL) && (objs[4] == NULL), "objects FIFO capacity");
+  for (i = 0U; i < 4U; i++) {
+    chFifoSendObject(&ch_objects.fifo_pkt, objs[i]);
+  }
+  found = true;
+  for (i = 0U; i < 4U; i++) {
+    void *objp;
+
+    found = found &&
+            (chFifoReceiveObjectTimeout(&ch_objects.fifo_pkt, &objp,
+                                        TIME_IMMEDIATE) == MSG_OK) &&
+            (objp == objs[i]);
+  }
+  check(found, "objects FIFO order");
+
+  chprintf(chp, "Final result: %s\r\n", ok ? "SUCCESS" : "FAILURE");
+
+  exit(ok ? 0 : 1);
+}
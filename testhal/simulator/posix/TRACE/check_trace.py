@@ -0,0 +1,88 @@
+#!/usr/bin/env python3
+#
+#    ChibiOS - Copyright (C) 2006..2018 Giovanni Di Sirio
+#
+#    Licensed under the Apache License, Version 2.0 (the "License");
+#    you may not use this file except in compliance with the License.
+#    You may obtain a copy of the License at
+#
+#        http://www.apache.org/licenses/LICENSE-2.0
+#
+#    Unless required by applicable law or agreed to in writing, software
+#    distributed under the License is distributed on an "AS IS" BASIS,
+#    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+#    See the License for the specific language governing permissions and
+#    limitations under the License.
+#
+
+"""Checks the trace stream produced by the TRACE simulator demo.
+
+The stream is converted using trace2json.py then the JSON output is
+checked against the demo workload.
+
+Usage: check_trace.py input.bin output.json
+"""
+
+import json
+import os
+import subprocess
+import sys
+
+ITERATIONS = 32
+USER_MARKER = "0x55"
+
+TRACE2JSON = os.path.join(os.path.dirname(os.path.abspath(__file__)),
+                          "..", "..", "..", "..", "os", "various",
+                          "trace_stream", "trace2json.py")
+
+
+def check(cond, what):
+    if not cond:
+        sys.exit("FAILED: %s" % what)
+    print("ok: %s" % what)
+
+
+def main():
+    if len(sys.argv) != 3:
+        sys.exit(__doc__.splitlines()[-1])
+
+    subprocess.run([sys.executable, TRACE2JSON, "-o", sys.argv[2],
+                    sys.argv[1]], check=True)
+    with open(sys.argv[2]) as f:
+        events = json.load(f)["traceEvents"]
+
+    names = {ev["args"]["name"].split(" ")[0]
+             for ev in events if ev["ph"] == "M"}
+    check({"main", "idle", "trace"} <= names, "registered threads defined")
+    check({"producer", "consumer"} <= names, "workload threads defined")
+
+    def count(name):
+        return sum(1 for ev in events if ev["name"] == name)
+
+    check(count("overflow") == 0, "no records lost")
+    check(count("running") > 0, "context switches")
+    check(count("mbx post") >= ITERATIONS, "mailbox posts")
+    check(count("mbx fetch") >= ITERATIONS, "mailbox fetches")
+    check(count("mtx lock") >= ITERATIONS, "mutex locks")
+    check(count("mtx unlock") >= ITERATIONS, "mutex unlocks")
+    check(count("sem signal") >= ITERATIONS, "semaphore signals")
+    check(count("sem wait") >= ITERATIONS, "semaphore waits")
+    check(sum(1 for ev in events if ev["name"].startswith("vt ")) >=
+          ITERATIONS, "virtual timers")
+
+    isrs = [ev for ev in events if ev["ph"] in ("B", "E")]
+    check(len(isrs) > 0 and
+          all(not ev["name"].startswith("0x") for ev in isrs),
+          "ISRs with names")
+
+    users = [int(ev["args"]["up2"], 16) for ev in events
+             if ev["name"] == "user" and ev["args"]["up1"] == USER_MARKER]
+    check(users == list(range(1, ITERATIONS + 1)), "user records in order")
+
+    # Running slices are emitted when they end.
+    stamps = [ev["ts"] + ev.get("dur", 0) for ev in events if ev["ph"] != "M"]
+    check(stamps == sorted(stamps), "monotonic time stamps")
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,183 @@
+/*
+    ChibiOS - Copyright (C) 2006..2018 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "ch.h"
+#include "hal.h"
+
+#include "chprintf.h"
+#include "console.h"
+#include "memstreams.h"
+#include "trace_stream.h"
+
+/*
+ * Number of messages exchanged by the producer and consumer threads.
+ */
+#define ITERATIONS          32U
+
+/*
+ * Marker written in the user trace records, checked by check_trace.py.
+ */
+#define USER_MARKER         0x55U
+
+/*
+ * The trace stream is collected in memory and written to a host file at
+ * the end of the run.
+ */
+static uint8_t stream_buffer[65536];
+static MemoryStream ms;
+
+static const TraceStreamConfig tscfg = {
+  (BaseSequentialStream *)&ms,
+#if PORT_SUPPORTS_RT == TRUE
+  /* The simulator realtime counter counts nanoseconds.*/
+  1000000000U,
+#else
+  0U,
+#endif
+  TIME_MS2I(1)
+};
+
+static THD_WORKING_AREA(waTrace, TRACE_STREAM_WA_SIZE);
+
+static msg_t mb_buffer[4];
+static MAILBOX_DECL(mb1, mb_buffer, 4);
+static MUTEX_DECL(mtx1);
+static SEMAPHORE_DECL(sem1, 0);
+static virtual_timer_t vt1;
+static volatile unsigned total, vt_count;
+
+/*
+ * Virtual timer callback, rearms itself until enough events have been
+ * generated.
+ */
+static void vt_cb(void *p) {
+
+  (void)p;
+
+  chSysLockFromISR();
+  if (++vt_count < ITERATIONS) {
+    chVTSetI(&vt1, TIME_MS2I(2), vt_cb, NULL);
+  }
+  chSysUnlockFromISR();
+}
+
+/*
+ * Producer thread, posts messages in the mailbox.
+ */
+static THD_WORKING_AREA(waProducer, 256);
+static THD_FUNCTION(Producer, arg) {
+  unsigned i;
+
+  (void)arg;
+  chRegSetThreadName("producer");
+
+  for (i = 1U; i <= ITERATIONS; i++) {
+    (void) chMBPostTimeout(&mb1, (msg_t)i, TIME_INFINITE);
+    chThdSleepMilliseconds(1);
+  }
+}
+
+/*
+ * Consumer thread, fetches messages and accumulates them.
+ */
+static THD_WORKING_AREA(waConsumer, 256);
+static THD_FUNCTION(Consumer, arg) {
+  unsigned i;
+
+  (void)arg;
+  chRegSetThreadName("consumer");
+
+  for (i = 1U; i <= ITERATIONS; i++) {
+    msg_t msg;
+
+    (void) chMBFetchTimeout(&mb1, &msg, TIME_INFINITE);
+    chMtxLock(&mtx1);
+    total += (unsigned)msg;
+    chMtxUnlock(&mtx1);
+    chSemSignal(&sem1);
+  }
+}
+
+/*
+ * Simulator main.
+ */
+int main(int argc, char *argv[]) {
+  thread_t *tp;
+  unsigned i;
+  FILE *f;
+  bool ok;
+
+  /*
+   * System initializations.
+   * - HAL initialization, this also initializes the configured device drivers
+   *   and performs the board-specific initializations.
+   * - Kernel initialization, the main() function becomes a thread and the
+   *   RTOS is active.
+   */
+  halInit();
+  conInit();
+  chSysInit();
+
+  /*
+   * Trace stream drain thread, the lowest priority above idle.
+   */
+  msObjectInit(&ms, stream_buffer, sizeof stream_buffer, 0U);
+  tp = chThdCreateStatic(waTrace, sizeof (waTrace), LOWPRIO,
+                         traceStreamThread, (void *)&tscfg);
+
+  /*
+   * Workload, producing switch, synchronization, timer, ISR and user
+   * records.
+   */
+  chThdCreateStatic(waProducer, sizeof (waProducer), NORMALPRIO + 1,
+                    Producer, NULL);
+  chThdCreateStatic(waConsumer, sizeof (waConsumer), NORMALPRIO + 2,
+                    Consumer, NULL);
+  chVTSet(&vt1, TIME_MS2I(2), vt_cb, NULL);
+  for (i = 1U; i <= ITERATIONS; i++) {
+    (void) chSemWait(&sem1);
+    chDbgWriteTrace((void *)USER_MARKER, (void *)(uintptr_t)i);
+  }
+  while (vt_count < ITERATIONS) {
+    chThdSleepMilliseconds(2);
+  }
+
+  /*
+   * Leaving time to the drain thread for emptying the trace buffer then
+   * stopping it.
+   */
+  chThdSleepMilliseconds(20);
+  chThdTerminate(tp);
+  (void) chThdWait(tp);
+
+  ok = (total == (ITERATIONS * (ITERATIONS + 1U)) / 2U) &&
+       (ms.eos < sizeof stream_buffer);
+  chprintf((BaseSequentialStream *)&CD1, "Stream size: %u bytes, %s\r\n",
+           (unsigned)ms.eos, ok ? "OK" : "FAILED");
+
+  f = fopen(argc > 1 ? argv[1] : "trace.bin", "wb");
+  if ((f == NULL) || (fwrite(stream_buffer, 1, ms.eos, f) != ms.eos)) {
+    ok = false;
+  }
+  if (f != NULL) {
+    fclose(f);
+  }
+
+  exit(ok ? 0 : 1);
+}
@@ -0,0 +1,140 @@
+[#ftl]
+[#--
+    ChibiOS/RT - Copyright (C) 2006..2018 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+  --]
+
+[#--
+  -- Printable ASCII characters starting from the space, the position of a
+  -- character in this string is its code minus 32.
+  --]
+[#assign ascii = " !\"#$%&'()*+,-./0123456789:;<=>?@ABCDEFGHIJKLMNOPQRSTUVWXYZ[\\]^_`abcdefghijklmnopqrstuvwxyz{|}~" /]
+
+[#--
+  -- Returns the value of the attribute "name" of the XML node "node" or
+  -- "default" if the attribute is not present.
+  --]
+[#function Attr node name default]
+  [#local a = node["@" + name] /]
+  [#if a?size > 0]
+    [#return a[0]?string?trim /]
+  [/#if]
+  [#return default /]
+[/#function]
+
+[#--
+  -- Returns the value of the attribute "name" of the XML node "node", the
+  -- processing is stopped if the attribute is not present.
+  --]
+[#function Required node name]
+  [#local a = node["@" + name] /]
+  [#if a?size == 0]
+    [#stop "missing attribute '" + name + "' in <" + node?node_name + ">"]
+  [/#if]
+  [#return a[0]?string?trim /]
+[/#function]
+
+[#--
+  -- Returns the hash of an object name, it must match the hash computed by
+  -- chObjectsFind() at runtime.
+  --]
+[#function NameHash s]
+  [#local h = 0 /]
+  [#list 0..(s?length - 1) as i]
+    [#local h = ((h * 31) + ascii?index_of(s[i])) % 65536 /]
+  [/#list]
+  [#return h /]
+[/#function]
+
+[#--
+  -- Returns a sequence of hashes describing the objects declared as children
+  -- of the XML node "root", in declaration order.
+  --]
+[#function Collect root]
+  [#local objects = [] /]
+  [#local names = {} /]
+  [#list root.* as node]
+    [#local type = node?node_name /]
+    [#local name = Required(node, "name") /]
+    [#if !name?matches("[A-Za-z_][A-Za-z0-9_]*")]
+      [#stop "invalid object name '" + name + "'"]
+    [/#if]
+    [#if names[name]??]
+      [#stop "duplicated object name '" + name + "'"]
+    [/#if]
+    [#local names = names + {name:true} /]
+    [#local obj = {"type":type, "name":name, "hash":NameHash(name)} /]
+    [#if type == "thread"]
+      [#local obj = obj + {"stack":Required(node, "stack"),
+                           "priority":Attr(node, "priority", "NORMALPRIO"),
+                           "function":Required(node, "function"),
+                           "arg":Attr(node, "arg", "NULL")} /]
+    [#elseif type == "semaphore"]
+      [#local obj = obj + {"count":Attr(node, "count", "0")} /]
+    [#elseif type == "binary_semaphore"]
+      [#local obj = obj + {"taken":Attr(node, "taken", "false")} /]
+    [#elseif (type == "mutex") || (type == "event_source")]
+    [#elseif (type == "mailbox") || (type == "pipe")]
+      [#local obj = obj + {"size":Required(node, "size")} /]
+    [#elseif (type == "pool") || (type == "fifo")]
+      [#local obj = obj + {"object_size":Required(node, "object_size"),
+                           "count":Required(node, "count"),
+                           "guarded":(Attr(node, "guarded", "false") == "true")} /]
+    [#else]
+      [#stop "unknown object type <" + type + ">"]
+    [/#if]
+    [#local objects = objects + [obj] /]
+  [/#list]
+  [#return objects /]
+[/#function]
+
+[#--
+  -- Returns the size of the names index, the smallest power of two not lower
+  -- than twice the number of objects.
+  --]
+[#function IndexSize objects]
+  [#local size = 2 /]
+  [#list 1..16 as i]
+    [#if size >= (objects?size * 2)]
+      [#break]
+    [/#if]
+    [#local size = size * 2 /]
+  [/#list]
+  [#return size /]
+[/#function]
+
+[#--
+  -- Returns the names index as a sequence of object positions plus one, zero
+  -- marks an empty slot. Collisions are resolved by linear probing, the same
+  -- probing sequence is followed by chObjectsFind() at runtime.
+  --]
+[#function Index objects]
+  [#local size = IndexSize(objects) /]
+  [#local slots = {} /]
+  [#list objects as obj]
+    [#local s = obj.hash % size /]
+    [#list 1..size as i]
+      [#if !slots[s?c]??]
+        [#break]
+      [/#if]
+      [#local s = (s + 1) % size /]
+    [/#list]
+    [#local slots = slots + {s?c:(obj_index + 1)} /]
+  [/#list]
+  [#local index = [] /]
+  [#list 0..(size - 1) as s]
+    [#local index = index + [slots[s?c]!0] /]
+  [/#list]
+  [#return index /]
+[/#function]
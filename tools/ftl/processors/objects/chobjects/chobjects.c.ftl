@@ -0,0 +1,234 @@
+[#ftl]
+[#--
+    ChibiOS/RT - Copyright (C) 2006..2018 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+  --]
+[#import "/@ftllibs/libobjects.ftl" as objs /]
+[#assign objects = objs.Collect(xml.objects) /]
+[#assign section = objs.Attr(xml.objects, "section", "") /]
+[@pp.dropOutputFile /]
+[@pp.changeOutputFile name="chobjects.c" /]
+/*
+    This file has been generated from an objects description, do not edit.
+*/
+
+/**
+ * @file    chobjects.c
+ * @brief   Static kernel objects code.
+ *
+ * @addtogroup static_objects
+ * @details All the kernel objects described in the objects description
+ *          file and their buffers are allocated statically in a single
+ *          structure, the heap is never used.<br>
+ *          Objects can be accessed directly as fields of @p ch_objects,
+ *          by identifier in constant time using @p chObjectsGetX() or by
+ *          name using @p chObjectsFind(). The names index is an hash
+ *          table computed by the generator, a lookup requires hashing
+ *          the name and, usually, a single string comparison.
+ * @{
+ */
+
+#include <string.h>
+
+[#if section != ""]
+#include "ccportab.h"
+[/#if]
+#include "chobjects.h"
+
+/*===========================================================================*/
+/* Module local definitions.                                                 */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Module exported variables.                                                */
+/*===========================================================================*/
+
+/**
+ * @brief   Static objects.
+ */
+[#if section != ""]
+CC_SECTION("${section}") ch_objects_t ch_objects;
+[#else]
+ch_objects_t ch_objects;
+[/#if]
+
+/**
+ * @brief   Static objects index, ordered by identifier.
+ */
+const ch_object_t ch_objects_index[CH_OBJECTS_NUM] = {
+[#list objects as obj]
+  [#if obj.type == "thread"]
+    [#assign type = "CH_OBJECT_THREAD" /]
+  [#elseif obj.type == "semaphore"]
+    [#assign type = "CH_OBJECT_SEMAPHORE" /]
+  [#elseif obj.type == "binary_semaphore"]
+    [#assign type = "CH_OBJECT_BINARY_SEMAPHORE" /]
+  [#elseif obj.type == "mutex"]
+    [#assign type = "CH_OBJECT_MUTEX" /]
+  [#elseif obj.type == "event_source"]
+    [#assign type = "CH_OBJECT_EVENT_SOURCE" /]
+  [#elseif obj.type == "mailbox"]
+    [#assign type = "CH_OBJECT_MAILBOX" /]
+  [#elseif (obj.type == "pool") && obj.guarded]
+    [#assign type = "CH_OBJECT_GUARDED_MEMORY_POOL" /]
+  [#elseif obj.type == "pool"]
+    [#assign type = "CH_OBJECT_MEMORY_POOL" /]
+  [#elseif obj.type == "fifo"]
+    [#assign type = "CH_OBJECT_OBJECTS_FIFO" /]
+  [#else]
+    [#assign type = "CH_OBJECT_PIPE" /]
+  [/#if]
+  {"${obj.name}", ${obj.hash?c}U, ${type}, (void *)&ch_objects.${obj.name}}[#if obj_has_next],[/#if]
+[/#list]
+};
+
+/*===========================================================================*/
+/* Module local types.                                                       */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Module local variables.                                                   */
+/*===========================================================================*/
+
+/**
+ * @brief   Names index, positions in @p ch_objects_index plus one.
+ */
+static const uint16_t ch_objects_names[CH_OBJECTS_INDEX_SIZE] = {
+[#assign index = objs.Index(objects) /]
+[#list index?chunk(8) as row]
+  [#list row as n]${n?c}U[#if n_has_next], [/#if][/#list][#if row_has_next],[/#if]
+[/#list]
+};
+[#assign threads = [] /]
+[#list objects as obj]
+  [#if obj.type == "thread"]
+    [#assign threads = threads + [obj] /]
+  [/#if]
+[/#list]
+[#if threads?size > 0]
+
+/*
+ * Threads functions, defined by the application.
+ */
+  [#list threads as obj]
+THD_FUNCTION(${obj.function}, arg);
+  [/#list]
+
+/**
+ * @brief   Threads descriptors.
+ */
+static const thread_descriptor_t ch_objects_threads[${threads?size?c}] = {
+  [#list threads as obj]
+  {
+    "${obj.name}",
+    THD_WORKING_AREA_BASE(ch_objects.${obj.name}_wa),
+    THD_WORKING_AREA_END(ch_objects.${obj.name}_wa),
+    ${obj.priority},
+    ${obj.function},
+    ${obj.arg}
+  }[#if obj_has_next],[/#if]
+  [/#list]
+};
+[/#if]
+
+/*===========================================================================*/
+/* Module local functions.                                                   */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Module exported functions.                                                */
+/*===========================================================================*/
+
+/**
+ * @brief   Initializes the static objects and starts the static threads.
+ * @details Threads are started last, in declaration order, when all the
+ *          other objects are already initialized.
+ *
+ * @init
+ */
+void chObjectsInit(void) {
+
+[#list objects as obj]
+  [#if obj.type == "semaphore"]
+  chSemObjectInit(&ch_objects.${obj.name}, (cnt_t)${obj.count});
+  [#elseif obj.type == "binary_semaphore"]
+  chBSemObjectInit(&ch_objects.${obj.name}, ${obj.taken});
+  [#elseif obj.type == "mutex"]
+  chMtxObjectInit(&ch_objects.${obj.name});
+  [#elseif obj.type == "event_source"]
+  chEvtObjectInit(&ch_objects.${obj.name});
+  [#elseif obj.type == "mailbox"]
+  chMBObjectInit(&ch_objects.${obj.name}, ch_objects.${obj.name}_buf,
+                 (size_t)${obj.size});
+  [#elseif (obj.type == "pool") && obj.guarded]
+  chGuardedPoolObjectInit(&ch_objects.${obj.name},
+                          MEM_ALIGN_NEXT(${obj.object_size}, PORT_NATURAL_ALIGN));
+  chGuardedPoolLoadArray(&ch_objects.${obj.name},
+                         (void *)ch_objects.${obj.name}_buf, (size_t)${obj.count});
+  [#elseif obj.type == "pool"]
+  chPoolObjectInit(&ch_objects.${obj.name},
+                   MEM_ALIGN_NEXT(${obj.object_size}, PORT_NATURAL_ALIGN), NULL);
+  chPoolLoadArray(&ch_objects.${obj.name},
+                  (void *)ch_objects.${obj.name}_buf, (size_t)${obj.count});
+  [#elseif obj.type == "fifo"]
+  chFifoObjectInit(&ch_objects.${obj.name},
+                   MEM_ALIGN_NEXT(${obj.object_size}, PORT_NATURAL_ALIGN),
+                   (size_t)${obj.count}, (void *)ch_objects.${obj.name}_buf,
+                   ch_objects.${obj.name}_msgbuf);
+  [#elseif obj.type == "pipe"]
+  chPipeObjectInit(&ch_objects.${obj.name}, ch_objects.${obj.name}_buf,
+                   (size_t)${obj.size});
+  [/#if]
+[/#list]
+[#list threads as obj]
+  ch_objects.${obj.name} = chThdCreate(&ch_objects_threads[${obj_index?c}]);
+[/#list]
+}
+
+/**
+ * @brief   Finds a static object by name.
+ *
+ * @param[in] name      name of the object
+ * @return              Pointer to the object index entry.
+ * @retval NULL         if an object with the specified name does not exist.
+ *
+ * @api
+ */
+const ch_object_t *chObjectsFind(const char *name) {
+  const ch_object_t *op;
+  const char *p;
+  uint32_t h, i;
+
+  chDbgCheck(name != NULL);
+
+  /* Same hash computed by the generator.*/
+  h = 0U;
+  for (p = name; *p != '\0'; p++) {
+    h = ((h * 31U) + ((uint32_t)(uint8_t)*p - 32U)) & 0xFFFFU;
+  }
+
+  /* Linear probing, the index always contains at least one free slot.*/
+  i = h & (CH_OBJECTS_INDEX_SIZE - 1U);
+  while (ch_objects_names[i] != 0U) {
+    op = &ch_objects_index[ch_objects_names[i] - 1U];
+    if (((uint32_t)op->hash == h) && (strcmp(op->name, name) == 0)) {
+      return op;
+    }
+    i = (i + 1U) & (CH_OBJECTS_INDEX_SIZE - 1U);
+  }
+
+  return NULL;
+}
+
+/** @} */
@@ -0,0 +1,209 @@
+[#ftl]
+[#--
+    ChibiOS/RT - Copyright (C) 2006..2018 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+  --]
+[#import "/@ftllibs/libobjects.ftl" as objs /]
+[#assign objects = objs.Collect(xml.objects) /]
+[@pp.dropOutputFile /]
+[@pp.changeOutputFile name="chobjects.h" /]
+/*
+    This file has been generated from an objects description, do not edit.
+*/
+
+/**
+ * @file    chobjects.h
+ * @brief   Static kernel objects header.
+ *
+ * @addtogroup static_objects
+ * @{
+ */
+
+#ifndef CHOBJECTS_H
+#define CHOBJECTS_H
+
+#include "ch.h"
+
+/*===========================================================================*/
+/* Module constants.                                                         */
+/*===========================================================================*/
+
+/**
+ * @brief   Number of static objects.
+ */
+#define CH_OBJECTS_NUM                      ${objects?size?c}U
+
+/**
+ * @brief   Size of the names index, a power of two.
+ */
+#define CH_OBJECTS_INDEX_SIZE               ${objs.IndexSize(objects)?c}U
+
+/**
+ * @name    Objects identifiers
+ * @{
+ */
+[#list objects as obj]
+#define ${("CH_OBJ_ID_" + obj.name?upper_case)?right_pad(36)}${obj_index?c}U
+[/#list]
+/** @} */
+
+/*===========================================================================*/
+/* Module pre-compile time settings.                                         */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Derived constants and error checks.                                       */
+/*===========================================================================*/
+
+/**
+ * @brief   Size, in @p stkalign_t units, of a buffer of objects.
+ * @details Each object is rounded up to @p PORT_NATURAL_ALIGN.
+ *
+ * @param[in] size      size of an object
+ * @param[in] n         number of objects
+ */
+#define CH_OBJECTS_BUF_SIZE(size, n)                                        \
+  (((MEM_ALIGN_NEXT((size), PORT_NATURAL_ALIGN) * (n)) +                    \
+    sizeof (stkalign_t) - 1U) / sizeof (stkalign_t))
+
+/*===========================================================================*/
+/* Module data structures and types.                                         */
+/*===========================================================================*/
+
+/**
+ * @brief   Type of a static object type.
+ */
+typedef enum {
+  CH_OBJECT_THREAD = 0,
+  CH_OBJECT_SEMAPHORE = 1,
+  CH_OBJECT_BINARY_SEMAPHORE = 2,
+  CH_OBJECT_MUTEX = 3,
+  CH_OBJECT_EVENT_SOURCE = 4,
+  CH_OBJECT_MAILBOX = 5,
+  CH_OBJECT_MEMORY_POOL = 6,
+  CH_OBJECT_GUARDED_MEMORY_POOL = 7,
+  CH_OBJECT_OBJECTS_FIFO = 8,
+  CH_OBJECT_PIPE = 9
+} ch_object_type_t;
+
+/**
+ * @brief   Type of a static object index entry.
+ */
+typedef struct {
+  /**
+   * @brief   Object name.
+   */
+  const char            *name;
+  /**
+   * @brief   Hash of the object name.
+   */
+  uint16_t              hash;
+  /**
+   * @brief   Object type.
+   */
+  ch_object_type_t      type;
+  /**
+   * @brief   Pointer to the object, for threads it is a pointer to the
+   *          @p thread_t pointer.
+   */
+  void                  *objp;
+} ch_object_t;
+
+/**
+ * @brief   Type of the static objects structure.
+ * @details Control blocks are grouped at the beginning of the structure,
+ *          buffers follow and threads working areas are placed last.
+ */
+typedef struct {
+[#list objects as obj]
+  [#if obj.type == "thread"]
+  thread_t              *${obj.name};
+  [#elseif obj.type == "semaphore"]
+  semaphore_t           ${obj.name};
+  [#elseif obj.type == "binary_semaphore"]
+  binary_semaphore_t    ${obj.name};
+  [#elseif obj.type == "mutex"]
+  mutex_t               ${obj.name};
+  [#elseif obj.type == "event_source"]
+  event_source_t        ${obj.name};
+  [#elseif obj.type == "mailbox"]
+  mailbox_t             ${obj.name};
+  [#elseif obj.type == "pool"]
+    [#if obj.guarded]
+  guarded_memory_pool_t ${obj.name};
+    [#else]
+  memory_pool_t         ${obj.name};
+    [/#if]
+  [#elseif obj.type == "fifo"]
+  objects_fifo_t        ${obj.name};
+  [#elseif obj.type == "pipe"]
+  pipe_t                ${obj.name};
+  [/#if]
+[/#list]
+[#list objects as obj]
+  [#if obj.type == "mailbox"]
+  msg_t                 ${obj.name}_buf[${obj.size}];
+  [#elseif obj.type == "pool"]
+  stkalign_t            ${obj.name}_buf[CH_OBJECTS_BUF_SIZE(${obj.object_size}, ${obj.count})];
+  [#elseif obj.type == "fifo"]
+  stkalign_t            ${obj.name}_buf[CH_OBJECTS_BUF_SIZE(${obj.object_size}, ${obj.count})];
+  msg_t                 ${obj.name}_msgbuf[${obj.count}];
+  [#elseif obj.type == "pipe"]
+  uint8_t               ${obj.name}_buf[${obj.size}];
+  [/#if]
+[/#list]
+[#list objects as obj]
+  [#if obj.type == "thread"]
+  stkalign_t            ${obj.name}_wa[THD_WORKING_AREA_SIZE(${obj.stack}) / sizeof (stkalign_t)];
+  [/#if]
+[/#list]
+} ch_objects_t;
+
+/*===========================================================================*/
+/* Module macros.                                                            */
+/*===========================================================================*/
+
+/**
+ * @brief   Returns a static object by identifier.
+ *
+ * @param[in] id        the object identifier, a @p CH_OBJ_ID_xxx constant
+ * @return              Pointer to the object index entry.
+ *
+ * @xclass
+ */
+#define chObjectsGetX(id) (&ch_objects_index[(id)])
+
+/*===========================================================================*/
+/* External declarations.                                                    */
+/*===========================================================================*/
+
+extern ch_objects_t ch_objects;
+extern const ch_object_t ch_objects_index[CH_OBJECTS_NUM];
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+  void chObjectsInit(void);
+  const ch_object_t *chObjectsFind(const char *name);
+#ifdef __cplusplus
+}
+#endif
+
+/*===========================================================================*/
+/* Module inline functions.                                                  */
+/*===========================================================================*/
+
+#endif /* CHOBJECTS_H */
+
+/** @} */